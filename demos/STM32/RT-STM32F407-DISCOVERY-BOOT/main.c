@@ -0,0 +1,120 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "hal.h"
+#include "chprintf.h"
+#include "crt1.h"
+
+/*
+ * Initialized image in the CCM RAM area, it is copied at boot by the startup
+ * code or expanded if the area is listed in USE_CRT1_LZ_AREAS.
+ */
+#define IMAGE_SIZE      16384
+static uint8_t ccm_image[IMAGE_SIZE] __attribute__((section(".ram4_init"))) = {
+  [0 ... 1023]                        = 0xFF,
+  [1024 ... (IMAGE_SIZE / 2) - 1]     = 0x00,
+  [IMAGE_SIZE / 2 ... IMAGE_SIZE - 1] = 0x55
+};
+
+static const char * const phase_names[CRT1_BOOT_PHASES_NUMBER] = {
+  "reset", "RAM init", "halInit()", "chSysInit()", "first thread"
+};
+
+/*
+ * This is a periodic thread that does absolutely nothing except flashing
+ * a LED. It is the first thread started after the kernel initialization.
+ */
+static THD_WORKING_AREA(waThread1, 128);
+static THD_FUNCTION(Thread1, arg) {
+
+  (void)arg;
+  __crt1_boot_timestamp(CRT1_BOOT_PHASE_FIRST_THREAD);
+  chRegSetThreadName("blinker");
+  while (true) {
+    palSetPad(GPIOD, GPIOD_LED3);       /* Orange.  */
+    chThdSleepMilliseconds(500);
+    palClearPad(GPIOD, GPIOD_LED3);     /* Orange.  */
+    chThdSleepMilliseconds(500);
+  }
+}
+
+/*
+ * Prints the boot phases table.
+ */
+static void print_boot_phases(BaseSequentialStream *chp) {
+  uint32_t sum = 0U;
+  unsigned i;
+
+  for (i = 0U; i < IMAGE_SIZE; i++) {
+    sum += (uint32_t)ccm_image[i];
+  }
+
+  chprintf(chp, "Boot phases, HCLK cycles from reset:\r\n");
+  for (i = 0U; i < CRT1_BOOT_PHASES_NUMBER; i++) {
+    uint32_t t = __crt1_boot_timestamps[i];
+    uint32_t d = i == 0U ? 0U : t - __crt1_boot_timestamps[i - 1U];
+
+    chprintf(chp, "  %-14s %10U %10U (%U us)\r\n",
+             phase_names[i], t, d, d / (STM32_HCLK / 1000000U));
+  }
+  chprintf(chp, "CCM image checksum: %U (expected %U)\r\n",
+           sum, (uint32_t)((1024U * 0xFFU) + ((IMAGE_SIZE / 2U) * 0x55U)));
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   * The end of each phase is recorded in the boot timestamps table.
+   */
+  halInit();
+  __crt1_boot_timestamp(CRT1_BOOT_PHASE_HAL_INIT);
+  chSysInit();
+  __crt1_boot_timestamp(CRT1_BOOT_PHASE_SYS_INIT);
+
+  /*
+   * Creates the example thread.
+   */
+  chThdCreateStatic(waThread1, sizeof(waThread1), NORMALPRIO + 1, Thread1, NULL);
+
+  /*
+   * Activates the serial driver 2 using the driver default configuration.
+   * PA2(TX) and PA3(RX) are routed to USART2.
+   */
+  sdStart(&SD2, NULL);
+  palSetPadMode(GPIOA, 2, PAL_MODE_ALTERNATE(7));
+  palSetPadMode(GPIOA, 3, PAL_MODE_ALTERNATE(7));
+
+  /*
+   * Normal main() thread activity, the boot phases table is printed on
+   * start and then each time the button is pressed.
+   */
+  print_boot_phases((BaseSequentialStream *)&SD2);
+  while (true) {
+    if (palReadPad(GPIOA, GPIOA_BUTTON)) {
+      print_boot_phases((BaseSequentialStream *)&SD2);
+    }
+    chThdSleepMilliseconds(500);
+  }
+}
@@ -0,0 +1,223 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "hal.h"
+
+/*
+ * Mailbox geometry, both instances must agree on it.
+ */
+#define RMB_SLOTS           16U
+#define RMB_SIZE            32U
+
+/*
+ * Benchmark parameters.
+ */
+#define THROUGHPUT_MESSAGES 200000U
+#define THROUGHPUT_BATCH    8U
+#define PINGPONG_ROUNDS     10000U
+
+/*
+ * Message types.
+ */
+#define MSG_TYPE_DATA       0U
+#define MSG_TYPE_SYNC       1U
+#define MSG_TYPE_PING       2U
+#define MSG_TYPE_QUIT       3U
+
+typedef struct {
+  uint32_t              type;
+  uint32_t              seq;
+} amp_msg_t;
+
+static remote_mailbox_t rmb;
+
+/*
+ * Doorbell, it interrupts the other instance.
+ */
+static void doorbell(remote_mailbox_t *rmbp, void *arg) {
+
+  (void)rmbp;
+  (void)arg;
+
+  simAmpInterruptPeer();
+}
+
+/*
+ * Inter-instance interrupt handler.
+ */
+static void amp_handler(void) {
+
+  chSysLockFromISR();
+  chRMBDoorbellI(&rmb);
+  chSysUnlockFromISR();
+}
+
+static void post(uint32_t type, uint32_t seq) {
+  amp_msg_t m = {type, seq};
+
+  (void) chRMBPostTimeout(&rmb, &m, sizeof (m), TIME_INFINITE);
+}
+
+static void fetch(amp_msg_t *mp) {
+  size_t n;
+
+  (void) chRMBFetchTimeout(&rmb, mp, &n, TIME_INFINITE);
+}
+
+/*
+ * Secondary instance, it serves the requests of the main instance.
+ */
+static void secondary(void) {
+  uint32_t received = 0U;
+  amp_msg_t m;
+
+  while (true) {
+    fetch(&m);
+    switch (m.type) {
+    case MSG_TYPE_DATA:
+      received++;
+      break;
+    case MSG_TYPE_SYNC:
+      /* Reporting the number of data messages received since the last
+         synchronization.*/
+      post(MSG_TYPE_SYNC, received);
+      received = 0U;
+      break;
+    case MSG_TYPE_PING:
+      post(MSG_TYPE_PING, m.seq);
+      break;
+    default:
+      return;
+    }
+  }
+}
+
+/*
+ * Main instance, it runs the benchmarks.
+ */
+static void primary(void) {
+  systimestamp_t start, elapsed, min, max, total;
+  amp_msg_t m;
+  uint32_t i, j;
+
+  /*
+   * Throughput, messages are published in batches and the doorbell is
+   * rung only when the secondary instance is waiting.
+   */
+  start = chVTGetTimeStamp();
+  for (i = 0U; i < THROUGHPUT_MESSAGES; i += THROUGHPUT_BATCH) {
+    for (j = 0U; j < THROUGHPUT_BATCH; j++) {
+      void *p;
+
+      (void) chRMBReserveTimeout(&rmb, &p, TIME_INFINITE);
+      ((amp_msg_t *)p)->type = MSG_TYPE_DATA;
+      ((amp_msg_t *)p)->seq  = i + j;
+      chRMBPublish(&rmb, sizeof (amp_msg_t));
+    }
+    chRMBFlush(&rmb);
+  }
+  post(MSG_TYPE_SYNC, 0U);
+  fetch(&m);
+  elapsed = chVTGetTimeStamp() - start;
+
+  printf("Throughput: %u messages in %u us, %u messages/s\n",
+         (unsigned)m.seq, (unsigned)chTimeStamp2US(elapsed),
+         (unsigned)(((uint64_t)m.seq * 1000000U) /
+                    (chTimeStamp2US(elapsed) + 1U)));
+  printf("Doorbells:  %u rung, %u received\n",
+         (unsigned)rmb.n_rung, (unsigned)rmb.n_doorbells);
+
+  /*
+   * Latency, round trip of a single message.
+   */
+  min   = (systimestamp_t)-1;
+  max   = 0U;
+  total = 0U;
+  for (i = 0U; i < PINGPONG_ROUNDS; i++) {
+    start = chVTGetTimeStamp();
+    post(MSG_TYPE_PING, i);
+    fetch(&m);
+    elapsed = chVTGetTimeStamp() - start;
+
+    chDbgAssert(m.seq == i, "out of sequence");
+
+    total += elapsed;
+    if (elapsed < min) {
+      min = elapsed;
+    }
+    if (elapsed > max) {
+      max = elapsed;
+    }
+  }
+
+  printf("Round trip: avg %u us, min %u us, max %u us\n",
+         (unsigned)chTimeStamp2US(total / PINGPONG_ROUNDS),
+         (unsigned)chTimeStamp2US(min), (unsigned)chTimeStamp2US(max));
+
+  post(MSG_TYPE_QUIT, 0U);
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  rmb_descriptor_t d;
+  int id;
+
+  /*
+   * Splitting the simulator in two instances sharing the mailbox region,
+   * from here each instance initializes its own system.
+   */
+  id = simAmpSpawn(RMB_REGION_SIZE(RMB_SLOTS, RMB_SIZE), &d.region);
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * Remote mailbox initialization, the main instance formats the region.
+   */
+  d.slots     = RMB_SLOTS;
+  d.slot_size = RMB_SIZE;
+  d.side      = id == SIM_AMP_PARENT ? RMB_SIDE_A : RMB_SIDE_B;
+  d.doorbell  = doorbell;
+  d.arg       = NULL;
+  chRMBObjectInit(&rmb, &d);
+  simAmpSetHandler(amp_handler);
+
+  if (chRMBConnectTimeout(&rmb, TIME_MS2I(1000)) != MSG_OK) {
+    printf("Instance %d: connection failed\n", id);
+    return 1;
+  }
+
+  if (id == SIM_AMP_PARENT) {
+    printf("Instances connected, %u slots of %u bytes\n",
+           (unsigned)RMB_SLOTS, (unsigned)RMB_SIZE);
+    primary();
+  }
+  else {
+    secondary();
+  }
+
+  return 0;
+}
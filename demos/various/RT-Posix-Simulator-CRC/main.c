@@ -0,0 +1,188 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "hal.h"
+
+/*
+ * Benchmark parameters.
+ */
+#define BUFFER_SIZE         4096U
+#define BENCH_BYTES         (64U * 1024U * 1024U)
+
+static uint8_t buffer[BUFFER_SIZE];
+
+/*
+ * Byte-wise implementations as found in MFS and MMC-SPI, the tables are
+ * computed at startup instead of being constant.
+ */
+static uint16_t legacy_crc16_table[256];
+static uint8_t legacy_crc7_table[256];
+
+static void legacy_init(void) {
+  unsigned i, k;
+
+  for (i = 0U; i < 256U; i++) {
+    uint16_t c16 = (uint16_t)(i << 8);
+    uint8_t c7 = (uint8_t)i;
+
+    for (k = 0U; k < 8U; k++) {
+      c16 = (c16 & 0x8000U) != 0U ? (uint16_t)((c16 << 1) ^ 0x1021U)
+                                  : (uint16_t)(c16 << 1);
+      c7  = (c7 & 0x80U) != 0U ? (uint8_t)((c7 << 1) ^ (0x09U << 1))
+                               : (uint8_t)(c7 << 1);
+    }
+    legacy_crc16_table[i] = c16;
+    legacy_crc7_table[i]  = (uint8_t)(c7 >> 1);
+  }
+}
+
+static uint32_t legacy_crc16(size_t n, const uint8_t *data) {
+  uint16_t crc = 0xFFFFU;
+
+  while (n > 0U) {
+    crc = (crc << 8U) ^ legacy_crc16_table[(crc >> 8U) ^ (uint16_t)*data];
+    data++;
+    n--;
+  }
+
+  return crc;
+}
+
+static uint32_t legacy_crc7(size_t n, const uint8_t *data) {
+  uint8_t crc = 0U;
+
+  while (n > 0U) {
+    crc = legacy_crc7_table[(crc << 1) ^ (*data++)];
+    n--;
+  }
+
+  return crc;
+}
+
+/*
+ * CRC driver configurations, the driver is not associated to a CRC unit
+ * so the fall-back is always used.
+ */
+static CRCDriver crcd;
+static crc_table_t crc16_table, crc7_table, crc32_table, crc32c_table;
+
+static const CRCConfig crc16_cfg  = {CRC_MODEL_CRC16_CCITT, &crc16_table};
+static const CRCConfig crc16b_cfg = {CRC_MODEL_CRC16_CCITT, NULL};
+static const CRCConfig crc7_cfg   = {CRC_MODEL_CRC7_MMC, &crc7_table};
+static const CRCConfig crc32_cfg  = {CRC_MODEL_CRC32, &crc32_table};
+static const CRCConfig crc32c_cfg = {CRC_MODEL_CRC32C, &crc32c_table};
+
+static uint32_t driver_crc(size_t n, const uint8_t *data) {
+
+  return crcCalc(&crcd, n, data);
+}
+
+/*
+ * Runs an implementation over the buffer repeatedly and prints the
+ * throughput, the CRC of the buffer is returned.
+ */
+static uint32_t bench(const char *name, const CRCConfig *config,
+                      uint32_t (*crcf)(size_t n, const uint8_t *data),
+                      uint32_t bytes) {
+  systimestamp_t start, elapsed;
+  uint32_t i, crc = 0U;
+
+  if (config != NULL) {
+    crcStart(&crcd, config);
+  }
+
+  start = chVTGetTimeStamp();
+  for (i = 0U; i < bytes / BUFFER_SIZE; i++) {
+    crc = crcf(BUFFER_SIZE, buffer);
+  }
+  elapsed = chVTGetTimeStamp() - start;
+
+  printf("%-28s %6u MB/s\n", name,
+         (unsigned)(((uint64_t)bytes * 1000000U) /
+                    ((uint64_t)(chTimeStamp2US(elapsed) + 1U) * 1048576U)));
+
+  return crc;
+}
+
+/*
+ * Checks an implementation against the reference value.
+ */
+static void check(const char *name, uint32_t crc, uint32_t expected) {
+
+  if (crc != expected) {
+    printf("%s: 0x%08X, expected 0x%08X\n",
+           name, (unsigned)crc, (unsigned)expected);
+  }
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  static const uint8_t check_string[] = "123456789";
+  uint32_t i, crc;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  legacy_init();
+  crcObjectInit(&crcd);
+  for (i = 0U; i < BUFFER_SIZE; i++) {
+    buffer[i] = (uint8_t)((i * 2654435761U) >> 24);
+  }
+
+  /*
+   * Check values of the standard models.
+   */
+  crcStart(&crcd, &crc7_cfg);
+  check("CRC-7/MMC", crcCalc(&crcd, 9U, check_string), 0x75U);
+  check("legacy CRC-7", legacy_crc7(9U, check_string), 0x75U);
+  crcStart(&crcd, &crc16_cfg);
+  check("CRC-16/CCITT", crcCalc(&crcd, 9U, check_string), 0x29B1U);
+  check("legacy CRC-16", legacy_crc16(9U, check_string), 0x29B1U);
+  crcStart(&crcd, &crc32_cfg);
+  check("CRC-32", crcCalc(&crcd, 9U, check_string), 0xCBF43926U);
+  crcStart(&crcd, &crc32c_cfg);
+  check("CRC-32C", crcCalc(&crcd, 9U, check_string), 0xE3069283U);
+
+  printf("Fall-back with %u lookup tables, %u bytes blocks\n",
+         (unsigned)HAL_CRC_FALLBACK_SLICES, (unsigned)BUFFER_SIZE);
+
+  /*
+   * Throughput, the byte-wise implementations against the driver.
+   */
+  crc = bench("CRC-16 legacy (MFS)", NULL, legacy_crc16, BENCH_BYTES);
+  check("CRC-16 driver",
+        bench("CRC-16 driver", &crc16_cfg, driver_crc, BENCH_BYTES), crc);
+  check("CRC-16 driver, no tables",
+        bench("CRC-16 driver, no tables", &crc16b_cfg, driver_crc,
+              BENCH_BYTES / 16U), crc);
+  crc = bench("CRC-7 legacy (MMC-SPI)", NULL, legacy_crc7, BENCH_BYTES);
+  check("CRC-7 driver",
+        bench("CRC-7 driver", &crc7_cfg, driver_crc, BENCH_BYTES), crc);
+  (void) bench("CRC-32 driver", &crc32_cfg, driver_crc, BENCH_BYTES);
+  (void) bench("CRC-32C driver", &crc32c_cfg, driver_crc, BENCH_BYTES);
+
+  return 0;
+}
@@ -0,0 +1,259 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <time.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "evtimer.h"
+
+/*
+ * Benchmark parameters.
+ */
+#define MAX_TIMERS          512U
+#define TEST_DURATION       TIME_MS2I(3000)
+#define SOURCES             (MAX_TIMERS / 32U)
+
+/*
+ * Timers period and phase, in milliseconds.
+ */
+#define TIMER_PERIOD(i)     (10U + ((i) % 16U))
+#define TIMER_PHASE(i)      ((i) % 10U)
+
+/*
+ * Implementation using a virtual timer for each event timer and re-arming
+ * it relative to the callback time, as done by the previous evtimer.
+ */
+typedef struct {
+  virtual_timer_t       vt;
+  sysinterval_t         interval;
+  event_source_t        *esp;
+  eventflags_t          flags;
+} legacy_timer_t;
+
+static void legacy_cb(void *p) {
+  legacy_timer_t *ltp = p;
+
+  chSysLockFromISR();
+  chEvtBroadcastFlagsI(ltp->esp, ltp->flags);
+  chVTDoSetI(&ltp->vt, ltp->interval, legacy_cb, ltp);
+  chSysUnlockFromISR();
+}
+
+static event_timer_t timers[MAX_TIMERS];
+static legacy_timer_t legacy[MAX_TIMERS];
+
+/*
+ * Each group of 32 timers shares an event source, the timers are told
+ * apart by the event flags.
+ */
+static event_source_t sources[SOURCES];
+static event_listener_t listeners[SOURCES];
+static uint32_t counts[MAX_TIMERS];
+static systime_t last[MAX_TIMERS];
+static volatile uint32_t wakeups;
+
+/*
+ * Listener thread, it counts the expirations of each timer and records
+ * the time of the last one.
+ */
+static THD_WORKING_AREA(waListener, 1024);
+static THD_FUNCTION(listener_thread, arg) {
+  unsigned i;
+
+  (void)arg;
+  chRegSetThreadName("listener");
+
+  for (i = 0U; i < SOURCES; i++) {
+    chEvtRegisterMask(&sources[i], &listeners[i], EVENT_MASK(i));
+  }
+
+  while (true) {
+    eventmask_t mask = chEvtWaitAny(ALL_EVENTS);
+    systime_t now = chVTGetSystemTimeX();
+
+    wakeups++;
+    for (i = 0U; i < SOURCES; i++) {
+      if ((mask & EVENT_MASK(i)) != 0U) {
+        eventflags_t flags = chEvtGetAndClearFlags(&listeners[i]);
+        unsigned j;
+
+        for (j = 0U; j < 32U; j++) {
+          if ((flags & ((eventflags_t)1 << j)) != 0U) {
+            counts[(i * 32U) + j]++;
+            last[(i * 32U) + j] = now;
+          }
+        }
+      }
+    }
+  }
+}
+
+/*
+ * Background load, it polls the simulated interrupts as done by the idle
+ * thread. The interrupts and the threads they wake up run inside the
+ * polling function, the host time of the polls waking up the listener is
+ * accumulated. The system time cannot be used to detect the polls serving
+ * the timers because it is free running in tick-less mode.
+ */
+static volatile uint64_t busy_ns;
+
+static uint64_t host_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static THD_WORKING_AREA(waLoad, 1024);
+static THD_FUNCTION(load_thread, arg) {
+
+  (void)arg;
+  chRegSetThreadName("load");
+
+  while (true) {
+    uint32_t n = wakeups;
+    uint64_t start = host_ns();
+
+    port_wait_for_interrupt();
+    if (wakeups != n) {
+      busy_ns += host_ns() - start;
+    }
+  }
+}
+
+/*
+ * Runs n timers for the test duration.
+ */
+static void run(unsigned n, bool use_legacy) {
+  systime_t start, end;
+  uint64_t busy;
+  uint32_t total, expected;
+  sysinterval_t maxerr;
+  unsigned i;
+
+  for (i = 0U; i < MAX_TIMERS; i++) {
+    counts[i] = 0U;
+  }
+
+  /* All the timers are armed against the same start time.*/
+  start = chTimeAddX(chVTGetSystemTime(), TIME_MS2I(10));
+  chSysLock();
+  for (i = 0U; i < n; i++) {
+    systime_t first = chTimeAddX(start, TIME_MS2I(TIMER_PHASE(i)));
+
+    if (use_legacy) {
+      legacy[i].interval = TIME_MS2I(TIMER_PERIOD(i));
+      legacy[i].esp      = &sources[i / 32U];
+      legacy[i].flags    = (eventflags_t)1 << (i % 32U);
+      chVTSetI(&legacy[i].vt, chTimeDiffX(chVTGetSystemTimeX(), first),
+               legacy_cb, &legacy[i]);
+    }
+    else {
+      evtObjectInit(&timers[i], TIME_MS2I(TIMER_PERIOD(i)));
+      evtSetBroadcastX(&timers[i], &sources[i / 32U],
+                       (eventflags_t)1 << (i % 32U));
+      evtStartAtI(&timers[i], first, timers[i].et_interval);
+    }
+  }
+  chSysUnlock();
+
+  chThdSleepUntil(start);
+  busy = busy_ns;
+  chThdSleepUntil(chTimeAddX(start, TEST_DURATION));
+  busy = busy_ns - busy;
+
+  /* The wakeup can be late in tick-less mode, the expected expirations are
+     counted up to the time the timers are actually stopped.*/
+  chSysLock();
+  end = chVTGetSystemTimeX();
+  for (i = 0U; i < n; i++) {
+    if (use_legacy) {
+      chVTResetI(&legacy[i].vt);
+    }
+    else {
+      evtStopI(&timers[i]);
+    }
+  }
+  chSysUnlock();
+
+  /* Expected expirations and time error of the last one, the listener has
+     a higher priority so the expirations at "end" have been counted.*/
+  total = 0U;
+  expected = 0U;
+  maxerr = (sysinterval_t)0;
+  for (i = 0U; i < n; i++) {
+    systime_t first = chTimeAddX(start, TIME_MS2I(TIMER_PHASE(i)));
+    sysinterval_t period = TIME_MS2I(TIMER_PERIOD(i));
+    sysinterval_t err;
+
+    total    += counts[i];
+    expected += (chTimeDiffX(first, end) / period) + 1U;
+    if (counts[i] > 0U) {
+      err = chTimeDiffX(chTimeAddX(first, period * (counts[i] - 1U)),
+                        last[i]);
+      if (err > maxerr) {
+        maxerr = err;
+      }
+    }
+  }
+
+  printf("%-8s %5u timers %8u events (%8u expected) "
+         "drift %4u ticks, %6.0f ns/event\n",
+         use_legacy ? "legacy" : "evtimer", n,
+         (unsigned)total, (unsigned)expected, (unsigned)maxerr,
+         (double)busy / (double)total);
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  static const unsigned sizes[] = {64U, 128U, 256U, 512U};
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  for (i = 0U; i < SOURCES; i++) {
+    chEvtObjectInit(&sources[i]);
+  }
+  for (i = 0U; i < MAX_TIMERS; i++) {
+    chVTObjectInit(&legacy[i].vt);
+  }
+  chThdCreateStatic(waListener, sizeof(waListener), NORMALPRIO + 1,
+                    listener_thread, NULL);
+  chThdCreateStatic(waLoad, sizeof(waLoad), LOWPRIO, load_thread, NULL);
+
+  printf("%s mode, %u Hz, %u..%u ms periods, %u s runs\n",
+         CH_CFG_ST_TIMEDELTA > 0 ? "Tick-less" : "Tick",
+         (unsigned)CH_CFG_ST_FREQUENCY, TIMER_PERIOD(0U), TIMER_PERIOD(15U),
+         (unsigned)(TIME_I2MS(TEST_DURATION) / 1000U));
+
+  for (i = 0U; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i], true);
+    run(sizes[i], false);
+  }
+
+  return 0;
+}
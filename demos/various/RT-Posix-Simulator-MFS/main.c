@@ -0,0 +1,113 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "ram_flash.h"
+#include "mfs_test_root.h"
+
+/*
+ * RAM flash device hosting the partition used by the test suite, two
+ * banks of one sector.
+ */
+#define FLASH_SECTOR_SIZE   4096U
+
+static uint8_t flash_memory[2U * FLASH_SECTOR_SIZE];
+static RAMFlash ramflash;
+
+const MFSConfig mfscfg1 = {
+  .flashp           = (BaseFlash *)&ramflash,
+  .erased           = 0xFFFFFFFFU,
+  .bank_size        = FLASH_SECTOR_SIZE,
+  .bank0_start      = 0U,
+  .bank0_sectors    = 1U,
+  .bank1_start      = 1U,
+  .bank1_sectors    = 1U
+};
+
+/*
+ * Stream on the standard output, used for the test report.
+ */
+static size_t stdout_write(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)ip;
+  n = fwrite(bp, 1U, n, stdout);
+  fflush(stdout);
+
+  return n;
+}
+
+static size_t stdout_read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return 0U;
+}
+
+static msg_t stdout_put(void *ip, uint8_t b) {
+
+  (void)ip;
+  putchar(b);
+  fflush(stdout);
+
+  return MSG_OK;
+}
+
+static msg_t stdout_get(void *ip) {
+
+  (void)ip;
+
+  return MSG_RESET;
+}
+
+static const struct BaseSequentialStreamVMT stdout_vmt = {
+  (size_t)0,
+  stdout_write, stdout_read, stdout_put, stdout_get
+};
+
+static BaseSequentialStream stdout_stream = {&stdout_vmt};
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * RAM flash initialization, the array starts erased.
+   */
+  memset(flash_memory, 0xFF, sizeof flash_memory);
+  ramflashObjectInit(&ramflash, flash_memory, 2U, FLASH_SECTOR_SIZE);
+
+  /*
+   * The test suite is executed, the exit code is non-zero on failures.
+   */
+  return (int)test_execute(&stdout_stream, &mfs_test_suite);
+}
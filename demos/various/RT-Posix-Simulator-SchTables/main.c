@@ -0,0 +1,224 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <math.h>
+#include <time.h>
+
+#include "ch.h"
+#include "hal.h"
+
+/*
+ * Benchmark parameters.
+ */
+#define MAX_POINTS          512U
+#define TEST_DURATION       TIME_MS2I(3000)
+#define CYCLE               20U
+
+/*
+ * Offset of a point in the cycle, in milliseconds, the points are spread
+ * over the cycle in offset order.
+ */
+#define POINT_OFFSET(i, n)  (((i) * CYCLE) / (n))
+
+static uint64_t host_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Host time of the last interrupt entry and host time spent in the
+ * interrupts, called from the IRQ hooks in chconf.h.
+ */
+static uint64_t irq_ns;
+static volatile uint64_t busy_ns;
+
+void irq_prologue_hook(void) {
+
+  irq_ns = host_ns();
+}
+
+void irq_epilogue_hook(void) {
+
+  busy_ns += host_ns() - irq_ns;
+}
+
+/*
+ * Activations and latency from the interrupt entry, the jitter is the
+ * standard deviation of the latency.
+ */
+static uint32_t total;
+static double latency_sum;
+static double latency_sq;
+
+static void activation(void) {
+  double lat = (double)(host_ns() - irq_ns);
+
+  latency_sum += lat;
+  latency_sq  += lat * lat;
+  total++;
+}
+
+/*
+ * Implementation using a schedule table with a callback point for each
+ * activation.
+ */
+static st_expiry_t points[MAX_POINTS];
+static st_table_t table;
+static st_timeline_t timeline;
+
+static void point_cb(void *arg) {
+
+  (void)arg;
+  activation();
+}
+
+/*
+ * Implementation using a virtual timer for each activation, rearmed from
+ * its own callback.
+ */
+static virtual_timer_t timers[MAX_POINTS];
+
+static void timer_cb(void *p) {
+  virtual_timer_t *vtp = p;
+
+  chSysLockFromISR();
+  activation();
+  chVTDoSetI(vtp, TIME_MS2I(CYCLE), timer_cb, p);
+  chSysUnlockFromISR();
+}
+
+/*
+ * Runs n activations per cycle for the test duration, returns the host
+ * time spent in the interrupts.
+ */
+static uint64_t run(unsigned n, bool use_timers, uint64_t baseline) {
+  systime_t start;
+  uint64_t busy;
+  unsigned i;
+
+  /* Both implementations start against the same time.*/
+  start = chTimeAddX(chVTGetSystemTime(), TIME_MS2I(10));
+  chSysLock();
+  if (use_timers) {
+    for (i = 0U; i < n; i++) {
+      systime_t first = chTimeAddX(start, TIME_MS2I(POINT_OFFSET(i, n)));
+
+      chVTDoSetI(&timers[i], chTimeDiffX(chVTGetSystemTimeX(), first),
+                 timer_cb, &timers[i]);
+    }
+  }
+  else if (n > 0U) {
+    for (i = 0U; i < n; i++) {
+      points[i].offset = TIME_MS2I(POINT_OFFSET(i, n));
+      points[i].action = ST_ACTION_CALLBACK;
+      points[i].func   = point_cb;
+      points[i].target = NULL;
+      points[i].value  = (msg_t)0;
+    }
+    table.points     = points;
+    table.n          = (size_t)n;
+    table.duration   = TIME_MS2I(CYCLE);
+    table.repeating  = true;
+    table.precision  = (sysinterval_t)0;
+    table.max_adjust = (sysinterval_t)0;
+    chSTStartAbsI(&timeline, &table, start);
+  }
+  else {
+    /* Baseline, no activations.*/
+  }
+  chSysUnlock();
+
+  chThdSleepUntil(start);
+  chSysLock();
+  total       = 0U;
+  latency_sum = 0.0;
+  latency_sq  = 0.0;
+  busy        = busy_ns;
+  chSysUnlock();
+  chThdSleepUntil(chTimeAddX(start, TEST_DURATION));
+  chSysLock();
+  busy = busy_ns - busy;
+  if (use_timers) {
+    for (i = 0U; i < n; i++) {
+      if (chVTIsArmedI(&timers[i])) {
+        chVTResetI(&timers[i]);
+      }
+    }
+  }
+  else if (n > 0U) {
+    chSTStopI(&timeline);
+  }
+  else {
+    /* Baseline, no activations.*/
+  }
+  chSysUnlock();
+
+  /* The cost per activation is the time spent in the interrupts above the
+     time spent without activations.*/
+  if (total > 0U) {
+    double mean = latency_sum / (double)total;
+    double var  = (latency_sq / (double)total) - (mean * mean);
+
+    printf("%-8s %4u points %6u activations, latency %6.0f ns, "
+           "jitter %6.0f ns, %5.0f ns/activation\n",
+           use_timers ? "vtimers" : "stable", n, (unsigned)total,
+           mean, var > 0.0 ? sqrt(var) : 0.0,
+           ((double)busy - (double)baseline) / (double)total);
+  }
+
+  return busy;
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  static const unsigned sizes[] = {16U, 64U, 256U, 512U};
+  uint64_t baseline;
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  for (i = 0U; i < MAX_POINTS; i++) {
+    chVTObjectInit(&timers[i]);
+  }
+  chSTObjectInit(&timeline);
+
+  /*
+   * Interrupts without activations as reference.
+   */
+  baseline = run(0U, false, 0U);
+  printf("Interrupts %u us/s without activations, %u ms cycle, %u s runs\n",
+         (unsigned)(baseline / 1000U / (TIME_I2MS(TEST_DURATION) / 1000U)),
+         CYCLE, (unsigned)(TIME_I2MS(TEST_DURATION) / 1000U));
+
+  for (i = 0U; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    (void)run(sizes[i], true, baseline);
+    (void)run(sizes[i], false, baseline);
+  }
+
+  return 0;
+}
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+#
+#    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+#
+
+"""Serial throughput test for the Posix simulator.
+
+Starts the simulator, connects to SD1 and SD2 using the backends the
+simulator has been built with and runs the shell and serial workloads.
+"""
+
+import argparse
+import os
+import socket
+import subprocess
+import sys
+import threading
+import time
+import tty
+
+PROMPT = b"ch> "
+
+class Port(object):
+    """A simulated serial port seen from the host."""
+
+    def __init__(self, name, backend, proc):
+        self.name = name
+        self.sock = None
+        path = "/tmp/chibios-" + name.lower()
+        port = {"SD1": 29001, "SD2": 29002}[name]
+        deadline = time.time() + 5.0
+        while True:
+            try:
+                if backend == "stdio":
+                    self.rfd = proc.stdout.fileno()
+                    self.wfd = proc.stdin.fileno()
+                elif backend == "pty":
+                    self.rfd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+                    self.wfd = self.rfd
+                    tty.setraw(self.rfd)
+                else:
+                    if backend == "unix":
+                        self.sock = socket.socket(socket.AF_UNIX,
+                                                  socket.SOCK_STREAM)
+                        self.sock.connect(path)
+                    else:
+                        self.sock = socket.create_connection(("localhost",
+                                                              port))
+                    self.rfd = self.sock.fileno()
+                    self.wfd = self.rfd
+                break
+            except OSError:
+                if self.sock is not None:
+                    self.sock.close()
+                    self.sock = None
+                if time.time() > deadline:
+                    raise
+                time.sleep(0.05)
+
+    def write(self, data):
+        view = memoryview(data)
+        while len(view) > 0:
+            view = view[os.write(self.wfd, view):]
+
+    def read(self, n):
+        data = os.read(self.rfd, n)
+        if len(data) == 0:
+            raise EOFError(self.name)
+        return data
+
+    def read_until(self, marker, minimum=0):
+        data = b""
+        while len(data) < minimum or not data.endswith(marker):
+            data += self.read(65536)
+        return data
+
+def report(name, count, unit, elapsed):
+    print("%-32s %10.1f %s/s" % (name, count / elapsed, unit))
+
+def shell_workload(port, commands, size):
+    """Command round trips and bulk transfers through the shell on SD1."""
+    port.write(b"\r")
+    port.read_until(PROMPT)
+
+    start = time.time()
+    for i in range(commands):
+        port.write(b"echo %d\r" % i)
+        port.read_until(PROMPT)
+    report("Shell commands", commands, "cmd", time.time() - start)
+
+    start = time.time()
+    port.write(b"source %d\r" % size)
+    port.read_until(PROMPT, size)
+    report("Shell source", size / 1024.0, "kB", time.time() - start)
+
+    start = time.time()
+    port.write(b"sink %d\r" % size)
+    port.write(bytes(size))
+    port.read_until(PROMPT)
+    report("Shell sink", size / 1024.0, "kB", time.time() - start)
+
+def frames_workload(port, frames, payload):
+    """Framed transfers through the shell on SD1, each frame is moved as
+    header, payload and CRC using three calls or a single vectored call."""
+    size = frames * (4 + payload + 2)
+    for mode, name in (("", "separate"), (" v", "vectored")):
+        start = time.time()
+        port.write(b"frames %d %d%s\r" % (frames, payload, mode.encode()))
+        port.read_until(PROMPT, size)
+        report("Shell frames %s" % name, frames, "frm", time.time() - start)
+
+        start = time.time()
+        port.write(b"rframes %d %d%s\r" % (frames, payload, mode.encode()))
+        port.write(bytes(size))
+        port.read_until(PROMPT)
+        report("Shell rframes %s" % name, frames, "frm",
+               time.time() - start)
+
+def serial_workload(port, size, block):
+    """Full duplex echo of a stream of data on SD2."""
+    data = bytes(i & 0xFF for i in range(size))
+    received = bytearray()
+
+    def reader():
+        while len(received) < size:
+            received.extend(port.read(65536))
+
+    start = time.time()
+    thread = threading.Thread(target=reader)
+    thread.start()
+    for i in range(0, size, block):
+        port.write(data[i:i + block])
+    thread.join()
+    report("Serial echo", size / 1024.0, "kB", time.time() - start)
+    if bytes(received) != data:
+        print("Serial echo: data mismatch")
+        return False
+    return True
+
+def main():
+    backends = ["tcp", "unix", "pty", "stdio"]
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--sim", default="./build/ch",
+                        help="simulator executable (%(default)s)")
+    parser.add_argument("--sd1", choices=backends, default="unix",
+                        help="SD1 backend as built (%(default)s)")
+    parser.add_argument("--sd2", choices=backends, default="unix",
+                        help="SD2 backend as built (%(default)s)")
+    parser.add_argument("--commands", type=int, default=1000,
+                        help="shell commands (%(default)s)")
+    parser.add_argument("--bytes", type=int, default=1 << 20,
+                        help="bytes per transfer (%(default)s)")
+    parser.add_argument("--block", type=int, default=4096,
+                        help="serial write size (%(default)s)")
+    parser.add_argument("--frames", type=int, default=200000,
+                        help="frames per transfer (%(default)s)")
+    parser.add_argument("--payload", type=int, default=16,
+                        help="frames payload size (%(default)s)")
+    args = parser.parse_args()
+
+    pipes = "stdio" in (args.sd1, args.sd2)
+    proc = subprocess.Popen([args.sim],
+                            stdin=subprocess.PIPE if pipes else None,
+                            stdout=subprocess.PIPE if pipes else None,
+                            bufsize=0)
+    ok = True
+    try:
+        sd1 = Port("SD1", args.sd1, proc)
+        shell_workload(sd1, args.commands, args.bytes)
+        frames_workload(sd1, args.frames, args.payload)
+        ok = serial_workload(Port("SD2", args.sd2, proc), args.bytes,
+                             args.block)
+    finally:
+        proc.terminate()
+        proc.wait()
+    return 0 if ok else 1
+
+if __name__ == "__main__":
+    sys.exit(main())
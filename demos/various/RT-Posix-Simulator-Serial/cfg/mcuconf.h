@@ -0,0 +1,31 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef MCUCONF_H
+#define MCUCONF_H
+
+/*
+ * Simulated serial ports backends, can be overridden from the make command
+ * line, see the readme file.
+ */
+#if !defined(SIM_SD1_BACKEND)
+#define SIM_SD1_BACKEND                     SIM_SD_BACKEND_UNIX
+#endif
+#if !defined(SIM_SD2_BACKEND)
+#define SIM_SD2_BACKEND                     SIM_SD_BACKEND_UNIX
+#endif
+
+#endif /* MCUCONF_H */
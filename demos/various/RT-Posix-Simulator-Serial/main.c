@@ -0,0 +1,323 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "shell.h"
+#include "chprintf.h"
+
+#define SHELL_WA_SIZE       THD_WORKING_AREA_SIZE(4096)
+#define ECHO_WA_SIZE        THD_WORKING_AREA_SIZE(4096)
+
+/*
+ * Size of the blocks moved by the workloads.
+ */
+#define BLOCK_SIZE          512U
+
+/*
+ * Frames moved by the frames workloads, a header, a payload up to
+ * BLOCK_SIZE bytes and a CRC.
+ */
+#define FRAME_HEADER_SIZE   4U
+#define FRAME_CRC_SIZE      2U
+
+/*
+ * Simulated bit rate, zero for no limitation.
+ */
+#if !defined(SERIAL_SPEED)
+#define SERIAL_SPEED        0
+#endif
+
+static const SerialConfig serial_cfg = {
+  SERIAL_SPEED
+};
+
+/*===========================================================================*/
+/* Shell workload on SD1.                                                    */
+/*===========================================================================*/
+
+static thread_t *shelltp;
+static event_listener_t sd1el;
+
+/*
+ * Transmits the specified number of bytes.
+ */
+static void cmd_source(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static uint8_t buf[BLOCK_SIZE];
+  systime_t start;
+  size_t i, n;
+
+  if (argc != 1) {
+    chprintf(chp, "Usage: source <bytes>" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  for (i = 0U; i < BLOCK_SIZE; i++) {
+    buf[i] = (uint8_t)('A' + (i % 26U));
+  }
+
+  start = chVTGetSystemTimeX();
+  n = (size_t)atol(argv[0]);
+  while (n > 0U) {
+    size_t chunk = n > BLOCK_SIZE ? BLOCK_SIZE : n;
+
+    streamWrite(chp, buf, chunk);
+    n -= chunk;
+  }
+  chprintf(chp, SHELL_NEWLINE_STR "%s bytes sent in %u ms" SHELL_NEWLINE_STR,
+           argv[0],
+           (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)));
+}
+
+/*
+ * Receives the specified number of bytes.
+ */
+static void cmd_sink(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static uint8_t buf[BLOCK_SIZE];
+  systime_t start;
+  size_t n;
+
+  if (argc != 1) {
+    chprintf(chp, "Usage: sink <bytes>" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  start = chVTGetSystemTimeX();
+  n = (size_t)atol(argv[0]);
+  while (n > 0U) {
+    size_t chunk = n > BLOCK_SIZE ? BLOCK_SIZE : n;
+
+    n -= streamRead(chp, buf, chunk);
+  }
+  chprintf(chp, "%s bytes received in %u ms" SHELL_NEWLINE_STR,
+           argv[0],
+           (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)));
+}
+
+/*
+ * Frames segments, the header and the CRC are fixed.
+ */
+static uint8_t frame_header[FRAME_HEADER_SIZE] = {0x55, 0xAA, 0x00, 0x00};
+static uint8_t frame_payload[BLOCK_SIZE];
+static uint8_t frame_crc[FRAME_CRC_SIZE];
+
+/*
+ * Parses the arguments of the frames commands and prepares the segments.
+ */
+static bool frames_args(BaseSequentialStream *chp, int argc, char *argv[],
+                        const char *name, stream_iovec_t *iov,
+                        size_t *np, bool *vectoredp) {
+  size_t size;
+
+  if ((argc < 2) || (argc > 3) || ((argc == 3) && (*argv[2] != 'v'))) {
+    chprintf(chp, "Usage: %s <frames> <payload> [v]" SHELL_NEWLINE_STR, name);
+    return false;
+  }
+
+  size = (size_t)atol(argv[1]);
+  if ((size == 0U) || (size > BLOCK_SIZE)) {
+    chprintf(chp, "payload 1..%u" SHELL_NEWLINE_STR, BLOCK_SIZE);
+    return false;
+  }
+
+  frame_header[2] = (uint8_t)(size >> 8);
+  frame_header[3] = (uint8_t)size;
+  iov[0].bp = frame_header;
+  iov[0].n  = FRAME_HEADER_SIZE;
+  iov[1].bp = frame_payload;
+  iov[1].n  = size;
+  iov[2].bp = frame_crc;
+  iov[2].n  = FRAME_CRC_SIZE;
+  *np = (size_t)atol(argv[0]);
+  *vectoredp = argc == 3;
+
+  return true;
+}
+
+/*
+ * Transmits frames, as three writes or a single vectored write.
+ */
+static void cmd_frames(BaseSequentialStream *chp, int argc, char *argv[]) {
+  stream_iovec_t iov[3];
+  systime_t start;
+  size_t i, n;
+  bool vectored;
+
+  if (!frames_args(chp, argc, argv, "frames", iov, &n, &vectored)) {
+    return;
+  }
+
+  for (i = 0U; i < BLOCK_SIZE; i++) {
+    frame_payload[i] = (uint8_t)('A' + (i % 26U));
+  }
+  frame_crc[0] = 'C';
+  frame_crc[1] = 'R';
+
+  start = chVTGetSystemTimeX();
+  for (i = 0U; i < n; i++) {
+    if (vectored) {
+      /* The shell runs on SD1, vectored I/O is a SerialDriver method.*/
+      streamWriteV((SerialDriver *)chp, iov, 3U);
+    }
+    else {
+      streamWrite(chp, iov[0].bp, iov[0].n);
+      streamWrite(chp, iov[1].bp, iov[1].n);
+      streamWrite(chp, iov[2].bp, iov[2].n);
+    }
+  }
+  chprintf(chp, SHELL_NEWLINE_STR "%s frames sent in %u ms" SHELL_NEWLINE_STR,
+           argv[0],
+           (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)));
+}
+
+/*
+ * Receives frames, as three reads or a single vectored read.
+ */
+static void cmd_rframes(BaseSequentialStream *chp, int argc, char *argv[]) {
+  stream_iovec_t iov[3];
+  systime_t start;
+  size_t i, n;
+  bool vectored;
+
+  if (!frames_args(chp, argc, argv, "rframes", iov, &n, &vectored)) {
+    return;
+  }
+
+  start = chVTGetSystemTimeX();
+  for (i = 0U; i < n; i++) {
+    if (vectored) {
+      streamReadV((SerialDriver *)chp, iov, 3U);
+    }
+    else {
+      streamRead(chp, iov[0].bp, iov[0].n);
+      streamRead(chp, iov[1].bp, iov[1].n);
+      streamRead(chp, iov[2].bp, iov[2].n);
+    }
+  }
+  chprintf(chp, "%s frames received in %u ms" SHELL_NEWLINE_STR,
+           argv[0],
+           (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)));
+}
+
+static const ShellCommand commands[] = {
+  {"source", cmd_source},
+  {"sink", cmd_sink},
+  {"frames", cmd_frames},
+  {"rframes", cmd_rframes},
+  {NULL, NULL}
+};
+
+static const ShellConfig shell_cfg = {
+  (BaseSequentialStream *)&SD1,
+  commands
+};
+
+/*
+ * SD1 status change handler, a shell is spawned on connection.
+ */
+static void sd1_handler(eventid_t id) {
+  eventflags_t flags;
+
+  (void)id;
+  flags = chEvtGetAndClearFlags(&sd1el);
+  if ((shelltp != NULL) && chThdTerminatedX(shelltp)) {
+    chThdWait(shelltp);
+    shelltp = NULL;
+  }
+  if ((flags & CHN_CONNECTED) && (shelltp == NULL)) {
+    shelltp = chThdCreateFromHeap(NULL, SHELL_WA_SIZE,
+                                  "shell", NORMALPRIO + 1,
+                                  shellThread, (void *)&shell_cfg);
+  }
+  if (flags & CHN_DISCONNECTED) {
+    chSysLock();
+    iqResetI(&SD1.iqueue);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+/*===========================================================================*/
+/* Serial workload on SD2.                                                   */
+/*===========================================================================*/
+
+/*
+ * Echoes back everything received on SD2, in blocks.
+ */
+static THD_WORKING_AREA(waEcho, ECHO_WA_SIZE);
+static THD_FUNCTION(echo_thread, arg) {
+  static uint8_t buf[BLOCK_SIZE];
+
+  (void)arg;
+  chRegSetThreadName("echo");
+  while (true) {
+    size_t n;
+
+    /* Waiting for the first byte then taking whatever is available.*/
+    n = chnReadTimeout(&SD2, buf, 1U, TIME_INFINITE);
+    n += chnReadTimeout(&SD2, buf + n, BLOCK_SIZE - n, TIME_IMMEDIATE);
+    chnWrite(&SD2, buf, n);
+  }
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  static const evhandler_t evhndl[] = {
+    sd1_handler,
+    sd1_handler
+  };
+  event_listener_t tel;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * Serial ports (simulated) initialization.
+   */
+  sdStart(&SD1, &serial_cfg);
+  sdStart(&SD2, &serial_cfg);
+
+  /*
+   * Shell manager initialization, the shell runs on SD1.
+   */
+  shellInit();
+  chEvtRegister(&shell_terminated, &tel, 0);
+  chEvtRegister(chnGetEventSource(&SD1), &sd1el, 1);
+
+  /*
+   * Echo thread on SD2.
+   */
+  chThdCreateStatic(waEcho, sizeof(waEcho), NORMALPRIO + 1,
+                    echo_thread, NULL);
+
+  /*
+   * Events servicing loop.
+   */
+  while (true) {
+    chEvtDispatch(evhndl, chEvtWaitOne(ALL_EVENTS));
+  }
+}
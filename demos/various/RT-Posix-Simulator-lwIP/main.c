@@ -0,0 +1,419 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "lwipthread.h"
+
+#include "lwip/netif.h"
+#include "lwip/sys.h"
+
+/*
+ * Benchmark parameters.
+ */
+#define THROUGHPUT_FRAMES   100000U
+#define THROUGHPUT_WINDOW   4U
+#define PINGPONG_ROUNDS     10000U
+#define PAYLOAD_SIZE        32U
+#define CHKSUM_MAX_SIZE     1536U
+#define CHKSUM_ROUNDS       20000U
+
+/*
+ * Soak run, number of rounds of THROUGHPUT_FRAMES requests executed after
+ * the benchmarks, zero disables it.
+ */
+#if !defined(SOAK_ROUNDS)
+#define SOAK_ROUNDS         0U
+#endif
+
+/*
+ * Frame layout, Ethernet + IPv4 + ICMP echo.
+ */
+#define ETH_HDR_SIZE        14U
+#define IP_HDR_SIZE         20U
+#define ICMP_HDR_SIZE       8U
+#define ECHO_FRAME_SIZE     (ETH_HDR_SIZE + IP_HDR_SIZE + ICMP_HDR_SIZE +   \
+                             PAYLOAD_SIZE)
+#define ARP_FRAME_SIZE      60U
+
+#define ICMP_OFFSET         (ETH_HDR_SIZE + IP_HDR_SIZE)
+
+/*
+ * The emulated peer, the stack uses the lwipthread defaults.
+ */
+static const uint8_t peer_mac[6]  = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static const uint8_t peer_ip[4]   = {192, 168, 1, 20};
+static const uint8_t stack_mac[6] = {LWIP_ETHADDR_0, LWIP_ETHADDR_1,
+                                     LWIP_ETHADDR_2, LWIP_ETHADDR_3,
+                                     LWIP_ETHADDR_4, LWIP_ETHADDR_5};
+static const uint8_t stack_ip[4]  = {192, 168, 1, 10};
+
+/*
+ * The lwIP routine selected by LWIP_CHKSUM_ALGORITHM, it is not declared by
+ * lwIP because the port routine is the LWIP_CHKSUM one.
+ */
+u16_t lwip_standard_chksum(const void *dataptr, int len);
+
+/*
+ * Echo replies seen on the wire, the semaphore is signaled for each one.
+ */
+static semaphore_t replies;
+static volatile uint32_t n_replies;
+static volatile uint16_t last_seq;
+
+static uint16_t checksum(const uint8_t *p, size_t n) {
+  uint32_t sum = 0U;
+
+  while (n > 1U) {
+    sum += ((uint32_t)p[0] << 8) | (uint32_t)p[1];
+    p += 2;
+    n -= 2U;
+  }
+  if (n > 0U) {
+    sum += (uint32_t)p[0] << 8;
+  }
+  while ((sum >> 16) != 0U) {
+    sum = (sum & 0xFFFFU) + (sum >> 16);
+  }
+
+  return (uint16_t)~sum;
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+
+  p[0] = (uint8_t)(v >> 8);
+  p[1] = (uint8_t)v;
+}
+
+static void make_eth_header(uint8_t *p, const uint8_t *dst, uint16_t type) {
+
+  memcpy(&p[0], dst, 6);
+  memcpy(&p[6], peer_mac, 6);
+  put16(&p[12], type);
+}
+
+static void make_arp_request(uint8_t *p) {
+  static const uint8_t bcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+  memset(p, 0, ARP_FRAME_SIZE);
+  make_eth_header(p, bcast, 0x0806U);
+  p += ETH_HDR_SIZE;
+  put16(&p[0], 1U);                     /* Ethernet.                        */
+  put16(&p[2], 0x0800U);                /* IPv4.                            */
+  p[4] = 6U;
+  p[5] = 4U;
+  put16(&p[6], 1U);                     /* Request.                         */
+  memcpy(&p[8], peer_mac, 6);
+  memcpy(&p[14], peer_ip, 4);
+  memcpy(&p[24], stack_ip, 4);
+}
+
+static void make_echo_request(uint8_t *p) {
+  uint8_t *ip = &p[ETH_HDR_SIZE];
+  unsigned i;
+
+  memset(p, 0, ECHO_FRAME_SIZE);
+  make_eth_header(p, stack_mac, 0x0800U);
+  ip[0] = 0x45U;
+  put16(&ip[2], (uint16_t)(IP_HDR_SIZE + ICMP_HDR_SIZE + PAYLOAD_SIZE));
+  ip[8] = 64U;                          /* TTL.                             */
+  ip[9] = 1U;                           /* ICMP.                            */
+  memcpy(&ip[12], peer_ip, 4);
+  memcpy(&ip[16], stack_ip, 4);
+  put16(&ip[10], checksum(ip, IP_HDR_SIZE));
+  p[ICMP_OFFSET] = 8U;                  /* Echo request.                    */
+  put16(&p[ICMP_OFFSET + 4U], 0x1234U);
+  for (i = 0U; i < PAYLOAD_SIZE; i++) {
+    p[ICMP_OFFSET + ICMP_HDR_SIZE + i] = (uint8_t)i;
+  }
+}
+
+/*
+ * Updates the sequence number and the ICMP checksum of an echo request.
+ */
+static void set_echo_seq(uint8_t *p, uint16_t seq) {
+
+  put16(&p[ICMP_OFFSET + 2U], 0U);
+  put16(&p[ICMP_OFFSET + 6U], seq);
+  put16(&p[ICMP_OFFSET + 2U],
+        checksum(&p[ICMP_OFFSET], ICMP_HDR_SIZE + PAYLOAD_SIZE));
+}
+
+/*
+ * Transmit hook, the emulated peer receiving the frames.
+ */
+static void peer_receive(MACDriver *macp, const uint8_t *buf, size_t n) {
+
+  (void)macp;
+
+  if ((n >= (size_t)(ICMP_OFFSET + ICMP_HDR_SIZE)) &&
+      (buf[12] == 0x08U) && (buf[13] == 0x00U) &&
+      (buf[ETH_HDR_SIZE + 9U] == 1U) && (buf[ICMP_OFFSET] == 0U)) {
+    last_seq = (uint16_t)(((uint16_t)buf[ICMP_OFFSET + 6U] << 8) |
+                          (uint16_t)buf[ICMP_OFFSET + 7U]);
+    n_replies++;
+    chSemSignal(&replies);
+  }
+}
+
+/*
+ * Puts a frame on the wire, it cannot fail because the number of frames in
+ * flight is limited to less than the receive ring size.
+ */
+static void inject(const uint8_t *p, size_t n) {
+
+  if (!simMacInject(&ETHD1, p, n)) {
+    chSysHalt("frame dropped");
+  }
+}
+
+static void benchmark(void) {
+  static uint8_t frame[ECHO_FRAME_SIZE];
+  systimestamp_t start, elapsed, min, max, total;
+  uint32_t i;
+
+  make_echo_request(frame);
+
+  /*
+   * Latency, time from the frame put on the wire to the reply transmitted
+   * by the stack.
+   */
+  min   = (systimestamp_t)-1;
+  max   = 0U;
+  total = 0U;
+  for (i = 0U; i < PINGPONG_ROUNDS; i++) {
+    set_echo_seq(frame, (uint16_t)i);
+    start = chVTGetTimeStamp();
+    inject(frame, sizeof (frame));
+    (void) chSemWait(&replies);
+    elapsed = chVTGetTimeStamp() - start;
+
+    chDbgAssert(last_seq == (uint16_t)i, "out of sequence");
+
+    total += elapsed;
+    if (elapsed < min) {
+      min = elapsed;
+    }
+    if (elapsed > max) {
+      max = elapsed;
+    }
+  }
+
+  /* The average is printed with three decimals because the round trip
+     is close to the time stamps resolution on fast hosts.*/
+  total = (chTimeStamp2US(total) * 1000U) / PINGPONG_ROUNDS;
+  printf("Round trip: avg %u.%03u us, min %u us, max %u us\n",
+         (unsigned)(total / 1000U), (unsigned)(total % 1000U),
+         (unsigned)chTimeStamp2US(min), (unsigned)chTimeStamp2US(max));
+
+  /*
+   * Throughput, requests are kept in flight up to the window size, a new
+   * request is injected for each reply.
+   */
+  n_replies = 0U;
+  start = chVTGetTimeStamp();
+  for (i = 0U; i < THROUGHPUT_FRAMES; i++) {
+    if (i >= THROUGHPUT_WINDOW) {
+      (void) chSemWait(&replies);
+    }
+    set_echo_seq(frame, (uint16_t)i);
+    inject(frame, sizeof (frame));
+  }
+  for (i = 0U; i < THROUGHPUT_WINDOW; i++) {
+    (void) chSemWait(&replies);
+  }
+  elapsed = chVTGetTimeStamp() - start;
+
+  printf("Throughput: %u frames in %u us, %u frames/s\n",
+         (unsigned)n_replies, (unsigned)chTimeStamp2US(elapsed),
+         (unsigned)(((uint64_t)n_replies * 1000000U) /
+                    (chTimeStamp2US(elapsed) + 1U)));
+  printf("MAC:        %u received, %u dropped, %u transmitted\n",
+         (unsigned)ETHD1.stats.rx_frames, (unsigned)ETHD1.stats.rx_dropped,
+         (unsigned)ETHD1.stats.tx_frames);
+}
+
+/*
+ * Checksum benchmark, the port routine is verified against the lwIP one on
+ * all the sizes and alignments then both are timed.
+ */
+static volatile uint16_t chksum_sink;
+
+static uint32_t chksum_rate(uint16_t (*func)(const void *, int),
+                            const uint8_t *p, size_t n) {
+  systimestamp_t start;
+  uint32_t i;
+
+  start = chVTGetTimeStamp();
+  for (i = 0U; i < CHKSUM_ROUNDS; i++) {
+    chksum_sink = func(p, (int)n);
+  }
+
+  return (uint32_t)(((uint64_t)n * CHKSUM_ROUNDS) /
+                    (chTimeStamp2US(chVTGetTimeStamp() - start) + 1U));
+}
+
+static void chksum_benchmark(void) {
+  static uint8_t buf[CHKSUM_MAX_SIZE + 4U];
+  static const size_t sizes[] = {64U, 576U, 1500U};
+  uint32_t seed = 0x12345678U;
+  size_t i, n, offset;
+
+  for (i = 0U; i < sizeof (buf); i++) {
+    seed = (seed * 1103515245U) + 12345U;
+    buf[i] = (uint8_t)(seed >> 16);
+  }
+
+  for (offset = 0U; offset < 4U; offset++) {
+    for (n = 0U; n <= CHKSUM_MAX_SIZE; n++) {
+      if (lwip_arch_chksum(&buf[offset], (int)n) !=
+          lwip_standard_chksum(&buf[offset], (int)n)) {
+        chSysHalt("checksum mismatch");
+      }
+    }
+  }
+
+  for (i = 0U; i < sizeof (sizes) / sizeof (sizes[0]); i++) {
+    for (offset = 0U; offset < 2U; offset++) {
+      printf("Checksum:   %4u bytes %-9s lwIP %5u MB/s, port %5u MB/s\n",
+             (unsigned)sizes[i], offset == 0U ? "aligned" : "unaligned",
+             (unsigned)chksum_rate(lwip_standard_chksum, &buf[offset],
+                                   sizes[i]),
+             (unsigned)chksum_rate(lwip_arch_chksum, &buf[offset],
+                                   sizes[i]));
+    }
+  }
+}
+
+#if SOAK_ROUNDS > 0U
+/*
+ * Soak run, the throughput load is repeated and the lwIP objects allocated
+ * from the static pools must be the same after each round.
+ */
+static void soak(void) {
+  static uint8_t frame[ECHO_FRAME_SIZE];
+  uint32_t round, i, frames, leaks;
+#if SYS_ARCH_USE_POOLS
+  unsigned used[SYS_ARCH_POOLS_NUMBER];
+  unsigned n;
+#endif
+
+  make_echo_request(frame);
+
+  frames = 0U;
+  leaks  = 0U;
+  for (round = 0U; round < SOAK_ROUNDS; round++) {
+    n_replies = 0U;
+    for (i = 0U; i < THROUGHPUT_FRAMES; i++) {
+      if (i >= THROUGHPUT_WINDOW) {
+        (void) chSemWait(&replies);
+      }
+      set_echo_seq(frame, (uint16_t)i);
+      inject(frame, sizeof (frame));
+    }
+    for (i = 0U; i < THROUGHPUT_WINDOW; i++) {
+      (void) chSemWait(&replies);
+    }
+    frames += n_replies;
+
+    /* The stack frees the last replies after the transmit hook, it is
+       given time to settle before sampling the pools.*/
+    chThdSleepMilliseconds(10);
+#if SYS_ARCH_USE_POOLS
+    for (n = 0U; n < SYS_ARCH_POOLS_NUMBER; n++) {
+      const sys_arch_pool_stats_t *sp = sys_arch_get_pool_stats(n);
+
+      if (round == 0U) {
+        used[n] = sp->used;
+      }
+      else if (sp->used != used[n]) {
+        leaks++;
+      }
+    }
+#endif
+  }
+
+  printf("Soak:       %u rounds, %u frames, %u leaks\n",
+         (unsigned)SOAK_ROUNDS, (unsigned)frames, (unsigned)leaks);
+#if SYS_ARCH_USE_POOLS
+  for (n = 0U; n < SYS_ARCH_POOLS_NUMBER; n++) {
+    const sys_arch_pool_stats_t *sp = sys_arch_get_pool_stats(n);
+
+    printf("Pool %-6s %4u bytes, %2u objects, %2u max used, %u fallbacks\n",
+           sp->name, (unsigned)sp->object_size, sp->num, sp->max_used,
+           sp->fallbacks);
+  }
+
+  /* A calloc() whose size overflows must fail.*/
+  if (sys_arch_mem_calloc(((size_t)-1 / 2U) + 2U, 2U) != NULL) {
+    chSysHalt("calloc overflow");
+  }
+#endif
+}
+#endif /* SOAK_ROUNDS > 0U */
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  uint8_t arp[ARP_FRAME_SIZE];
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * The emulated peer is attached to the MAC before starting the stack.
+   */
+  chSemObjectInit(&replies, (cnt_t)0);
+  simMacSetTransmitHook(&ETHD1, peer_receive);
+
+  /*
+   * Stack initialization using the default addresses, then waiting for the
+   * link to be detected.
+   */
+  lwipInit(NULL);
+  while (!netif_is_link_up(netif_default)) {
+    chThdSleepMilliseconds(10);
+  }
+
+  /*
+   * The peer announces itself so that the stack does not need to resolve
+   * its address before replying.
+   */
+  make_arp_request(arp);
+  inject(arp, sizeof (arp));
+  chThdSleepMilliseconds(10);
+
+  printf("Reception mode: %s\n",
+         LWIP_TCPIP_DIRECT_RX == TRUE ? "tcpip thread" : "lwIP-MAC thread");
+  benchmark();
+  chksum_benchmark();
+#if SOAK_ROUNDS > 0U
+  soak();
+#endif
+
+  return 0;
+}
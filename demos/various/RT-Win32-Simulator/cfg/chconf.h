@@ -381,6 +381,62 @@
 #define CH_CFG_USE_PIPES                    TRUE
 #endif
 
+/**
+ * @brief   Active Objects APIs.
+ * @details If enabled then the active objects APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MEMPOOLS.
+ */
+#if !defined(CH_CFG_USE_ACTIVE_OBJECTS)
+#define CH_CFG_USE_ACTIVE_OBJECTS           TRUE
+#endif
+
+/**
+ * @brief   Remote Mailboxes APIs.
+ * @details If enabled then the remote mailboxes APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_REMOTE_MAILBOXES)
+#define CH_CFG_USE_REMOTE_MAILBOXES         TRUE
+#endif
+
+/**
+ * @brief   Basic Tasks APIs.
+ * @details If enabled then the stack sharing basic tasks APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_BASIC_TASKS)
+#define CH_CFG_USE_BASIC_TASKS              TRUE
+#endif
+
+/**
+ * @brief   Schedule Tables APIs.
+ * @details If enabled then the time-triggered schedule tables APIs are
+ *          included in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_SCHEDULE_TABLES)
+#define CH_CFG_USE_SCHEDULE_TABLES          TRUE
+#endif
+
+/**
+ * @brief   RCU APIs.
+ * @details If enabled then the read-copy-update APIs are included in the
+ *          kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_RCU)
+#define CH_CFG_USE_RCU                      TRUE
+#endif
+
 /**
  * @brief   Dynamic Threads APIs.
  * @details If enabled then the dynamic threads creation APIs are included
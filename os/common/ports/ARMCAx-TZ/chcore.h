@@ -311,6 +311,26 @@ struct port_context {
 #define PORT_FAST_IRQ_HANDLER(id)                                           \
   bool id(void)
 
+#if (ARM_CORE == ARM_CORE_CORTEX_A5) || (ARM_CORE == ARM_CORE_CORTEX_A9) ||   \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Number of performance counters.
+ * @details The PMU cycle counter followed by two event counters programmed
+ *          for executed instructions and L1 data cache refills.
+ */
+#define PORT_PMU_COUNTERS               3
+
+/**
+ * @brief   Performance counters names.
+ */
+#define PORT_PMU_COUNTER_NAMES {"cycles", "instr", "l1d_refill"}
+
+/**
+ * @brief   Performance counters significant bits.
+ */
+#define PORT_PMU_COUNTER_MASKS {0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU}
+#endif
+
 /**
  * @brief   Performs a context switch between two threads.
  * @details This is the most critical code in any port, this function
@@ -532,6 +552,54 @@ static inline rtcnt_t port_rt_get_counter_value(void) {
 #endif
 }
 
+#if (ARM_CORE == ARM_CORE_CORTEX_A5) || (ARM_CORE == ARM_CORE_CORTEX_A9) ||   \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Enables the performance counters.
+ * @note    The cycle counter is not reset because it is also the realtime
+ *          counter.
+ */
+static inline void port_pmu_init(void) {
+  uint32_t pmcr;
+
+  /* Event counter 0, instructions executed, the A9 does not implement
+     the architectural event so the speculative one is used.*/
+  __asm volatile ("mcr p15, 0, %[p0], c9, c12, 5" : : [p0] "r" (0U));
+#if ARM_CORE == ARM_CORE_CORTEX_A9
+  __asm volatile ("mcr p15, 0, %[p0], c9, c13, 1" : : [p0] "r" (0x68U));
+#else
+  __asm volatile ("mcr p15, 0, %[p0], c9, c13, 1" : : [p0] "r" (0x08U));
+#endif
+
+  /* Event counter 1, L1 data cache refills.*/
+  __asm volatile ("mcr p15, 0, %[p0], c9, c12, 5" : : [p0] "r" (1U));
+  __asm volatile ("mcr p15, 0, %[p0], c9, c13, 1" : : [p0] "r" (0x03U));
+
+  /* Enabling the cycle counter and the two event counters.*/
+  __asm volatile ("mcr p15, 0, %[p0], c9, c12, 1" : : [p0] "r" (0x80000003U));
+  __asm volatile ("mrc p15, 0, %[p0], c9, c12, 0" : [p0] "=r" (pmcr) :);
+  __asm volatile ("mcr p15, 0, %[p0], c9, c12, 0" : : [p0] "r" (pmcr | 1U));
+}
+
+/**
+ * @brief   Samples the performance counters.
+ *
+ * @param[out] cnt      array of @p PORT_PMU_COUNTERS elements
+ */
+static inline void port_pmu_read(uint32_t *cnt) {
+  uint32_t v;
+
+  __asm volatile ("mrc p15, 0, %[p0], c9, c13, 0" : [p0] "=r" (v) :);
+  cnt[0] = v;
+  __asm volatile ("mcr p15, 0, %[p0], c9, c12, 5" : : [p0] "r" (0U));
+  __asm volatile ("mrc p15, 0, %[p0], c9, c13, 2" : [p0] "=r" (v) :);
+  cnt[1] = v;
+  __asm volatile ("mcr p15, 0, %[p0], c9, c12, 5" : : [p0] "r" (1U));
+  __asm volatile ("mrc p15, 0, %[p0], c9, c13, 2" : [p0] "=r" (v) :);
+  cnt[2] = v;
+}
+#endif
+
 #if CH_CFG_ST_TIMEDELTA > 0
 #if PORT_USE_ALT_TIMER == FALSE
 #include "chcore_timer.h"
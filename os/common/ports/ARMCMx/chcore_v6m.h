@@ -272,6 +272,12 @@ struct port_intctx {
  */
 #define PORT_IRQ_EPILOGUE() _port_irq_epilogue(_saved_lr)
 
+/**
+ * @brief   Returns the number of the vector currently being served.
+ * @note    This is the exception number, external IRQs start from 16.
+ */
+#define PORT_IRQ_GET_VECTOR() (__get_IPSR() & 0x1FFU)
+
 /**
  * @brief   IRQ handler function declaration.
  * @note    @p id can be a function name or a vector number depending on the
@@ -430,6 +430,34 @@ struct port_intctx {
  */
 #define PORT_IRQ_EPILOGUE() _port_irq_epilogue()
 
+/**
+ * @brief   Returns the number of the vector currently being served.
+ * @note    This is the exception number, external IRQs start from 16.
+ */
+#define PORT_IRQ_GET_VECTOR() (__get_IPSR() & 0x1FFU)
+
+/**
+ * @brief   Number of performance counters.
+ * @details Only the DWT cycle counter is exported.
+ * @note    The DWT profiling counters (CPI, EXC, SLEEP, LSU and FOLD) are
+ *          8 bits wide and are sampled only on context switches, they
+ *          would wrap many times between two samples so they are not
+ *          exported.
+ * @note    The cycle counter is 32 bits wide, a thread running longer than
+ *          2^32 cycles without a context switch is under-accounted.
+ */
+#define PORT_PMU_COUNTERS               1
+
+/**
+ * @brief   Performance counters names.
+ */
+#define PORT_PMU_COUNTER_NAMES {"cycles"}
+
+/**
+ * @brief   Performance counters significant bits.
+ */
+#define PORT_PMU_COUNTER_MASKS {0xFFFFFFFFU}
+
 /**
  * @brief   IRQ handler function declaration.
  * @note    @p id can be a function name or a vector number depending on the
@@ -716,6 +744,24 @@ static inline rtcnt_t port_rt_get_counter_value(void) {
   return DWT->CYCCNT;
 }
 
+/**
+ * @brief   Enables the performance counters.
+ * @note    The cycle counter is already enabled by @p port_init().
+ */
+static inline void port_pmu_init(void) {
+
+}
+
+/**
+ * @brief   Samples the performance counters.
+ *
+ * @param[out] cnt      array of @p PORT_PMU_COUNTERS elements
+ */
+static inline void port_pmu_read(uint32_t *cnt) {
+
+  cnt[0] = DWT->CYCCNT;
+}
+
 #endif /* !defined(_FROM_ASM_) */
 
 #endif /* CHCORE_V7M_H */
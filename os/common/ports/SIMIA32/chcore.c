@@ -31,6 +31,14 @@
 #include <sys/time.h>
 #endif
 
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
 #include "ch.h"
 
 /*===========================================================================*/
@@ -43,6 +51,7 @@
 
 bool port_isr_context_flag;
 syssts_t port_irq_sts;
+unsigned port_irq_vector;
 
 /*===========================================================================*/
 /* Module local types.                                                       */
@@ -52,6 +61,32 @@ syssts_t port_irq_sts;
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if defined(__linux__)
+/**
+ * @brief   Host events associated to the performance counters.
+ */
+static const uint64_t pmu_events[PORT_PMU_COUNTERS] = {
+  PERF_COUNT_HW_CPU_CYCLES,
+  PERF_COUNT_HW_INSTRUCTIONS,
+  PERF_COUNT_HW_CACHE_MISSES
+};
+
+/**
+ * @brief   Performance counters file descriptors, -1 if not available.
+ */
+static int pmu_fd[PORT_PMU_COUNTERS];
+#endif
+
+/**
+ * @brief   Host counter value corresponding to the realtime counter zero.
+ */
+static rtcnt_t rt_origin;
+
+/**
+ * @brief   The realtime counter origin has been latched.
+ */
+static bool rt_origin_valid = false;
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
@@ -114,18 +149,74 @@ void _port_thread_start(msg_t (*pf)(void *), void *p) {
  * @return              The realtime counter value.
  */
 rtcnt_t port_rt_get_counter_value(void) {
+  rtcnt_t cnt;
 #if defined(WIN32)
   LARGE_INTEGER n;
 
   QueryPerformanceCounter(&n);
-
-  return (rtcnt_t)(n.QuadPart / 1000LL);
+  cnt = (rtcnt_t)(n.QuadPart / 1000LL);
 #else
   struct timeval tv;
 
   gettimeofday(&tv, NULL);
-  return ((rtcnt_t)tv.tv_sec * (rtcnt_t)1000000) + (rtcnt_t)tv.tv_usec;
+  cnt = ((rtcnt_t)tv.tv_sec * (rtcnt_t)1000000) + (rtcnt_t)tv.tv_usec;
 #endif
+
+  /* The first reading defines the counter origin.*/
+  if (!rt_origin_valid) {
+    rt_origin = cnt - (rtcnt_t)PORT_RT_COUNTER_INIT;
+    rt_origin_valid = true;
+  }
+
+  return cnt - rt_origin;
+}
+
+#if defined(__linux__) || defined(__DOXYGEN__)
+/**
+ * @brief   Opens the host performance counters.
+ * @note    Only user space events of the simulator process are counted.
+ */
+void port_pmu_init(void) {
+  struct perf_event_attr attr;
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)PORT_PMU_COUNTERS; i++) {
+    memset(&attr, 0, sizeof (attr));
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof (attr);
+    attr.config         = pmu_events[i];
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    pmu_fd[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  }
 }
 
+/**
+ * @brief   Samples the performance counters.
+ *
+ * @param[out] cnt      array of @p PORT_PMU_COUNTERS elements
+ */
+void port_pmu_read(uint32_t *cnt) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)PORT_PMU_COUNTERS; i++) {
+    uint64_t v = 0U;
+
+    if (pmu_fd[i] >= 0) {
+      if (read(pmu_fd[i], &v, sizeof (v)) != (ssize_t)sizeof (v)) {
+        v = 0U;
+      }
+    }
+    else if (i == 0U) {
+      struct timespec ts;
+
+      /* Fall back on the process CPU time.*/
+      clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+      v = ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+    }
+    cnt[i] = (uint32_t)v;
+  }
+}
+#endif
+
 /** @} */
@@ -41,6 +41,14 @@
  */
 #define PORT_SUPPORTS_RT                TRUE
 
+#if !defined(WIN32) || defined(__DOXYGEN__)
+/**
+ * @brief   Realtime counter frequency.
+ * @note    The counter is the host time in microseconds.
+ */
+#define PORT_RT_FREQUENCY               1000000
+#endif
+
 /**
  * @brief   Natural alignment constant.
  * @note    It is the minimum alignment for pointer-size variables.
@@ -123,6 +131,16 @@
 #define PORT_USE_ALT_TIMER              FALSE
 #endif
 
+/**
+ * @brief   Realtime counter initial value.
+ * @details The realtime counter starts counting from this value, setting
+ *          it close to the counter overflow allows to test the counter
+ *          wrap without waiting for it.
+ */
+#if !defined(PORT_RT_COUNTER_INIT) || defined(__DOXYGEN__)
+#define PORT_RT_COUNTER_INIT            0
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -261,6 +279,35 @@ struct port_context {
   port_isr_context_flag = false;                                            \
 }
 
+/**
+ * @brief   Returns the number of the vector currently being served.
+ * @note    The simulated interrupt sources are required to set
+ *          @p port_irq_vector before invoking the IRQ prologue.
+ */
+#define PORT_IRQ_GET_VECTOR() port_irq_vector
+
+#if defined(__linux__) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of performance counters.
+ * @details Host hardware counters of the simulator process, obtained using
+ *          @p perf_event_open().
+ * @note    If the host denies access to the hardware counters then the
+ *          cycles counter is replaced by the process CPU time in
+ *          nanoseconds and the other counters read zero.
+ */
+#define PORT_PMU_COUNTERS               3
+
+/**
+ * @brief   Performance counters names.
+ */
+#define PORT_PMU_COUNTER_NAMES {"cycles", "instr", "cache_miss"}
+
+/**
+ * @brief   Performance counters significant bits.
+ */
+#define PORT_PMU_COUNTER_MASKS {0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU}
+#endif
+
 /**
  * @brief   IRQ handler function declaration.
  * @note    @p id can be a function name or a vector number depending on the
@@ -293,6 +340,7 @@ struct port_context {
 
 extern bool port_isr_context_flag;
 extern syssts_t port_irq_sts;
+extern unsigned port_irq_vector;
 
 #ifdef __cplusplus
 extern "C" {
@@ -304,6 +352,10 @@ extern "C" {
   /*lint -restore*/
   rtcnt_t port_rt_get_counter_value(void);
   void _sim_check_for_interrupts(void);
+#if defined(__linux__)
+  void port_pmu_init(void);
+  void port_pmu_read(uint32_t *cnt);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -23,26 +23,103 @@
  */
 
 #include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
 
 #include "cmparams.h"
+#include "crt1.h"
 
 /*===========================================================================*/
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if !defined(FALSE) || defined(__DOXYGEN__)
+#define FALSE                               0
+#endif
+
+#if !defined(TRUE) || defined(__DOXYGEN__)
+#define TRUE                                1
+#endif
+
 #if !defined(CRT1_AREAS_NUMBER) || defined(__DOXYGEN__)
 #define CRT1_AREAS_NUMBER                   8
 #endif
 
+/**
+ * @brief   Multi-word RAM areas initialization switch.
+ * @details If enabled the copy and clear loops move four words per
+ *          iteration, the compiler is able to turn those into LDM/STM
+ *          instructions pairs.
+ */
+#if !defined(CRT1_AREAS_FAST_INIT) || defined(__DOXYGEN__)
+#define CRT1_AREAS_FAST_INIT                TRUE
+#endif
+
+/**
+ * @brief   Mask of the RAM areas stored compressed in flash.
+ * @details Bit N set means that the initialization image of area N is
+ *          stored as an LZ4 raw block and is expanded at boot.
+ * @note    The image is replaced post-link with its compressed form, the
+ *          makefile rules do that for the areas listed in
+ *          @p USE_CRT1_LZ_AREAS and also set this mask accordingly.
+ */
+#if !defined(CRT1_AREAS_LZ_MASK) || defined(__DOXYGEN__)
+#define CRT1_AREAS_LZ_MASK                  0x00U
+#endif
+
+/**
+ * @brief   Mask of the RAM areas whose clear part is not zeroed.
+ * @details Bit N set means that the clear part of area N is left
+ *          untouched at boot, this is useful for large buffers that
+ *          are going to be overwritten anyway.
+ */
+#if !defined(CRT1_AREAS_NOCLEAR_MASK) || defined(__DOXYGEN__)
+#define CRT1_AREAS_NOCLEAR_MASK             0x00U
+#endif
+
+/**
+ * @brief   Boot phases timestamps switch.
+ * @details If enabled the startup code records the time of the reset and
+ *          RAM initialization phases into @p __crt1_boot_timestamps[], the
+ *          following phases are recorded by the application using
+ *          @p __crt1_boot_timestamp().
+ * @note    The default time base is the DWT cycle counter, on cores without
+ *          it, or under emulators not implementing it, a different source
+ *          can be specified by defining @p CRT1_BOOT_TIMESTAMP_GET().
+ */
+#if !defined(CRT1_BOOT_TIMESTAMPS) || defined(__DOXYGEN__)
+#define CRT1_BOOT_TIMESTAMPS                FALSE
+#endif
+
 #if (CRT1_AREAS_NUMBER < 0) || (CRT1_AREAS_NUMBER > 8)
 #error "CRT1_AREAS_NUMBER must be within 0 and 8"
 #endif
 
+#if ((CRT1_AREAS_LZ_MASK | CRT1_AREAS_NOCLEAR_MASK) &                       \
+     ~((1U << CRT1_AREAS_NUMBER) - 1U)) != 0U
+#error "CRT1_AREAS_LZ_MASK or CRT1_AREAS_NOCLEAR_MASK out of range"
+#endif
+
+#if (CRT1_BOOT_TIMESTAMPS == TRUE) && !defined(CRT1_BOOT_TIMESTAMP_GET)
+#if CORTEX_MODEL < 3
+#error "CRT1_BOOT_TIMESTAMPS requires CRT1_BOOT_TIMESTAMP_GET on this core"
+#endif
+#define CRT1_BOOT_TIMESTAMP_GET()           (DWT->CYCCNT)
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
 
+#if (CRT1_BOOT_TIMESTAMPS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Boot phases timestamps table.
+ * @note    Entries are expressed in @p CRT1_BOOT_TIMESTAMP_GET() units
+ *          counted from the reset phase.
+ */
+uint32_t __crt1_boot_timestamps[CRT1_BOOT_PHASES_NUMBER];
+#endif
+
 /*===========================================================================*/
 /* Module local types.                                                       */
 /*===========================================================================*/
@@ -120,6 +197,120 @@ static const ram_init_area_t ram_areas[CRT1_AREAS_NUMBER] = {
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CRT1_AREAS_NUMBER > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Copies an initialization image into a RAM area.
+ *
+ * @param[out] p        start of the destination area
+ * @param[in] tp        start of the initialization image
+ * @param[in] end       end of the destination area
+ */
+static void crt1_area_copy(uint32_t *p, const uint32_t *tp,
+                           const uint32_t *end) {
+
+#if CRT1_AREAS_FAST_INIT == TRUE
+  while ((size_t)(end - p) >= 4U) {
+    uint32_t w0 = tp[0], w1 = tp[1], w2 = tp[2], w3 = tp[3];
+
+    p[0] = w0;
+    p[1] = w1;
+    p[2] = w2;
+    p[3] = w3;
+    p  += 4;
+    tp += 4;
+  }
+#endif
+
+  while (p < end) {
+    *p = *tp;
+    p++;
+    tp++;
+  }
+}
+
+/**
+ * @brief   Zeroes a RAM area.
+ *
+ * @param[out] p        start of the area
+ * @param[in] end       end of the area
+ */
+static void crt1_area_clear(uint32_t *p, const uint32_t *end) {
+
+#if CRT1_AREAS_FAST_INIT == TRUE
+  while ((size_t)(end - p) >= 4U) {
+    p[0] = 0U;
+    p[1] = 0U;
+    p[2] = 0U;
+    p[3] = 0U;
+    p += 4;
+  }
+#endif
+
+  while (p < end) {
+    *p = 0U;
+    p++;
+  }
+}
+
+#if (CRT1_AREAS_LZ_MASK != 0U) || defined(__DOXYGEN__)
+/**
+ * @brief   Expands an LZ4 raw block into a RAM area.
+ * @note    The stream is trusted, it is generated at build time and there
+ *          is no bounds checking on the source side.
+ *
+ * @param[out] dp       start of the destination area
+ * @param[in] sp        start of the compressed image
+ * @param[in] end       end of the destination area
+ */
+static void crt1_area_expand(uint8_t *dp, const uint8_t *sp,
+                             const uint8_t *end) {
+
+  while (dp < end) {
+    unsigned token = (unsigned)*sp++;
+    size_t n, offset;
+    const uint8_t *mp;
+
+    /* Literals run.*/
+    n = (size_t)(token >> 4);
+    if (n == 15U) {
+      uint8_t b;
+      do {
+        b = *sp++;
+        n += (size_t)b;
+      } while (b == 255U);
+    }
+    while (n > 0U) {
+      *dp++ = *sp++;
+      n--;
+    }
+
+    /* The last sequence is made of literals only.*/
+    if (dp >= end) {
+      break;
+    }
+
+    /* Match copy, it can overlap the destination.*/
+    offset = (size_t)sp[0] | ((size_t)sp[1] << 8);
+    sp += 2;
+    n = (size_t)(token & 15U);
+    if (n == 15U) {
+      uint8_t b;
+      do {
+        b = *sp++;
+        n += (size_t)b;
+      } while (b == 255U);
+    }
+    n += 4U;
+    mp = dp - offset;
+    while (n > 0U) {
+      *dp++ = *mp++;
+      n--;
+    }
+  }
+}
+#endif /* CRT1_AREAS_LZ_MASK != 0U */
+#endif /* CRT1_AREAS_NUMBER > 0 */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -136,6 +327,10 @@ __attribute__((weak))
 /*lint -save -e9075 [8.4] All symbols are invoked from asm context.*/
 void __core_init(void) {
 
+#if CRT1_BOOT_TIMESTAMPS == TRUE
+  __crt1_boot_timestamps_start();
+#endif
+
 #if CORTEX_MODEL == 7
   SCB_EnableICache();
   SCB_EnableDCache();
@@ -191,33 +386,86 @@ void __default_exit(void) {
   }
 }
 
+#if (CRT1_BOOT_TIMESTAMPS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the boot timestamps time base.
+ * @details The default implementation enables and zeroes the DWT cycle
+ *          counter, the reset phase is the time origin.
+ * @note    This function is invoked by the default @p __core_init(), an
+ *          application overriding @p __core_init() must call it too.
+ * @note    This function is a weak symbol.
+ */
+#if !defined(__DOXYGEN__)
+__attribute__((weak))
+#endif
+void __crt1_boot_timestamps_start(void) {
+
+#if CORTEX_MODEL >= 3
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+/**
+ * @brief   Records the timestamp of a boot phase.
+ * @note    Phases past @p CRT1_BOOT_PHASE_RAM_INIT must be recorded by
+ *          the application, for example right after @p halInit().
+ *
+ * @param[in] phase     the boot phase identifier
+ */
+void __crt1_boot_timestamp(unsigned phase) {
+
+  if (phase < (unsigned)CRT1_BOOT_PHASES_NUMBER) {
+    __crt1_boot_timestamps[phase] = (uint32_t)CRT1_BOOT_TIMESTAMP_GET();
+  }
+}
+#endif /* CRT1_BOOT_TIMESTAMPS == TRUE */
+
 /**
  * @brief   Performs the initialization of the various RAM areas.
  */
 void __init_ram_areas(void) {
 #if CRT1_AREAS_NUMBER > 0
   const ram_init_area_t *rap = ram_areas;
+  unsigned mask = 1U;
 
   do {
-    uint32_t *tp = rap->init_text_area;
-    uint32_t *p = rap->init_area;
-
-    /* Copying initialization data.*/
-    while (p < rap->clear_area) {
-      *p = *tp;
-      p++;
-      tp++;
-    }
+    /* Empty areas are skipped.*/
+    if (rap->init_area < rap->no_init_area) {
+
+      /* Initialization data.*/
+      if (rap->init_area < rap->clear_area) {
+#if CRT1_AREAS_LZ_MASK != 0U
+        if ((mask & (unsigned)CRT1_AREAS_LZ_MASK) != 0U) {
+          crt1_area_expand((uint8_t *)rap->init_area,
+                           (const uint8_t *)rap->init_text_area,
+                           (const uint8_t *)rap->clear_area);
+        }
+        else
+#endif
+        {
+          crt1_area_copy(rap->init_area, rap->init_text_area,
+                         rap->clear_area);
+        }
+      }
 
-    /* Zeroing clear area.*/
-    while (p < rap->no_init_area) {
-      *p = 0;
-      p++;
+      /* Zeroing clear area.*/
+      if ((mask & (unsigned)CRT1_AREAS_NOCLEAR_MASK) == 0U) {
+        crt1_area_clear(rap->clear_area, rap->no_init_area);
+      }
     }
+    mask <<= 1;
     rap++;
   }
   while (rap < &ram_areas[CRT1_AREAS_NUMBER]);
 #endif
+
+#if CRT1_BOOT_TIMESTAMPS == TRUE
+  /* Note, the table is in BSS and has been cleared at this point, the
+     reset phase entry is zero by definition.*/
+  __crt1_boot_timestamp(CRT1_BOOT_PHASE_RAM_INIT);
+#endif
 }
 
 /** @} */
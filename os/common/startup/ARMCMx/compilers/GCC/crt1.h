@@ -0,0 +1,84 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ARMCMx/compilers/GCC/crt1.h
+ * @brief   Startup stub functions header.
+ *
+ * @addtogroup ARMCMx_GCC_STARTUP
+ * @{
+ */
+
+#ifndef CRT1_H
+#define CRT1_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Boot phases identifiers
+ * @{
+ */
+#define CRT1_BOOT_PHASE_RESET               0U
+#define CRT1_BOOT_PHASE_RAM_INIT            1U
+#define CRT1_BOOT_PHASE_HAL_INIT            2U
+#define CRT1_BOOT_PHASE_SYS_INIT            3U
+#define CRT1_BOOT_PHASE_FIRST_THREAD        4U
+#define CRT1_BOOT_PHASES_NUMBER             5U
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(_FROM_ASM_)
+/* Only available if CRT1_BOOT_TIMESTAMPS is enabled in the startup code.*/
+extern uint32_t __crt1_boot_timestamps[CRT1_BOOT_PHASES_NUMBER];
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void __crt1_boot_timestamps_start(void);
+  void __crt1_boot_timestamp(unsigned phase);
+#ifdef __cplusplus
+}
+#endif
+#endif /* !defined(_FROM_ASM_) */
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CRT1_H */
+
+/** @} */
@@ -59,6 +59,14 @@ else
   LDOPT := $(LDOPT),--defsym=__main_stack_size__=$(USE_EXCEPTIONS_STACKSIZE)
 endif
 
+# RAM areas stored compressed in flash, list of area numbers
+ifneq ($(USE_CRT1_LZ_AREAS),)
+  DDEFS += -DCRT1_AREAS_LZ_MASK="($(foreach n,$(USE_CRT1_LZ_AREAS),(1U<<$(n))|)0U)"
+  ifeq ($(LZ4RAW),)
+    LZ4RAW = python3 $(CHIBIOS)/tools/lz4raw.py
+  endif
+endif
+
 # Output directory and files
 ifeq ($(BUILDDIR),)
   BUILDDIR = build
@@ -204,6 +212,15 @@ else
 	@echo Linking $@
 	@$(LD) $(OBJS) $(LDFLAGS) $(LIBS) -o $@
 endif
+ifneq ($(USE_CRT1_LZ_AREAS),)
+	@for n in $(USE_CRT1_LZ_AREAS); do \
+	  echo Compressing .ram$${n}_init; \
+	  $(CP) -O binary --only-section=.ram$${n}_init $@ $(OBJDIR)/ram$${n}_init.bin && \
+	  $(LZ4RAW) $(OBJDIR)/ram$${n}_init.bin $(OBJDIR)/ram$${n}_init.lz4 && \
+	  $(CP) --update-section .ram$${n}_init=$(OBJDIR)/ram$${n}_init.lz4 $@ || \
+	  { rm -f $@; exit 1; }; \
+	done
+endif
 
 %.hex: %.elf
 ifeq ($(USE_VERBOSE_COMPILE),yes)
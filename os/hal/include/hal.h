@@ -42,6 +42,10 @@
 #define HAL_USE_CAN                         FALSE
 #endif
 
+#if !defined(HAL_USE_CRC)
+#define HAL_USE_CRC                         FALSE
+#endif
+
 #if !defined(HAL_USE_CRY)
 #define HAL_USE_CRY                         FALSE
 #endif
@@ -138,6 +142,7 @@
 #include "hal_pal.h"
 #include "hal_adc.h"
 #include "hal_can.h"
+#include "hal_crc.h"
 #include "hal_crypto.h"
 #include "hal_dac.h"
 #include "hal_gpt.h"
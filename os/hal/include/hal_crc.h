@@ -0,0 +1,285 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crc.h
+ * @brief   CRC Driver macros and structures.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#ifndef HAL_CRC_H
+#define HAL_CRC_H
+
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Standard CRC models
+ * @details Initializers of the model fields of a @p CRCConfig structure,
+ *          in order width, polynomial, initial value, final XOR value, input
+ *          reflection and output reflection.
+ * @{
+ */
+/**
+ * @brief   CRC-7/MMC, MMC/SD commands, check value 0x75.
+ */
+#define CRC_MODEL_CRC7_MMC          7U, 0x09U, 0x00U, 0x00U, false, false
+
+/**
+ * @brief   CRC-16/CCITT-FALSE, check value 0x29B1.
+ */
+#define CRC_MODEL_CRC16_CCITT       16U, 0x1021U, 0xFFFFU, 0x0000U,       \
+                                    false, false
+
+/**
+ * @brief   CRC-16/XMODEM, MMC/SD data blocks, check value 0x31C3.
+ */
+#define CRC_MODEL_CRC16_XMODEM      16U, 0x1021U, 0x0000U, 0x0000U,       \
+                                    false, false
+
+/**
+ * @brief   CRC-32, Ethernet and ZIP, check value 0xCBF43926.
+ */
+#define CRC_MODEL_CRC32             32U, 0x04C11DB7U, 0xFFFFFFFFU,        \
+                                    0xFFFFFFFFU, true, true
+
+/**
+ * @brief   CRC-32C (Castagnoli), iSCSI and ext4, check value 0xE3069283.
+ */
+#define CRC_MODEL_CRC32C            32U, 0x1EDC6F41U, 0xFFFFFFFFU,        \
+                                    0xFFFFFFFFU, true, true
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the SW fall-back of the CRC driver.
+ * @details When enabled, this option, activates a fall-back software
+ *          implementation for CRC models not supported by the underlying
+ *          hardware.
+ */
+#if !defined(HAL_CRC_USE_FALLBACK) || defined(__DOXYGEN__)
+#define HAL_CRC_USE_FALLBACK                TRUE
+#endif
+
+/**
+ * @brief   Makes the driver forcibly use the fall-back implementation.
+ * @note    If enabled then the LLD driver is not included at all.
+ */
+#if !defined(HAL_CRC_ENFORCE_FALLBACK) || defined(__DOXYGEN__)
+#define HAL_CRC_ENFORCE_FALLBACK            FALSE
+#endif
+
+/**
+ * @brief   Number of lookup tables used by the fall-back implementation.
+ * @details With 8 tables the data is processed 8 bytes at time
+ *          (slicing-by-8), each table takes 1kB. Values 4 and 1 trade
+ *          speed for memory.
+ */
+#if !defined(HAL_CRC_FALLBACK_SLICES) || defined(__DOXYGEN__)
+#define HAL_CRC_FALLBACK_SLICES             8
+#endif
+
+/**
+ * @brief   Enables the @p crcAcquireBus() and @p crcReleaseBus() APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(CRC_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
+#define CRC_USE_MUTUAL_EXCLUSION            TRUE
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_CRC_ENFORCE_FALLBACK == TRUE
+#undef HAL_CRC_USE_FALLBACK
+#define HAL_CRC_USE_FALLBACK                TRUE
+#endif
+
+#if (HAL_CRC_FALLBACK_SLICES != 1) && (HAL_CRC_FALLBACK_SLICES != 4) &&     \
+    (HAL_CRC_FALLBACK_SLICES != 8)
+#error "invalid HAL_CRC_FALLBACK_SLICES value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  CRC_UNINIT = 0,                   /**< Not initialized.                   */
+  CRC_STOP = 1,                     /**< Stopped.                           */
+  CRC_READY = 2                     /**< Ready.                             */
+} crcstate_t;
+
+/**
+ * @brief   Type of a structure representing a CRC driver.
+ */
+typedef struct hal_crc_driver CRCDriver;
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct hal_crc_config CRCConfig;
+
+/**
+ * @brief   Fall-back lookup tables.
+ * @note    The tables are computed on the first use of a configuration
+ *          pointing to them, configurations of the same model can share
+ *          the same tables.
+ */
+typedef struct {
+  /**
+   * @brief   Tables initialized flag.
+   */
+  bool                      ready;
+  /**
+   * @brief   Lookup tables.
+   */
+  uint32_t                  t[HAL_CRC_FALLBACK_SLICES][256];
+} crc_table_t;
+
+#if HAL_CRC_ENFORCE_FALLBACK == FALSE
+/* Use the defined low level driver.*/
+#include "hal_crc_lld.h"
+
+#else /* HAL_CRC_ENFORCE_FALLBACK == TRUE */
+/* No LLD at all, using the standalone mode.*/
+
+#define crc_lld_driver_fields                                               \
+  /* Dummy field, it is not needed.*/                                       \
+  uint32_t                  dummy
+#endif /* HAL_CRC_ENFORCE_FALLBACK == TRUE */
+
+/**
+ * @brief   Driver configuration structure.
+ * @note    The model fields can be initialized using one of the
+ *          @p CRC_MODEL_xxx macros.
+ * @note    There are no low level fields, the model is everything the
+ *          low level driver needs.
+ */
+struct hal_crc_config {
+  /**
+   * @brief   CRC width in bits, from 1 to 32.
+   */
+  uint32_t                  width;
+  /**
+   * @brief   Polynomial, normal representation without the top bit.
+   */
+  uint32_t                  poly;
+  /**
+   * @brief   Initial value, normal representation.
+   */
+  uint32_t                  init;
+  /**
+   * @brief   Value XORed to the final CRC.
+   */
+  uint32_t                  xorout;
+  /**
+   * @brief   Input bytes processed starting from the LSB.
+   */
+  bool                      refin;
+  /**
+   * @brief   Final CRC reflected.
+   */
+  bool                      refout;
+#if (HAL_CRC_USE_FALLBACK == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Fall-back lookup tables or @p NULL.
+   * @note    If @p NULL the fall-back implementation processes the data
+   *          one bit at time, without any lookup table.
+   */
+  crc_table_t               *table;
+#endif
+};
+
+/**
+ * @brief   Structure representing a CRC driver.
+ */
+struct hal_crc_driver {
+  /**
+   * @brief   Driver state.
+   */
+  crcstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const CRCConfig           *config;
+#if (HAL_CRC_USE_FALLBACK == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   The current configuration is handled by the hardware.
+   */
+  bool                      hw;
+  /**
+   * @brief   Fall-back engine state.
+   */
+  uint32_t                  crc;
+#endif
+#if (CRC_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the driver.
+   */
+  mutex_t                   mutex;
+#endif
+#if defined(CRC_DRIVER_EXT_FIELDS)
+  CRC_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  crc_lld_driver_fields;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void crcInit(void);
+  void crcObjectInit(CRCDriver *crcp);
+  void crcStart(CRCDriver *crcp, const CRCConfig *config);
+  void crcStop(CRCDriver *crcp);
+  void crcReset(CRCDriver *crcp);
+  void crcUpdate(CRCDriver *crcp, size_t n, const void *buf);
+  uint32_t crcGetValue(CRCDriver *crcp);
+  uint32_t crcCalc(CRCDriver *crcp, size_t n, const void *buf);
+#if CRC_USE_MUTUAL_EXCLUSION == TRUE
+  void crcAcquireBus(CRCDriver *crcp);
+  void crcReleaseBus(CRCDriver *crcp);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CRC == TRUE */
+
+#endif /* HAL_CRC_H */
+
+/** @} */
@@ -31,6 +31,11 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Maximum size of a key stored in a key slot, in bytes.
+ */
+#define CRY_KEY_MAX_SIZE                    64U
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -54,6 +59,21 @@
 #define HAL_CRY_ENFORCE_FALLBACK            FALSE
 #endif
 
+/**
+ * @brief   Number of key slots.
+ * @details Keys loaded in slots are identified by the returned key
+ *          identifier and are kept in their expanded form, AES round keys
+ *          and HMAC padded key states are computed once at load time.
+ *          When all slots are in use the least recently used key is
+ *          evicted.
+ * @note    The slots table is shared among all driver instances.
+ * @note    Zero disables the key slots, only the transient keys can be
+ *          used.
+ */
+#if !defined(HAL_CRY_KEY_SLOTS) || defined(__DOXYGEN__)
+#define HAL_CRY_KEY_SLOTS                   0
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -63,6 +83,10 @@
 #define HAL_CRY_USE_FALLBACK                TRUE
 #endif
 
+#if (HAL_CRY_KEY_SLOTS < 0) || (HAL_CRY_KEY_SLOTS > 254)
+#error "invalid HAL_CRY_KEY_SLOTS value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -145,7 +169,7 @@ typedef enum {
 #define CRY_LLD_SUPPORTS_HMAC_SHA256        FALSE
 #define CRY_LLD_SUPPORTS_HMAC_SHA512        FALSE
 
-typedef uint_fast8_t crykey_t;
+typedef uint32_t crykey_t;
 
 typedef struct CRYDriver CRYDriver;
 
@@ -204,6 +228,45 @@ typedef struct {
 } HMACSHA512Context;
 #endif
 
+#if (HAL_CRY_KEY_SLOTS > 0) || (HAL_CRY_USE_FALLBACK == TRUE) ||            \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Type of a key slot.
+ */
+typedef struct {
+  /**
+   * @brief   Algorithm of the stored key, @p cry_algo_none if free.
+   */
+  cryalgorithm_t            algo;
+  /**
+   * @brief   Generation counter, it invalidates stale key identifiers.
+   */
+  uint8_t                   gen;
+  /**
+   * @brief   Last use time stamp for LRU eviction.
+   */
+  uint32_t                  stamp;
+  /**
+   * @brief   Driver having this key currently loaded in its LLD.
+   */
+  CRYDriver                 *loaded;
+  /**
+   * @brief   Key size in bytes.
+   */
+  size_t                    size;
+  /**
+   * @brief   Key data.
+   */
+  uint8_t                   key[CRY_KEY_MAX_SIZE];
+#if (HAL_CRY_USE_FALLBACK == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Expanded key for the fall-back implementations.
+   */
+  crykeysched_t             sched;
+#endif
+} crykeyslot_t;
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -225,6 +288,22 @@ extern "C" {
   void cryObjectInit(CRYDriver *cryp);
   void cryStart(CRYDriver *cryp, const CRYConfig *config);
   void cryStop(CRYDriver *cryp);
+#if HAL_CRY_KEY_SLOTS > 0
+  cryerror_t cryLoadAESKey(CRYDriver *cryp,
+                           size_t size,
+                           const uint8_t *keyp,
+                           crykey_t *key_idp);
+  cryerror_t cryLoadHMACKey(CRYDriver *cryp,
+                            size_t size,
+                            const uint8_t *keyp,
+                            crykey_t *key_idp);
+  cryerror_t cryDeleteKey(CRYDriver *cryp, crykey_t key_id);
+  cryerror_t _cry_key_get(crykey_t key_id,
+                          cryalgorithm_t algo,
+                          crykeyslot_t **slotpp);
+#endif
+  void cryDeleteAllKeys(CRYDriver *cryp);
+  void _cry_wipe(void *p, size_t n);
   cryerror_t cryLoadAESTransientKey(CRYDriver *cryp,
                                     size_t size,
                                     const uint8_t *keyp);
@@ -353,6 +432,9 @@ extern "C" {
                                      const uint8_t *keyp);
   cryerror_t cryHMACSHA256Init(CRYDriver *cryp,
                                HMACSHA256Context *hmacsha256ctxp);
+  cryerror_t cryHMACSHA256InitKey(CRYDriver *cryp,
+                                  crykey_t key_id,
+                                  HMACSHA256Context *hmacsha256ctxp);
   cryerror_t cryHMACSHA256Update(CRYDriver *cryp,
                                  HMACSHA256Context *hmacsha256ctxp,
                                  size_t size,
@@ -362,6 +444,9 @@ extern "C" {
                                 uint8_t *out);
   cryerror_t cryHMACSHA512Init(CRYDriver *cryp,
                                HMACSHA512Context *hmacsha512ctxp);
+  cryerror_t cryHMACSHA512InitKey(CRYDriver *cryp,
+                                  crykey_t key_id,
+                                  HMACSHA512Context *hmacsha512ctxp);
   cryerror_t cryHMACSHA512Update(CRYDriver *cryp,
                                  HMACSHA512Context *hmacsha512ctxp,
                                  size_t size,
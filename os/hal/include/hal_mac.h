@@ -30,6 +30,20 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    MAC checksum offload capabilities
+ * @{
+ */
+#define MAC_CAP_CHECKSUM_GEN_IP     (1U << 0)   /**< IP header generation.  */
+#define MAC_CAP_CHECKSUM_GEN_UDP    (1U << 1)   /**< UDP generation.        */
+#define MAC_CAP_CHECKSUM_GEN_TCP    (1U << 2)   /**< TCP generation.        */
+#define MAC_CAP_CHECKSUM_GEN_ICMP   (1U << 3)   /**< ICMP generation.       */
+#define MAC_CAP_CHECKSUM_CHECK_IP   (1U << 4)   /**< IP header checking.    */
+#define MAC_CAP_CHECKSUM_CHECK_UDP  (1U << 5)   /**< UDP checking.          */
+#define MAC_CAP_CHECKSUM_CHECK_TCP  (1U << 6)   /**< TCP checking.          */
+#define MAC_CAP_CHECKSUM_CHECK_ICMP (1U << 7)   /**< ICMP checking.         */
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -97,6 +111,23 @@ typedef struct MACDriver MACDriver;
 #define macGetReceiveEventSource(macp)  (&(macp)->rdevent)
 #endif
 
+/**
+ * @brief   Returns the driver capabilities.
+ * @details The returned mask tells which checksums are generated on
+ *          transmission and verified on reception by the hardware, the
+ *          upper layers can skip those operations.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The capabilities mask.
+ *
+ * @api
+ */
+#if defined(mac_lld_get_capabilities) || defined(__DOXYGEN__)
+#define macGetCapabilities(macp)        mac_lld_get_capabilities(macp)
+#else
+#define macGetCapabilities(macp)        0U
+#endif
+
 /**
  * @brief   Writes to a transmit descriptor's stream.
  *
@@ -85,6 +85,14 @@ typedef struct {
    * @brief SPI high speed configuration used during transfers.
    */
   const SPIConfig       *hscfg;
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief CRC driver used for data blocks or @p NULL.
+   * @note  If specified, the CRC of read blocks is verified and the
+   *        CRC of written blocks is sent, else the data CRC is ignored.
+   */
+  CRCDriver             *crcp;
+#endif
 } MMCConfig;
 
 /**
@@ -102,7 +102,8 @@ typedef struct SerialDriver SerialDriver;
  * @brief   @p SerialDriver specific methods.
  */
 #define _serial_driver_methods                                              \
-  _base_asynchronous_channel_methods
+  _base_asynchronous_channel_methods                                        \
+  _vectored_stream_methods
 
 /**
  * @extends BaseAsynchronousChannelVMT
@@ -138,7 +138,8 @@ typedef struct {
  * @brief   @p SerialUSBDriver specific methods.
  */
 #define _serial_usb_driver_methods                                          \
-  _base_asynchronous_channel_methods
+  _base_asynchronous_channel_methods                                        \
+  _vectored_stream_methods
 
 /**
  * @extends BaseAsynchronousChannelVMT
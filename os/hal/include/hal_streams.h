@@ -44,6 +44,16 @@
 #define STM_RESET            MSG_RESET
 /** @} */
 
+/**
+ * @brief   Type of a data segment for vectored I/O.
+ * @note    Segments written from constant data need a cast of the pointer,
+ *          the data is not modified by write operations.
+ */
+typedef struct {
+  uint8_t               *bp;            /**< @brief Segment data.           */
+  size_t                n;              /**< @brief Segment size.           */
+} stream_iovec_t;
+
 /**
  * @brief   BaseSequentialStream specific methods.
  */
@@ -58,6 +68,20 @@
   /* Channel get method, blocking.*/                                        \
   msg_t (*get)(void *instance);                                             \
 
+/**
+ * @brief   Vectored I/O methods.
+ * @details Optional methods, the classes implementing vectored I/O append
+ *          them at the end of their VMT so that the layout of the base
+ *          VMTs is not affected.
+ */
+#define _vectored_stream_methods                                            \
+  /* Vectored write method with timeout specification.*/                    \
+  size_t (*writev)(void *instance, const stream_iovec_t *iov,               \
+                   size_t n, sysinterval_t time);                           \
+  /* Vectored read method with timeout specification.*/                     \
+  size_t (*readv)(void *instance, const stream_iovec_t *iov,                \
+                  size_t n, sysinterval_t time);
+
 /**
  * @brief   @p BaseSequentialStream specific data.
  * @note    It is empty because @p BaseSequentialStream is only an interface
@@ -151,6 +175,89 @@ typedef struct {
 #define streamGet(ip) ((ip)->vmt->get(ip))
 /** @} */
 
+/**
+ * @name    Macro Functions (vectored I/O)
+ * @note    The object must implement vectored I/O, its VMT must include
+ *          @p _vectored_stream_methods.
+ * @{
+ */
+/**
+ * @brief   Sequential Stream vectored write.
+ * @details The function writes data from a sequence of segments to a
+ *          stream, the segments are transferred in order as a single
+ *          buffer.
+ *
+ * @param[in] ip        pointer to an object implementing vectored I/O
+ * @param[in] iov       pointer to an array of @p stream_iovec_t
+ * @param[in] n         number of segments
+ * @return              The number of bytes transferred. The return value can
+ *                      be less than the total size of the segments if an
+ *                      end-of-file condition has been met.
+ *
+ * @api
+ */
+#define streamWriteV(ip, iov, n)                                            \
+  ((ip)->vmt->writev(ip, iov, n, TIME_INFINITE))
+
+/**
+ * @brief   Sequential Stream vectored read.
+ * @details The function reads data from a stream into a sequence of
+ *          segments, the segments are filled in order as a single buffer.
+ *
+ * @param[in] ip        pointer to an object implementing vectored I/O
+ * @param[in] iov       pointer to an array of @p stream_iovec_t
+ * @param[in] n         number of segments
+ * @return              The number of bytes transferred. The return value can
+ *                      be less than the total size of the segments if an
+ *                      end-of-file condition has been met.
+ *
+ * @api
+ */
+#define streamReadV(ip, iov, n)                                             \
+  ((ip)->vmt->readv(ip, iov, n, TIME_INFINITE))
+
+/**
+ * @brief   Sequential Stream vectored write with timeout.
+ * @details The function writes data from a sequence of segments to a
+ *          stream, the segments are transferred in order as a single
+ *          buffer.
+ *
+ * @param[in] ip        pointer to an object implementing vectored I/O
+ * @param[in] iov       pointer to an array of @p stream_iovec_t
+ * @param[in] n         number of segments
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes transferred.
+ *
+ * @api
+ */
+#define streamWriteVTimeout(ip, iov, n, time)                               \
+  ((ip)->vmt->writev(ip, iov, n, time))
+
+/**
+ * @brief   Sequential Stream vectored read with timeout.
+ * @details The function reads data from a stream into a sequence of
+ *          segments, the segments are filled in order as a single buffer.
+ *
+ * @param[in] ip        pointer to an object implementing vectored I/O
+ * @param[in] iov       pointer to an array of @p stream_iovec_t
+ * @param[in] n         number of segments
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes transferred.
+ *
+ * @api
+ */
+#define streamReadVTimeout(ip, iov, n, time)                                \
+  ((ip)->vmt->readv(ip, iov, n, time))
+/** @} */
+
 #endif /* HAL_STREAMS_H */
 
 /** @} */
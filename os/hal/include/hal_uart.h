@@ -48,6 +48,16 @@
  * @{
  */
 #define UART_ERR_NOT_ACTIVE     (size_t)-1
+#define UART_ERR_OVERRUN        (size_t)-2
+/** @} */
+
+/**
+ * @name    UART circular receive events
+ * @{
+ */
+#define UART_RX_HALF_EVENT      1   /**< @brief First half filled.          */
+#define UART_RX_FULL_EVENT      2   /**< @brief Second half filled.         */
+#define UART_RX_IDLE_EVENT      4   /**< @brief Line idle after data.       */
 /** @} */
 
 /*===========================================================================*/
@@ -73,6 +83,15 @@
 #if !defined(UART_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
 #define UART_USE_MUTUAL_EXCLUSION           FALSE
 #endif
+
+/**
+ * @brief   Enables the circular receive APIs.
+ * @note    The low level driver must support the circular receive mode.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(UART_USE_CIRCULAR_RX) || defined(__DOXYGEN__)
+#define UART_USE_CIRCULAR_RX                FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -107,11 +126,43 @@ typedef enum {
 typedef enum {
   UART_RX_IDLE = 0,                 /**< Not receiving.                     */
   UART_RX_ACTIVE = 1,               /**< Receiving.                         */
-  UART_RX_COMPLETE = 2              /**< Buffer complete.                   */
+  UART_RX_COMPLETE = 2,             /**< Buffer complete.                   */
+  UART_RX_CIRCULAR = 3              /**< Receiving continuously.            */
 } uartrxstate_t;
 
+#if (UART_USE_CIRCULAR_RX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Circular receive fields of the @p UARTDriver structure.
+ * @note    Low level drivers supporting the circular receive mode include
+ *          these fields in their driver structure.
+ * @note    The written and read counters are free running, their difference
+ *          is the amount of pending data.
+ */
+#define _uart_circular_rx_data                                              \
+  /* Circular receive buffer.*/                                             \
+  uint8_t                   *rxcbuf;                                        \
+  /* Size of the circular receive buffer.*/                                 \
+  size_t                    rxcsize;                                        \
+  /* Frames counter value at the start of the current buffer lap.*/         \
+  size_t                    rxcbase;                                        \
+  /* Frames written into the buffer.*/                                      \
+  size_t                    rxcwr;                                          \
+  /* Frames consumed from the buffer.*/                                     \
+  size_t                    rxcrd;                                          \
+  /* Read position within the buffer.*/                                    \
+  size_t                    rxcrp;
+#endif
+
 #include "hal_uart_lld.h"
 
+#if UART_USE_CIRCULAR_RX == TRUE
+#if !defined(UART_SUPPORTS_CIRCULAR_RX)
+#error "UART_USE_CIRCULAR_RX not supported by the low level driver"
+#elif UART_SUPPORTS_CIRCULAR_RX != TRUE
+#error "UART_USE_CIRCULAR_RX not supported by the low level driver"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -381,6 +432,33 @@ typedef enum {
   _uart_wakeup_rx_cm_isr(uartp);                                            \
 }
 
+#if (UART_USE_CIRCULAR_RX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Circular receive ISR code.
+ * @details This code handles the portable part of the ISR code:
+ *          - Written frames counter update.
+ *          - Callback invocation.
+ *          .
+ * @note    This macro is meant to be used in the low level drivers
+ *          implementation only.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] events    mask of @p UART_RX_HALF_EVENT, @p UART_RX_FULL_EVENT
+ *                      and @p UART_RX_IDLE_EVENT
+ *
+ * @notapi
+ */
+#define _uart_rx_circular_isr_code(uartp, events) {                         \
+  osalSysLockFromISR();                                                     \
+  _uart_rx_circular_update(uartp,                                           \
+                           ((events) & UART_RX_FULL_EVENT) != 0U);          \
+  osalSysUnlockFromISR();                                                   \
+  if ((uartp)->config->rxcirc_cb != NULL) {                                 \
+    (uartp)->config->rxcirc_cb(uartp, (uartflags_t)(events));               \
+  }                                                                         \
+}
+#endif /* UART_USE_CIRCULAR_RX == TRUE */
+
 /** @} */
 
 /*===========================================================================*/
@@ -414,6 +492,15 @@ extern "C" {
   void uartAcquireBus(UARTDriver *uartp);
   void uartReleaseBus(UARTDriver *uartp);
 #endif
+#if UART_USE_CIRCULAR_RX == TRUE
+  void uartStartReceiveCircular(UARTDriver *uartp, size_t n, uint8_t *rxbuf);
+  void uartStartReceiveCircularI(UARTDriver *uartp, size_t n, uint8_t *rxbuf);
+  size_t uartCircularGetI(UARTDriver *uartp, uint8_t **pp);
+  void uartCircularReleaseI(UARTDriver *uartp, size_t n);
+  size_t uartCircularToBuffersI(UARTDriver *uartp,
+                                input_buffers_queue_t *ibqp);
+  void _uart_rx_circular_update(UARTDriver *uartp, bool wrapped);
+#endif
 #ifdef __cplusplus
 }
 #endif
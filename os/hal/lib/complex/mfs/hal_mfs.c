@@ -23,9 +23,14 @@
  * @details This module manages a flash partition as a generic storage where
  *          arbitrary data records can be created, updated, deleted and
  *          retrieved.<br>
- *          A managed partition is composed of two banks of equal size, a
- *          bank is composed of one or more erasable sectors, a sector is
- *          divided in writable pages.<br>
+ *          A managed partition is composed of two or more banks of equal
+ *          size, a bank is composed of one or more erasable sectors, a
+ *          sector is divided in writable pages.<br>
+ *          Banks are used as a log-structured ring, records are appended
+ *          to the most recent bank and, when it is full, the next erased
+ *          bank is put in use. One bank is always kept erased, when it
+ *          would be needed the oldest bank is reclaimed by relocating the
+ *          live records it still holds and erasing it.<br>
  *          The module handles flash wear leveling and recovery of damaged
  *          banks (where possible) caused by power loss during operations.
  *          Both operations are transparent to the user.
@@ -44,7 +49,12 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
-#define PAIR(a, b) (((unsigned)(a) << 2U) | (unsigned)(b))
+/**
+ * @brief   Number of banks in the managed partition.
+ */
+#define MFS_BANKS_COUNT(mfsp)                                               \
+  ((mfsp)->config->bank_count == 0U ? (mfs_bank_t)2 :                       \
+                                      (mfsp)->config->bank_count)
 
 /**
  * @brief   Error check helper.
@@ -99,6 +109,22 @@ static const uint16_t crc16_table[256] = {
   0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
 };
 
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+#if (HAL_CRC_USE_FALLBACK == TRUE) || defined(__DOXYGEN__)
+static crc_table_t mfs_crc_table;
+#endif
+
+/**
+ * @brief   CRC16-CCITT configuration for the CRC driver.
+ */
+static const CRCConfig mfs_crc_config = {
+  CRC_MODEL_CRC16_CCITT,
+#if HAL_CRC_USE_FALLBACK == TRUE
+  &mfs_crc_table
+#endif
+};
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -114,6 +140,43 @@ uint16_t crc16(uint16_t crc, const uint8_t *data, size_t n) {
   return crc;
 }
 
+/**
+ * @brief   Computes the CRC16-CCITT of a data block.
+ * @details The CRC driver associated to the MFS instance is used if
+ *          specified, else the CRC is computed in software.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] data      pointer to the data
+ * @param[in] n         number of bytes
+ * @return              The CRC value.
+ *
+ * @notapi
+ */
+static uint16_t mfs_crc16(MFSDriver *mfsp, const uint8_t *data, size_t n) {
+#if HAL_USE_CRC == TRUE
+  CRCDriver *crcp = mfsp->config->crcp;
+
+  if (crcp != NULL) {
+    uint16_t crc;
+
+#if CRC_USE_MUTUAL_EXCLUSION == TRUE
+    crcAcquireBus(crcp);
+#endif
+    crcStart(crcp, &mfs_crc_config);
+    crc = (uint16_t)crcCalc(crcp, n, data);
+#if CRC_USE_MUTUAL_EXCLUSION == TRUE
+    crcReleaseBus(crcp);
+#endif
+
+    return crc;
+  }
+#else
+  (void)mfsp;
+#endif
+
+  return crc16(0xFFFFU, data, n);
+}
+
 static void mfs_state_reset(MFSDriver *mfsp) {
   unsigned i;
 
@@ -122,19 +185,37 @@ static void mfs_state_reset(MFSDriver *mfsp) {
   mfsp->next_offset     = 0U;
   mfsp->used_space      = 0U;
 
+  for (i = 0; i < MFS_CFG_MAX_BANKS; i++) {
+    mfsp->banks[i].counter = 0U;
+  }
+
   for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
     mfsp->descriptors[i].offset = 0U;
     mfsp->descriptors[i].size   = 0U;
   }
 }
 
+static void mfs_bank_get_sectors(MFSDriver *mfsp, mfs_bank_t bank,
+                                 flash_sector_t *startp, flash_sector_t *np) {
+
+  if (bank == MFS_BANK_0) {
+    *startp = mfsp->config->bank0_start;
+    *np     = mfsp->config->bank0_sectors;
+  }
+  else {
+    *startp = mfsp->config->bank1_start +
+              ((flash_sector_t)bank - 1U) * mfsp->config->bank1_sectors;
+    *np     = mfsp->config->bank1_sectors;
+  }
+}
+
 static flash_offset_t mfs_flash_get_bank_offset(MFSDriver *mfsp,
                                                 mfs_bank_t bank) {
+  flash_sector_t sector, n;
+
+  mfs_bank_get_sectors(mfsp, bank, &sector, &n);
 
-  return bank == MFS_BANK_0 ? flashGetSectorOffset(mfsp->config->flashp,
-                                                   mfsp->config->bank0_start) :
-                              flashGetSectorOffset(mfsp->config->flashp,
-                                                   mfsp->config->bank1_start);
+  return flashGetSectorOffset(mfsp->config->flashp, sector);
 }
 
 /**
@@ -292,6 +373,7 @@ static mfs_error_t mfs_record_check(MFSDriver *mfsp,
 
 /**
  * @brief   Erases and verifies all sectors belonging to a bank.
+ * @note    The bank is marked as erased and its erase counter is increased.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @param[in] bank      bank to be erased
@@ -300,18 +382,11 @@ static mfs_error_t mfs_record_check(MFSDriver *mfsp,
  * @notapi
  */
 static mfs_error_t mfs_bank_erase(MFSDriver *mfsp, mfs_bank_t bank) {
-  flash_sector_t sector, end;
+  flash_sector_t sector, n;
 
-  if (bank == MFS_BANK_0) {
-    sector = mfsp->config->bank0_start;
-    end    = mfsp->config->bank0_start + mfsp->config->bank0_sectors;
-  }
-  else {
-    sector = mfsp->config->bank1_start;
-    end    = mfsp->config->bank1_start + mfsp->config->bank1_sectors;
-  }
+  mfs_bank_get_sectors(mfsp, bank, &sector, &n);
 
-  while (sector < end) {
+  while (n > 0U) {
     flash_error_t ferr;
 
     ferr = flashStartEraseSector(mfsp->config->flashp, sector);
@@ -331,8 +406,12 @@ static mfs_error_t mfs_bank_erase(MFSDriver *mfsp, mfs_bank_t bank) {
     }
 
     sector++;
+    n--;
   }
 
+  mfsp->banks[bank].counter = 0U;
+  mfsp->banks[bank].erase_count++;
+
   return MFS_NO_ERROR;
 }
 
@@ -346,18 +425,11 @@ static mfs_error_t mfs_bank_erase(MFSDriver *mfsp, mfs_bank_t bank) {
  * @notapi
  */
 static mfs_error_t mfs_bank_verify_erase(MFSDriver *mfsp, mfs_bank_t bank) {
-  flash_sector_t sector, end;
+  flash_sector_t sector, n;
 
-  if (bank == MFS_BANK_0) {
-    sector = mfsp->config->bank0_start;
-    end    = mfsp->config->bank0_start + mfsp->config->bank0_sectors;
-  }
-  else {
-    sector = mfsp->config->bank1_start;
-    end    = mfsp->config->bank1_start + mfsp->config->bank1_sectors;
-  }
+  mfs_bank_get_sectors(mfsp, bank, &sector, &n);
 
-  while (sector < end) {
+  while (n > 0U) {
     flash_error_t ferr;
 
     ferr = flashVerifyErase(mfsp->config->flashp, sector);
@@ -370,6 +442,7 @@ static mfs_error_t mfs_bank_verify_erase(MFSDriver *mfsp, mfs_bank_t bank) {
     }
 
     sector++;
+    n--;
   }
 
   return MFS_NO_ERROR;
@@ -377,6 +450,7 @@ static mfs_error_t mfs_bank_verify_erase(MFSDriver *mfsp, mfs_bank_t bank) {
 
 /**
  * @brief   Writes the validation header in a bank.
+ * @note    The bank erase counter is stored in the header.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @param[in] bank      bank to be validated
@@ -389,27 +463,29 @@ static mfs_error_t mfs_bank_verify_erase(MFSDriver *mfsp, mfs_bank_t bank) {
 static mfs_error_t mfs_bank_write_header(MFSDriver *mfsp,
                                          mfs_bank_t bank,
                                          uint32_t cnt) {
-  flash_sector_t sector;
   mfs_bank_header_t bhdr;
+  uint32_t erase_count;
 
-  if (bank == MFS_BANK_0) {
-    sector = mfsp->config->bank0_start;
-  }
-  else {
-    sector = mfsp->config->bank1_start;
+  erase_count = mfsp->banks[bank].erase_count;
+  if (erase_count > 0xFFFFU) {
+    erase_count = 0xFFFFU;
   }
 
-  bhdr.fields.magic1    = MFS_BANK_MAGIC_1;
-  bhdr.fields.magic2    = MFS_BANK_MAGIC_2;
-  bhdr.fields.counter   = cnt;
-  bhdr.fields.reserved1 = (uint16_t)mfsp->config->erased;
-  bhdr.fields.crc       = crc16(0xFFFFU, bhdr.hdr8,
-                                sizeof (mfs_bank_header_t) - sizeof (uint16_t));
-
-  return mfs_flash_write(mfsp,
-                         flashGetSectorOffset(mfsp->config->flashp, sector),
-                         sizeof (mfs_bank_header_t),
-                         bhdr.hdr8);
+  bhdr.fields.magic1      = MFS_BANK_MAGIC_1;
+  bhdr.fields.magic2      = MFS_BANK_MAGIC_2;
+  bhdr.fields.counter     = cnt;
+  bhdr.fields.erase_count = (uint16_t)(mfsp->config->erased ^ erase_count);
+  bhdr.fields.crc         = mfs_crc16(mfsp, bhdr.hdr8,
+                                      sizeof (mfs_bank_header_t) - sizeof (uint16_t));
+
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfs_flash_get_bank_offset(mfsp, bank),
+                               sizeof (mfs_bank_header_t),
+                               bhdr.hdr8));
+
+  mfsp->banks[bank].counter = cnt;
+
+  return MFS_NO_ERROR;
 }
 
 /**
@@ -437,9 +513,10 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
   start_offset = mfs_flash_get_bank_offset(mfsp, bank);
   end_offset   = start_offset + mfsp->config->bank_size;
 
-  /* Scanning records.*/
+  /* Scanning records, a tail smaller than a header cannot contain records
+     and is not read, it would overlap the following bank.*/
   hdr_offset = start_offset + (flash_offset_t)sizeof(mfs_bank_header_t);
-  while (hdr_offset < end_offset) {
+  while (hdr_offset + (flash_offset_t)sizeof(mfs_data_header_t) <= end_offset) {
     uint32_t size;
 
     /* Reading the current record header.*/
@@ -514,6 +591,8 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
  *                      - MFS_BANK_OK
  *                      .
  * @param[out] cntp     bank counter
+ * @param[out] erasesp  bank erase counter, only valid if the state is
+ *                      @p MFS_BANK_OK
  * @return              The operation status.
  *
  * @notapi
@@ -521,14 +600,16 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
 static mfs_error_t mfs_bank_get_state(MFSDriver *mfsp,
                                       mfs_bank_t bank,
                                       mfs_bank_state_t *statep,
-                                      uint32_t * cntp) {
+                                      uint32_t *cntp,
+                                      uint32_t *erasesp) {
   unsigned i;
   mfs_error_t err;
   uint16_t crc;
 
   /* Worst case is default.*/
-  *statep = MFS_BANK_GARBAGE;
-  *cntp   = 0U;
+  *statep  = MFS_BANK_GARBAGE;
+  *cntp    = 0U;
+  *erasesp = 0U;
 
   /* Reading the current bank header.*/
   RET_ON_ERROR(mfs_flash_read(mfsp, mfs_flash_get_bank_offset(mfsp, bank),
@@ -543,93 +624,201 @@ static mfs_error_t mfs_bank_get_state(MFSDriver *mfsp,
       if ((mfsp->buffer.bhdr.fields.magic1 != MFS_BANK_MAGIC_1) ||
           (mfsp->buffer.bhdr.fields.magic2 != MFS_BANK_MAGIC_2) ||
           (mfsp->buffer.bhdr.fields.counter == mfsp->config->erased) ||
-          (mfsp->buffer.bhdr.fields.reserved1 != (uint16_t)mfsp->config->erased)) {
+          (mfsp->buffer.bhdr.fields.counter == 0U)) {
         return MFS_NO_ERROR;
       }
 
       /* Verifying header CRC.*/
-      crc = crc16(0xFFFFU, mfsp->buffer.bhdr.hdr8,
-                  sizeof (mfs_bank_header_t) - sizeof (uint16_t));
+      crc = mfs_crc16(mfsp, mfsp->buffer.bhdr.hdr8,
+                      sizeof (mfs_bank_header_t) - sizeof (uint16_t));
       if (crc != mfsp->buffer.bhdr.fields.crc) {
         return MFS_NO_ERROR;
       }
 
-      *statep = MFS_BANK_OK;
-      *cntp   = mfsp->buffer.bhdr.fields.counter;
+      *statep  = MFS_BANK_OK;
+      *cntp    = mfsp->buffer.bhdr.fields.counter;
+      *erasesp = (uint32_t)(uint16_t)(mfsp->buffer.bhdr.fields.erase_count ^
+                                      (uint16_t)mfsp->config->erased);
 
       return MFS_NO_ERROR;
     }
   }
 
-  /* If the header is erased then it could be the whole block erased.*/
+  /* If the header is erased then it could be the whole block erased,
+     else it is garbage, for example data copied by an interrupted garbage
+     collection.*/
   err = mfs_bank_verify_erase(mfsp, bank);
   if (err == MFS_NO_ERROR) {
     *statep = MFS_BANK_ERASED;
   }
+  else if (err == MFS_ERR_NOT_ERASED) {
+    err = MFS_NO_ERROR;
+  }
 
   return err;
 }
 
 /**
- * @brief   Selects a bank as current.
- * @note    The bank header is assumed to be valid.
+ * @brief   Returns the number of erased banks.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
- * @param[in] bank      bank to be scanned
- * @param[out] statep   bank state, it can be:
- *                      - MFS_BANK_ERASED
- *                      - MFS_BANK_GARBAGE
- *                      - MFS_BANK_PARTIAL
- *                      - MFS_BANK_OK
- *                      .
- * @return              The operation status.
+ * @return              The number of erased banks.
  *
  * @notapi
  */
-static mfs_error_t mfs_bank_mount(MFSDriver *mfsp,
-                                  mfs_bank_t bank,
-                                  mfs_bank_state_t *statep) {
-  unsigned i;
+static mfs_bank_t mfs_bank_count_erased(MFSDriver *mfsp) {
+  mfs_bank_t bank, n = 0U;
 
-  /* Resetting the bank state, then reading the required header data.*/
-  mfs_state_reset(mfsp);
-  RET_ON_ERROR(mfs_bank_get_state(mfsp, bank, statep, &mfsp->current_counter));
-  mfsp->current_bank = bank;
+  for (bank = 0U; bank < MFS_BANKS_COUNT(mfsp); bank++) {
+    if (mfsp->banks[bank].counter == 0U) {
+      n++;
+    }
+  }
 
-  /* Scanning for the most recent instance of all records.*/
-  RET_ON_ERROR(mfs_bank_scan_records(mfsp, bank, statep));
+  return n;
+}
+
+/**
+ * @brief   Returns the oldest bank in use with a counter above a limit.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] cnt       counter limit, zero for the oldest bank in use
+ * @return              The bank identifier.
+ * @retval MFS_BANKS_COUNT(mfsp) if there are no banks above the limit.
+ *
+ * @notapi
+ */
+static mfs_bank_t mfs_bank_get_oldest(MFSDriver *mfsp, uint32_t cnt) {
+  mfs_bank_t bank, oldest = MFS_BANKS_COUNT(mfsp);
+
+  for (bank = 0U; bank < MFS_BANKS_COUNT(mfsp); bank++) {
+    uint32_t bcnt = mfsp->banks[bank].counter;
+
+    if ((bcnt > cnt) && ((oldest == MFS_BANKS_COUNT(mfsp)) ||
+                         (bcnt < mfsp->banks[oldest].counter))) {
+      oldest = bank;
+    }
+  }
+
+  return oldest;
+}
+
+/**
+ * @brief   Selects the next erased bank to be put in use.
+ * @details The erased bank with the lowest erase counter is selected,
+ *          ties are resolved by taking the first bank following the
+ *          current one in the ring.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] from      first bank to be considered
+ * @return              The bank identifier.
+ *
+ * @notapi
+ */
+static mfs_bank_t mfs_bank_select_erased(MFSDriver *mfsp, mfs_bank_t from) {
+  mfs_bank_t i, selected = MFS_BANKS_COUNT(mfsp);
+
+  for (i = 0U; i < MFS_BANKS_COUNT(mfsp); i++) {
+    mfs_bank_t bank = (from + i) % MFS_BANKS_COUNT(mfsp);
+
+    if ((mfsp->banks[bank].counter == 0U) &&
+        ((selected == MFS_BANKS_COUNT(mfsp)) ||
+         (mfsp->banks[bank].erase_count <
+          mfsp->banks[selected].erase_count))) {
+      selected = bank;
+    }
+  }
+
+  return selected;
+}
+
+/**
+ * @brief   Checks if a bank contains a flash offset.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @param[in] offset    the flash offset
+ * @return              The test result.
+ *
+ * @notapi
+ */
+static bool mfs_bank_contains(MFSDriver *mfsp, mfs_bank_t bank,
+                              flash_offset_t offset) {
+  flash_offset_t start = mfs_flash_get_bank_offset(mfsp, bank);
+
+  return (offset >= start) && (offset < start + mfsp->config->bank_size);
+}
+
+/**
+ * @brief   Checks if a bank holds live records.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @return              The test result.
+ *
+ * @notapi
+ */
+static bool mfs_bank_is_live(MFSDriver *mfsp, mfs_bank_t bank) {
+  unsigned i;
 
-  /* Calculating the effective used size.*/
-  mfsp->used_space = sizeof (mfs_bank_header_t);
   for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
-    if (mfsp->descriptors[i].offset != 0U) {
-      mfsp->used_space += mfsp->descriptors[i].size + sizeof (mfs_data_header_t);
+    if ((mfsp->descriptors[i].offset != 0U) &&
+        mfs_bank_contains(mfsp, bank, mfsp->descriptors[i].offset)) {
+      return true;
     }
   }
 
+  return false;
+}
+
+/**
+ * @brief   Puts an erased bank in use as current bank.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_bank_open(MFSDriver *mfsp, mfs_bank_t bank) {
+
+  RET_ON_ERROR(mfs_bank_write_header(mfsp, bank,
+                                     mfsp->current_counter + 1U));
+
+  mfsp->current_bank    = bank;
+  mfsp->current_counter = mfsp->current_counter + 1U;
+  mfsp->next_offset     = mfs_flash_get_bank_offset(mfsp, bank) +
+                          sizeof (mfs_bank_header_t);
+
   return MFS_NO_ERROR;
 }
 
 /**
  * @brief   Enforces a garbage collection.
- * @details Storage data is compacted into a single bank.
+ * @details Live records are relocated into an erased bank which becomes
+ *          the current bank, then the source banks are erased. A partial
+ *          collection only relocates the records held by the oldest bank
+ *          and erases it, a full collection compacts the whole storage
+ *          into a single bank.
+ * @note    Source banks are erased from the oldest, so an interrupted
+ *          collection never exposes records superseded by erase markers
+ *          held in more recent banks.
  *
  * @param[out] mfsp     pointer to the @p MFSDriver object
+ * @param[in] full      @p true for a full collection
  * @return              The operation status.
  *
  * @notapi
  */
-static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
+static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp, bool full) {
   unsigned i;
   mfs_bank_t sbank, dbank;
   flash_offset_t dest_offset;
 
-  sbank = mfsp->current_bank;
-  if (sbank == MFS_BANK_0) {
-    dbank = MFS_BANK_1;
-  }
-  else {
-    dbank = MFS_BANK_0;
+  sbank = mfs_bank_get_oldest(mfsp, 0U);
+  dbank = mfs_bank_select_erased(mfsp, mfsp->current_bank + 1U);
+  if (dbank == MFS_BANKS_COUNT(mfsp)) {
+    return MFS_ERR_INTERNAL;
   }
 
   /* Write address.*/
@@ -639,7 +828,9 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
   /* Copying the most recent record instances only.*/
   for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
     uint32_t totsize = mfsp->descriptors[i].size + sizeof (mfs_data_header_t);
-    if (mfsp->descriptors[i].offset != 0) {
+    if ((mfsp->descriptors[i].offset != 0) &&
+        (full || mfs_bank_contains(mfsp, sbank,
+                                   mfsp->descriptors[i].offset))) {
       RET_ON_ERROR(mfs_flash_copy(mfsp, dest_offset,
                                   mfsp->descriptors[i].offset,
                                   totsize));
@@ -648,16 +839,69 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
     }
   }
 
+  /* The header is written after the data.*/
+  RET_ON_ERROR(mfs_bank_write_header(mfsp, dbank,
+                                     mfsp->current_counter + 1U));
+
   /* New current bank.*/
   mfsp->current_bank = dbank;
   mfsp->current_counter += 1U;
   mfsp->next_offset = dest_offset;
 
-  /* The header is written after the data.*/
-  RET_ON_ERROR(mfs_bank_write_header(mfsp, dbank, mfsp->current_counter));
-
-  /* The source bank is erased last.*/
+  /* The source banks are erased last.*/
   RET_ON_ERROR(mfs_bank_erase(mfsp, sbank));
+  if (full) {
+    while ((sbank = mfs_bank_get_oldest(mfsp, 0U)) != dbank) {
+      RET_ON_ERROR(mfs_bank_erase(mfsp, sbank));
+    }
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Makes space available in the current bank.
+ * @details If the current bank has not enough free space then the next
+ *          erased bank is put in use, if it is the last erased bank then
+ *          the oldest bank is reclaimed instead.
+ * @note    The caller must verify that the required space is available
+ *          in the compacted storage.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] required  the required space
+ * @param[out] gcp      set to @p true if a garbage collection was performed
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_bank_make_room(MFSDriver *mfsp,
+                                      flash_offset_t required,
+                                      bool *gcp) {
+
+  while ((mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+          mfsp->config->bank_size) - mfsp->next_offset < required) {
+    mfs_bank_t oldest = mfs_bank_get_oldest(mfsp, 0U);
+
+    if (mfs_bank_count_erased(mfsp) > 1U) {
+      /* There are spare banks, just moving to the next one.*/
+      RET_ON_ERROR(mfs_bank_open(mfsp,
+                                 mfs_bank_select_erased(mfsp,
+                                                        mfsp->current_bank + 1U)));
+    }
+    else if ((oldest != mfsp->current_bank) &&
+             !mfs_bank_is_live(mfsp, oldest)) {
+      /* The oldest bank only contains obsolete records, it can be erased
+         without relocations.*/
+      *gcp = true;
+      RET_ON_ERROR(mfs_bank_erase(mfsp, oldest));
+    }
+    else {
+      /* Reclaiming the oldest bank, the relocated records are at most a
+         bank worth of data so the new bank has space for the request.*/
+      *gcp = true;
+      RET_ON_ERROR(mfs_garbage_collect(mfsp, false));
+    }
+  }
 
   return MFS_NO_ERROR;
 }
@@ -671,106 +915,95 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
  * @api
  */
 static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
-  mfs_bank_state_t sts, sts0, sts1;
+  mfs_bank_state_t sts[MFS_CFG_MAX_BANKS];
   mfs_bank_t bank;
-  uint32_t cnt0 = 0, cnt1 = 0;
-  bool warning = false;
+  uint32_t erases = 0U;
+  unsigned i;
+  bool warning = false, partial = false;
 
-  /* Assessing the state of the two banks.*/
-  RET_ON_ERROR(mfs_bank_get_state(mfsp, MFS_BANK_0, &sts0, &cnt0));
-  RET_ON_ERROR(mfs_bank_get_state(mfsp, MFS_BANK_1, &sts1, &cnt1));
-
-  /* Handling all possible scenarios, each one requires its own recovery
-     strategy.*/
-  switch (PAIR(sts0, sts1)) {
-
-  case PAIR(MFS_BANK_ERASED, MFS_BANK_ERASED):
-    /* Both banks erased, first initialization.*/
-    RET_ON_ERROR(mfs_bank_write_header(mfsp, MFS_BANK_0, 1));
-    bank = MFS_BANK_0;
-    break;
-
-  case PAIR(MFS_BANK_OK, MFS_BANK_OK):
-    /* Both banks appear to be valid but one must be newer, erasing the
-       older one.*/
-    if (cnt0 > cnt1) {
-      /* Bank 0 is newer.*/
-      RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
-      bank = MFS_BANK_0;
+  /* Resetting the state, then assessing the state of all banks.*/
+  mfs_state_reset(mfsp);
+  for (bank = 0U; bank < MFS_BANKS_COUNT(mfsp); bank++) {
+    uint32_t cnt, bank_erases;
+
+    RET_ON_ERROR(mfs_bank_get_state(mfsp, bank, &sts[bank],
+                                    &cnt, &bank_erases));
+    if (sts[bank] == MFS_BANK_OK) {
+      mfsp->banks[bank].counter     = cnt;
+      mfsp->banks[bank].erase_count = bank_erases;
+      if (bank_erases > erases) {
+        erases = bank_erases;
+      }
     }
-    else {
-      /* Bank 1 is newer.*/
-      RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
-      bank = MFS_BANK_1;
+  }
+
+  /* Banks without a valid header have lost their erase counter, the
+     highest known value is assumed. Unreadable banks are erased.*/
+  for (bank = 0U; bank < MFS_BANKS_COUNT(mfsp); bank++) {
+    if (sts[bank] != MFS_BANK_OK) {
+      if (mfsp->banks[bank].erase_count < erases) {
+        mfsp->banks[bank].erase_count = erases;
+      }
+      if (sts[bank] == MFS_BANK_GARBAGE) {
+        RET_ON_ERROR(mfs_bank_erase(mfsp, bank));
+        warning = true;
+      }
     }
-    warning = true;
-    break;
-
-  case PAIR(MFS_BANK_GARBAGE, MFS_BANK_GARBAGE):
-    /* Both banks are unreadable, reinitializing.*/
-    RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
-    RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
-    RET_ON_ERROR(mfs_bank_write_header(mfsp, MFS_BANK_0, 1));
-    bank = MFS_BANK_0;
-    warning = true;
-    break;
-
-  case PAIR(MFS_BANK_ERASED, MFS_BANK_OK):
-    /* Normal situation, bank one is used.*/
-    bank = MFS_BANK_1;
-    break;
-
-  case PAIR(MFS_BANK_OK, MFS_BANK_ERASED):
-    /* Normal situation, bank zero is used.*/
-    bank = MFS_BANK_0;
-    break;
-
-  case PAIR(MFS_BANK_ERASED, MFS_BANK_GARBAGE):
-    /* Bank zero is erased, bank one is not readable.*/
-    RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
-    RET_ON_ERROR(mfs_bank_write_header(mfsp, MFS_BANK_0, 1));
-    bank = MFS_BANK_0;
-    warning = true;
-    break;
+  }
 
-  case PAIR(MFS_BANK_GARBAGE, MFS_BANK_ERASED):
-    /* Bank zero is not readable, bank one is erased.*/
-    RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
-    RET_ON_ERROR(mfs_bank_write_header(mfsp, MFS_BANK_1, 1));
-    bank = MFS_BANK_1;
-    warning = true;
-    break;
+  /* All banks erased, first initialization.*/
+  if (mfs_bank_count_erased(mfsp) == MFS_BANKS_COUNT(mfsp)) {
+    RET_ON_ERROR(mfs_bank_open(mfsp, mfs_bank_select_erased(mfsp,
+                                                            MFS_BANK_0)));
+    mfsp->used_space = sizeof (mfs_bank_header_t);
 
-  case PAIR(MFS_BANK_OK, MFS_BANK_GARBAGE):
-    /* Bank zero is normal, bank one is unreadable.*/
-    RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
-    bank = MFS_BANK_0;
-    warning = true;
-    break;
+    return warning ? MFS_WARN_REPAIR : MFS_NO_ERROR;
+  }
 
-  case PAIR(MFS_BANK_GARBAGE, MFS_BANK_OK):
-    /* Bank zero is unreadable, bank one is normal.*/
-    RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
-    bank = MFS_BANK_1;
-    warning = true;
-    break;
+  /* Scanning banks from the oldest to the most recent one, more recent
+     record instances override the previous ones.*/
+  bank = mfs_bank_get_oldest(mfsp, 0U);
+  while (bank < MFS_BANKS_COUNT(mfsp)) {
+    RET_ON_ERROR(mfs_bank_scan_records(mfsp, bank, &sts[bank]));
+    mfsp->current_bank    = bank;
+    mfsp->current_counter = mfsp->banks[bank].counter;
+    bank = mfs_bank_get_oldest(mfsp, mfsp->current_counter);
+  }
 
-  default:
-    return MFS_ERR_INTERNAL;
+  /* Calculating the effective used size.*/
+  mfsp->used_space = sizeof (mfs_bank_header_t);
+  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+    if (mfsp->descriptors[i].offset != 0U) {
+      mfsp->used_space += mfsp->descriptors[i].size + sizeof (mfs_data_header_t);
+    }
   }
 
-  /* Mounting the bank.*/
-  RET_ON_ERROR(mfs_bank_mount(mfsp, bank, &sts));
+  /* Oldest banks not holding live records are erased, this happens
+     normally after an interrupted garbage collection, in that case there
+     are no erased banks left.*/
+  if (mfs_bank_count_erased(mfsp) == 0U) {
+    warning = true;
+  }
+  while (((bank = mfs_bank_get_oldest(mfsp, 0U)) != mfsp->current_bank) &&
+         !mfs_bank_is_live(mfsp, bank)) {
+    RET_ON_ERROR(mfs_bank_erase(mfsp, bank));
+  }
 
-  /* This condition should not occur, the bank has just been repaired.*/
-  if ((sts == MFS_BANK_ERASED) || (sts == MFS_BANK_GARBAGE)) {
+  /* This condition should not occur, at least an erased bank must exist
+     at this point.*/
+  if (mfs_bank_count_erased(mfsp) == 0U) {
     return MFS_ERR_INTERNAL;
   }
 
   /* In case of detected problems then a garbage collection is performed in
      order to repair/remove anomalies.*/
-  if (sts == MFS_BANK_PARTIAL) {
-    RET_ON_ERROR(mfs_garbage_collect(mfsp));
+  for (bank = 0U; bank < MFS_BANKS_COUNT(mfsp); bank++) {
+    if ((mfsp->banks[bank].counter != 0U) && (sts[bank] == MFS_BANK_PARTIAL)) {
+      partial = true;
+    }
+  }
+  if (partial) {
+    RET_ON_ERROR(mfs_garbage_collect(mfsp, true));
     warning = true;
   }
 
@@ -830,11 +1063,17 @@ mfs_error_t mfs_mount(MFSDriver *mfsp) {
  * @init
  */
 void mfsObjectInit(MFSDriver *mfsp) {
+  unsigned i;
 
   osalDbgCheck(mfsp != NULL);
 
   mfsp->state = MFS_STOP;
   mfsp->config = NULL;
+
+  for (i = 0; i < MFS_CFG_MAX_BANKS; i++) {
+    mfsp->banks[i].counter     = 0U;
+    mfsp->banks[i].erase_count = 0U;
+  }
 }
 
 /**
@@ -853,7 +1092,9 @@ void mfsObjectInit(MFSDriver *mfsp) {
  */
 mfs_error_t mfsStart(MFSDriver *mfsp, const MFSConfig *config) {
 
-  osalDbgCheck((mfsp != NULL) && (config != NULL));
+  osalDbgCheck((mfsp != NULL) && (config != NULL) &&
+               (config->bank_count <= (mfs_bank_t)MFS_CFG_MAX_BANKS) &&
+               (config->bank_count != (mfs_bank_t)1));
   osalDbgAssert((mfsp->state == MFS_STOP) || (mfsp->state == MFS_READY) ||
                 (mfsp->state == MFS_ERROR), "invalid state");
 
@@ -894,6 +1135,7 @@ void mfsStop(MFSDriver *mfsp) {
  * @api
  */
 mfs_error_t mfsErase(MFSDriver *mfsp) {
+  mfs_bank_t bank;
 
   osalDbgCheck(mfsp != NULL);
 
@@ -901,8 +1143,9 @@ mfs_error_t mfsErase(MFSDriver *mfsp) {
     return MFS_ERR_INV_STATE;
   }
 
-  RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
-  RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
+  for (bank = 0U; bank < MFS_BANKS_COUNT(mfsp); bank++) {
+    RET_ON_ERROR(mfs_bank_erase(mfsp, bank));
+  }
 
   return mfs_mount(mfsp);
 }
@@ -964,7 +1207,7 @@ mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
                               buffer));
 
   /* Checking CRC.*/
-  crc = crc16(0xFFFFU, buffer, *np);
+  crc = mfs_crc16(mfsp, buffer, *np);
   if (crc != mfsp->buffer.dhdr.fields.crc) {
     mfsp->state = MFS_ERROR;
     return MFS_ERR_FLASH_FAILURE;
@@ -995,7 +1238,7 @@ mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
  */
 mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
                            size_t n, const uint8_t *buffer) {
-  flash_offset_t free, required;
+  flash_offset_t required;
   bool warning = false;
 
   osalDbgCheck((mfsp != NULL) &&
@@ -1016,21 +1259,15 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
     return MFS_ERR_OUT_OF_MEM;
   }
 
-  /* Checking for immediately (not compacted) available space.*/
-  free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
-          mfsp->config->bank_size) - mfsp->next_offset;
-  if (required > free) {
-    /* We need to perform a garbage collection, there is enough space
-       but it has to be freed.*/
-    warning = true;
-    RET_ON_ERROR(mfs_garbage_collect(mfsp));
-  }
+  /* Checking for immediately (not compacted) available space, if there
+     is not enough space then it has to be freed.*/
+  RET_ON_ERROR(mfs_bank_make_room(mfsp, required, &warning));
 
   /* Writing the data header without the magic, it will be written last.*/
   mfsp->buffer.dhdr.fields.magic = (uint32_t)mfsp->config->erased;
   mfsp->buffer.dhdr.fields.id    = (uint16_t)id;
   mfsp->buffer.dhdr.fields.size  = (uint32_t)n;
-  mfsp->buffer.dhdr.fields.crc   = crc16(0xFFFFU, buffer, n);
+  mfsp->buffer.dhdr.fields.crc   = mfs_crc16(mfsp, buffer, n);
   RET_ON_ERROR(mfs_flash_write(mfsp,
                                mfsp->next_offset,
                                sizeof (mfs_data_header_t),
@@ -1082,7 +1319,7 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
  * @api
  */
 mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
-  flash_offset_t free, required;
+  flash_offset_t required;
   bool warning = false;
 
   osalDbgCheck((mfsp != NULL) &&
@@ -1104,15 +1341,9 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
     return MFS_ERR_INTERNAL;
   }
 
-  /* Checking for immediately (not compacted) available space.*/
-  free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
-          mfsp->config->bank_size) - mfsp->next_offset;
-  if (required > free) {
-    /* We need to perform a garbage collection, there is enough space
-       but it has to be freed.*/
-    warning = true;
-    RET_ON_ERROR(mfs_garbage_collect(mfsp));
-  }
+  /* Checking for immediately (not compacted) available space, if there
+     is not enough space then it has to be freed.*/
+  RET_ON_ERROR(mfs_bank_make_room(mfsp, required, &warning));
 
   /* Writing the data header with size set to zero, it means that the
      record is logically erased.*/
@@ -1158,7 +1389,7 @@ mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp) {
     return MFS_ERR_INV_STATE;
   }
 
-  return mfs_garbage_collect(mfsp);
+  return mfs_garbage_collect(mfsp, true);
 }
 
 /** @} */
@@ -54,6 +54,16 @@
 #define MFS_CFG_MAX_RECORDS                 32
 #endif
 
+/**
+ * @brief   Maximum number of banks in the managed storage.
+ * @details This value determines the size of the per-bank state kept in
+ *          the driver, the number of banks actually used is specified in
+ *          the configuration structure.
+ */
+#if !defined(MFS_CFG_MAX_BANKS) || defined(__DOXYGEN__)
+#define MFS_CFG_MAX_BANKS                   2
+#endif
+
 /**
  * @brief   Maximum number of repair attempts on partition mount.
  */
@@ -115,6 +125,10 @@
 #error "invalid MFS_CFG_MAX_RECORDS value"
 #endif
 
+#if MFS_CFG_MAX_BANKS < 2
+#error "invalid MFS_CFG_MAX_BANKS value"
+#endif
+
 #if (MFS_CFG_MAX_REPAIR_ATTEMPTS < 1) || (MFS_CFG_MAX_REPAIR_ATTEMPTS > 10)
 #error "invalid MFS_MAX_REPAIR_ATTEMPTS value"
 #endif
@@ -140,12 +154,9 @@
 /*===========================================================================*/
 
 /**
- * @brief   Type of a flash bank.
+ * @brief   Type of a flash bank index.
  */
-typedef enum {
-  MFS_BANK_0 = 0,
-  MFS_BANK_1 = 1
-} mfs_bank_t;
+typedef uint32_t mfs_bank_t;
 
 /**
  * @brief   Type of driver state machine states.
@@ -216,14 +227,16 @@ typedef union {
     uint32_t                magic2;
     /**
      * @brief   Usage counter of the bank.
-     * @details This value is increased each time a bank swap is performed. It
-     *          indicates how much wearing the flash has already endured.
+     * @details This value is increased each time a new bank is put in use,
+     *          the bank with the highest value is the most recent one.
      */
     uint32_t                counter;
     /**
-     * @brief   Reserved field.
+     * @brief   Erase cycles endured by the bank.
+     * @details The value is stored XORed with the erased value so that
+     *          headers written before this field existed read as zero.
      */
-    uint16_t                reserved1;
+    uint16_t                erase_count;
     /**
      * @brief   Header CRC.
      */
@@ -261,6 +274,25 @@ typedef union {
   uint32_t                  hdr32[3];
 } mfs_data_header_t;
 
+/**
+ * @brief   Type of a bank descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Usage counter of the bank.
+   * @note    Zero means that the bank is erased.
+   */
+  uint32_t                  counter;
+  /**
+   * @brief   Erase cycles endured by the bank.
+   * @note    For banks found erased on mount this is an estimate.
+   */
+  uint32_t                  erase_count;
+} mfs_bank_descriptor_t;
+
+/**
+ * @brief   Type of a record descriptor.
+ */
 typedef struct {
   /**
    * @brief   Offset of the record header.
@@ -308,6 +340,25 @@ typedef struct {
    *          @p bank_size.
    */
   flash_sector_t            bank1_sectors;
+  /**
+   * @brief   Number of banks.
+   * @details Banks after the first two are placed contiguously after
+   *          bank 1, each one has @p bank1_sectors sectors.
+   * @note    Zero is equivalent to two banks.
+   * @note    The usable space is always limited to one bank, additional
+   *          banks reduce the amount of data relocated by garbage
+   *          collection and spread erase cycles over more sectors.
+   */
+  mfs_bank_t                bank_count;
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   CRC driver used for headers and records or @p NULL.
+   * @note    If @p NULL the CRC is computed in software, the driver, if
+   *          specified, is started by MFS with its own configuration on
+   *          each use.
+   */
+  CRCDriver                 *crcp;
+#endif
 } MFSConfig;
 
 /**
@@ -325,7 +376,7 @@ typedef struct {
    */
   const MFSConfig           *config;
   /**
-   * @brief   Bank currently in use.
+   * @brief   Bank currently in use for writing.
    */
   mfs_bank_t                current_bank;
   /**
@@ -337,9 +388,13 @@ typedef struct {
    */
   flash_offset_t            next_offset;
   /**
-   * @brief   Used space in the current bank without considering erased records.
+   * @brief   Used space without considering erased and obsolete records.
    */
   flash_offset_t            used_space;
+  /**
+   * @brief   State of the banks.
+   */
+  mfs_bank_descriptor_t     banks[MFS_CFG_MAX_BANKS];
   /**
    * @brief   Offsets of the most recent instance of the records.
    * @note    Zero means that there is not a record with that id.
@@ -361,6 +416,14 @@ typedef struct {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @name    Bank identifiers
+ * @{
+ */
+#define MFS_BANK_0          ((mfs_bank_t)0)
+#define MFS_BANK_1          ((mfs_bank_t)1)
+/** @} */
+
 /**
  * @name   Error codes handling macros
  * @{
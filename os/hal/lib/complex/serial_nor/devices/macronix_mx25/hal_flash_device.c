@@ -408,6 +408,15 @@ void snor_device_init(SNORDriver *devp) {
 flash_error_t snor_device_read(SNORDriver *devp, flash_offset_t offset,
                                size_t n, uint8_t *rp) {
 
+#if SNOR_HAS_MEMMAP_READS == TRUE
+  /* Large reads are performed in memory mapped mode.*/
+  if (n >= (size_t)SNOR_MEMMAP_THRESHOLD) {
+    bus_memmap_receive(devp->config->busp, &snor_memmap_read, offset, n, rp);
+
+    return FLASH_NO_ERROR;
+  }
+#endif
+
 #if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
   /* Fast read command in WSPI mode.*/
 #if MX25_BUS_MODE == MX25_BUS_MODE_SPI
@@ -554,7 +563,18 @@ flash_error_t snor_device_start_erase_sector(SNORDriver *devp,
  */
 flash_error_t snor_device_verify_erase(SNORDriver *devp,
                                        flash_sector_t sector) {
-  uint8_t cmpbuf[MX25_COMPARE_BUFFER_SIZE];
+#if SNOR_HAS_MEMMAP_READS == TRUE
+  flash_offset_t offset = (flash_offset_t)(sector * SECTOR_SIZE);
+
+  /* The whole sector is checked in place in memory mapped mode.*/
+  if (!bus_memmap_is_erased(devp->config->busp, &snor_memmap_read,
+                            offset, SECTOR_SIZE)) {
+    /* Ready state again.*/
+    devp->state = FLASH_READY;
+
+    return FLASH_ERROR_VERIFY;
+  }
+#else
   flash_offset_t offset;
   size_t n;
 
@@ -562,41 +582,39 @@ flash_error_t snor_device_verify_erase(SNORDriver *devp,
   offset = (flash_offset_t)(sector * SECTOR_SIZE);
   n = SECTOR_SIZE;
   while (n > 0U) {
-    uint8_t *p;
-
 #if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
 #if MX25_BUS_MODE == MX25_BUS_MODE_SPI
     bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_SPI_FAST_READ4B,
                                offset, 8,   /* Note, always 8 dummy cycles. */
-                               sizeof cmpbuf, cmpbuf);
+                               SNOR_VERIFY_BUFFER_SIZE, devp->verify_buffer);
 #elif MX25_BUS_MODE == MX25_BUS_MODE_OPI_STR
    bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_OPI_8READ,
                               offset, MX25_READ_DUMMY_CYCLES,
-                              sizeof cmpbuf, cmpbuf);
+                              SNOR_VERIFY_BUFFER_SIZE, devp->verify_buffer);
 #elif MX25_BUS_MODE == MX25_BUS_MODE_OPI_DTR
    bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_OPI_8DTRD,
                               offset, MX25_READ_DUMMY_CYCLES,
-                              sizeof cmpbuf, cmpbuf);
+                              SNOR_VERIFY_BUFFER_SIZE, devp->verify_buffer);
 #endif
 #else
    /* Normal read command in SPI mode.*/
    bus_cmd_addr_receive(devp->config->busp, MX25_CMD_SPI_READ4B,
-                        offset, sizeof cmpbuf, cmpbuf);
+                        offset, SNOR_VERIFY_BUFFER_SIZE, devp->verify_buffer);
 #endif
 
     /* Checking for erased state of current buffer.*/
-    for (p = cmpbuf; p < &cmpbuf[MX25_COMPARE_BUFFER_SIZE]; p++) {
-      if (*p != 0xFFU) {
-        /* Ready state again.*/
-        devp->state = FLASH_READY;
+    if (!snor_buffer_is_erased(devp->verify_buffer,
+                               SNOR_VERIFY_BUFFER_SIZE)) {
+      /* Ready state again.*/
+      devp->state = FLASH_READY;
 
-        return FLASH_ERROR_VERIFY;
-      }
+      return FLASH_ERROR_VERIFY;
     }
 
-    offset += sizeof cmpbuf;
-    n -= sizeof cmpbuf;
+    offset += SNOR_VERIFY_BUFFER_SIZE;
+    n -= SNOR_VERIFY_BUFFER_SIZE;
   }
+#endif
 
   return FLASH_NO_ERROR;
 }
@@ -151,17 +151,6 @@
 #define N25Q_USE_SUB_SECTORS                FALSE
 #endif
 
-/**
- * @brief   Size of the compare buffer.
- * @details This buffer is allocated in the stack frame of the function
- *          @p flashVerifyErase() and its size must be a power of two.
- *          Larger buffers lead to better verify performance but increase
- *          stack usage for that function.
- */
-#if !defined(N25Q_COMPARE_BUFFER_SIZE) || defined(__DOXYGEN__)
-#define N25Q_COMPARE_BUFFER_SIZE            32
-#endif
-
 /**
  * @brief   Number of dummy cycles for fast read (1..15).
  * @details This is the number of dummy cycles to be used for fast read
@@ -175,10 +164,6 @@
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
-#if (N25Q_COMPARE_BUFFER_SIZE & (N25Q_COMPARE_BUFFER_SIZE - 1)) != 0
-#error "invalid N25Q_COMPARE_BUFFER_SIZE value"
-#endif
-
 #if (N25Q_READ_DUMMY_CYCLES < 1) || (N25Q_READ_DUMMY_CYCLES > 15)
 #error "invalid N25Q_READ_DUMMY_CYCLES value (1..15)"
 #endif
@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 #include "hal_serial_nor.h"
 
@@ -119,6 +121,32 @@ void bus_release(BUSDriver *busp) {
 #define bus_release(busp)
 #endif
 
+#if (SNOR_HAS_MEMMAP_READS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Discards cached copies of a memory mapped flash area.
+ * @note    The flash can be modified using commands while not mapped, any
+ *          data cache line left from a previous mapping would be stale.
+ *
+ * @param[in] p         pointer to the mapped area
+ * @param[in] n         size of the area
+ *
+ * @notapi
+ */
+static void bus_memmap_invalidate(const uint8_t *p, size_t n) {
+
+#if defined(CACHE_LINE_SIZE) && (CACHE_LINE_SIZE > 0U)
+  {
+    size_t skew = (size_t)p & (size_t)(CACHE_LINE_SIZE - 1U);
+
+    cacheBufferInvalidate(p - skew, n + skew);
+  }
+#else
+  (void)p;
+  (void)n;
+#endif
+}
+#endif /* SNOR_HAS_MEMMAP_READS == TRUE */
+
 /**
  * @brief   Returns a pointer to the device descriptor.
  *
@@ -637,6 +665,122 @@ void bus_cmd_addr_dummy_receive(BUSDriver *busp,
 }
 #endif /* SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI */
 
+#if (SNOR_HAS_MEMMAP_READS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reads data in memory mapped mode.
+ * @details The bus is switched in memory mapped mode for the duration of
+ *          the transfer then it is returned in normal mode.
+ * @pre     The bus must be in ready state.
+ *
+ * @param[in] busp      pointer to the bus driver
+ * @param[in] cmdp      fast read command to be used in memory mapped mode
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to receive
+ * @param[out] p        data buffer
+ *
+ * @notapi
+ */
+void bus_memmap_receive(BUSDriver *busp,
+                        const wspi_command_t *cmdp,
+                        flash_offset_t offset,
+                        size_t n,
+                        uint8_t *p) {
+  uint8_t *addr;
+
+  wspiMapFlash(busp, cmdp, &addr);
+  bus_memmap_invalidate(addr + offset, n);
+  memcpy(p, addr + offset, n);
+  wspiUnmapFlash(busp);
+}
+
+/**
+ * @brief   Checks a flash area for erased state in memory mapped mode.
+ * @details The area is checked in place, the scan stops on the first
+ *          non-erased word.
+ * @pre     The bus must be in ready state.
+ *
+ * @param[in] busp      pointer to the bus driver
+ * @param[in] cmdp      fast read command to be used in memory mapped mode
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be checked
+ * @return              The erased state.
+ * @retval false        if the area contains programmed bits.
+ * @retval true         if the area is erased.
+ *
+ * @notapi
+ */
+bool bus_memmap_is_erased(BUSDriver *busp,
+                          const wspi_command_t *cmdp,
+                          flash_offset_t offset,
+                          size_t n) {
+  uint8_t *addr;
+  bool erased;
+
+  wspiMapFlash(busp, cmdp, &addr);
+  bus_memmap_invalidate(addr + offset, n);
+  erased = snor_buffer_is_erased(addr + offset, n);
+  wspiUnmapFlash(busp);
+
+  return erased;
+}
+#endif /* SNOR_HAS_MEMMAP_READS == TRUE */
+
+/**
+ * @brief   Checks a buffer for erased state.
+ * @details The buffer is scanned a word at time, four words are merged
+ *          before each comparison, the scan stops on the first group
+ *          containing programmed bits.
+ *
+ * @param[in] p         pointer to the buffer
+ * @param[in] n         size of the buffer
+ * @return              The erased state.
+ * @retval false        if the buffer contains programmed bits.
+ * @retval true         if the buffer is erased.
+ *
+ * @notapi
+ */
+bool snor_buffer_is_erased(const uint8_t *p, size_t n) {
+  const uint32_t *wp;
+
+  /* Leading bytes up to the first aligned word.*/
+  while ((((size_t)p & (sizeof (uint32_t) - 1U)) != 0U) && (n > 0U)) {
+    if (*p != 0xFFU) {
+      return false;
+    }
+    p++;
+    n--;
+  }
+
+  /* Aligned words.*/
+  wp = (const uint32_t *)(const void *)p;
+  while (n >= 4U * sizeof (uint32_t)) {
+    if ((wp[0] & wp[1] & wp[2] & wp[3]) != 0xFFFFFFFFU) {
+      return false;
+    }
+    wp += 4;
+    n  -= 4U * sizeof (uint32_t);
+  }
+  while (n >= sizeof (uint32_t)) {
+    if (*wp != 0xFFFFFFFFU) {
+      return false;
+    }
+    wp++;
+    n -= sizeof (uint32_t);
+  }
+
+  /* Trailing bytes.*/
+  p = (const uint8_t *)wp;
+  while (n > 0U) {
+    if (*p != 0xFFU) {
+      return false;
+    }
+    p++;
+    n--;
+  }
+
+  return true;
+}
+
 /**
  * @brief   Initializes an instance.
  *
@@ -715,6 +859,83 @@ void snorStop(SNORDriver *devp) {
   }
 }
 
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Feeds a flash area to a CRC driver.
+ * @details The CRC driver must have been started by the caller with the
+ *          desired model, the CRC is not reset so several areas can be
+ *          chained, the result is retrieved using @p crcGetValue().
+ * @note    If memory mapped reads are enabled then large areas are fed
+ *          in place, else the area is read in blocks of
+ *          @p SNOR_CRC_BUFFER_SIZE bytes.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING if there is an erase operation in progress.
+ * @retval FLASH_ERROR_READ if the read operation failed.
+ * @retval FLASH_ERROR_HW_FAILURE if access to the memory failed.
+ *
+ * @api
+ */
+flash_error_t snorUpdateCRC(SNORDriver *devp, CRCDriver *crcp,
+                            flash_offset_t offset, size_t n) {
+  flash_error_t err = FLASH_NO_ERROR;
+
+  osalDbgCheck((devp != NULL) && (crcp != NULL));
+  osalDbgCheck((size_t)offset + n <= (size_t)snor_descriptor.sectors_count *
+                                     (size_t)snor_descriptor.sectors_size);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* Bus acquired.*/
+  bus_acquire(devp->config->busp, devp->config->buscfg);
+
+  /* FLASH_READ state while the operation is performed.*/
+  devp->state = FLASH_READ;
+
+#if SNOR_HAS_MEMMAP_READS == TRUE
+  /* Large areas are fed in place in memory mapped mode.*/
+  if (n >= (size_t)SNOR_MEMMAP_THRESHOLD) {
+    uint8_t *addr;
+
+    wspiMapFlash(devp->config->busp, &snor_memmap_read, &addr);
+    bus_memmap_invalidate(addr + offset, n);
+    crcUpdate(crcp, n, addr + offset);
+    wspiUnmapFlash(devp->config->busp);
+    n = 0U;
+  }
+#endif
+
+  while ((n > 0U) && (err == FLASH_NO_ERROR)) {
+    uint8_t buf[SNOR_CRC_BUFFER_SIZE];
+    size_t chunk = n > sizeof (buf) ? sizeof (buf) : n;
+
+    err = snor_device_read(devp, offset, chunk, buf);
+    if (err == FLASH_NO_ERROR) {
+      crcUpdate(crcp, chunk, buf);
+      offset += (flash_offset_t)chunk;
+      n      -= chunk;
+    }
+  }
+
+  /* Ready state again.*/
+  devp->state = FLASH_READY;
+
+  /* Bus released.*/
+  bus_release(devp->config->busp);
+
+  return err;
+}
+#endif /* HAL_USE_CRC == TRUE */
+
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
@@ -65,6 +65,53 @@
 #if !defined(SNOR_SHARED_BUS) || defined(__DOXYGEN__)
 #define SNOR_SHARED_BUS                     TRUE
 #endif
+
+/**
+ * @brief   Memory mapped reads switch.
+ * @details If set to @p TRUE then large reads and erase verifications are
+ *          performed by temporarily switching the WSPI driver in memory
+ *          mapped mode, the device is accessed using its fast read command
+ *          and data is checked in place without intermediate buffers.
+ * @note    This option is ignored if the bus is not WSPI or if the WSPI
+ *          low level driver does not support memory mapping.
+ */
+#if !defined(SNOR_USE_MEMMAP_READS) || defined(__DOXYGEN__)
+#define SNOR_USE_MEMMAP_READS               TRUE
+#endif
+
+/**
+ * @brief   Minimum read size for memory mapped reads.
+ * @details Reads smaller than this size are performed using a single read
+ *          command, entering and leaving the memory mapped mode costs
+ *          more than the command overhead for small transfers.
+ */
+#if !defined(SNOR_MEMMAP_THRESHOLD) || defined(__DOXYGEN__)
+#define SNOR_MEMMAP_THRESHOLD               128
+#endif
+
+/**
+ * @brief   Size of the stack buffer used by @p snorUpdateCRC().
+ * @details Areas not accessible in memory mapped mode are read in blocks
+ *          of this size before being fed to the CRC driver.
+ */
+#if !defined(SNOR_CRC_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define SNOR_CRC_BUFFER_SIZE                64
+#endif
+
+/**
+ * @brief   Size of the erase verification buffer.
+ * @details Without memory mapped reads the sectors are read in blocks of
+ *          this size by a single read command, large blocks amortize the
+ *          command overhead and are transferred by the bus DMA. The size
+ *          must be a power of two.
+ * @note    The buffer is part of the @p SNORDriver structure, the driver
+ *          object must be allocated in memory accessible by the bus DMA.
+ * @note    The buffer is not allocated if @p SNOR_HAS_MEMMAP_READS is
+ *          @p TRUE, sectors are checked in place in memory mapped mode.
+ */
+#if !defined(SNOR_VERIFY_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define SNOR_VERIFY_BUFFER_SIZE             512
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -81,6 +128,25 @@
 #error "invalid SNOR_BUS_DRIVER setting"
 #endif
 
+/**
+ * @brief   Memory mapped reads effectively in use.
+ */
+#if ((SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) &&                           \
+     (SNOR_USE_MEMMAP_READS == TRUE)) || defined(__DOXYGEN__)
+#if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
+#define SNOR_HAS_MEMMAP_READS               TRUE
+#else
+#define SNOR_HAS_MEMMAP_READS               FALSE
+#endif
+#else
+#define SNOR_HAS_MEMMAP_READS               FALSE
+#endif
+
+#if (SNOR_VERIFY_BUFFER_SIZE < 4) ||                                        \
+    ((SNOR_VERIFY_BUFFER_SIZE & (SNOR_VERIFY_BUFFER_SIZE - 1)) != 0)
+#error "invalid SNOR_VERIFY_BUFFER_SIZE value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -138,6 +204,12 @@ typedef struct {
    * @brief   Device ID and unique ID.
    */
   uint8_t                       device_id[20];
+#if (SNOR_HAS_MEMMAP_READS == FALSE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Erase verification buffer.
+   */
+  uint8_t                       verify_buffer[SNOR_VERIFY_BUFFER_SIZE];
+#endif
 } SNORDriver;
 
 /*===========================================================================*/
@@ -181,9 +253,25 @@ extern "C" {
                                   size_t n,
                                   uint8_t *p);
 #endif
+#if (SNOR_HAS_MEMMAP_READS == TRUE) || defined(__DOXYGEN__)
+  void bus_memmap_receive(BUSDriver *busp,
+                          const wspi_command_t *cmdp,
+                          flash_offset_t offset,
+                          size_t n,
+                          uint8_t *p);
+  bool bus_memmap_is_erased(BUSDriver *busp,
+                            const wspi_command_t *cmdp,
+                            flash_offset_t offset,
+                            size_t n);
+#endif
+  bool snor_buffer_is_erased(const uint8_t *p, size_t n);
   void snorObjectInit(SNORDriver *devp);
   void snorStart(SNORDriver *devp, const SNORConfig *config);
   void snorStop(SNORDriver *devp);
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+  flash_error_t snorUpdateCRC(SNORDriver *devp, CRCDriver *crcp,
+                              flash_offset_t offset, size_t n);
+#endif
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
   void snorMemoryMap(SNORDriver *devp, uint8_t ** addrp);
@@ -0,0 +1,575 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_wallclock.c
+ * @brief   RTC disciplined wall clock module code.
+ * @details This module keeps the calendar time as an offset against the
+ *          system time, the RTC is only read on start and periodically
+ *          in order to discipline the clock.<br>
+ *          The wall clock counts the microseconds of the RTC calendar
+ *          since 1970-01-01, time zones are not handled. The DST flag of
+ *          the last RTC reading is reported in @p tm_isdst and applied to
+ *          FAT time stamps as @p rtcConvertDateTimeToFAT() does.<br>
+ *          Small errors against the RTC are corrected by slewing the
+ *          clock rate, errors above the configured threshold are stepped.
+ *          A frequency correction is estimated comparing the system time
+ *          and the RTC over a long baseline, so the RTC resolution does
+ *          not limit the estimate.<br>
+ *          The calendar date of the current day is cached, getters only
+ *          perform the full calendar conversion when crossing a day
+ *          boundary.
+ *
+ * @addtogroup HAL_WALLCLOCK
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#include "hal_wallclock.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Division rounding toward minus infinity.
+ */
+static int64_t wclk_floor_div(int64_t a, int64_t b) {
+  int64_t q = a / b;
+
+  if (((a % b) != 0) && ((a < 0) != (b < 0))) {
+    q--;
+  }
+
+  return q;
+}
+
+/**
+ * @brief   Days since 1970-01-01 of a civil date.
+ *
+ * @param[in] y         year
+ * @param[in] m         month 1..12
+ * @param[in] d         day of the month 1..31
+ * @return              The number of days.
+ */
+static int64_t wclk_days_from_civil(int64_t y, int64_t m, int64_t d) {
+  int64_t era, yoe, doy, doe;
+
+  y  -= m <= 2 ? 1 : 0;
+  era = (y >= 0 ? y : y - 399) / 400;
+  yoe = y - (era * 400);
+  doy = (((153 * (m > 2 ? m - 3 : m + 9)) + 2) / 5) + d - 1;
+  doe = (yoe * 365) + (yoe / 4) - (yoe / 100) + doy;
+
+  return (era * 146097) + doe - 719468;
+}
+
+/**
+ * @brief   Civil date of a number of days since 1970-01-01.
+ *
+ * @param[in] z         number of days
+ * @param[out] yp       year
+ * @param[out] mp       month 1..12
+ * @param[out] dp       day of the month 1..31
+ */
+static void wclk_civil_from_days(int64_t z, int64_t *yp,
+                                 int64_t *mp, int64_t *dp) {
+  int64_t era, doe, yoe, doy, mq;
+
+  z  += 719468;
+  era = (z >= 0 ? z : z - 146096) / 146097;
+  doe = z - (era * 146097);
+  yoe = (doe - (doe / 1460) + (doe / 36524) - (doe / 146096)) / 365;
+  doy = doe - ((365 * yoe) + (yoe / 4) - (yoe / 100));
+  mq  = ((5 * doy) + 2) / 153;
+
+  *dp = doy - (((153 * mq) + 2) / 5) + 1;
+  *mp = mq < 10 ? mq + 3 : mq - 9;
+  *yp = yoe + (era * 400) + (*mp <= 2 ? 1 : 0);
+}
+
+/**
+ * @brief   Converts an RTC time stamp in microseconds since 1970.
+ *
+ * @param[in] timespec  pointer to a @p RTCDateTime structure
+ * @return              The time in microseconds.
+ */
+static int64_t wclk_datetime_to_us(const RTCDateTime *timespec) {
+  int64_t days;
+
+  days = wclk_days_from_civil((int64_t)timespec->year + (int64_t)RTC_BASE_YEAR,
+                              (int64_t)timespec->month,
+                              (int64_t)timespec->day);
+
+  return (days * (int64_t)WCLK_SECONDS_PER_DAY * 1000000) +
+         ((int64_t)timespec->millisecond * 1000);
+}
+
+/**
+ * @brief   Updates the cached day.
+ * @note    This function must be invoked from a lock zone.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @param[in] secs      seconds since 1970
+ */
+static void wclk_update_day(WallClockDriver *wclkp, int64_t secs) {
+  int64_t days, y, m, d;
+
+  if ((secs >= wclkp->day_start) &&
+      (secs < wclkp->day_start + WCLK_SECONDS_PER_DAY)) {
+    return;
+  }
+
+  days = wclk_floor_div(secs, WCLK_SECONDS_PER_DAY);
+  wclk_civil_from_days(days, &y, &m, &d);
+
+  memset(&wclkp->day_tm, 0, sizeof (struct tm));
+  wclkp->day_tm.tm_year = (int)(y - 1900);
+  wclkp->day_tm.tm_mon  = (int)(m - 1);
+  wclkp->day_tm.tm_mday = (int)d;
+  wclkp->day_tm.tm_wday = (int)((days + 4) - (wclk_floor_div(days + 4, 7) * 7));
+  wclkp->day_tm.tm_yday = (int)(days - wclk_days_from_civil(y, 1, 1));
+
+  /* Dates before the FAT epoch are clamped to its first day.*/
+  if (y < (int64_t)RTC_BASE_YEAR) {
+    wclkp->day_fat = (1U << 21) | (1U << 16);
+  }
+  else {
+    wclkp->day_fat = ((uint32_t)(y - (int64_t)RTC_BASE_YEAR) << 25) |
+                     ((uint32_t)m << 21) | ((uint32_t)d << 16);
+  }
+
+  wclkp->day_start = days * WCLK_SECONDS_PER_DAY;
+}
+
+/**
+ * @brief   Time elapsed since the last discipline.
+ * @details The system time is extended to 64 bits, then the elapsed time
+ *          is corrected by the frequency correction and by the slewed
+ *          part of the phase correction.
+ * @note    This function must be invoked from a lock zone.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @param[out] slewp    slewed part of the phase correction
+ * @return              The corrected elapsed time in microseconds.
+ */
+static int64_t wclk_elapsed(WallClockDriver *wclkp, int64_t *slewp) {
+  systime_t now = osalOsGetSystemTimeX();
+  int64_t e, s;
+
+  wclkp->ticks += (uint64_t)osalTimeDiffX(wclkp->last, now);
+  wclkp->last   = now;
+
+  e = (int64_t)(((wclkp->ticks - wclkp->base_ticks) * 1000000U) /
+                (uint64_t)OSAL_ST_FREQUENCY);
+
+  s = (e * (int64_t)wclkp->config->max_slew) / 1000000;
+  if (wclkp->slew_us >= 0) {
+    if (s > wclkp->slew_us) {
+      s = wclkp->slew_us;
+    }
+  }
+  else {
+    s = -s;
+    if (s < wclkp->slew_us) {
+      s = wclkp->slew_us;
+    }
+  }
+  *slewp = s;
+
+  return e + ((e * (int64_t)wclkp->freq) / 1000000000) + s;
+}
+
+/**
+ * @brief   Restarts the elapsed time from the current time.
+ * @note    This function must be invoked from a lock zone.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @param[in] us        wall time in microseconds since 1970
+ */
+static void wclk_rebase(WallClockDriver *wclkp, int64_t us) {
+
+  wclkp->base_us    = us;
+  wclkp->base_ticks = wclkp->ticks;
+  wclkp->next_ticks = wclkp->ticks +
+                      (uint64_t)wclkp->config->period;
+}
+
+/**
+ * @brief   Restarts the frequency baseline.
+ * @note    This function must be invoked from a lock zone.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @param[in] rtc_us    RTC time in microseconds since 1970
+ */
+static void wclk_restart_baseline(WallClockDriver *wclkp, int64_t rtc_us) {
+
+  wclkp->ref_ticks = wclkp->ticks;
+  wclkp->ref_us    = rtc_us;
+}
+
+/**
+ * @brief   Updates the frequency correction.
+ * @details The frequency error measured over the current baseline is
+ *          weighted by the baseline length, when the baseline reaches the
+ *          window the estimate replaces the correction and a new baseline
+ *          is started.
+ * @note    This function must be invoked from a lock zone.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @param[in] rtc_us    RTC time in microseconds since 1970
+ */
+static void wclk_update_freq(WallClockDriver *wclkp, int64_t rtc_us) {
+  const int64_t window = (int64_t)WCLK_CFG_FREQ_WINDOW * 1000000;
+  int64_t raw, meas, freq;
+
+  raw = (int64_t)(((wclkp->ticks - wclkp->ref_ticks) * 1000000U) /
+                  (uint64_t)OSAL_ST_FREQUENCY);
+  if (raw <= 0) {
+    return;
+  }
+
+  /* Frequency error in parts per billion.*/
+  meas = (((rtc_us - wclkp->ref_us) - raw) * 1000000000) / raw;
+  if (meas > (int64_t)WCLK_CFG_MAX_FREQ * 1000) {
+    meas = (int64_t)WCLK_CFG_MAX_FREQ * 1000;
+  }
+  else if (meas < -(int64_t)WCLK_CFG_MAX_FREQ * 1000) {
+    meas = -(int64_t)WCLK_CFG_MAX_FREQ * 1000;
+  }
+
+  freq = (int64_t)wclkp->freq;
+  if (raw >= window) {
+    freq = meas;
+    wclk_restart_baseline(wclkp, rtc_us);
+  }
+  else {
+    freq += ((meas - freq) * raw) / window;
+  }
+  wclkp->freq = (int32_t)freq;
+}
+
+/**
+ * @brief   Returns the wall time, disciplining the clock if due.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @return              The time in microseconds since 1970.
+ */
+static int64_t wclk_get(WallClockDriver *wclkp) {
+  int64_t us, s;
+  bool due;
+
+  osalSysLock();
+  us  = wclkp->base_us + wclk_elapsed(wclkp, &s);
+  due = (wclkp->config->period > (sysinterval_t)0) &&
+        (wclkp->ticks >= wclkp->next_ticks) && !wclkp->busy;
+  if (due) {
+    wclkp->busy = true;
+  }
+  osalSysUnlock();
+
+  if (due) {
+    (void) wclkDiscipline(wclkp);
+
+    osalSysLock();
+    us = wclkp->base_us + wclk_elapsed(wclkp, &s);
+    osalSysUnlock();
+  }
+
+  return us;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] wclkp    pointer to the @p WallClockDriver object
+ *
+ * @init
+ */
+void wclkObjectInit(WallClockDriver *wclkp) {
+
+  osalDbgCheck(wclkp != NULL);
+
+  wclkp->state       = WCLK_STOP;
+  wclkp->config      = NULL;
+  wclkp->disciplines = 0U;
+  wclkp->steps       = 0U;
+}
+
+/**
+ * @brief   Configures and activates a wall clock.
+ * @details The RTC is read and the wall clock is set to its value.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @param[in] config    pointer to the configuration
+ *
+ * @api
+ */
+void wclkStart(WallClockDriver *wclkp, const WallClockConfig *config) {
+  RTCDateTime timespec;
+  int64_t us;
+
+  osalDbgCheck((wclkp != NULL) && (config != NULL) &&
+               (config->rtcp != NULL) && (config->max_slew < 1000000U));
+  osalDbgAssert((wclkp->state == WCLK_STOP) || (wclkp->state == WCLK_READY),
+                "invalid state");
+
+  rtcGetTime(config->rtcp, &timespec);
+  us = wclk_datetime_to_us(&timespec);
+
+  osalSysLock();
+  wclkp->config     = config;
+  wclkp->last       = osalOsGetSystemTimeX();
+  wclkp->ticks      = 0U;
+  wclkp->slew_us    = 0;
+  wclkp->freq       = 0;
+  wclkp->busy       = false;
+  wclkp->dstflag    = timespec.dstflag;
+  wclkp->last_error = 0;
+  wclk_rebase(wclkp, us);
+  wclk_restart_baseline(wclkp, us);
+
+  /* Forcing the cached day to be computed.*/
+  wclkp->day_start  = wclk_floor_div(us, 1000000) + WCLK_SECONDS_PER_DAY;
+  wclk_update_day(wclkp, wclk_floor_div(us, 1000000));
+  wclkp->state      = WCLK_READY;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Deactivates a wall clock.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ *
+ * @api
+ */
+void wclkStop(WallClockDriver *wclkp) {
+
+  osalDbgCheck(wclkp != NULL);
+  osalDbgAssert((wclkp->state == WCLK_STOP) || (wclkp->state == WCLK_READY),
+                "invalid state");
+
+  osalSysLock();
+  wclkp->config = NULL;
+  wclkp->state  = WCLK_STOP;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Disciplines the wall clock against the RTC.
+ * @details The RTC is read and compared with the wall clock, the error is
+ *          either stepped or slewed depending on its size, then the
+ *          frequency correction is updated.
+ * @note    This function is invoked automatically by the getters when the
+ *          configured period expired, it can also be invoked explicitly.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @return              The measured error, RTC time minus wall time, in
+ *                      microseconds.
+ *
+ * @api
+ */
+int64_t wclkDiscipline(WallClockDriver *wclkp) {
+  RTCDateTime timespec;
+  int64_t rtc_us, us, err, s;
+  uint32_t threshold;
+
+  osalDbgCheck(wclkp != NULL);
+  osalDbgAssert(wclkp->state == WCLK_READY, "invalid state");
+
+  rtcGetTime(wclkp->config->rtcp, &timespec);
+  rtc_us = wclk_datetime_to_us(&timespec);
+
+  osalSysLock();
+  us  = wclkp->base_us + wclk_elapsed(wclkp, &s);
+  err = rtc_us - us;
+
+  threshold = wclkp->config->step_threshold;
+  if ((err > (int64_t)threshold) || (err < -(int64_t)threshold)) {
+    wclkp->slew_us = 0;
+    wclkp->steps++;
+    wclk_rebase(wclkp, rtc_us);
+    wclk_restart_baseline(wclkp, rtc_us);
+  }
+  else {
+    wclkp->slew_us = err / (1 << WCLK_CFG_PHASE_SHIFT);
+    wclk_rebase(wclkp, us);
+    wclk_update_freq(wclkp, rtc_us);
+  }
+  wclkp->dstflag    = timespec.dstflag;
+  wclkp->last_error = err;
+  wclkp->disciplines++;
+  wclkp->busy       = false;
+  osalSysUnlock();
+
+  return err;
+}
+
+/**
+ * @brief   Sets the time.
+ * @details The RTC is written and the wall clock is stepped to the new
+ *          time.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @param[in] timespec  pointer to a @p RTCDateTime structure
+ *
+ * @api
+ */
+void wclkSetTime(WallClockDriver *wclkp, const RTCDateTime *timespec) {
+  int64_t s;
+
+  osalDbgCheck((wclkp != NULL) && (timespec != NULL));
+  osalDbgAssert(wclkp->state == WCLK_READY, "invalid state");
+
+  rtcSetTime(wclkp->config->rtcp, timespec);
+
+  osalSysLock();
+  (void) wclk_elapsed(wclkp, &s);
+  wclkp->slew_us = 0;
+  wclkp->dstflag = timespec->dstflag;
+  wclk_rebase(wclkp, wclk_datetime_to_us(timespec));
+  wclk_restart_baseline(wclkp, wclkp->base_us);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns the time in microseconds.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @return              The time in microseconds since 1970.
+ *
+ * @api
+ */
+int64_t wclkGetTimeUS(WallClockDriver *wclkp) {
+
+  osalDbgCheck(wclkp != NULL);
+  osalDbgAssert(wclkp->state == WCLK_READY, "invalid state");
+
+  return wclk_get(wclkp);
+}
+
+/**
+ * @brief   Returns the time in seconds.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @return              The time in seconds since 1970.
+ *
+ * @api
+ */
+time_t wclkGetTime(WallClockDriver *wclkp) {
+
+  osalDbgCheck(wclkp != NULL);
+  osalDbgAssert(wclkp->state == WCLK_READY, "invalid state");
+
+  return (time_t)wclk_floor_div(wclk_get(wclkp), 1000000);
+}
+
+/**
+ * @brief   Returns the time as broken-down time structure.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @param[out] timp     pointer to a broken-down time structure
+ * @param[out] tv_msec  pointer to milliseconds value or @p NULL
+ *
+ * @api
+ */
+void wclkGetStructTm(WallClockDriver *wclkp,
+                     struct tm *timp,
+                     uint32_t *tv_msec) {
+  int64_t us, secs;
+  int sod;
+
+  osalDbgCheck((wclkp != NULL) && (timp != NULL));
+  osalDbgAssert(wclkp->state == WCLK_READY, "invalid state");
+
+  us   = wclk_get(wclkp);
+  secs = wclk_floor_div(us, 1000000);
+
+  osalSysLock();
+  wclk_update_day(wclkp, secs);
+  *timp = wclkp->day_tm;
+  sod   = (int)(secs - wclkp->day_start);
+  timp->tm_isdst = (int)wclkp->dstflag;
+  osalSysUnlock();
+
+  timp->tm_hour = sod / 3600;
+  sod %= 3600;
+  timp->tm_min  = sod / 60;
+  timp->tm_sec  = sod % 60;
+
+  if (tv_msec != NULL) {
+    *tv_msec = (uint32_t)((us - (secs * 1000000)) / 1000);
+  }
+}
+
+/**
+ * @brief   Returns the time in format suitable for usage in FAT file system.
+ * @note    The information about day of week and DST is lost in DOS
+ *          format, the second field loses its least significant bit.
+ *
+ * @param[in] wclkp     pointer to the @p WallClockDriver object
+ * @return              FAT date/time value.
+ *
+ * @api
+ */
+uint32_t wclkGetFAT(WallClockDriver *wclkp) {
+  int64_t secs;
+  uint32_t fattime, sod;
+
+  osalDbgCheck(wclkp != NULL);
+  osalDbgAssert(wclkp->state == WCLK_READY, "invalid state");
+
+  secs = wclk_floor_div(wclk_get(wclkp), 1000000);
+
+  osalSysLock();
+  if (wclkp->dstflag == 1U) {
+    secs += 3600;
+  }
+  wclk_update_day(wclkp, secs);
+  sod     = (uint32_t)(secs - wclkp->day_start);
+  fattime = wclkp->day_fat;
+  osalSysUnlock();
+
+  fattime |= (sod % 60U) >> 1U;
+  fattime |= ((sod / 60U) % 60U) << 5U;
+  fattime |= (sod / 3600U) << 11U;
+
+  return fattime;
+}
+
+/** @} */
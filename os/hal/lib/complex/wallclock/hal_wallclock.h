@@ -0,0 +1,253 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_wallclock.h
+ * @brief   RTC disciplined wall clock module header.
+ *
+ * @addtogroup HAL_WALLCLOCK
+ * @{
+ */
+
+#ifndef HAL_WALLCLOCK_H
+#define HAL_WALLCLOCK_H
+
+#include <time.h>
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Seconds in a day.
+ */
+#define WCLK_SECONDS_PER_DAY                86400
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Phase correction gain as a power of two divider.
+ * @details Only the measured error divided by 2^WCLK_CFG_PHASE_SHIFT is
+ *          slewed on each discipline, this averages the RTC resolution
+ *          error over several readings.
+ */
+#if !defined(WCLK_CFG_PHASE_SHIFT) || defined(__DOXYGEN__)
+#define WCLK_CFG_PHASE_SHIFT                2
+#endif
+
+/**
+ * @brief   Frequency estimation window in seconds.
+ * @details The frequency error is measured against the RTC over a baseline
+ *          growing up to this window, the RTC resolution error on the
+ *          estimate is the resolution divided by the window. Longer windows
+ *          are more accurate but track oscillator changes slower.
+ */
+#if !defined(WCLK_CFG_FREQ_WINDOW) || defined(__DOXYGEN__)
+#define WCLK_CFG_FREQ_WINDOW                600
+#endif
+
+/**
+ * @brief   Maximum frequency correction in parts per million.
+ */
+#if !defined(WCLK_CFG_MAX_FREQ) || defined(__DOXYGEN__)
+#define WCLK_CFG_MAX_FREQ                   500
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_USE_RTC != TRUE
+#error "WALLCLOCK requires HAL_USE_RTC"
+#endif
+
+#if (WCLK_CFG_PHASE_SHIFT < 0) || (WCLK_CFG_PHASE_SHIFT > 8)
+#error "invalid WCLK_CFG_PHASE_SHIFT value"
+#endif
+
+#if (WCLK_CFG_FREQ_WINDOW < 1) || (WCLK_CFG_FREQ_WINDOW > 86400)
+#error "invalid WCLK_CFG_FREQ_WINDOW value"
+#endif
+
+#if (WCLK_CFG_MAX_FREQ < 0) || (WCLK_CFG_MAX_FREQ > 100000)
+#error "invalid WCLK_CFG_MAX_FREQ value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a wall clock state.
+ */
+typedef enum {
+  WCLK_UNINIT = 0,
+  WCLK_STOP = 1,
+  WCLK_READY = 2
+} wclkstate_t;
+
+/**
+ * @brief   Type of a wall clock configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   RTC used as time reference.
+   */
+  RTCDriver                 *rtcp;
+  /**
+   * @brief   Interval between RTC readings.
+   * @details The RTC is read by the first access to the wall clock after
+   *          the interval expired, zero disables the automatic discipline,
+   *          in that case @p wclkDiscipline() must be called explicitly.
+   * @note    The interval must be shorter than the system time wrap
+   *          period.
+   */
+  sysinterval_t             period;
+  /**
+   * @brief   Errors larger than this threshold are stepped, microseconds.
+   * @note    It must be larger than the RTC resolution.
+   */
+  uint32_t                  step_threshold;
+  /**
+   * @brief   Maximum slew rate in parts per million.
+   * @details Errors below the step threshold are corrected by changing the
+   *          clock rate up to this value, the clock never goes backward
+   *          while slewing.
+   */
+  uint32_t                  max_slew;
+} WallClockConfig;
+
+/**
+ * @brief   Structure representing a wall clock.
+ */
+typedef struct {
+  /**
+   * @brief   Driver state.
+   */
+  wclkstate_t               state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const WallClockConfig     *config;
+  /**
+   * @brief   Last observed system time.
+   */
+  systime_t                 last;
+  /**
+   * @brief   System time extended to 64 bits.
+   */
+  uint64_t                  ticks;
+  /**
+   * @brief   Extended system time of the last discipline.
+   */
+  uint64_t                  base_ticks;
+  /**
+   * @brief   Wall time of the last discipline, microseconds since 1970.
+   */
+  int64_t                   base_us;
+  /**
+   * @brief   Phase correction to be slewed, microseconds.
+   */
+  int64_t                   slew_us;
+  /**
+   * @brief   Frequency correction in parts per billion.
+   */
+  int32_t                   freq;
+  /**
+   * @brief   Extended system time of the frequency baseline start.
+   */
+  uint64_t                  ref_ticks;
+  /**
+   * @brief   RTC time of the frequency baseline start, microseconds.
+   */
+  int64_t                   ref_us;
+  /**
+   * @brief   Extended system time of the next discipline.
+   */
+  uint64_t                  next_ticks;
+  /**
+   * @brief   A discipline is in progress.
+   */
+  bool                      busy;
+  /**
+   * @brief   DST flag of the last RTC reading.
+   */
+  uint32_t                  dstflag;
+  /**
+   * @brief   Cached day, seconds since 1970 of its start.
+   */
+  int64_t                   day_start;
+  /**
+   * @brief   Date fields of the cached day.
+   */
+  struct tm                 day_tm;
+  /**
+   * @brief   FAT date fields of the cached day.
+   */
+  uint32_t                  day_fat;
+  /**
+   * @brief   Error measured by the last discipline, microseconds.
+   */
+  int64_t                   last_error;
+  /**
+   * @brief   Number of RTC readings.
+   */
+  uint32_t                  disciplines;
+  /**
+   * @brief   Number of steps.
+   */
+  uint32_t                  steps;
+} WallClockDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void wclkObjectInit(WallClockDriver *wclkp);
+  void wclkStart(WallClockDriver *wclkp, const WallClockConfig *config);
+  void wclkStop(WallClockDriver *wclkp);
+  int64_t wclkDiscipline(WallClockDriver *wclkp);
+  void wclkSetTime(WallClockDriver *wclkp, const RTCDateTime *timespec);
+  int64_t wclkGetTimeUS(WallClockDriver *wclkp);
+  time_t wclkGetTime(WallClockDriver *wclkp);
+  void wclkGetStructTm(WallClockDriver *wclkp,
+                       struct tm *timp,
+                       uint32_t *tv_msec);
+  uint32_t wclkGetFAT(WallClockDriver *wclkp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_WALLCLOCK_H */
+
+/** @} */
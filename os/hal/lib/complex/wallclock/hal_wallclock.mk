@@ -0,0 +1,9 @@
+# List of all the wall clock files.
+WCLKSRC := $(CHIBIOS)/os/hal/lib/complex/wallclock/hal_wallclock.c
+
+# Required include directories
+WCLKINC := $(CHIBIOS)/os/hal/lib/complex/wallclock
+
+# Shared variables
+ALLCSRC += $(WCLKSRC)
+ALLINC  += $(WCLKINC)
@@ -85,7 +85,50 @@ static msg_t _get(void *ip) {
   return b;
 }
 
-static const struct MemStreamVMT vmt = {(size_t)0, _writes, _reads, _put, _get};
+static size_t _writev(void *ip, const stream_iovec_t *iov, size_t n,
+                      sysinterval_t time) {
+  MemoryStream *msp = ip;
+  size_t total = 0;
+
+  (void)time;
+
+  while ((n > 0) && (msp->eos < msp->size)) {
+    size_t k = iov->n;
+
+    if (msp->size - msp->eos < k)
+      k = msp->size - msp->eos;
+    memcpy(msp->buffer + msp->eos, iov->bp, k);
+    msp->eos += k;
+    total += k;
+    iov++;
+    n--;
+  }
+  return total;
+}
+
+static size_t _readv(void *ip, const stream_iovec_t *iov, size_t n,
+                     sysinterval_t time) {
+  MemoryStream *msp = ip;
+  size_t total = 0;
+
+  (void)time;
+
+  while ((n > 0) && (msp->offset < msp->eos)) {
+    size_t k = iov->n;
+
+    if (msp->eos - msp->offset < k)
+      k = msp->eos - msp->offset;
+    memcpy(iov->bp, msp->buffer + msp->offset, k);
+    msp->offset += k;
+    total += k;
+    iov++;
+    n--;
+  }
+  return total;
+}
+
+static const struct MemStreamVMT vmt = {(size_t)0, _writes, _reads, _put, _get,
+                                        _writev, _readv};
 
 /*===========================================================================*/
 /* Driver exported functions.                                                */
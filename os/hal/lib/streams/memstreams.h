@@ -60,6 +60,7 @@
  */
 struct MemStreamVMT {
   _base_sequential_stream_methods
+  _vectored_stream_methods
 };
 
 /**
@@ -506,7 +506,7 @@ static inline void osalSysEnable(void) {
  *
  * @special
  */
-static inline void osalSysLock(void) {
+static inline CH_STATS_FORCE_INLINE void osalSysLock(void) {
 
   chSysLock();
 }
@@ -528,7 +528,7 @@ static inline void osalSysUnlock(void) {
  *
  * @special
  */
-static inline void osalSysLockFromISR(void) {
+static inline CH_STATS_FORCE_INLINE void osalSysLockFromISR(void) {
 
   chSysLockFromISR();
 }
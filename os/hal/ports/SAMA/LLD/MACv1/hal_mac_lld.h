@@ -282,6 +282,26 @@ typedef struct {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the driver capabilities.
+ * @note    When the offload is enabled received frames with wrong IP, UDP
+ *          or TCP checksums are discarded by the GMAC.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The capabilities mask.
+ *
+ * @notapi
+ */
+#if (SAMA_MAC_IP_CHECKSUM_OFFLOAD == 0) || defined(__DOXYGEN__)
+#define mac_lld_get_capabilities(macp)  0U
+#else
+#define mac_lld_get_capabilities(macp)                                      \
+  (MAC_CAP_CHECKSUM_GEN_IP    | MAC_CAP_CHECKSUM_GEN_UDP    |               \
+   MAC_CAP_CHECKSUM_GEN_TCP   |                                             \
+   MAC_CAP_CHECKSUM_CHECK_IP  | MAC_CAP_CHECKSUM_CHECK_UDP  |               \
+   MAC_CAP_CHECKSUM_CHECK_TCP)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
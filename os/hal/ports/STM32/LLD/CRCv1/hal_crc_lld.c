@@ -0,0 +1,345 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    CRCv1/hal_crc_lld.c
+ * @brief   STM32 CRC subsystem low level driver source.
+ * @note    Only the CRC units with programmable initial value and input
+ *          reflection are used, models not supported by the unit are
+ *          handled by the high level driver fall-back.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Byte access to the data register.
+ */
+#define CRC_DR8             (*(volatile uint8_t *)(void *)&CRC->DR)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   CRCD1 driver identifier.
+ */
+#if (STM32_CRC_USE_CRC1 == TRUE) || defined(__DOXYGEN__)
+CRCDriver CRCD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+#if (STM32_CRC_DMA_THRESHOLD != 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Shared end-of-transfer service routine.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void crc_lld_serve_dma_interrupt(CRCDriver *crcp, uint32_t flags) {
+
+  /* DMA errors handling.*/
+#if defined(STM32_CRC_DMA_ERROR_HOOK)
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0U) {
+    STM32_CRC_DMA_ERROR_HOOK(crcp);
+  }
+#endif
+
+  if ((flags & STM32_DMA_ISR_TCIF) != 0U) {
+    /* End buffer interrupt.*/
+
+    /* Resuming waiting thread.*/
+    osalSysLockFromISR();
+    osalThreadResumeI(&crcp->tr, MSG_OK);
+    osalSysUnlockFromISR();
+  }
+}
+#endif
+
+#if (STM32_CRC_USE_CRC1 == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Pushes data into the CRC unit using the CPU.
+ * @details Aligned words are byte-swapped and written at once, the input
+ *          reflection is programmed on byte boundaries so the result is
+ *          the same of writing the bytes in order.
+ *
+ * @param[in] n         number of bytes
+ * @param[in] p         pointer to the data
+ */
+static void crc_lld_push(size_t n, const uint8_t *p) {
+  const uint32_t *wp;
+
+  /* Leading bytes up to the first aligned word.*/
+  while ((((size_t)p & (sizeof (uint32_t) - 1U)) != 0U) && (n > 0U)) {
+    CRC_DR8 = *p++;
+    n--;
+  }
+
+  /* Aligned words.*/
+  wp = (const uint32_t *)(const void *)p;
+  while (n >= sizeof (uint32_t)) {
+    CRC->DR = __REV(*wp++);
+    n -= sizeof (uint32_t);
+  }
+
+  /* Trailing bytes.*/
+  p = (const uint8_t *)wp;
+  while (n > 0U) {
+    CRC_DR8 = *p++;
+    n--;
+  }
+}
+
+/**
+ * @brief   Programs the CRC unit for a model.
+ * @note    The units without input reflection have fixed initial value
+ *          and polynomial, those are never used.
+ *
+ * @param[in] config    pointer to the @p CRCConfig object
+ * @return              The hardware support for the model.
+ */
+static bool crc_lld_configure(const CRCConfig *config) {
+#if defined(CRC_CR_REV_IN)
+  uint32_t cr;
+
+  if (config->refin != config->refout) {
+    return false;
+  }
+  cr = config->refin ? CRC_CR_REV_IN_0 | CRC_CR_REV_OUT : 0U;
+
+#if defined(CRC_CR_POLYSIZE)
+  switch (config->width) {
+  case 32U:
+    break;
+  case 16U:
+    cr |= CRC_CR_POLYSIZE_0;
+    break;
+  case 8U:
+    cr |= CRC_CR_POLYSIZE_1;
+    break;
+  case 7U:
+    cr |= CRC_CR_POLYSIZE_1 | CRC_CR_POLYSIZE_0;
+    break;
+  default:
+    return false;
+  }
+  CRC->POL  = config->poly;
+#else
+  if ((config->width != 32U) || (config->poly != 0x04C11DB7U)) {
+    return false;
+  }
+#endif
+  CRC->INIT = config->init;
+  CRC->CR   = cr | CRC_CR_RESET;
+
+  return true;
+#else
+  (void)config;
+
+  return false;
+#endif
+}
+#endif /* STM32_CRC_USE_CRC1 == TRUE */
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level CRC driver initialization.
+ *
+ * @notapi
+ */
+void crc_lld_init(void) {
+
+#if STM32_CRC_USE_CRC1 == TRUE
+  /* Driver initialization.*/
+  crcObjectInit(&CRCD1);
+#if STM32_CRC_DMA_THRESHOLD != 0
+  CRCD1.tr  = NULL;
+  CRCD1.dma = NULL;
+#endif
+#endif
+}
+
+/**
+ * @brief   Configures and activates the CRC peripheral.
+ * @details The peripheral is programmed for the model specified in the
+ *          configuration and the CRC reset to its initial value.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The hardware support for the configured model.
+ * @retval false        if the model is not supported, the high level
+ *                      driver uses the fall-back implementation.
+ * @retval true         if the model is supported.
+ *
+ * @notapi
+ */
+bool crc_lld_start(CRCDriver *crcp) {
+
+#if STM32_CRC_USE_CRC1 == TRUE
+  if (&CRCD1 == crcp) {
+    if (crcp->state == CRC_STOP) {
+      /* Enables the peripheral.*/
+#if STM32_CRC_DMA_THRESHOLD != 0
+      crcp->dma = dmaStreamAllocI(STM32_CRC_CRC1_DMA_STREAM,
+                                  STM32_CRC_CRC1_DMA_IRQ_PRIORITY,
+                                  (stm32_dmaisr_t)crc_lld_serve_dma_interrupt,
+                                  (void *)crcp);
+      osalDbgAssert(crcp->dma != NULL, "unable to allocate stream");
+
+      /* Preparing the DMA channel, the source is the peripheral port of
+         the stream, the data register is the fixed destination.*/
+      dmaStreamSetMode(crcp->dma,
+                       STM32_DMA_CR_PL(STM32_CRC_CRC1_DMA_PRIORITY) |
+                       STM32_DMA_CR_PINC | STM32_DMA_CR_DIR_M2M |
+                       STM32_DMA_CR_MSIZE_BYTE | STM32_DMA_CR_PSIZE_BYTE |
+                       STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE |
+                       STM32_DMA_CR_TCIE);
+      dmaStreamSetMemory0(crcp->dma, &CRC->DR);
+#endif
+      rccEnableCRC(true);
+    }
+
+    /* Configures the peripheral.*/
+    return crc_lld_configure(crcp->config);
+  }
+#endif
+
+  /* Objects not associated to the unit.*/
+  return false;
+}
+
+/**
+ * @brief   Deactivates the CRC peripheral.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+void crc_lld_stop(CRCDriver *crcp) {
+
+  if (crcp->state == CRC_READY) {
+    /* Disables the peripheral.*/
+#if STM32_CRC_USE_CRC1 == TRUE
+    if (&CRCD1 == crcp) {
+#if STM32_CRC_DMA_THRESHOLD != 0
+      dmaStreamFreeI(crcp->dma);
+      crcp->dma = NULL;
+#endif
+      rccDisableCRC();
+    }
+#endif
+  }
+}
+
+/**
+ * @brief   Resets the CRC to the initial value of the model.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+void crc_lld_reset(CRCDriver *crcp) {
+
+  (void)crcp;
+
+  CRC->CR |= CRC_CR_RESET;
+}
+
+/**
+ * @brief   Feeds data to the CRC unit.
+ * @note    Transfers larger than @p STM32_CRC_DMA_THRESHOLD are performed
+ *          by DMA, the invoking thread is suspended until completion.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] n         number of bytes, it is always greater than zero
+ * @param[in] p         pointer to the data
+ *
+ * @notapi
+ */
+void crc_lld_update(CRCDriver *crcp, size_t n, const uint8_t *p) {
+
+  (void)crcp; /* Not touched in some cases, needs this.*/
+
+#if STM32_CRC_DMA_THRESHOLD != 0
+  if (n >= (size_t)STM32_CRC_DMA_THRESHOLD) {
+    /* Data is processed in 64kB blocks because DMA size limitations.*/
+    while (n > 0U) {
+      size_t chunk = n > 0xFFFFU ? 0xFFFFU : n;
+
+      /* Setting up transfer.*/
+      dmaStreamSetTransactionSize(crcp->dma, chunk);
+      dmaStreamSetPeripheral(crcp->dma, p);
+      p += chunk;
+      n -= chunk;
+
+      osalSysLock();
+
+      /* Enabling DMA channel.*/
+      dmaStreamEnable(crcp->dma);
+
+      /* Waiting for DMA operation completion.*/
+      osalThreadSuspendS(&crcp->tr);
+
+      osalSysUnlock();
+    }
+    return;
+  }
+#endif
+
+  /* Small block, just pushing data without touching DMA.*/
+  crc_lld_push(n, p);
+}
+
+/**
+ * @brief   Returns the current CRC.
+ * @note    The final XOR is applied by the high level driver.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The CRC before the final XOR.
+ *
+ * @notapi
+ */
+uint32_t crc_lld_get_value(CRCDriver *crcp) {
+
+  (void)crcp;
+
+  return CRC->DR;
+}
+
+#endif /* HAL_USE_CRC == TRUE */
+
+/** @} */
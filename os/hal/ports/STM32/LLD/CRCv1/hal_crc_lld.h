@@ -0,0 +1,173 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    CRCv1/hal_crc_lld.h
+ * @brief   STM32 CRC subsystem low level driver header.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#ifndef HAL_CRC_LLD_H
+#define HAL_CRC_LLD_H
+
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    STM32 configuration options
+ * @{
+ */
+/**
+ * @brief   CRCD1 driver enable switch.
+ * @details If set to @p TRUE the support for CRCD1 is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_CRC_USE_CRC1) || defined(__DOXYGEN__)
+#define STM32_CRC_USE_CRC1                  FALSE
+#endif
+
+/**
+ * @brief   Minimum data size (in bytes) for DMA use.
+ * @note    If set to zero then DMA is never used.
+ * @note    If set to one then DMA is always used.
+ */
+#if !defined(STM32_CRC_DMA_THRESHOLD) || defined(__DOXYGEN__)
+#define STM32_CRC_DMA_THRESHOLD             0
+#endif
+
+/**
+ * @brief   CRC1 DMA interrupt priority level setting.
+ */
+#if !defined(STM32_CRC_CRC1_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_CRC_CRC1_DMA_IRQ_PRIORITY     9
+#endif
+
+/**
+ * @brief   CRC1 DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_CRC_CRC1_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_CRC_CRC1_DMA_PRIORITY         0
+#endif
+
+/**
+ * @brief   CRC DMA error hook.
+ * @note    The default action for DMA errors is a system halt because DMA
+ *          error can only happen because programming errors.
+ */
+#if !defined(STM32_CRC_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_CRC_DMA_ERROR_HOOK(crcp)      osalSysHalt("DMA failure")
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(STM32_HAS_CRC)
+#define STM32_HAS_CRC                       TRUE
+#endif
+
+#if STM32_CRC_USE_CRC1 && !STM32_HAS_CRC
+#error "CRC not present in the selected device"
+#endif
+
+#if STM32_CRC_DMA_THRESHOLD < 0
+#error "invalid STM32_CRC_DMA_THRESHOLD value"
+#endif
+
+#if STM32_CRC_USE_CRC1 && (STM32_CRC_DMA_THRESHOLD != 0)
+/* Check on the presence of the DMA streams settings in mcuconf.h.*/
+#if !defined(STM32_CRC_CRC1_DMA_STREAM)
+#error "CRC1 DMA stream not defined"
+#endif
+
+/* Sanity checks on DMA streams settings in mcuconf.h.*/
+#if !STM32_DMA_IS_VALID_STREAM(STM32_CRC_CRC1_DMA_STREAM)
+#error "Invalid DMA stream assigned to CRC1"
+#endif
+
+#if !OSAL_IRQ_IS_VALID_PRIORITY(STM32_CRC_CRC1_DMA_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to CRC1 DMA"
+#endif
+
+/* DMA priority check.*/
+#if !STM32_DMA_IS_VALID_PRIORITY(STM32_CRC_CRC1_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to CRC1"
+#endif
+
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+#endif /* STM32_CRC_USE_CRC1 && (STM32_CRC_DMA_THRESHOLD != 0) */
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the CRC driver structure.
+ */
+#if (STM32_CRC_DMA_THRESHOLD != 0) || defined(__DOXYGEN__)
+#define crc_lld_driver_fields                                               \
+  /* Thread waiting for a DMA transfer.*/                                   \
+  thread_reference_t        tr;                                             \
+  /* DMA stream used for large transfers.*/                                 \
+  const stm32_dma_stream_t  *dma
+#else
+#define crc_lld_driver_fields                                               \
+  /* Dummy field, it is not needed.*/                                       \
+  uint32_t                  dummy
+#endif
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (STM32_CRC_USE_CRC1 == TRUE) && !defined(__DOXYGEN__)
+extern CRCDriver CRCD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void crc_lld_init(void);
+  bool crc_lld_start(CRCDriver *crcp);
+  void crc_lld_stop(CRCDriver *crcp);
+  void crc_lld_reset(CRCDriver *crcp);
+  void crc_lld_update(CRCDriver *crcp, size_t n, const uint8_t *p);
+  uint32_t crc_lld_get_value(CRCDriver *crcp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CRC == TRUE */
+
+#endif /* HAL_CRC_LLD_H */
+
+/** @} */
@@ -312,6 +312,32 @@ typedef struct {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the driver capabilities.
+ * @note    When the offload is enabled received frames with wrong IP header
+ *          or payload checksum are discarded by the driver, the payload
+ *          checksum is inserted in hardware only in mode 3.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The capabilities mask.
+ *
+ * @notapi
+ */
+#if (STM32_MAC_IP_CHECKSUM_OFFLOAD == 0) || defined(__DOXYGEN__)
+#define mac_lld_get_capabilities(macp)  0U
+#elif STM32_MAC_IP_CHECKSUM_OFFLOAD == 3
+#define mac_lld_get_capabilities(macp)                                      \
+  (MAC_CAP_CHECKSUM_GEN_IP    | MAC_CAP_CHECKSUM_GEN_UDP    |               \
+   MAC_CAP_CHECKSUM_GEN_TCP   | MAC_CAP_CHECKSUM_GEN_ICMP   |               \
+   MAC_CAP_CHECKSUM_CHECK_IP  | MAC_CAP_CHECKSUM_CHECK_UDP  |               \
+   MAC_CAP_CHECKSUM_CHECK_TCP | MAC_CAP_CHECKSUM_CHECK_ICMP)
+#else
+#define mac_lld_get_capabilities(macp)                                      \
+  (MAC_CAP_CHECKSUM_GEN_IP    |                                             \
+   MAC_CAP_CHECKSUM_CHECK_IP  | MAC_CAP_CHECKSUM_CHECK_UDP  |               \
+   MAC_CAP_CHECKSUM_CHECK_TCP | MAC_CAP_CHECKSUM_CHECK_ICMP)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -31,6 +31,13 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    UART implementation capabilities
+ * @{
+ */
+#define UART_SUPPORTS_CIRCULAR_RX           TRUE
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -623,6 +630,12 @@ typedef struct {
    * @brief Initialization value for the CR3 register.
    */
   uint16_t                  cr3;
+#if (UART_USE_CIRCULAR_RX == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Circular receive events callback.
+   */
+  uartecb_t                 rxcirc_cb;
+#endif
 } UARTConfig;
 
 /**
@@ -665,6 +678,9 @@ struct UARTDriver {
    */
   mutex_t                   mutex;
 #endif /* UART_USE_MUTUAL_EXCLUSION */
+#if (UART_USE_CIRCULAR_RX == TRUE) || defined(__DOXYGEN__)
+  _uart_circular_rx_data
+#endif
 #if defined(UART_DRIVER_EXT_FIELDS)
   UART_DRIVER_EXT_FIELDS
 #endif
@@ -741,6 +757,11 @@ extern "C" {
   size_t uart_lld_stop_send(UARTDriver *uartp);
   void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf);
   size_t uart_lld_stop_receive(UARTDriver *uartp);
+#if UART_USE_CIRCULAR_RX == TRUE
+  void uart_lld_start_receive_circular(UARTDriver *uartp, size_t n,
+                                       uint8_t *rxbuf);
+  size_t uart_lld_get_receive_position(UARTDriver *uartp);
+#endif
 #ifdef __cplusplus
 }
 #endif
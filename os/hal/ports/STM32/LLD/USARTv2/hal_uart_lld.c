@@ -312,6 +312,22 @@ static void uart_lld_serve_rx_end_irq(UARTDriver *uartp, uint32_t flags) {
   (void)flags;
 #endif
 
+#if UART_USE_CIRCULAR_RX == TRUE
+  if (uartp->rxstate == UART_RX_CIRCULAR) {
+    /* Receiver in circular state, the DMA keeps running and a callback is
+       generated, if enabled, for each half buffer.*/
+    uartflags_t events = 0U;
+
+    if ((flags & STM32_DMA_ISR_HTIF) != 0U) {
+      events |= UART_RX_HALF_EVENT;
+    }
+    if ((flags & STM32_DMA_ISR_TCIF) != 0U) {
+      events |= UART_RX_FULL_EVENT;
+    }
+    _uart_rx_circular_isr_code(uartp, events);
+    return;
+  }
+#endif
   if (uartp->rxstate == UART_RX_IDLE) {
     /* Receiver in idle state, a callback is generated, if enabled, for each
        received character and then the driver stays in the same state.*/
@@ -378,6 +394,18 @@ static void serve_usart_irq(UARTDriver *uartp) {
   /* Timeout interrupt sources are only checked if enabled in CR1.*/
   if (((cr1 & USART_CR1_IDLEIE) && (isr & USART_ISR_IDLE)) ||
       ((cr1 & USART_CR1_RTOIE) && (isr & USART_ISR_RTOF))) {
+#if UART_USE_CIRCULAR_RX == TRUE
+    /* In circular receive mode the idle interrupt is enabled by the driver,
+       the timeout callback is invoked only if enabled in the configuration.*/
+    if (uartp->rxstate == UART_RX_CIRCULAR) {
+      if ((isr & USART_ISR_IDLE) != 0U) {
+        _uart_rx_circular_isr_code(uartp, UART_RX_IDLE_EVENT);
+      }
+      if ((uartp->config->cr1 & (USART_CR1_IDLEIE | USART_CR1_RTOIE)) == 0U) {
+        return;
+      }
+    }
+#endif
     _uart_timeout_isr_code(uartp);
   }
 }
@@ -1071,11 +1099,71 @@ size_t uart_lld_stop_receive(UARTDriver *uartp) {
 
   dmaStreamDisable(uartp->dmarx);
   n = dmaStreamGetTransactionSize(uartp->dmarx);
+#if UART_USE_CIRCULAR_RX == TRUE
+  if (uartp->rxstate == UART_RX_CIRCULAR) {
+    /* Restoring the idle interrupt setting of the configuration.*/
+    uartp->usart->CR1 = (uartp->usart->CR1 & ~USART_CR1_IDLEIE) |
+                        (uartp->config->cr1 & USART_CR1_IDLEIE);
+  }
+#endif
   uart_enter_rx_idle_loop(uartp);
 
   return n;
 }
 
+#if (UART_USE_CIRCULAR_RX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a circular receive operation on the UART peripheral.
+ * @details The DMA runs in circular mode with both the half and full
+ *          transfer interrupts enabled, the idle line interrupt is enabled
+ *          for the duration of the operation.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         size of the circular buffer
+ * @param[out] rxbuf    the pointer to the circular buffer
+ *
+ * @notapi
+ */
+void uart_lld_start_receive_circular(UARTDriver *uartp, size_t n,
+                                     uint8_t *rxbuf) {
+
+  osalDbgAssert((uartp->dmamode & STM32_DMA_CR_PSIZE_MASK) ==
+                STM32_DMA_CR_PSIZE_BYTE, "not 8 bits frames");
+
+  /* Stopping previous activity (idle state).*/
+  dmaStreamDisable(uartp->dmarx);
+
+  /* RX DMA channel preparation.*/
+  dmaStreamSetMemory0(uartp->dmarx, rxbuf);
+  dmaStreamSetTransactionSize(uartp->dmarx, n);
+  dmaStreamSetMode(uartp->dmarx, uartp->dmamode    | STM32_DMA_CR_DIR_P2M |
+                                 STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC    |
+                                 STM32_DMA_CR_HTIE | STM32_DMA_CR_TCIE);
+
+  /* Idle line detection.*/
+  uartp->usart->ICR = USART_ICR_IDLECF;
+  uartp->usart->CR1 |= USART_CR1_IDLEIE;
+
+  /* Starting transfer.*/
+  dmaStreamEnable(uartp->dmarx);
+}
+
+/**
+ * @brief   Returns the circular receive position.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @return              The number of frames written in the current buffer
+ *                      lap.
+ *
+ * @notapi
+ */
+size_t uart_lld_get_receive_position(UARTDriver *uartp) {
+
+  return uartp->rxcsize - (size_t)dmaStreamGetTransactionSize(uartp->dmarx);
+}
+#endif /* UART_USE_CIRCULAR_RX == TRUE */
+
 #endif /* HAL_USE_UART */
 
 /** @} */
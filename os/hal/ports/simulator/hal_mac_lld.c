@@ -0,0 +1,372 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_mac_lld.c
+ * @brief   Simulator MAC subsystem low level driver source.
+ *
+ * @addtogroup MAC
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_MAC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   ETHD1 driver identifier.
+ */
+#if (USE_SIM_MAC1 == TRUE) || defined(__DOXYGEN__)
+MACDriver ETHD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level MAC initialization.
+ *
+ * @notapi
+ */
+void mac_lld_init(void) {
+
+#if USE_SIM_MAC1 == TRUE
+  macObjectInit(&ETHD1);
+  ETHD1.link_up = true;
+  ETHD1.txhook  = NULL;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the MAC peripheral.
+ * @note    Frames left in the receive ring are discarded.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_start(MACDriver *macp) {
+  unsigned i;
+
+  macp->rxbusy = false;
+  macp->rxtail = 0U;
+  macp->rxcnt  = 0U;
+  for (i = 0U; i < (unsigned)SIM_MAC_TRANSMIT_BUFFERS; i++) {
+    macp->txbusy[i] = false;
+  }
+  memset(&macp->stats, 0, sizeof (mac_sim_stats_t));
+}
+
+/**
+ * @brief   Deactivates the MAC peripheral.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_stop(MACDriver *macp) {
+
+  (void)macp;
+}
+
+/**
+ * @brief   Returns a transmission descriptor.
+ * @details One of the available transmission descriptors is locked and
+ *          returned.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tdp      pointer to a @p MACTransmitDescriptor structure
+ * @return              The operation status.
+ * @retval MSG_OK       the descriptor has been obtained.
+ * @retval MSG_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                      MACTransmitDescriptor *tdp) {
+  unsigned i;
+
+  if (!macp->link_up) {
+    return MSG_TIMEOUT;
+  }
+
+  osalSysLock();
+  for (i = 0U; i < (unsigned)SIM_MAC_TRANSMIT_BUFFERS; i++) {
+    if (!macp->txbusy[i]) {
+      macp->txbusy[i] = true;
+      osalSysUnlock();
+
+      tdp->offset = 0U;
+      tdp->size   = (size_t)SIM_MAC_BUFFERS_SIZE;
+      tdp->macp   = macp;
+      tdp->index  = i;
+      return MSG_OK;
+    }
+  }
+  osalSysUnlock();
+
+  return MSG_TIMEOUT;
+}
+
+/**
+ * @brief   Releases a transmit descriptor and starts the transmission of the
+ *          enqueued data as a single frame.
+ * @details The frame is passed to the transmit hook, if any, before the
+ *          buffer is made available again.
+ *
+ * @param[in] tdp       the pointer to the @p MACTransmitDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp) {
+  MACDriver *macp = tdp->macp;
+  sim_mac_hook_t hook = macp->txhook;
+
+  if (hook != NULL) {
+    hook(macp, macp->txbuf[tdp->index], tdp->offset);
+  }
+
+  osalSysLock();
+  macp->stats.tx_frames++;
+  macp->txbusy[tdp->index] = false;
+  osalThreadDequeueNextI(&macp->tdqueue, MSG_OK);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns a receive descriptor.
+ * @note    Only one receive descriptor can be in use at any time.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] rdp      pointer to a @p MACReceiveDescriptor structure
+ * @return              The operation status.
+ * @retval MSG_OK       the descriptor has been obtained.
+ * @retval MSG_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                     MACReceiveDescriptor *rdp) {
+
+  osalSysLock();
+  if ((macp->rxcnt == 0U) || macp->rxbusy) {
+    osalSysUnlock();
+    return MSG_TIMEOUT;
+  }
+  macp->rxbusy = true;
+  osalSysUnlock();
+
+  rdp->offset = 0U;
+  rdp->size   = macp->rxsize[macp->rxtail];
+  rdp->macp   = macp;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases a receive descriptor.
+ * @details The descriptor and its buffer are made available for more incoming
+ *          frames.
+ *
+ * @param[in] rdp       the pointer to the @p MACReceiveDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp) {
+  MACDriver *macp = rdp->macp;
+
+  osalSysLock();
+  macp->rxtail = (macp->rxtail + 1U) % (unsigned)SIM_MAC_RECEIVE_BUFFERS;
+  macp->rxcnt--;
+  macp->rxbusy = false;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Updates and returns the link status.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ * @retval true         if the link is active.
+ * @retval false        if the link is down.
+ *
+ * @notapi
+ */
+bool mac_lld_poll_link_status(MACDriver *macp) {
+
+  return macp->link_up;
+}
+
+/**
+ * @brief   Writes to a transmit descriptor's stream.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] buf       pointer to the buffer containing the data to be
+ *                      written
+ * @param[in] size      number of bytes to be written
+ * @return              The number of bytes written into the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if the maximum
+ *                      frame size is reached.
+ *
+ * @notapi
+ */
+size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                         uint8_t *buf,
+                                         size_t size) {
+
+  if (size > tdp->size - tdp->offset) {
+    size = tdp->size - tdp->offset;
+  }
+
+  memcpy(&tdp->macp->txbuf[tdp->index][tdp->offset], buf, size);
+  tdp->offset += size;
+
+  return size;
+}
+
+/**
+ * @brief   Reads from a receive descriptor's stream.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[in] buf       pointer to the buffer that will receive the read data
+ * @param[in] size      number of bytes to be read
+ * @return              The number of bytes read from the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if there are
+ *                      no more bytes to read.
+ *
+ * @notapi
+ */
+size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                       uint8_t *buf,
+                                       size_t size) {
+
+  if (size > rdp->size - rdp->offset) {
+    size = rdp->size - rdp->offset;
+  }
+
+  memcpy(buf, &rdp->macp->rxbuf[rdp->macp->rxtail][rdp->offset], size);
+  rdp->offset += size;
+
+  return size;
+}
+
+/**
+ * @brief   Puts a frame on the emulated wire.
+ * @details The frame is copied in the receive ring and the waiting threads
+ *          are notified as it would happen on a reception interrupt.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] buf       pointer to the frame
+ * @param[in] n         size of the frame
+ * @return              The operation status.
+ * @retval true         if the frame has been queued.
+ * @retval false        if the frame has been dropped because the ring
+ *                      is full, the link is down or the driver is not
+ *                      active.
+ *
+ * @api
+ */
+bool simMacInject(MACDriver *macp, const uint8_t *buf, size_t n) {
+  unsigned head;
+
+  osalDbgCheck((macp != NULL) && (buf != NULL) &&
+               (n <= (size_t)SIM_MAC_BUFFERS_SIZE));
+
+  osalSysLock();
+  if ((macp->state != MAC_ACTIVE) || !macp->link_up ||
+      (macp->rxcnt >= (unsigned)SIM_MAC_RECEIVE_BUFFERS)) {
+    macp->stats.rx_dropped++;
+    osalSysUnlock();
+    return false;
+  }
+  head = (macp->rxtail + macp->rxcnt) % (unsigned)SIM_MAC_RECEIVE_BUFFERS;
+  memcpy(macp->rxbuf[head], buf, n);
+  macp->rxsize[head] = n;
+  macp->rxcnt++;
+  macp->stats.rx_frames++;
+  osalThreadDequeueAllI(&macp->rdqueue, MSG_RESET);
+#if MAC_USE_EVENTS == TRUE
+  osalEventBroadcastFlagsI(&macp->rdevent, (eventflags_t)0);
+#endif
+  osalOsRescheduleS();
+  osalSysUnlock();
+
+  return true;
+}
+
+/**
+ * @brief   Sets the transmit hook.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] hook      hook function or @p NULL
+ *
+ * @api
+ */
+void simMacSetTransmitHook(MACDriver *macp, sim_mac_hook_t hook) {
+
+  osalDbgCheck(macp != NULL);
+
+  osalSysLock();
+  macp->txhook = hook;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Changes the emulated link status.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] up        @p true if the link is up
+ *
+ * @api
+ */
+void simMacSetLinkStatus(MACDriver *macp, bool up) {
+
+  osalDbgCheck(macp != NULL);
+
+  osalSysLock();
+  macp->link_up = up;
+  osalSysUnlock();
+}
+
+#endif /* HAL_USE_MAC == TRUE */
+
+/** @} */
@@ -0,0 +1,302 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_mac_lld.h
+ * @brief   Simulator MAC subsystem low level driver header.
+ * @details The driver emulates a MAC attached to a wire controlled by the
+ *          application, frames are put on the receive ring using
+ *          @p simMacInject() and transmitted frames are passed to a hook
+ *          function set using @p simMacSetTransmitHook(). This allows to
+ *          exercise and measure a network stack without any host network
+ *          interface.
+ *
+ * @addtogroup MAC
+ * @{
+ */
+
+#ifndef HAL_MAC_LLD_H
+#define HAL_MAC_LLD_H
+
+#if (HAL_USE_MAC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   This implementation does not support the zero-copy mode API.
+ */
+#define MAC_SUPPORTS_ZERO_COPY              FALSE
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   ETHD1 driver enable switch.
+ * @details If set to @p TRUE the support for ETHD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_MAC1) || defined(__DOXYGEN__)
+#define USE_SIM_MAC1                        TRUE
+#endif
+
+/**
+ * @brief   Number of frames in the receive ring.
+ */
+#if !defined(SIM_MAC_RECEIVE_BUFFERS) || defined(__DOXYGEN__)
+#define SIM_MAC_RECEIVE_BUFFERS             8
+#endif
+
+/**
+ * @brief   Number of available transmit buffers.
+ */
+#if !defined(SIM_MAC_TRANSMIT_BUFFERS) || defined(__DOXYGEN__)
+#define SIM_MAC_TRANSMIT_BUFFERS            2
+#endif
+
+/**
+ * @brief   Maximum supported frame size.
+ */
+#if !defined(SIM_MAC_BUFFERS_SIZE) || defined(__DOXYGEN__)
+#define SIM_MAC_BUFFERS_SIZE                1536
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if SIM_MAC_RECEIVE_BUFFERS < 1
+#error "invalid SIM_MAC_RECEIVE_BUFFERS value"
+#endif
+
+#if SIM_MAC_TRANSMIT_BUFFERS < 1
+#error "invalid SIM_MAC_TRANSMIT_BUFFERS value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a transmit hook.
+ * @details The hook is invoked with the content of each transmitted frame,
+ *          it runs in the context of the transmitting thread outside of
+ *          critical zones.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] buf       pointer to the frame
+ * @param[in] n         size of the frame
+ */
+typedef void (*sim_mac_hook_t)(MACDriver *macp, const uint8_t *buf, size_t n);
+
+/**
+ * @brief   Statistic counters of the emulated MAC.
+ */
+typedef struct {
+  /**
+   * @brief   Frames put on the receive ring.
+   */
+  uint32_t                  rx_frames;
+  /**
+   * @brief   Frames dropped because the receive ring was full.
+   */
+  uint32_t                  rx_dropped;
+  /**
+   * @brief   Transmitted frames.
+   */
+  uint32_t                  tx_frames;
+} mac_sim_stats_t;
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief MAC address.
+   */
+  uint8_t                   *mac_address;
+  /* End of the mandatory fields.*/
+} MACConfig;
+
+/**
+ * @brief   Structure representing a MAC driver.
+ */
+struct MACDriver {
+  /**
+   * @brief Driver state.
+   */
+  macstate_t                state;
+  /**
+   * @brief Current configuration data.
+   */
+  const MACConfig           *config;
+  /**
+   * @brief Transmit semaphore.
+   */
+  threads_queue_t           tdqueue;
+  /**
+   * @brief Receive semaphore.
+   */
+  threads_queue_t           rdqueue;
+#if (MAC_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Receive event.
+   */
+  event_source_t            rdevent;
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Emulated link status.
+   */
+  bool                      link_up;
+  /**
+   * @brief   A receive descriptor is in use.
+   */
+  bool                      rxbusy;
+  /**
+   * @brief   Index of the oldest frame in the receive ring.
+   */
+  unsigned                  rxtail;
+  /**
+   * @brief   Number of frames in the receive ring.
+   */
+  unsigned                  rxcnt;
+  /**
+   * @brief   Sizes of the frames in the receive ring.
+   */
+  size_t                    rxsize[SIM_MAC_RECEIVE_BUFFERS];
+  /**
+   * @brief   Receive ring buffers.
+   */
+  uint8_t                   rxbuf[SIM_MAC_RECEIVE_BUFFERS]
+                                 [SIM_MAC_BUFFERS_SIZE];
+  /**
+   * @brief   Transmit buffers in use.
+   */
+  bool                      txbusy[SIM_MAC_TRANSMIT_BUFFERS];
+  /**
+   * @brief   Transmit buffers.
+   */
+  uint8_t                   txbuf[SIM_MAC_TRANSMIT_BUFFERS]
+                                 [SIM_MAC_BUFFERS_SIZE];
+  /**
+   * @brief   Transmit hook or @p NULL.
+   */
+  sim_mac_hook_t            txhook;
+  /**
+   * @brief   Statistic counters.
+   */
+  mac_sim_stats_t           stats;
+};
+
+/**
+ * @brief   Structure representing a transmit descriptor.
+ */
+typedef struct {
+  /**
+   * @brief Current write offset.
+   */
+  size_t                    offset;
+  /**
+   * @brief Available space size.
+   */
+  size_t                    size;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the driver.
+   */
+  MACDriver                 *macp;
+  /**
+   * @brief   Index of the associated transmit buffer.
+   */
+  unsigned                  index;
+} MACTransmitDescriptor;
+
+/**
+ * @brief   Structure representing a receive descriptor.
+ */
+typedef struct {
+  /**
+   * @brief Current read offset.
+   */
+  size_t                    offset;
+  /**
+   * @brief Available data size.
+   */
+  size_t                    size;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the driver.
+   */
+  MACDriver                 *macp;
+} MACReceiveDescriptor;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the driver capabilities.
+ * @note    The emulated MAC does not offload checksums.
+ */
+#define mac_lld_get_capabilities(macp)      0U
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (USE_SIM_MAC1 == TRUE) && !defined(__DOXYGEN__)
+extern MACDriver ETHD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void mac_lld_init(void);
+  void mac_lld_start(MACDriver *macp);
+  void mac_lld_stop(MACDriver *macp);
+  msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                        MACTransmitDescriptor *tdp);
+  void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp);
+  msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                       MACReceiveDescriptor *rdp);
+  void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp);
+  bool mac_lld_poll_link_status(MACDriver *macp);
+  size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                           uint8_t *buf,
+                                           size_t size);
+  size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                         uint8_t *buf,
+                                         size_t size);
+  bool simMacInject(MACDriver *macp, const uint8_t *buf, size_t n);
+  void simMacSetTransmitHook(MACDriver *macp, sim_mac_hook_t hook);
+  void simMacSetLinkStatus(MACDriver *macp, bool up);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_MAC == TRUE */
+
+#endif /* HAL_MAC_LLD_H */
+
+/** @} */
@@ -16,12 +16,16 @@
 
 /**
  * @file    hal_st_lld.c
- * @brief   PLATFORM ST subsystem low level driver source.
+ * @brief   Simulator ST subsystem low level driver source.
  *
  * @addtogroup ST
  * @{
  */
 
+#if !defined(WIN32)
+#include <time.h>
+#endif
+
 #include "hal.h"
 
 #if (OSAL_ST_MODE != OSAL_ST_MODE_NONE) || defined(__DOXYGEN__)
@@ -42,6 +46,33 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Host time of the counter origin.
+ */
+#if defined(WIN32)
+static LARGE_INTEGER st_origin;
+static LARGE_INTEGER st_host_freq;
+#else
+static struct timespec st_origin;
+#endif
+
+/**
+ * @brief   Alarm time.
+ */
+static systime_t st_alarm;
+
+/**
+ * @brief   Alarm enabled.
+ */
+static bool st_alarm_active;
+
+/**
+ * @brief   Alarm not yet triggered since it has been set.
+ */
+static bool st_alarm_armed;
+#endif /* OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING */
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -60,7 +91,160 @@
  * @notapi
  */
 void st_lld_init(void) {
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+#if defined(WIN32)
+  QueryPerformanceFrequency(&st_host_freq);
+  QueryPerformanceCounter(&st_origin);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &st_origin);
+#endif
+  st_alarm_active = false;
+  st_alarm_armed  = false;
+#endif
+}
+
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the time counter value.
+ *
+ * @return              The counter value.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_counter(void) {
+  uint64_t sec, frac;
+
+#if defined(WIN32)
+  LARGE_INTEGER now;
+
+  QueryPerformanceCounter(&now);
+  sec  = (uint64_t)(now.QuadPart - st_origin.QuadPart) /
+         (uint64_t)st_host_freq.QuadPart;
+  frac = (uint64_t)(now.QuadPart - st_origin.QuadPart) %
+         (uint64_t)st_host_freq.QuadPart;
+  frac = (frac * (uint64_t)OSAL_ST_FREQUENCY) /
+         (uint64_t)st_host_freq.QuadPart;
+#else
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (now.tv_nsec < st_origin.tv_nsec) {
+    now.tv_sec--;
+    now.tv_nsec += 1000000000L;
+  }
+  sec  = (uint64_t)(now.tv_sec - st_origin.tv_sec);
+  frac = ((uint64_t)(now.tv_nsec - st_origin.tv_nsec) *
+          (uint64_t)OSAL_ST_FREQUENCY) / 1000000000U;
+#endif
+
+  return (systime_t)((sec * (uint64_t)OSAL_ST_FREQUENCY) + frac);
+}
+
+/**
+ * @brief   Starts the alarm.
+ * @note    Makes sure that no spurious alarms are triggered after
+ *          this call.
+ *
+ * @param[in] time      the time to be set for the first alarm
+ *
+ * @notapi
+ */
+void st_lld_start_alarm(systime_t time) {
+
+  st_alarm        = time;
+  st_alarm_active = true;
+  st_alarm_armed  = true;
+}
+
+/**
+ * @brief   Stops the alarm interrupt.
+ *
+ * @notapi
+ */
+void st_lld_stop_alarm(void) {
+
+  st_alarm_active = false;
+}
+
+/**
+ * @brief   Sets the alarm time.
+ *
+ * @param[in] time      the time to be set for the next alarm
+ *
+ * @notapi
+ */
+void st_lld_set_alarm(systime_t time) {
+
+  st_alarm       = time;
+  st_alarm_armed = true;
+}
+
+/**
+ * @brief   Returns the current alarm time.
+ *
+ * @return              The currently set alarm time.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_alarm(void) {
+
+  return st_alarm;
+}
+
+/**
+ * @brief   Determines if the alarm is active.
+ *
+ * @return              The alarm status.
+ * @retval false        if the alarm is not active.
+ * @retval true         is the alarm is active
+ *
+ * @notapi
+ */
+bool st_lld_is_alarm_active(void) {
+
+  return st_alarm_active;
+}
+
+/**
+ * @brief   Serves the simulated alarm interrupt.
+ * @details The alarm triggers once when the counter reaches the alarm
+ *          time, as a compare match would do. An alarm time already in
+ *          the past triggers immediately.
+ *
+ * @return              The interrupt status.
+ * @retval false        if the alarm interrupt has not been served.
+ * @retval true         if the alarm interrupt has been served.
+ *
+ * @notapi
+ */
+bool st_lld_interrupt_pending(void) {
+  systime_t elapsed;
+
+  if (!st_alarm_active || !st_alarm_armed) {
+    return false;
+  }
+
+  /* Time past the alarm, values in the upper half of the range mean that
+     the alarm is still in the future.*/
+  elapsed = (systime_t)(st_lld_get_counter() - st_alarm);
+  if (elapsed > ((systime_t)-1 / (systime_t)2)) {
+    return false;
+  }
+  st_alarm_armed = false;
+
+  port_irq_vector = SIM_ST_IRQ_VECTOR;
+  OSAL_IRQ_PROLOGUE();
+
+  osalSysLockFromISR();
+  osalOsTimerHandlerI();
+  osalSysUnlockFromISR();
+
+  OSAL_IRQ_EPILOGUE();
+
+  return true;
 }
+#endif /* OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING */
 
 #endif /* OSAL_ST_MODE != OSAL_ST_MODE_NONE */
 
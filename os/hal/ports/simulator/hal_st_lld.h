@@ -16,9 +16,12 @@
 
 /**
  * @file    hal_st_lld.h
- * @brief   PLATFORM ST subsystem low level driver header.
+ * @brief   Simulator ST subsystem low level driver header.
  * @details This header is designed to be include-able without having to
  *          include other files from the HAL.
+ * @note    The free running mode counts the host monotonic time at
+ *          @p OSAL_ST_FREQUENCY, the alarm is served by the simulated
+ *          interrupts polling.
  *
  * @addtogroup ST
  * @{
@@ -55,6 +58,13 @@
 extern "C" {
 #endif
   void st_lld_init(void);
+  systime_t st_lld_get_counter(void);
+  void st_lld_start_alarm(systime_t time);
+  void st_lld_stop_alarm(void);
+  void st_lld_set_alarm(systime_t time);
+  systime_t st_lld_get_alarm(void);
+  bool st_lld_is_alarm_active(void);
+  bool st_lld_interrupt_pending(void);
 #ifdef __cplusplus
 }
 #endif
@@ -63,79 +73,6 @@ extern "C" {
 /* Driver inline functions.                                                  */
 /*===========================================================================*/
 
-/**
- * @brief   Returns the time counter value.
- *
- * @return              The counter value.
- *
- * @notapi
- */
-static inline systime_t st_lld_get_counter(void) {
-
-  return (systime_t)0;
-}
-
-/**
- * @brief   Starts the alarm.
- * @note    Makes sure that no spurious alarms are triggered after
- *          this call.
- *
- * @param[in] time      the time to be set for the first alarm
- *
- * @notapi
- */
-static inline void st_lld_start_alarm(systime_t time) {
-
-  (void)time;
-}
-
-/**
- * @brief   Stops the alarm interrupt.
- *
- * @notapi
- */
-static inline void st_lld_stop_alarm(void) {
-
-}
-
-/**
- * @brief   Sets the alarm time.
- *
- * @param[in] time      the time to be set for the next alarm
- *
- * @notapi
- */
-static inline void st_lld_set_alarm(systime_t time) {
-
-  (void)time;
-}
-
-/**
- * @brief   Returns the current alarm time.
- *
- * @return              The currently set alarm time.
- *
- * @notapi
- */
-static inline systime_t st_lld_get_alarm(void) {
-
-  return (systime_t)0;
-}
-
-/**
- * @brief   Determines if the alarm is active.
- *
- * @return              The alarm status.
- * @retval false        if the alarm is not active.
- * @retval true         is the alarm is active
- *
- * @notapi
- */
-static inline bool st_lld_is_alarm_active(void) {
-
-  return false;
-}
-
 #endif /* HAL_ST_LLD_H */
 
 /** @} */
@@ -0,0 +1,495 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_wspi_lld.c
+ * @brief   Simulator WSPI subsystem low level driver source.
+ *
+ * @addtogroup WSPI
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_WSPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define PAGE_SIZE                           256U
+
+/**
+ * @name    Emulated device commands
+ * @note    Commands sent in 16 bits format are identified by their most
+ *          significant byte.
+ * @{
+ */
+#define SIM_CMD_WRITE_STATUS                0x01U
+#define SIM_CMD_PAGE_PROGRAM                0x02U
+#define SIM_CMD_READ                        0x03U
+#define SIM_CMD_WRITE_DISABLE               0x04U
+#define SIM_CMD_READ_STATUS                 0x05U
+#define SIM_CMD_WRITE_ENABLE                0x06U
+#define SIM_CMD_FAST_READ                   0x0BU
+#define SIM_CMD_FAST_READ4B                 0x0CU
+#define SIM_CMD_PAGE_PROGRAM4B              0x12U
+#define SIM_CMD_READ4B                      0x13U
+#define SIM_CMD_SECTOR_ERASE                0x20U
+#define SIM_CMD_SECTOR_ERASE4B              0x21U
+#define SIM_CMD_QUAD_PAGE_PROGRAM           0x32U
+#define SIM_CMD_DUAL_READ                   0x3BU
+#define SIM_CMD_CHIP_ERASE_ALT              0x60U
+#define SIM_CMD_QUAD_READ                   0x6BU
+#define SIM_CMD_READ_FLAG_STATUS            0x70U
+#define SIM_CMD_WRITE_CR2                   0x72U
+#define SIM_CMD_WRITE_V_CONF                0x81U
+#define SIM_CMD_WRITE_EV_CONF               0x61U
+#define SIM_CMD_RESET_MEMORY                0x99U
+#define SIM_CMD_READ_ID                     0x9FU
+#define SIM_CMD_MULTIPLE_IO_READ_ID         0xAFU
+#define SIM_CMD_DUAL_IO_READ                0xBBU
+#define SIM_CMD_CHIP_ERASE                  0xC7U
+#define SIM_CMD_BLOCK_ERASE                 0xD8U
+#define SIM_CMD_BLOCK_ERASE4B               0xDCU
+#define SIM_CMD_QUAD_IO_READ                0xEBU
+#define SIM_CMD_OPI_READ                    0xECU
+#define SIM_CMD_OPI_DTR_READ                0xEEU
+/** @} */
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief WSPID1 driver identifier.*/
+#if (USE_SIM_WSPI1 == TRUE) || defined(__DOXYGEN__)
+WSPIDriver WSPID1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static uint32_t wspi_sim_lines(uint32_t mode) {
+
+  switch (mode) {
+  case 1U:
+    return 1U;
+  case 2U:
+    return 2U;
+  case 3U:
+    return 4U;
+  case 4U:
+    return 8U;
+  default:
+    return 0U;
+  }
+}
+
+static uint64_t wspi_sim_phase(uint32_t mode, bool dtr, uint64_t bits) {
+  uint64_t lines = (uint64_t)wspi_sim_lines(mode);
+  uint64_t cycles;
+
+  if (lines == 0U) {
+    return 0U;
+  }
+
+  cycles = (bits + lines - 1U) / lines;
+  if (dtr) {
+    cycles = (cycles + 1U) / 2U;
+  }
+
+  return cycles;
+}
+
+/**
+ * @brief   Bus time of a transaction.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         size of the data phase
+ * @return              The bus time in nanoseconds.
+ */
+static uint64_t wspi_sim_time(WSPIDriver *wspip,
+                              const wspi_command_t *cmdp,
+                              size_t n) {
+  uint32_t cfg = cmdp->cfg;
+  uint64_t cycles;
+
+  cycles  = wspi_sim_phase((cfg & WSPI_CFG_CMD_MODE_MASK) >> 0U,
+                           (cfg & WSPI_CFG_CMD_DTR) != 0U,
+                           (uint64_t)(((cfg & WSPI_CFG_CMD_SIZE_MASK) >> 4U) +
+                                      1U) * 8U);
+  cycles += wspi_sim_phase((cfg & WSPI_CFG_ADDR_MODE_MASK) >> 8U,
+                           (cfg & WSPI_CFG_ADDR_DTR) != 0U,
+                           (uint64_t)(((cfg & WSPI_CFG_ADDR_SIZE_MASK) >> 12U) +
+                                      1U) * 8U);
+  cycles += wspi_sim_phase((cfg & WSPI_CFG_ALT_MODE_MASK) >> 16U,
+                           (cfg & WSPI_CFG_ALT_DTR) != 0U,
+                           (uint64_t)(((cfg & WSPI_CFG_ALT_SIZE_MASK) >> 20U) +
+                                      1U) * 8U);
+  cycles += (uint64_t)cmdp->dummy;
+  cycles += wspi_sim_phase((cfg & WSPI_CFG_DATA_MODE_MASK) >> 24U,
+                           (cfg & WSPI_CFG_DATA_DTR) != 0U,
+                           (uint64_t)n * 8U);
+
+  return (cycles * (uint64_t)wspip->config->timings->clk_period) / 1000U;
+}
+
+/**
+ * @brief   Decodes the command code.
+ *
+ * @param[in] cmdp      pointer to the command descriptor
+ * @return              The command code.
+ */
+static uint32_t wspi_sim_decode(const wspi_command_t *cmdp) {
+
+  /* No command phase, it is a continuous read in XIP mode.*/
+  if ((cmdp->cfg & WSPI_CFG_CMD_MODE_MASK) == WSPI_CFG_CMD_MODE_NONE) {
+    return SIM_CMD_FAST_READ;
+  }
+
+  /* Octal commands are sent as the command code followed by its
+     complement.*/
+  if ((cmdp->cfg & WSPI_CFG_CMD_SIZE_MASK) == WSPI_CFG_CMD_SIZE_16) {
+    return (cmdp->cmd >> 8U) & 0xFFU;
+  }
+
+  return cmdp->cmd & 0xFFU;
+}
+
+/**
+ * @brief   Erases an aligned area of the emulated device.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] addr      address within the area
+ * @param[in] size      size of the area
+ * @param[in] us        erase time in microseconds
+ */
+static void wspi_sim_erase(WSPIDriver *wspip, uint32_t addr,
+                           size_t size, uint32_t us) {
+  const WSPIConfig *config = wspip->config;
+
+  if (wspip->wel) {
+    if (size > config->size) {
+      size = config->size;
+    }
+    addr &= (uint32_t)(config->size - 1U) & ~(uint32_t)(size - 1U);
+    memset(&config->array[addr], 0xFF, size);
+    wspip->stats.busy_time += (uint64_t)us * 1000U;
+    wspip->wel = false;
+  }
+}
+
+/**
+ * @brief   Executes a transaction on the emulated device.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         size of the data phase
+ * @param[in] txbuf     data to be sent or @p NULL
+ * @param[out] rxbuf    buffer for received data or @p NULL
+ */
+static void wspi_sim_execute(WSPIDriver *wspip,
+                             const wspi_command_t *cmdp,
+                             size_t n,
+                             const uint8_t *txbuf,
+                             uint8_t *rxbuf) {
+  const WSPIConfig *config = wspip->config;
+  const wspi_sim_timings_t *timings = config->timings;
+  uint32_t mask = (uint32_t)(config->size - 1U);
+  uint32_t addr = cmdp->addr & mask;
+  size_t i;
+
+  wspip->stats.commands++;
+  wspip->stats.bus_time += (uint64_t)timings->xfer_overhead +
+                           wspi_sim_time(wspip, cmdp, n);
+  if (rxbuf != NULL) {
+    wspip->stats.rx_bytes += (uint64_t)n;
+    memset(rxbuf, 0, n);
+  }
+  if (txbuf != NULL) {
+    wspip->stats.tx_bytes += (uint64_t)n;
+  }
+
+  switch (wspi_sim_decode(cmdp)) {
+  case SIM_CMD_READ:
+  case SIM_CMD_FAST_READ:
+  case SIM_CMD_FAST_READ4B:
+  case SIM_CMD_READ4B:
+  case SIM_CMD_DUAL_READ:
+  case SIM_CMD_QUAD_READ:
+  case SIM_CMD_DUAL_IO_READ:
+  case SIM_CMD_QUAD_IO_READ:
+  case SIM_CMD_OPI_READ:
+  case SIM_CMD_OPI_DTR_READ:
+    if (rxbuf != NULL) {
+      for (i = 0U; i < n; i++) {
+        rxbuf[i] = config->array[(addr + (uint32_t)i) & mask];
+      }
+    }
+    break;
+  case SIM_CMD_READ_ID:
+  case SIM_CMD_MULTIPLE_IO_READ_ID:
+    if (rxbuf != NULL) {
+      /* In DTR mode each byte is repeated on both clock edges.*/
+      size_t rep = (cmdp->cfg & WSPI_CFG_DATA_DTR) != 0U ? 2U : 1U;
+
+      for (i = 0U; (i < n) && (i < 3U * rep); i++) {
+        rxbuf[i] = config->id[i / rep];
+      }
+    }
+    break;
+  case SIM_CMD_READ_STATUS:
+    /* Operations complete instantly, WIP is never set.*/
+    if (rxbuf != NULL) {
+      rxbuf[0] = wspip->wel ? 0x02U : 0x00U;
+    }
+    break;
+  case SIM_CMD_READ_FLAG_STATUS:
+    /* Program/erase controller always ready, no errors.*/
+    if (rxbuf != NULL) {
+      rxbuf[0] = 0x80U;
+    }
+    break;
+  case SIM_CMD_WRITE_ENABLE:
+    wspip->wel = true;
+    break;
+  case SIM_CMD_PAGE_PROGRAM:
+  case SIM_CMD_PAGE_PROGRAM4B:
+  case SIM_CMD_QUAD_PAGE_PROGRAM:
+    if (wspip->wel && (txbuf != NULL)) {
+      uint32_t page = addr & ~(PAGE_SIZE - 1U);
+
+      /* Bits can only be cleared, data wraps within the page.*/
+      for (i = 0U; i < n; i++) {
+        config->array[page + ((addr + (uint32_t)i) & (PAGE_SIZE - 1U))] &=
+            txbuf[i];
+      }
+      wspip->stats.busy_time += (uint64_t)timings->page_program * 1000U;
+      wspip->wel = false;
+    }
+    break;
+  case SIM_CMD_SECTOR_ERASE:
+  case SIM_CMD_SECTOR_ERASE4B:
+    wspi_sim_erase(wspip, addr, 0x1000U, timings->sector_erase);
+    break;
+  case SIM_CMD_BLOCK_ERASE:
+  case SIM_CMD_BLOCK_ERASE4B:
+    wspi_sim_erase(wspip, addr, 0x10000U, timings->block_erase);
+    break;
+  case SIM_CMD_CHIP_ERASE:
+  case SIM_CMD_CHIP_ERASE_ALT:
+    wspi_sim_erase(wspip, 0U, config->size,
+                   (uint32_t)(config->size / 0x10000U) *
+                   timings->block_erase);
+    break;
+  case SIM_CMD_WRITE_DISABLE:
+  case SIM_CMD_WRITE_STATUS:
+  case SIM_CMD_WRITE_CR2:
+  case SIM_CMD_WRITE_V_CONF:
+  case SIM_CMD_WRITE_EV_CONF:
+  case SIM_CMD_RESET_MEMORY:
+    /* Configuration is not emulated, the latch is cleared.*/
+    wspip->wel = false;
+    break;
+  default:
+    /* Other registers read as zero.*/
+    break;
+  }
+
+  /* The completion interrupt is served on the next interrupts check.*/
+  wspip->pending = true;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level WSPI driver initialization.
+ *
+ * @notapi
+ */
+void wspi_lld_init(void) {
+
+#if USE_SIM_WSPI1 == TRUE
+  wspiObjectInit(&WSPID1);
+  WSPID1.pending = false;
+  WSPID1.wel     = false;
+  memset(&WSPID1.stats, 0, sizeof (wspi_sim_stats_t));
+#endif
+}
+
+/**
+ * @brief   Configures and activates the WSPI peripheral.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ *
+ * @notapi
+ */
+void wspi_lld_start(WSPIDriver *wspip) {
+
+  osalDbgCheck((wspip->config->array != NULL) &&
+               (wspip->config->id != NULL) &&
+               (wspip->config->timings != NULL));
+  osalDbgAssert((wspip->config->size & (wspip->config->size - 1U)) == 0U,
+                "size not a power of two");
+
+  /* If in stopped state then full initialization.*/
+  if (wspip->state == WSPI_STOP) {
+    wspip->pending = false;
+    wspip->wel     = false;
+  }
+}
+
+/**
+ * @brief   Deactivates the WSPI peripheral.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ *
+ * @notapi
+ */
+void wspi_lld_stop(WSPIDriver *wspip) {
+
+  wspip->pending = false;
+}
+
+/**
+ * @brief   Sends a command without data phase.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ *
+ * @notapi
+ */
+void wspi_lld_command(WSPIDriver *wspip, const wspi_command_t *cmdp) {
+
+  wspi_sim_execute(wspip, cmdp, 0U, NULL, NULL);
+}
+
+/**
+ * @brief   Sends a command with data over the WSPI bus.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ *
+ * @notapi
+ */
+void wspi_lld_send(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                   size_t n, const uint8_t *txbuf) {
+
+  wspi_sim_execute(wspip, cmdp, n, txbuf, NULL);
+}
+
+/**
+ * @brief   Sends a command then receives data over the WSPI bus.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes to send
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                      size_t n, uint8_t *rxbuf) {
+
+  wspi_sim_execute(wspip, cmdp, n, NULL, rxbuf);
+}
+
+#if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Maps in memory space a WSPI flash device.
+ * @pre     The memory flash device must be initialized appropriately
+ *          before mapping it in memory space.
+ * @note    The emulated device array is returned as memory window, the
+ *          command header of the first access is accounted here.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[out] addrp    pointer to the memory start address of the mapped
+ *                      flash or @p NULL
+ *
+ * @notapi
+ */
+void wspi_lld_map_flash(WSPIDriver *wspip,
+                        const wspi_command_t *cmdp,
+                        uint8_t **addrp) {
+
+  wspip->stats.maps++;
+  wspip->stats.bus_time += (uint64_t)wspip->config->timings->map_overhead +
+                           wspi_sim_time(wspip, cmdp, 0U);
+
+  if (addrp != NULL) {
+    *addrp = wspip->config->array;
+  }
+}
+
+/**
+ * @brief   Unmaps from memory space a WSPI flash device.
+ * @post    The memory flash device must be re-initialized for normal
+ *          commands exchange.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ *
+ * @notapi
+ */
+void wspi_lld_unmap_flash(WSPIDriver *wspip) {
+
+  (void)wspip;
+}
+#endif /* WSPI_SUPPORTS_MEMMAP == TRUE */
+
+/**
+ * @brief   Serves the pending completion interrupts.
+ *
+ * @return              @p true if an interrupt has been served.
+ *
+ * @notapi
+ */
+bool wspi_lld_interrupt_pending(void) {
+  bool int_occurred = false;
+
+#if USE_SIM_WSPI1 == TRUE
+  if (WSPID1.pending) {
+    WSPID1.pending = false;
+    _wspi_isr_code(&WSPID1);
+    int_occurred = true;
+  }
+#endif
+
+  return int_occurred;
+}
+
+#endif /* HAL_USE_WSPI */
+
+/** @} */
@@ -0,0 +1,201 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_wspi_lld.h
+ * @brief   Simulator WSPI subsystem low level driver header.
+ * @details The driver emulates a serial NOR flash device attached to the
+ *          bus, the device understands the JEDEC commands used by the
+ *          Micron N25Q and Macronix MX25 drivers. Transfers are not timed
+ *          in real time, the cost of each transaction is accumulated into
+ *          statistic counters according to a configurable timing model.
+ *
+ * @addtogroup WSPI
+ * @{
+ */
+
+#ifndef HAL_WSPI_LLD_H
+#define HAL_WSPI_LLD_H
+
+#if (HAL_USE_WSPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    WSPI implementation capabilities
+ * @{
+ */
+#define WSPI_SUPPORTS_MEMMAP                TRUE
+#define WSPI_DEFAULT_CFG_MASKS              TRUE
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   WSPID1 driver enable switch.
+ * @details If set to @p TRUE the support for WSPID1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_WSPI1) || defined(__DOXYGEN__)
+#define USE_SIM_WSPI1                       TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Timing model of the emulated bus and device.
+ */
+typedef struct {
+  /**
+   * @brief   Bus clock period in picoseconds.
+   */
+  uint32_t                  clk_period;
+  /**
+   * @brief   Fixed cost of a transaction in nanoseconds.
+   * @details This is the time spent setting up the peripheral and the DMA,
+   *          serving the completion interrupt and waking up the thread.
+   */
+  uint32_t                  xfer_overhead;
+  /**
+   * @brief   Fixed cost of a memory mapping in nanoseconds.
+   * @details This is the time spent entering and leaving the memory mapped
+   *          mode, the command header is accounted separately.
+   */
+  uint32_t                  map_overhead;
+  /**
+   * @brief   Page program time in microseconds.
+   */
+  uint32_t                  page_program;
+  /**
+   * @brief   4kB sector erase time in microseconds.
+   */
+  uint32_t                  sector_erase;
+  /**
+   * @brief   64kB block erase time in microseconds.
+   */
+  uint32_t                  block_erase;
+} wspi_sim_timings_t;
+
+/**
+ * @brief   Statistic counters of the emulated device.
+ */
+typedef struct {
+  /**
+   * @brief   Number of transactions.
+   */
+  uint32_t                  commands;
+  /**
+   * @brief   Number of memory mappings.
+   */
+  uint32_t                  maps;
+  /**
+   * @brief   Bytes received by the host.
+   */
+  uint64_t                  rx_bytes;
+  /**
+   * @brief   Bytes sent by the host.
+   */
+  uint64_t                  tx_bytes;
+  /**
+   * @brief   Accumulated bus time in nanoseconds.
+   * @note    Accesses performed through a memory mapped window are not
+   *          visible to the emulator, only the mapping is accounted.
+   */
+  uint64_t                  bus_time;
+  /**
+   * @brief   Accumulated program and erase time in nanoseconds.
+   */
+  uint64_t                  busy_time;
+} wspi_sim_stats_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the WSPI driver structure.
+ */
+#define wspi_lld_driver_fields                                              \
+  /* Operation completed, the interrupt is pending.*/                       \
+  bool                      pending;                                        \
+  /* Write enable latch of the emulated device.*/                           \
+  bool                      wel;                                            \
+  /* Statistic counters.*/                                                  \
+  wspi_sim_stats_t          stats
+
+/**
+ * @brief   Low level fields of the WSPI configuration structure.
+ */
+#define wspi_lld_config_fields                                              \
+  /* Emulated device array, it is not initialized by the driver.*/          \
+  uint8_t                   *array;                                         \
+  /* Size of the emulated device array, it must be a power of two.*/        \
+  size_t                    size;                                           \
+  /* Three identification bytes returned by the read ID commands.*/         \
+  const uint8_t             *id;                                            \
+  /* Timing model.*/                                                        \
+  const wspi_sim_timings_t  *timings
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (USE_SIM_WSPI1 == TRUE) && !defined(__DOXYGEN__)
+extern WSPIDriver WSPID1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void wspi_lld_init(void);
+  void wspi_lld_start(WSPIDriver *wspip);
+  void wspi_lld_stop(WSPIDriver *wspip);
+  void wspi_lld_command(WSPIDriver *wspip, const wspi_command_t *cmdp);
+  void wspi_lld_send(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                     size_t n, const uint8_t *txbuf);
+  void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                        size_t n, uint8_t *rxbuf);
+#if WSPI_SUPPORTS_MEMMAP == TRUE
+  void wspi_lld_map_flash(WSPIDriver *wspip,
+                          const wspi_command_t *cmdp,
+                          uint8_t **addrp);
+  void wspi_lld_unmap_flash(WSPIDriver *wspip);
+#endif
+  bool wspi_lld_interrupt_pending(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_WSPI */
+
+#endif /* HAL_WSPI_LLD_H */
+
+/** @} */
@@ -78,11 +78,36 @@ void _sim_check_for_interrupts(void) {
   }
 #endif
 
+#if HAL_USE_UART
+  if (uart_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_WSPI
+  if (wspi_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if SIM_USE_AMP
+  if (sim_amp_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  (void)tv;
+  if (st_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#else
   gettimeofday(&tv, NULL);
   if (timercmp(&tv, &nextcnt, >=)) {
     int_occurred = true;
     timeradd(&nextcnt, &tick, &nextcnt);
 
+    port_irq_vector = SIM_ST_IRQ_VECTOR;
     CH_IRQ_PROLOGUE();
 
     chSysLockFromISR();
@@ -91,6 +116,7 @@ void _sim_check_for_interrupts(void) {
 
     CH_IRQ_EPILOGUE();
   }
+#endif
 
   if (int_occurred) {
     _dbg_check_lock();
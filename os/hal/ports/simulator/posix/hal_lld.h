@@ -49,10 +49,32 @@
 #define PLATFORM_NAME   "Posix Simulator"
 #endif
 
+/**
+ * @name    Simulated interrupt vectors
+ * @{
+ */
+#define SIM_ST_IRQ_VECTOR       0U
+#define SIM_SD1_IRQ_VECTOR      1U
+#define SIM_SD2_IRQ_VECTOR      2U
+#define SIM_UART1_IRQ_VECTOR    3U
+#define SIM_UART2_IRQ_VECTOR    4U
+#define SIM_AMP_IRQ_VECTOR      5U
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Enables the AMP support.
+ * @details If enabled the simulator can be split in two instances sharing
+ *          a memory region and able to interrupt each other.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(SIM_USE_AMP) || defined(__DOXYGEN__)
+#define SIM_USE_AMP             FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -65,6 +87,8 @@
 /* External declarations.                                                    */
 /*===========================================================================*/
 
+#include "sim_amp.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -0,0 +1,197 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_rtc_lld.c
+ * @brief   Posix simulator low level RTC driver code.
+ *
+ * @addtogroup POSIX_RTC
+ * @{
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "hal.h"
+
+#if (HAL_USE_RTC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   RTC driver identifier.
+ */
+RTCDriver RTCD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Host monotonic time in nanoseconds.
+ */
+static uint64_t sim_time(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief   Calendar value in milliseconds since 1970.
+ *
+ * @param[in] rtcp      pointer to RTC driver structure
+ * @param[in] now       host monotonic time in nanoseconds
+ */
+static int64_t rtc_calendar(RTCDriver *rtcp, uint64_t now) {
+  int64_t elapsed = (int64_t)(now - rtcp->base_ns);
+
+  /* Elapsed nanoseconds scaled by the oscillator error.*/
+  elapsed += (elapsed / 1000000) * rtcp->drift;
+
+  return rtcp->base_ms + (elapsed / 1000000);
+}
+
+/**
+ * @brief   Moves the base of the calendar to the current time.
+ *
+ * @param[in] rtcp      pointer to RTC driver structure
+ * @param[in] now       host monotonic time in nanoseconds
+ * @param[in] ms        calendar value in milliseconds since 1970
+ */
+static void rtc_rebase(RTCDriver *rtcp, uint64_t now, int64_t ms) {
+
+  rtcp->base_ns = now;
+  rtcp->base_ms = ms;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Enable access to registers.
+ * @details The calendar starts from the host UTC time.
+ *
+ * @notapi
+ */
+void rtc_lld_init(void) {
+  struct timespec ts;
+
+  rtcObjectInit(&RTCD1);
+
+  RTCD1.drift      = SIM_RTC_DRIFT_PPM;
+  RTCD1.resolution = SIM_RTC_RESOLUTION;
+  RTCD1.latency    = SIM_RTC_READ_LATENCY;
+  RTCD1.dstflag    = 0U;
+  RTCD1.reads      = 0U;
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+  rtc_rebase(&RTCD1, sim_time(),
+             ((int64_t)ts.tv_sec * 1000) + (ts.tv_nsec / 1000000));
+}
+
+/**
+ * @brief   Set current time.
+ *
+ * @param[in] rtcp      pointer to RTC driver structure
+ * @param[in] timespec  pointer to a @p RTCDateTime structure
+ *
+ * @notapi
+ */
+void rtc_lld_set_time(RTCDriver *rtcp, const RTCDateTime *timespec) {
+  struct tm tm;
+
+  memset(&tm, 0, sizeof (tm));
+  tm.tm_year = (int)timespec->year + (int)(RTC_BASE_YEAR - 1900U);
+  tm.tm_mon  = (int)timespec->month - 1;
+  tm.tm_mday = (int)timespec->day;
+
+  rtcp->dstflag = timespec->dstflag;
+  rtc_rebase(rtcp, sim_time(), ((int64_t)timegm(&tm) * 1000) +
+                                (int64_t)timespec->millisecond);
+}
+
+/**
+ * @brief   Get current time.
+ *
+ * @param[in] rtcp      pointer to RTC driver structure
+ * @param[out] timespec pointer to a @p RTCDateTime structure
+ *
+ * @notapi
+ */
+void rtc_lld_get_time(RTCDriver *rtcp, RTCDateTime *timespec) {
+  uint64_t now = sim_time();
+  int64_t ms;
+  time_t secs;
+  struct tm tm;
+
+  /* Emulated access time.*/
+  while (sim_time() - now < (uint64_t)rtcp->latency * 1000U) {
+  }
+  rtcp->reads++;
+
+  ms = rtc_calendar(rtcp, now);
+  ms -= ms % (int64_t)rtcp->resolution;
+  secs = (time_t)(ms / 1000);
+  gmtime_r(&secs, &tm);
+
+  timespec->year        = (uint32_t)tm.tm_year - (RTC_BASE_YEAR - 1900U);
+  timespec->month       = (uint32_t)tm.tm_mon + 1U;
+  timespec->day         = (uint32_t)tm.tm_mday;
+  timespec->dayofweek   = tm.tm_wday == 0 ? RTC_DAY_SUNDAY :
+                                            (uint32_t)tm.tm_wday;
+  timespec->dstflag     = rtcp->dstflag;
+  timespec->millisecond = (uint32_t)((tm.tm_hour * 3600) +
+                                     (tm.tm_min * 60) +
+                                      tm.tm_sec) * 1000U +
+                          (uint32_t)(ms % 1000);
+}
+
+/**
+ * @brief   Changes the oscillator error.
+ * @details The calendar continues from its current value.
+ *
+ * @param[in] rtcp      pointer to RTC driver structure
+ * @param[in] drift     oscillator error in parts per million
+ *
+ * @notapi
+ */
+void rtc_lld_set_drift(RTCDriver *rtcp, int32_t drift) {
+  uint64_t now = sim_time();
+
+  rtc_rebase(rtcp, now, rtc_calendar(rtcp, now));
+  rtcp->drift = drift;
+}
+
+#endif /* HAL_USE_RTC == TRUE */
+
+/** @} */
@@ -0,0 +1,142 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_rtc_lld.h
+ * @brief   Posix simulator low level RTC driver header.
+ * @details The calendar runs on the host monotonic clock, it starts from
+ *          the host UTC time. The oscillator error, the calendar resolution
+ *          and the cost of a read access are configurable in order to
+ *          emulate real devices.
+ *
+ * @addtogroup POSIX_RTC
+ * @{
+ */
+
+#ifndef HAL_RTC_LLD_H
+#define HAL_RTC_LLD_H
+
+#if (HAL_USE_RTC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Implementation capabilities
+ */
+/**
+ * @brief   Callback support int the driver.
+ */
+#define RTC_SUPPORTS_CALLBACKS      FALSE
+
+/**
+ * @brief   Number of alarms available.
+ */
+#define RTC_ALARMS                  0
+
+/**
+ * @brief   Presence of a local persistent storage.
+ */
+#define RTC_HAS_STORAGE             FALSE
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Initial oscillator error in parts per million.
+ * @note    It can be changed at runtime using @p rtc_lld_set_drift().
+ */
+#if !defined(SIM_RTC_DRIFT_PPM) || defined(__DOXYGEN__)
+#define SIM_RTC_DRIFT_PPM           0
+#endif
+
+/**
+ * @brief   Initial calendar resolution in milliseconds.
+ * @note    It can be changed at runtime writing the @p resolution field.
+ */
+#if !defined(SIM_RTC_RESOLUTION) || defined(__DOXYGEN__)
+#define SIM_RTC_RESOLUTION          1
+#endif
+
+/**
+ * @brief   Initial read access time in microseconds.
+ * @details Time spent busy waiting on each read, it emulates the shadow
+ *          registers synchronization or the bus access of real devices.
+ * @note    It can be changed at runtime writing the @p latency field.
+ */
+#if !defined(SIM_RTC_READ_LATENCY) || defined(__DOXYGEN__)
+#define SIM_RTC_READ_LATENCY        0
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Implementation-specific @p RTCDriver fields.
+ */
+#define rtc_lld_driver_fields                                               \
+  /* Calendar value at the base time, milliseconds since 1970.*/            \
+  int64_t                   base_ms;                                        \
+  /* Host monotonic time of the base, nanoseconds.*/                        \
+  uint64_t                  base_ns;                                        \
+  /* Oscillator error in parts per million.*/                               \
+  int32_t                   drift;                                          \
+  /* Calendar resolution in milliseconds.*/                                 \
+  uint32_t                  resolution;                                     \
+  /* Read access time in microseconds.*/                                    \
+  uint32_t                  latency;                                        \
+  /* DST flag of the calendar.*/                                            \
+  uint32_t                  dstflag;                                        \
+  /* Number of read accesses.*/                                             \
+  uint32_t                  reads
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void rtc_lld_init(void);
+  void rtc_lld_set_time(RTCDriver *rtcp, const RTCDateTime *timespec);
+  void rtc_lld_get_time(RTCDriver *rtcp, RTCDateTime *timespec);
+  void rtc_lld_set_drift(RTCDriver *rtcp, int32_t drift);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_RTC == TRUE */
+
+#endif /* HAL_RTC_LLD_H */
+
+/** @} */
@@ -17,14 +17,32 @@
 /**
  * @file    simulator/posix/hal_serial_lld.c
  * @brief   Posix simulator low level serial driver code.
+ * @details Each serial port is connected to one of the following backends:
+ *          - A TCP listen socket, one connection at time.
+ *          - A UNIX domain socket, one connection at time.
+ *          - A pseudo-terminal, the port is always connected.
+ *          - The simulator standard input and output.
+ *          .
+ *          Data is moved in blocks directly between the descriptors and the
+ *          driver queues, optionally at the simulated bit rate.
  *
  * @addtogroup POSIX_SERIAL
  * @{
  */
 
+/* Pseudo-terminal functions are X/Open extensions.*/
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
+#include <termios.h>
+#include <poll.h>
+#include <sys/un.h>
+#include <netinet/tcp.h>
 
 #include "hal.h"
 
@@ -50,86 +68,333 @@ SerialDriver SD2;
 
 /** @brief Driver default configuration.*/
 static const SerialConfig default_config = {
+  0U
 };
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
-static void init(SerialDriver *sdp, uint16_t port) {
-  struct sockaddr_in sad;
-  struct protoent *prtp;
+/**
+ * @brief   Returns the host monotonic time in nanoseconds.
+ */
+static uint64_t sd_now(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief   Sets a descriptor in non blocking mode.
+ */
+static bool sd_set_nonblocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+
+  return (flags == -1) || (fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0);
+}
+
+/**
+ * @brief   Connection oriented backend initialization.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] port      TCP port, used by the TCP backend
+ * @param[in] path      socket path, used by the UNIX domain socket backend
+ */
+static void init_socket(SerialDriver *sdp, uint16_t port, const char *path) {
   int sockval = 1;
   socklen_t socklen = sizeof(sockval);
 
-  if ((prtp = getprotobyname("tcp")) == NULL) {
-    printf("%s: Error mapping protocol name to protocol number\n", sdp->com_name);
+  if (sdp->com_backend == SIM_SD_BACKEND_TCP) {
+    struct sockaddr_in sad;
+    struct protoent *prtp;
+
+    if ((prtp = getprotobyname("tcp")) == NULL) {
+      fprintf(stderr, "%s: Error mapping protocol name to protocol number\n",
+              sdp->com_name);
+      goto abort;
+    }
+
+    sdp->com_listen = socket(PF_INET, SOCK_STREAM, prtp->p_proto);
+    if (sdp->com_listen == -1) {
+      fprintf(stderr, "%s: Error creating simulator socket\n", sdp->com_name);
+      goto abort;
+    }
+
+    setsockopt(sdp->com_listen, SOL_SOCKET, SO_REUSEADDR, &sockval, socklen);
+
+    memset(&sad, 0, sizeof(sad));
+    sad.sin_family = AF_INET;
+    sad.sin_addr.s_addr = INADDR_ANY;
+    sad.sin_port = htons(port);
+    if (bind(sdp->com_listen, (struct sockaddr *)&sad, sizeof(sad))) {
+      fprintf(stderr, "%s: Error binding socket\n", sdp->com_name);
+      goto abort;
+    }
+  }
+  else {
+    struct sockaddr_un sad;
+
+    if (strlen(path) >= sizeof(sad.sun_path)) {
+      fprintf(stderr, "%s: Socket path too long\n", sdp->com_name);
+      goto abort;
+    }
+
+    sdp->com_listen = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sdp->com_listen == -1) {
+      fprintf(stderr, "%s: Error creating simulator socket\n", sdp->com_name);
+      goto abort;
+    }
+
+    /* A stale socket from a previous run would make bind() fail.*/
+    unlink(path);
+
+    memset(&sad, 0, sizeof(sad));
+    sad.sun_family = AF_UNIX;
+    strcpy(sad.sun_path, path);
+    if (bind(sdp->com_listen, (struct sockaddr *)&sad, sizeof(sad))) {
+      fprintf(stderr, "%s: Error binding socket\n", sdp->com_name);
+      goto abort;
+    }
+  }
+
+  if (sd_set_nonblocking(sdp->com_listen)) {
+    fprintf(stderr, "%s: Unable to setup non blocking mode on socket\n",
+            sdp->com_name);
     goto abort;
   }
 
-  sdp->com_listen = socket(PF_INET, SOCK_STREAM, prtp->p_proto);
-  if (sdp->com_listen == -1) {
-    printf("%s: Error creating simulator socket\n", sdp->com_name);
+  if (listen(sdp->com_listen, 1) != 0) {
+    fprintf(stderr, "%s: Error listening socket\n", sdp->com_name);
     goto abort;
   }
 
-  setsockopt(sdp->com_listen, SOL_SOCKET, SO_REUSEADDR, &sockval, socklen);
+  if (sdp->com_backend == SIM_SD_BACKEND_TCP) {
+    fprintf(stderr, "Full Duplex Channel %s listening on port %d\n",
+            sdp->com_name, port);
+  }
+  else {
+    fprintf(stderr, "Full Duplex Channel %s listening on %s\n",
+            sdp->com_name, path);
+  }
+  return;
+
+abort:
+  if (sdp->com_listen != -1)
+    close(sdp->com_listen);
+  exit(1);
+}
 
-#if 0
-  if (ioctl(sdp->com_listen, FIONBIO, &nb) != 0) {
-    printf("%s: Unable to setup non blocking mode on socket\n", sdp->com_name);
+/**
+ * @brief   Pseudo-terminal backend initialization.
+ * @note    The slave side is kept open by the simulator, this way the
+ *          terminal stays in raw mode and clients can come and go without
+ *          the master side reporting errors.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] path      name of a symbolic link to the slave device or
+ *                      @p NULL
+ */
+static void init_pty(SerialDriver *sdp, const char *path) {
+  struct termios tio;
+  const char *name;
+
+  sdp->com_out = posix_openpt(O_RDWR | O_NOCTTY);
+  if ((sdp->com_out == -1) || (grantpt(sdp->com_out) != 0) ||
+      (unlockpt(sdp->com_out) != 0) ||
+      ((name = ptsname(sdp->com_out)) == NULL)) {
+    fprintf(stderr, "%s: Error creating pseudo-terminal\n", sdp->com_name);
     goto abort;
   }
-#endif
-  int flags = fcntl(sdp->com_listen, F_GETFL, 0);
-  if (fcntl(sdp->com_listen, F_SETFL, flags | O_NONBLOCK) != 0) {
-    printf("%s: Unable to setup non blocking mode on socket\n", sdp->com_name);
+
+  sdp->com_listen = open(name, O_RDWR | O_NOCTTY);
+  if ((sdp->com_listen == -1) || (tcgetattr(sdp->com_listen, &tio) != 0)) {
+    fprintf(stderr, "%s: Error opening %s\n", sdp->com_name, name);
     goto abort;
   }
-
-  memset(&sad, 0, sizeof(sad));
-  sad.sin_family = AF_INET;
-  sad.sin_addr.s_addr = INADDR_ANY;
-  sad.sin_port = htons(port);
-  if (bind(sdp->com_listen, (struct sockaddr *)&sad, sizeof(sad))) {
-    printf("%s: Error binding socket\n", sdp->com_name);
+  cfmakeraw(&tio);
+  if (tcsetattr(sdp->com_listen, TCSANOW, &tio) != 0) {
+    fprintf(stderr, "%s: Unable to setup raw mode on %s\n",
+            sdp->com_name, name);
     goto abort;
   }
 
-  if (listen(sdp->com_listen, 1) != 0) {
-    printf("%s: Error listening socket\n", sdp->com_name);
+  if (sd_set_nonblocking(sdp->com_out)) {
+    fprintf(stderr, "%s: Unable to setup non blocking mode on %s\n",
+            sdp->com_name, name);
     goto abort;
   }
-  printf("Full Duplex Channel %s listening on port %d\n", sdp->com_name, port);
+
+  if (path != NULL) {
+    unlink(path);
+    if (symlink(name, path) != 0) {
+      fprintf(stderr, "%s: Error linking %s to %s\n",
+              sdp->com_name, path, name);
+      goto abort;
+    }
+    fprintf(stderr, "Full Duplex Channel %s on %s (%s)\n",
+            sdp->com_name, name, path);
+  }
+  else {
+    fprintf(stderr, "Full Duplex Channel %s on %s\n", sdp->com_name, name);
+  }
   return;
 
 abort:
   if (sdp->com_listen != -1)
     close(sdp->com_listen);
+  if (sdp->com_out != -1)
+    close(sdp->com_out);
   exit(1);
 }
 
-static bool connint(SerialDriver *sdp) {
+/**
+ * @brief   Standard input/output backend initialization.
+ * @note    The standard input is held in @p com_listen until the connection
+ *          is notified.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void init_stdio(SerialDriver *sdp) {
 
-  if (sdp->com_data == -1) {
-    struct sockaddr addr;
-    socklen_t addrlen = sizeof(addr);
+  if (sd_set_nonblocking(STDIN_FILENO) || sd_set_nonblocking(STDOUT_FILENO)) {
+    fprintf(stderr, "%s: Unable to setup non blocking mode on stdio\n",
+            sdp->com_name);
+    exit(1);
+  }
+  sdp->com_listen = STDIN_FILENO;
+  sdp->com_out    = STDOUT_FILENO;
+  fprintf(stderr, "Full Duplex Channel %s on stdin/stdout\n", sdp->com_name);
+}
 
-    if ((sdp->com_data = accept(sdp->com_listen, &addr, &addrlen)) == -1)
-      return false;
+/**
+ * @brief   Backend initialization.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] port      TCP port, used by the TCP backend
+ * @param[in] path      path, used by the UNIX domain socket and
+ *                      pseudo-terminal backends
+ */
+static void init(SerialDriver *sdp, uint16_t port, const char *path) {
+
+  switch (sdp->com_backend) {
+  case SIM_SD_BACKEND_PTY:
+    init_pty(sdp, path);
+    break;
+  case SIM_SD_BACKEND_STDIO:
+    init_stdio(sdp);
+    break;
+  default:
+    init_socket(sdp, port, path);
+    break;
+  }
+}
 
-#if 0
-    if (ioctl(sdp->com_data, FIONBIO, &nb) != 0) {
-      printf("%s: Unable to setup non blocking mode on data socket\n", sdp->com_name);
-      goto abort;
-    }
-#endif
-    int flags = fcntl(sdp->com_data, F_GETFL, 0);
-    if (fcntl(sdp->com_data, F_SETFL, flags | O_NONBLOCK) != 0) {
-      printf("%s: Unable to setup non blocking mode on data socket\n", sdp->com_name);
-      goto abort;
+/**
+ * @brief   Releases the backend resources.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] path      path, used by the UNIX domain socket and
+ *                      pseudo-terminal backends
+ */
+static void deinit(SerialDriver *sdp, const char *path) {
+
+  if (sdp->com_backend != SIM_SD_BACKEND_STDIO) {
+    if (sdp->com_out != -1)
+      close(sdp->com_out);
+    if (sdp->com_listen != -1)
+      close(sdp->com_listen);
+    if ((sdp->com_backend != SIM_SD_BACKEND_TCP) && (path != NULL))
+      unlink(path);
+  }
+  sdp->com_listen = -1;
+  sdp->com_data   = -1;
+  sdp->com_out    = -1;
+}
+
+/**
+ * @brief   Closes the current connection.
+ * @note    The pseudo-terminal and standard output remain available for
+ *          output, the standard input is never reconnected.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void disconnect(SerialDriver *sdp) {
+
+  if ((sdp->com_backend == SIM_SD_BACKEND_TCP) ||
+      (sdp->com_backend == SIM_SD_BACKEND_UNIX)) {
+    close(sdp->com_data);
+    sdp->com_out = -1;
+  }
+  sdp->com_data = -1;
+
+  osalSysLockFromISR();
+  chnAddFlagsI(sdp, CHN_DISCONNECTED);
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Limits a transfer to the simulated bit rate.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in,out] nextp time the line can transfer the next character
+ * @param[in] n         number of characters ready for transfer
+ * @return              The number of characters that can be transferred.
+ */
+static size_t pace(SerialDriver *sdp, uint64_t *nextp, size_t n) {
+  uint64_t now, burst, chars;
+
+  if (sdp->com_char_ns == 0U)
+    return n;
+
+  /* Characters not transferred while the line was idle are lost, except
+     for a FIFO worth of them.*/
+  now   = sd_now();
+  burst = (uint64_t)SIM_SD_FIFO_SIZE * sdp->com_char_ns;
+  if (*nextp + burst < now)
+    *nextp = now - burst;
+
+  if (*nextp >= now)
+    return 0;
+  chars = (now - *nextp) / sdp->com_char_ns;
+  return chars < (uint64_t)n ? (size_t)chars : n;
+}
+
+static bool connint(SerialDriver *sdp) {
+
+  if ((sdp->com_data == -1) && (sdp->com_listen != -1)) {
+    switch (sdp->com_backend) {
+    case SIM_SD_BACKEND_PTY:
+      /* Always connected.*/
+      sdp->com_data = sdp->com_out;
+      break;
+    case SIM_SD_BACKEND_STDIO:
+      /* Connected once, the standard input is not read after EOF.*/
+      sdp->com_data   = sdp->com_listen;
+      sdp->com_listen = -1;
+      break;
+    default:
+      if ((sdp->com_data = accept(sdp->com_listen, NULL, NULL)) == -1)
+        return false;
+
+      if (sd_set_nonblocking(sdp->com_data)) {
+        fprintf(stderr, "%s: Unable to setup non blocking mode on data socket\n",
+                sdp->com_name);
+        goto abort;
+      }
+      if (sdp->com_backend == SIM_SD_BACKEND_TCP) {
+        /* Small writes must not be delayed, it is a serial line.*/
+        int sockval = 1;
+        setsockopt(sdp->com_data, IPPROTO_TCP, TCP_NODELAY,
+                   &sockval, sizeof(sockval));
+      }
+      sdp->com_out = sdp->com_data;
+      break;
     }
 
+    sdp->com_rx_next = 0U;
+    sdp->com_tx_next = 0U;
+
     osalSysLockFromISR();
     chnAddFlagsI(sdp, CHN_CONNECTED);
     osalSysUnlockFromISR();
@@ -147,33 +412,39 @@ abort:
 static bool inint(SerialDriver *sdp) {
 
   if (sdp->com_data != -1) {
-    int i;
-    uint8_t data[32];
+    input_queue_t *iqp = &sdp->iqueue;
+    size_t n;
+    ssize_t r;
 
     /*
-     * Input.
+     * Input, the data is read into the transfer buffer and then moved into
+     * the input queue. The simulated interrupts and the threads never run
+     * concurrently so the free space cannot shrink during the read.
      */
-    int n = recv(sdp->com_data, data, sizeof(data), 0);
-    switch (n) {
-    case 0:
-      close(sdp->com_data);
-      sdp->com_data = -1;
-      osalSysLockFromISR();
-      chnAddFlagsI(sdp, CHN_DISCONNECTED);
-      osalSysUnlockFromISR();
+    osalSysLockFromISR();
+    n = iqGetEmptyI(iqp);
+    osalSysUnlockFromISR();
+
+    /* If the queue is full then the data is left to the host, this acts
+       as a flow control.*/
+    n = pace(sdp, &sdp->com_rx_next, n);
+    if (n == 0U)
       return false;
-    case -1:
-      if (errno == EWOULDBLOCK)
+
+    r = read(sdp->com_data, sdp->com_rxbuf, n);
+    if (r <= 0) {
+      if ((r == -1) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
         return false;
-      close(sdp->com_data);
-      sdp->com_data = -1;
+      disconnect(sdp);
       return false;
     }
-    for (i = 0; i < n; i++) {
-      osalSysLockFromISR();
-      sdIncomingDataI(sdp, data[i]);
-      osalSysUnlockFromISR();
-    }
+    sdp->com_rx_next += (uint64_t)r * sdp->com_char_ns;
+
+    osalSysLockFromISR();
+    if (iqIsEmptyI(iqp))
+      chnAddFlagsI(sdp, CHN_INPUT_AVAILABLE);
+    (void)iqWriteI(iqp, sdp->com_rxbuf, (size_t)r);
+    osalSysUnlockFromISR();
     return true;
   }
   return false;
@@ -181,35 +452,55 @@ static bool inint(SerialDriver *sdp) {
 
 static bool outint(SerialDriver *sdp) {
 
-  if (sdp->com_data != -1) {
-    int n;
-    uint8_t data[1];
+  if (sdp->com_out != -1) {
+    output_queue_t *oqp = &sdp->oqueue;
+    size_t n;
+    ssize_t r;
 
     /*
-     * Input.
+     * Output, the transfer buffer is refilled from the output queue and
+     * then written, characters not accepted by the host are kept in the
+     * buffer for the next pass.
      */
     osalSysLockFromISR();
-    n = sdRequestDataI(sdp);
+    if (sdp->com_txcnt < sizeof(sdp->com_txbuf)) {
+      n = oqReadI(oqp, &sdp->com_txbuf[sdp->com_txcnt],
+                  sizeof(sdp->com_txbuf) - sdp->com_txcnt);
+      sdp->com_txcnt += n;
+      if ((n > 0U) && oqIsEmptyI(oqp))
+        chnAddFlagsI(sdp, CHN_OUTPUT_EMPTY);
+    }
     osalSysUnlockFromISR();
-    if (n < 0)
-      return false;
-    data[0] = (uint8_t)n;
-    n = send(sdp->com_data, data, sizeof(data), 0);
-    switch (n) {
-    case 0:
-      close(sdp->com_data);
-      sdp->com_data = -1;
-      osalSysLockFromISR();
-      chnAddFlagsI(sdp, CHN_DISCONNECTED);
-      osalSysUnlockFromISR();
+
+    n = pace(sdp, &sdp->com_tx_next, sdp->com_txcnt);
+    if (n == 0U)
       return false;
-    case -1:
-      if (errno == EWOULDBLOCK)
+
+    if ((sdp->com_backend == SIM_SD_BACKEND_TCP) ||
+        (sdp->com_backend == SIM_SD_BACKEND_UNIX)) {
+      /* A peer closing the connection must not kill the simulator.*/
+#if defined(MSG_NOSIGNAL)
+      r = send(sdp->com_out, sdp->com_txbuf, n, MSG_NOSIGNAL);
+#else
+      r = send(sdp->com_out, sdp->com_txbuf, n, 0);
+#endif
+    }
+    else {
+      r = write(sdp->com_out, sdp->com_txbuf, n);
+    }
+    if (r <= 0) {
+      if ((r == -1) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
         return false;
-      close(sdp->com_data);
-      sdp->com_data = -1;
+      if (sdp->com_out == sdp->com_data)
+        disconnect(sdp);
+      else
+        sdp->com_out = -1;
       return false;
     }
+    sdp->com_tx_next += (uint64_t)r * sdp->com_char_ns;
+
+    sdp->com_txcnt -= (size_t)r;
+    memmove(sdp->com_txbuf, &sdp->com_txbuf[r], sdp->com_txcnt);
     return true;
   }
   return false;
@@ -230,21 +521,27 @@ void sd_lld_init(void) {
 
 #if USE_SIM_SERIAL1
   sdObjectInit(&SD1, NULL, NULL);
+  SD1.com_backend = SIM_SD1_BACKEND;
   SD1.com_listen = -1;
   SD1.com_data = -1;
+  SD1.com_out = -1;
   SD1.com_name = "SD1";
 #endif
 
 #if USE_SIM_SERIAL2
   sdObjectInit(&SD2, NULL, NULL);
+  SD2.com_backend = SIM_SD2_BACKEND;
   SD2.com_listen = -1;
   SD2.com_data = -1;
+  SD2.com_out = -1;
   SD2.com_name = "SD2";
 #endif
 }
 
 /**
  * @brief   Low level serial driver configuration and (re)start.
+ * @note    The backend is opened on the first start, a restart only changes
+ *          the simulated bit rate.
  *
  * @param[in] sdp       pointer to a @p SerialDriver object
  * @param[in] config    the architecture-dependent serial driver configuration.
@@ -256,43 +553,139 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
   if (config == NULL)
     config = &default_config;
 
+  sdp->com_char_ns = config->speed == 0U ? 0U :
+                     10000000000U / (uint64_t)config->speed;
+  sdp->com_rx_next = 0U;
+  sdp->com_tx_next = 0U;
+  sdp->com_txcnt   = 0U;
+
+  if (sdp->state == SD_STOP) {
 #if USE_SIM_SERIAL1
-  if (sdp == &SD1)
-    init(&SD1, SIM_SD1_PORT);
+    if (sdp == &SD1)
+      init(&SD1, SIM_SD1_PORT, SIM_SD1_PATH);
 #endif
 
 #if USE_SIM_SERIAL2
-  if (sdp == &SD2)
-    init(&SD2, SIM_SD2_PORT);
+    if (sdp == &SD2)
+      init(&SD2, SIM_SD2_PORT, SIM_SD2_PATH);
 #endif
+  }
 }
 
 /**
  * @brief Low level serial driver stop.
- * @details De-initializes the USART, stops the associated clock, resets the
- *          interrupt vector.
+ * @details Closes the backend of the simulated serial port.
  *
  * @param[in] sdp pointer to a @p SerialDriver object
  */
 void sd_lld_stop(SerialDriver *sdp) {
 
-  (void)sdp;
+  if (sdp->state == SD_READY) {
+#if USE_SIM_SERIAL1
+    if (sdp == &SD1)
+      deinit(&SD1, SIM_SD1_PATH);
+#endif
+
+#if USE_SIM_SERIAL2
+    if (sdp == &SD2)
+      deinit(&SD2, SIM_SD2_PATH);
+#endif
+  }
 }
 
-bool sd_lld_interrupt_pending(void) {
+/**
+ * @brief   Checks the simulated interrupt sources of a serial port.
+ * @details The descriptors are polled without transferring data so that
+ *          the interrupt is only entered if a source can be served.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @return              The pending status.
+ * @retval false        if no interrupt source is pending.
+ * @retval true         if at least one interrupt source is pending.
+ */
+static bool sd_pending(SerialDriver *sdp) {
+  struct pollfd fds[2];
+  nfds_t nfds = 0U;
+
+  if (sdp->com_data == -1) {
+    if (sdp->com_listen != -1) {
+      /* The pseudo-terminal and the standard input are connected without
+         waiting for a peer.*/
+      if ((sdp->com_backend == SIM_SD_BACKEND_PTY) ||
+          (sdp->com_backend == SIM_SD_BACKEND_STDIO))
+        return true;
+      fds[nfds].fd     = sdp->com_listen;
+      fds[nfds].events = POLLIN;
+      nfds++;
+    }
+  }
+  else if (!iqIsFullI(&sdp->iqueue) &&
+           (pace(sdp, &sdp->com_rx_next, 1U) > 0U)) {
+    fds[nfds].fd     = sdp->com_data;
+    fds[nfds].events = POLLIN;
+    nfds++;
+  }
+
+  if ((sdp->com_out != -1) &&
+      ((sdp->com_txcnt > 0U) || !oqIsEmptyI(&sdp->oqueue)) &&
+      (pace(sdp, &sdp->com_tx_next, 1U) > 0U)) {
+    fds[nfds].fd     = sdp->com_out;
+    fds[nfds].events = POLLOUT;
+    nfds++;
+  }
+
+  if (nfds == 0U)
+    return false;
+
+  /* Errors and hang-ups are also reported, they are served as input.*/
+  return poll(fds, nfds, 0) > 0;
+}
+
+/**
+ * @brief   Serves the simulated interrupt sources of a serial port.
+ * @details Each serial port is served as a distinct interrupt vector, the
+ *          interrupt is only entered if a source is pending.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] vector    simulated vector number of the port
+ * @return              The interrupt status.
+ * @retval false        if no interrupt source has been served.
+ * @retval true         if an interrupt source has been served.
+ */
+static bool sd_serve_interrupt(SerialDriver *sdp, unsigned vector) {
   bool b;
 
+  if (!sd_pending(sdp))
+    return false;
+
+  port_irq_vector = vector;
+
   OSAL_IRQ_PROLOGUE();
 
-  b =  connint(&SD1) || connint(&SD2) ||
-       inint(&SD1)   || inint(&SD2)   ||
-       outint(&SD1)  || outint(&SD2);
+  /* Both directions are served on each pass.*/
+  b = connint(sdp);
+  b = inint(sdp) || b;
+  b = outint(sdp) || b;
 
   OSAL_IRQ_EPILOGUE();
 
   return b;
 }
 
+bool sd_lld_interrupt_pending(void) {
+  bool b = false;
+
+#if USE_SIM_SERIAL1
+  b = sd_serve_interrupt(&SD1, SIM_SD1_IRQ_VECTOR) || b;
+#endif
+
+#if USE_SIM_SERIAL2
+  b = sd_serve_interrupt(&SD2, SIM_SD2_IRQ_VECTOR) || b;
+#endif
+
+  return b;
+}
+
 #endif /* HAL_USE_SERIAL */
 
 /** @} */
@@ -27,6 +27,20 @@
 
 #if HAL_USE_SERIAL || defined(__DOXYGEN__)
 
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Simulated serial port backends
+ * @{
+ */
+#define SIM_SD_BACKEND_TCP                  0   /**< TCP listen socket.     */
+#define SIM_SD_BACKEND_UNIX                 1   /**< UNIX domain socket.    */
+#define SIM_SD_BACKEND_PTY                  2   /**< Pseudo-terminal.       */
+#define SIM_SD_BACKEND_STDIO                3   /**< Standard input/output. */
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -58,20 +72,94 @@
 #define USE_SIM_SERIAL2                     TRUE
 #endif
 
+/**
+ * @brief   Backend of SD1.
+ * @details One of the @p SIM_SD_BACKEND_xxx values.
+ * @note    The default is @p SIM_SD_BACKEND_TCP.
+ */
+#if !defined(SIM_SD1_BACKEND) || defined(__DOXYGEN__)
+#define SIM_SD1_BACKEND                     SIM_SD_BACKEND_TCP
+#endif
+
+/**
+ * @brief   Backend of SD2.
+ * @details One of the @p SIM_SD_BACKEND_xxx values.
+ * @note    The default is @p SIM_SD_BACKEND_TCP.
+ */
+#if !defined(SIM_SD2_BACKEND) || defined(__DOXYGEN__)
+#define SIM_SD2_BACKEND                     SIM_SD_BACKEND_TCP
+#endif
+
 /**
  * @brief   Listen port for SD1.
+ * @note    Used by the TCP backend.
  */
-#if !defined(SD1_PORT) || defined(__DOXYGEN__)
+#if !defined(SIM_SD1_PORT) || defined(__DOXYGEN__)
 #define SIM_SD1_PORT                        29001
 #endif
 
 /**
  * @brief   Listen port for SD2.
+ * @note    Used by the TCP backend.
  */
-#if !defined(SD2_PORT) || defined(__DOXYGEN__)
+#if !defined(SIM_SD2_PORT) || defined(__DOXYGEN__)
 #define SIM_SD2_PORT                        29002
 #endif
 
+/**
+ * @brief   File system path of SD1.
+ * @details Socket path for the UNIX domain socket backend, name of a
+ *          symbolic link to the slave device for the pseudo-terminal
+ *          backend. The link is not created if @p NULL.
+ */
+#if !defined(SIM_SD1_PATH) || defined(__DOXYGEN__)
+#define SIM_SD1_PATH                        "/tmp/chibios-sd1"
+#endif
+
+/**
+ * @brief   File system path of SD2.
+ * @details Socket path for the UNIX domain socket backend, name of a
+ *          symbolic link to the slave device for the pseudo-terminal
+ *          backend. The link is not created if @p NULL.
+ */
+#if !defined(SIM_SD2_PATH) || defined(__DOXYGEN__)
+#define SIM_SD2_PATH                        "/tmp/chibios-sd2"
+#endif
+
+/**
+ * @brief   Simulated UART FIFO size.
+ * @details When the bit rate is simulated, after an idle period up to this
+ *          number of characters can be transferred at once, then the
+ *          characters are transferred at the configured rate.
+ */
+#if !defined(SIM_SD_FIFO_SIZE) || defined(__DOXYGEN__)
+#define SIM_SD_FIFO_SIZE                    16
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SIM_SD1_BACKEND < SIM_SD_BACKEND_TCP) ||                               \
+    (SIM_SD1_BACKEND > SIM_SD_BACKEND_STDIO)
+#error "invalid SIM_SD1_BACKEND value"
+#endif
+
+#if (SIM_SD2_BACKEND < SIM_SD_BACKEND_TCP) ||                               \
+    (SIM_SD2_BACKEND > SIM_SD_BACKEND_STDIO)
+#error "invalid SIM_SD2_BACKEND value"
+#endif
+
+#if USE_SIM_SERIAL1 && USE_SIM_SERIAL2 &&                                   \
+    (SIM_SD1_BACKEND == SIM_SD_BACKEND_STDIO) &&                            \
+    (SIM_SD2_BACKEND == SIM_SD_BACKEND_STDIO)
+#error "SD1 and SD2 cannot both use the standard input/output"
+#endif
+
+#if SIM_SD_FIFO_SIZE < 1
+#error "invalid SIM_SD_FIFO_SIZE value"
+#endif
+
 /*===========================================================================*/
 /* Unsupported event flags and custom events.                                */
 /*===========================================================================*/
@@ -89,6 +177,11 @@
  *          initializers.
  */
 typedef struct {
+  /**
+   * @brief   Simulated bit rate, zero for no rate limitation.
+   * @note    Characters are timed as 8N1 frames, ten bits each.
+   */
+  uint32_t                  speed;
 } SerialConfig;
 
 /**
@@ -107,12 +200,28 @@ typedef struct {
   /* Output circular buffer.*/                                              \
   uint8_t                   ob[SERIAL_BUFFERS_SIZE];                        \
   /* End of the mandatory fields.*/                                         \
-  /* Listen socket for simulated serial port.*/                             \
+  /* Backend of the simulated serial port.*/                               \
+  int                       com_backend;                                    \
+  /* Listen socket or pseudo-terminal slave side.*/                         \
   int                       com_listen;                                     \
-  /* Data socket for simulated serial port.*/                               \
+  /* Input descriptor, -1 when not connected.*/                             \
   int                       com_data;                                       \
+  /* Output descriptor.*/                                                   \
+  int                       com_out;                                        \
   /* Port readable name.*/                                                  \
-  const char                *com_name;
+  const char                *com_name;                                      \
+  /* Character time in nanoseconds, zero if the rate is not simulated.*/    \
+  uint64_t                  com_char_ns;                                    \
+  /* Time the receiver can accept the next character.*/                     \
+  uint64_t                  com_rx_next;                                    \
+  /* Time the transmitter can send the next character.*/                    \
+  uint64_t                  com_tx_next;                                    \
+  /* Receive transfer buffer.*/                                             \
+  uint8_t                   com_rxbuf[SERIAL_BUFFERS_SIZE];                 \
+  /* Transmit transfer buffer.*/                                            \
+  uint8_t                   com_txbuf[SERIAL_BUFFERS_SIZE];                 \
+  /* Number of characters in the transmit transfer buffer.*/                \
+  size_t                    com_txcnt;
 
 /*===========================================================================*/
 /* External declarations.                                                    */
@@ -0,0 +1,518 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_uart_lld.c
+ * @brief   Posix simulator low level UART driver code.
+ *
+ * @addtogroup POSIX_UART
+ * @{
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+
+#include "hal.h"
+
+#if HAL_USE_UART || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Bits per simulated frame, 8N1 framing.
+ */
+#define SIM_UART_FRAME_BITS                 10U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief UART driver 1 identifier.*/
+#if USE_SIM_UART1 || defined(__DOXYGEN__)
+UARTDriver UARTD1;
+#endif
+
+/** @brief UART driver 2 identifier.*/
+#if USE_SIM_UART2 || defined(__DOXYGEN__)
+UARTDriver UARTD2;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Host monotonic time in nanoseconds.
+ */
+static uint64_t sim_time(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief   Puts the receiver in the UART_RX_IDLE state.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ */
+static void uart_enter_rx_idle_loop(UARTDriver *uartp) {
+
+  uartp->rxptr = NULL;
+  uartp->rxrem = 0U;
+}
+
+/**
+ * @brief   Stores received frames according to the receiver state.
+ * @details Callbacks can change the receiver state, remaining frames are
+ *          stored according to the new state.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] p         pointer to the received frames
+ * @param[in] n         number of received frames
+ */
+static void rx_store(UARTDriver *uartp, const uint8_t *p, size_t n) {
+
+  while (n > 0U) {
+    size_t m;
+
+#if UART_USE_CIRCULAR_RX == TRUE
+    if (uartp->rxstate == UART_RX_CIRCULAR) {
+      size_t half = uartp->rxcsize / 2U;
+      size_t limit = uartp->rxpos < half ? half : uartp->rxcsize;
+
+      /* Filling up to the next half buffer boundary.*/
+      m = limit - uartp->rxpos;
+      if (m > n) {
+        m = n;
+      }
+      memcpy(&uartp->rxcbuf[uartp->rxpos], p, m);
+      uartp->rxpos += m;
+      p += m;
+      n -= m;
+
+      if (uartp->rxpos == half) {
+        _uart_rx_circular_isr_code(uartp, UART_RX_HALF_EVENT);
+      }
+      else if (uartp->rxpos == uartp->rxcsize) {
+        uartp->rxpos = 0U;
+        _uart_rx_circular_isr_code(uartp, UART_RX_FULL_EVENT);
+      }
+      continue;
+    }
+#endif
+
+    if (uartp->rxstate == UART_RX_ACTIVE) {
+      m = uartp->rxrem;
+      if (m > n) {
+        m = n;
+      }
+      memcpy(uartp->rxptr, p, m);
+      uartp->rxptr += m;
+      uartp->rxrem -= m;
+      p += m;
+      n -= m;
+
+      if (uartp->rxrem == 0U) {
+        _uart_rx_complete_isr_code(uartp);
+      }
+      continue;
+    }
+
+    /* Receiver in idle state, a callback is generated, if enabled, for each
+       received character.*/
+    uartp->rxbuf = (uint16_t)*p++;
+    n--;
+    _uart_rx_idle_code(uartp);
+  }
+}
+
+/**
+ * @brief   Receiver interrupt sources.
+ * @details The line is busy until the end of the last received frame, after
+ *          that the frames that could have been transferred in the elapsed
+ *          time are read from the descriptor. The line is considered idle
+ *          after one frame time without data.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @return              The interrupt status.
+ */
+static bool rx_serve(UARTDriver *uartp) {
+  uint8_t data[SIM_UART_MAX_BURST];
+  uint64_t now, start;
+  size_t max;
+  ssize_t n;
+
+  if (uartp->rxeof) {
+    return false;
+  }
+
+  now = sim_time();
+  if (now < uartp->rxnext) {
+    return false;
+  }
+
+  /* After an idle period the line can have been free for at most one frame
+     time, earlier frame slots are lost.*/
+  max = SIM_UART_MAX_BURST;
+  start = uartp->rxnext;
+  if (uartp->frame > 0U) {
+    if (start + uartp->frame < now) {
+      start = now - uartp->frame;
+    }
+    if ((now - start) / uartp->frame + 1U < max) {
+      max = (size_t)((now - start) / uartp->frame) + 1U;
+    }
+  }
+
+  n = read(uartp->config->rxfd, data, max);
+  if (n > 0) {
+    uartp->rxnext = start + ((uint64_t)n * uartp->frame);
+    uartp->rxline = true;
+    rx_store(uartp, data, (size_t)n);
+    return true;
+  }
+
+  if (uartp->rxline) {
+    if (now >= uartp->rxnext + uartp->frame) {
+      uartp->rxline = false;
+#if UART_USE_CIRCULAR_RX == TRUE
+      if (uartp->rxstate == UART_RX_CIRCULAR) {
+        _uart_rx_circular_isr_code(uartp, UART_RX_IDLE_EVENT);
+        return true;
+      }
+#endif
+    }
+    return false;
+  }
+
+  if ((n == 0) || (errno != EAGAIN)) {
+    /* The other end has been closed after the line went idle, it is
+       reported as a break.*/
+    uartp->rxeof = true;
+    _uart_rx_error_isr_code(uartp, UART_BREAK_DETECTED);
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Transmitter interrupt sources.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @return              The interrupt status.
+ */
+static bool tx_serve(UARTDriver *uartp) {
+
+  if ((uartp->txstate != UART_TX_ACTIVE) || (sim_time() < uartp->txend)) {
+    return false;
+  }
+
+  /* The last frame left the line, both buffer and physical end of
+     transmission are notified.*/
+  _uart_tx1_isr_code(uartp);
+  _uart_tx2_isr_code(uartp);
+
+  return true;
+}
+
+/**
+ * @brief   Checks the simulated interrupt sources of an UART.
+ * @details The receive descriptor is polled without reading so that the
+ *          interrupt is only entered if a source can be served.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @return              The pending status.
+ * @retval false        if no interrupt source is pending.
+ * @retval true         if at least one interrupt source is pending.
+ */
+static bool uart_pending(UARTDriver *uartp) {
+  struct pollfd pfd;
+  uint64_t now;
+
+  now = sim_time();
+  if ((uartp->txstate == UART_TX_ACTIVE) && (now >= uartp->txend)) {
+    return true;
+  }
+  if (uartp->rxeof || (now < uartp->rxnext)) {
+    return false;
+  }
+  if (uartp->rxline && (now >= uartp->rxnext + uartp->frame)) {
+    return true;
+  }
+
+  /* Errors and hang-ups are also reported, they are served as a break.*/
+  pfd.fd     = uartp->config->rxfd;
+  pfd.events = POLLIN;
+  return poll(&pfd, 1, 0) > 0;
+}
+
+/**
+ * @brief   Serves the simulated interrupt sources of an UART.
+ * @details Each UART is served as a distinct interrupt vector, the
+ *          interrupt is only entered if a source is pending.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @return              The interrupt status.
+ * @retval false        if no interrupt source has been served.
+ * @retval true         if an interrupt source has been served.
+ */
+static bool uart_serve_interrupt(UARTDriver *uartp) {
+  bool b;
+
+  if ((uartp->state != UART_READY) || !uart_pending(uartp)) {
+    return false;
+  }
+
+  port_irq_vector = uartp->vector;
+
+  OSAL_IRQ_PROLOGUE();
+
+  b = rx_serve(uartp);
+  b = tx_serve(uartp) || b;
+
+  OSAL_IRQ_EPILOGUE();
+
+  return b;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level UART driver initialization.
+ *
+ * @notapi
+ */
+void uart_lld_init(void) {
+
+#if USE_SIM_UART1
+  uartObjectInit(&UARTD1);
+  UARTD1.vector = SIM_UART1_IRQ_VECTOR;
+#endif
+
+#if USE_SIM_UART2
+  uartObjectInit(&UARTD2);
+  UARTD2.vector = SIM_UART2_IRQ_VECTOR;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the UART peripheral.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @notapi
+ */
+void uart_lld_start(UARTDriver *uartp) {
+  int flags;
+
+  flags = fcntl(uartp->config->rxfd, F_GETFL, 0);
+  if (fcntl(uartp->config->rxfd, F_SETFL, flags | O_NONBLOCK) != 0) {
+    osalSysHalt("non blocking mode");
+  }
+
+  if (uartp->config->speed > 0U) {
+    uartp->frame = ((uint64_t)SIM_UART_FRAME_BITS * 1000000000U) /
+                   uartp->config->speed;
+  }
+  else {
+    uartp->frame = 0U;
+  }
+  uartp->rxnext = 0U;
+  uartp->rxline = false;
+  uartp->rxeof  = false;
+  uart_enter_rx_idle_loop(uartp);
+}
+
+/**
+ * @brief   Deactivates the UART peripheral.
+ * @note    The descriptors are owned by the application and are not closed.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @notapi
+ */
+void uart_lld_stop(UARTDriver *uartp) {
+
+  uart_enter_rx_idle_loop(uartp);
+}
+
+/**
+ * @brief   Starts a transmission on the UART peripheral.
+ * @details The frames are written to the descriptor immediately, the end
+ *          of transmission is notified after the simulated line time.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         number of data frames to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ *
+ * @notapi
+ */
+void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf) {
+  const uint8_t *p = txbuf;
+  size_t left = n;
+
+  while (left > 0U) {
+    ssize_t m = write(uartp->config->txfd, p, left);
+    if (m < 0) {
+      if (errno == EAGAIN) {
+        continue;
+      }
+      break;
+    }
+    p += m;
+    left -= (size_t)m;
+  }
+
+  uartp->txsize = n;
+  uartp->txend  = sim_time() + ((uint64_t)n * uartp->frame);
+}
+
+/**
+ * @brief   Stops any ongoing transmission.
+ * @note    Stopping a transmission also suppresses the transmission callbacks.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @return              The number of data frames not transmitted by the
+ *                      stopped transmit operation.
+ *
+ * @notapi
+ */
+size_t uart_lld_stop_send(UARTDriver *uartp) {
+  uint64_t now = sim_time();
+  size_t n = 0U;
+
+  if ((uartp->frame > 0U) && (now < uartp->txend)) {
+    n = (size_t)((uartp->txend - now) / uartp->frame);
+    if (n > uartp->txsize) {
+      n = uartp->txsize;
+    }
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Starts a receive operation on the UART peripheral.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         number of data frames to receive
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf) {
+
+  uartp->rxptr = rxbuf;
+  uartp->rxrem = n;
+}
+
+/**
+ * @brief   Stops any ongoing receive operation.
+ * @note    Stopping a receive operation also suppresses the receive callbacks.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @return              The number of data frames not received by the
+ *                      stopped receive operation.
+ *
+ * @notapi
+ */
+size_t uart_lld_stop_receive(UARTDriver *uartp) {
+  size_t n = uartp->rxrem;
+
+  uart_enter_rx_idle_loop(uartp);
+
+  return n;
+}
+
+#if (UART_USE_CIRCULAR_RX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a circular receive operation on the UART peripheral.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         size of the circular buffer
+ * @param[out] rxbuf    the pointer to the circular buffer
+ *
+ * @notapi
+ */
+void uart_lld_start_receive_circular(UARTDriver *uartp, size_t n,
+                                     uint8_t *rxbuf) {
+
+  (void)n;
+  (void)rxbuf;
+
+  uartp->rxpos = 0U;
+}
+
+/**
+ * @brief   Returns the circular receive position.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @return              The number of frames written in the current buffer
+ *                      lap.
+ *
+ * @notapi
+ */
+size_t uart_lld_get_receive_position(UARTDriver *uartp) {
+
+  return uartp->rxpos;
+}
+#endif /* UART_USE_CIRCULAR_RX == TRUE */
+
+/**
+ * @brief   Checks the simulated interrupt sources.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt source has been served.
+ * @retval true         if an interrupt source has been served.
+ *
+ * @notapi
+ */
+bool uart_lld_interrupt_pending(void) {
+  bool b = false;
+
+#if USE_SIM_UART1
+  b = uart_serve_interrupt(&UARTD1) || b;
+#endif
+#if USE_SIM_UART2
+  b = uart_serve_interrupt(&UARTD2) || b;
+#endif
+
+  return b;
+}
+
+#endif /* HAL_USE_UART */
+
+/** @} */
@@ -0,0 +1,297 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_uart_lld.h
+ * @brief   Posix simulator low level UART driver header.
+ * @details The simulated line is a pair of file descriptors, a socket or
+ *          the two ends of pipes. Received frames are paced at the
+ *          configured bit rate against the host clock, ten bits per frame,
+ *          and written into the receive buffers as a DMA would do.
+ *
+ * @addtogroup POSIX_UART
+ * @{
+ */
+
+#ifndef HAL_UART_LLD_H
+#define HAL_UART_LLD_H
+
+#if HAL_USE_UART || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    UART implementation capabilities
+ * @{
+ */
+#define UART_SUPPORTS_CIRCULAR_RX           TRUE
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   UARTD1 driver enable switch.
+ * @details If set to @p TRUE the support for UARTD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_UART1) || defined(__DOXYGEN__)
+#define USE_SIM_UART1                       TRUE
+#endif
+
+/**
+ * @brief   UARTD2 driver enable switch.
+ * @details If set to @p TRUE the support for UARTD2 is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(USE_SIM_UART2) || defined(__DOXYGEN__)
+#define USE_SIM_UART2                       FALSE
+#endif
+
+/**
+ * @brief   Maximum number of frames received in a single interrupt.
+ * @details It bounds the time spent in the simulated interrupt when the
+ *          line is not paced or the host clock jumped.
+ */
+#if !defined(SIM_UART_MAX_BURST) || defined(__DOXYGEN__)
+#define SIM_UART_MAX_BURST                  256
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   UART driver condition flags type.
+ */
+typedef uint32_t uartflags_t;
+
+/**
+ * @brief   Structure representing an UART driver.
+ */
+typedef struct UARTDriver UARTDriver;
+
+/**
+ * @brief   Generic UART notification callback type.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ */
+typedef void (*uartcb_t)(UARTDriver *uartp);
+
+/**
+ * @brief   Character received UART notification callback type.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] c         received character
+ */
+typedef void (*uartccb_t)(UARTDriver *uartp, uint16_t c);
+
+/**
+ * @brief   Receive error UART notification callback type.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] e         receive error mask
+ */
+typedef void (*uartecb_t)(UARTDriver *uartp, uartflags_t e);
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   End of transmission buffer callback.
+   */
+  uartcb_t                  txend1_cb;
+  /**
+   * @brief   Physical end of transmission callback.
+   */
+  uartcb_t                  txend2_cb;
+  /**
+   * @brief   Receive buffer filled callback.
+   */
+  uartcb_t                  rxend_cb;
+  /**
+   * @brief   Character received while out if the @p UART_RECEIVE state.
+   */
+  uartccb_t                 rxchar_cb;
+  /**
+   * @brief   Receive error callback.
+   */
+  uartecb_t                 rxerr_cb;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Descriptor the received frames are read from.
+   * @note    It is switched to non blocking mode by the driver.
+   */
+  int                       rxfd;
+  /**
+   * @brief   Descriptor the transmitted frames are written to.
+   * @note    It can be the same descriptor used for reception.
+   */
+  int                       txfd;
+  /**
+   * @brief   Simulated bit rate.
+   * @note    Zero means that frames are received as soon as available.
+   */
+  uint32_t                  speed;
+#if (UART_USE_CIRCULAR_RX == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Circular receive events callback.
+   */
+  uartecb_t                 rxcirc_cb;
+#endif
+} UARTConfig;
+
+/**
+ * @brief   Structure representing an UART driver.
+ */
+struct UARTDriver {
+  /**
+   * @brief   Driver state.
+   */
+  uartstate_t               state;
+  /**
+   * @brief   Transmitter state.
+   */
+  uarttxstate_t             txstate;
+  /**
+   * @brief   Receiver state.
+   */
+  uartrxstate_t             rxstate;
+  /**
+   * @brief   Current configuration data.
+   */
+  const UARTConfig          *config;
+#if (UART_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Synchronization flag for transmit operations.
+   */
+  bool                      early;
+  /**
+   * @brief   Waiting thread on RX.
+   */
+  thread_reference_t        threadrx;
+  /**
+   * @brief   Waiting thread on TX.
+   */
+  thread_reference_t        threadtx;
+#endif /* UART_USE_WAIT */
+#if (UART_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the peripheral.
+   */
+  mutex_t                   mutex;
+#endif /* UART_USE_MUTUAL_EXCLUSION */
+#if (UART_USE_CIRCULAR_RX == TRUE) || defined(__DOXYGEN__)
+  _uart_circular_rx_data
+#endif
+#if defined(UART_DRIVER_EXT_FIELDS)
+  UART_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Simulated interrupt vector.
+   */
+  unsigned                  vector;
+  /**
+   * @brief   Duration of a frame in nanoseconds.
+   */
+  uint64_t                  frame;
+  /**
+   * @brief   Host time of the next receive frame slot in nanoseconds.
+   */
+  uint64_t                  rxnext;
+  /**
+   * @brief   Host time of the end of the transmission in nanoseconds.
+   */
+  uint64_t                  txend;
+  /**
+   * @brief   Size of the transmission in progress.
+   */
+  size_t                    txsize;
+  /**
+   * @brief   Receive pointer in @p UART_RX_ACTIVE state.
+   */
+  uint8_t                   *rxptr;
+  /**
+   * @brief   Frames still to be received in @p UART_RX_ACTIVE state.
+   */
+  size_t                    rxrem;
+  /**
+   * @brief   Position within the buffer in @p UART_RX_CIRCULAR state.
+   */
+  size_t                    rxpos;
+  /**
+   * @brief   Frames received since the last idle line condition.
+   */
+  bool                      rxline;
+  /**
+   * @brief   End of file reached on the receive descriptor.
+   */
+  bool                      rxeof;
+  /**
+   * @brief   Default receive buffer while into @p UART_RX_IDLE state.
+   */
+  uint16_t                  rxbuf;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if USE_SIM_UART1 && !defined(__DOXYGEN__)
+extern UARTDriver UARTD1;
+#endif
+#if USE_SIM_UART2 && !defined(__DOXYGEN__)
+extern UARTDriver UARTD2;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void uart_lld_init(void);
+  void uart_lld_start(UARTDriver *uartp);
+  void uart_lld_stop(UARTDriver *uartp);
+  void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf);
+  size_t uart_lld_stop_send(UARTDriver *uartp);
+  void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf);
+  size_t uart_lld_stop_receive(UARTDriver *uartp);
+#if UART_USE_CIRCULAR_RX == TRUE
+  void uart_lld_start_receive_circular(UARTDriver *uartp, size_t n,
+                                       uint8_t *rxbuf);
+  size_t uart_lld_get_receive_position(UARTDriver *uartp);
+#endif
+  bool uart_lld_interrupt_pending(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_UART */
+
+#endif /* HAL_UART_LLD_H */
+
+/** @} */
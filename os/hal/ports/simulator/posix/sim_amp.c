@@ -0,0 +1,220 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/sim_amp.c
+ * @brief   Posix simulator AMP support code.
+ *
+ * @addtogroup POSIX_AMP
+ * @{
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "hal.h"
+
+#if SIM_USE_AMP || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Identifier of this instance, -1 before spawning.
+ */
+static int amp_id = -1;
+
+/**
+ * @brief   Pipe end receiving the interrupts from the peer instance.
+ */
+static int amp_rxfd = -1;
+
+/**
+ * @brief   Pipe end sending interrupts to the peer instance.
+ */
+static int amp_txfd = -1;
+
+/**
+ * @brief   Inter-instance interrupt handler.
+ */
+static sim_amp_handler_t amp_handler = NULL;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static bool amp_set_nonblocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+
+  return fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Splits the simulator in two instances sharing a memory region.
+ * @details The simulator process is forked, the parent and the child
+ *          continue from this function with an identical state except for
+ *          the returned identifier. The region is mapped at the same address
+ *          in both instances and is zero filled.
+ * @note    This function must be invoked before @p halInit() and
+ *          @p chSysInit() so that each instance initializes its own system.
+ *
+ * @param[in] size      size of the shared region
+ * @param[out] regionp  pointer to the shared region
+ * @return              The instance identifier.
+ * @retval SIM_AMP_PARENT  in the parent instance.
+ * @retval SIM_AMP_CHILD   in the child instance.
+ */
+int simAmpSpawn(size_t size, void **regionp) {
+  int p2c[2], c2p[2];
+  void *region;
+  pid_t pid;
+
+  region = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (region == MAP_FAILED) {
+    printf("AMP: Error mapping the shared region\n");
+    exit(1);
+  }
+
+  if ((pipe(p2c) != 0) || (pipe(c2p) != 0)) {
+    printf("AMP: Error creating the interrupt pipes\n");
+    exit(1);
+  }
+
+  fflush(stdout);
+  pid = fork();
+  if (pid < 0) {
+    printf("AMP: Error forking the child instance\n");
+    exit(1);
+  }
+
+  if (pid == 0) {
+    amp_id   = SIM_AMP_CHILD;
+    amp_rxfd = p2c[0];
+    amp_txfd = c2p[1];
+    close(p2c[1]);
+    close(c2p[0]);
+  }
+  else {
+    amp_id   = SIM_AMP_PARENT;
+    amp_rxfd = c2p[0];
+    amp_txfd = p2c[1];
+    close(c2p[1]);
+    close(p2c[0]);
+  }
+
+  if (!amp_set_nonblocking(amp_rxfd) || !amp_set_nonblocking(amp_txfd)) {
+    printf("AMP: Unable to setup non blocking mode on pipes\n");
+    exit(1);
+  }
+
+  *regionp = region;
+
+  return amp_id;
+}
+
+/**
+ * @brief   Sets the inter-instance interrupt handler.
+ *
+ * @param[in] handler   the handler or @p NULL
+ */
+void simAmpSetHandler(sim_amp_handler_t handler) {
+
+  amp_handler = handler;
+}
+
+/**
+ * @brief   Triggers an interrupt in the peer instance.
+ * @note    Interrupts triggered while the previous one is still pending
+ *          are merged, like on a real interrupt line.
+ * @note    This function can be called from any context.
+ */
+void simAmpInterruptPeer(void) {
+  static const uint8_t b = 0U;
+
+  /* A full pipe means there are already pending interrupts.*/
+  (void) write(amp_txfd, &b, 1);
+}
+
+/**
+ * @brief   Serves the inter-instance interrupt.
+ * @note    The host CPU is yielded if there is no interrupt pending.
+ * @note    The child instance terminates when the parent terminates.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt has been served.
+ * @retval true         if an interrupt has been served.
+ */
+bool sim_amp_interrupt_pending(void) {
+  uint8_t buf[16];
+  ssize_t n;
+  bool pending = false;
+
+  if (amp_rxfd < 0) {
+    return false;
+  }
+
+  /* All the queued interrupts are served by a single invocation.*/
+  while ((n = read(amp_rxfd, buf, sizeof (buf))) > 0) {
+    pending = true;
+  }
+  if (n == 0) {
+    /* Peer terminated.*/
+    if (amp_id == SIM_AMP_CHILD) {
+      exit(0);
+    }
+    close(amp_rxfd);
+    amp_rxfd = -1;
+  }
+
+  if (!pending) {
+    /* Giving the host CPU to the peer instance, the interrupts polling
+       would otherwise consume its whole time slice on single CPU hosts.*/
+    (void) sched_yield();
+    return false;
+  }
+
+  if (amp_handler != NULL) {
+    port_irq_vector = SIM_AMP_IRQ_VECTOR;
+
+    OSAL_IRQ_PROLOGUE();
+
+    amp_handler();
+
+    OSAL_IRQ_EPILOGUE();
+  }
+
+  return pending;
+}
+
+#endif /* SIM_USE_AMP */
+
+/** @} */
@@ -0,0 +1,83 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/sim_amp.h
+ * @brief   Posix simulator AMP support header.
+ * @details Two simulator instances, a parent and a forked child, share a
+ *          memory region and can interrupt each other. This simulates two
+ *          cores running separate ChibiOS images.
+ *
+ * @addtogroup POSIX_AMP
+ * @{
+ */
+
+#ifndef SIM_AMP_H
+#define SIM_AMP_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Instance identifiers
+ * @{
+ */
+#define SIM_AMP_PARENT          0
+#define SIM_AMP_CHILD           1
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of an inter-instance interrupt handler.
+ * @note    The handler is invoked in ISR context, it can use the I-class
+ *          APIs after locking the kernel.
+ */
+typedef void (*sim_amp_handler_t)(void);
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  int simAmpSpawn(size_t size, void **regionp);
+  void simAmpSetHandler(sim_amp_handler_t handler);
+  void simAmpInterruptPeer(void);
+  bool sim_amp_interrupt_pending(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_AMP_H */
+
+/** @} */
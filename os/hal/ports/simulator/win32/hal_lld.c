@@ -84,12 +84,25 @@ void _sim_check_for_interrupts(void) {
   }
 #endif
 
+#if HAL_USE_WSPI
+  if (wspi_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  (void)n;
+  if (st_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#else
   /* Interrupt Timer simulation (10ms interval).*/
   QueryPerformanceCounter(&n);
   if (n.QuadPart > nextcnt.QuadPart) {
     int_occurred = true;
     nextcnt.QuadPart += slice.QuadPart;
 
+    port_irq_vector = SIM_ST_IRQ_VECTOR;
     CH_IRQ_PROLOGUE();
 
     chSysLockFromISR();
@@ -98,6 +111,7 @@ void _sim_check_for_interrupts(void) {
 
     CH_IRQ_EPILOGUE();
   }
+#endif
 
   if (int_occurred) {
     _dbg_check_lock();
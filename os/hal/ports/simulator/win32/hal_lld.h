@@ -37,6 +37,15 @@
  */
 #define PLATFORM_NAME   "Win32 Simulator"
 
+/**
+ * @name    Simulated interrupt vectors
+ * @{
+ */
+#define SIM_ST_IRQ_VECTOR       0U
+#define SIM_SD1_IRQ_VECTOR      1U
+#define SIM_SD2_IRQ_VECTOR      2U
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -259,21 +259,75 @@ void sd_lld_stop(SerialDriver *sdp) {
   (void)sdp;
 }
 
-bool sd_lld_interrupt_pending(void) {
-  bool b = false;
+/**
+ * @brief   Checks the simulated interrupt sources of a serial port.
+ * @details The sockets are polled without transferring data so that the
+ *          interrupt is only entered if a source can be served.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @return              The pending status.
+ * @retval false        if no interrupt source is pending.
+ * @retval true         if at least one interrupt source is pending.
+ */
+static bool sd_pending(SerialDriver *sdp) {
+  fd_set rfds, wfds;
+  struct timeval tv = {0, 0};
+
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+  if (sdp->com_data == INVALID_SOCKET) {
+    if (sdp->com_listen == INVALID_SOCKET)
+      return false;
+    FD_SET(sdp->com_listen, &rfds);
+  }
+  else {
+    FD_SET(sdp->com_data, &rfds);
+    if (!oqIsEmptyI(&sdp->oqueue))
+      FD_SET(sdp->com_data, &wfds);
+  }
+
+  return select(0, &rfds, &wfds, NULL, &tv) > 0;
+}
+
+/**
+ * @brief   Serves the simulated interrupt sources of a serial port.
+ * @details Each serial port is served as a distinct interrupt vector, the
+ *          interrupt is only entered if a source is pending.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] vector    simulated vector number of the port
+ * @return              The interrupt status.
+ * @retval false        if no interrupt source has been served.
+ * @retval true         if an interrupt source has been served.
+ */
+static bool sd_serve_interrupt(SerialDriver *sdp, unsigned vector) {
+  bool b;
+
+  if (!sd_pending(sdp))
+    return false;
+
+  port_irq_vector = vector;
 
   CH_IRQ_PROLOGUE();
 
+  b = connint(sdp) || inint(sdp) || outint(sdp);
+
+  CH_IRQ_EPILOGUE();
+
+  return b;
+}
+
+bool sd_lld_interrupt_pending(void) {
+  bool b = false;
+
 #if USE_WIN32_SERIAL1
-  b |= connint(&SD1) || inint(&SD1) || outint(&SD1);
+  b = sd_serve_interrupt(&SD1, SIM_SD1_IRQ_VECTOR) || b;
 #endif
 
 #if USE_WIN32_SERIAL2
-  b |= connint(&SD2) || inint(&SD2) || outint(&SD2);
+  b = sd_serve_interrupt(&SD2, SIM_SD2_IRQ_VECTOR) || b;
 #endif
 
-  CH_IRQ_EPILOGUE();
-
   return b;
 }
 
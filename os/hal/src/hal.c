@@ -74,6 +74,9 @@ void halInit(void) {
 #if (HAL_USE_CAN == TRUE) || defined(__DOXYGEN__)
   canInit();
 #endif
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+  crcInit();
+#endif
 #if (HAL_USE_CRY == TRUE) || defined(__DOXYGEN__)
   cryInit();
 #endif
@@ -416,6 +416,98 @@ size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
   }
 }
 
+/**
+ * @brief   Input queue vectored read with timeout.
+ * @details The function reads data from an input queue into a sequence of
+ *          segments. The operation completes when all the segments have
+ *          been filled or after the specified timeout or if the queue has
+ *          been reset.
+ * @note    Small segments are filled within the same critical zone, up to
+ *          @p BUFFERS_CHUNKS_SIZE bytes for each preemption point.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[in] iov       pointer to an array of @p stream_iovec_t
+ * @param[in] n         number of segments
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t ibqReadVTimeout(input_buffers_queue_t *ibqp,
+                       const stream_iovec_t *iov,
+                       size_t n, sysinterval_t timeout) {
+  uint8_t *bp = NULL;
+  size_t left = 0;
+  size_t r = 0;
+
+  osalDbgCheck((iov != NULL) || (n == 0U));
+
+  osalSysLock();
+
+  while (true) {
+    size_t budget = (size_t)BUFFERS_CHUNKS_SIZE;
+
+    while (budget > 0U) {
+      size_t size;
+
+      /* Next non-empty segment.*/
+      while ((left == 0U) && (n > 0U)) {
+        bp   = iov->bp;
+        left = iov->n;
+        iov++;
+        n--;
+      }
+      if (left == 0U) {
+        osalSysUnlock();
+        return r;
+      }
+
+      /* This condition indicates that a new buffer must be acquired.*/
+      if (ibqp->ptr == NULL) {
+        msg_t msg;
+
+        /* Getting a data buffer using the specified timeout.*/
+        msg = ibqGetFullBufferTimeoutS(ibqp, timeout);
+
+        /* Anything except MSG_OK interrupts the operation.*/
+        if (msg != MSG_OK) {
+          osalSysUnlock();
+          return r;
+        }
+      }
+
+      /* Size of the data chunk present in the current buffer.*/
+      size = (size_t)ibqp->top - (size_t)ibqp->ptr;
+      if (size > left) {
+        size = left;
+      }
+      if (size > budget) {
+        size = budget;
+      }
+
+      memcpy(bp, ibqp->ptr, size);
+      bp        += size;
+      ibqp->ptr += size;
+      left      -= size;
+      budget    -= size;
+      r         += size;
+
+      /* Has the current data buffer been finished? if so then release it.*/
+      if (ibqp->ptr >= ibqp->top) {
+        ibqReleaseEmptyBufferS(ibqp);
+      }
+    }
+
+    /* Giving a preemption chance.*/
+    osalSysUnlock();
+    osalSysLock();
+  }
+}
+
 /**
  * @brief   Initializes an output buffers queue object.
  *
@@ -779,6 +871,98 @@ size_t obqWriteTimeout(output_buffers_queue_t *obqp, const uint8_t *bp,
   }
 }
 
+/**
+ * @brief   Output queue vectored write with timeout.
+ * @details The function writes data from a sequence of segments to an
+ *          output queue. The operation completes when all the segments have
+ *          been transferred or after the specified timeout or if the queue
+ *          has been reset.
+ * @note    Small segments are copied within the same critical zone, up to
+ *          @p BUFFERS_CHUNKS_SIZE bytes for each preemption point.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] iov       pointer to an array of @p stream_iovec_t
+ * @param[in] n         number of segments
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t obqWriteVTimeout(output_buffers_queue_t *obqp,
+                        const stream_iovec_t *iov,
+                        size_t n, sysinterval_t timeout) {
+  const uint8_t *bp = NULL;
+  size_t left = 0;
+  size_t w = 0;
+
+  osalDbgCheck((iov != NULL) || (n == 0U));
+
+  osalSysLock();
+
+  while (true) {
+    size_t budget = (size_t)BUFFERS_CHUNKS_SIZE;
+
+    while (budget > 0U) {
+      size_t size;
+
+      /* Next non-empty segment.*/
+      while ((left == 0U) && (n > 0U)) {
+        bp   = iov->bp;
+        left = iov->n;
+        iov++;
+        n--;
+      }
+      if (left == 0U) {
+        osalSysUnlock();
+        return w;
+      }
+
+      /* This condition indicates that a new buffer must be acquired.*/
+      if (obqp->ptr == NULL) {
+        msg_t msg;
+
+        /* Getting an empty buffer using the specified timeout.*/
+        msg = obqGetEmptyBufferTimeoutS(obqp, timeout);
+
+        /* Anything except MSG_OK interrupts the operation.*/
+        if (msg != MSG_OK) {
+          osalSysUnlock();
+          return w;
+        }
+      }
+
+      /* Size of the space available in the current buffer.*/
+      size = (size_t)obqp->top - (size_t)obqp->ptr;
+      if (size > left) {
+        size = left;
+      }
+      if (size > budget) {
+        size = budget;
+      }
+
+      memcpy(obqp->ptr, bp, size);
+      bp        += size;
+      obqp->ptr += size;
+      left      -= size;
+      budget    -= size;
+      w         += size;
+
+      /* Has the current data buffer been finished? if so then release it.*/
+      if (obqp->ptr >= obqp->top) {
+        obqPostFullBufferS(obqp, obqp->bsize - sizeof (size_t));
+      }
+    }
+
+    /* Giving a preemption chance.*/
+    osalSysUnlock();
+    osalSysLock();
+  }
+}
+
 /**
  * @brief   Flushes the current, partially filled, buffer to the queue.
  * @note    The notification callback is not invoked because the function
@@ -0,0 +1,543 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crc.c
+ * @brief   CRC Driver code.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Mask of the CRC bits.
+ *
+ * @param[in] width     CRC width in bits
+ * @return              The mask.
+ */
+static inline uint32_t crc_mask(uint32_t width) {
+
+  return 0xFFFFFFFFU >> (32U - width);
+}
+
+#if (HAL_CRC_USE_FALLBACK == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reflects the lower bits of a value.
+ *
+ * @param[in] x         value to be reflected
+ * @param[in] width     number of bits to be reflected
+ * @return              The reflected value.
+ */
+static uint32_t crc_reflect(uint32_t x, uint32_t width) {
+  uint32_t r = 0U;
+
+  while (width > 0U) {
+    r = (r << 1) | (x & 1U);
+    x >>= 1;
+    width--;
+  }
+
+  return r;
+}
+
+/**
+ * @brief   Computes the fall-back lookup tables.
+ * @details Reflected models keep the CRC in the lower bits and process
+ *          bytes starting from the LSB, normal models keep the CRC aligned
+ *          to the upper bits and process bytes starting from the MSB.
+ *          Table @p k advances a byte value across @p k further zero
+ *          bytes.
+ *
+ * @param[in] config    pointer to the @p CRCConfig object
+ */
+static void crc_fallback_tables(const CRCConfig *config) {
+  uint32_t (*t)[256] = config->table->t;
+  unsigned i, k;
+
+  if (config->refin) {
+    uint32_t poly = crc_reflect(config->poly, config->width);
+
+    for (i = 0U; i < 256U; i++) {
+      uint32_t c = i;
+
+      for (k = 0U; k < 8U; k++) {
+        c = (c & 1U) != 0U ? (c >> 1) ^ poly : c >> 1;
+      }
+      t[0][i] = c;
+    }
+    for (k = 1U; k < (unsigned)HAL_CRC_FALLBACK_SLICES; k++) {
+      for (i = 0U; i < 256U; i++) {
+        t[k][i] = (t[k - 1U][i] >> 8) ^ t[0][t[k - 1U][i] & 0xFFU];
+      }
+    }
+  }
+  else {
+    uint32_t poly = config->poly << (32U - config->width);
+
+    for (i = 0U; i < 256U; i++) {
+      uint32_t c = (uint32_t)i << 24;
+
+      for (k = 0U; k < 8U; k++) {
+        c = (c & 0x80000000U) != 0U ? (c << 1) ^ poly : c << 1;
+      }
+      t[0][i] = c;
+    }
+    for (k = 1U; k < (unsigned)HAL_CRC_FALLBACK_SLICES; k++) {
+      for (i = 0U; i < 256U; i++) {
+        t[k][i] = (t[k - 1U][i] << 8) ^ t[0][t[k - 1U][i] >> 24];
+      }
+    }
+  }
+
+  config->table->ready = true;
+}
+
+/**
+ * @brief   Initial state of the fall-back engine.
+ *
+ * @param[in] config    pointer to the @p CRCConfig object
+ * @return              The engine state.
+ */
+static uint32_t crc_fallback_init(const CRCConfig *config) {
+
+  if (config->refin) {
+    return crc_reflect(config->init, config->width);
+  }
+  return config->init << (32U - config->width);
+}
+
+/**
+ * @brief   Fall-back engine without lookup tables.
+ *
+ * @param[in] config    pointer to the @p CRCConfig object
+ * @param[in] crc       engine state
+ * @param[in] n         number of bytes
+ * @param[in] p         pointer to the data
+ * @return              The updated engine state.
+ */
+static uint32_t crc_fallback_bitwise(const CRCConfig *config, uint32_t crc,
+                                     size_t n, const uint8_t *p) {
+  unsigned k;
+
+  if (config->refin) {
+    uint32_t poly = crc_reflect(config->poly, config->width);
+
+    while (n > 0U) {
+      crc ^= (uint32_t)*p++;
+      for (k = 0U; k < 8U; k++) {
+        crc = (crc & 1U) != 0U ? (crc >> 1) ^ poly : crc >> 1;
+      }
+      n--;
+    }
+  }
+  else {
+    uint32_t poly = config->poly << (32U - config->width);
+
+    while (n > 0U) {
+      crc ^= (uint32_t)*p++ << 24;
+      for (k = 0U; k < 8U; k++) {
+        crc = (crc & 0x80000000U) != 0U ? (crc << 1) ^ poly : crc << 1;
+      }
+      n--;
+    }
+  }
+
+  return crc;
+}
+
+/**
+ * @brief   Fall-back engine, table driven.
+ * @note    Words are assembled from bytes, the code is independent from
+ *          the data alignment and the architecture endianness.
+ *
+ * @param[in] config    pointer to the @p CRCConfig object
+ * @param[in] crc       engine state
+ * @param[in] n         number of bytes
+ * @param[in] p         pointer to the data
+ * @return              The updated engine state.
+ */
+static uint32_t crc_fallback_update(const CRCConfig *config, uint32_t crc,
+                                    size_t n, const uint8_t *p) {
+  const uint32_t (*t)[256] = (const uint32_t (*)[256])config->table->t;
+
+  if (config->refin) {
+#if HAL_CRC_FALLBACK_SLICES == 8
+    while (n >= 8U) {
+      uint32_t a = crc ^ ((uint32_t)p[0]         | ((uint32_t)p[1] << 8) |
+                          ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+      uint32_t b =        (uint32_t)p[4]         | ((uint32_t)p[5] << 8) |
+                          ((uint32_t)p[6] << 16) | ((uint32_t)p[7] << 24);
+
+      crc = t[7][a & 0xFFU]         ^ t[6][(a >> 8) & 0xFFU] ^
+            t[5][(a >> 16) & 0xFFU] ^ t[4][a >> 24]          ^
+            t[3][b & 0xFFU]         ^ t[2][(b >> 8) & 0xFFU] ^
+            t[1][(b >> 16) & 0xFFU] ^ t[0][b >> 24];
+      p += 8;
+      n -= 8U;
+    }
+#endif
+#if HAL_CRC_FALLBACK_SLICES >= 4
+    while (n >= 4U) {
+      uint32_t a = crc ^ ((uint32_t)p[0]         | ((uint32_t)p[1] << 8) |
+                          ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+
+      crc = t[3][a & 0xFFU]         ^ t[2][(a >> 8) & 0xFFU] ^
+            t[1][(a >> 16) & 0xFFU] ^ t[0][a >> 24];
+      p += 4;
+      n -= 4U;
+    }
+#endif
+    while (n > 0U) {
+      crc = (crc >> 8) ^ t[0][(crc ^ (uint32_t)*p++) & 0xFFU];
+      n--;
+    }
+  }
+  else {
+#if HAL_CRC_FALLBACK_SLICES == 8
+    while (n >= 8U) {
+      uint32_t a = crc ^ (((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+                          ((uint32_t)p[2] << 8)  | (uint32_t)p[3]);
+      uint32_t b =        ((uint32_t)p[4] << 24) | ((uint32_t)p[5] << 16) |
+                          ((uint32_t)p[6] << 8)  | (uint32_t)p[7];
+
+      crc = t[7][a >> 24]          ^ t[6][(a >> 16) & 0xFFU] ^
+            t[5][(a >> 8) & 0xFFU] ^ t[4][a & 0xFFU]         ^
+            t[3][b >> 24]          ^ t[2][(b >> 16) & 0xFFU] ^
+            t[1][(b >> 8) & 0xFFU] ^ t[0][b & 0xFFU];
+      p += 8;
+      n -= 8U;
+    }
+#endif
+#if HAL_CRC_FALLBACK_SLICES >= 4
+    while (n >= 4U) {
+      uint32_t a = crc ^ (((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+                          ((uint32_t)p[2] << 8)  | (uint32_t)p[3]);
+
+      crc = t[3][a >> 24]          ^ t[2][(a >> 16) & 0xFFU] ^
+            t[1][(a >> 8) & 0xFFU] ^ t[0][a & 0xFFU];
+      p += 4;
+      n -= 4U;
+    }
+#endif
+    while (n > 0U) {
+      crc = (crc << 8) ^ t[0][(crc >> 24) ^ (uint32_t)*p++];
+      n--;
+    }
+  }
+
+  return crc;
+}
+
+/**
+ * @brief   Final value of the fall-back engine, before the final XOR.
+ *
+ * @param[in] config    pointer to the @p CRCConfig object
+ * @param[in] crc       engine state
+ * @return              The CRC value.
+ */
+static uint32_t crc_fallback_value(const CRCConfig *config, uint32_t crc) {
+
+  if (!config->refin) {
+    crc >>= 32U - config->width;
+  }
+  if (config->refin != config->refout) {
+    crc = crc_reflect(crc, config->width);
+  }
+
+  return crc;
+}
+#endif /* HAL_CRC_USE_FALLBACK == TRUE */
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   CRC Driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void crcInit(void) {
+
+#if HAL_CRC_ENFORCE_FALLBACK == FALSE
+  crc_lld_init();
+#endif
+}
+
+/**
+ * @brief   Initializes the standard part of a @p CRCDriver structure.
+ * @note    Driver objects not associated to a CRC unit can be declared by
+ *          the application, they always use the fall-back implementation.
+ *
+ * @param[out] crcp     pointer to the @p CRCDriver object
+ *
+ * @init
+ */
+void crcObjectInit(CRCDriver *crcp) {
+
+  crcp->state  = CRC_STOP;
+  crcp->config = NULL;
+#if HAL_CRC_USE_FALLBACK == TRUE
+  crcp->hw     = false;
+  crcp->crc    = 0U;
+#endif
+#if CRC_USE_MUTUAL_EXCLUSION == TRUE
+  osalMutexObjectInit(&crcp->mutex);
+#endif
+#if defined(CRC_DRIVER_EXT_INIT_HOOK)
+  CRC_DRIVER_EXT_INIT_HOOK(crcp);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the CRC peripheral.
+ * @details The CRC is reset to the initial value of the configured model.
+ *          The driver can be started again in order to switch model.
+ * @note    The fall-back lookup tables are computed, if required, on the
+ *          first use of a configuration.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] config    pointer to the @p CRCConfig object
+ *
+ * @api
+ */
+void crcStart(CRCDriver *crcp, const CRCConfig *config) {
+  bool hw;
+
+  osalDbgCheck((crcp != NULL) && (config != NULL) &&
+               (config->width >= 1U) && (config->width <= 32U));
+  osalDbgAssert((crcp->state == CRC_STOP) || (crcp->state == CRC_READY),
+                "invalid state");
+
+  crcp->config = config;
+#if HAL_CRC_ENFORCE_FALLBACK == FALSE
+  hw = crc_lld_start(crcp);
+#else
+  hw = false;
+#endif
+
+#if HAL_CRC_USE_FALLBACK == TRUE
+  crcp->hw = hw;
+  if (!hw) {
+    if ((config->table != NULL) && !config->table->ready) {
+      crc_fallback_tables(config);
+    }
+    crcp->crc = crc_fallback_init(config);
+  }
+#else
+  osalDbgAssert(hw, "unsupported model");
+  (void)hw;
+#endif
+
+  crcp->state = CRC_READY;
+}
+
+/**
+ * @brief   Deactivates the CRC peripheral.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @api
+ */
+void crcStop(CRCDriver *crcp) {
+
+  osalDbgCheck(crcp != NULL);
+  osalDbgAssert((crcp->state == CRC_STOP) || (crcp->state == CRC_READY),
+                "invalid state");
+
+#if HAL_CRC_ENFORCE_FALLBACK == FALSE
+  crc_lld_stop(crcp);
+#endif
+  crcp->config = NULL;
+  crcp->state  = CRC_STOP;
+}
+
+/**
+ * @brief   Resets the CRC to the initial value of the model.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @api
+ */
+void crcReset(CRCDriver *crcp) {
+
+  osalDbgCheck(crcp != NULL);
+  osalDbgAssert(crcp->state == CRC_READY, "not ready");
+
+#if HAL_CRC_USE_FALLBACK == TRUE
+  if (!crcp->hw) {
+    crcp->crc = crc_fallback_init(crcp->config);
+    return;
+  }
+#endif
+#if HAL_CRC_ENFORCE_FALLBACK == FALSE
+  crc_lld_reset(crcp);
+#endif
+}
+
+/**
+ * @brief   Feeds data to the CRC computation.
+ * @details The function can be called any number of times, the CRC is
+ *          computed over the concatenation of all the data fed since the
+ *          last reset.
+ * @note    The low level implementation can perform the operation using
+ *          a DMA channel and wait for its completion.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] n         number of bytes
+ * @param[in] buf       pointer to the data
+ *
+ * @api
+ */
+void crcUpdate(CRCDriver *crcp, size_t n, const void *buf) {
+
+  osalDbgCheck((crcp != NULL) && ((buf != NULL) || (n == 0U)));
+  osalDbgAssert(crcp->state == CRC_READY, "not ready");
+
+#if HAL_CRC_USE_FALLBACK == TRUE
+  if (!crcp->hw) {
+    if (crcp->config->table != NULL) {
+      crcp->crc = crc_fallback_update(crcp->config, crcp->crc,
+                                      n, (const uint8_t *)buf);
+    }
+    else {
+      crcp->crc = crc_fallback_bitwise(crcp->config, crcp->crc,
+                                       n, (const uint8_t *)buf);
+    }
+    return;
+  }
+#endif
+#if HAL_CRC_ENFORCE_FALLBACK == FALSE
+  if (n > 0U) {
+    crc_lld_update(crcp, n, (const uint8_t *)buf);
+  }
+#endif
+}
+
+/**
+ * @brief   Returns the CRC of the data fed since the last reset.
+ * @note    The computation state is not altered, more data can be fed
+ *          after this call.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The CRC value.
+ *
+ * @api
+ */
+uint32_t crcGetValue(CRCDriver *crcp) {
+  uint32_t crc;
+
+  osalDbgCheck(crcp != NULL);
+  osalDbgAssert(crcp->state == CRC_READY, "not ready");
+
+#if HAL_CRC_ENFORCE_FALLBACK == TRUE
+  crc = crc_fallback_value(crcp->config, crcp->crc);
+#elif HAL_CRC_USE_FALLBACK == TRUE
+  if (crcp->hw) {
+    crc = crc_lld_get_value(crcp);
+  }
+  else {
+    crc = crc_fallback_value(crcp->config, crcp->crc);
+  }
+#else
+  crc = crc_lld_get_value(crcp);
+#endif
+
+  return (crc ^ crcp->config->xorout) & crc_mask(crcp->config->width);
+}
+
+/**
+ * @brief   Computes the CRC of a buffer.
+ * @details The CRC is reset, the data fed and the final value returned.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] n         number of bytes
+ * @param[in] buf       pointer to the data
+ * @return              The CRC value.
+ *
+ * @api
+ */
+uint32_t crcCalc(CRCDriver *crcp, size_t n, const void *buf) {
+
+  crcReset(crcp);
+  crcUpdate(crcp, n, buf);
+
+  return crcGetValue(crcp);
+}
+
+#if (CRC_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Gains exclusive access to the CRC driver.
+ * @details This function tries to gain ownership to the CRC driver, if the
+ *          driver is already being used then the invoking thread is queued.
+ * @note    Users sharing a driver are expected to start it with their own
+ *          configuration after gaining ownership.
+ * @pre     In order to use this function the option
+ *          @p CRC_USE_MUTUAL_EXCLUSION must be enabled.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @api
+ */
+void crcAcquireBus(CRCDriver *crcp) {
+
+  osalDbgCheck(crcp != NULL);
+
+  osalMutexLock(&crcp->mutex);
+}
+
+/**
+ * @brief   Releases exclusive access to the CRC driver.
+ * @pre     In order to use this function the option
+ *          @p CRC_USE_MUTUAL_EXCLUSION must be enabled.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @api
+ */
+void crcReleaseBus(CRCDriver *crcp) {
+
+  osalDbgCheck(crcp != NULL);
+
+  osalMutexUnlock(&crcp->mutex);
+}
+#endif /* CRC_USE_MUTUAL_EXCLUSION == TRUE */
+
+#endif /* HAL_USE_CRC == TRUE */
+
+/** @} */
@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 #if (HAL_USE_CRY == TRUE) || defined(__DOXYGEN__)
@@ -38,10 +40,226 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if (HAL_CRY_KEY_SLOTS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Key slots.
+ */
+static crykeyslot_t cry_keys[HAL_CRY_KEY_SLOTS];
+
+/**
+ * @brief   Key slots use counter.
+ */
+static uint32_t cry_keys_stamp;
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (HAL_CRY_KEY_SLOTS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Key identifier of a slot.
+ */
+static crykey_t cry_key_id(const crykeyslot_t *slotp) {
+
+  return ((crykey_t)slotp->gen << 8) | (crykey_t)((slotp - cry_keys) + 1);
+}
+
+/**
+ * @brief   Compares two keys in constant time.
+ */
+static bool cry_key_equal(const uint8_t *k1, const uint8_t *k2, size_t n) {
+  uint8_t diff = 0U;
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    diff |= k1[i] ^ k2[i];
+  }
+
+  return diff == 0U;
+}
+
+/**
+ * @brief   Stores a key in a slot.
+ * @details An existing slot holding the same key is reused, else a free
+ *          slot or the least recently used one is overwritten.
+ *
+ * @param[in] algo              the key algorithm
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @param[out] key_idp          pointer to the returned key identifier
+ * @return                      The operation status.
+ */
+static cryerror_t cry_key_store(cryalgorithm_t algo,
+                                size_t size,
+                                const uint8_t *keyp,
+                                crykey_t *key_idp) {
+  crykeyslot_t tmp, *slotp, *lrup;
+  unsigned i;
+  syssts_t sts;
+
+  /* Searching for the same key already loaded, all slots are compared in
+     order to not leak the position of a match.*/
+  slotp = NULL;
+  sts = osalSysGetStatusAndLockX();
+  for (i = 0U; i < (unsigned)HAL_CRY_KEY_SLOTS; i++) {
+    crykeyslot_t *sp = &cry_keys[i];
+
+    if ((sp->algo == algo) && (sp->size == size) &&
+        cry_key_equal(sp->key, keyp, size)) {
+      slotp = sp;
+    }
+  }
+  if (slotp != NULL) {
+    slotp->stamp = ++cry_keys_stamp;
+    *key_idp = cry_key_id(slotp);
+    osalSysRestoreStatusX(sts);
+    return CRY_NOERROR;
+  }
+  osalSysRestoreStatusX(sts);
+
+  /* Key expansion is performed outside the critical zone.*/
+  tmp.algo = algo;
+  tmp.size = size;
+  memcpy(tmp.key, keyp, size);
+#if HAL_CRY_USE_FALLBACK == TRUE
+  {
+    cryerror_t err = cry_fallback_key_schedule(&tmp.sched, algo, size, keyp);
+
+    if (err != CRY_NOERROR) {
+      _cry_wipe(&tmp, sizeof (tmp));
+      return err;
+    }
+  }
+#endif
+
+  /* Free slot or least recently used one.*/
+  sts = osalSysGetStatusAndLockX();
+  lrup = &cry_keys[0];
+  for (i = 0U; i < (unsigned)HAL_CRY_KEY_SLOTS; i++) {
+    crykeyslot_t *sp = &cry_keys[i];
+
+    if (sp->algo == cry_algo_none) {
+      lrup = sp;
+      break;
+    }
+    if ((int32_t)(sp->stamp - lrup->stamp) < 0) {
+      lrup = sp;
+    }
+  }
+
+  /* An evicted key invalidates its identifiers.*/
+  if (lrup->algo != cry_algo_none) {
+    lrup->gen++;
+  }
+  tmp.gen    = lrup->gen;
+  tmp.stamp  = ++cry_keys_stamp;
+  tmp.loaded = NULL;
+  *lrup      = tmp;
+  *key_idp   = cry_key_id(lrup);
+  osalSysRestoreStatusX(sts);
+
+  _cry_wipe(&tmp, sizeof (tmp));
+
+  return CRY_NOERROR;
+}
+
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Clears the LLD loaded marks of a driver.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] algo              the algorithm
+ */
+static void cry_key_unload(CRYDriver *cryp, cryalgorithm_t algo) {
+  unsigned i;
+  syssts_t sts;
+
+  sts = osalSysGetStatusAndLockX();
+  for (i = 0U; i < (unsigned)HAL_CRY_KEY_SLOTS; i++) {
+    if ((cry_keys[i].loaded == cryp) && (cry_keys[i].algo == algo)) {
+      cry_keys[i].loaded = NULL;
+    }
+  }
+  osalSysRestoreStatusX(sts);
+}
+
+/**
+ * @brief   Makes a slot key the LLD transient key.
+ * @details The LLD key is reloaded only if the slot key is not the last one
+ *          loaded on this driver, on return the key identifier is replaced
+ *          with zero.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] algo              the algorithm
+ * @param[in,out] key_idp       pointer to the key identifier
+ * @return                      The operation status.
+ */
+static cryerror_t cry_lld_key_select(CRYDriver *cryp,
+                                     cryalgorithm_t algo,
+                                     crykey_t *key_idp) {
+  crykeyslot_t *slotp;
+  uint8_t key[CRY_KEY_MAX_SIZE];
+  crykey_t key_id = *key_idp;
+  size_t size;
+  cryerror_t err;
+  syssts_t sts;
+
+  if (key_id == (crykey_t)0) {
+    return CRY_NOERROR;
+  }
+  *key_idp = (crykey_t)0;
+
+  err = _cry_key_get(key_id, algo, &slotp);
+  if ((err != CRY_NOERROR) || (slotp->loaded == cryp)) {
+    return err;
+  }
+
+  /* Copy of the key taken in the critical zone because the slot could be
+     evicted meanwhile.*/
+  sts = osalSysGetStatusAndLockX();
+  size = slotp->size;
+  memcpy(key, slotp->key, size);
+  osalSysRestoreStatusX(sts);
+
+  cry_key_unload(cryp, algo);
+  switch (algo) {
+#if CRY_LLD_SUPPORTS_AES == TRUE
+  case cry_algo_aes:
+    err = cry_lld_aes_loadkey(cryp, size, key);
+    break;
+#endif
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == TRUE) ||                               \
+    (CRY_LLD_SUPPORTS_HMAC_SHA512 == TRUE)
+  case cry_algo_hmac:
+    err = cry_lld_hmac_loadkey(cryp, size, key);
+    break;
+#endif
+  default:
+    err = CRY_ERR_INV_ALGO;
+    break;
+  }
+  _cry_wipe(key, sizeof (key));
+
+  if (err == CRY_NOERROR) {
+    sts = osalSysGetStatusAndLockX();
+    if (cry_key_id(slotp) == key_id) {
+      slotp->loaded = cryp;
+    }
+    osalSysRestoreStatusX(sts);
+  }
+
+  return err;
+}
+#endif /* HAL_CRY_ENFORCE_FALLBACK == FALSE */
+#endif /* HAL_CRY_KEY_SLOTS > 0 */
+
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) && (HAL_CRY_KEY_SLOTS == 0)
+/* Without key slots the key identifiers are passed to the LLD unchanged.*/
+#define cry_key_unload(cryp, algo)
+#define cry_lld_key_select(cryp, algo, key_idp) ((void)(key_idp), CRY_NOERROR)
+#endif
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -125,6 +343,226 @@ void cryStop(CRYDriver *cryp) {
   osalSysUnlock();
 }
 
+#if (HAL_CRY_KEY_SLOTS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Loads an AES key in a key slot.
+ * @details The key schedule is computed once here, operations using the
+ *          returned key identifier do not repeat it. Loading a key already
+ *          present in a slot returns the existing identifier.
+ * @note    If all slots are in use then the least recently used key is
+ *          evicted and its identifier becomes invalid.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @param[out] key_idp          pointer to the returned key identifier
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the algorithm is unsupported.
+ * @retval CRY_ERR_INV_KEY_SIZE if the specified key size is invalid for
+ *                              the specified algorithm.
+ *
+ * @api
+ */
+cryerror_t cryLoadAESKey(CRYDriver *cryp,
+                         size_t size,
+                         const uint8_t *keyp,
+                         crykey_t *key_idp) {
+
+  osalDbgCheck((cryp != NULL) && (keyp != NULL) && (key_idp != NULL));
+
+#if (CRY_LLD_SUPPORTS_AES == TRUE) || (HAL_CRY_USE_FALLBACK == TRUE)
+  if ((size != 16U) && (size != 24U) && (size != 32U)) {
+    return CRY_ERR_INV_KEY_SIZE;
+  }
+
+  return cry_key_store(cry_algo_aes, size, keyp, key_idp);
+#else
+  (void)cryp;
+  (void)size;
+  (void)keyp;
+  (void)key_idp;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   Loads an HMAC key in a key slot.
+ * @details The hash states of the inner and outer padded keys are computed
+ *          once here, HMAC operations using the returned key identifier
+ *          only hash the message.
+ * @note    If all slots are in use then the least recently used key is
+ *          evicted and its identifier becomes invalid.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes, up to
+ *                              @p CRY_KEY_MAX_SIZE
+ * @param[in] keyp              pointer to the key data
+ * @param[out] key_idp          pointer to the returned key identifier
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the algorithm is unsupported.
+ * @retval CRY_ERR_INV_KEY_SIZE if the specified key size is invalid for
+ *                              the specified algorithm.
+ *
+ * @api
+ */
+cryerror_t cryLoadHMACKey(CRYDriver *cryp,
+                          size_t size,
+                          const uint8_t *keyp,
+                          crykey_t *key_idp) {
+
+  osalDbgCheck((cryp != NULL) && (keyp != NULL) && (key_idp != NULL));
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == TRUE) ||                               \
+    (CRY_LLD_SUPPORTS_HMAC_SHA512 == TRUE) ||                               \
+    (HAL_CRY_USE_FALLBACK == TRUE)
+  if (size > CRY_KEY_MAX_SIZE) {
+    return CRY_ERR_INV_KEY_SIZE;
+  }
+
+  return cry_key_store(cry_algo_hmac, size, keyp, key_idp);
+#else
+  (void)cryp;
+  (void)size;
+  (void)keyp;
+  (void)key_idp;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   Deletes a key from its slot.
+ * @details The key and its schedule are zeroized, the key identifier
+ *          becomes invalid.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be deleted
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @api
+ */
+cryerror_t cryDeleteKey(CRYDriver *cryp, crykey_t key_id) {
+  uint32_t i = (key_id & 0xFFU) - 1U;
+  crykeyslot_t *slotp;
+  uint8_t gen;
+  syssts_t sts;
+
+  osalDbgCheck(cryp != NULL);
+
+  if (i >= (uint32_t)HAL_CRY_KEY_SLOTS) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+  slotp = &cry_keys[i];
+
+  sts = osalSysGetStatusAndLockX();
+  if ((slotp->algo == cry_algo_none) || (cry_key_id(slotp) != key_id)) {
+    osalSysRestoreStatusX(sts);
+    return CRY_ERR_INV_KEY_ID;
+  }
+  gen = slotp->gen;
+  _cry_wipe(slotp, sizeof (crykeyslot_t));
+  slotp->gen = gen + 1U;
+  osalSysRestoreStatusX(sts);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Retrieves a key slot.
+ * @note    The slot content must not be modified.
+ *
+ * @param[in] key_id            the key identifier
+ * @param[in] algo              the algorithm the key is required for
+ * @param[out] slotpp           pointer to the returned slot pointer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t _cry_key_get(crykey_t key_id,
+                        cryalgorithm_t algo,
+                        crykeyslot_t **slotpp) {
+  uint32_t i = (key_id & 0xFFU) - 1U;
+  crykeyslot_t *slotp;
+  cryerror_t err;
+  syssts_t sts;
+
+  if (i >= (uint32_t)HAL_CRY_KEY_SLOTS) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+  slotp = &cry_keys[i];
+
+  sts = osalSysGetStatusAndLockX();
+  if ((slotp->algo == cry_algo_none) || (cry_key_id(slotp) != key_id)) {
+    err = CRY_ERR_INV_KEY_ID;
+  }
+  else if (slotp->algo != algo) {
+    err = CRY_ERR_INV_KEY_TYPE;
+  }
+  else {
+    slotp->stamp = ++cry_keys_stamp;
+    *slotpp = slotp;
+    err = CRY_NOERROR;
+  }
+  osalSysRestoreStatusX(sts);
+
+  return err;
+}
+#endif /* HAL_CRY_KEY_SLOTS > 0 */
+
+/**
+ * @brief   Deletes all keys.
+ * @details All key slots and the software transient keys are zeroized.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ *
+ * @api
+ */
+void cryDeleteAllKeys(CRYDriver *cryp) {
+
+  osalDbgCheck(cryp != NULL);
+
+#if HAL_CRY_KEY_SLOTS > 0
+  {
+    unsigned i;
+
+    for (i = 0U; i < (unsigned)HAL_CRY_KEY_SLOTS; i++) {
+      (void)cryDeleteKey(cryp, cry_key_id(&cry_keys[i]));
+    }
+  }
+#endif
+#if HAL_CRY_USE_FALLBACK == TRUE
+  cry_fallback_delete_keys(cryp);
+#endif
+}
+
+/**
+ * @brief   Zeroizes a memory area.
+ * @details The writes are not optimized away by the compiler.
+ *
+ * @param[out] p                pointer to the memory area
+ * @param[in] n                 size of the memory area
+ *
+ * @notapi
+ */
+void _cry_wipe(void *p, size_t n) {
+  volatile uint8_t *vp = (volatile uint8_t *)p;
+
+  while (n > 0U) {
+    *vp++ = 0U;
+    n--;
+  }
+}
+
 /**
  * @brief   Initializes the AES transient key.
  * @note    It is the underlying implementation to decide which key sizes are
@@ -149,6 +587,7 @@ cryerror_t cryLoadAESTransientKey(CRYDriver *cryp,
 
 
 #if CRY_LLD_SUPPORTS_AES == TRUE
+  cry_key_unload(cryp, cry_algo_aes);
   return cry_lld_aes_loadkey(cryp, size, keyp);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_aes_loadkey(cryp, size, keyp);
@@ -194,6 +633,11 @@ cryerror_t cryEncryptAES(CRYDriver *cryp,
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_AES == TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_aes, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_encrypt_AES(cryp, key_id, in, out);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_encrypt_AES(cryp, key_id, in, out);
@@ -240,6 +684,11 @@ cryerror_t cryDecryptAES(CRYDriver *cryp,
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_AES == TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_aes, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_decrypt_AES(cryp, key_id, in, out);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_decrypt_AES(cryp, key_id, in, out);
@@ -291,6 +740,11 @@ cryerror_t cryEncryptAES_ECB(CRYDriver *cryp,
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_AES_ECB == TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_aes, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_encrypt_AES_ECB(cryp, key_id, size, in, out);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_encrypt_AES_ECB(cryp, key_id, size, in, out);
@@ -343,6 +797,11 @@ cryerror_t cryDecryptAES_ECB(CRYDriver *cryp,
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_AES_ECB == TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_aes, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_decrypt_AES_ECB(cryp, key_id, size, in, out);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_decrypt_AES_ECB(cryp, key_id, size, in, out);
@@ -397,6 +856,11 @@ cryerror_t cryEncryptAES_CBC(CRYDriver *cryp,
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_AES_CBC == TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_aes, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_encrypt_AES_CBC(cryp, key_id, size, in, out, iv);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_encrypt_AES_CBC(cryp, key_id, size, in, out, iv);
@@ -452,6 +916,11 @@ cryerror_t cryDecryptAES_CBC(CRYDriver *cryp,
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_AES_CBC == TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_aes, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_decrypt_AES_CBC(cryp, key_id, size, in, out, iv);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_decrypt_AES_CBC(cryp, key_id, size, in, out, iv);
@@ -507,6 +976,11 @@ cryerror_t cryEncryptAES_CFB(CRYDriver *cryp,
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_AES_CFB == TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_aes, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_encrypt_AES_CFB(cryp, key_id, size, in, out, iv);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_encrypt_AES_CFB(cryp, key_id, size, in, out, iv);
@@ -562,6 +1036,11 @@ cryerror_t cryDecryptAES_CFB(CRYDriver *cryp,
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_AES_CFB == TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_aes, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_decrypt_AES_CFB(cryp, key_id, size, in, out, iv);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_decrypt_AES_CFB(cryp, key_id, size, in, out, iv);
@@ -618,6 +1097,11 @@ cryerror_t cryEncryptAES_CTR(CRYDriver *cryp,
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_AES_CTR == TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_aes, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_encrypt_AES_CTR(cryp, key_id, size, in, out, iv);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_encrypt_AES_CTR(cryp, key_id, size, in, out, iv);
@@ -674,6 +1158,11 @@ cryerror_t cryDecryptAES_CTR(CRYDriver *cryp,
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_AES_CTR == TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_aes, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_decrypt_AES_CTR(cryp, key_id, size, in, out, iv);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_decrypt_AES_CTR(cryp, key_id, size, in, out, iv);
@@ -740,6 +1229,11 @@ cryerror_t cryEncryptAES_GCM(CRYDriver *cryp,
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_AES_GCM== TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_aes, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_encrypt_AES_GCM(cryp, key_id, size, in, out, iv,
                                  aadsize, aad, authtag);
 #elif HAL_CRY_USE_FALLBACK == TRUE
@@ -811,6 +1305,11 @@ cryerror_t cryDecryptAES_GCM(CRYDriver *cryp,
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_AES_GCM== TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_aes, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_decrypt_AES_GCM(cryp, key_id, size, in, out, iv,
                                  aadsize, aad, authtag);
 #elif HAL_CRY_USE_FALLBACK == TRUE
@@ -1512,6 +2011,7 @@ cryerror_t cryLoadHMACTransientKey(CRYDriver *cryp,
 
 #if (CRY_LLD_SUPPORTS_HMAC_SHA256 == TRUE) ||                               \
     (CRY_LLD_SUPPORTS_HMAC_SHA512 == TRUE)
+  cry_key_unload(cryp, cry_algo_hmac);
   return cry_lld_hmac_loadkey(cryp, size, keyp);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_hmac_loadkey(cryp, size, keyp);
@@ -1526,6 +2026,7 @@ cryerror_t cryLoadHMACTransientKey(CRYDriver *cryp,
 
 /**
  * @brief   Hash initialization using HMAC_SHA256.
+ * @details The HMAC transient key is used.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[out] hmacsha256ctxp   pointer to a HMAC_SHA256 context to be
@@ -1542,16 +2043,50 @@ cryerror_t cryLoadHMACTransientKey(CRYDriver *cryp,
 cryerror_t cryHMACSHA256Init(CRYDriver *cryp,
                              HMACSHA256Context *hmacsha256ctxp) {
 
+  return cryHMACSHA256InitKey(cryp, (crykey_t)0, hmacsha256ctxp);
+}
+
+/**
+ * @brief   Hash initialization using HMAC_SHA256 and a specified key.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys
+ *                              loaded using @p cryLoadHMACKey()
+ * @param[out] hmacsha256ctxp   pointer to a HMAC_SHA256 context to be
+ *                              initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryHMACSHA256InitKey(CRYDriver *cryp,
+                                crykey_t key_id,
+                                HMACSHA256Context *hmacsha256ctxp) {
+
   osalDbgCheck((cryp != NULL) && (hmacsha256ctxp != NULL));
 
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_HMAC_SHA256 == TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_hmac, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_HMACSHA256_init(cryp, hmacsha256ctxp);
 #elif HAL_CRY_USE_FALLBACK == TRUE
-  return cry_fallback_HMACSHA256_init(cryp, hmacsha256ctxp);
+  return cry_fallback_HMACSHA256_init(cryp, key_id, hmacsha256ctxp);
 #else
   (void)cryp;
+  (void)key_id;
   (void)hmacsha256ctxp;
 
   return CRY_ERR_INV_ALGO;
@@ -1635,6 +2170,7 @@ cryerror_t cryHMACSHA256Final(CRYDriver *cryp,
 
 /**
  * @brief   Hash initialization using HMAC_SHA512.
+ * @details The HMAC transient key is used.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  * @param[out] hmacsha512ctxp   pointer to a HMAC_SHA512 context to be
@@ -1651,16 +2187,50 @@ cryerror_t cryHMACSHA256Final(CRYDriver *cryp,
 cryerror_t cryHMACSHA512Init(CRYDriver *cryp,
                              HMACSHA512Context *hmacsha512ctxp) {
 
+  return cryHMACSHA512InitKey(cryp, (crykey_t)0, hmacsha512ctxp);
+}
+
+/**
+ * @brief   Hash initialization using HMAC_SHA512 and a specified key.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys
+ *                              loaded using @p cryLoadHMACKey()
+ * @param[out] hmacsha512ctxp   pointer to a HMAC_SHA512 context to be
+ *                              initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryHMACSHA512InitKey(CRYDriver *cryp,
+                                crykey_t key_id,
+                                HMACSHA512Context *hmacsha512ctxp) {
+
   osalDbgCheck((cryp != NULL) && (hmacsha512ctxp != NULL));
 
   osalDbgAssert(cryp->state == CRY_READY, "not ready");
 
 #if CRY_LLD_SUPPORTS_HMAC_SHA512 == TRUE
+  cryerror_t err = cry_lld_key_select(cryp, cry_algo_hmac, &key_id);
+
+  if (err != CRY_NOERROR) {
+    return err;
+  }
   return cry_lld_HMACSHA512_init(cryp, hmacsha512ctxp);
 #elif HAL_CRY_USE_FALLBACK == TRUE
-  return cry_fallback_HMACSHA512_init(cryp, hmacsha512ctxp);
+  return cry_fallback_HMACSHA512_init(cryp, key_id, hmacsha512ctxp);
 #else
   (void)cryp;
+  (void)key_id;
   (void)hmacsha512ctxp;
 
   return CRY_ERR_INV_ALGO;
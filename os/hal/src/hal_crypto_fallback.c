@@ -0,0 +1,1512 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crypto_fallback.c
+ * @brief   Cryptographic Driver software fall-back code.
+ * @details Keys are expanded when loaded, the AES round keys and the HMAC
+ *          inner and outer padded key states are kept in the key slot so
+ *          operations never repeat the key schedule.
+ *
+ * @addtogroup CRYPTO
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if ((HAL_USE_CRY == TRUE) && (HAL_CRY_USE_FALLBACK == TRUE)) ||            \
+    defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   AES transient key.
+ */
+static crykeyslot_t aes_transient;
+
+/**
+ * @brief   HMAC transient key.
+ */
+static crykeyslot_t hmac_transient;
+
+/**
+ * @brief   AES S-box.
+ */
+static const uint8_t aes_sbox[256] = {
+  0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5,
+  0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
+  0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0,
+  0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
+  0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC,
+  0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+  0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A,
+  0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
+  0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0,
+  0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
+  0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B,
+  0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+  0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85,
+  0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
+  0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5,
+  0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
+  0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17,
+  0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+  0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88,
+  0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
+  0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C,
+  0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
+  0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9,
+  0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+  0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6,
+  0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
+  0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E,
+  0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
+  0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94,
+  0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+  0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68,
+  0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16
+};
+
+/**
+ * @brief   AES inverse S-box.
+ */
+static const uint8_t aes_inv_sbox[256] = {
+  0x52, 0x09, 0x6A, 0xD5, 0x30, 0x36, 0xA5, 0x38,
+  0xBF, 0x40, 0xA3, 0x9E, 0x81, 0xF3, 0xD7, 0xFB,
+  0x7C, 0xE3, 0x39, 0x82, 0x9B, 0x2F, 0xFF, 0x87,
+  0x34, 0x8E, 0x43, 0x44, 0xC4, 0xDE, 0xE9, 0xCB,
+  0x54, 0x7B, 0x94, 0x32, 0xA6, 0xC2, 0x23, 0x3D,
+  0xEE, 0x4C, 0x95, 0x0B, 0x42, 0xFA, 0xC3, 0x4E,
+  0x08, 0x2E, 0xA1, 0x66, 0x28, 0xD9, 0x24, 0xB2,
+  0x76, 0x5B, 0xA2, 0x49, 0x6D, 0x8B, 0xD1, 0x25,
+  0x72, 0xF8, 0xF6, 0x64, 0x86, 0x68, 0x98, 0x16,
+  0xD4, 0xA4, 0x5C, 0xCC, 0x5D, 0x65, 0xB6, 0x92,
+  0x6C, 0x70, 0x48, 0x50, 0xFD, 0xED, 0xB9, 0xDA,
+  0x5E, 0x15, 0x46, 0x57, 0xA7, 0x8D, 0x9D, 0x84,
+  0x90, 0xD8, 0xAB, 0x00, 0x8C, 0xBC, 0xD3, 0x0A,
+  0xF7, 0xE4, 0x58, 0x05, 0xB8, 0xB3, 0x45, 0x06,
+  0xD0, 0x2C, 0x1E, 0x8F, 0xCA, 0x3F, 0x0F, 0x02,
+  0xC1, 0xAF, 0xBD, 0x03, 0x01, 0x13, 0x8A, 0x6B,
+  0x3A, 0x91, 0x11, 0x41, 0x4F, 0x67, 0xDC, 0xEA,
+  0x97, 0xF2, 0xCF, 0xCE, 0xF0, 0xB4, 0xE6, 0x73,
+  0x96, 0xAC, 0x74, 0x22, 0xE7, 0xAD, 0x35, 0x85,
+  0xE2, 0xF9, 0x37, 0xE8, 0x1C, 0x75, 0xDF, 0x6E,
+  0x47, 0xF1, 0x1A, 0x71, 0x1D, 0x29, 0xC5, 0x89,
+  0x6F, 0xB7, 0x62, 0x0E, 0xAA, 0x18, 0xBE, 0x1B,
+  0xFC, 0x56, 0x3E, 0x4B, 0xC6, 0xD2, 0x79, 0x20,
+  0x9A, 0xDB, 0xC0, 0xFE, 0x78, 0xCD, 0x5A, 0xF4,
+  0x1F, 0xDD, 0xA8, 0x33, 0x88, 0x07, 0xC7, 0x31,
+  0xB1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xEC, 0x5F,
+  0x60, 0x51, 0x7F, 0xA9, 0x19, 0xB5, 0x4A, 0x0D,
+  0x2D, 0xE5, 0x7A, 0x9F, 0x93, 0xC9, 0x9C, 0xEF,
+  0xA0, 0xE0, 0x3B, 0x4D, 0xAE, 0x2A, 0xF5, 0xB0,
+  0xC8, 0xEB, 0xBB, 0x3C, 0x83, 0x53, 0x99, 0x61,
+  0x17, 0x2B, 0x04, 0x7E, 0xBA, 0x77, 0xD6, 0x26,
+  0xE1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0C, 0x7D
+};
+
+/**
+ * @brief   SHA256 initial hash value.
+ */
+static const uint32_t sha256_h0[8] = {
+  0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU,
+  0x510E527FU, 0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U
+};
+
+/**
+ * @brief   SHA256 round constants.
+ */
+static const uint32_t sha256_k[64] = {
+  0x428A2F98U, 0x71374491U, 0xB5C0FBCFU, 0xE9B5DBA5U,
+  0x3956C25BU, 0x59F111F1U, 0x923F82A4U, 0xAB1C5ED5U,
+  0xD807AA98U, 0x12835B01U, 0x243185BEU, 0x550C7DC3U,
+  0x72BE5D74U, 0x80DEB1FEU, 0x9BDC06A7U, 0xC19BF174U,
+  0xE49B69C1U, 0xEFBE4786U, 0x0FC19DC6U, 0x240CA1CCU,
+  0x2DE92C6FU, 0x4A7484AAU, 0x5CB0A9DCU, 0x76F988DAU,
+  0x983E5152U, 0xA831C66DU, 0xB00327C8U, 0xBF597FC7U,
+  0xC6E00BF3U, 0xD5A79147U, 0x06CA6351U, 0x14292967U,
+  0x27B70A85U, 0x2E1B2138U, 0x4D2C6DFCU, 0x53380D13U,
+  0x650A7354U, 0x766A0ABBU, 0x81C2C92EU, 0x92722C85U,
+  0xA2BFE8A1U, 0xA81A664BU, 0xC24B8B70U, 0xC76C51A3U,
+  0xD192E819U, 0xD6990624U, 0xF40E3585U, 0x106AA070U,
+  0x19A4C116U, 0x1E376C08U, 0x2748774CU, 0x34B0BCB5U,
+  0x391C0CB3U, 0x4ED8AA4AU, 0x5B9CCA4FU, 0x682E6FF3U,
+  0x748F82EEU, 0x78A5636FU, 0x84C87814U, 0x8CC70208U,
+  0x90BEFFFAU, 0xA4506CEBU, 0xBEF9A3F7U, 0xC67178F2U
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Multiplication by x in GF(2^8).
+ */
+static uint8_t aes_xtime(uint8_t x) {
+
+  return (uint8_t)((uint8_t)(x << 1) ^ (((x >> 7) & 1U) * 0x1BU));
+}
+
+/**
+ * @brief   AES key expansion.
+ *
+ * @param[out] schedp   pointer to the key schedule
+ * @param[in] size      key size in bytes, 16, 24 or 32
+ * @param[in] keyp      pointer to the key data
+ */
+static void aes_expand(crykeysched_t *schedp, size_t size,
+                       const uint8_t *keyp) {
+  uint8_t *rk = schedp->aes.rk;
+  uint32_t nk = (uint32_t)size / 4U;
+  uint32_t i, words;
+  uint8_t t[4], tmp, rcon = 1U;
+
+  schedp->aes.rounds = nk + 6U;
+  words = 4U * (schedp->aes.rounds + 1U);
+  memcpy(rk, keyp, size);
+
+  for (i = nk; i < words; i++) {
+    memcpy(t, &rk[(i - 1U) * 4U], 4U);
+    if ((i % nk) == 0U) {
+      tmp  = t[0];
+      t[0] = aes_sbox[t[1]] ^ rcon;
+      t[1] = aes_sbox[t[2]];
+      t[2] = aes_sbox[t[3]];
+      t[3] = aes_sbox[tmp];
+      rcon = aes_xtime(rcon);
+    }
+    else if ((nk > 6U) && ((i % nk) == 4U)) {
+      t[0] = aes_sbox[t[0]];
+      t[1] = aes_sbox[t[1]];
+      t[2] = aes_sbox[t[2]];
+      t[3] = aes_sbox[t[3]];
+    }
+    rk[(i * 4U) + 0U] = rk[((i - nk) * 4U) + 0U] ^ t[0];
+    rk[(i * 4U) + 1U] = rk[((i - nk) * 4U) + 1U] ^ t[1];
+    rk[(i * 4U) + 2U] = rk[((i - nk) * 4U) + 2U] ^ t[2];
+    rk[(i * 4U) + 3U] = rk[((i - nk) * 4U) + 3U] ^ t[3];
+  }
+}
+
+/**
+ * @brief   XOR of a round key into the state.
+ */
+static void aes_add_round_key(uint8_t *s, const uint8_t *rk) {
+  unsigned i;
+
+  for (i = 0U; i < 16U; i++) {
+    s[i] ^= rk[i];
+  }
+}
+
+/**
+ * @brief   MixColumns transformation.
+ */
+static void aes_mix_columns(uint8_t *s) {
+  unsigned c;
+
+  for (c = 0U; c < 16U; c += 4U) {
+    uint8_t a0 = s[c], a1 = s[c + 1U], a2 = s[c + 2U], a3 = s[c + 3U];
+    uint8_t t = a0 ^ a1 ^ a2 ^ a3;
+
+    s[c]      = a0 ^ t ^ aes_xtime(a0 ^ a1);
+    s[c + 1U] = a1 ^ t ^ aes_xtime(a1 ^ a2);
+    s[c + 2U] = a2 ^ t ^ aes_xtime(a2 ^ a3);
+    s[c + 3U] = a3 ^ t ^ aes_xtime(a3 ^ a0);
+  }
+}
+
+/**
+ * @brief   InvMixColumns transformation.
+ */
+static void aes_inv_mix_columns(uint8_t *s) {
+  unsigned c;
+
+  for (c = 0U; c < 16U; c += 4U) {
+    uint8_t u = aes_xtime(aes_xtime(s[c] ^ s[c + 2U]));
+    uint8_t v = aes_xtime(aes_xtime(s[c + 1U] ^ s[c + 3U]));
+
+    s[c]      ^= u;
+    s[c + 1U] ^= v;
+    s[c + 2U] ^= u;
+    s[c + 3U] ^= v;
+  }
+  aes_mix_columns(s);
+}
+
+/**
+ * @brief   Encryption of a single AES block.
+ *
+ * @param[in] schedp    pointer to the key schedule
+ * @param[in] in        input block
+ * @param[out] out      output block, it can be the same as @p in
+ */
+static void aes_encrypt_block(const crykeysched_t *schedp,
+                              const uint8_t *in, uint8_t *out) {
+  const uint8_t *rk = schedp->aes.rk;
+  uint32_t r;
+  uint8_t s[16], t[16];
+  unsigned c, i;
+
+  memcpy(s, in, 16U);
+  aes_add_round_key(s, rk);
+  for (r = 1U; r <= schedp->aes.rounds; r++) {
+    /* SubBytes and ShiftRows.*/
+    for (c = 0U; c < 4U; c++) {
+      for (i = 0U; i < 4U; i++) {
+        t[(c * 4U) + i] = aes_sbox[s[(((c + i) & 3U) * 4U) + i]];
+      }
+    }
+    if (r < schedp->aes.rounds) {
+      aes_mix_columns(t);
+    }
+    for (i = 0U; i < 16U; i++) {
+      s[i] = t[i] ^ rk[(r * 16U) + i];
+    }
+  }
+  memcpy(out, s, 16U);
+}
+
+/**
+ * @brief   Decryption of a single AES block.
+ *
+ * @param[in] schedp    pointer to the key schedule
+ * @param[in] in        input block
+ * @param[out] out      output block, it can be the same as @p in
+ */
+static void aes_decrypt_block(const crykeysched_t *schedp,
+                              const uint8_t *in, uint8_t *out) {
+  const uint8_t *rk = schedp->aes.rk;
+  uint32_t r;
+  uint8_t s[16], t[16];
+  unsigned c, i;
+
+  memcpy(s, in, 16U);
+  aes_add_round_key(s, &rk[schedp->aes.rounds * 16U]);
+  for (r = schedp->aes.rounds; r > 0U; r--) {
+    /* InvShiftRows and InvSubBytes.*/
+    for (c = 0U; c < 4U; c++) {
+      for (i = 0U; i < 4U; i++) {
+        t[(c * 4U) + i] = aes_inv_sbox[s[(((c + 4U - i) & 3U) * 4U) + i]];
+      }
+    }
+    for (i = 0U; i < 16U; i++) {
+      s[i] = t[i] ^ rk[((r - 1U) * 16U) + i];
+    }
+    if (r > 1U) {
+      aes_inv_mix_columns(s);
+    }
+  }
+  memcpy(out, s, 16U);
+}
+
+/**
+ * @brief   Right rotation.
+ */
+static uint32_t sha256_ror(uint32_t x, unsigned n) {
+
+  return (x >> n) | (x << (32U - n));
+}
+
+/**
+ * @brief   SHA256 compression of a single block.
+ *
+ * @param[in,out] h     hash state
+ * @param[in] p         pointer to the 64 bytes block
+ */
+static void sha256_compress(uint32_t *h, const uint8_t *p) {
+  uint32_t w[64], a, b, c, d, e, f, g, hh, t1, t2;
+  unsigned i;
+
+  for (i = 0U; i < 16U; i++) {
+    w[i] = ((uint32_t)p[i * 4U] << 24) | ((uint32_t)p[(i * 4U) + 1U] << 16) |
+           ((uint32_t)p[(i * 4U) + 2U] << 8) | (uint32_t)p[(i * 4U) + 3U];
+  }
+  for (i = 16U; i < 64U; i++) {
+    uint32_t s0 = sha256_ror(w[i - 15U], 7U) ^ sha256_ror(w[i - 15U], 18U) ^
+                  (w[i - 15U] >> 3);
+    uint32_t s1 = sha256_ror(w[i - 2U], 17U) ^ sha256_ror(w[i - 2U], 19U) ^
+                  (w[i - 2U] >> 10);
+    w[i] = w[i - 16U] + s0 + w[i - 7U] + s1;
+  }
+
+  a = h[0]; b = h[1]; c = h[2]; d = h[3];
+  e = h[4]; f = h[5]; g = h[6]; hh = h[7];
+  for (i = 0U; i < 64U; i++) {
+    t1 = hh + (sha256_ror(e, 6U) ^ sha256_ror(e, 11U) ^ sha256_ror(e, 25U)) +
+         ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+    t2 = (sha256_ror(a, 2U) ^ sha256_ror(a, 13U) ^ sha256_ror(a, 22U)) +
+         ((a & b) ^ (a & c) ^ (b & c));
+    hh = g; g = f; f = e; e = d + t1;
+    d = c; c = b; b = a; a = t1 + t2;
+  }
+  h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+  h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+}
+
+/**
+ * @brief   SHA256 state initialization.
+ *
+ * @param[out] shap     pointer to the SHA256 state
+ * @param[in] h         initial hash value
+ * @param[in] size      number of bytes already hashed into @p h
+ */
+static void sha256_init(crysha256_t *shap, const uint32_t *h, uint64_t size) {
+
+  memcpy(shap->h, h, sizeof (shap->h));
+  shap->size = size;
+}
+
+/**
+ * @brief   SHA256 update.
+ */
+static void sha256_update(crysha256_t *shap, size_t size, const uint8_t *in) {
+  size_t n = (size_t)(shap->size % CRY_FALLBACK_SHA256_BLOCK_SIZE);
+
+  shap->size += size;
+
+  /* Completing the partial block.*/
+  if (n > 0U) {
+    size_t chunk = CRY_FALLBACK_SHA256_BLOCK_SIZE - n;
+
+    if (chunk > size) {
+      chunk = size;
+    }
+    memcpy(&shap->buf[n], in, chunk);
+    in   += chunk;
+    size -= chunk;
+    if (n + chunk < CRY_FALLBACK_SHA256_BLOCK_SIZE) {
+      return;
+    }
+    sha256_compress(shap->h, shap->buf);
+  }
+
+  /* Whole blocks are hashed in place.*/
+  while (size >= CRY_FALLBACK_SHA256_BLOCK_SIZE) {
+    sha256_compress(shap->h, in);
+    in   += CRY_FALLBACK_SHA256_BLOCK_SIZE;
+    size -= CRY_FALLBACK_SHA256_BLOCK_SIZE;
+  }
+  memcpy(shap->buf, in, size);
+}
+
+/**
+ * @brief   SHA256 finalization.
+ */
+static void sha256_final(crysha256_t *shap, uint8_t *out) {
+  uint64_t bits = shap->size * 8U;
+  size_t n = (size_t)(shap->size % CRY_FALLBACK_SHA256_BLOCK_SIZE);
+  unsigned i;
+
+  shap->buf[n++] = 0x80U;
+  if (n > CRY_FALLBACK_SHA256_BLOCK_SIZE - 8U) {
+    memset(&shap->buf[n], 0, CRY_FALLBACK_SHA256_BLOCK_SIZE - n);
+    sha256_compress(shap->h, shap->buf);
+    n = 0U;
+  }
+  memset(&shap->buf[n], 0, CRY_FALLBACK_SHA256_BLOCK_SIZE - 8U - n);
+  for (i = 0U; i < 8U; i++) {
+    shap->buf[CRY_FALLBACK_SHA256_BLOCK_SIZE - 1U - i] = (uint8_t)(bits >> (i * 8U));
+  }
+  sha256_compress(shap->h, shap->buf);
+
+  for (i = 0U; i < 8U; i++) {
+    out[i * 4U]        = (uint8_t)(shap->h[i] >> 24);
+    out[(i * 4U) + 1U] = (uint8_t)(shap->h[i] >> 16);
+    out[(i * 4U) + 2U] = (uint8_t)(shap->h[i] >> 8);
+    out[(i * 4U) + 3U] = (uint8_t)shap->h[i];
+  }
+}
+
+/**
+ * @brief   HMAC padded keys precomputation.
+ *
+ * @param[out] schedp   pointer to the key schedule
+ * @param[in] size      key size in bytes
+ * @param[in] keyp      pointer to the key data
+ */
+static void hmac_expand(crykeysched_t *schedp, size_t size,
+                        const uint8_t *keyp) {
+  uint8_t k[CRY_FALLBACK_SHA256_BLOCK_SIZE];
+  crysha256_t sha;
+  unsigned i;
+
+  /* Keys longer than a block are replaced by their hash.*/
+  memset(k, 0, sizeof (k));
+  if (size > CRY_FALLBACK_SHA256_BLOCK_SIZE) {
+    sha256_init(&sha, sha256_h0, 0U);
+    sha256_update(&sha, size, keyp);
+    sha256_final(&sha, k);
+  }
+  else {
+    memcpy(k, keyp, size);
+  }
+
+  for (i = 0U; i < CRY_FALLBACK_SHA256_BLOCK_SIZE; i++) {
+    k[i] ^= 0x36U;
+  }
+  memcpy(schedp->hmac.ipad, sha256_h0, sizeof (schedp->hmac.ipad));
+  sha256_compress(schedp->hmac.ipad, k);
+
+  for (i = 0U; i < CRY_FALLBACK_SHA256_BLOCK_SIZE; i++) {
+    k[i] ^= 0x36U ^ 0x5CU;
+  }
+  memcpy(schedp->hmac.opad, sha256_h0, sizeof (schedp->hmac.opad));
+  sha256_compress(schedp->hmac.opad, k);
+
+  _cry_wipe(k, sizeof (k));
+  _cry_wipe(&sha, sizeof (sha));
+}
+
+/**
+ * @brief   Retrieves the schedule of a key.
+ *
+ * @param[in] key_id    the key identifier, zero is the transient key
+ * @param[in] algo      the algorithm the key is required for
+ * @param[out] schedpp  pointer to the key schedule
+ * @return              The operation status.
+ */
+static cryerror_t fallback_get_key(crykey_t key_id, cryalgorithm_t algo,
+                                   const crykeysched_t **schedpp) {
+  crykeyslot_t *slotp;
+
+  if (key_id == (crykey_t)0) {
+    slotp = algo == cry_algo_aes ? &aes_transient : &hmac_transient;
+    if (slotp->algo == cry_algo_none) {
+      return CRY_ERR_INV_KEY_ID;
+    }
+  }
+  else {
+#if HAL_CRY_KEY_SLOTS > 0
+    cryerror_t err = _cry_key_get(key_id, algo, &slotp);
+
+    if (err != CRY_NOERROR) {
+      return err;
+    }
+#else
+    return CRY_ERR_INV_KEY_ID;
+#endif
+  }
+
+  *schedpp = &slotp->sched;
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Loads a transient key.
+ */
+static cryerror_t fallback_load_transient(crykeyslot_t *slotp,
+                                          cryalgorithm_t algo,
+                                          size_t size,
+                                          const uint8_t *keyp) {
+  crykeysched_t sched;
+  cryerror_t err;
+  syssts_t sts;
+
+  err = cry_fallback_key_schedule(&sched, algo, size, keyp);
+  if (err != CRY_NOERROR) {
+    return err;
+  }
+
+  sts = osalSysGetStatusAndLockX();
+  slotp->sched = sched;
+  slotp->algo  = algo;
+  osalSysRestoreStatusX(sts);
+  _cry_wipe(&sched, sizeof (sched));
+
+  return CRY_NOERROR;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Computes the schedule of a key.
+ *
+ * @param[out] schedp           pointer to the key schedule
+ * @param[in] algo              the key algorithm
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the algorithm is unsupported.
+ * @retval CRY_ERR_INV_KEY_SIZE if the specified key size is invalid for
+ *                              the specified algorithm.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_key_schedule(crykeysched_t *schedp,
+                                     cryalgorithm_t algo,
+                                     size_t size,
+                                     const uint8_t *keyp) {
+
+  switch (algo) {
+  case cry_algo_aes:
+    if ((size != 16U) && (size != 24U) && (size != 32U)) {
+      return CRY_ERR_INV_KEY_SIZE;
+    }
+    aes_expand(schedp, size, keyp);
+    return CRY_NOERROR;
+  case cry_algo_hmac:
+    hmac_expand(schedp, size, keyp);
+    return CRY_NOERROR;
+  default:
+    return CRY_ERR_INV_ALGO;
+  }
+}
+
+/**
+ * @brief   Zeroizes the transient keys.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ *
+ * @notapi
+ */
+void cry_fallback_delete_keys(CRYDriver *cryp) {
+
+  (void)cryp;
+
+  _cry_wipe(&aes_transient, sizeof (aes_transient));
+  _cry_wipe(&hmac_transient, sizeof (hmac_transient));
+}
+
+/**
+ * @brief   Initializes the AES transient key.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_SIZE if the specified key size is invalid for
+ *                              the specified algorithm.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_aes_loadkey(CRYDriver *cryp,
+                                    size_t size,
+                                    const uint8_t *keyp) {
+
+  (void)cryp;
+
+  return fallback_load_transient(&aes_transient, cry_algo_aes, size, keyp);
+}
+
+/**
+ * @brief   Encryption of a single block using AES.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output cyphertext
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+  const crykeysched_t *schedp;
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = fallback_get_key(key_id, cry_algo_aes, &schedp);
+  if (err == CRY_NOERROR) {
+    aes_encrypt_block(schedp, in, out);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption of a single block using AES.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] in                buffer containing the input cyphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+  const crykeysched_t *schedp;
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = fallback_get_key(key_id, cry_algo_aes, &schedp);
+  if (err == CRY_NOERROR) {
+    aes_decrypt_block(schedp, in, out);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Encryption operation using AES-ECB.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers, multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output cyphertext
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+  const crykeysched_t *schedp;
+  cryerror_t err;
+  size_t i;
+
+  (void)cryp;
+
+  err = fallback_get_key(key_id, cry_algo_aes, &schedp);
+  if (err == CRY_NOERROR) {
+    for (i = 0U; i < size; i += 16U) {
+      aes_encrypt_block(schedp, &in[i], &out[i]);
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-ECB.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers, multiple of 16
+ * @param[in] in                buffer containing the input cyphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+  const crykeysched_t *schedp;
+  cryerror_t err;
+  size_t i;
+
+  (void)cryp;
+
+  err = fallback_get_key(key_id, cry_algo_aes, &schedp);
+  if (err == CRY_NOERROR) {
+    for (i = 0U; i < size; i += 16U) {
+      aes_decrypt_block(schedp, &in[i], &out[i]);
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Encryption operation using AES-CBC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers, multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output cyphertext
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  const crykeysched_t *schedp;
+  cryerror_t err;
+  uint8_t b[16];
+  size_t i, j;
+
+  (void)cryp;
+
+  err = fallback_get_key(key_id, cry_algo_aes, &schedp);
+  if (err == CRY_NOERROR) {
+    for (i = 0U; i < size; i += 16U) {
+      for (j = 0U; j < 16U; j++) {
+        b[j] = in[i + j] ^ iv[j];
+      }
+      aes_encrypt_block(schedp, b, &out[i]);
+      iv = &out[i];
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-CBC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers, multiple of 16
+ * @param[in] in                buffer containing the input cyphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  const crykeysched_t *schedp;
+  cryerror_t err;
+  uint8_t chain[16], c[16];
+  size_t i, j;
+
+  (void)cryp;
+
+  err = fallback_get_key(key_id, cry_algo_aes, &schedp);
+  if (err == CRY_NOERROR) {
+    memcpy(chain, iv, 16U);
+    for (i = 0U; i < size; i += 16U) {
+      /* The cyphertext is saved because buffers can overlap.*/
+      memcpy(c, &in[i], 16U);
+      aes_decrypt_block(schedp, c, &out[i]);
+      for (j = 0U; j < 16U; j++) {
+        out[i + j] ^= chain[j];
+      }
+      memcpy(chain, c, 16U);
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Encryption operation using AES-CFB.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers, multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output cyphertext
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_CFB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  const crykeysched_t *schedp;
+  cryerror_t err;
+  uint8_t ks[16];
+  size_t i, j;
+
+  (void)cryp;
+
+  err = fallback_get_key(key_id, cry_algo_aes, &schedp);
+  if (err == CRY_NOERROR) {
+    for (i = 0U; i < size; i += 16U) {
+      aes_encrypt_block(schedp, iv, ks);
+      for (j = 0U; j < 16U; j++) {
+        out[i + j] = in[i + j] ^ ks[j];
+      }
+      iv = &out[i];
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-CFB.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers, multiple of 16
+ * @param[in] in                buffer containing the input cyphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_CFB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  const crykeysched_t *schedp;
+  cryerror_t err;
+  uint8_t ks[16];
+  size_t i, j;
+
+  (void)cryp;
+
+  err = fallback_get_key(key_id, cry_algo_aes, &schedp);
+  if (err == CRY_NOERROR) {
+    memcpy(ks, iv, 16U);
+    for (i = 0U; i < size; i += 16U) {
+      aes_encrypt_block(schedp, ks, ks);
+      for (j = 0U; j < 16U; j++) {
+        uint8_t c = in[i + j];
+
+        out[i + j] = c ^ ks[j];
+        ks[j] = c;
+      }
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Encryption operation using AES-CTR.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers, multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output cyphertext
+ * @param[in] iv                128 bits input vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_CTR(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  const crykeysched_t *schedp;
+  cryerror_t err;
+  uint8_t ctr[16], ks[16];
+  size_t i, j;
+
+  (void)cryp;
+
+  err = fallback_get_key(key_id, cry_algo_aes, &schedp);
+  if (err == CRY_NOERROR) {
+    memcpy(ctr, iv, 16U);
+    for (i = 0U; i < size; i += 16U) {
+      aes_encrypt_block(schedp, ctr, ks);
+      for (j = 0U; j < 16U; j++) {
+        out[i + j] = in[i + j] ^ ks[j];
+      }
+
+      /* Incrementing the 32 bits big endian counter.*/
+      for (j = 15U; j >= 12U; j--) {
+        ctr[j]++;
+        if (ctr[j] != 0U) {
+          break;
+        }
+      }
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-CTR.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers, multiple of 16
+ * @param[in] in                buffer containing the input cyphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits input vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_CTR(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+
+  return cry_fallback_encrypt_AES_CTR(cryp, key_id, size, in, out, iv);
+}
+
+/**
+ * @brief   Encryption operation using AES-GCM.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_GCM(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv,
+                                        size_t aadsize,
+                                        const uint8_t *aad,
+                                        uint8_t *authtag) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+  (void)iv;
+  (void)aadsize;
+  (void)aad;
+  (void)authtag;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Decryption operation using AES-GCM.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_GCM(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv,
+                                        size_t aadsize,
+                                        const uint8_t *aad,
+                                        uint8_t *authtag) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+  (void)iv;
+  (void)aadsize;
+  (void)aad;
+  (void)authtag;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Initializes the DES transient key.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_des_loadkey(CRYDriver *cryp,
+                                    size_t size,
+                                    const uint8_t *keyp) {
+
+  (void)cryp;
+  (void)size;
+  (void)keyp;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Encryption of a single block using (T)DES.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_DES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Decryption of a single block using (T)DES.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_DES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Encryption operation using (T)DES-ECB.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_DES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Decryption operation using (T)DES-ECB.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_DES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Encryption operation using (T)DES-CBC.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_DES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+  (void)iv;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Decryption operation using (T)DES-CBC.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_DES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+  (void)iv;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using SHA1.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA1_init(CRYDriver *cryp, SHA1Context *sha1ctxp) {
+
+  (void)cryp;
+  (void)sha1ctxp;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Hash update using SHA1.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA1_update(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                    size_t size, const uint8_t *in) {
+
+  (void)cryp;
+  (void)sha1ctxp;
+  (void)size;
+  (void)in;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Hash finalization using SHA1.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA1_final(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                   uint8_t *out) {
+
+  (void)cryp;
+  (void)sha1ctxp;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] sha256ctxp       pointer to a SHA256 context to be initialized
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA256_init(CRYDriver *cryp,
+                                    SHA256Context *sha256ctxp) {
+
+  (void)cryp;
+
+  sha256_init(&sha256ctxp->sha, sha256_h0, 0U);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha256ctxp        pointer to a SHA256 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA256_update(CRYDriver *cryp,
+                                      SHA256Context *sha256ctxp,
+                                      size_t size, const uint8_t *in) {
+
+  (void)cryp;
+
+  sha256_update(&sha256ctxp->sha, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha256ctxp        pointer to a SHA256 context
+ * @param[out] out              256 bits output buffer
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA256_final(CRYDriver *cryp,
+                                     SHA256Context *sha256ctxp,
+                                     uint8_t *out) {
+
+  (void)cryp;
+
+  sha256_final(&sha256ctxp->sha, out);
+  _cry_wipe(sha256ctxp, sizeof (SHA256Context));
+
+  return CRY_NOERROR;
+}
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using SHA512.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA512_init(CRYDriver *cryp,
+                                    SHA512Context *sha512ctxp) {
+
+  (void)cryp;
+  (void)sha512ctxp;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Hash update using SHA512.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA512_update(CRYDriver *cryp,
+                                      SHA512Context *sha512ctxp,
+                                      size_t size, const uint8_t *in) {
+
+  (void)cryp;
+  (void)sha512ctxp;
+  (void)size;
+  (void)in;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Hash finalization using SHA512.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA512_final(CRYDriver *cryp,
+                                     SHA512Context *sha512ctxp,
+                                     uint8_t *out) {
+
+  (void)cryp;
+  (void)sha512ctxp;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+#endif
+
+/**
+ * @brief   Initializes the HMAC transient key.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_hmac_loadkey(CRYDriver *cryp,
+                                     size_t size,
+                                     const uint8_t *keyp) {
+
+  (void)cryp;
+
+  return fallback_load_transient(&hmac_transient, cry_algo_hmac, size, keyp);
+}
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using HMAC_SHA256.
+ * @details The hash states of the padded keys are taken from the key
+ *          schedule, the key itself is not hashed again.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[out] hmacsha256ctxp   pointer to a HMAC_SHA256 context to be
+ *                              initialized
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA256_init(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        HMACSHA256Context *hmacsha256ctxp) {
+  const crykeysched_t *schedp;
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = fallback_get_key(key_id, cry_algo_hmac, &schedp);
+  if (err == CRY_NOERROR) {
+    sha256_init(&hmacsha256ctxp->sha, schedp->hmac.ipad,
+                CRY_FALLBACK_SHA256_BLOCK_SIZE);
+    memcpy(hmacsha256ctxp->opad, schedp->hmac.opad,
+           sizeof (hmacsha256ctxp->opad));
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Hash update using HMAC_SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha256ctxp    pointer to a HMAC_SHA256 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA256_update(CRYDriver *cryp,
+                                          HMACSHA256Context *hmacsha256ctxp,
+                                          size_t size,
+                                          const uint8_t *in) {
+
+  (void)cryp;
+
+  sha256_update(&hmacsha256ctxp->sha, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using HMAC_SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha256ctxp    pointer to a HMAC_SHA256 context
+ * @param[out] out              256 bits output buffer
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA256_final(CRYDriver *cryp,
+                                         HMACSHA256Context *hmacsha256ctxp,
+                                         uint8_t *out) {
+  uint8_t digest[32];
+
+  (void)cryp;
+
+  sha256_final(&hmacsha256ctxp->sha, digest);
+  sha256_init(&hmacsha256ctxp->sha, hmacsha256ctxp->opad,
+              CRY_FALLBACK_SHA256_BLOCK_SIZE);
+  sha256_update(&hmacsha256ctxp->sha, sizeof (digest), digest);
+  sha256_final(&hmacsha256ctxp->sha, out);
+
+  _cry_wipe(digest, sizeof (digest));
+  _cry_wipe(hmacsha256ctxp, sizeof (HMACSHA256Context));
+
+  return CRY_NOERROR;
+}
+#endif
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using HMAC_SHA512.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA512_init(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        HMACSHA512Context *hmacsha512ctxp) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)hmacsha512ctxp;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Hash update using HMAC_SHA512.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA512_update(CRYDriver *cryp,
+                                          HMACSHA512Context *hmacsha512ctxp,
+                                          size_t size,
+                                          const uint8_t *in) {
+
+  (void)cryp;
+  (void)hmacsha512ctxp;
+  (void)size;
+  (void)in;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Hash finalization using HMAC_SHA512.
+ * @note    Not implemented by the fall-back.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA512_final(CRYDriver *cryp,
+                                         HMACSHA512Context *hmacsha512ctxp,
+                                         uint8_t *out) {
+
+  (void)cryp;
+  (void)hmacsha512ctxp;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+#endif
+
+#endif /* (HAL_USE_CRY == TRUE) && (HAL_CRY_USE_FALLBACK == TRUE) */
+
+/** @} */
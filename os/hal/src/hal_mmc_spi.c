@@ -108,6 +108,22 @@ static const uint8_t crc7_lookup_table[256] = {
   0x62, 0x6b, 0x70, 0x79
 };
 
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+#if (HAL_CRC_USE_FALLBACK == TRUE) || defined(__DOXYGEN__)
+static crc_table_t crc16_table;
+#endif
+
+/**
+ * @brief   CRC-16 configuration for data blocks.
+ */
+static const CRCConfig crc16_config = {
+  CRC_MODEL_CRC16_XMODEM,
+#if HAL_CRC_USE_FALLBACK == TRUE
+  &crc16_table
+#endif
+};
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -171,6 +187,33 @@ static uint8_t crc7(uint8_t crc, const uint8_t *buffer, size_t len) {
   return crc;
 }
 
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Calculates the CRC-16 of a data block.
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ * @param[in] buffer    pointer to the block data
+ * @return              The CRC in transmission order.
+ *
+ * @notapi
+ */
+static uint16_t crc16_block(MMCDriver *mmcp, const uint8_t *buffer) {
+  CRCDriver *crcp = mmcp->config->crcp;
+  uint16_t crc;
+
+#if CRC_USE_MUTUAL_EXCLUSION == TRUE
+  crcAcquireBus(crcp);
+#endif
+  crcStart(crcp, &crc16_config);
+  crc = (uint16_t)crcCalc(crcp, MMCSD_BLOCK_SIZE, buffer);
+#if CRC_USE_MUTUAL_EXCLUSION == TRUE
+  crcReleaseBus(crcp);
+#endif
+
+  return crc;
+}
+#endif
+
 /**
  * @brief   Waits an idle condition.
  *
@@ -693,11 +736,25 @@ bool mmcSequentialRead(MMCDriver *mmcp, uint8_t *buffer) {
 
   if (wait_nonidle(mmcp) == 0xFEU) {
     spiReceive(mmcp->config->spip, MMCSD_BLOCK_SIZE, buffer);
-    /* CRC ignored. */
-    spiIgnore(mmcp->config->spip, 2);
-    return HAL_SUCCESS;
+#if HAL_USE_CRC == TRUE
+    if (mmcp->config->crcp != NULL) {
+      uint8_t crc[2];
+
+      spiReceive(mmcp->config->spip, 2, crc);
+      if (crc16_block(mmcp, buffer) ==
+          (((uint16_t)crc[0] << 8U) | (uint16_t)crc[1])) {
+        return HAL_SUCCESS;
+      }
+    }
+    else
+#endif
+    {
+      /* CRC ignored. */
+      spiIgnore(mmcp->config->spip, 2);
+      return HAL_SUCCESS;
+    }
   }
-  /* Timeout or read error*/
+  /* Timeout, read error or CRC error.*/
   spiUnselect(mmcp->config->spip);
   spiStop(mmcp->config->spip);
   mmcp->state = BLK_READY;
@@ -800,7 +857,20 @@ bool mmcSequentialWrite(MMCDriver *mmcp, const uint8_t *buffer) {
 
   spiSend(mmcp->config->spip, sizeof(start), start);    /* Data prologue.   */
   spiSend(mmcp->config->spip, MMCSD_BLOCK_SIZE, buffer);/* Data.            */
-  spiIgnore(mmcp->config->spip, 2);                     /* CRC ignored.     */
+#if HAL_USE_CRC == TRUE
+  if (mmcp->config->crcp != NULL) {
+    uint16_t crc = crc16_block(mmcp, buffer);
+    uint8_t c[2];
+
+    c[0] = (uint8_t)(crc >> 8U);
+    c[1] = (uint8_t)crc;
+    spiSend(mmcp->config->spip, 2, c);                  /* CRC.             */
+  }
+  else
+#endif
+  {
+    spiIgnore(mmcp->config->spip, 2);                   /* CRC ignored.     */
+  }
   spiReceive(mmcp->config->spip, 1, b);
   if ((b[0] & 0x1FU) == 0x05U) {
     wait(mmcp);
@@ -241,6 +241,62 @@ msg_t iqPutI(input_queue_t *iqp, uint8_t b) {
   return MSG_TIMEOUT;
 }
 
+/**
+ * @brief   Input queue non-blocking bulk write.
+ * @details The function writes data from a buffer into an input queue, it
+ *          is meant to be used by the lower side in place of multiple
+ *          @p iqPutI() calls. The operation completes immediately.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is reserved
+ * @return              The number of bytes effectively transferred.
+ *
+ * @iclass
+ */
+size_t iqWriteI(input_queue_t *iqp, const uint8_t *bp, size_t n) {
+  size_t s1, s2;
+
+  osalDbgCheckClassI();
+  osalDbgCheck(n > 0U);
+
+  /* Number of bytes that can be written in a single atomic operation.*/
+  if (n > iqGetEmptyI(iqp)) {
+    n = iqGetEmptyI(iqp);
+  }
+  if (n == (size_t)0) {
+    return (size_t)0;
+  }
+
+  /* Number of bytes before buffer limit.*/
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(iqp->q_top - iqp->q_wrptr);
+  /*lint -restore*/
+  if (n < s1) {
+    memcpy((void *)iqp->q_wrptr, (const void *)bp, n);
+    iqp->q_wrptr += n;
+  }
+  else if (n > s1) {
+    memcpy((void *)iqp->q_wrptr, (const void *)bp, s1);
+    bp += s1;
+    s2 = n - s1;
+    memcpy((void *)iqp->q_buffer, (const void *)bp, s2);
+    iqp->q_wrptr = iqp->q_buffer + s2;
+  }
+  else { /* n == s1 */
+    memcpy((void *)iqp->q_wrptr, (const void *)bp, n);
+    iqp->q_wrptr = iqp->q_buffer;
+  }
+  iqp->q_counter += n;
+
+  /* All the waiting readers are resumed, there could be enough data for
+     more than one of them.*/
+  osalThreadDequeueAllI(&iqp->q_waiting, MSG_OK);
+
+  return n;
+}
+
 /**
  * @brief   Input queue non-blocking read.
  * @details This function reads a byte value from an input queue. The
@@ -428,6 +484,101 @@ size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Input queue vectored read with timeout.
+ * @details The function reads data from an input queue into a sequence of
+ *          segments. The operation completes when all the segments have
+ *          been filled or after the specified timeout or if the queue has
+ *          been reset.
+ * @note    The function is not atomic, if you need atomicity it is suggested
+ *          to use a semaphore or a mutex for mutual exclusion.
+ * @note    The segments are filled from the available data within the same
+ *          critical zone, the callback is invoked once for all of them.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[in] iov       pointer to an array of @p stream_iovec_t
+ * @param[in] n         number of segments
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t iqReadVTimeout(input_queue_t *iqp, const stream_iovec_t *iov,
+                      size_t n, sysinterval_t timeout) {
+  qnotify_t nfy = iqp->q_notify;
+  uint8_t *bp = NULL;
+  size_t left = (size_t)0;
+  size_t rd = (size_t)0;
+
+  osalDbgCheck((iov != NULL) || (n == 0U));
+
+  osalSysLock();
+
+  while (true) {
+    size_t done = (size_t)0;
+
+    /* Filling segments until the queue is empty.*/
+    while (true) {
+      size_t k;
+
+      /* Next non-empty segment, iq_read() does not accept zero sizes.*/
+      while ((left == (size_t)0) && (n > 0U)) {
+        bp   = iov->bp;
+        left = iov->n;
+        iov++;
+        n--;
+      }
+      if (left == (size_t)0) {
+        break;
+      }
+
+      k = iq_read(iqp, bp, left);
+      if (k == (size_t)0) {
+        break;
+      }
+      bp   += k;
+      left -= k;
+      done += k;
+    }
+
+    if (done == (size_t)0) {
+      msg_t msg;
+
+      /* All segments filled.*/
+      if (left == (size_t)0) {
+        break;
+      }
+
+      msg = osalThreadEnqueueTimeoutS(&iqp->q_waiting, timeout);
+
+      /* Anything except MSG_OK causes the operation to stop.*/
+      if (msg != MSG_OK) {
+        break;
+      }
+    }
+    else {
+      /* Inform the low side that the queue has at least one empty slot
+         available.*/
+      if (nfy != NULL) {
+        nfy(iqp);
+      }
+
+      rd += done;
+
+      /* Giving a preemption chance in a controlled point.*/
+      osalSysUnlock();
+      osalSysLock();
+    }
+  }
+
+  osalSysUnlock();
+  return rd;
+}
+
 /**
  * @brief   Initializes an output queue.
  * @details A Semaphore is internally initialized and works as a counter of
@@ -600,6 +751,62 @@ msg_t oqGetI(output_queue_t *oqp) {
   return MSG_TIMEOUT;
 }
 
+/**
+ * @brief   Output queue non-blocking bulk read.
+ * @details The function reads data from an output queue into a buffer, it
+ *          is meant to be used by the lower side in place of multiple
+ *          @p oqGetI() calls. The operation completes immediately.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is reserved
+ * @return              The number of bytes effectively transferred.
+ *
+ * @iclass
+ */
+size_t oqReadI(output_queue_t *oqp, uint8_t *bp, size_t n) {
+  size_t s1, s2;
+
+  osalDbgCheckClassI();
+  osalDbgCheck(n > 0U);
+
+  /* Number of bytes that can be read in a single atomic operation.*/
+  if (n > oqGetFullI(oqp)) {
+    n = oqGetFullI(oqp);
+  }
+  if (n == (size_t)0) {
+    return (size_t)0;
+  }
+
+  /* Number of bytes before buffer limit.*/
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(oqp->q_top - oqp->q_rdptr);
+  /*lint -restore*/
+  if (n < s1) {
+    memcpy((void *)bp, (void *)oqp->q_rdptr, n);
+    oqp->q_rdptr += n;
+  }
+  else if (n > s1) {
+    memcpy((void *)bp, (void *)oqp->q_rdptr, s1);
+    bp += s1;
+    s2 = n - s1;
+    memcpy((void *)bp, (void *)oqp->q_buffer, s2);
+    oqp->q_rdptr = oqp->q_buffer + s2;
+  }
+  else { /* n == s1 */
+    memcpy((void *)bp, (void *)oqp->q_rdptr, n);
+    oqp->q_rdptr = oqp->q_buffer;
+  }
+  oqp->q_counter += n;
+
+  /* All the waiting writers are resumed, there could be enough space for
+     more than one of them.*/
+  osalThreadDequeueAllI(&oqp->q_waiting, MSG_OK);
+
+  return n;
+}
+
 
 /**
  * @brief   Output queue non-blocking write.
@@ -697,4 +904,99 @@ size_t oqWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Output queue vectored write with timeout.
+ * @details The function writes data from a sequence of segments to an
+ *          output queue. The operation completes when all the segments have
+ *          been transferred or after the specified timeout or if the queue
+ *          has been reset.
+ * @note    The function is not atomic, if you need atomicity it is suggested
+ *          to use a semaphore or a mutex for mutual exclusion.
+ * @note    The segments are copied into the free space within the same
+ *          critical zone, the callback is invoked once for all of them.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] iov       pointer to an array of @p stream_iovec_t
+ * @param[in] n         number of segments
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t oqWriteVTimeout(output_queue_t *oqp, const stream_iovec_t *iov,
+                       size_t n, sysinterval_t timeout) {
+  qnotify_t nfy = oqp->q_notify;
+  const uint8_t *bp = NULL;
+  size_t left = (size_t)0;
+  size_t wr = (size_t)0;
+
+  osalDbgCheck((iov != NULL) || (n == 0U));
+
+  osalSysLock();
+
+  while (true) {
+    size_t done = (size_t)0;
+
+    /* Copying segments until the queue is full.*/
+    while (true) {
+      size_t k;
+
+      /* Next non-empty segment, oq_write() does not accept zero sizes.*/
+      while ((left == (size_t)0) && (n > 0U)) {
+        bp   = iov->bp;
+        left = iov->n;
+        iov++;
+        n--;
+      }
+      if (left == (size_t)0) {
+        break;
+      }
+
+      k = oq_write(oqp, bp, left);
+      if (k == (size_t)0) {
+        break;
+      }
+      bp   += k;
+      left -= k;
+      done += k;
+    }
+
+    if (done == (size_t)0) {
+      msg_t msg;
+
+      /* All segments transferred.*/
+      if (left == (size_t)0) {
+        break;
+      }
+
+      msg = osalThreadEnqueueTimeoutS(&oqp->q_waiting, timeout);
+
+      /* Anything except MSG_OK causes the operation to stop.*/
+      if (msg != MSG_OK) {
+        break;
+      }
+    }
+    else {
+      /* Inform the low side that the queue has at least one character
+         available.*/
+      if (nfy != NULL) {
+        nfy(oqp);
+      }
+
+      wr += done;
+
+      /* Giving a preemption chance in a controlled point.*/
+      osalSysUnlock();
+      osalSysLock();
+    }
+  }
+
+  osalSysUnlock();
+  return wr;
+}
+
 /** @} */
@@ -91,6 +91,18 @@ static size_t _readt(void *ip, uint8_t *bp, size_t n,
   return iqReadTimeout(&((SerialDriver *)ip)->iqueue, bp, n, timeout);
 }
 
+static size_t _writev(void *ip, const stream_iovec_t *iov, size_t n,
+                      sysinterval_t timeout) {
+
+  return oqWriteVTimeout(&((SerialDriver *)ip)->oqueue, iov, n, timeout);
+}
+
+static size_t _readv(void *ip, const stream_iovec_t *iov, size_t n,
+                     sysinterval_t timeout) {
+
+  return iqReadVTimeout(&((SerialDriver *)ip)->iqueue, iov, n, timeout);
+}
+
 static msg_t _ctl(void *ip, unsigned int operation, void *arg) {
   SerialDriver *sdp = (SerialDriver *)ip;
 
@@ -118,7 +130,8 @@ static const struct SerialDriverVMT vmt = {
   (size_t)0,
   _write, _read, _put, _get,
   _putt, _gett, _writet, _readt,
-  _ctl
+  _ctl,
+  _writev, _readv
 };
 
 /*===========================================================================*/
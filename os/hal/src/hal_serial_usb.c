@@ -126,6 +126,18 @@ static size_t _readt(void *ip, uint8_t *bp, size_t n,
   return ibqReadTimeout(&((SerialUSBDriver *)ip)->ibqueue, bp, n, timeout);
 }
 
+static size_t _writev(void *ip, const stream_iovec_t *iov, size_t n,
+                      sysinterval_t timeout) {
+
+  return obqWriteVTimeout(&((SerialUSBDriver *)ip)->obqueue, iov, n, timeout);
+}
+
+static size_t _readv(void *ip, const stream_iovec_t *iov, size_t n,
+                     sysinterval_t timeout) {
+
+  return ibqReadVTimeout(&((SerialUSBDriver *)ip)->ibqueue, iov, n, timeout);
+}
+
 static msg_t _ctl(void *ip, unsigned int operation, void *arg) {
   SerialUSBDriver *sdup = (SerialUSBDriver *)ip;
 
@@ -157,7 +169,8 @@ static const struct SerialUSBDriverVMT vmt = {
   (size_t)0,
   _write, _read, _put, _get,
   _putt, _gett, _writet, _readt,
-  _ctl
+  _ctl,
+  _writev, _readv
 };
 
 /**
@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 #if (HAL_USE_UART == TRUE) || defined(__DOXYGEN__)
@@ -256,7 +258,8 @@ void uartStartReceive(UARTDriver *uartp, size_t n, void *rxbuf) {
 
   osalSysLock();
   osalDbgAssert(uartp->state == UART_READY, "is active");
-  osalDbgAssert(uartp->rxstate != UART_RX_ACTIVE, "rx active");
+  osalDbgAssert((uartp->rxstate != UART_RX_ACTIVE) &&
+                (uartp->rxstate != UART_RX_CIRCULAR), "rx active");
 
   uart_lld_start_receive(uartp, n, rxbuf);
   uartp->rxstate = UART_RX_ACTIVE;
@@ -280,7 +283,8 @@ void uartStartReceiveI(UARTDriver *uartp, size_t n, void *rxbuf) {
   osalDbgCheckClassI();
   osalDbgCheck((uartp != NULL) && (n > 0U) && (rxbuf != NULL));
   osalDbgAssert(uartp->state == UART_READY, "is active");
-  osalDbgAssert(uartp->rxstate != UART_RX_ACTIVE, "rx active");
+  osalDbgAssert((uartp->rxstate != UART_RX_ACTIVE) &&
+                (uartp->rxstate != UART_RX_CIRCULAR), "rx active");
 
   uart_lld_start_receive(uartp, n, rxbuf);
   uartp->rxstate = UART_RX_ACTIVE;
@@ -293,7 +297,8 @@ void uartStartReceiveI(UARTDriver *uartp, size_t n, void *rxbuf) {
  * @param[in] uartp     pointer to the @p UARTDriver object
  *
  * @return              The number of data frames not received by the
- *                      stopped receive operation.
+ *                      stopped receive operation. In circular mode it is
+ *                      the number of received frames not yet consumed.
  * @retval UART_ERR_NOT_ACTIVE if there was no receive operation in progress.
  *
  * @api
@@ -304,15 +309,7 @@ size_t uartStopReceive(UARTDriver *uartp) {
   osalDbgCheck(uartp != NULL);
 
   osalSysLock();
-  osalDbgAssert(uartp->state == UART_READY, "not active");
-
-  if (uartp->rxstate == UART_RX_ACTIVE) {
-    n = uart_lld_stop_receive(uartp);
-    uartp->rxstate = UART_RX_IDLE;
-  }
-  else {
-    n = UART_ERR_NOT_ACTIVE;
-  }
+  n = uartStopReceiveI(uartp);
   osalSysUnlock();
 
   return n;
@@ -326,7 +323,8 @@ size_t uartStopReceive(UARTDriver *uartp) {
  * @param[in] uartp     pointer to the @p UARTDriver object
  *
  * @return              The number of data frames not received by the
- *                      stopped receive operation.
+ *                      stopped receive operation. In circular mode it is
+ *                      the number of received frames not yet consumed.
  * @retval UART_ERR_NOT_ACTIVE if there was no receive operation in progress.
  *
  * @iclass
@@ -342,6 +340,14 @@ size_t uartStopReceiveI(UARTDriver *uartp) {
     uartp->rxstate = UART_RX_IDLE;
     return n;
   }
+#if UART_USE_CIRCULAR_RX == TRUE
+  if (uartp->rxstate == UART_RX_CIRCULAR) {
+    _uart_rx_circular_update(uartp, false);
+    (void) uart_lld_stop_receive(uartp);
+    uartp->rxstate = UART_RX_IDLE;
+    return uartp->rxcwr - uartp->rxcrd;
+  }
+#endif
   return UART_ERR_NOT_ACTIVE;
 }
 
@@ -519,6 +525,233 @@ void uartReleaseBus(UARTDriver *uartp) {
 }
 #endif
 
+#if (UART_USE_CIRCULAR_RX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a continuous receive operation on the UART peripheral.
+ * @details The receiver fills the buffer circularly until the operation is
+ *          stopped using @p uartStopReceive(), the @p rxcirc_cb callback is
+ *          invoked when the first or second half of the buffer is filled
+ *          and when the line becomes idle after a reception.
+ * @note    Received data is consumed using @p uartCircularGetI() and
+ *          @p uartCircularReleaseI() or moved into a buffers queue using
+ *          @p uartCircularToBuffersI().
+ * @note    Only data frames of up to 8 bits are supported.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         size of the circular buffer, at least two frames
+ * @param[in] rxbuf     the pointer to the circular buffer
+ *
+ * @api
+ */
+void uartStartReceiveCircular(UARTDriver *uartp, size_t n, uint8_t *rxbuf) {
+
+  osalSysLock();
+  uartStartReceiveCircularI(uartp, n, rxbuf);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Starts a continuous receive operation on the UART peripheral.
+ * @details The receiver fills the buffer circularly until the operation is
+ *          stopped using @p uartStopReceive(), the @p rxcirc_cb callback is
+ *          invoked when the first or second half of the buffer is filled
+ *          and when the line becomes idle after a reception.
+ * @note    Only data frames of up to 8 bits are supported.
+ * @note    This function has to be invoked from a lock zone.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         size of the circular buffer, at least two frames
+ * @param[in] rxbuf     the pointer to the circular buffer
+ *
+ * @iclass
+ */
+void uartStartReceiveCircularI(UARTDriver *uartp, size_t n, uint8_t *rxbuf) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((uartp != NULL) && (n > 1U) && (rxbuf != NULL));
+  osalDbgAssert(uartp->state == UART_READY, "is active");
+  osalDbgAssert((uartp->rxstate != UART_RX_ACTIVE) &&
+                (uartp->rxstate != UART_RX_CIRCULAR), "rx active");
+
+  uartp->rxcbuf  = rxbuf;
+  uartp->rxcsize = n;
+  uartp->rxcbase = 0U;
+  uartp->rxcwr   = 0U;
+  uartp->rxcrd   = 0U;
+  uartp->rxcrp   = 0U;
+  uart_lld_start_receive_circular(uartp, n, rxbuf);
+  uartp->rxstate = UART_RX_CIRCULAR;
+}
+
+/**
+ * @brief   Returns a pointer to the received data.
+ * @details The data is accessed in place, the returned block is contiguous
+ *          so, when the pending data crosses the end of the buffer, only
+ *          the part before the end is returned and a second call returns
+ *          the remaining part after the block has been released.
+ * @note    The block stays valid as long as the receiver does not complete
+ *          a whole buffer lap over it, a later overrun indication means
+ *          that the data could have been overwritten while in use.
+ * @note    This function has to be invoked from a lock zone.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[out] pp       pointer to a variable receiving the block address
+ *
+ * @return              The size of the contiguous block of received data.
+ * @retval 0            if there is no pending data.
+ * @retval UART_ERR_OVERRUN if the receiver overwrote data not yet consumed,
+ *                      the pending data is discarded and reception goes
+ *                      on from the current position.
+ *
+ * @iclass
+ */
+size_t uartCircularGetI(UARTDriver *uartp, uint8_t **pp) {
+  size_t n;
+
+  osalDbgCheckClassI();
+  osalDbgCheck((uartp != NULL) && (pp != NULL));
+  osalDbgAssert(uartp->rxstate == UART_RX_CIRCULAR, "not circular");
+
+  _uart_rx_circular_update(uartp, false);
+
+  n = uartp->rxcwr - uartp->rxcrd;
+  if (n > uartp->rxcsize) {
+    uartp->rxcrd = uartp->rxcwr;
+    uartp->rxcrp = (uartp->rxcwr - uartp->rxcbase) % uartp->rxcsize;
+    return UART_ERR_OVERRUN;
+  }
+
+  if (n > uartp->rxcsize - uartp->rxcrp) {
+    n = uartp->rxcsize - uartp->rxcrp;
+  }
+  *pp = &uartp->rxcbuf[uartp->rxcrp];
+
+  return n;
+}
+
+/**
+ * @brief   Releases received data.
+ * @details The specified amount of data is marked as consumed, it must not
+ *          exceed the size of the block returned by @p uartCircularGetI().
+ * @note    This function has to be invoked from a lock zone.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         number of data frames consumed
+ *
+ * @iclass
+ */
+void uartCircularReleaseI(UARTDriver *uartp, size_t n) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(uartp != NULL);
+  osalDbgAssert(uartp->rxstate == UART_RX_CIRCULAR, "not circular");
+  osalDbgAssert(n <= uartp->rxcsize - uartp->rxcrp, "out of range");
+
+  uartp->rxcrd += n;
+  uartp->rxcrp += n;
+  if (uartp->rxcrp >= uartp->rxcsize) {
+    uartp->rxcrp = 0U;
+  }
+}
+
+/**
+ * @brief   Moves received data into a buffers queue.
+ * @details Pending data is copied into the empty buffers of the queue, each
+ *          buffer is posted as soon as it is filled or the pending data is
+ *          exhausted. Data not fitting in the queue stays in the circular
+ *          buffer and is moved by a later call.
+ * @note    The function is meant to be invoked from the @p rxcirc_cb
+ *          callback and from the queue notification callback, the idle
+ *          line event posts partially filled buffers so that short
+ *          messages are not delayed.
+ * @note    This function has to be invoked from a lock zone.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ *
+ * @return              The number of data frames moved into the queue.
+ * @retval UART_ERR_OVERRUN if the receiver overwrote data not yet consumed.
+ *
+ * @iclass
+ */
+size_t uartCircularToBuffersI(UARTDriver *uartp,
+                              input_buffers_queue_t *ibqp) {
+  size_t total = 0U;
+
+  osalDbgCheckClassI();
+  osalDbgCheck((uartp != NULL) && (ibqp != NULL));
+
+  while (true) {
+    uint8_t *src, *dst;
+    size_t n, space;
+
+    n = uartCircularGetI(uartp, &src);
+    if (n == UART_ERR_OVERRUN) {
+      return UART_ERR_OVERRUN;
+    }
+    if (n == 0U) {
+      break;
+    }
+
+    dst = ibqGetEmptyBufferI(ibqp);
+    if (dst == NULL) {
+      break;
+    }
+
+    /* The pending data could be split at the end of the circular buffer,
+       the second part is appended to the same queue buffer.*/
+    space = ibqp->bsize - sizeof (size_t);
+    if (n > space) {
+      n = space;
+    }
+    memcpy(dst, src, n);
+    uartCircularReleaseI(uartp, n);
+    if (n < space) {
+      size_t m = uartCircularGetI(uartp, &src);
+      if (m == UART_ERR_OVERRUN) {
+        ibqPostFullBufferI(ibqp, n);
+        return UART_ERR_OVERRUN;
+      }
+      if (m > space - n) {
+        m = space - n;
+      }
+      memcpy(dst + n, src, m);
+      uartCircularReleaseI(uartp, m);
+      n += m;
+    }
+    ibqPostFullBufferI(ibqp, n);
+    total += n;
+  }
+
+  return total;
+}
+
+/**
+ * @brief   Updates the written frames counter in circular receive mode.
+ * @details The counter is derived from the lap base and the receiver
+ *          position. A position behind the last observed one, without a
+ *          wrap indication, means that the buffer wrapped and the full
+ *          event has not yet been served, the counter is then left
+ *          unchanged until the event is processed.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] wrapped   @p true if invoked on a full buffer event
+ *
+ * @notapi
+ */
+void _uart_rx_circular_update(UARTDriver *uartp, bool wrapped) {
+  size_t wr;
+
+  if (wrapped) {
+    uartp->rxcbase += uartp->rxcsize;
+  }
+  wr = uartp->rxcbase + uart_lld_get_receive_position(uartp);
+  if (wrapped || ((size_t)(wr - uartp->rxcwr) <= uartp->rxcsize)) {
+    uartp->rxcwr = wr;
+  }
+}
+#endif /* UART_USE_CIRCULAR_RX == TRUE */
+
 #endif /* HAL_USE_UART == TRUE */
 
 /** @} */
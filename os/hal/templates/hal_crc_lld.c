@@ -0,0 +1,168 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crc_lld.c
+ * @brief   PLATFORM CRC subsystem low level driver source.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_CRC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   CRCD1 driver identifier.
+ */
+#if (PLATFORM_CRC_USE_CRC1 == TRUE) || defined(__DOXYGEN__)
+CRCDriver CRCD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level CRC driver initialization.
+ *
+ * @notapi
+ */
+void crc_lld_init(void) {
+
+#if PLATFORM_CRC_USE_CRC1 == TRUE
+  /* Driver initialization.*/
+  crcObjectInit(&CRCD1);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the CRC peripheral.
+ * @details The peripheral is programmed for the model specified in the
+ *          configuration and the CRC reset to its initial value.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The hardware support for the configured model.
+ * @retval false        if the model is not supported, the high level
+ *                      driver uses the fall-back implementation.
+ * @retval true         if the model is supported.
+ *
+ * @notapi
+ */
+bool crc_lld_start(CRCDriver *crcp) {
+
+  if (crcp->state == CRC_STOP) {
+    /* Enables the peripheral.*/
+#if PLATFORM_CRC_USE_CRC1 == TRUE
+    if (&CRCD1 == crcp) {
+
+    }
+#endif
+  }
+  /* Configures the peripheral.*/
+
+  return false;
+}
+
+/**
+ * @brief   Deactivates the CRC peripheral.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+void crc_lld_stop(CRCDriver *crcp) {
+
+  if (crcp->state == CRC_READY) {
+    /* Resets the peripheral.*/
+
+    /* Disables the peripheral.*/
+#if PLATFORM_CRC_USE_CRC1 == TRUE
+    if (&CRCD1 == crcp) {
+
+    }
+#endif
+  }
+}
+
+/**
+ * @brief   Resets the CRC to the initial value of the model.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+void crc_lld_reset(CRCDriver *crcp) {
+
+  (void)crcp;
+}
+
+/**
+ * @brief   Feeds data to the CRC unit.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] n         number of bytes, it is always greater than zero
+ * @param[in] p         pointer to the data
+ *
+ * @notapi
+ */
+void crc_lld_update(CRCDriver *crcp, size_t n, const uint8_t *p) {
+
+  (void)crcp;
+  (void)n;
+  (void)p;
+}
+
+/**
+ * @brief   Returns the current CRC.
+ * @note    The final XOR is applied by the high level driver.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The CRC before the final XOR.
+ *
+ * @notapi
+ */
+uint32_t crc_lld_get_value(CRCDriver *crcp) {
+
+  (void)crcp;
+
+  return 0U;
+}
+
+#endif /* HAL_USE_CRC == TRUE */
+
+/** @} */
@@ -136,6 +136,16 @@ typedef struct {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the driver capabilities.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The capabilities mask.
+ *
+ * @notapi
+ */
+#define mac_lld_get_capabilities(macp)  0U
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -61,6 +61,13 @@
 #define HAL_USE_CRY                         TRUE
 #endif
 
+/**
+ * @brief   Enables the CRC subsystem.
+ */
+#if !defined(HAL_USE_CRC) || defined(__DOXYGEN__)
+#define HAL_USE_CRC                         TRUE
+#endif
+
 /**
  * @brief   Enables the DAC subsystem.
  */
@@ -274,6 +281,46 @@
 #define HAL_CRY_ENFORCE_FALLBACK            FALSE
 #endif
 
+/**
+ * @brief   Number of key slots, zero disables them.
+ */
+#if !defined(HAL_CRY_KEY_SLOTS) || defined(__DOXYGEN__)
+#define HAL_CRY_KEY_SLOTS                   0
+#endif
+
+/*===========================================================================*/
+/* CRC driver related settings.                                              */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the SW fall-back of the CRC driver.
+ */
+#if !defined(HAL_CRC_USE_FALLBACK) || defined(__DOXYGEN__)
+#define HAL_CRC_USE_FALLBACK                TRUE
+#endif
+
+/**
+ * @brief   Makes the driver forcibly use the fall-back implementation.
+ */
+#if !defined(HAL_CRC_ENFORCE_FALLBACK) || defined(__DOXYGEN__)
+#define HAL_CRC_ENFORCE_FALLBACK            FALSE
+#endif
+
+/**
+ * @brief   Number of lookup tables of the fall-back implementation.
+ */
+#if !defined(HAL_CRC_FALLBACK_SLICES) || defined(__DOXYGEN__)
+#define HAL_CRC_FALLBACK_SLICES             8
+#endif
+
+/**
+ * @brief   Enables the @p crcAcquireBus() and @p crcReleaseBus() APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(CRC_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
+#define CRC_USE_MUTUAL_EXCLUSION            TRUE
+#endif
+
 /*===========================================================================*/
 /* DAC driver related settings.                                              */
 /*===========================================================================*/
@@ -488,6 +535,14 @@
 #define UART_USE_MUTUAL_EXCLUSION           TRUE
 #endif
 
+/**
+ * @brief   Enables the circular receive APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(UART_USE_CIRCULAR_RX) || defined(__DOXYGEN__)
+#define UART_USE_CIRCULAR_RX                FALSE
+#endif
+
 /*===========================================================================*/
 /* USB driver related settings.                                              */
 /*===========================================================================*/
@@ -19,6 +19,9 @@ endif
 ifneq ($(findstring HAL_USE_CRY TRUE,$(HALCONF)),)
 PLATFORMSRC += ${CHIBIOS}/os/hal/templates/hal_crypto_lld.c
 endif
+ifneq ($(findstring HAL_USE_CRC TRUE,$(HALCONF)),)
+PLATFORMSRC += ${CHIBIOS}/os/hal/templates/hal_crc_lld.c
+endif
 ifneq ($(findstring HAL_USE_DAC TRUE,$(HALCONF)),)
 PLATFORMSRC += ${CHIBIOS}/os/hal/templates/hal_dac_lld.c
 endif
@@ -77,6 +80,7 @@ else
 PLATFORMSRC = ${CHIBIOS}/os/hal/templates/hal_lld.c \
               ${CHIBIOS}/os/hal/templates/hal_adc_lld.c \
               ${CHIBIOS}/os/hal/templates/hal_can_lld.c \
+              ${CHIBIOS}/os/hal/templates/hal_crc_lld.c \
               ${CHIBIOS}/os/hal/templates/hal_crypto_lld.c \
               ${CHIBIOS}/os/hal/templates/hal_dac_lld.c \
               ${CHIBIOS}/os/hal/templates/hal_gpt_lld.c \
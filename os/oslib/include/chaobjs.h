@@ -0,0 +1,352 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chaobjs.h
+ * @brief   Active objects macros and structures.
+ *
+ * @addtogroup oslib_active_objects
+ * @{
+ */
+
+#ifndef CHAOBJS_H
+#define CHAOBJS_H
+
+#if !defined(CH_CFG_USE_ACTIVE_OBJECTS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_ACTIVE_OBJECTS           FALSE
+#endif
+
+#if (CH_CFG_USE_ACTIVE_OBJECTS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Reserved signals
+ * @{
+ */
+/**
+ * @brief   State entry signal.
+ */
+#define AO_SIG_ENTRY                        (ao_signal_t)0
+
+/**
+ * @brief   State exit signal.
+ */
+#define AO_SIG_EXIT                         (ao_signal_t)1
+
+/**
+ * @brief   State initial transition signal.
+ */
+#define AO_SIG_INIT                         (ao_signal_t)2
+
+/**
+ * @brief   First signal available to the application.
+ */
+#define AO_SIG_USER                         (ao_signal_t)3
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum states nesting level.
+ * @details This is the maximum number of states that can be entered by a
+ *          single transition, it determines the stack usage of the events
+ *          dispatcher.
+ */
+#if !defined(CH_CFG_AO_MAX_NESTING) || defined(__DOXYGEN__)
+#define CH_CFG_AO_MAX_NESTING               8
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_MEMPOOLS == FALSE
+#error "CH_CFG_USE_ACTIVE_OBJECTS requires CH_CFG_USE_MEMPOOLS"
+#endif
+
+#if CH_CFG_AO_MAX_NESTING < 1
+#error "invalid CH_CFG_AO_MAX_NESTING value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of an event signal.
+ */
+typedef uint32_t ao_signal_t;
+
+/**
+ * @brief   Type of a state handler result.
+ */
+typedef enum {
+  AO_HANDLED = 0,                       /**< Event consumed.                */
+  AO_UNHANDLED = 1,                     /**< Event passed to the parent.    */
+  AO_TRAN = 2                           /**< Transition taken.              */
+} ao_result_t;
+
+/**
+ * @brief   Type of an event object.
+ * @details Application events embed this structure as first field and
+ *          add their parameters after it.
+ */
+typedef struct {
+  ao_signal_t           sig;            /**< @brief Event signal.           */
+  ucnt_t                refs;           /**< @brief Number of references,
+                                                    one for each queue
+                                                    holding the event.      */
+  memory_pool_t         *pool;          /**< @brief Pool owning the event,
+                                                    @p NULL for static
+                                                    events.                 */
+} ao_event_t;
+
+/**
+ * @brief   Type of an active object.
+ */
+typedef struct active_object active_object_t;
+
+/**
+ * @brief   Type of a state handler function.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @param[in] ep        pointer to the event to be processed
+ * @return              The handler result.
+ */
+typedef ao_result_t (*ao_handler_t)(active_object_t *aop,
+                                    const ao_event_t *ep);
+
+/**
+ * @brief   Type of a state.
+ * @details States are constant objects, the hierarchy is described by the
+ *          parent links, top level states have a @p NULL parent.
+ */
+typedef struct ao_state {
+  const struct ao_state *parent;        /**< @brief Enclosing state.        */
+  ao_handler_t          handler;        /**< @brief State handler.          */
+} ao_state_t;
+
+/**
+ * @brief   Type of an active objects scheduler.
+ */
+typedef struct {
+  active_object_t       *ready;         /**< @brief Active objects with
+                                                    pending events, in
+                                                    priority order.         */
+  bool                  stop;           /**< @brief True if stopped.        */
+  threads_queue_t       waiting;        /**< @brief Idle worker threads.    */
+} ao_scheduler_t;
+
+/**
+ * @brief   Structure representing an active object.
+ */
+struct active_object {
+  active_object_t       *next;          /**< @brief Next in the ready list. */
+  ao_scheduler_t        *sched;         /**< @brief Owner scheduler.        */
+  tprio_t               prio;           /**< @brief Priority.               */
+  bool                  busy;           /**< @brief Ready or being
+                                                    dispatched.             */
+  const ao_state_t      *state;         /**< @brief Current leaf state.     */
+  const ao_state_t      *target;        /**< @brief Transition target.      */
+  ao_event_t            **buffer;       /**< @brief Pointer to the events
+                                                    queue buffer.           */
+  ao_event_t            **top;          /**< @brief Pointer to the location
+                                                    after the buffer.       */
+  ao_event_t            **wrptr;        /**< @brief Write pointer.          */
+  ao_event_t            **rdptr;        /**< @brief Read pointer.           */
+  size_t                cnt;            /**< @brief Events in queue.        */
+};
+
+#if defined(_CHIBIOS_RT_) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a time event.
+ * @details Time events are static events posted by a virtual timer.
+ */
+typedef struct {
+  ao_event_t            ev;             /**< @brief Event object.           */
+  active_object_t       *aop;           /**< @brief Recipient.              */
+  sysinterval_t         period;         /**< @brief Period, zero for
+                                                    one-shot events.        */
+  virtual_timer_t       vt;             /**< @brief Virtual timer.          */
+} ao_time_event_t;
+#endif
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Static state initializer.
+ *
+ * @param[in] name      the name of the state variable
+ * @param[in] parent    pointer to the parent state or @p NULL
+ * @param[in] handler   the state handler function
+ */
+#define AO_STATE_DECL(name, parent, handler)                                \
+  const ao_state_t name = {parent, handler}
+
+/**
+ * @brief   Takes a transition.
+ * @details This macro is meant to be used as return value of a state
+ *          handler, the transition is external, all the states up to the
+ *          innermost ancestor of the handling state that also contains the
+ *          target state are exited. If the target state has an initial
+ *          transition then it is followed.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @param[in] s         pointer to the target state
+ * @return              The value @p AO_TRAN.
+ */
+#define chAOTransition(aop, s) ((aop)->target = (s), AO_TRAN)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chAOSchedulerObjectInit(ao_scheduler_t *sp);
+  msg_t chAOSchedulerDispatchTimeout(ao_scheduler_t *sp,
+                                     sysinterval_t timeout);
+  void chAOSchedulerRun(ao_scheduler_t *sp);
+  void chAOSchedulerStopI(ao_scheduler_t *sp);
+  void chAOSchedulerStop(ao_scheduler_t *sp);
+  void chAOObjectInit(active_object_t *aop, ao_scheduler_t *sp, tprio_t prio,
+                      const ao_state_t *initial, ao_event_t **buf, size_t n);
+  void chAOStart(active_object_t *aop);
+  bool chAOIsInState(active_object_t *aop, const ao_state_t *s);
+  msg_t chAOPostI(active_object_t *aop, ao_event_t *ep);
+  msg_t chAOPost(active_object_t *aop, ao_event_t *ep);
+  msg_t chAOPostAheadI(active_object_t *aop, ao_event_t *ep);
+  msg_t chAOPostAhead(active_object_t *aop, ao_event_t *ep);
+  ao_event_t *chAOEventAllocI(memory_pool_t *mp, ao_signal_t sig);
+  ao_event_t *chAOEventAlloc(memory_pool_t *mp, ao_signal_t sig);
+  void chAOEventReleaseI(ao_event_t *ep);
+  void chAOEventRelease(ao_event_t *ep);
+#if defined(_CHIBIOS_RT_) || defined(__DOXYGEN__)
+  void chAOTimeEventObjectInit(ao_time_event_t *tep, active_object_t *aop,
+                               ao_signal_t sig);
+  void chAOTimeEventArmI(ao_time_event_t *tep, sysinterval_t delay,
+                         sysinterval_t period);
+  void chAOTimeEventArm(ao_time_event_t *tep, sysinterval_t delay,
+                        sysinterval_t period);
+  void chAOTimeEventDisarmI(ao_time_event_t *tep);
+  void chAOTimeEventDisarm(ao_time_event_t *tep);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a static event.
+ * @details Static events are never returned to a pool, they can be posted
+ *          again after being processed.
+ *
+ * @param[out] ep       pointer to the @p ao_event_t object
+ * @param[in] sig       the event signal
+ *
+ * @init
+ */
+static inline void chAOEventObjectInit(ao_event_t *ep, ao_signal_t sig) {
+
+  ep->sig  = sig;
+  ep->refs = (ucnt_t)0;
+  ep->pool = NULL;
+}
+
+/**
+ * @brief   Adds a reference to an event.
+ * @details An active object can keep an event beyond the run-to-completion
+ *          step by adding a reference, the event must be released later
+ *          using @p chAOEventRelease().
+ *
+ * @param[in] ep        pointer to the @p ao_event_t object
+ * @return              The event pointer.
+ *
+ * @iclass
+ */
+static inline ao_event_t *chAOEventRefI(ao_event_t *ep) {
+
+  chDbgCheckClassI();
+
+  ep->refs++;
+
+  return ep;
+}
+
+/**
+ * @brief   Returns the current leaf state of an active object.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @return              The current leaf state.
+ *
+ * @xclass
+ */
+static inline const ao_state_t *chAOGetStateX(active_object_t *aop) {
+
+  return aop->state;
+}
+
+/**
+ * @brief   Returns the number of events queued in an active object.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @return              The number of queued events.
+ *
+ * @iclass
+ */
+static inline size_t chAOGetUsedCountI(active_object_t *aop) {
+
+  chDbgCheckClassI();
+
+  return aop->cnt;
+}
+
+#if defined(_CHIBIOS_RT_) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns @p true if the time event is armed.
+ *
+ * @param[in] tep       pointer to the @p ao_time_event_t object
+ * @return              The time event state.
+ *
+ * @iclass
+ */
+static inline bool chAOTimeEventIsArmedI(ao_time_event_t *tep) {
+
+  chDbgCheckClassI();
+
+  return chVTIsArmedI(&tep->vt);
+}
+#endif
+
+#endif /* CH_CFG_USE_ACTIVE_OBJECTS == TRUE */
+
+#endif /* CHAOBJS_H */
+
+/** @} */
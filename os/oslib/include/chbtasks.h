@@ -0,0 +1,182 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chbtasks.h
+ * @brief   Basic tasks macros and structures.
+ *
+ * @addtogroup oslib_basic_tasks
+ * @{
+ */
+
+#ifndef CHBTASKS_H
+#define CHBTASKS_H
+
+#if !defined(CH_CFG_USE_BASIC_TASKS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_BASIC_TASKS              FALSE
+#endif
+
+#if (CH_CFG_USE_BASIC_TASKS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(_CHIBIOS_RT_)
+#error "CH_CFG_USE_BASIC_TASKS requires ChibiOS/RT"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a basic task function.
+ *
+ * @param[in] arg       the task argument
+ */
+typedef void (*bt_function_t)(void *arg);
+
+/**
+ * @brief   Type of a basic task.
+ */
+typedef struct basic_task basic_task_t;
+
+/**
+ * @brief   Type of a preemption level.
+ * @details A preemption level is served by a single thread, all the tasks
+ *          of a level share the stack of that thread.
+ */
+typedef struct {
+  basic_task_t          *ready;         /**< @brief Activated tasks, in
+                                                    priority order.         */
+  basic_task_t          *current;       /**< @brief Task being executed or
+                                                    @p NULL.                */
+  thread_t              *thread;        /**< @brief Thread serving the
+                                                    level or @p NULL.       */
+  thread_reference_t    tr;             /**< @brief Thread waiting for
+                                                    activations.            */
+  tprio_t               threshold;      /**< @brief Preemption threshold.   */
+  bool                  stop;           /**< @brief True if stopped.        */
+} bt_level_t;
+
+/**
+ * @brief   Structure representing a basic task.
+ */
+struct basic_task {
+  basic_task_t          *next;          /**< @brief Next in the ready list. */
+  bt_level_t            *level;         /**< @brief Preemption level.       */
+  tprio_t               prio;           /**< @brief Activation priority.    */
+  ucnt_t                pending;        /**< @brief Pending activations.    */
+  ucnt_t                max;            /**< @brief Maximum pending
+                                                    activations.            */
+  bt_function_t         func;           /**< @brief Task function.          */
+  void                  *arg;           /**< @brief Task argument.          */
+};
+
+/**
+ * @brief   Type of a shared resource.
+ * @details Locking a resource raises the priority of the locking thread
+ *          or task to the resource ceiling.
+ */
+typedef struct {
+  tprio_t               ceiling;        /**< @brief Resource ceiling.       */
+  tprio_t               prio;           /**< @brief Priority of the owner
+                                                    before locking.         */
+  thread_t              *owner;         /**< @brief Owner thread or
+                                                    @p NULL.                */
+} bt_resource_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chBTLevelObjectInit(bt_level_t *lp, tprio_t threshold);
+  void chBTLevelRun(bt_level_t *lp);
+  void chBTLevelStopI(bt_level_t *lp);
+  void chBTLevelStop(bt_level_t *lp);
+  void chBTObjectInit(basic_task_t *btp, bt_level_t *lp, tprio_t prio,
+                      ucnt_t max, bt_function_t func, void *arg);
+  msg_t chBTActivateI(basic_task_t *btp);
+  msg_t chBTActivate(basic_task_t *btp);
+  void chBTResourceObjectInit(bt_resource_t *rp, tprio_t ceiling);
+  void chBTResourceLockS(bt_resource_t *rp);
+  void chBTResourceLock(bt_resource_t *rp);
+  void chBTResourceUnlockS(bt_resource_t *rp);
+  void chBTResourceUnlock(bt_resource_t *rp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the number of pending activations of a task.
+ * @note    The activation being executed is not counted.
+ *
+ * @param[in] btp       pointer to the @p basic_task_t object
+ * @return              The number of pending activations.
+ *
+ * @iclass
+ */
+static inline ucnt_t chBTGetPendingI(basic_task_t *btp) {
+
+  chDbgCheckClassI();
+
+  return btp->pending;
+}
+
+/**
+ * @brief   Returns the task being executed by a preemption level.
+ *
+ * @param[in] lp        pointer to the @p bt_level_t object
+ * @return              Pointer to the task or @p NULL if the level is
+ *                      not executing a task.
+ *
+ * @iclass
+ */
+static inline basic_task_t *chBTGetCurrentI(bt_level_t *lp) {
+
+  chDbgCheckClassI();
+
+  return lp->current;
+}
+
+#endif /* CH_CFG_USE_BASIC_TASKS == TRUE */
+
+#endif /* CHBTASKS_H */
+
+/** @} */
@@ -176,12 +176,22 @@
 #undef CH_CFG_USE_MEMPOOLS
 #undef CH_CFG_USE_OBJ_FIFOS
 #undef CH_CFG_USE_PIPES
+#undef CH_CFG_USE_ACTIVE_OBJECTS
+#undef CH_CFG_USE_REMOTE_MAILBOXES
+#undef CH_CFG_USE_BASIC_TASKS
+#undef CH_CFG_USE_SCHEDULE_TABLES
+#undef CH_CFG_USE_RCU
 
 #define CH_CFG_USE_MEMCORE                  FALSE
 #define CH_CFG_USE_HEAP                     FALSE
 #define CH_CFG_USE_MEMPOOLS                 FALSE
 #define CH_CFG_USE_OBJ_FIFOS                FALSE
 #define CH_CFG_USE_PIPES                    FALSE
+#define CH_CFG_USE_ACTIVE_OBJECTS           FALSE
+#define CH_CFG_USE_REMOTE_MAILBOXES         FALSE
+#define CH_CFG_USE_BASIC_TASKS              FALSE
+#define CH_CFG_USE_SCHEDULE_TABLES          FALSE
+#define CH_CFG_USE_RCU                      FALSE
 
 #endif /* (CH_CUSTOMER_LIC_OSLIB == FALSE) ||
           (CH_LICENSE_FEATURES == CH_FEATURES_BASIC) */
@@ -210,6 +220,11 @@
 #include "chmempools.h"
 #include "chobjfifos.h"
 #include "chpipes.h"
+#include "chrmboxes.h"
+#include "chaobjs.h"
+#include "chbtasks.h"
+#include "chstables.h"
+#include "chrcu.h"
 #include "chfactory.h"
 
 #endif /* CHLIB_H */
@@ -0,0 +1,256 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chrcu.h
+ * @brief   RCU macros and structures.
+ *
+ * @addtogroup oslib_rcu
+ * @{
+ */
+
+#ifndef CHRCU_H
+#define CHRCU_H
+
+#if !defined(CH_CFG_USE_RCU) || defined(__DOXYGEN__)
+#define CH_CFG_USE_RCU                      FALSE
+#endif
+
+#if (CH_CFG_USE_RCU == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Compiler barrier delimiting the read-side critical sections.
+ * @note    The default is the GCC extended asm.
+ */
+#if !defined(CH_CFG_RCU_BARRIER) || defined(__DOXYGEN__)
+#define CH_CFG_RCU_BARRIER()                __asm volatile ("" : : : "memory")
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(_CHIBIOS_RT_)
+#error "CH_CFG_USE_RCU requires ChibiOS/RT"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a reclamation callback header.
+ */
+typedef struct rcu_head rcu_head_t;
+
+/**
+ * @brief   Type of a reclamation callback.
+ *
+ * @param[in] hp        pointer to the @p rcu_head_t embedded in the object
+ *                      to be reclaimed
+ */
+typedef void (*rcu_callback_t)(rcu_head_t *hp);
+
+/**
+ * @brief   Structure representing a reclamation callback header.
+ * @note    The header is meant to be embedded in the reclaimed objects.
+ */
+struct rcu_head {
+  rcu_head_t            *next;          /**< @brief Next in the callbacks
+                                                    list.                   */
+  rcu_callback_t        func;           /**< @brief Reclamation callback.   */
+  ucnt_t                gp;             /**< @brief Grace period to be
+                                                    elapsed.                */
+};
+
+/**
+ * @brief   Type of the RCU state.
+ */
+typedef struct {
+  /**
+   * @brief   Readers preempted in a read-side critical section, for each
+   *          phase.
+   */
+  ucnt_t                blocked[2];
+  /**
+   * @brief   Phase of the readers preempted from now on.
+   */
+  ucnt_t                phase;
+  /**
+   * @brief   Number of started grace periods.
+   */
+  ucnt_t                started;
+  /**
+   * @brief   Number of completed grace periods.
+   */
+  ucnt_t                completed;
+  /**
+   * @brief   Last requested grace period.
+   */
+  ucnt_t                requested;
+  /**
+   * @brief   Threads waiting for a grace period.
+   */
+  threads_queue_t       waiting;
+  /**
+   * @brief   Callbacks waiting for their grace period.
+   */
+  rcu_head_t            *pending;
+  /**
+   * @brief   Last pending callback or @p NULL.
+   */
+  rcu_head_t            *last;
+  /**
+   * @brief   Callbacks whose grace period elapsed.
+   */
+  rcu_head_t            *done;
+} rcu_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Publishes a new version of an RCU protected object.
+ * @details The initialization of the object is completed before the
+ *          pointer is written.
+ *
+ * @param[out] p        the pointer to be assigned
+ * @param[in] v         pointer to the new version
+ *
+ * @xclass
+ */
+#define chRCUAssignPointer(p, v) {                                          \
+  CH_CFG_RCU_BARRIER();                                                     \
+  (p) = (v);                                                                \
+}
+
+/**
+ * @brief   Context switch hook.
+ * @details A reader switched out inside a read-side critical section is
+ *          recorded in the current phase.
+ *
+ * @param[in] ntp       the thread to be switched in
+ * @param[in] otp       the thread to be switched out
+ *
+ * @notapi
+ */
+#define _rcu_switch(ntp, otp) {                                             \
+  (void)(ntp);                                                              \
+  if (((otp)->rcu_nesting > (ucnt_t)0) && !(otp)->rcu_blocked) {            \
+    (otp)->rcu_blocked = true;                                              \
+    (otp)->rcu_phase   = ch_rcu.phase;                                      \
+    ch_rcu.blocked[ch_rcu.phase]++;                                         \
+  }                                                                         \
+}
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern rcu_t ch_rcu;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void _rcu_init(void);
+  void _rcu_unblock(thread_t *tp);
+  void chRCUSynchronize(void);
+  void chRCUCall(rcu_head_t *hp, rcu_callback_t func);
+  void chRCUBarrier(void);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Enters a read-side critical section.
+ * @details The section only updates a counter of the current thread, it
+ *          is wait-free and lock-free. Sections can be nested.
+ * @note    Readers should not block inside a section, a blocked reader
+ *          delays all the grace periods.
+ * @note    Sections can only be used in thread context, the grace periods
+ *          only track the readers switched out by the scheduler.
+ *
+ * @api
+ */
+static inline void chRCUReadLock(void) {
+
+  chDbgAssert(!port_is_isr_context(), "not in thread context");
+
+  chThdGetSelfX()->rcu_nesting++;
+  CH_CFG_RCU_BARRIER();
+}
+
+/**
+ * @brief   Leaves a read-side critical section.
+ * @details If the reader was preempted inside the section then the grace
+ *          period waiting for it is updated.
+ *
+ * @api
+ */
+static inline void chRCUReadUnlock(void) {
+  thread_t *tp = chThdGetSelfX();
+
+  chDbgAssert(!port_is_isr_context(), "not in thread context");
+  chDbgAssert(tp->rcu_nesting > (ucnt_t)0, "not in a read-side section");
+
+  CH_CFG_RCU_BARRIER();
+  tp->rcu_nesting--;
+  CH_CFG_RCU_BARRIER();
+  if ((tp->rcu_nesting == (ucnt_t)0) && tp->rcu_blocked) {
+    _rcu_unblock(tp);
+  }
+}
+
+/**
+ * @brief   Returns @p true if the current thread is inside a read-side
+ *          critical section.
+ * @note    In ISR context the state of the interrupted thread is returned.
+ *
+ * @xclass
+ */
+static inline bool chRCUIsReadingX(void) {
+
+  return (bool)(chThdGetSelfX()->rcu_nesting > (ucnt_t)0);
+}
+
+#else /* CH_CFG_USE_RCU == FALSE */
+
+/* Hook not used.*/
+#define _rcu_switch(ntp, otp)
+
+#endif /* CH_CFG_USE_RCU == TRUE */
+
+#endif /* CHRCU_H */
+
+/** @} */
@@ -0,0 +1,350 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chrmboxes.h
+ * @brief   Remote mailboxes macros and structures.
+ *
+ * @addtogroup oslib_remote_mailboxes
+ * @{
+ */
+
+#ifndef CHRMBOXES_H
+#define CHRMBOXES_H
+
+#if !defined(CH_CFG_USE_REMOTE_MAILBOXES) || defined(__DOXYGEN__)
+#define CH_CFG_USE_REMOTE_MAILBOXES         FALSE
+#endif
+
+#if (CH_CFG_USE_REMOTE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Shared region signature.
+ */
+#define RMB_MAGIC                           0x31424D52U
+
+/**
+ * @name    Remote mailbox sides
+ * @{
+ */
+/**
+ * @brief   Side formatting the shared region.
+ */
+#define RMB_SIDE_A                          0U
+
+/**
+ * @brief   Side connecting to an already formatted shared region.
+ */
+#define RMB_SIDE_B                          1U
+/** @} */
+
+/**
+ * @brief   Size of the header preceding each message in its slot.
+ */
+#define RMB_SLOT_HEADER_SIZE                8U
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Shared memory line size.
+ * @details Indexes written by different sides are placed in distinct lines
+ *          and slots are aligned to lines, this avoids false sharing and
+ *          allows cache maintenance on non-coherent memories. It should be
+ *          the largest cache line size of the cores sharing the region.
+ */
+#if !defined(CH_CFG_RMB_LINE_SIZE) || defined(__DOXYGEN__)
+#define CH_CFG_RMB_LINE_SIZE                32U
+#endif
+
+/**
+ * @brief   Full memory barrier between the cores sharing the region.
+ * @note    The default is the GCC builtin.
+ */
+#if !defined(CH_CFG_RMB_BARRIER) || defined(__DOXYGEN__)
+#define CH_CFG_RMB_BARRIER()                __sync_synchronize()
+#endif
+
+/**
+ * @brief   Writes back a shared memory area to the shared level.
+ * @note    Only required if the region is cached and not coherent.
+ */
+#if !defined(CH_CFG_RMB_CACHE_CLEAN) || defined(__DOXYGEN__)
+#define CH_CFG_RMB_CACHE_CLEAN(p, n)
+#endif
+
+/**
+ * @brief   Discards the local copy of a shared memory area.
+ * @note    Only required if the region is cached and not coherent.
+ */
+#if !defined(CH_CFG_RMB_CACHE_INVALIDATE) || defined(__DOXYGEN__)
+#define CH_CFG_RMB_CACHE_INVALIDATE(p, n)
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (CH_CFG_RMB_LINE_SIZE < 16U) ||                                         \
+    ((CH_CFG_RMB_LINE_SIZE & (CH_CFG_RMB_LINE_SIZE - 1U)) != 0U)
+#error "invalid CH_CFG_RMB_LINE_SIZE value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a remote mailbox.
+ */
+typedef struct remote_mailbox remote_mailbox_t;
+
+/**
+ * @brief   Type of a doorbell function.
+ * @details The function raises an interrupt on the other side, for example
+ *          using an inter-processor interrupt or a mailbox peripheral, the
+ *          other side handler must call @p chRMBDoorbellI().
+ * @note    The function is invoked from within a lock zone.
+ */
+typedef void (*rmbdoorbell_t)(remote_mailbox_t *rmbp, void *arg);
+
+/**
+ * @brief   Type of a shared memory line.
+ * @details Each line is written by one side only.
+ */
+typedef union {
+  struct {
+    volatile uint32_t   index;          /**< @brief Free running slot
+                                                    index.                  */
+    volatile uint32_t   waitseq;        /**< @brief Incremented each time
+                                                    the owner side starts
+                                                    waiting.                */
+  } s;
+  uint8_t               line[CH_CFG_RMB_LINE_SIZE];
+} rmb_line_t;
+
+/**
+ * @brief   Type of a descriptors ring control block.
+ * @details Each ring has a single producer and a single consumer, each on
+ *          a different side.
+ */
+typedef struct {
+  rmb_line_t            prod;           /**< @brief Written by the
+                                                    producer, the index is
+                                                    the next slot to be
+                                                    filled.                 */
+  rmb_line_t            cons;           /**< @brief Written by the
+                                                    consumer, the index is
+                                                    the next slot to be
+                                                    read.                   */
+} rmb_ring_t;
+
+/**
+ * @brief   Type of the shared region header.
+ * @details The header is followed by the slots of the first ring then by
+ *          the slots of the second ring.
+ */
+typedef struct {
+  union {
+    struct {
+      volatile uint32_t magic;          /**< @brief Region signature.       */
+      uint32_t          slots;          /**< @brief Slots in each ring.     */
+      uint32_t          slot_size;      /**< @brief Maximum message size.   */
+    } s;
+    uint8_t             line[CH_CFG_RMB_LINE_SIZE];
+  } hdr;
+  rmb_ring_t            rings[2];       /**< @brief Rings, the first ring
+                                                    goes from side A to side
+                                                    B.                      */
+} rmb_region_t;
+
+/**
+ * @brief   Type of a remote mailbox descriptor.
+ * @details Both sides must use the same region geometry.
+ */
+typedef struct {
+  /**
+   * @brief   Shared region, it must be aligned to @p CH_CFG_RMB_LINE_SIZE
+   *          and @p RMB_REGION_SIZE() bytes large.
+   */
+  void                  *region;
+  /**
+   * @brief   Number of slots in each ring, it must be a power of two.
+   */
+  size_t                slots;
+  /**
+   * @brief   Maximum message size.
+   */
+  size_t                slot_size;
+  /**
+   * @brief   Side of this endpoint, @p RMB_SIDE_A or @p RMB_SIDE_B.
+   */
+  unsigned              side;
+  /**
+   * @brief   Doorbell function notifying the other side.
+   */
+  rmbdoorbell_t         doorbell;
+  /**
+   * @brief   Doorbell function parameter.
+   */
+  void                  *arg;
+} rmb_descriptor_t;
+
+/**
+ * @brief   Structure representing a remote mailbox endpoint.
+ */
+struct remote_mailbox {
+  rmb_region_t          *region;        /**< @brief Shared region.          */
+  rmb_ring_t            *txring;        /**< @brief Outgoing ring.          */
+  rmb_ring_t            *rxring;        /**< @brief Incoming ring.          */
+  uint8_t               *txslots;       /**< @brief Outgoing ring slots.    */
+  uint8_t               *rxslots;       /**< @brief Incoming ring slots.    */
+  uint32_t              slots;          /**< @brief Slots in each ring.     */
+  size_t                slot_size;      /**< @brief Maximum message size.   */
+  size_t                stride;         /**< @brief Distance between
+                                                    slots.                  */
+  unsigned              side;           /**< @brief Endpoint side.          */
+  bool                  connected;      /**< @brief Region connected.       */
+  rmbdoorbell_t         doorbell;       /**< @brief Doorbell function.      */
+  void                  *arg;           /**< @brief Doorbell parameter.     */
+  uint32_t              txhead;         /**< @brief Next slot to be
+                                                    published.              */
+  uint32_t              rxtail;         /**< @brief Next slot to be
+                                                    released.               */
+  uint32_t              txnotified;     /**< @brief Last consumer wait
+                                                    already notified.       */
+  uint32_t              rxnotified;     /**< @brief Last producer wait
+                                                    already notified.       */
+  thread_reference_t    wtr;            /**< @brief Waiting writer.         */
+  thread_reference_t    rtr;            /**< @brief Waiting reader.         */
+#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+  mutex_t               wmtx;           /**< @brief Write access mutex.     */
+  mutex_t               rmtx;           /**< @brief Read access mutex.      */
+#else
+  semaphore_t           wsem;           /**< @brief Write access semaphore. */
+  semaphore_t           rsem;           /**< @brief Read access semaphore.  */
+#endif
+  ucnt_t                n_posted;       /**< @brief Messages posted.        */
+  ucnt_t                n_fetched;      /**< @brief Messages fetched.       */
+  ucnt_t                n_rung;         /**< @brief Doorbells rung.         */
+  ucnt_t                n_doorbells;    /**< @brief Doorbells received.     */
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Distance between slots for the specified message size.
+ *
+ * @param[in] size      maximum message size
+ */
+#define RMB_SLOT_STRIDE(size)                                               \
+  ((((size_t)(size) + (size_t)RMB_SLOT_HEADER_SIZE +                        \
+     (size_t)CH_CFG_RMB_LINE_SIZE) - 1U) &                                  \
+   ~((size_t)CH_CFG_RMB_LINE_SIZE - 1U))
+
+/**
+ * @brief   Size of a shared region.
+ *
+ * @param[in] slots     number of slots in each ring
+ * @param[in] size      maximum message size
+ */
+#define RMB_REGION_SIZE(slots, size)                                        \
+  (sizeof (rmb_region_t) + (2U * (size_t)(slots) * RMB_SLOT_STRIDE(size)))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chRMBObjectInit(remote_mailbox_t *rmbp, const rmb_descriptor_t *dp);
+  msg_t chRMBConnectTimeout(remote_mailbox_t *rmbp, sysinterval_t timeout);
+  msg_t chRMBReserveTimeout(remote_mailbox_t *rmbp, void **pp,
+                            sysinterval_t timeout);
+  void chRMBPublish(remote_mailbox_t *rmbp, size_t n);
+  void chRMBFlush(remote_mailbox_t *rmbp);
+  msg_t chRMBPostTimeout(remote_mailbox_t *rmbp, const void *bp,
+                         size_t n, sysinterval_t timeout);
+  msg_t chRMBFetchSlotTimeout(remote_mailbox_t *rmbp, const void **pp,
+                              size_t *np, sysinterval_t timeout);
+  void chRMBRelease(remote_mailbox_t *rmbp);
+  msg_t chRMBFetchTimeout(remote_mailbox_t *rmbp, void *bp,
+                          size_t *np, sysinterval_t timeout);
+  void chRMBDoorbellI(remote_mailbox_t *rmbp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the maximum message size.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @return              The maximum message size.
+ *
+ * @xclass
+ */
+static inline size_t chRMBGetSlotSizeX(const remote_mailbox_t *rmbp) {
+
+  return rmbp->slot_size;
+}
+
+/**
+ * @brief   Returns the number of incoming messages not yet released.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @return              The number of incoming messages.
+ *
+ * @xclass
+ */
+static inline size_t chRMBGetUsedCountX(const remote_mailbox_t *rmbp) {
+
+  return (size_t)(rmbp->rxring->prod.s.index - rmbp->rxtail);
+}
+
+/**
+ * @brief   Returns the number of outgoing slots not yet released by the
+ *          other side.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @return              The number of outgoing slots in use.
+ *
+ * @xclass
+ */
+static inline size_t chRMBGetPendingCountX(const remote_mailbox_t *rmbp) {
+
+  return (size_t)(rmbp->txhead - rmbp->txring->cons.s.index);
+}
+
+#endif /* CH_CFG_USE_REMOTE_MAILBOXES == TRUE */
+
+#endif /* CHRMBOXES_H */
+
+/** @} */
@@ -0,0 +1,293 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chstables.h
+ * @brief   Schedule tables macros and structures.
+ *
+ * @addtogroup oslib_schedule_tables
+ * @{
+ */
+
+#ifndef CHSTABLES_H
+#define CHSTABLES_H
+
+#if !defined(CH_CFG_USE_SCHEDULE_TABLES) || defined(__DOXYGEN__)
+#define CH_CFG_USE_SCHEDULE_TABLES          FALSE
+#endif
+
+#if (CH_CFG_USE_SCHEDULE_TABLES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(_CHIBIOS_RT_)
+#error "CH_CFG_USE_SCHEDULE_TABLES requires ChibiOS/RT"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of an expiry point action.
+ */
+typedef enum {
+  ST_ACTION_CALLBACK = 0,               /**< Calls a function.              */
+  ST_ACTION_RESUME = 1,                 /**< Resumes a thread reference.    */
+  ST_ACTION_BROADCAST = 2,              /**< Broadcasts an event source.    */
+  ST_ACTION_TASK = 3                    /**< Activates a basic task.        */
+} st_action_t;
+
+/**
+ * @brief   Type of a timeline state.
+ */
+typedef enum {
+  ST_STOPPED = 0,                       /**< Not running.                   */
+  ST_WAITING = 1,                       /**< Waiting for the first
+                                             synchronization.               */
+  ST_RUNNING = 2,                       /**< Running, not synchronous.      */
+  ST_RUNNING_SYNC = 3                   /**< Running and synchronous.       */
+} st_state_t;
+
+/**
+ * @brief   Type of an expiry point callback.
+ * @note    Callbacks are invoked from the timer callback with the kernel
+ *          locked, only I-class functions can be used.
+ *
+ * @param[in] arg       the callback argument
+ */
+typedef void (*st_callback_t)(void *arg);
+
+/**
+ * @brief   Type of an expiry point.
+ * @note    Expiry points are meant to be constant, use the
+ *          @p ST_CALLBACK(), @p ST_RESUME(), @p ST_BROADCAST() and
+ *          @p ST_TASK() macros in order to initialize them.
+ */
+typedef struct {
+  sysinterval_t         offset;         /**< @brief Offset from the table
+                                                    start.                  */
+  st_action_t           action;         /**< @brief Action to be taken.     */
+  st_callback_t         func;           /**< @brief Callback function.      */
+  void                  *target;        /**< @brief Callback argument or
+                                                    action target.          */
+  msg_t                 value;          /**< @brief Resume message or
+                                                    broadcast flags.        */
+} st_expiry_t;
+
+/**
+ * @brief   Type of a schedule table.
+ * @note    Tables are meant to be constant, use the @p ST_TABLE() macro
+ *          in order to initialize them.
+ */
+typedef struct {
+  const st_expiry_t     *points;        /**< @brief Expiry points ordered
+                                                    by offset.              */
+  size_t                n;              /**< @brief Number of expiry
+                                                    points.                 */
+  sysinterval_t         duration;       /**< @brief Table duration.         */
+  bool                  repeating;      /**< @brief Table restarted at the
+                                                    end of each cycle.      */
+  sysinterval_t         precision;      /**< @brief Maximum deviation of a
+                                                    synchronous table.      */
+  sysinterval_t         max_adjust;     /**< @brief Maximum correction for
+                                                    each alarm, zero for
+                                                    immediate corrections.  */
+} st_table_t;
+
+/**
+ * @brief   Type of a timeline.
+ * @details A timeline runs a schedule table at a time using a single
+ *          virtual timer.
+ */
+typedef struct {
+  virtual_timer_t       vt;             /**< @brief Timeline alarm.         */
+  const st_table_t      *table;         /**< @brief Running table or
+                                                    @p NULL.                */
+  const st_table_t      *next;          /**< @brief Table started at the
+                                                    end of the cycle or
+                                                    @p NULL.                */
+  st_state_t            state;          /**< @brief Timeline state.         */
+  size_t                index;          /**< @brief Next expiry point.      */
+  systime_t             start;          /**< @brief Start time of the
+                                                    current cycle.          */
+  systime_t             time;           /**< @brief Time of the next
+                                                    expiry point.           */
+  sysinterval_t         deviation;      /**< @brief Deviation still to be
+                                                    corrected.              */
+  bool                  retard;         /**< @brief Deviation direction,
+                                                    true if ahead of the
+                                                    time base.              */
+  bool                  synced;         /**< @brief Synchronized to the
+                                                    time base.              */
+} st_timeline_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Expiry points initializers
+ * @{
+ */
+/**
+ * @brief   Expiry point calling a function.
+ *
+ * @param[in] offset    offset from the table start
+ * @param[in] func      the @p st_callback_t function
+ * @param[in] arg       the callback argument
+ */
+#define ST_CALLBACK(offset, func, arg)                                      \
+  {(sysinterval_t)(offset), ST_ACTION_CALLBACK, (func), (void *)(arg),      \
+   (msg_t)0}
+
+/**
+ * @brief   Expiry point resuming a thread reference.
+ *
+ * @param[in] offset    offset from the table start
+ * @param[in] trp       pointer to the @p thread_reference_t variable
+ * @param[in] msg       the message returned to the resumed thread
+ */
+#define ST_RESUME(offset, trp, msg)                                         \
+  {(sysinterval_t)(offset), ST_ACTION_RESUME, NULL, (void *)(trp),          \
+   (msg_t)(msg)}
+
+/**
+ * @brief   Expiry point broadcasting an event source.
+ *
+ * @param[in] offset    offset from the table start
+ * @param[in] esp       pointer to the @p event_source_t object
+ * @param[in] flags     the flags to be broadcasted
+ */
+#define ST_BROADCAST(offset, esp, flags)                                    \
+  {(sysinterval_t)(offset), ST_ACTION_BROADCAST, NULL, (void *)(esp),       \
+   (msg_t)(flags)}
+
+/**
+ * @brief   Expiry point activating a basic task.
+ *
+ * @param[in] offset    offset from the table start
+ * @param[in] btp       pointer to the @p basic_task_t object
+ */
+#define ST_TASK(offset, btp)                                                \
+  {(sysinterval_t)(offset), ST_ACTION_TASK, NULL, (void *)(btp), (msg_t)0}
+/** @} */
+
+/**
+ * @brief   Schedule table initializer.
+ * @note    The expiry points must be ordered by offset, points with equal
+ *          offsets are processed in array order.
+ *
+ * @param[in] points    array of @p st_expiry_t
+ * @param[in] duration  table duration, greater than all the offsets
+ * @param[in] repeating true if the table is restarted at the end of each
+ *                      cycle
+ * @param[in] precision maximum deviation of a synchronous table
+ * @param[in] max_adjust maximum correction for each alarm, zero for
+ *                      immediate corrections
+ */
+#define ST_TABLE(points, duration, repeating, precision, max_adjust)       \
+  {(points), sizeof (points) / sizeof (points)[0],                          \
+   (sysinterval_t)(duration), (repeating), (sysinterval_t)(precision),      \
+   (sysinterval_t)(max_adjust)}
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chSTObjectInit(st_timeline_t *stp);
+  void chSTStartRelI(st_timeline_t *stp, const st_table_t *tp,
+                     sysinterval_t delay);
+  void chSTStartRel(st_timeline_t *stp, const st_table_t *tp,
+                    sysinterval_t delay);
+  void chSTStartAbsI(st_timeline_t *stp, const st_table_t *tp,
+                     systime_t time);
+  void chSTStartAbs(st_timeline_t *stp, const st_table_t *tp,
+                    systime_t time);
+  void chSTStartSyncI(st_timeline_t *stp, const st_table_t *tp);
+  void chSTStartSync(st_timeline_t *stp, const st_table_t *tp);
+  void chSTNextI(st_timeline_t *stp, const st_table_t *tp);
+  void chSTNext(st_timeline_t *stp, const st_table_t *tp);
+  void chSTStopI(st_timeline_t *stp);
+  void chSTStop(st_timeline_t *stp);
+  void chSTSyncI(st_timeline_t *stp, sysinterval_t value);
+  void chSTSync(st_timeline_t *stp, sysinterval_t value);
+  void chSTSetAsyncI(st_timeline_t *stp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the state of a timeline.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @return              The timeline state.
+ *
+ * @iclass
+ */
+static inline st_state_t chSTGetStateI(st_timeline_t *stp) {
+
+  chDbgCheckClassI();
+
+  if ((stp->state == ST_RUNNING) && stp->synced &&
+      (stp->deviation <= stp->table->precision)) {
+    return ST_RUNNING_SYNC;
+  }
+
+  return stp->state;
+}
+
+/**
+ * @brief   Returns the table running on a timeline.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @return              Pointer to the table or @p NULL if the timeline
+ *                      is stopped.
+ *
+ * @iclass
+ */
+static inline const st_table_t *chSTGetTableI(st_timeline_t *stp) {
+
+  chDbgCheckClassI();
+
+  return stp->table;
+}
+
+#endif /* CH_CFG_USE_SCHEDULE_TABLES == TRUE */
+
+#endif /* CHSTABLES_H */
+
+/** @} */
@@ -29,6 +29,21 @@ endif
 ifneq ($(findstring CH_CFG_USE_PIPES TRUE,$(CHLIBCONF)),)
 LIBSRC += $(CHIBIOS)/os/oslib/src/chpipes.c
 endif
+ifneq ($(findstring CH_CFG_USE_ACTIVE_OBJECTS TRUE,$(CHLIBCONF)),)
+LIBSRC += $(CHIBIOS)/os/oslib/src/chaobjs.c
+endif
+ifneq ($(findstring CH_CFG_USE_REMOTE_MAILBOXES TRUE,$(CHLIBCONF)),)
+LIBSRC += $(CHIBIOS)/os/oslib/src/chrmboxes.c
+endif
+ifneq ($(findstring CH_CFG_USE_BASIC_TASKS TRUE,$(CHLIBCONF)),)
+LIBSRC += $(CHIBIOS)/os/oslib/src/chbtasks.c
+endif
+ifneq ($(findstring CH_CFG_USE_SCHEDULE_TABLES TRUE,$(CHLIBCONF)),)
+LIBSRC += $(CHIBIOS)/os/oslib/src/chstables.c
+endif
+ifneq ($(findstring CH_CFG_USE_RCU TRUE,$(CHLIBCONF)),)
+LIBSRC += $(CHIBIOS)/os/oslib/src/chrcu.c
+endif
 ifneq ($(findstring CH_CFG_USE_FACTORY TRUE,$(CHLIBCONF)),)
 LIBSRC += $(CHIBIOS)/os/oslib/src/chfactory.c
 endif
@@ -38,6 +53,11 @@ LIBSRC := $(CHIBIOS)/os/oslib/src/chmboxes.c \
           $(CHIBIOS)/os/oslib/src/chmemheaps.c \
           $(CHIBIOS)/os/oslib/src/chmempools.c \
           $(CHIBIOS)/os/oslib/src/chpipes.c \
+          $(CHIBIOS)/os/oslib/src/chaobjs.c \
+          $(CHIBIOS)/os/oslib/src/chrmboxes.c \
+          $(CHIBIOS)/os/oslib/src/chbtasks.c \
+          $(CHIBIOS)/os/oslib/src/chstables.c \
+          $(CHIBIOS)/os/oslib/src/chrcu.c \
           $(CHIBIOS)/os/oslib/src/chfactory.c
 endif
 
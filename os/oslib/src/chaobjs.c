@@ -0,0 +1,798 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chaobjs.c
+ * @brief   Active objects code.
+ *
+ * @addtogroup oslib_active_objects
+ * @details Event-driven active objects.
+ *          <h2>Operation mode</h2>
+ *          An active object is a hierarchical state machine with its own
+ *          events queue, active objects do not own a thread, they are
+ *          executed by one or more worker threads running a scheduler.<br>
+ *          - <b>States</b>: States are constant objects linked to their
+ *            parent state, each state has an handler receiving the events,
+ *            events not handled by a state are passed to the parent state.
+ *            Entry, exit and initial transition actions are executed by
+ *            the handlers when receiving the reserved signals
+ *            @p AO_SIG_ENTRY, @p AO_SIG_EXIT and @p AO_SIG_INIT.
+ *          - <b>Run to completion</b>: An event is completely processed,
+ *            transitions included, before the next event is fetched from
+ *            the queue of the same active object, an active object is never
+ *            executed by two workers at the same time.
+ *          - <b>Events</b>: Events are either static or allocated from
+ *            memory pools, pool events are reference counted and returned
+ *            to their pool after the last recipient processed them, the
+ *            same event can be posted to multiple active objects.
+ *          - <b>Queues</b>: Events are posted in FIFO order or ahead of the
+ *            other queued events, posting never blocks and fails if the
+ *            queue is full.
+ *          - <b>Scheduling</b>: Active objects with queued events are
+ *            served one event at time in priority order, active objects
+ *            with the same priority are served round-robin.
+ *          - <b>Time events</b>: One-shot or periodic static events posted
+ *            by a virtual timer, RT only.
+ *          .
+ * @pre     In order to use the active objects APIs the
+ *          @p CH_CFG_USE_ACTIVE_OBJECTS option must be enabled in
+ *          @p chconf.h.
+ * @note    Compatible with RT and NIL.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_ACTIVE_OBJECTS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Reserved events.
+ */
+static const ao_event_t ao_reserved_events[] = {
+  {AO_SIG_ENTRY, (ucnt_t)0, NULL},
+  {AO_SIG_EXIT,  (ucnt_t)0, NULL},
+  {AO_SIG_INIT,  (ucnt_t)0, NULL}
+};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Sends a reserved signal to a state.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @param[in] s         pointer to the state
+ * @param[in] sig       the reserved signal
+ * @return              The handler result.
+ */
+static ao_result_t ao_trig(active_object_t *aop,
+                           const ao_state_t *s,
+                           ao_signal_t sig) {
+
+  return s->handler(aop, &ao_reserved_events[sig]);
+}
+
+/**
+ * @brief   Checks if a state contains another state.
+ *
+ * @param[in] ancestor  pointer to the containing state, @p NULL represents
+ *                      the top of the hierarchy
+ * @param[in] s         pointer to the contained state
+ * @return              The test result.
+ * @retval true         if @p s is @p ancestor or one of its substates.
+ * @retval false        otherwise.
+ */
+static bool ao_contains(const ao_state_t *ancestor, const ao_state_t *s) {
+
+  while (s != NULL) {
+    if (s == ancestor) {
+      return true;
+    }
+    s = s->parent;
+  }
+
+  return ancestor == NULL;
+}
+
+/**
+ * @brief   Enters the states from a containing state down to a target.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @param[in] from      pointer to the containing state, not entered
+ * @param[in] to        pointer to the target state
+ */
+static void ao_enter(active_object_t *aop,
+                     const ao_state_t *from,
+                     const ao_state_t *to) {
+  const ao_state_t *path[CH_CFG_AO_MAX_NESTING];
+  unsigned n = 0U;
+
+  while (to != from) {
+    chDbgAssert(n < (unsigned)CH_CFG_AO_MAX_NESTING, "nesting too deep");
+
+    path[n++] = to;
+    to = to->parent;
+  }
+
+  while (n > 0U) {
+    n--;
+    (void) ao_trig(aop, path[n], AO_SIG_ENTRY);
+  }
+}
+
+/**
+ * @brief   Follows the initial transitions starting from a state.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @param[in] s         pointer to the entered state
+ */
+static void ao_init(active_object_t *aop, const ao_state_t *s) {
+
+  while (ao_trig(aop, s, AO_SIG_INIT) == AO_TRAN) {
+    chDbgAssert((aop->target != s) && ao_contains(s, aop->target),
+                "initial transition to a non-substate");
+
+    ao_enter(aop, s, aop->target);
+    s = aop->target;
+  }
+
+  aop->state = s;
+}
+
+/**
+ * @brief   Processes an event.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @param[in] ep        pointer to the event
+ */
+static void ao_dispatch(active_object_t *aop, const ao_event_t *ep) {
+  const ao_state_t *s, *target, *lca;
+  ao_result_t res;
+
+  /* Searching for an handler starting from the leaf state.*/
+  s = aop->state;
+  do {
+    res = s->handler(aop, ep);
+    if (res == AO_HANDLED) {
+      return;
+    }
+    if (res == AO_TRAN) {
+      break;
+    }
+    s = s->parent;
+  } while (s != NULL);
+
+  /* Unhandled events are discarded.*/
+  if (s == NULL) {
+    return;
+  }
+
+  /* Innermost ancestor of the source state containing the target.*/
+  target = aop->target;
+  lca = s->parent;
+  while (!ao_contains(lca, target)) {
+    lca = lca->parent;
+  }
+
+  /* Exiting from the current leaf state up to the common ancestor.*/
+  s = aop->state;
+  while (s != lca) {
+    (void) ao_trig(aop, s, AO_SIG_EXIT);
+    s = s->parent;
+  }
+
+  /* Entering the target state and following initial transitions.*/
+  ao_enter(aop, lca, target);
+  ao_init(aop, target);
+}
+
+/**
+ * @brief   Inserts an active object in the scheduler ready list.
+ * @details Active objects are ordered by priority, an active object is
+ *          inserted after the ones with the same priority.
+ *
+ * @param[in] sp        pointer to the @p ao_scheduler_t object
+ * @param[in] aop       pointer to the @p active_object_t object
+ */
+static void ao_ready_insert(ao_scheduler_t *sp, active_object_t *aop) {
+  active_object_t **app = &sp->ready;
+
+  while ((*app != NULL) && ((*app)->prio >= aop->prio)) {
+    app = &(*app)->next;
+  }
+  aop->next = *app;
+  *app = aop;
+}
+
+/**
+ * @brief   Makes an active object ready after an event has been queued.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @param[in] ep        pointer to the queued event
+ */
+static void ao_queued(active_object_t *aop, ao_event_t *ep) {
+
+  ep->refs++;
+  aop->cnt++;
+
+  if (!aop->busy) {
+    aop->busy = true;
+    ao_ready_insert(aop->sched, aop);
+    chThdDequeueNextI(&aop->sched->waiting, MSG_OK);
+  }
+}
+
+#if defined(_CHIBIOS_RT_) || defined(__DOXYGEN__)
+/**
+ * @brief   Time events timer callback.
+ *
+ * @param[in] p         pointer to the @p ao_time_event_t object
+ */
+static void ao_time_event_cb(void *p) {
+  ao_time_event_t *tep = (ao_time_event_t *)p;
+
+  chSysLockFromISR();
+  if (tep->period > (sysinterval_t)0) {
+    chVTDoSetI(&tep->vt, tep->period, ao_time_event_cb, p);
+  }
+  (void) chAOPostI(tep->aop, &tep->ev);
+  chSysUnlockFromISR();
+}
+#endif
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p ao_scheduler_t object.
+ *
+ * @param[out] sp       pointer to the @p ao_scheduler_t object
+ *
+ * @init
+ */
+void chAOSchedulerObjectInit(ao_scheduler_t *sp) {
+
+  chDbgCheck(sp != NULL);
+
+  sp->ready = NULL;
+  sp->stop  = false;
+  chThdQueueObjectInit(&sp->waiting);
+}
+
+/**
+ * @brief   Processes one event.
+ * @details The first event of the highest priority ready active object
+ *          is dispatched, if there are no ready active objects then the
+ *          function waits for an event to be posted.
+ * @note    Multiple threads can invoke this function on the same
+ *          scheduler.
+ *
+ * @param[in] sp        pointer to the @p ao_scheduler_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if an event has been processed.
+ * @retval MSG_RESET    if the scheduler has been stopped.
+ * @retval MSG_TIMEOUT  if no event has been posted within the specified
+ *                      timeout.
+ *
+ * @api
+ */
+msg_t chAOSchedulerDispatchTimeout(ao_scheduler_t *sp,
+                                   sysinterval_t timeout) {
+  active_object_t *aop;
+  ao_event_t *ep;
+
+  chDbgCheck(sp != NULL);
+
+  chSysLock();
+  while (true) {
+    msg_t msg;
+
+    if (sp->stop) {
+      chSysUnlock();
+      return MSG_RESET;
+    }
+
+    aop = sp->ready;
+    if (aop != NULL) {
+      break;
+    }
+
+    msg = chThdEnqueueTimeoutS(&sp->waiting, timeout);
+    if (msg != MSG_OK) {
+      chSysUnlock();
+      return msg;
+    }
+  }
+
+  /* Removing the active object from the ready list, it is not inserted
+     again until the event has been processed.*/
+  sp->ready = aop->next;
+  ep = *aop->rdptr++;
+  if (aop->rdptr >= aop->top) {
+    aop->rdptr = aop->buffer;
+  }
+  aop->cnt--;
+  chSysUnlock();
+
+  ao_dispatch(aop, ep);
+
+  chSysLock();
+  chAOEventReleaseI(ep);
+  if (aop->cnt > (size_t)0) {
+    ao_ready_insert(sp, aop);
+  }
+  else {
+    aop->busy = false;
+  }
+  chSysUnlock();
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Runs a scheduler.
+ * @details Events are processed until the scheduler is stopped, this
+ *          function is meant to be the body of one or more worker threads.
+ *
+ * @param[in] sp        pointer to the @p ao_scheduler_t object
+ *
+ * @api
+ */
+void chAOSchedulerRun(ao_scheduler_t *sp) {
+
+  while (chAOSchedulerDispatchTimeout(sp, TIME_INFINITE) == MSG_OK) {
+  }
+}
+
+/**
+ * @brief   Stops a scheduler.
+ * @details The waiting workers are resumed with status @p MSG_RESET, the
+ *          workers currently processing an event terminate their
+ *          run-to-completion step first. Queued events are not lost.
+ *
+ * @param[in] sp        pointer to the @p ao_scheduler_t object
+ *
+ * @iclass
+ */
+void chAOSchedulerStopI(ao_scheduler_t *sp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(sp != NULL);
+
+  sp->stop = true;
+  chThdDequeueAllI(&sp->waiting, MSG_RESET);
+}
+
+/**
+ * @brief   Stops a scheduler.
+ * @details The waiting workers are resumed with status @p MSG_RESET, the
+ *          workers currently processing an event terminate their
+ *          run-to-completion step first. Queued events are not lost.
+ *
+ * @param[in] sp        pointer to the @p ao_scheduler_t object
+ *
+ * @api
+ */
+void chAOSchedulerStop(ao_scheduler_t *sp) {
+
+  chSysLock();
+  chAOSchedulerStopI(sp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Initializes an @p active_object_t object.
+ *
+ * @param[out] aop      pointer to the @p active_object_t object
+ * @param[in] sp        pointer to the scheduler running the active object
+ * @param[in] prio      the active object priority
+ * @param[in] initial   pointer to the initial state
+ * @param[in] buf       pointer to the events queue buffer
+ * @param[in] n         number of elements in the buffer array
+ *
+ * @init
+ */
+void chAOObjectInit(active_object_t *aop, ao_scheduler_t *sp, tprio_t prio,
+                    const ao_state_t *initial, ao_event_t **buf, size_t n) {
+
+  chDbgCheck((aop != NULL) && (sp != NULL) && (initial != NULL) &&
+             (buf != NULL) && (n > (size_t)0));
+
+  aop->next   = NULL;
+  aop->sched  = sp;
+  aop->prio   = prio;
+  aop->busy   = false;
+  aop->state  = NULL;
+  aop->target = initial;
+  aop->buffer = buf;
+  aop->top    = &buf[n];
+  aop->wrptr  = buf;
+  aop->rdptr  = buf;
+  aop->cnt    = (size_t)0;
+}
+
+/**
+ * @brief   Starts an active object.
+ * @details The initial state is entered and its initial transitions are
+ *          followed, the actions are executed in the context of the
+ *          caller.
+ * @pre     No events can be posted to the active object before it has
+ *          been started.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ *
+ * @api
+ */
+void chAOStart(active_object_t *aop) {
+  const ao_state_t *initial;
+
+  chDbgCheck(aop != NULL);
+  chDbgAssert(aop->state == NULL, "already started");
+
+  initial = aop->target;
+  ao_enter(aop, NULL, initial);
+  ao_init(aop, initial);
+}
+
+/**
+ * @brief   Checks if an active object is in a state.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @param[in] s         pointer to the state
+ * @return              The test result.
+ * @retval true         if the current leaf state is @p s or one of its
+ *                      substates.
+ * @retval false        otherwise.
+ *
+ * @api
+ */
+bool chAOIsInState(active_object_t *aop, const ao_state_t *s) {
+
+  chDbgCheck((aop != NULL) && (s != NULL));
+
+  return ao_contains(s, aop->state);
+}
+
+/**
+ * @brief   Posts an event to an active object.
+ * @details The event is queued in FIFO order.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @param[in] ep        pointer to the event
+ * @return              The operation status.
+ * @retval MSG_OK       if the event has been queued.
+ * @retval MSG_TIMEOUT  if the queue is full, the event is not referenced.
+ *
+ * @iclass
+ */
+msg_t chAOPostI(active_object_t *aop, ao_event_t *ep) {
+
+  chDbgCheckClassI();
+  chDbgCheck((aop != NULL) && (ep != NULL));
+  chDbgAssert(aop->state != NULL, "not started");
+
+  if (aop->cnt >= (size_t)(aop->top - aop->buffer)) {
+    return MSG_TIMEOUT;
+  }
+
+  *aop->wrptr++ = ep;
+  if (aop->wrptr >= aop->top) {
+    aop->wrptr = aop->buffer;
+  }
+  ao_queued(aop, ep);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Posts an event to an active object.
+ * @details The event is queued in FIFO order.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @param[in] ep        pointer to the event
+ * @return              The operation status.
+ * @retval MSG_OK       if the event has been queued.
+ * @retval MSG_TIMEOUT  if the queue is full, the event is not referenced.
+ *
+ * @api
+ */
+msg_t chAOPost(active_object_t *aop, ao_event_t *ep) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chAOPostI(aop, ep);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Posts an high priority event to an active object.
+ * @details The event is queued ahead of the other queued events.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @param[in] ep        pointer to the event
+ * @return              The operation status.
+ * @retval MSG_OK       if the event has been queued.
+ * @retval MSG_TIMEOUT  if the queue is full, the event is not referenced.
+ *
+ * @iclass
+ */
+msg_t chAOPostAheadI(active_object_t *aop, ao_event_t *ep) {
+
+  chDbgCheckClassI();
+  chDbgCheck((aop != NULL) && (ep != NULL));
+  chDbgAssert(aop->state != NULL, "not started");
+
+  if (aop->cnt >= (size_t)(aop->top - aop->buffer)) {
+    return MSG_TIMEOUT;
+  }
+
+  if (--aop->rdptr < aop->buffer) {
+    aop->rdptr = aop->top - 1;
+  }
+  *aop->rdptr = ep;
+  ao_queued(aop, ep);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Posts an high priority event to an active object.
+ * @details The event is queued ahead of the other queued events.
+ *
+ * @param[in] aop       pointer to the @p active_object_t object
+ * @param[in] ep        pointer to the event
+ * @return              The operation status.
+ * @retval MSG_OK       if the event has been queued.
+ * @retval MSG_TIMEOUT  if the queue is full, the event is not referenced.
+ *
+ * @api
+ */
+msg_t chAOPostAhead(active_object_t *aop, ao_event_t *ep) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chAOPostAheadI(aop, ep);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Allocates an event from a memory pool.
+ * @details The event is returned to the pool when the last active object
+ *          it has been posted to has processed it.
+ * @note    The objects size of the pool must be at least
+ *          @p sizeof(ao_event_t).
+ *
+ * @param[in] mp        pointer to the @p memory_pool_t object
+ * @param[in] sig       the event signal
+ * @return              The pointer to the allocated event.
+ * @retval NULL         if the pool is empty.
+ *
+ * @iclass
+ */
+ao_event_t *chAOEventAllocI(memory_pool_t *mp, ao_signal_t sig) {
+  ao_event_t *ep;
+
+  chDbgCheckClassI();
+  chDbgCheck((mp != NULL) && (mp->object_size >= sizeof (ao_event_t)));
+
+  ep = (ao_event_t *)chPoolAllocI(mp);
+  if (ep != NULL) {
+    ep->sig  = sig;
+    ep->refs = (ucnt_t)0;
+    ep->pool = mp;
+  }
+
+  return ep;
+}
+
+/**
+ * @brief   Allocates an event from a memory pool.
+ * @details The event is returned to the pool when the last active object
+ *          it has been posted to has processed it.
+ * @note    The objects size of the pool must be at least
+ *          @p sizeof(ao_event_t).
+ *
+ * @param[in] mp        pointer to the @p memory_pool_t object
+ * @param[in] sig       the event signal
+ * @return              The pointer to the allocated event.
+ * @retval NULL         if the pool is empty.
+ *
+ * @api
+ */
+ao_event_t *chAOEventAlloc(memory_pool_t *mp, ao_signal_t sig) {
+  ao_event_t *ep;
+
+  chSysLock();
+  ep = chAOEventAllocI(mp, sig);
+  chSysUnlock();
+
+  return ep;
+}
+
+/**
+ * @brief   Releases a reference to an event.
+ * @details Pool events are returned to their pool when there are no more
+ *          references, this function can also be used to free an event
+ *          that has never been successfully posted.
+ *
+ * @param[in] ep        pointer to the @p ao_event_t object
+ *
+ * @iclass
+ */
+void chAOEventReleaseI(ao_event_t *ep) {
+
+  chDbgCheckClassI();
+  chDbgCheck(ep != NULL);
+
+  if (ep->refs > (ucnt_t)0) {
+    ep->refs--;
+  }
+
+  if ((ep->refs == (ucnt_t)0) && (ep->pool != NULL)) {
+    chPoolFreeI(ep->pool, (void *)ep);
+  }
+}
+
+/**
+ * @brief   Releases a reference to an event.
+ * @details Pool events are returned to their pool when there are no more
+ *          references, this function can also be used to free an event
+ *          that has never been successfully posted.
+ *
+ * @param[in] ep        pointer to the @p ao_event_t object
+ *
+ * @api
+ */
+void chAOEventRelease(ao_event_t *ep) {
+
+  chSysLock();
+  chAOEventReleaseI(ep);
+  chSysUnlock();
+}
+
+#if defined(_CHIBIOS_RT_) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes an @p ao_time_event_t object.
+ *
+ * @param[out] tep      pointer to the @p ao_time_event_t object
+ * @param[in] aop       pointer to the recipient active object
+ * @param[in] sig       the event signal
+ *
+ * @init
+ */
+void chAOTimeEventObjectInit(ao_time_event_t *tep, active_object_t *aop,
+                             ao_signal_t sig) {
+
+  chDbgCheck((tep != NULL) && (aop != NULL));
+
+  chAOEventObjectInit(&tep->ev, sig);
+  tep->aop    = aop;
+  tep->period = (sysinterval_t)0;
+  chVTObjectInit(&tep->vt);
+}
+
+/**
+ * @brief   Arms a time event.
+ * @details If the time event is already armed then it is re-armed.
+ * @note    If the queue of the recipient is full when the time expires
+ *          then the event is lost.
+ *
+ * @param[in] tep       pointer to the @p ao_time_event_t object
+ * @param[in] delay     delay before the first event, it cannot be
+ *                      @p TIME_IMMEDIATE
+ * @param[in] period    period of the following events, zero for a one-shot
+ *                      time event
+ *
+ * @iclass
+ */
+void chAOTimeEventArmI(ao_time_event_t *tep, sysinterval_t delay,
+                       sysinterval_t period) {
+
+  chDbgCheckClassI();
+  chDbgCheck((tep != NULL) && (delay != TIME_IMMEDIATE));
+
+  tep->period = period;
+  chVTSetI(&tep->vt, delay, ao_time_event_cb, (void *)tep);
+}
+
+/**
+ * @brief   Arms a time event.
+ * @details If the time event is already armed then it is re-armed.
+ * @note    If the queue of the recipient is full when the time expires
+ *          then the event is lost.
+ *
+ * @param[in] tep       pointer to the @p ao_time_event_t object
+ * @param[in] delay     delay before the first event, it cannot be
+ *                      @p TIME_IMMEDIATE
+ * @param[in] period    period of the following events, zero for a one-shot
+ *                      time event
+ *
+ * @api
+ */
+void chAOTimeEventArm(ao_time_event_t *tep, sysinterval_t delay,
+                      sysinterval_t period) {
+
+  chSysLock();
+  chAOTimeEventArmI(tep, delay, period);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Disarms a time event.
+ * @note    An event already posted by the timer is not removed from the
+ *          recipient queue.
+ *
+ * @param[in] tep       pointer to the @p ao_time_event_t object
+ *
+ * @iclass
+ */
+void chAOTimeEventDisarmI(ao_time_event_t *tep) {
+
+  chDbgCheckClassI();
+  chDbgCheck(tep != NULL);
+
+  chVTResetI(&tep->vt);
+}
+
+/**
+ * @brief   Disarms a time event.
+ * @note    An event already posted by the timer is not removed from the
+ *          recipient queue.
+ *
+ * @param[in] tep       pointer to the @p ao_time_event_t object
+ *
+ * @api
+ */
+void chAOTimeEventDisarm(ao_time_event_t *tep) {
+
+  chSysLock();
+  chAOTimeEventDisarmI(tep);
+  chSysUnlock();
+}
+#endif /* defined(_CHIBIOS_RT_) */
+
+#endif /* CH_CFG_USE_ACTIVE_OBJECTS == TRUE */
+
+/** @} */
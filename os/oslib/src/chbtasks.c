@@ -0,0 +1,465 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chbtasks.c
+ * @brief   Basic tasks code.
+ *
+ * @addtogroup oslib_basic_tasks
+ * @details Run-to-completion tasks sharing stacks under the Stack Resource
+ *          Policy.
+ *          <h2>Operation mode</h2>
+ *          A basic task is a function executed to completion each time
+ *          the task is activated, tasks never block and do not own a
+ *          stack.<br>
+ *          - <b>Preemption levels</b>: Each task belongs to a preemption
+ *            level, a level is served by a single thread running
+ *            @p chBTLevelRun(), all the tasks of a level are executed on
+ *            the stack of that thread. The RAM required is one working
+ *            area for each level instead of one for each task.
+ *          - <b>Activation priority</b>: An activated task is started
+ *            when its priority is the highest among the ready threads and
+ *            tasks, tasks of the same level are started in priority order,
+ *            FIFO among equal priorities.
+ *          - <b>Preemption threshold</b>: A running task is executed at
+ *            the threshold of its level, it can only be preempted by
+ *            threads and tasks with priority above the threshold. Tasks
+ *            of the same level never preempt each other.
+ *          - <b>Resources</b>: Resources are shared using the immediate
+ *            priority ceiling protocol, locking a resource raises the
+ *            priority of the owner to the resource ceiling so that no
+ *            other user of the resource can start, locking never blocks.
+ *          - <b>Activations</b>: Tasks can be activated by threads, tasks
+ *            and ISRs, activations are counted up to a per-task limit,
+ *            activating never blocks.
+ *          .
+ *          Tasks coexist with normal threads, the levels threads are
+ *          scheduled as any other thread.
+ * @pre     In order to use the basic tasks APIs the
+ *          @p CH_CFG_USE_BASIC_TASKS option must be enabled in
+ *          @p chconf.h.
+ * @note    Compatible with RT only.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_BASIC_TASKS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Changes the priority of a thread serving a level.
+ * @note    The real priority is changed too so that the priority
+ *          inheritance mechanism restores the same priority.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] prio      the new priority
+ */
+static void bt_set_priority(thread_t *tp, tprio_t prio) {
+
+#if CH_CFG_USE_MUTEXES == TRUE
+  tp->realprio = prio;
+#endif
+  tp->prio = prio;
+}
+
+/**
+ * @brief   Inserts a task in the level ready list.
+ * @details Tasks are ordered by priority, a task is inserted after the
+ *          ones with the same priority.
+ *
+ * @param[in] lp        pointer to the @p bt_level_t object
+ * @param[in] btp       pointer to the @p basic_task_t object
+ */
+static void bt_ready_insert(bt_level_t *lp, basic_task_t *btp) {
+  basic_task_t **btpp = &lp->ready;
+
+  while ((*btpp != NULL) && ((*btpp)->prio >= btp->prio)) {
+    btpp = &(*btpp)->next;
+  }
+  btp->next = *btpp;
+  *btpp = btp;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p bt_level_t object.
+ *
+ * @param[out] lp       pointer to the @p bt_level_t object
+ * @param[in] threshold the preemption threshold, it must be greater than
+ *                      or equal to the priority of all the tasks of the
+ *                      level
+ *
+ * @init
+ */
+void chBTLevelObjectInit(bt_level_t *lp, tprio_t threshold) {
+
+  chDbgCheck((lp != NULL) && (threshold <= HIGHPRIO));
+
+  lp->ready     = NULL;
+  lp->current   = NULL;
+  lp->thread    = NULL;
+  lp->tr        = NULL;
+  lp->threshold = threshold;
+  lp->stop      = false;
+}
+
+/**
+ * @brief   Serves a preemption level.
+ * @details The activated tasks of the level are executed until the level
+ *          is stopped, this function is meant to be the body of the
+ *          thread serving the level. The thread priority is changed
+ *          dynamically, the original priority is restored on exit.
+ * @note    Only one thread can serve a level.
+ *
+ * @param[in] lp        pointer to the @p bt_level_t object
+ *
+ * @api
+ */
+void chBTLevelRun(bt_level_t *lp) {
+  tprio_t prio;
+
+  chDbgCheck(lp != NULL);
+
+  chSysLock();
+
+  chDbgAssert(lp->thread == NULL, "already served");
+
+  lp->thread = currp;
+  prio = chThdGetPriorityX();
+
+  while (!lp->stop) {
+    basic_task_t *btp = lp->ready;
+
+    if (btp == NULL) {
+      /* Waiting for an activation, the activating side sets the priority
+         of the thread to the priority of the activated task.*/
+      (void) chThdSuspendS(&lp->tr);
+      continue;
+    }
+
+    /* The task has been started because its priority, from now on it is
+       executed at the preemption threshold.*/
+    lp->ready = btp->next;
+    btp->pending--;
+    lp->current = btp;
+    bt_set_priority(currp, lp->threshold);
+    chSysUnlock();
+
+    btp->func(btp->arg);
+
+    chSysLock();
+    chDbgAssert(currp->prio == lp->threshold, "resource not released");
+    lp->current = NULL;
+    if (btp->pending > (ucnt_t)0) {
+      bt_ready_insert(lp, btp);
+    }
+
+    /* Going back to the priority of the next task, threads and tasks with
+       higher priority can run before it is started.*/
+    if (lp->ready != NULL) {
+      bt_set_priority(currp, lp->ready->prio);
+      chSchRescheduleS();
+    }
+  }
+
+  lp->thread = NULL;
+  bt_set_priority(currp, prio);
+  chSchRescheduleS();
+
+  chSysUnlock();
+}
+
+/**
+ * @brief   Stops a preemption level.
+ * @details The thread serving the level returns from @p chBTLevelRun(),
+ *          if a task is being executed then it completes first. Pending
+ *          activations are not lost.
+ *
+ * @param[in] lp        pointer to the @p bt_level_t object
+ *
+ * @iclass
+ */
+void chBTLevelStopI(bt_level_t *lp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(lp != NULL);
+
+  lp->stop = true;
+  chThdResumeI(&lp->tr, MSG_RESET);
+}
+
+/**
+ * @brief   Stops a preemption level.
+ * @details The thread serving the level returns from @p chBTLevelRun(),
+ *          if a task is being executed then it completes first. Pending
+ *          activations are not lost.
+ *
+ * @param[in] lp        pointer to the @p bt_level_t object
+ *
+ * @api
+ */
+void chBTLevelStop(bt_level_t *lp) {
+
+  chSysLock();
+  chBTLevelStopI(lp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Initializes a @p basic_task_t object.
+ *
+ * @param[out] btp      pointer to the @p basic_task_t object
+ * @param[in] lp        pointer to the preemption level of the task
+ * @param[in] prio      the task activation priority, it must not be
+ *                      greater than the level preemption threshold
+ * @param[in] max       maximum number of pending activations
+ * @param[in] func      the task function
+ * @param[in] arg       an argument passed to the task function
+ *
+ * @init
+ */
+void chBTObjectInit(basic_task_t *btp, bt_level_t *lp, tprio_t prio,
+                    ucnt_t max, bt_function_t func, void *arg) {
+
+  chDbgCheck((btp != NULL) && (lp != NULL) && (prio <= lp->threshold) &&
+             (max > (ucnt_t)0) && (func != NULL));
+
+  btp->next    = NULL;
+  btp->level   = lp;
+  btp->prio    = prio;
+  btp->pending = (ucnt_t)0;
+  btp->max     = max;
+  btp->func    = func;
+  btp->arg     = arg;
+}
+
+/**
+ * @brief   Activates a task.
+ * @details The task is started when its priority is the highest among the
+ *          ready threads and tasks. If the task is already activated then
+ *          the activation is counted and the task is executed once more
+ *          after completing.
+ *
+ * @param[in] btp       pointer to the @p basic_task_t object
+ * @return              The operation status.
+ * @retval MSG_OK       if the task has been activated.
+ * @retval MSG_TIMEOUT  if the maximum number of pending activations has
+ *                      been reached.
+ *
+ * @iclass
+ */
+msg_t chBTActivateI(basic_task_t *btp) {
+  bt_level_t *lp;
+  thread_t *tp;
+
+  chDbgCheckClassI();
+  chDbgCheck(btp != NULL);
+
+  if (btp->pending >= btp->max) {
+    return MSG_TIMEOUT;
+  }
+
+  /* A task being executed is inserted in the ready list again after
+     completing.*/
+  lp = btp->level;
+  btp->pending++;
+  if ((btp->pending > (ucnt_t)1) || (lp->current == btp)) {
+    return MSG_OK;
+  }
+  bt_ready_insert(lp, btp);
+
+  /* The thread serving the level needs to be considered only if it is not
+     executing a task, else it is at the preemption threshold already.*/
+  tp = lp->thread;
+  if ((tp == NULL) || (lp->current != NULL)) {
+    return MSG_OK;
+  }
+
+  if (lp->tr != NULL) {
+    /* Waiting for activations, it is resumed at the task priority.*/
+    bt_set_priority(lp->tr, btp->prio);
+    chThdResumeI(&lp->tr, MSG_OK);
+  }
+  else if (btp->prio > tp->prio) {
+    /* Ready between two tasks at the priority of the next one, it is
+       re-enqueued at the higher priority.*/
+    chDbgAssert(tp->state == CH_STATE_READY, "not ready");
+
+    bt_set_priority(tp, btp->prio);
+    (void) chSchRequeueReadyI(tp);
+  }
+  else {
+    /* Already ready at an higher priority.*/
+  }
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Activates a task.
+ * @details The task is started when its priority is the highest among the
+ *          ready threads and tasks. If the task is already activated then
+ *          the activation is counted and the task is executed once more
+ *          after completing.
+ *
+ * @param[in] btp       pointer to the @p basic_task_t object
+ * @return              The operation status.
+ * @retval MSG_OK       if the task has been activated.
+ * @retval MSG_TIMEOUT  if the maximum number of pending activations has
+ *                      been reached.
+ *
+ * @api
+ */
+msg_t chBTActivate(basic_task_t *btp) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chBTActivateI(btp);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Initializes a @p bt_resource_t object.
+ *
+ * @param[out] rp       pointer to the @p bt_resource_t object
+ * @param[in] ceiling   the resource ceiling, it must be greater than or
+ *                      equal to the preemption threshold of all the tasks
+ *                      and the priority of all the threads using the
+ *                      resource
+ *
+ * @init
+ */
+void chBTResourceObjectInit(bt_resource_t *rp, tprio_t ceiling) {
+
+  chDbgCheck((rp != NULL) && (ceiling <= HIGHPRIO));
+
+  rp->ceiling = ceiling;
+  rp->prio    = IDLEPRIO;
+  rp->owner   = NULL;
+}
+
+/**
+ * @brief   Locks a resource.
+ * @details The priority of the calling thread or task is raised to the
+ *          resource ceiling, the operation never blocks.
+ * @note    Resources must be unlocked in reverse order and before the
+ *          locking task completes.
+ * @note    The owner must not block while holding resources.
+ *
+ * @param[in] rp        pointer to the @p bt_resource_t object
+ *
+ * @sclass
+ */
+void chBTResourceLockS(bt_resource_t *rp) {
+
+  chDbgCheckClassS();
+  chDbgCheck(rp != NULL);
+  chDbgAssert(rp->owner == NULL, "already locked");
+  chDbgAssert(rp->ceiling >= currp->prio, "ceiling violation");
+
+  rp->owner = currp;
+  rp->prio  = currp->prio;
+  currp->prio = rp->ceiling;
+}
+
+/**
+ * @brief   Locks a resource.
+ * @details The priority of the calling thread or task is raised to the
+ *          resource ceiling, the operation never blocks.
+ * @note    Resources must be unlocked in reverse order and before the
+ *          locking task completes.
+ * @note    The owner must not block while holding resources.
+ *
+ * @param[in] rp        pointer to the @p bt_resource_t object
+ *
+ * @api
+ */
+void chBTResourceLock(bt_resource_t *rp) {
+
+  chSysLock();
+  chBTResourceLockS(rp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Unlocks a resource.
+ * @details The priority of the calling thread or task is restored to the
+ *          value before locking the resource.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] rp        pointer to the @p bt_resource_t object
+ *
+ * @sclass
+ */
+void chBTResourceUnlockS(bt_resource_t *rp) {
+
+  chDbgCheckClassS();
+  chDbgCheck(rp != NULL);
+  chDbgAssert(rp->owner == currp, "not owner");
+  chDbgAssert(currp->prio == rp->ceiling, "not the last locked resource");
+
+  rp->owner   = NULL;
+  currp->prio = rp->prio;
+}
+
+/**
+ * @brief   Unlocks a resource.
+ * @details The priority of the calling thread or task is restored to the
+ *          value before locking the resource, tasks activated while the
+ *          resource was locked can start.
+ *
+ * @param[in] rp        pointer to the @p bt_resource_t object
+ *
+ * @api
+ */
+void chBTResourceUnlock(bt_resource_t *rp) {
+
+  chSysLock();
+  chBTResourceUnlockS(rp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+#endif /* CH_CFG_USE_BASIC_TASKS == TRUE */
+
+/** @} */
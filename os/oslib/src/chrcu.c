@@ -0,0 +1,304 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chrcu.c
+ * @brief   RCU code.
+ *
+ * @addtogroup oslib_rcu
+ * @details Read-copy-update for read-mostly shared objects.
+ *          <h2>Operation mode</h2>
+ *          Readers access the shared objects inside read-side critical
+ *          sections, writers publish a new version of an object by
+ *          replacing its pointer and reclaim the old version after a
+ *          grace period, when all the readers that could still access
+ *          it have left their sections.<br>
+ *          - <b>Readers</b>: Entering and leaving a section only updates
+ *            a counter of the current thread, readers never wait and
+ *            never lock. Sections are only allowed in thread context.
+ *          - <b>Grace periods</b>: On a single core a reader can only be
+ *            inside a section while another thread runs if it has been
+ *            switched out. The context switch hook records those readers,
+ *            a grace period waits for the readers recorded before its
+ *            start and elapses when the last one leaves its section.
+ *            Without preempted readers a grace period elapses
+ *            immediately.
+ *          - <b>Reclamation</b>: A writer can wait for a grace period using
+ *            @p chRCUSynchronize() then free the old version, or queue a
+ *            callback using @p chRCUCall(). Callbacks are invoked by the
+ *            writers in thread context so they can free into pools or
+ *            the heap.
+ *          .
+ * @pre     In order to use the RCU APIs the @p CH_CFG_USE_RCU option must
+ *          be enabled in @p chconf.h.
+ * @note    Compatible with RT only.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_RCU == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   RCU state.
+ */
+rcu_t ch_rcu;
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Verifies if a grace period elapsed.
+ *
+ * @param[in] gp        the grace period
+ * @return              The grace period state.
+ */
+static bool rcu_elapsed(ucnt_t gp) {
+
+  return (bool)((cnt_t)(ch_rcu.completed - gp) >= (cnt_t)0);
+}
+
+/**
+ * @brief   Starts a grace period.
+ * @details The readers preempted up to now are waited for, readers
+ *          preempted from now on are recorded in the other phase.
+ */
+static void rcu_start(void) {
+
+  ch_rcu.phase ^= (ucnt_t)1;
+  ch_rcu.started++;
+}
+
+/**
+ * @brief   Requests a grace period.
+ * @details If a grace period is running then the following one is
+ *          requested, the running one could miss readers preempted after
+ *          its start.
+ *
+ * @return              The grace period to be waited for.
+ */
+static ucnt_t rcu_request(void) {
+
+  if (ch_rcu.started == ch_rcu.completed) {
+    rcu_start();
+    ch_rcu.requested = ch_rcu.started;
+  }
+  else {
+    ch_rcu.requested = ch_rcu.started + (ucnt_t)1;
+  }
+
+  return ch_rcu.requested;
+}
+
+/**
+ * @brief   Completes the grace periods without preempted readers.
+ * @details The waiting threads are woken up and the elapsed callbacks are
+ *          moved in the done list, a requested grace period is started.
+ */
+static void rcu_advance(void) {
+
+  while ((ch_rcu.started != ch_rcu.completed) &&
+         (ch_rcu.blocked[ch_rcu.phase ^ (ucnt_t)1] == (ucnt_t)0)) {
+    ch_rcu.completed = ch_rcu.started;
+
+    while ((ch_rcu.pending != NULL) && rcu_elapsed(ch_rcu.pending->gp)) {
+      rcu_head_t *hp = ch_rcu.pending;
+
+      ch_rcu.pending = hp->next;
+      hp->next = ch_rcu.done;
+      ch_rcu.done = hp;
+    }
+    if (ch_rcu.pending == NULL) {
+      ch_rcu.last = NULL;
+    }
+
+    chThdDequeueAllI(&ch_rcu.waiting, MSG_OK);
+
+    if (ch_rcu.requested != ch_rcu.completed) {
+      rcu_start();
+    }
+  }
+}
+
+/**
+ * @brief   Invokes the callbacks whose grace period elapsed.
+ */
+static void rcu_reclaim(void) {
+  rcu_head_t *hp;
+
+  chSysLock();
+  hp = ch_rcu.done;
+  ch_rcu.done = NULL;
+  chSysUnlock();
+
+  while (hp != NULL) {
+    rcu_head_t *next = hp->next;
+
+    hp->func(hp);
+    hp = next;
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes the RCU state.
+ *
+ * @notapi
+ */
+void _rcu_init(void) {
+
+  ch_rcu.blocked[0] = (ucnt_t)0;
+  ch_rcu.blocked[1] = (ucnt_t)0;
+  ch_rcu.phase      = (ucnt_t)0;
+  ch_rcu.started    = (ucnt_t)0;
+  ch_rcu.completed  = (ucnt_t)0;
+  ch_rcu.requested  = (ucnt_t)0;
+  chThdQueueObjectInit(&ch_rcu.waiting);
+  ch_rcu.pending    = NULL;
+  ch_rcu.last       = NULL;
+  ch_rcu.done       = NULL;
+}
+
+/**
+ * @brief   Removes a preempted reader from its grace period.
+ * @note    Called when a reader recorded by the context switch hook leaves
+ *          its outermost section, the reader can be inside a critical zone.
+ *
+ * @param[in] tp        pointer to the reader thread
+ *
+ * @notapi
+ */
+void _rcu_unblock(thread_t *tp) {
+  syssts_t sts;
+
+  sts = chSysGetStatusAndLockX();
+  tp->rcu_blocked = false;
+  ch_rcu.blocked[tp->rcu_phase]--;
+  rcu_advance();
+  chSysRestoreStatusX(sts);
+}
+
+/**
+ * @brief   Waits for a grace period.
+ * @details On return all the readers that were inside a read-side critical
+ *          section on entry have left it, the versions unpublished before
+ *          the call can be reclaimed. The callbacks whose grace period
+ *          elapsed are invoked.
+ *
+ * @api
+ */
+void chRCUSynchronize(void) {
+  ucnt_t gp;
+
+  chDbgAssert(!chRCUIsReadingX(), "within read-side section");
+
+  chSysLock();
+  gp = rcu_request();
+  rcu_advance();
+  while (!rcu_elapsed(gp)) {
+    (void) chThdEnqueueTimeoutS(&ch_rcu.waiting, TIME_INFINITE);
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+
+  rcu_reclaim();
+}
+
+/**
+ * @brief   Queues a reclamation callback.
+ * @details The callback is invoked after a grace period, by a following
+ *          call to @p chRCUSynchronize(), @p chRCUCall() or
+ *          @p chRCUBarrier(), possibly this one. The callbacks whose grace
+ *          period elapsed are invoked.
+ * @note    The callbacks are invoked in thread context, they can free into
+ *          pools or the heap.
+ *
+ * @param[in] hp        pointer to the @p rcu_head_t embedded in the object
+ *                      to be reclaimed
+ * @param[in] func      the reclamation callback
+ *
+ * @api
+ */
+void chRCUCall(rcu_head_t *hp, rcu_callback_t func) {
+
+  chDbgCheck((hp != NULL) && (func != NULL));
+
+  chSysLock();
+  hp->next = NULL;
+  hp->func = func;
+  hp->gp   = rcu_request();
+  if (ch_rcu.last == NULL) {
+    ch_rcu.pending = hp;
+  }
+  else {
+    ch_rcu.last->next = hp;
+  }
+  ch_rcu.last = hp;
+  rcu_advance();
+  chSchRescheduleS();
+  chSysUnlock();
+
+  rcu_reclaim();
+}
+
+/**
+ * @brief   Waits for all the queued callbacks.
+ * @details On return all the callbacks queued before the call have been
+ *          invoked.
+ * @note    With concurrent writers a callback could still be running in
+ *          the writer that dequeued it.
+ *
+ * @api
+ */
+void chRCUBarrier(void) {
+
+  chDbgAssert(!chRCUIsReadingX(), "within read-side section");
+
+  chSysLock();
+  if (ch_rcu.last != NULL) {
+    ucnt_t gp = ch_rcu.last->gp;
+
+    while (!rcu_elapsed(gp)) {
+      (void) chThdEnqueueTimeoutS(&ch_rcu.waiting, TIME_INFINITE);
+    }
+  }
+  chSysUnlock();
+
+  rcu_reclaim();
+}
+
+#endif /* CH_CFG_USE_RCU == TRUE */
+
+/** @} */
@@ -0,0 +1,633 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chrmboxes.c
+ * @brief   Remote mailboxes code.
+ *
+ * @addtogroup oslib_remote_mailboxes
+ * @details Messages exchange between two OS instances sharing a memory
+ *          region, for example two cores of an AMP system.
+ *          <h2>Operation mode</h2>
+ *          - <b>Rings</b>: The region contains two descriptors rings, one
+ *            for each direction. Each ring has a single producer and a
+ *            single consumer and is lock-free, each index is written by
+ *            one side only.
+ *          - <b>Zero copy</b>: Messages are written and read in place, a
+ *            slot is reserved, filled and published by the producer then
+ *            fetched and released by the consumer.
+ *          - <b>Doorbells</b>: The other side is notified using a
+ *            doorbell function, an inter-processor interrupt or a mailbox
+ *            peripheral, its handler calls @p chRMBDoorbellI().
+ *          - <b>Batching</b>: A side rings the doorbell only if the other
+ *            side announced it is waiting and only once for each wait,
+ *            messages published while the other side is busy do not cost
+ *            any interrupt. Several messages can be published before a
+ *            single flush.
+ *          .
+ * @pre     In order to use the remote mailboxes APIs the
+ *          @p CH_CFG_USE_REMOTE_MAILBOXES option must be enabled in
+ *          @p chconf.h.
+ * @note    Compatible with RT and NIL.
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+
+#if (CH_CFG_USE_REMOTE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*
+ * Defaults on the best synchronization mechanism available.
+ */
+#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+#define RW_INIT(p)       chMtxObjectInit(&(p)->wmtx)
+#define RW_LOCK(p)       chMtxLock(&(p)->wmtx)
+#define RW_UNLOCK(p)     chMtxUnlock(&(p)->wmtx)
+#define RR_INIT(p)       chMtxObjectInit(&(p)->rmtx)
+#define RR_LOCK(p)       chMtxLock(&(p)->rmtx)
+#define RR_UNLOCK(p)     chMtxUnlock(&(p)->rmtx)
+#else
+#define RW_INIT(p)       chSemObjectInit(&(p)->wsem, (cnt_t)1)
+#define RW_LOCK(p)       (void) chSemWait(&(p)->wsem)
+#define RW_UNLOCK(p)     chSemSignal(&(p)->wsem)
+#define RR_INIT(p)       chSemObjectInit(&(p)->rsem, (cnt_t)1)
+#define RR_LOCK(p)       (void) chSemWait(&(p)->rsem)
+#define RR_UNLOCK(p)     chSemSignal(&(p)->rsem)
+#endif
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns a slot address.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @param[in] slots     ring slots base
+ * @param[in] index     free running slot index
+ * @return              The slot address.
+ */
+static inline uint8_t *rmb_slot(remote_mailbox_t *rmbp,
+                                uint8_t *slots,
+                                uint32_t index) {
+
+  return slots + ((size_t)(index & (rmbp->slots - 1U)) * rmbp->stride);
+}
+
+/**
+ * @brief   Checks for free outgoing slots.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @return              The outgoing ring state.
+ * @retval false        if there is at least one free slot.
+ * @retval true         if the ring is full.
+ */
+static bool rmb_tx_full(remote_mailbox_t *rmbp) {
+
+  CH_CFG_RMB_CACHE_INVALIDATE(&rmbp->txring->cons, sizeof (rmb_line_t));
+  return (uint32_t)(rmbp->txhead - rmbp->txring->cons.s.index) >=
+         rmbp->slots;
+}
+
+/**
+ * @brief   Checks for incoming messages.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @return              The incoming ring state.
+ * @retval false        if there is at least one message.
+ * @retval true         if the ring is empty.
+ */
+static bool rmb_rx_empty(remote_mailbox_t *rmbp) {
+
+  CH_CFG_RMB_CACHE_INVALIDATE(&rmbp->rxring->prod, sizeof (rmb_line_t));
+  return rmbp->rxring->prod.s.index == rmbp->rxtail;
+}
+
+/**
+ * @brief   Rings the doorbell if the other side announced a wait.
+ * @note    Must be called from within a lock zone.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @param[in] line      the line written by the other side
+ * @param[in,out] seqp  pointer to the last wait already notified
+ */
+static void rmb_notify(remote_mailbox_t *rmbp,
+                       rmb_line_t *line,
+                       uint32_t *seqp) {
+  uint32_t seq;
+
+  CH_CFG_RMB_CACHE_INVALIDATE(line, sizeof (rmb_line_t));
+  seq = line->s.waitseq;
+  if (seq != *seqp) {
+    *seqp = seq;
+    rmbp->n_rung++;
+    rmbp->doorbell(rmbp, rmbp->arg);
+  }
+}
+
+/**
+ * @brief   Waits for a free outgoing slot.
+ * @note    Must be called from within a lock zone.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The operation status.
+ */
+static msg_t rmb_wait_space_s(remote_mailbox_t *rmbp, sysinterval_t timeout) {
+
+  while (rmb_tx_full(rmbp)) {
+    msg_t msg;
+
+    if (timeout == TIME_IMMEDIATE) {
+      return MSG_TIMEOUT;
+    }
+
+    /* The wait is announced then the ring is checked again, a slot
+       released before the announcement is visible would not be notified.*/
+    rmbp->txring->prod.s.waitseq++;
+    CH_CFG_RMB_CACHE_CLEAN(&rmbp->txring->prod, sizeof (rmb_line_t));
+    CH_CFG_RMB_BARRIER();
+    if (!rmb_tx_full(rmbp)) {
+      break;
+    }
+
+    msg = chThdSuspendTimeoutS(&rmbp->wtr, timeout);
+    if (msg != MSG_OK) {
+      return msg;
+    }
+  }
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Waits for an incoming message.
+ * @note    Must be called from within a lock zone.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The operation status.
+ */
+static msg_t rmb_wait_data_s(remote_mailbox_t *rmbp, sysinterval_t timeout) {
+
+  while (rmb_rx_empty(rmbp)) {
+    msg_t msg;
+
+    if (timeout == TIME_IMMEDIATE) {
+      return MSG_TIMEOUT;
+    }
+
+    /* The wait is announced then the ring is checked again, a message
+       published before the announcement is visible would not be
+       notified.*/
+    rmbp->rxring->cons.s.waitseq++;
+    CH_CFG_RMB_CACHE_CLEAN(&rmbp->rxring->cons, sizeof (rmb_line_t));
+    CH_CFG_RMB_BARRIER();
+    if (!rmb_rx_empty(rmbp)) {
+      break;
+    }
+
+    msg = chThdSuspendTimeoutS(&rmbp->rtr, timeout);
+    if (msg != MSG_OK) {
+      return msg;
+    }
+  }
+
+  return MSG_OK;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p remote_mailbox_t object.
+ * @note    The shared region is not accessed, see
+ *          @p chRMBConnectTimeout().
+ *
+ * @param[out] rmbp     pointer to a @p remote_mailbox_t object
+ * @param[in] dp        pointer to a @p rmb_descriptor_t structure
+ *
+ * @init
+ */
+void chRMBObjectInit(remote_mailbox_t *rmbp, const rmb_descriptor_t *dp) {
+  uint8_t *slots;
+
+  chDbgCheck((rmbp != NULL) && (dp != NULL) && (dp->region != NULL) &&
+             (dp->slots > 0U) && ((dp->slots & (dp->slots - 1U)) == 0U) &&
+             (dp->slot_size > 0U) && (dp->side <= RMB_SIDE_B) &&
+             (dp->doorbell != NULL));
+  chDbgAssert(((size_t)dp->region & (CH_CFG_RMB_LINE_SIZE - 1U)) == 0U,
+              "unaligned region");
+
+  rmbp->region     = (rmb_region_t *)dp->region;
+  rmbp->slots      = (uint32_t)dp->slots;
+  rmbp->slot_size  = dp->slot_size;
+  rmbp->stride     = RMB_SLOT_STRIDE(dp->slot_size);
+  rmbp->side       = dp->side;
+  rmbp->connected  = false;
+  rmbp->doorbell   = dp->doorbell;
+  rmbp->arg        = dp->arg;
+  rmbp->txhead     = 0U;
+  rmbp->rxtail     = 0U;
+  rmbp->txnotified = 0U;
+  rmbp->rxnotified = 0U;
+  rmbp->wtr        = NULL;
+  rmbp->rtr        = NULL;
+  rmbp->n_posted   = (ucnt_t)0;
+  rmbp->n_fetched  = (ucnt_t)0;
+  rmbp->n_rung     = (ucnt_t)0;
+  rmbp->n_doorbells = (ucnt_t)0;
+  RW_INIT(rmbp);
+  RR_INIT(rmbp);
+
+  /* Side A transmits on the first ring.*/
+  slots = (uint8_t *)dp->region + sizeof (rmb_region_t);
+  if (dp->side == RMB_SIDE_A) {
+    rmbp->txring  = &rmbp->region->rings[0];
+    rmbp->rxring  = &rmbp->region->rings[1];
+    rmbp->txslots = slots;
+    rmbp->rxslots = slots + (dp->slots * rmbp->stride);
+  }
+  else {
+    rmbp->txring  = &rmbp->region->rings[1];
+    rmbp->rxring  = &rmbp->region->rings[0];
+    rmbp->txslots = slots + (dp->slots * rmbp->stride);
+    rmbp->rxslots = slots;
+  }
+}
+
+/**
+ * @brief   Connects to the shared region.
+ * @details Side A formats the region and notifies side B, side B waits for
+ *          the region to be formatted.
+ * @note    The doorbell interrupt must be enabled before calling this
+ *          function.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the region is ready.
+ * @retval MSG_RESET    if the region geometry does not match.
+ * @retval MSG_TIMEOUT  if the region has not been formatted within the
+ *                      specified time.
+ *
+ * @api
+ */
+msg_t chRMBConnectTimeout(remote_mailbox_t *rmbp, sysinterval_t timeout) {
+  rmb_region_t *rp = rmbp->region;
+  msg_t msg = MSG_OK;
+
+  chDbgCheck(rmbp != NULL);
+
+  chSysLock();
+
+  if (rmbp->side == RMB_SIDE_A) {
+    memset((void *)rp, 0, sizeof (rmb_region_t));
+    rp->hdr.s.slots     = rmbp->slots;
+    rp->hdr.s.slot_size = (uint32_t)rmbp->slot_size;
+    CH_CFG_RMB_CACHE_CLEAN(rp, sizeof (rmb_region_t));
+    CH_CFG_RMB_BARRIER();
+    rp->hdr.s.magic     = RMB_MAGIC;
+    CH_CFG_RMB_CACHE_CLEAN(rp, sizeof (rmb_line_t));
+    rmbp->n_rung++;
+    rmbp->doorbell(rmbp, rmbp->arg);
+  }
+  else {
+    while (true) {
+      CH_CFG_RMB_CACHE_INVALIDATE(rp, sizeof (rmb_region_t));
+      if (rp->hdr.s.magic == RMB_MAGIC) {
+        CH_CFG_RMB_BARRIER();
+        if ((rp->hdr.s.slots != rmbp->slots) ||
+            (rp->hdr.s.slot_size != (uint32_t)rmbp->slot_size)) {
+          msg = MSG_RESET;
+        }
+        break;
+      }
+
+      /* Waiting for the side A doorbell.*/
+      if (timeout == TIME_IMMEDIATE) {
+        msg = MSG_TIMEOUT;
+        break;
+      }
+      msg = chThdSuspendTimeoutS(&rmbp->rtr, timeout);
+      if (msg != MSG_OK) {
+        break;
+      }
+    }
+  }
+
+  /* Wait sequences start from zero in a formatted region, waits announced
+     by the other side before the connection are notified.*/
+  if (msg == MSG_OK) {
+    rmbp->txhead     = 0U;
+    rmbp->rxtail     = 0U;
+    rmbp->txnotified = 0U;
+    rmbp->rxnotified = 0U;
+    rmbp->connected  = true;
+  }
+
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Reserves an outgoing slot.
+ * @details The message is written in place then published using
+ *          @p chRMBPublish().
+ * @note    Only one thread at time can use the zero copy functions on the
+ *          same endpoint direction, the caller must serialize them.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @param[out] pp       pointer to the slot data area, it can contain
+ *                      @p chRMBGetSlotSizeX() bytes
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a slot has been reserved.
+ * @retval MSG_TIMEOUT  if all slots are in use after the specified time.
+ *
+ * @api
+ */
+msg_t chRMBReserveTimeout(remote_mailbox_t *rmbp, void **pp,
+                          sysinterval_t timeout) {
+  msg_t msg;
+
+  chDbgCheck((rmbp != NULL) && (pp != NULL));
+  chDbgAssert(rmbp->connected, "not connected");
+
+  chSysLock();
+  msg = rmb_wait_space_s(rmbp, timeout);
+  chSysUnlock();
+
+  if (msg == MSG_OK) {
+    *pp = (void *)(rmb_slot(rmbp, rmbp->txslots, rmbp->txhead) +
+                   RMB_SLOT_HEADER_SIZE);
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Publishes the reserved slot.
+ * @details The message becomes visible to the other side, the other side
+ *          is not notified, see @p chRMBFlush().
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @param[in] n         the message size
+ *
+ * @xclass
+ */
+void chRMBPublish(remote_mailbox_t *rmbp, size_t n) {
+  uint8_t *slot;
+
+  chDbgCheck((rmbp != NULL) && (n <= rmbp->slot_size));
+
+  slot = rmb_slot(rmbp, rmbp->txslots, rmbp->txhead);
+  *(uint32_t *)slot = (uint32_t)n;
+  CH_CFG_RMB_CACHE_CLEAN(slot, (size_t)RMB_SLOT_HEADER_SIZE + n);
+  CH_CFG_RMB_BARRIER();
+  rmbp->txhead++;
+  rmbp->txring->prod.s.index = rmbp->txhead;
+  CH_CFG_RMB_CACHE_CLEAN(&rmbp->txring->prod, sizeof (rmb_line_t));
+  rmbp->n_posted++;
+}
+
+/**
+ * @brief   Notifies the other side about published messages.
+ * @details The doorbell is rung only if the other side is waiting for
+ *          messages and has not been notified yet.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ *
+ * @api
+ */
+void chRMBFlush(remote_mailbox_t *rmbp) {
+
+  chDbgCheck(rmbp != NULL);
+
+  chSysLock();
+  CH_CFG_RMB_BARRIER();
+  rmb_notify(rmbp, &rmbp->txring->cons, &rmbp->txnotified);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Posts a message.
+ * @details The message is copied in an outgoing slot, published and the
+ *          other side is notified.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @param[in] bp        pointer to the message
+ * @param[in] n         the message size
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the message has been posted.
+ * @retval MSG_TIMEOUT  if all slots are in use after the specified time.
+ *
+ * @api
+ */
+msg_t chRMBPostTimeout(remote_mailbox_t *rmbp, const void *bp,
+                       size_t n, sysinterval_t timeout) {
+  void *p;
+  msg_t msg;
+
+  chDbgCheck((bp != NULL) || (n == 0U));
+
+  RW_LOCK(rmbp);
+
+  msg = chRMBReserveTimeout(rmbp, &p, timeout);
+  if (msg == MSG_OK) {
+    memcpy(p, bp, n);
+    chRMBPublish(rmbp, n);
+    chRMBFlush(rmbp);
+  }
+
+  RW_UNLOCK(rmbp);
+
+  return msg;
+}
+
+/**
+ * @brief   Fetches the next incoming message in place.
+ * @details The message is read in place then released using
+ *          @p chRMBRelease().
+ * @note    Only one thread at time can use the zero copy functions on the
+ *          same endpoint direction, the caller must serialize them.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @param[out] pp       pointer to the message
+ * @param[out] np       pointer to the message size
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been fetched.
+ * @retval MSG_TIMEOUT  if no message arrived within the specified time.
+ *
+ * @api
+ */
+msg_t chRMBFetchSlotTimeout(remote_mailbox_t *rmbp, const void **pp,
+                            size_t *np, sysinterval_t timeout) {
+  msg_t msg;
+
+  chDbgCheck((rmbp != NULL) && (pp != NULL) && (np != NULL));
+  chDbgAssert(rmbp->connected, "not connected");
+
+  chSysLock();
+  msg = rmb_wait_data_s(rmbp, timeout);
+  chSysUnlock();
+
+  if (msg == MSG_OK) {
+    const uint8_t *slot = rmb_slot(rmbp, rmbp->rxslots, rmbp->rxtail);
+    size_t n;
+
+    CH_CFG_RMB_BARRIER();
+    CH_CFG_RMB_CACHE_INVALIDATE(slot, rmbp->stride);
+    n = (size_t)*(const uint32_t *)slot;
+    chDbgAssert(n <= rmbp->slot_size, "corrupted slot");
+    *pp = (const void *)(slot + RMB_SLOT_HEADER_SIZE);
+    *np = n;
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Releases the fetched message slot.
+ * @details The other side is notified if it is waiting for free slots.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ *
+ * @api
+ */
+void chRMBRelease(remote_mailbox_t *rmbp) {
+
+  chDbgCheck(rmbp != NULL);
+  chDbgAssert(!rmb_rx_empty(rmbp), "nothing to release");
+
+  chSysLock();
+  CH_CFG_RMB_BARRIER();
+  rmbp->rxtail++;
+  rmbp->rxring->cons.s.index = rmbp->rxtail;
+  CH_CFG_RMB_CACHE_CLEAN(&rmbp->rxring->cons, sizeof (rmb_line_t));
+  rmbp->n_fetched++;
+  CH_CFG_RMB_BARRIER();
+  rmb_notify(rmbp, &rmbp->rxring->prod, &rmbp->rxnotified);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Fetches a message.
+ * @details The next incoming message is copied in the buffer and its slot
+ *          released.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ * @param[out] bp       pointer to the message buffer, it must be able to
+ *                      contain @p chRMBGetSlotSizeX() bytes
+ * @param[out] np       pointer to the message size
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been fetched.
+ * @retval MSG_TIMEOUT  if no message arrived within the specified time.
+ *
+ * @api
+ */
+msg_t chRMBFetchTimeout(remote_mailbox_t *rmbp, void *bp,
+                        size_t *np, sysinterval_t timeout) {
+  const void *p;
+  msg_t msg;
+
+  chDbgCheck(bp != NULL);
+
+  RR_LOCK(rmbp);
+
+  msg = chRMBFetchSlotTimeout(rmbp, &p, np, timeout);
+  if (msg == MSG_OK) {
+    memcpy(bp, p, *np);
+    chRMBRelease(rmbp);
+  }
+
+  RR_UNLOCK(rmbp);
+
+  return msg;
+}
+
+/**
+ * @brief   Handles a doorbell from the other side.
+ * @details The waiting threads are resumed, they check the rings again.
+ * @note    This function must be called from the doorbell interrupt
+ *          handler.
+ *
+ * @param[in] rmbp      pointer to a @p remote_mailbox_t object
+ *
+ * @iclass
+ */
+void chRMBDoorbellI(remote_mailbox_t *rmbp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(rmbp != NULL);
+
+  rmbp->n_doorbells++;
+  chThdResumeI(&rmbp->rtr, MSG_OK);
+  chThdResumeI(&rmbp->wtr, MSG_OK);
+}
+
+#endif /* CH_CFG_USE_REMOTE_MAILBOXES == TRUE */
+
+/** @} */
@@ -0,0 +1,606 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chstables.c
+ * @brief   Schedule tables code.
+ *
+ * @addtogroup oslib_schedule_tables
+ * @details Time-triggered schedule tables.
+ *          <h2>Operation mode</h2>
+ *          A schedule table is a constant list of expiry points, each
+ *          point has an offset from the table start and an action:
+ *          calling a function, resuming a thread, broadcasting an event
+ *          source or activating a basic task.<br>
+ *          - <b>Timelines</b>: A table is run by a timeline, a timeline
+ *            uses a single virtual timer programmed on the next expiry
+ *            point. All the points expiring together are processed in
+ *            a single callback.
+ *          - <b>Absolute timing</b>: The expiry times are computed from
+ *            the cycle start time, latencies do not accumulate.
+ *          - <b>Cycles</b>: At the end of the table duration a repeating
+ *            table starts a new cycle, a single shot table stops. A
+ *            different table can be queued in order to be started at the
+ *            end of the current cycle.
+ *          - <b>Synchronization</b>: The timeline can be synchronized to
+ *            an external time base, the deviation measured on each
+ *            synchronization is corrected gradually on the following
+ *            alarms. A table can also be started on the first
+ *            synchronization.
+ *          .
+ * @pre     In order to use the schedule tables APIs the
+ *          @p CH_CFG_USE_SCHEDULE_TABLES option must be enabled in
+ *          @p chconf.h.
+ * @note    Compatible with RT only.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_SCHEDULE_TABLES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void st_cb(void *p);
+
+/**
+ * @brief   Verifies a table.
+ *
+ * @param[in] tp        pointer to the @p st_table_t object
+ * @return              The table validity.
+ */
+static bool st_is_valid(const st_table_t *tp) {
+  size_t i;
+
+  if ((tp->n == (size_t)0) || (tp->duration == (sysinterval_t)0)) {
+    return false;
+  }
+
+  for (i = (size_t)0; i < tp->n; i++) {
+    if ((tp->points[i].offset >= tp->duration) ||
+        ((i > (size_t)0) &&
+         (tp->points[i].offset < tp->points[i - (size_t)1].offset))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Offset of the next expiry point or of the cycle end.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @return              The offset from the cycle start.
+ */
+static sysinterval_t st_next_offset(st_timeline_t *stp) {
+
+  if (stp->index < stp->table->n) {
+    return stp->table->points[stp->index].offset;
+  }
+
+  return stp->table->duration;
+}
+
+/**
+ * @brief   Executes the action of an expiry point.
+ *
+ * @param[in] ep        pointer to the @p st_expiry_t object
+ */
+static void st_execute(const st_expiry_t *ep) {
+
+  switch (ep->action) {
+  case ST_ACTION_CALLBACK:
+    ep->func(ep->target);
+    break;
+  case ST_ACTION_RESUME:
+    chThdResumeI((thread_reference_t *)ep->target, ep->value);
+    break;
+#if CH_CFG_USE_EVENTS == TRUE
+  case ST_ACTION_BROADCAST:
+    chEvtBroadcastFlagsI((event_source_t *)ep->target,
+                         (eventflags_t)ep->value);
+    break;
+#endif
+#if CH_CFG_USE_BASIC_TASKS == TRUE
+  case ST_ACTION_TASK:
+    (void) chBTActivateI((basic_task_t *)ep->target);
+    break;
+#endif
+  default:
+    chDbgAssert(false, "unsupported action");
+    break;
+  }
+}
+
+/**
+ * @brief   Programs the alarm on the next expiry point.
+ * @details A part of the deviation is corrected by moving the cycle start,
+ *          an advance cannot move the next expiry point before the next
+ *          tick.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @param[in] now       current system time
+ * @param[in] delay     interval from @p now to the next expiry point
+ */
+static void st_arm(st_timeline_t *stp, systime_t now, sysinterval_t delay) {
+
+  if (stp->deviation > (sysinterval_t)0) {
+    sysinterval_t step = stp->deviation;
+
+    if ((stp->table->max_adjust > (sysinterval_t)0) &&
+        (step > stp->table->max_adjust)) {
+      step = stp->table->max_adjust;
+    }
+
+    if (stp->retard) {
+      stp->start = chTimeAddX(stp->start, step);
+      delay += step;
+    }
+    else {
+      if (step >= delay) {
+        step = delay > (sysinterval_t)0 ? delay - (sysinterval_t)1 :
+                                          (sysinterval_t)0;
+      }
+      stp->start = (systime_t)(stp->start - (systime_t)step);
+      delay -= step;
+    }
+    stp->deviation -= step;
+  }
+
+  /* The recorded time is the ideal one, the alarm needs at least one
+     tick.*/
+  stp->time = chTimeAddX(now, delay);
+  chVTDoSetI(&stp->vt, delay > (sysinterval_t)0 ? delay : (sysinterval_t)1,
+             st_cb, (void *)stp);
+}
+
+/**
+ * @brief   Starts a table.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @param[in] tp        pointer to the @p st_table_t object
+ * @param[in] delay     interval from the current time to the table start
+ */
+static void st_start(st_timeline_t *stp, const st_table_t *tp,
+                     sysinterval_t delay) {
+  systime_t now = chVTGetSystemTimeX();
+
+  stp->table = tp;
+  stp->state = ST_RUNNING;
+  stp->index = (size_t)0;
+  stp->start = chTimeAddX(now, delay);
+  st_arm(stp, now, delay + tp->points[0].offset);
+}
+
+/**
+ * @brief   Timeline alarm callback.
+ * @details Processes all the expired points, starting new cycles if
+ *          required, then programs the alarm on the next point.
+ *
+ * @param[in] p         pointer to the @p st_timeline_t object
+ */
+static void st_cb(void *p) {
+  st_timeline_t *stp = (st_timeline_t *)p;
+  systime_t now;
+  sysinterval_t late;
+
+  chSysLockFromISR();
+
+  /* Points up to the current time have expired, the point that
+     triggered the alarm is the first one.*/
+  now  = chVTGetSystemTimeX();
+  late = chTimeDiffX(stp->time, now);
+
+  while (true) {
+    const st_table_t *tp = stp->table;
+
+    if (stp->index < tp->n) {
+      const st_expiry_t *ep = &tp->points[stp->index];
+
+      if (chTimeDiffX(chTimeAddX(stp->start, ep->offset), now) > late) {
+        break;
+      }
+      stp->index++;
+      st_execute(ep);
+
+      /* The action could have stopped or restarted the timeline.*/
+      if ((stp->state != ST_RUNNING) || chVTIsArmedI(&stp->vt)) {
+        chSysUnlockFromISR();
+        return;
+      }
+    }
+    else {
+      systime_t end = chTimeAddX(stp->start, tp->duration);
+
+      if (chTimeDiffX(end, now) > late) {
+        break;
+      }
+
+      /* End of the cycle.*/
+      stp->start = end;
+      stp->index = (size_t)0;
+      if (stp->next != NULL) {
+        /* The next table starts not synchronized.*/
+        stp->table     = stp->next;
+        stp->next      = NULL;
+        stp->deviation = (sysinterval_t)0;
+        stp->synced    = false;
+      }
+      else if (!tp->repeating) {
+        stp->table = NULL;
+        stp->state = ST_STOPPED;
+        chSysUnlockFromISR();
+        return;
+      }
+      else {
+        /* New cycle of the same table.*/
+      }
+    }
+  }
+
+  st_arm(stp, now, chTimeDiffX(now, chTimeAddX(stp->start,
+                                               st_next_offset(stp))));
+
+  chSysUnlockFromISR();
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p st_timeline_t object.
+ *
+ * @param[out] stp      pointer to the @p st_timeline_t object
+ *
+ * @init
+ */
+void chSTObjectInit(st_timeline_t *stp) {
+
+  chDbgCheck(stp != NULL);
+
+  chVTObjectInit(&stp->vt);
+  stp->table     = NULL;
+  stp->next      = NULL;
+  stp->state     = ST_STOPPED;
+  stp->index     = (size_t)0;
+  stp->start     = (systime_t)0;
+  stp->time      = (systime_t)0;
+  stp->deviation = (sysinterval_t)0;
+  stp->retard    = false;
+  stp->synced    = false;
+}
+
+/**
+ * @brief   Starts a table after a delay.
+ * @details If the timeline is already running then it is restarted.
+ * @note    Expiry points at offset zero of a table started with zero
+ *          delay are processed on the next tick.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @param[in] tp        pointer to the @p st_table_t object
+ * @param[in] delay     delay before the table start
+ *
+ * @iclass
+ */
+void chSTStartRelI(st_timeline_t *stp, const st_table_t *tp,
+                   sysinterval_t delay) {
+
+  chDbgCheckClassI();
+  chDbgCheck((stp != NULL) && (tp != NULL) && st_is_valid(tp));
+
+  chSTStopI(stp);
+  st_start(stp, tp, delay);
+}
+
+/**
+ * @brief   Starts a table after a delay.
+ * @details If the timeline is already running then it is restarted.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @param[in] tp        pointer to the @p st_table_t object
+ * @param[in] delay     delay before the table start
+ *
+ * @api
+ */
+void chSTStartRel(st_timeline_t *stp, const st_table_t *tp,
+                  sysinterval_t delay) {
+
+  chSysLock();
+  chSTStartRelI(stp, tp, delay);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a table on an absolute time.
+ * @details If the timeline is already running then it is restarted.
+ *          Timelines started on the same time keep their phase
+ *          relationship.
+ * @note    The start time is considered in the future, if it is equal to
+ *          the current time then the points at offset zero are processed
+ *          on the next tick.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @param[in] tp        pointer to the @p st_table_t object
+ * @param[in] time      start time of the table
+ *
+ * @iclass
+ */
+void chSTStartAbsI(st_timeline_t *stp, const st_table_t *tp,
+                   systime_t time) {
+
+  chDbgCheckClassI();
+  chDbgCheck((stp != NULL) && (tp != NULL) && st_is_valid(tp));
+
+  chSTStopI(stp);
+  st_start(stp, tp, chTimeDiffX(chVTGetSystemTimeX(), time));
+}
+
+/**
+ * @brief   Starts a table on an absolute time.
+ * @details If the timeline is already running then it is restarted.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @param[in] tp        pointer to the @p st_table_t object
+ * @param[in] time      start time of the table
+ *
+ * @api
+ */
+void chSTStartAbs(st_timeline_t *stp, const st_table_t *tp,
+                  systime_t time) {
+
+  chSysLock();
+  chSTStartAbsI(stp, tp, time);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a table on the first synchronization.
+ * @details The timeline waits for a call to @p chSTSyncI(), the table is
+ *          started when the time base reaches the end of its cycle. If
+ *          the timeline is already running then it is stopped.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @param[in] tp        pointer to the @p st_table_t object
+ *
+ * @iclass
+ */
+void chSTStartSyncI(st_timeline_t *stp, const st_table_t *tp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((stp != NULL) && (tp != NULL) && st_is_valid(tp));
+
+  chSTStopI(stp);
+  stp->table = tp;
+  stp->state = ST_WAITING;
+}
+
+/**
+ * @brief   Starts a table on the first synchronization.
+ * @details The timeline waits for a call to @p chSTSync(), the table is
+ *          started when the time base reaches the end of its cycle. If
+ *          the timeline is already running then it is stopped.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @param[in] tp        pointer to the @p st_table_t object
+ *
+ * @api
+ */
+void chSTStartSync(st_timeline_t *stp, const st_table_t *tp) {
+
+  chSysLock();
+  chSTStartSyncI(stp, tp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Queues a table to be started at the end of the current cycle.
+ * @details The table replaces the running one at the end of its cycle,
+ *          the new table starts not synchronized. A table already queued
+ *          is replaced.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @param[in] tp        pointer to the @p st_table_t object or @p NULL in
+ *                      order to cancel a queued table
+ *
+ * @iclass
+ */
+void chSTNextI(st_timeline_t *stp, const st_table_t *tp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((stp != NULL) && ((tp == NULL) || st_is_valid(tp)));
+  chDbgAssert(stp->state == ST_RUNNING, "not running");
+
+  stp->next = tp;
+}
+
+/**
+ * @brief   Queues a table to be started at the end of the current cycle.
+ * @details The table replaces the running one at the end of its cycle,
+ *          the new table starts not synchronized. A table already queued
+ *          is replaced.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @param[in] tp        pointer to the @p st_table_t object or @p NULL in
+ *                      order to cancel a queued table
+ *
+ * @api
+ */
+void chSTNext(st_timeline_t *stp, const st_table_t *tp) {
+
+  chSysLock();
+  chSTNextI(stp, tp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Stops a timeline.
+ * @details The queued table, if any, is discarded. If the timeline is
+ *          already stopped then the function has no effect.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ *
+ * @iclass
+ */
+void chSTStopI(st_timeline_t *stp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(stp != NULL);
+
+  if (chVTIsArmedI(&stp->vt)) {
+    chVTResetI(&stp->vt);
+  }
+  stp->table     = NULL;
+  stp->next      = NULL;
+  stp->state     = ST_STOPPED;
+  stp->deviation = (sysinterval_t)0;
+  stp->synced    = false;
+}
+
+/**
+ * @brief   Stops a timeline.
+ * @details The queued table, if any, is discarded. If the timeline is
+ *          already stopped then the function has no effect.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ *
+ * @api
+ */
+void chSTStop(st_timeline_t *stp) {
+
+  chSysLock();
+  chSTStopI(stp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Synchronizes a timeline to an external time base.
+ * @details The deviation between the table position and the time base
+ *          is measured, the timeline is retarded if ahead of the time base
+ *          and advanced if behind it, by the shortest way. The correction
+ *          is performed on the following alarms, each alarm corrects up
+ *          to the maximum adjustment of the table.<br>
+ *          A timeline waiting for synchronization is started.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @param[in] value     current position of the time base within the
+ *                      table cycle
+ *
+ * @iclass
+ */
+void chSTSyncI(st_timeline_t *stp, sysinterval_t value) {
+  sysinterval_t duration, offset, remaining, pos, d;
+
+  chDbgCheckClassI();
+  chDbgCheck(stp != NULL);
+
+  if (stp->state == ST_STOPPED) {
+    return;
+  }
+
+  duration = stp->table->duration;
+  value %= duration;
+
+  if (stp->state == ST_WAITING) {
+    /* Starting on the next cycle start of the time base.*/
+    st_start(stp, stp->table, (duration - value) % duration);
+    stp->synced = true;
+    return;
+  }
+
+  /* Current position from the time of the next point, a retard can
+     move the cycle start after the current time.*/
+  offset    = st_next_offset(stp);
+  remaining = chTimeDiffX(chVTGetSystemTimeX(), stp->time);
+  if (remaining <= offset) {
+    pos = (offset - remaining) % duration;
+  }
+  else {
+    pos = duration - ((remaining - offset) % duration);
+  }
+
+  d = (pos + (duration - value)) % duration;
+  if (d <= (duration / (sysinterval_t)2)) {
+    stp->retard    = true;
+    stp->deviation = d;
+  }
+  else {
+    stp->retard    = false;
+    stp->deviation = duration - d;
+  }
+  stp->synced = true;
+}
+
+/**
+ * @brief   Synchronizes a timeline to an external time base.
+ * @details The deviation between the table position and the time base
+ *          is measured, the timeline is retarded if ahead of the time base
+ *          and advanced if behind it, by the shortest way. The correction
+ *          is performed on the following alarms, each alarm corrects up
+ *          to the maximum adjustment of the table.<br>
+ *          A timeline waiting for synchronization is started.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ * @param[in] value     current position of the time base within the
+ *                      table cycle
+ *
+ * @api
+ */
+void chSTSync(st_timeline_t *stp, sysinterval_t value) {
+
+  chSysLock();
+  chSTSyncI(stp, value);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Stops the synchronization of a timeline.
+ * @details The deviation not yet corrected is discarded.
+ *
+ * @param[in] stp       pointer to the @p st_timeline_t object
+ *
+ * @iclass
+ */
+void chSTSetAsyncI(st_timeline_t *stp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(stp != NULL);
+
+  stp->deviation = (sysinterval_t)0;
+  stp->synced    = false;
+}
+
+#endif /* CH_CFG_USE_SCHEDULE_TABLES == TRUE */
+
+/** @} */
@@ -59,6 +59,10 @@
 typedef struct condition_variable {
   threads_queue_t       queue;              /**< @brief Condition variable
                                                  threads queue.             */
+#if (CH_DBG_STATISTICS_LOCKS == TRUE) || defined(__DOXYGEN__)
+  lock_stats_t          stats;              /**< @brief Contention
+                                                 statistics.                */
+#endif
 } condition_variable_t;
 
 /*===========================================================================*/
@@ -72,7 +76,11 @@ typedef struct condition_variable {
  *
  * @param[in] name      the name of the condition variable
  */
+#if (CH_DBG_STATISTICS_LOCKS == TRUE) && !defined(__DOXYGEN__)
+#define _CONDVAR_DATA(name) {_THREADS_QUEUE_DATA(name.queue), _LOCK_STATS_DATA}
+#else
 #define _CONDVAR_DATA(name) {_THREADS_QUEUE_DATA(name.queue)}
+#endif
 
 /**
  * @brief Static condition variable initializer.
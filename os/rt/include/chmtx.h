@@ -64,6 +64,9 @@ struct ch_mutex {
 #if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
   cnt_t                 cnt;        /**< @brief Mutex recursion counter.    */
 #endif
+#if (CH_DBG_STATISTICS_LOCKS == TRUE) || defined(__DOXYGEN__)
+  lock_stats_t          stats;      /**< @brief Contention statistics.      */
+#endif
 };
 
 /*===========================================================================*/
@@ -77,7 +80,15 @@ struct ch_mutex {
  *
  * @param[in] name      the name of the mutex variable
  */
-#if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
+#if (CH_DBG_STATISTICS_LOCKS == TRUE) && !defined(__DOXYGEN__)
+#if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
+#define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.queue), NULL, NULL, 0,  \
+                           _LOCK_STATS_DATA}
+#else
+#define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.queue), NULL, NULL,     \
+                           _LOCK_STATS_DATA}
+#endif
+#elif (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
 #define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.queue), NULL, NULL, 0}
 #else
 #define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.queue), NULL, NULL}
@@ -293,12 +293,33 @@ struct ch_thread {
    */
   void                  *mpool;
 #endif
+#if (defined(CH_CFG_USE_RCU) && (CH_CFG_USE_RCU == TRUE)) ||                \
+    defined(__DOXYGEN__)
+  /**
+   * @brief   RCU read-side critical sections nesting.
+   */
+  ucnt_t                rcu_nesting;
+  /**
+   * @brief   Grace period phase of a preempted reader.
+   */
+  ucnt_t                rcu_phase;
+  /**
+   * @brief   Reader preempted inside a read-side critical section.
+   */
+  bool                  rcu_blocked;
+#endif
 #if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   Thread statistics.
    */
   time_measurement_t    stats;
 #endif
+#if (CH_DBG_STATISTICS_PMU == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Thread virtualized performance counters.
+   */
+  pmu_counters_t        pmu;
+#endif
 #if defined(CH_CFG_THREAD_EXTRA_FIELDS)
   /* Extra fields defined in chconf.h.*/
   CH_CFG_THREAD_EXTRA_FIELDS
@@ -342,6 +363,23 @@ struct ch_virtual_timers_list {
   systime_t             lasttime;   /**< @brief System time of the last
                                                 tick event.                 */
 #endif
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Time stamp of the last refresh.
+   * @details Its low bits are the counter value at the refresh time, the
+   *          high bits count the counter wraps.
+   */
+  volatile systimestamp_t laststamp;
+  /**
+   * @brief   Time stamp refresh sequence, odd while a refresh is in
+   *          progress.
+   */
+  volatile ucnt_t       stampseq;
+  /**
+   * @brief   Time stamp refresh timer.
+   */
+  virtual_timer_t       stampvt;
+#endif
 };
 
 /**
@@ -464,6 +502,7 @@ extern "C" {
   void _scheduler_init(void);
   thread_t *chSchReadyI(thread_t *tp);
   thread_t *chSchReadyAheadI(thread_t *tp);
+  thread_t *chSchRequeueReadyI(thread_t *tp);
   void chSchGoSleepS(tstate_t newstate);
   msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout);
   void chSchWakeupS(thread_t *ntp, msg_t msg);
@@ -53,6 +53,9 @@ typedef struct ch_semaphore {
   threads_queue_t       queue;      /**< @brief Queue of the threads sleeping
                                                 on this semaphore.          */
   cnt_t                 cnt;        /**< @brief The semaphore counter.      */
+#if (CH_DBG_STATISTICS_LOCKS == TRUE) || defined(__DOXYGEN__)
+  lock_stats_t          stats;      /**< @brief Contention statistics.      */
+#endif
 } semaphore_t;
 
 /*===========================================================================*/
@@ -68,7 +71,12 @@ typedef struct ch_semaphore {
  * @param[in] n         the counter initial value, this value must be
  *                      non-negative
  */
+#if (CH_DBG_STATISTICS_LOCKS == TRUE) && !defined(__DOXYGEN__)
+#define _SEMAPHORE_DATA(name, n) {_THREADS_QUEUE_DATA(name.queue), n,       \
+                                  _LOCK_STATS_DATA}
+#else
 #define _SEMAPHORE_DATA(name, n) {_THREADS_QUEUE_DATA(name.queue), n}
+#endif
 
 /**
  * @brief   Static semaphore initializer.
@@ -38,18 +38,214 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
-#if CH_CFG_USE_TM == FALSE
-#error "CH_DBG_STATISTICS requires CH_CFG_USE_TM"
+/**
+ * @brief   Number of IRQ vectors with dedicated statistics.
+ * @details If greater than zero then each ISR is measured between
+ *          @p CH_IRQ_PROLOGUE() and @p CH_IRQ_EPILOGUE() and accounted to
+ *          its vector number as returned by @p PORT_IRQ_GET_VECTOR().
+ * @note    Vectors beyond the specified number are accounted to the last
+ *          entry of the table.
+ * @note    The measured times include the time spent in nested ISRs.
+ */
+#if !defined(CH_DBG_STATISTICS_IRQ_VECTORS) || defined(__DOXYGEN__)
+#define CH_DBG_STATISTICS_IRQ_VECTORS       0
+#endif
+
+/**
+ * @brief   Number of critical zone call sites with dedicated statistics.
+ * @details If greater than zero then the duration of each critical zone is
+ *          also accounted to the call site of the @p chSysLock() or
+ *          @p chSysLockFromISR() that opened it. When the table is full
+ *          a new site replaces the entry with the shortest worst case
+ *          duration, if longer, so the table retains the sites holding
+ *          the longest critical zones.
+ * @note    The table is scanned on each critical zone exit, this adds
+ *          a significant overhead proportional to the table size.
+ */
+#if !defined(CH_DBG_STATISTICS_CRIT_SITES) || defined(__DOXYGEN__)
+#define CH_DBG_STATISTICS_CRIT_SITES        0
+#endif
+
+/**
+ * @brief   Number of buckets in the critical zones durations histogram.
+ * @details Bucket zero counts durations below
+ *          2^@p CH_DBG_STATISTICS_CRIT_HIST_BASE realtime counter cycles,
+ *          each following bucket doubles the upper limit, the last bucket
+ *          counts all the longer durations.
+ */
+#if !defined(CH_DBG_STATISTICS_CRIT_HIST_SIZE) || defined(__DOXYGEN__)
+#define CH_DBG_STATISTICS_CRIT_HIST_SIZE    8
+#endif
+
+/**
+ * @brief   Log2 of the upper limit of the first histogram bucket.
+ */
+#if !defined(CH_DBG_STATISTICS_CRIT_HIST_BASE) || defined(__DOXYGEN__)
+#define CH_DBG_STATISTICS_CRIT_HIST_BASE    4
+#endif
+
+/**
+ * @brief   Per-object contention statistics for synchronization objects.
+ * @details If enabled then mutexes, semaphores and condition variables
+ *          embed a @p lock_stats_t structure counting acquisitions,
+ *          contended acquisitions, wait times and, for mutexes, hold
+ *          times and priority inheritance boosts. Objects can be named
+ *          and linked into a registry using @p chStatsLockRegister().
+ */
+#if !defined(CH_DBG_STATISTICS_LOCKS) || defined(__DOXYGEN__)
+#define CH_DBG_STATISTICS_LOCKS             FALSE
+#endif
+
+/**
+ * @brief   Per-thread virtualized performance counters.
+ * @details If enabled then the port performance counters are sampled on
+ *          each context switch and the deltas are accumulated into the
+ *          @p pmu field of the thread being switched out, so each thread
+ *          sees its own counters.
+ * @note    Events occurring in ISRs are accounted to the interrupted
+ *          thread, as for the execution time.
+ * @note    Counters are only sampled on context switches, a counter
+ *          wrapping more than once between two switches is
+ *          under-accounted. Ports only export counters wide enough for
+ *          this to be unlikely.
+ * @note    Requires a port exporting @p PORT_PMU_COUNTERS.
+ */
+#if !defined(CH_DBG_STATISTICS_PMU) || defined(__DOXYGEN__)
+#define CH_DBG_STATISTICS_PMU               FALSE
+#endif
+
+/**
+ * @brief   Returns the return address of the current function.
+ * @details It is used for identifying the critical zones call sites.
+ */
+#if !defined(CH_DBG_STATISTICS_GET_CALLER) || defined(__DOXYGEN__)
+#if defined(__GNUC__) || defined(__DOXYGEN__)
+#define CH_DBG_STATISTICS_GET_CALLER()      __builtin_return_address(0)
+#else
+#define CH_DBG_STATISTICS_GET_CALLER()      NULL
+#endif
 #endif
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_USE_TM == FALSE
+#error "CH_DBG_STATISTICS requires CH_CFG_USE_TM"
+#endif
+
+#if CH_DBG_STATISTICS_IRQ_VECTORS < 0
+#error "invalid CH_DBG_STATISTICS_IRQ_VECTORS value"
+#endif
+
+#if (CH_DBG_STATISTICS_IRQ_VECTORS > 0) && !defined(PORT_IRQ_GET_VECTOR)
+#error "CH_DBG_STATISTICS_IRQ_VECTORS requires PORT_IRQ_GET_VECTOR()"
+#endif
+
+#if CH_DBG_STATISTICS_CRIT_SITES < 0
+#error "invalid CH_DBG_STATISTICS_CRIT_SITES value"
+#endif
+
+#if CH_DBG_STATISTICS_CRIT_HIST_SIZE < 1
+#error "invalid CH_DBG_STATISTICS_CRIT_HIST_SIZE value"
+#endif
+
+#if (CH_DBG_STATISTICS_CRIT_HIST_BASE < 0) ||                               \
+    (CH_DBG_STATISTICS_CRIT_HIST_BASE > 31)
+#error "invalid CH_DBG_STATISTICS_CRIT_HIST_BASE value"
+#endif
+
+#if (CH_DBG_STATISTICS_PMU == TRUE) && !defined(PORT_PMU_COUNTERS)
+#error "CH_DBG_STATISTICS_PMU not supported by this port"
+#endif
+
+/**
+ * @brief   Forced inlining of the critical zone entry functions.
+ * @details Call sites are identified by the return address of the
+ *          measurement start function so @p chSysLock() and
+ *          @p chSysLockFromISR() must be inlined in their callers at all
+ *          optimization levels, an out-of-line copy would otherwise be
+ *          the only call site of its translation unit.
+ */
+#if ((CH_DBG_STATISTICS_CRIT_SITES > 0) && defined(__GNUC__)) ||            \
+    defined(__DOXYGEN__)
+#define CH_STATS_FORCE_INLINE               __attribute__((always_inline))
+#else
+#define CH_STATS_FORCE_INLINE
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+#if (CH_DBG_STATISTICS_IRQ_VECTORS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a per-vector IRQ statistics structure.
+ * @note    The number of served IRQs is the @p n field of @p m_isr.
+ */
+typedef struct {
+  time_measurement_t    m_isr;      /**< @brief Measurement of the ISR
+                                                execution time.             */
+  cnt_t                 max_nesting;/**< @brief Maximum IRQ nesting level
+                                                observed on ISR entry.      */
+} irq_stats_t;
+#endif
+
+#if (CH_DBG_STATISTICS_CRIT_SITES > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a critical zone call site statistics structure.
+ */
+typedef struct {
+  const void            *site;      /**< @brief Call site address or
+                                                @p NULL if unused.          */
+  ucnt_t                n;          /**< @brief Number of critical zones.   */
+  rtcnt_t               worst;      /**< @brief Longest critical zone.      */
+  rttime_t              cumulative; /**< @brief Cumulative duration.        */
+  ucnt_t                hist[CH_DBG_STATISTICS_CRIT_HIST_SIZE];
+                                    /**< @brief Durations histogram.        */
+} crit_site_stats_t;
+#endif
+
+#if (CH_DBG_STATISTICS_LOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a synchronization object statistics structure.
+ */
+typedef struct ch_lock_stats lock_stats_t;
+
+/**
+ * @brief   Synchronization object statistics structure.
+ * @note    Hold times and boosts are only accounted for mutexes.
+ */
+struct ch_lock_stats {
+  lock_stats_t          *next;      /**< @brief Next registered object.     */
+  const char            *name;      /**< @brief Registered object name.     */
+  ucnt_t                n_acquired; /**< @brief Number of acquisitions.     */
+  ucnt_t                n_contended;/**< @brief Number of operations that
+                                                had to wait.                */
+  ucnt_t                n_boosts;   /**< @brief Number of priority
+                                                inheritance boosts.         */
+  rtsample_t            wait_worst; /**< @brief Longest wait.               */
+  rttime_t              wait_cumulative;
+                                    /**< @brief Cumulative wait time.       */
+  rtsample_t            hold_worst; /**< @brief Longest hold.               */
+  rttime_t              hold_cumulative;
+                                    /**< @brief Cumulative hold time.       */
+  rtsample_t            hold_start; /**< @brief Start of the current hold.  */
+};
+#endif
+
+#if (CH_DBG_STATISTICS_PMU == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a set of virtualized performance counters.
+ * @note    The meaning of each counter is port-dependent, names are
+ *          exported by the port as @p PORT_PMU_COUNTER_NAMES.
+ */
+typedef struct {
+  uint64_t              cnt[PORT_PMU_COUNTERS];
+                                    /**< @brief Accumulated counts.         */
+} pmu_counters_t;
+#endif
+
 /**
  * @brief   Type of a kernel statistics structure.
  */
@@ -60,12 +256,70 @@ typedef struct {
                                                 critical zones duration.    */
   time_measurement_t    m_crit_isr; /**< @brief Measurement of ISRs critical
                                                 zones duration.             */
+#if (CH_DBG_STATISTICS_IRQ_VECTORS > 0) || defined(__DOXYGEN__)
+  cnt_t                 irq_nesting;/**< @brief Current IRQ nesting level.  */
+  irq_stats_t           irq[CH_DBG_STATISTICS_IRQ_VECTORS];
+                                    /**< @brief Per-vector IRQ statistics.  */
+#endif
+#if (CH_DBG_STATISTICS_CRIT_SITES > 0) || defined(__DOXYGEN__)
+  const void            *crit_thd_site;
+                                    /**< @brief Call site of the current
+                                                thread critical zone.       */
+  const void            *crit_isr_site;
+                                    /**< @brief Call site of the current
+                                                ISR critical zone.          */
+  ucnt_t                crit_sites_dropped;
+                                    /**< @brief Number of critical zones
+                                                not accounted because the
+                                                table was full.             */
+  crit_site_stats_t     crit_sites[CH_DBG_STATISTICS_CRIT_SITES];
+                                    /**< @brief Per-site critical zones
+                                                statistics.                 */
+#endif
+#if (CH_DBG_STATISTICS_LOCKS == TRUE) || defined(__DOXYGEN__)
+  lock_stats_t          *locks;     /**< @brief Registered objects list.    */
+#endif
+#if (CH_DBG_STATISTICS_PMU == TRUE) || defined(__DOXYGEN__)
+  uint32_t              pmu_last[PORT_PMU_COUNTERS];
+                                    /**< @brief Counters values sampled on
+                                                the last context switch.    */
+#endif
 } kernel_stats_t;
 
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+#if (CH_DBG_STATISTICS_LOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Data part of a static lock statistics initializer.
+ */
+#define _LOCK_STATS_DATA {NULL, NULL, (ucnt_t)0, (ucnt_t)0, (ucnt_t)0,      \
+                          (rtsample_t)0, (rttime_t)0, (rtsample_t)0,        \
+                          (rttime_t)0, (rtsample_t)0}
+
+/**
+ * @brief   Marks the start of a wait on a synchronization object.
+ * @note    This macro declares a local variable so it must be placed where
+ *          a declaration is allowed.
+ *
+ * @notapi
+ */
+#define _stats_lock_wait_begin()                                            \
+  rtsample_t _stats_wait_start = _tm_get_sample()
+
+/**
+ * @brief   Marks the end of a wait on a synchronization object.
+ *
+ * @param[in] lsp       pointer to the @p lock_stats_t structure
+ * @param[in] acquired  @p true if the object has been acquired
+ *
+ * @notapi
+ */
+#define _stats_lock_wait_end(lsp, acquired)                                 \
+  _stats_lock_waited(lsp, _stats_wait_start, acquired)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -80,6 +334,28 @@ extern "C" {
   void _stats_stop_measure_crit_thd(void);
   void _stats_start_measure_crit_isr(void);
   void _stats_stop_measure_crit_isr(void);
+#if (CH_DBG_STATISTICS_IRQ_VECTORS > 0) || defined(__DOXYGEN__)
+  void _stats_start_measure_isr(void);
+  void _stats_stop_measure_isr(void);
+#endif
+#if (CH_DBG_STATISTICS_CRIT_SITES > 0) || defined(__DOXYGEN__)
+  void chStatsResetCritSitesI(void);
+#endif
+#if (CH_DBG_STATISTICS_LOCKS == TRUE) || defined(__DOXYGEN__)
+  void _stats_lock_init(lock_stats_t *lsp);
+  void _stats_lock_acquired(lock_stats_t *lsp);
+  void _stats_lock_waited(lock_stats_t *lsp, rtsample_t start,
+                          bool acquired);
+  void _stats_lock_released(lock_stats_t *lsp);
+  void _stats_lock_boost(lock_stats_t *lsp);
+  void chStatsLockRegister(lock_stats_t *lsp, const char *name);
+  void chStatsLockUnregister(lock_stats_t *lsp);
+  void chStatsLockResetI(lock_stats_t *lsp);
+#endif
+#if (CH_DBG_STATISTICS_PMU == TRUE) || defined(__DOXYGEN__)
+  void _stats_pmu_start(void);
+  void chStatsGetThreadPMUI(thread_t *tp, pmu_counters_t *pcp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -88,8 +364,42 @@ extern "C" {
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
+#if CH_DBG_STATISTICS_IRQ_VECTORS == 0
+/* Stub functions for when the per-vector statistics are disabled. */
+#define _stats_start_measure_isr()
+#define _stats_stop_measure_isr()
+#endif
+
+#if CH_DBG_STATISTICS_LOCKS == FALSE
+/* Stub functions for when the locks statistics are disabled. */
+#define _stats_lock_init(lsp)
+#define _stats_lock_acquired(lsp)
+#define _stats_lock_wait_begin()
+#define _stats_lock_wait_end(lsp, acquired)
+#define _stats_lock_released(lsp)
+#define _stats_lock_boost(lsp)
+#endif
+
 #else /* CH_DBG_STATISTICS == FALSE */
 
+#if !defined(CH_DBG_STATISTICS_LOCKS)
+#define CH_DBG_STATISTICS_LOCKS             FALSE
+#endif
+
+#if CH_DBG_STATISTICS_LOCKS == TRUE
+#error "CH_DBG_STATISTICS_LOCKS requires CH_DBG_STATISTICS"
+#endif
+
+#if !defined(CH_DBG_STATISTICS_PMU)
+#define CH_DBG_STATISTICS_PMU               FALSE
+#endif
+
+#if CH_DBG_STATISTICS_PMU == TRUE
+#error "CH_DBG_STATISTICS_PMU requires CH_DBG_STATISTICS"
+#endif
+
+#define CH_STATS_FORCE_INLINE
+
 /* Stub functions for when the statistics module is disabled. */
 #define _stats_increase_irq()
 #define _stats_ctxswc(old, new)
@@ -97,6 +407,14 @@ extern "C" {
 #define _stats_stop_measure_crit_thd()
 #define _stats_start_measure_crit_isr()
 #define _stats_stop_measure_crit_isr()
+#define _stats_start_measure_isr()
+#define _stats_stop_measure_isr()
+#define _stats_lock_init(lsp)
+#define _stats_lock_acquired(lsp)
+#define _stats_lock_wait_begin()
+#define _stats_lock_wait_end(lsp, acquired)
+#define _stats_lock_released(lsp)
+#define _stats_lock_boost(lsp)
 
 #endif /* CH_DBG_STATISTICS == FALSE */
 
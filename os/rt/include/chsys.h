@@ -110,6 +110,7 @@
   PORT_IRQ_PROLOGUE();                                                      \
   CH_CFG_IRQ_PROLOGUE_HOOK();                                               \
   _stats_increase_irq();                                                    \
+  _stats_start_measure_isr();                                               \
   _trace_isr_enter(__func__);                                               \
   _dbg_check_enter_isr()
 
@@ -124,6 +125,7 @@
 #define CH_IRQ_EPILOGUE()                                                   \
   _dbg_check_leave_isr();                                                   \
   _trace_isr_leave(__func__);                                               \
+  _stats_stop_measure_isr();                                                \
   CH_CFG_IRQ_EPILOGUE_HOOK();                                               \
   PORT_IRQ_EPILOGUE()
 
@@ -267,6 +269,7 @@
                                                                             \
   _trace_switch(ntp, otp);                                                  \
   _stats_ctxswc(ntp, otp);                                                  \
+  _rcu_switch(ntp, otp);                                                    \
   CH_CFG_CONTEXT_SWITCH_HOOK(ntp, otp);                                     \
   port_switch(ntp, otp);                                                    \
 }
@@ -350,7 +353,7 @@ static inline void chSysEnable(void) {
  *
  * @special
  */
-static inline void chSysLock(void) {
+static inline CH_STATS_FORCE_INLINE void chSysLock(void) {
 
   port_lock();
   _stats_start_measure_crit_thd();
@@ -390,7 +393,7 @@ static inline void chSysUnlock(void) {
  *
  * @special
  */
-static inline void chSysLockFromISR(void) {
+static inline CH_STATS_FORCE_INLINE void chSysLockFromISR(void) {
 
   port_lock_from_isr();
   _stats_start_measure_crit_isr();
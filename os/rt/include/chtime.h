@@ -69,6 +69,20 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   64 bits time stamps.
+ * @details If enabled the realtime counter, or the system time if the port
+ *          does not support it, is extended to 64 bits by a periodic
+ *          virtual timer. Time measurements and trace records are then
+ *          based on time stamps.
+ * @note    The refresh virtual timer is always armed, this prevents the
+ *          tick-less mode from stopping the system timer for long periods.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_TIMESTAMP) || defined(__DOXYGEN__)
+#define CH_CFG_USE_TIMESTAMP                FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -123,6 +137,15 @@ typedef uint32_t sysinterval_t;
 typedef uint16_t sysinterval_t;
 #endif
 
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a time stamp.
+ * @details Time stamps are 64 bits monotonic counters, they never wrap in
+ *          practice.
+ */
+typedef uint64_t systimestamp_t;
+#endif
+
 #if (CH_CFG_TIME_TYPES_SIZE == 32) || defined(__DOXYGEN__)
 /**
  * @brief   Type of seconds.
@@ -50,6 +50,17 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Type of a realtime sample.
+ * @details Samples are 64 bits time stamps if @p CH_CFG_USE_TIMESTAMP is
+ *          enabled else realtime counter values.
+ */
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+typedef systimestamp_t rtsample_t;
+#else
+typedef rtcnt_t rtsample_t;
+#endif
+
 /**
  * @brief   Type of a time measurement calibration data.
  */
@@ -63,16 +74,17 @@ typedef struct {
 /**
  * @brief   Type of a Time Measurement object.
  * @note    The maximum measurable time period depends on the implementation
- *          of the realtime counter and its clock frequency.
+ *          of the realtime counter and its clock frequency, it is not
+ *          limited if @p CH_CFG_USE_TIMESTAMP is enabled.
  * @note    The measurement is not 100% cycle-accurate, it can be in excess
  *          of few cycles depending on the compiler and target architecture.
  * @note    Interrupts can affect measurement if the measurement is performed
  *          with interrupts enabled.
  */
 typedef struct {
-  rtcnt_t               best;           /**< @brief Best measurement.       */
-  rtcnt_t               worst;          /**< @brief Worst measurement.      */
-  rtcnt_t               last;           /**< @brief Last measurement.       */
+  rtsample_t            best;           /**< @brief Best measurement.       */
+  rtsample_t            worst;          /**< @brief Worst measurement.      */
+  rtsample_t            last;           /**< @brief Last measurement.       */
   ucnt_t                n;              /**< @brief Number of measurements. */
   rttime_t              cumulative;     /**< @brief Cumulative measurement. */
 } time_measurement_t;
@@ -81,6 +93,17 @@ typedef struct {
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns a realtime sample.
+ *
+ * @notapi
+ */
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+#define _tm_get_sample()            chVTGetTimeStampX()
+#else
+#define _tm_get_sample()            chSysGetRealtimeCounterX()
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
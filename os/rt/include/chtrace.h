@@ -110,16 +110,32 @@ typedef struct {
    * @brief   Switched out thread state.
    */
   uint32_t              state:5;
+#if (CH_CFG_USE_TIMESTAMP == FALSE) || defined(__DOXYGEN__)
   /**
    * @brief   Accurate time stamp.
    * @note    This field only available if the post supports
    *          @p PORT_SUPPORTS_RT else it is set to zero.
+   * @note    This field is not used if @p CH_CFG_USE_TIMESTAMP is enabled,
+   *          the @p stamp field is used instead.
    */
   uint32_t              rtstamp:24;
+#else
+  uint32_t              reserved:24;
+#endif
   /**
    * @brief   System time stamp of the switch event.
    */
   systime_t             time;
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Accurate time stamp.
+   * @details It is the realtime counter extended to 64 bits if the port
+   *          supports @p PORT_SUPPORTS_RT else the extended system time.
+   * @note    This field is only available if @p CH_CFG_USE_TIMESTAMP is
+   *          enabled.
+   */
+  systimestamp_t        stamp;
+#endif
   union {
     /**
      * @brief   Structure representing a  context switch.
@@ -36,10 +36,37 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Realtime counter frequency in Hz.
+ * @details Time stamps count realtime counter cycles if the port supports
+ *          a realtime counter, this setting is required for converting
+ *          time stamps in time units. Zero means unknown frequency.
+ */
+#if !defined(CH_CFG_RT_FREQUENCY) || defined(__DOXYGEN__)
+#if defined(PORT_RT_FREQUENCY)
+#define CH_CFG_RT_FREQUENCY                 PORT_RT_FREQUENCY
+#else
+#define CH_CFG_RT_FREQUENCY                 0
+#endif
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+/**
+ * @brief   Time stamps frequency in Hz.
+ * @details Time stamps extend the realtime counter if the port supports
+ *          it, else the system time.
+ */
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+#if (PORT_SUPPORTS_RT == TRUE) || defined(__DOXYGEN__)
+#define CH_TIMESTAMP_FREQUENCY              CH_CFG_RT_FREQUENCY
+#else
+#define CH_TIMESTAMP_FREQUENCY              CH_CFG_ST_FREQUENCY
+#endif
+#endif
+
 #if (CH_CFG_ST_TIMEDELTA < 0) || (CH_CFG_ST_TIMEDELTA == 1)
 #error "invalid CH_CFG_ST_TIMEDELTA specified, must "                       \
        "be zero or greater than one"
@@ -75,6 +102,10 @@ extern "C" {
   void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
                   vtfunc_t vtfunc, void *par);
   void chVTDoResetI(virtual_timer_t *vtp);
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+  void _vt_stamp_start(void);
+  systimestamp_t chVTGetTimeStampX(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -141,6 +172,71 @@ static inline systime_t chVTGetSystemTime(void) {
   return systime;
 }
 
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Current time stamp.
+ * @details Returns a 64 bits monotonic time stamp, it extends the realtime
+ *          counter if the port supports it, else the system time.
+ *
+ * @return              The time stamp.
+ *
+ * @api
+ */
+static inline systimestamp_t chVTGetTimeStamp(void) {
+  systimestamp_t stamp;
+
+  chSysLock();
+  stamp = chVTGetTimeStampX();
+  chSysUnlock();
+
+  return stamp;
+}
+
+#if (CH_TIMESTAMP_FREQUENCY > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Time stamp to nanoseconds.
+ * @details Converts a time stamp, or a time stamps difference, to
+ *          nanoseconds.
+ * @note    The result is rounded down.
+ * @note    Only available if the time stamps frequency is known.
+ *
+ * @param[in] stamp     time stamp
+ * @return              The number of nanoseconds.
+ *
+ * @xclass
+ */
+static inline uint64_t chTimeStamp2NS(systimestamp_t stamp) {
+
+  return ((stamp / (systimestamp_t)CH_TIMESTAMP_FREQUENCY) *
+          (systimestamp_t)1000000000) +
+         (((stamp % (systimestamp_t)CH_TIMESTAMP_FREQUENCY) *
+           (systimestamp_t)1000000000) /
+          (systimestamp_t)CH_TIMESTAMP_FREQUENCY);
+}
+
+/**
+ * @brief   Time stamp to microseconds.
+ * @details Converts a time stamp, or a time stamps difference, to
+ *          microseconds.
+ * @note    The result is rounded down.
+ * @note    Only available if the time stamps frequency is known.
+ *
+ * @param[in] stamp     time stamp
+ * @return              The number of microseconds.
+ *
+ * @xclass
+ */
+static inline uint64_t chTimeStamp2US(systimestamp_t stamp) {
+
+  return ((stamp / (systimestamp_t)CH_TIMESTAMP_FREQUENCY) *
+          (systimestamp_t)1000000) +
+         (((stamp % (systimestamp_t)CH_TIMESTAMP_FREQUENCY) *
+           (systimestamp_t)1000000) /
+          (systimestamp_t)CH_TIMESTAMP_FREQUENCY);
+}
+#endif /* CH_TIMESTAMP_FREQUENCY > 0 */
+#endif /* CH_CFG_USE_TIMESTAMP == TRUE */
+
 /**
  * @brief   Returns the elapsed time since the specified start time.
  *
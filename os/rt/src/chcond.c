@@ -77,6 +77,7 @@ void chCondObjectInit(condition_variable_t *cp) {
   chDbgCheck(cp != NULL);
 
   queue_init(&cp->queue);
+  _stats_lock_init(&cp->stats);
 }
 
 /**
@@ -216,10 +217,12 @@ msg_t chCondWaitS(condition_variable_t *cp) {
 
   /* Start waiting on the condition variable, on exit the mutex is taken
      again.*/
+  _stats_lock_wait_begin();
   ctp->u.wtobjp = cp;
   queue_prio_insert(ctp, &cp->queue);
   chSchGoSleepS(CH_STATE_WTCOND);
   msg = ctp->u.rdymsg;
+  _stats_lock_wait_end(&cp->stats, msg == MSG_OK);
   chMtxLockS(mp);
 
   return msg;
@@ -305,9 +308,11 @@ msg_t chCondWaitTimeoutS(condition_variable_t *cp, sysinterval_t timeout) {
 
   /* Start waiting on the condition variable, on exit the mutex is taken
      again.*/
+  _stats_lock_wait_begin();
   currp->u.wtobjp = cp;
   queue_prio_insert(currp, &cp->queue);
   msg = chSchGoSleepTimeoutS(CH_STATE_WTCOND, timeout);
+  _stats_lock_wait_end(&cp->stats, msg == MSG_OK);
   if (msg != MSG_TIMEOUT) {
     chMtxLockS(mp);
   }
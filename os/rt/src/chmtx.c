@@ -109,6 +109,7 @@ void chMtxObjectInit(mutex_t *mp) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
   mp->cnt = (cnt_t)0;
 #endif
+  _stats_lock_init(&mp->stats);
 }
 
 /**
@@ -159,12 +160,14 @@ void chMtxLockS(mutex_t *mp) {
          boosting the priority of all the affected threads to equal the
          priority of the running thread requesting the mutex.*/
       thread_t *tp = mp->owner;
+      _stats_lock_wait_begin();
 
       /* Does the running thread have higher priority than the mutex
          owning thread? */
       while (tp->prio < ctp->prio) {
         /* Make priority of thread tp match the running thread's priority.*/
         tp->prio = ctp->prio;
+        _stats_lock_boost(&mp->stats);
 
         /* The following states need priority queues reordering.*/
         switch (tp->state) {
@@ -194,12 +197,8 @@ void chMtxLockS(mutex_t *mp) {
           break;
 #endif
         case CH_STATE_READY:
-#if CH_DBG_ENABLE_ASSERTS == TRUE
-          /* Prevents an assertion in chSchReadyI().*/
-          tp->state = CH_STATE_CURRENT;
-#endif
           /* Re-enqueues tp with its new priority on the ready list.*/
-          (void) chSchReadyI(queue_dequeue(tp));
+          (void) chSchRequeueReadyI(tp);
           break;
         default:
           /* Nothing to do for other states.*/
@@ -212,6 +211,7 @@ void chMtxLockS(mutex_t *mp) {
       queue_prio_insert(ctp, &mp->queue);
       ctp->u.wtmtxp = mp;
       chSchGoSleepS(CH_STATE_WTMTX);
+      _stats_lock_wait_end(&mp->stats, true);
 
       /* It is assumed that the thread performing the unlock operation assigns
          the mutex to this thread.*/
@@ -232,6 +232,7 @@ void chMtxLockS(mutex_t *mp) {
     mp->owner = ctp;
     mp->next = ctp->mtxlist;
     ctp->mtxlist = mp;
+    _stats_lock_acquired(&mp->stats);
   }
 }
 
@@ -305,6 +306,7 @@ bool chMtxTryLockS(mutex_t *mp) {
   mp->owner = currp;
   mp->next = currp->mtxlist;
   currp->mtxlist = mp;
+  _stats_lock_acquired(&mp->stats);
   return true;
 }
 
@@ -342,6 +344,7 @@ void chMtxUnlock(mutex_t *mp) {
        it as not owned. Note, it is assumed to be the same mutex passed as
        parameter of this function.*/
     ctp->mtxlist = mp->next;
+    _stats_lock_released(&mp->stats);
 
     /* If a thread is waiting on the mutex then the fun part begins.*/
     if (chMtxQueueNotEmptyS(mp)) {
@@ -428,6 +431,7 @@ void chMtxUnlockS(mutex_t *mp) {
        it as not owned. Note, it is assumed to be the same mutex passed as
        parameter of this function.*/
     ctp->mtxlist = mp->next;
+    _stats_lock_released(&mp->stats);
 
     /* If a thread is waiting on the mutex then the fun part begins.*/
     if (chMtxQueueNotEmptyS(mp)) {
@@ -490,6 +494,7 @@ void chMtxUnlockAllS(void) {
   while (ctp->mtxlist != NULL) {
     mutex_t *mp = ctp->mtxlist;
     ctp->mtxlist = mp->next;
+    _stats_lock_released(&mp->stats);
     if (chMtxQueueNotEmptyS(mp)) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
       mp->cnt = (cnt_t)1;
@@ -529,6 +534,7 @@ void chMtxUnlockAll(void) {
     do {
       mutex_t *mp = ctp->mtxlist;
       ctp->mtxlist = mp->next;
+      _stats_lock_released(&mp->stats);
       if (chMtxQueueNotEmptyS(mp)) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
         mp->cnt = (cnt_t)1;
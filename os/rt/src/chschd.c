@@ -277,6 +277,32 @@ thread_t *chSchReadyAheadI(thread_t *tp) {
   return tp;
 }
 
+/**
+ * @brief   Moves a ready thread in the Ready List after a priority change.
+ * @details The thread is positioned behind all threads with higher or equal
+ *          priority.
+ * @pre     The thread must be in the @p CH_STATE_READY state.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] tp        the thread whose priority has been changed
+ * @return              The thread pointer.
+ *
+ * @iclass
+ */
+thread_t *chSchRequeueReadyI(thread_t *tp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(tp != NULL);
+  chDbgAssert(tp->state == CH_STATE_READY, "not ready");
+
+  queue_prio_insert(queue_dequeue(tp), &ch.rlist.queue);
+
+  return tp;
+}
+
 /**
  * @brief   Puts the current thread to sleep into the specified state.
  * @details The thread goes into a sleeping state. The possible
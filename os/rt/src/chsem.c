@@ -100,6 +100,7 @@ void chSemObjectInit(semaphore_t *sp, cnt_t n) {
 
   queue_init(&sp->queue);
   sp->cnt = n;
+  _stats_lock_init(&sp->stats);
 }
 
 /**
@@ -203,12 +204,15 @@ msg_t chSemWaitS(semaphore_t *sp) {
               "inconsistent semaphore");
 
   if (--sp->cnt < (cnt_t)0) {
+    _stats_lock_wait_begin();
     currp->u.wtsemp = sp;
     sem_insert(currp, &sp->queue);
     chSchGoSleepS(CH_STATE_WTSEM);
+    _stats_lock_wait_end(&sp->stats, currp->u.rdymsg == MSG_OK);
 
     return currp->u.rdymsg;
   }
+  _stats_lock_acquired(&sp->stats);
 
   return MSG_OK;
 }
@@ -262,6 +266,7 @@ msg_t chSemWaitTimeout(semaphore_t *sp, sysinterval_t timeout) {
  * @sclass
  */
 msg_t chSemWaitTimeoutS(semaphore_t *sp, sysinterval_t timeout) {
+  msg_t msg;
 
   chDbgCheckClassS();
   chDbgCheck(sp != NULL);
@@ -275,11 +280,15 @@ msg_t chSemWaitTimeoutS(semaphore_t *sp, sysinterval_t timeout) {
 
       return MSG_TIMEOUT;
     }
+    _stats_lock_wait_begin();
     currp->u.wtsemp = sp;
     sem_insert(currp, &sp->queue);
+    msg = chSchGoSleepTimeoutS(CH_STATE_WTSEM, timeout);
+    _stats_lock_wait_end(&sp->stats, msg == MSG_OK);
 
-    return chSchGoSleepTimeoutS(CH_STATE_WTSEM, timeout);
+    return msg;
   }
+  _stats_lock_acquired(&sp->stats);
 
   return MSG_OK;
 }
@@ -392,12 +401,15 @@ msg_t chSemSignalWait(semaphore_t *sps, semaphore_t *spw) {
   }
   if (--spw->cnt < (cnt_t)0) {
     thread_t *ctp = currp;
+    _stats_lock_wait_begin();
     sem_insert(ctp, &spw->queue);
     ctp->u.wtsemp = spw;
     chSchGoSleepS(CH_STATE_WTSEM);
     msg = ctp->u.rdymsg;
+    _stats_lock_wait_end(&spw->stats, msg == MSG_OK);
   }
   else {
+    _stats_lock_acquired(&spw->stats);
     chSchRescheduleS();
     msg = MSG_OK;
   }
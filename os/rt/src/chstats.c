@@ -46,10 +46,142 @@
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if (CH_DBG_STATISTICS_PMU == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Significant bits of each performance counter.
+ */
+static const uint32_t pmu_masks[PORT_PMU_COUNTERS] = PORT_PMU_COUNTER_MASKS;
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_DBG_STATISTICS_IRQ_VECTORS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the statistics entry of the current IRQ vector.
+ *
+ * @return              Pointer to the statistics entry.
+ *
+ * @notapi
+ */
+static irq_stats_t *stats_get_irq(void) {
+  unsigned vector = (unsigned)PORT_IRQ_GET_VECTOR();
+
+  if (vector >= (unsigned)CH_DBG_STATISTICS_IRQ_VECTORS) {
+    vector = (unsigned)CH_DBG_STATISTICS_IRQ_VECTORS - 1U;
+  }
+
+  return &ch.kernel_stats.irq[vector];
+}
+#endif
+
+#if (CH_DBG_STATISTICS_CRIT_SITES > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Clears a critical zone call site entry.
+ *
+ * @param[out] csp      pointer to the entry
+ * @param[in] site      call site to be assigned to the entry
+ *
+ * @notapi
+ */
+static void stats_crit_site_init(crit_site_stats_t *csp, const void *site) {
+  unsigned i;
+
+  csp->site       = site;
+  csp->n          = (ucnt_t)0;
+  csp->worst      = (rtcnt_t)0;
+  csp->cumulative = (rttime_t)0;
+  for (i = 0U; i < (unsigned)CH_DBG_STATISTICS_CRIT_HIST_SIZE; i++) {
+    csp->hist[i] = (ucnt_t)0;
+  }
+}
+
+/**
+ * @brief   Accounts a critical zone to its call site.
+ *
+ * @param[in] site      call site of the critical zone
+ * @param[in] t         duration of the critical zone
+ *
+ * @notapi
+ */
+static void stats_crit_site_record(const void *site, rtcnt_t t) {
+  crit_site_stats_t *csp, *minp;
+  unsigned i;
+  rtcnt_t d;
+
+  /* Call site not available.*/
+  if (site == NULL) {
+    return;
+  }
+
+  /* Searching for the site or for a free entry, the entry with the
+     shortest worst case is remembered as replacement candidate.*/
+  minp = &ch.kernel_stats.crit_sites[0];
+  for (csp = &ch.kernel_stats.crit_sites[0];
+       csp < &ch.kernel_stats.crit_sites[CH_DBG_STATISTICS_CRIT_SITES];
+       csp++) {
+    if (csp->site == site) {
+      break;
+    }
+    if (csp->site == NULL) {
+      stats_crit_site_init(csp, site);
+      break;
+    }
+    if (csp->worst < minp->worst) {
+      minp = csp;
+    }
+  }
+
+  /* Table full, the new site replaces the least significant entry only if
+     longer.*/
+  if (csp >= &ch.kernel_stats.crit_sites[CH_DBG_STATISTICS_CRIT_SITES]) {
+    if (t <= minp->worst) {
+      ch.kernel_stats.crit_sites_dropped++;
+      return;
+    }
+    csp = minp;
+    stats_crit_site_init(csp, site);
+  }
+
+  csp->n++;
+  csp->cumulative += (rttime_t)t;
+  if (t > csp->worst) {
+    csp->worst = t;
+  }
+
+  /* Logarithmic histogram bucket.*/
+  d = t >> CH_DBG_STATISTICS_CRIT_HIST_BASE;
+  i = 0U;
+  while ((d > (rtcnt_t)0) &&
+         (i < ((unsigned)CH_DBG_STATISTICS_CRIT_HIST_SIZE - 1U))) {
+    d >>= 1;
+    i++;
+  }
+  csp->hist[i]++;
+}
+#endif
+
+#if (CH_DBG_STATISTICS_PMU == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Accumulates the counters deltas since the last sample.
+ *
+ * @param[in] last      counters values of the last sample
+ * @param[in] now       counters values of the current sample
+ * @param[in,out] pcp   counters set to be updated
+ *
+ * @notapi
+ */
+static void stats_pmu_accumulate(const uint32_t *last, const uint32_t *now,
+                                 pmu_counters_t *pcp) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)PORT_PMU_COUNTERS; i++) {
+    pcp->cnt[i] += (uint64_t)((now[i] - last[i]) & pmu_masks[i]);
+  }
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -65,6 +197,25 @@ void _stats_init(void) {
   ch.kernel_stats.n_ctxswc = (ucnt_t)0;
   chTMObjectInit(&ch.kernel_stats.m_crit_thd);
   chTMObjectInit(&ch.kernel_stats.m_crit_isr);
+#if CH_DBG_STATISTICS_IRQ_VECTORS > 0
+  {
+    unsigned i;
+
+    ch.kernel_stats.irq_nesting = (cnt_t)0;
+    for (i = 0U; i < (unsigned)CH_DBG_STATISTICS_IRQ_VECTORS; i++) {
+      chTMObjectInit(&ch.kernel_stats.irq[i].m_isr);
+      ch.kernel_stats.irq[i].max_nesting = (cnt_t)0;
+    }
+  }
+#endif
+#if CH_DBG_STATISTICS_CRIT_SITES > 0
+  ch.kernel_stats.crit_thd_site = NULL;
+  ch.kernel_stats.crit_isr_site = NULL;
+  chStatsResetCritSitesI();
+#endif
+#if CH_DBG_STATISTICS_LOCKS == TRUE
+  ch.kernel_stats.locks = NULL;
+#endif
 }
 
 /**
@@ -87,6 +238,18 @@ void _stats_ctxswc(thread_t *ntp, thread_t *otp) {
 
   ch.kernel_stats.n_ctxswc++;
   chTMChainMeasurementToX(&otp->stats, &ntp->stats);
+#if CH_DBG_STATISTICS_PMU == TRUE
+  {
+    uint32_t now[PORT_PMU_COUNTERS];
+    unsigned i;
+
+    port_pmu_read(now);
+    stats_pmu_accumulate(ch.kernel_stats.pmu_last, now, &otp->pmu);
+    for (i = 0U; i < (unsigned)PORT_PMU_COUNTERS; i++) {
+      ch.kernel_stats.pmu_last[i] = now[i];
+    }
+  }
+#endif
 }
 
 /**
@@ -94,6 +257,9 @@ void _stats_ctxswc(thread_t *ntp, thread_t *otp) {
  */
 void _stats_start_measure_crit_thd(void) {
 
+#if CH_DBG_STATISTICS_CRIT_SITES > 0
+  ch.kernel_stats.crit_thd_site = CH_DBG_STATISTICS_GET_CALLER();
+#endif
   chTMStartMeasurementX(&ch.kernel_stats.m_crit_thd);
 }
 
@@ -103,6 +269,10 @@ void _stats_start_measure_crit_thd(void) {
 void _stats_stop_measure_crit_thd(void) {
 
   chTMStopMeasurementX(&ch.kernel_stats.m_crit_thd);
+#if CH_DBG_STATISTICS_CRIT_SITES > 0
+  stats_crit_site_record(ch.kernel_stats.crit_thd_site,
+                         (rtcnt_t)ch.kernel_stats.m_crit_thd.last);
+#endif
 }
 
 /**
@@ -110,6 +280,9 @@ void _stats_stop_measure_crit_thd(void) {
  */
 void _stats_start_measure_crit_isr(void) {
 
+#if CH_DBG_STATISTICS_CRIT_SITES > 0
+  ch.kernel_stats.crit_isr_site = CH_DBG_STATISTICS_GET_CALLER();
+#endif
   chTMStartMeasurementX(&ch.kernel_stats.m_crit_isr);
 }
 
@@ -119,7 +292,244 @@ void _stats_start_measure_crit_isr(void) {
 void _stats_stop_measure_crit_isr(void) {
 
   chTMStopMeasurementX(&ch.kernel_stats.m_crit_isr);
+#if CH_DBG_STATISTICS_CRIT_SITES > 0
+  stats_crit_site_record(ch.kernel_stats.crit_isr_site,
+                         (rtcnt_t)ch.kernel_stats.m_crit_isr.last);
+#endif
+}
+
+#if (CH_DBG_STATISTICS_IRQ_VECTORS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the measurement of the current ISR.
+ * @note    The nesting level is updated in a critical zone because
+ *          higher priority ISRs can preempt this code.
+ */
+void _stats_start_measure_isr(void) {
+  irq_stats_t *isp = stats_get_irq();
+
+  port_lock_from_isr();
+  ch.kernel_stats.irq_nesting++;
+  if (ch.kernel_stats.irq_nesting > isp->max_nesting) {
+    isp->max_nesting = ch.kernel_stats.irq_nesting;
+  }
+  chTMStartMeasurementX(&isp->m_isr);
+  port_unlock_from_isr();
+}
+
+/**
+ * @brief   Stops the measurement of the current ISR.
+ */
+void _stats_stop_measure_isr(void) {
+  irq_stats_t *isp = stats_get_irq();
+
+  port_lock_from_isr();
+  chTMStopMeasurementX(&isp->m_isr);
+  ch.kernel_stats.irq_nesting--;
+  port_unlock_from_isr();
+}
+#endif
+
+#if (CH_DBG_STATISTICS_CRIT_SITES > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Clears the critical zones call sites table.
+ *
+ * @iclass
+ */
+void chStatsResetCritSitesI(void) {
+  unsigned i;
+
+  ch.kernel_stats.crit_sites_dropped = (ucnt_t)0;
+  for (i = 0U; i < (unsigned)CH_DBG_STATISTICS_CRIT_SITES; i++) {
+    stats_crit_site_init(&ch.kernel_stats.crit_sites[i], NULL);
+  }
+}
+#endif
+
+#if (CH_DBG_STATISTICS_LOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a synchronization object statistics structure.
+ * @note    A registered object must be unregistered before being
+ *          initialized again.
+ *
+ * @param[out] lsp      pointer to the @p lock_stats_t structure
+ *
+ * @notapi
+ */
+void _stats_lock_init(lock_stats_t *lsp) {
+
+  lsp->next = NULL;
+  lsp->name = NULL;
+  lsp->hold_start = (rtsample_t)0;
+  chStatsLockResetI(lsp);
+}
+
+/**
+ * @brief   Accounts an acquisition without waiting.
+ *
+ * @param[in] lsp       pointer to the @p lock_stats_t structure
+ *
+ * @notapi
+ */
+void _stats_lock_acquired(lock_stats_t *lsp) {
+
+  lsp->n_acquired++;
+  lsp->hold_start = _tm_get_sample();
+}
+
+/**
+ * @brief   Accounts an operation that had to wait.
+ *
+ * @param[in] lsp       pointer to the @p lock_stats_t structure
+ * @param[in] start     realtime sample at the start of the wait
+ * @param[in] acquired  @p true if the object has been acquired
+ *
+ * @notapi
+ */
+void _stats_lock_waited(lock_stats_t *lsp, rtsample_t start,
+                        bool acquired) {
+  rtsample_t now = _tm_get_sample();
+  rtsample_t t = now - start;
+
+  lsp->n_contended++;
+  lsp->wait_cumulative += (rttime_t)t;
+  if (t > lsp->wait_worst) {
+    lsp->wait_worst = t;
+  }
+  if (acquired) {
+    lsp->n_acquired++;
+    lsp->hold_start = now;
+  }
+}
+
+/**
+ * @brief   Accounts the release of a mutex.
+ *
+ * @param[in] lsp       pointer to the @p lock_stats_t structure
+ *
+ * @notapi
+ */
+void _stats_lock_released(lock_stats_t *lsp) {
+  rtsample_t t = _tm_get_sample() - lsp->hold_start;
+
+  lsp->hold_cumulative += (rttime_t)t;
+  if (t > lsp->hold_worst) {
+    lsp->hold_worst = t;
+  }
+}
+
+/**
+ * @brief   Accounts a priority inheritance boost.
+ *
+ * @param[in] lsp       pointer to the @p lock_stats_t structure
+ *
+ * @notapi
+ */
+void _stats_lock_boost(lock_stats_t *lsp) {
+
+  lsp->n_boosts++;
+}
+
+/**
+ * @brief   Adds a synchronization object to the statistics registry.
+ *
+ * @param[in] lsp       pointer to the @p lock_stats_t structure
+ * @param[in] name      name to be assigned to the object
+ *
+ * @api
+ */
+void chStatsLockRegister(lock_stats_t *lsp, const char *name) {
+
+  chDbgCheck(lsp != NULL);
+
+  chSysLock();
+  lsp->name = name;
+  lsp->next = ch.kernel_stats.locks;
+  ch.kernel_stats.locks = lsp;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Removes a synchronization object from the statistics registry.
+ *
+ * @param[in] lsp       pointer to the @p lock_stats_t structure
+ *
+ * @api
+ */
+void chStatsLockUnregister(lock_stats_t *lsp) {
+  lock_stats_t **lspp;
+
+  chDbgCheck(lsp != NULL);
+
+  chSysLock();
+  lspp = &ch.kernel_stats.locks;
+  while (*lspp != NULL) {
+    if (*lspp == lsp) {
+      *lspp = lsp->next;
+      lsp->next = NULL;
+      break;
+    }
+    lspp = &(*lspp)->next;
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Clears the counters of a synchronization object.
+ *
+ * @param[in] lsp       pointer to the @p lock_stats_t structure
+ *
+ * @iclass
+ */
+void chStatsLockResetI(lock_stats_t *lsp) {
+
+  lsp->n_acquired      = (ucnt_t)0;
+  lsp->n_contended     = (ucnt_t)0;
+  lsp->n_boosts        = (ucnt_t)0;
+  lsp->wait_worst      = (rtsample_t)0;
+  lsp->wait_cumulative = (rttime_t)0;
+  lsp->hold_worst      = (rtsample_t)0;
+  lsp->hold_cumulative = (rttime_t)0;
+}
+#endif
+
+#if (CH_DBG_STATISTICS_PMU == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the performance counters.
+ * @details The counters are initialized and sampled, from this point on
+ *          the events are accounted to the current thread.
+ *
+ * @notapi
+ */
+void _stats_pmu_start(void) {
+
+  port_pmu_init();
+  port_pmu_read(ch.kernel_stats.pmu_last);
+}
+
+/**
+ * @brief   Returns the virtualized performance counters of a thread.
+ * @details For the current thread the events since the last context
+ *          switch are included.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[out] pcp      pointer to the counters set to be written
+ *
+ * @iclass
+ */
+void chStatsGetThreadPMUI(thread_t *tp, pmu_counters_t *pcp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((tp != NULL) && (pcp != NULL));
+
+  *pcp = tp->pmu;
+  if (tp == currp) {
+    uint32_t now[PORT_PMU_COUNTERS];
+
+    port_pmu_read(now);
+    stats_pmu_accumulate(ch.kernel_stats.pmu_last, now, pcp);
+  }
 }
+#endif
 
 #endif /* CH_DBG_STATISTICS == TRUE */
 
@@ -119,6 +119,9 @@ void chSysInit(void) {
 #if CH_CFG_USE_FACTORY == TRUE
   _factory_init();
 #endif
+#if CH_CFG_USE_RCU == TRUE
+  _rcu_init();
+#endif
 #if CH_DBG_STATISTICS == TRUE
   _stats_init();
 #endif
@@ -158,12 +161,25 @@ void chSysInit(void) {
   chTMStartMeasurementX(&currp->stats);
 #endif
 
+#if CH_DBG_STATISTICS_PMU == TRUE
+  /* Starting the performance counters, events are accounted to this
+     thread from now on.*/
+  _stats_pmu_start();
+#endif
+
   /* Initialization hook.*/
   CH_CFG_SYSTEM_INIT_HOOK();
 
   /* It is alive now.*/
   chSysEnable();
 
+#if CH_CFG_USE_TIMESTAMP == TRUE
+  /* Time stamps are kept extended by a periodic virtual timer.*/
+  chSysLock();
+  _vt_stamp_start();
+  chSysUnlock();
+#endif
+
 #if CH_CFG_NO_IDLE_THREAD == FALSE
   {
     static const thread_descriptor_t idle_descriptor = {
@@ -116,8 +116,21 @@ thread_t *_thread_init(thread_t *tp, const char *name, tprio_t prio) {
 #if CH_CFG_USE_MESSAGES == TRUE
   queue_init(&tp->msgqueue);
 #endif
+#if CH_CFG_USE_RCU == TRUE
+  tp->rcu_nesting = (ucnt_t)0;
+  tp->rcu_blocked = false;
+#endif
 #if CH_DBG_STATISTICS == TRUE
   chTMObjectInit(&tp->stats);
+#endif
+#if CH_DBG_STATISTICS_PMU == TRUE
+  {
+    unsigned i;
+
+    for (i = 0U; i < (unsigned)PORT_PMU_COUNTERS; i++) {
+      tp->pmu.cnt[i] = (uint64_t)0;
+    }
+  }
 #endif
   CH_CFG_THREAD_INIT_HOOK(tp);
   return tp;
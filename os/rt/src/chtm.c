@@ -51,11 +51,17 @@
 /*===========================================================================*/
 
 static inline void tm_stop(time_measurement_t *tmp,
-                           rtcnt_t now,
+                           rtsample_t now,
                            rtcnt_t offset) {
 
   tmp->n++;
-  tmp->last = (now - tmp->last) - offset;
+  tmp->last = now - tmp->last;
+  if (tmp->last > (rtsample_t)offset) {
+    tmp->last -= (rtsample_t)offset;
+  }
+  else {
+    tmp->last = (rtsample_t)0;
+  }
   tmp->cumulative += (rttime_t)tmp->last;
   if (tmp->last > tmp->worst) {
     tmp->worst = tmp->last;
@@ -84,7 +90,7 @@ void _tm_init(void) {
   chTMObjectInit(&tm);
   chTMStartMeasurementX(&tm);
   chTMStopMeasurementX(&tm);
-  ch.tm.offset = tm.last;
+  ch.tm.offset = (rtcnt_t)tm.last;
 }
 
 /**
@@ -96,9 +102,9 @@ void _tm_init(void) {
  */
 void chTMObjectInit(time_measurement_t *tmp) {
 
-  tmp->best       = (rtcnt_t)-1;
-  tmp->worst      = (rtcnt_t)0;
-  tmp->last       = (rtcnt_t)0;
+  tmp->best       = (rtsample_t)-1;
+  tmp->worst      = (rtsample_t)0;
+  tmp->last       = (rtsample_t)0;
   tmp->n          = (ucnt_t)0;
   tmp->cumulative = (rttime_t)0;
 }
@@ -113,7 +119,7 @@ void chTMObjectInit(time_measurement_t *tmp) {
  */
 NOINLINE void chTMStartMeasurementX(time_measurement_t *tmp) {
 
-  tmp->last = chSysGetRealtimeCounterX();
+  tmp->last = _tm_get_sample();
 }
 
 /**
@@ -126,7 +132,7 @@ NOINLINE void chTMStartMeasurementX(time_measurement_t *tmp) {
  */
 NOINLINE void chTMStopMeasurementX(time_measurement_t *tmp) {
 
-  tm_stop(tmp, chSysGetRealtimeCounterX(), ch.tm.offset);
+  tm_stop(tmp, _tm_get_sample(), ch.tm.offset);
 }
 
 /**
@@ -145,7 +151,7 @@ NOINLINE void chTMChainMeasurementToX(time_measurement_t *tmp1,
                                       time_measurement_t *tmp2) {
 
   /* Starts new measurement.*/
-  tmp2->last = chSysGetRealtimeCounterX();
+  tmp2->last = _tm_get_sample();
 
   /* Stops previous measurement using the same time stamp.*/
   tm_stop(tmp1, tmp2->last, (rtcnt_t)0);
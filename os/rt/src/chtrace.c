@@ -56,11 +56,17 @@
  */
 static NOINLINE void trace_next(void) {
 
+#if CH_CFG_USE_TIMESTAMP == TRUE
+  ch.dbg.trace_buffer.ptr->time     = chVTGetSystemTimeX();
+  ch.dbg.trace_buffer.ptr->reserved = 0U;
+  ch.dbg.trace_buffer.ptr->stamp    = chVTGetTimeStampX();
+#else
   ch.dbg.trace_buffer.ptr->time    = chVTGetSystemTimeX();
 #if PORT_SUPPORTS_RT == TRUE
   ch.dbg.trace_buffer.ptr->rtstamp = chSysGetRealtimeCounterX();
 #else
   ch.dbg.trace_buffer.ptr->rtstamp = (rtcnt_t)0;
+#endif
 #endif
 
   /* Trace hook, useful in order to interface debug tools.*/
@@ -32,6 +32,42 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of the counter extended by time stamps.
+ */
+#if (PORT_SUPPORTS_RT == TRUE) || defined(__DOXYGEN__)
+typedef rtcnt_t stampcnt_t;
+#else
+typedef systime_t stampcnt_t;
+#endif
+
+/**
+ * @brief   Time stamp refresh period in system ticks.
+ * @details The counter must not wrap twice between refreshes, the period is
+ *          one second unless the counter is faster than 1GHz or the system
+ *          time is narrower.
+ */
+#if (PORT_SUPPORTS_RT == TRUE) && (CH_CFG_RT_FREQUENCY > 1000000000)
+#define STAMP_REFRESH_TICKS                                                 \
+  ((0x40000000ULL * CH_CFG_ST_FREQUENCY) / CH_CFG_RT_FREQUENCY)
+#else
+#define STAMP_REFRESH_TICKS         CH_CFG_ST_FREQUENCY
+#endif
+
+#if (CH_CFG_ST_RESOLUTION < 64) &&                                          \
+    (STAMP_REFRESH_TICKS > (1ULL << (CH_CFG_ST_RESOLUTION - 2)))
+#define STAMP_REFRESH_PERIOD                                                \
+  ((sysinterval_t)(1ULL << (CH_CFG_ST_RESOLUTION - 2)))
+#else
+#define STAMP_REFRESH_PERIOD        ((sysinterval_t)STAMP_REFRESH_TICKS)
+#endif
+
+#if STAMP_REFRESH_TICKS < 1
+#error "time stamps counter too fast for the system tick"
+#endif
+#endif /* CH_CFG_USE_TIMESTAMP == TRUE */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -48,6 +84,57 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reads the counter extended by time stamps.
+ */
+static inline stampcnt_t stamp_get_counter(void) {
+
+#if PORT_SUPPORTS_RT == TRUE
+  return chSysGetRealtimeCounterX();
+#else
+  return chVTGetSystemTimeX();
+#endif
+}
+
+/**
+ * @brief   Extends a counter value using a previous time stamp.
+ * @note    The counter must not have wrapped more than once since the
+ *          time stamp.
+ */
+static inline systimestamp_t stamp_extend(systimestamp_t last,
+                                          stampcnt_t now) {
+
+  return last + (systimestamp_t)(stampcnt_t)(now - (stampcnt_t)last);
+}
+
+/**
+ * @brief   Time stamp refresh.
+ * @note    Must be called from within a lock zone.
+ */
+static void stamp_refresh(void) {
+
+  ch.vtlist.stampseq++;
+  ch.vtlist.laststamp = stamp_extend(ch.vtlist.laststamp,
+                                     stamp_get_counter());
+  ch.vtlist.stampseq++;
+}
+
+/**
+ * @brief   Time stamp refresh timer callback.
+ */
+static void stamp_refresh_cb(void *p) {
+
+  (void)p;
+
+  chSysLockFromISR();
+  stamp_refresh();
+  chVTDoSetI(&ch.vtlist.stampvt, STAMP_REFRESH_PERIOD,
+             stamp_refresh_cb, NULL);
+  chSysUnlockFromISR();
+}
+#endif /* CH_CFG_USE_TIMESTAMP == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -68,7 +155,54 @@ void _vt_init(void) {
 #else /* CH_CFG_ST_TIMEDELTA > 0 */
   ch.vtlist.lasttime = (systime_t)0;
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
+#if CH_CFG_USE_TIMESTAMP == TRUE
+  ch.vtlist.laststamp = (systimestamp_t)0;
+  ch.vtlist.stampseq = (ucnt_t)0;
+  chVTObjectInit(&ch.vtlist.stampvt);
+#endif
+}
+
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the time stamps refresh.
+ * @note    Internal use only.
+ *
+ * @notapi
+ */
+void _vt_stamp_start(void) {
+
+  chDbgCheckClassI();
+
+  stamp_refresh();
+  chVTDoSetI(&ch.vtlist.stampvt, STAMP_REFRESH_PERIOD,
+             stamp_refresh_cb, NULL);
+}
+
+/**
+ * @brief   Current time stamp.
+ * @details Returns a 64 bits monotonic time stamp, it extends the realtime
+ *          counter if the port supports it, else the system time.
+ * @note    This function is lock-free, it can be called from any context
+ *          except fast interrupts, it can also be called from within a
+ *          lock zone.
+ *
+ * @return              The time stamp.
+ *
+ * @xclass
+ */
+systimestamp_t chVTGetTimeStampX(void) {
+  systimestamp_t stamp;
+  ucnt_t seq;
+
+  /* The last stamp is re-read if a refresh happened in the meanwhile.*/
+  do {
+    seq = ch.vtlist.stampseq;
+    stamp = stamp_extend(ch.vtlist.laststamp, stamp_get_counter());
+  } while (((seq & (ucnt_t)1) != (ucnt_t)0) || (seq != ch.vtlist.stampseq));
+
+  return stamp;
 }
+#endif /* CH_CFG_USE_TIMESTAMP == TRUE */
 
 /**
  * @brief   Enables a virtual timer.
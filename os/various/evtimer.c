@@ -17,6 +17,13 @@
 /**
  * @file    evtimer.c
  * @brief   Events Generator Timer code.
+ * @details Event timers broadcast an event source, with optional flags,
+ *          once or periodically. Periodic timers are re-armed on absolute
+ *          times so latencies do not accumulate.<br>
+ *          All the armed event timers are kept in a list ordered by
+ *          expiration time, a single virtual timer is programmed on the
+ *          first expiration and serves all the timers expiring at the
+ *          same time in a single callback.
  *
  * @addtogroup event_timer
  * @{
@@ -29,6 +36,11 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Pointer to the armed timers list header.
+ */
+#define evt_header                  (&evt_list)
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -41,16 +53,158 @@
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Armed timers list header.
+ * @note    Only the links are used, the header is an @p event_timer_t in
+ *          order to be handled as the list elements.
+ */
+static event_timer_t evt_list = {
+  evt_header,
+  evt_header,
+  (systime_t)0,
+  (sysinterval_t)0,
+  (sysinterval_t)0,
+  NULL,
+  (eventflags_t)0,
+  _EVENTSOURCE_DATA(evt_list.et_es)
+};
+
+/**
+ * @brief   Reference time for the list ordering.
+ * @note    It is never after the first expiration time except while
+ *          the virtual timer callback is pending.
+ */
+static systime_t evt_lasttime;
+
+/**
+ * @brief   Virtual timer serving the armed timers list.
+ */
+static virtual_timer_t evt_vt;
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
-static void tmrcb(void *p) {
-  event_timer_t *etp = p;
+static void evt_cb(void *p);
+
+/**
+ * @brief   Position of a time in the list ordering.
+ */
+static inline sysinterval_t evt_key(systime_t time) {
+
+  return chTimeDiffX(evt_lasttime, time);
+}
+
+/**
+ * @brief   Inserts a timer in the armed timers list.
+ * @note    The list is scanned starting from the end closer to the
+ *          expiration time, re-armed periodic timers are usually placed
+ *          near the list end.
+ *
+ * @param[in] etp       pointer to the @p event_timer_t structure
+ */
+static void evt_insert(event_timer_t *etp) {
+  sysinterval_t key = evt_key(etp->et_time);
+  event_timer_t *p = evt_list.et_prev;
+
+  if ((p != evt_header) && (evt_key(p->et_time) > key)) {
+    sysinterval_t first = evt_key(evt_list.et_next->et_time);
+
+    if ((key < first) || ((key - first) < (evt_key(p->et_time) - key))) {
+      /* Scanning forward, stopping on the last timer expiring before or
+         together with the new one.*/
+      p = evt_header;
+      while ((p->et_next != evt_header) &&
+             (evt_key(p->et_next->et_time) <= key)) {
+        p = p->et_next;
+      }
+    }
+    else {
+      /* Scanning backward.*/
+      while ((p != evt_header) && (evt_key(p->et_time) > key)) {
+        p = p->et_prev;
+      }
+    }
+  }
+
+  etp->et_prev = p;
+  etp->et_next = p->et_next;
+  etp->et_next->et_prev = etp;
+  p->et_next = etp;
+}
+
+/**
+ * @brief   Programs the virtual timer on the first expiration.
+ *
+ * @param[in] now       current system time
+ */
+static void evt_schedule(systime_t now) {
+  sysinterval_t delay;
+
+  if (chVTIsArmedI(&evt_vt)) {
+    chVTResetI(&evt_vt);
+  }
+
+  if (evt_list.et_next != evt_header) {
+    delay = chTimeDiffX(now, evt_list.et_next->et_time);
+    if (delay == (sysinterval_t)0) {
+      delay = (sysinterval_t)1;
+    }
+    chVTDoSetI(&evt_vt, delay, evt_cb, NULL);
+  }
+}
+
+/**
+ * @brief   Virtual timer callback.
+ * @details Broadcasts all the expired timers then re-arms the periodic
+ *          ones, periods missed because latencies are skipped.
+ *
+ * @param[in] p         not used
+ */
+static void evt_cb(void *p) {
+  event_timer_t *etp, *endp;
+  systime_t now;
+  sysinterval_t elapsed;
+
+  (void)p;
 
   chSysLockFromISR();
-  chEvtBroadcastI(&etp->et_es);
-  chVTDoSetI(&etp->et_vt, etp->et_interval, tmrcb, etp);
+
+  /* Expired timers are the first part of the list, detaching them.*/
+  now = chVTGetSystemTimeX();
+  elapsed = evt_key(now);
+  etp = evt_list.et_next;
+  endp = etp;
+  while ((endp != evt_header) && (evt_key(endp->et_time) <= elapsed)) {
+    endp = endp->et_next;
+  }
+  evt_list.et_next = endp;
+  endp->et_prev = evt_header;
+
+  /* The remaining timers expire after now, it becomes the reference.*/
+  evt_lasttime = now;
+
+  while (etp != endp) {
+    event_timer_t *nextp = etp->et_next;
+
+    chEvtBroadcastFlagsI(etp->et_esp, etp->et_flags);
+
+    if (etp->et_period > (sysinterval_t)0) {
+      sysinterval_t late = chTimeDiffX(etp->et_time, now);
+
+      etp->et_time = chTimeAddX(etp->et_time,
+                                late - (late % etp->et_period) +
+                                etp->et_period);
+      evt_insert(etp);
+    }
+    else {
+      etp->et_next = NULL;
+    }
+    etp = nextp;
+  }
+
+  evt_schedule(now);
+
   chSysUnlockFromISR();
 }
 
@@ -59,27 +213,168 @@ static void tmrcb(void *p) {
 /*===========================================================================*/
 
 /**
- * @brief Initializes an @p event_timer_t structure.
+ * @brief   Initializes an @p event_timer_t structure.
+ * @details The timer broadcasts its own event source @p et_es without
+ *          flags.
  *
  * @param[out] etp      the @p event_timer_t structure to be initialized
- * @param[in] time      the interval in system ticks
+ * @param[in] interval  the period used by @p evtStart() and
+ *                      @p evtStartAt(), in system ticks
+ *
+ * @init
  */
-void evtObjectInit(event_timer_t *etp, systime_t time) {
+void evtObjectInit(event_timer_t *etp, sysinterval_t interval) {
+
+  chDbgCheck(etp != NULL);
 
   chEvtObjectInit(&etp->et_es);
-  chVTObjectInit(&etp->et_vt);
-  etp->et_interval = time;
+  etp->et_next     = NULL;
+  etp->et_prev     = NULL;
+  etp->et_time     = (systime_t)0;
+  etp->et_period   = (sysinterval_t)0;
+  etp->et_interval = interval;
+  etp->et_esp      = &etp->et_es;
+  etp->et_flags    = (eventflags_t)0;
 }
 
 /**
- * @brief   Starts the timer
- * @details If the timer was already running then the function has no effect.
+ * @brief   Starts the timer on an absolute time.
+ * @details If the timer was already running then it is restarted.
+ * @note    If @p time is not after the current system time then the first
+ *          expiration happens on the next tick.
+ *
+ * @param[in] etp       pointer to an initialized @p event_timer_t structure
+ * @param[in] time      absolute time of the first expiration
+ * @param[in] period    period of the following expirations, zero for a
+ *                      one-shot timer
  *
- * @param[in] etp       pointer to an initialized @p event_timer_t structure.
+ * @iclass
+ */
+void evtStartAtI(event_timer_t *etp, systime_t time, sysinterval_t period) {
+  systime_t now;
+
+  chDbgCheckClassI();
+  chDbgCheck(etp != NULL);
+
+  if (etp->et_next != NULL) {
+    evtStopI(etp);
+  }
+
+  /* If the list is empty or none of the timers is overdue then the
+     current time can become the reference, keys are kept small.*/
+  now = chVTGetSystemTimeX();
+  if ((evt_list.et_next == evt_header) ||
+      (evt_key(now) <= evt_key(evt_list.et_next->et_time))) {
+    evt_lasttime = now;
+  }
+
+  if (evt_key(time) <= evt_key(now)) {
+    time = chTimeAddX(now, (sysinterval_t)1);
+  }
+
+  etp->et_time   = time;
+  etp->et_period = period;
+  evt_insert(etp);
+
+  /* A new first timer requires the virtual timer to be re-programmed.*/
+  if (evt_list.et_next == etp) {
+    evt_schedule(now);
+  }
+}
+
+/**
+ * @brief   Starts the timer in periodic mode.
+ * @details The first expiration happens after the timer interval. If the
+ *          timer was already running then it is restarted.
+ *
+ * @param[in] etp       pointer to an initialized @p event_timer_t structure
+ *
+ * @api
  */
 void evtStart(event_timer_t *etp) {
 
-  chVTSet(&etp->et_vt, etp->et_interval, tmrcb, etp);
+  chDbgCheck(etp != NULL);
+  chDbgAssert(etp->et_interval > (sysinterval_t)0, "zero interval");
+
+  chSysLock();
+  evtStartAtI(etp, chTimeAddX(chVTGetSystemTimeX(), etp->et_interval),
+              etp->et_interval);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts the timer in periodic mode from an absolute time.
+ * @details Timers started on the same time keep their phase relationship.
+ *          If the timer interval is zero then the timer expires once. If
+ *          the timer was already running then it is restarted.
+ *
+ * @param[in] etp       pointer to an initialized @p event_timer_t structure
+ * @param[in] time      absolute time of the first expiration
+ *
+ * @api
+ */
+void evtStartAt(event_timer_t *etp, systime_t time) {
+
+  chSysLock();
+  evtStartAtI(etp, time, etp->et_interval);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts the timer in one-shot mode.
+ * @details If the timer was already running then it is restarted.
+ *
+ * @param[in] etp       pointer to an initialized @p event_timer_t structure
+ * @param[in] delay     delay before the expiration, in system ticks
+ *
+ * @api
+ */
+void evtStartOneShot(event_timer_t *etp, sysinterval_t delay) {
+
+  chSysLock();
+  evtStartAtI(etp, chTimeAddX(chVTGetSystemTimeX(), delay), (sysinterval_t)0);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Stops the timer.
+ * @details If the timer was already stopped then the function has no effect.
+ * @note    The virtual timer is not re-programmed when the first timer is
+ *          stopped, the next callback could find nothing to do.
+ *
+ * @param[in] etp       pointer to an initialized @p event_timer_t structure
+ *
+ * @iclass
+ */
+void evtStopI(event_timer_t *etp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(etp != NULL);
+
+  if (etp->et_next != NULL) {
+    etp->et_prev->et_next = etp->et_next;
+    etp->et_next->et_prev = etp->et_prev;
+    etp->et_next = NULL;
+
+    if ((evt_list.et_next == evt_header) && chVTIsArmedI(&evt_vt)) {
+      chVTResetI(&evt_vt);
+    }
+  }
+}
+
+/**
+ * @brief   Stops the timer.
+ * @details If the timer was already stopped then the function has no effect.
+ *
+ * @param[in] etp       pointer to an initialized @p event_timer_t structure
+ *
+ * @api
+ */
+void evtStop(event_timer_t *etp) {
+
+  chSysLock();
+  evtStopI(etp);
+  chSysUnlock();
 }
 
 /** @} */
@@ -51,11 +51,47 @@
 /**
  * @brief   Type of a event timer structure.
  */
-typedef struct {
-  virtual_timer_t       et_vt;
+typedef struct event_timer event_timer_t;
+
+/**
+ * @brief   Structure representing an event timer.
+ * @note    All the armed event timers are kept in a single list ordered by
+ *          expiration time and served by a single virtual timer.
+ */
+struct event_timer {
+  /**
+   * @brief   Next timer in the armed timers list, @p NULL if not armed.
+   */
+  event_timer_t         *et_next;
+  /**
+   * @brief   Previous timer in the armed timers list.
+   */
+  event_timer_t         *et_prev;
+  /**
+   * @brief   Absolute time of the next expiration.
+   */
+  systime_t             et_time;
+  /**
+   * @brief   Period of the running timer, zero if one-shot.
+   */
+  sysinterval_t         et_period;
+  /**
+   * @brief   Period used by @p evtStart() and @p evtStartAt().
+   */
+  sysinterval_t         et_interval;
+  /**
+   * @brief   Event source broadcast on expiration.
+   */
+  event_source_t        *et_esp;
+  /**
+   * @brief   Event flags broadcast on expiration.
+   */
+  eventflags_t          et_flags;
+  /**
+   * @brief   Timer own event source.
+   */
   event_source_t        et_es;
-  systime_t             et_interval;
-} event_timer_t;
+};
 
 /*===========================================================================*/
 /* Module macros.                                                            */
@@ -68,8 +104,13 @@ typedef struct {
 #ifdef __cplusplus
 extern "C" {
 #endif
-  void evtObjectInit(event_timer_t *etp, systime_t time);
+  void evtObjectInit(event_timer_t *etp, sysinterval_t interval);
+  void evtStartAtI(event_timer_t *etp, systime_t time, sysinterval_t period);
   void evtStart(event_timer_t *etp);
+  void evtStartAt(event_timer_t *etp, systime_t time);
+  void evtStartOneShot(event_timer_t *etp, sysinterval_t delay);
+  void evtStopI(event_timer_t *etp);
+  void evtStop(event_timer_t *etp);
 #ifdef __cplusplus
 }
 #endif
@@ -79,14 +120,40 @@ extern "C" {
 /*===========================================================================*/
 
 /**
- * @brief   Stops the timer.
- * @details If the timer was already stopped then the function has no effect.
+ * @brief   Sets the event source and flags broadcast on expiration.
+ * @details By default a timer broadcasts its own event source @p et_es
+ *          without flags. Many timers can share the same event source
+ *          using different flags, a single listener is then able to tell
+ *          them apart.
+ * @note    The setting is taken at the next expiration.
+ *
+ * @param[in] etp       pointer to an initialized @p event_timer_t structure
+ * @param[in] esp       pointer to the @p event_source_t to be broadcast
+ * @param[in] flags     flags to be broadcast
+ *
+ * @xclass
+ */
+static inline void evtSetBroadcastX(event_timer_t *etp,
+                                    event_source_t *esp,
+                                    eventflags_t flags) {
+
+  etp->et_esp   = esp;
+  etp->et_flags = flags;
+}
+
+/**
+ * @brief   Returns @p true if the timer is armed.
+ *
+ * @param[in] etp       pointer to an initialized @p event_timer_t structure
+ * @return              true if the timer is armed.
  *
- * @param[in] etp       pointer to an initialized @p event_timer_t structure.
+ * @iclass
  */
-static inline void evtStop(event_timer_t *etp) {
+static inline bool evtIsArmedI(const event_timer_t *etp) {
+
+  chDbgCheckClassI();
 
-  chVTReset(&etp->et_vt);
+  return (bool)(etp->et_next != NULL);
 }
 
 #endif /* EVTIMER_H */
@@ -30,8 +30,14 @@ extern SDCDriver FATFS_HAL_DEVICE;
 #endif
 
 #if HAL_USE_RTC
+#if defined(FATFS_WALLCLOCK)
+#include "hal_wallclock.h"
+
+extern WallClockDriver FATFS_WALLCLOCK;
+#else
 extern RTCDriver RTCD1;
 #endif
+#endif
 
 /*-----------------------------------------------------------------------*/
 /* Correspondence between physical drive number and physical drive.      */
@@ -253,7 +259,9 @@ DRESULT disk_ioctl (
 
 #ifndef _ARDUPILOT_
 DWORD get_fattime(void) {
-#if HAL_USE_RTC
+#if HAL_USE_RTC && defined(FATFS_WALLCLOCK)
+    return wclkGetFAT(&FATFS_WALLCLOCK);
+#elif HAL_USE_RTC
     RTCDateTime timespec;
 
     rtcGetTime(&RTCD1, &timespec);
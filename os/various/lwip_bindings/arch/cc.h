@@ -78,6 +78,20 @@
 #define LWIP_PLATFORM_ASSERT(x)     osalSysHalt(x)
 #endif
 
+/**
+ * @brief   Use the port-optimized checksum by default.
+ */
+#if !defined(LWIP_CHKSUM)
+#define LWIP_CHKSUM                 lwip_arch_chksum
+#ifdef __cplusplus
+extern "C" {
+#endif
+  uint16_t lwip_arch_chksum(const void *dataptr, int len);
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 /**
  * @brief   The NETIF API is required by lwipthread.
  */
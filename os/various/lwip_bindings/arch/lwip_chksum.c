@@ -0,0 +1,163 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    lwip_chksum.c
+ * @brief   Port-optimized internet checksum for lwIP.
+ * @details This module provides the @p LWIP_CHKSUM function used by lwIP,
+ *          the result is the 16 bits one's complement sum in network order
+ *          like @p lwip_standard_chksum().
+ *          The sum is accumulated over aligned 32 bits words, unaligned
+ *          head and tail bytes are handled separately. On Thumb-2 cores
+ *          the words are added using an add-with-carry chain, elsewhere a
+ *          64 bits accumulator absorbs the carries.
+ */
+
+#include "hal.h"
+
+#include "arch/cc.h"
+
+/*
+ * Thumb-2 implementation of the main loop, four words are loaded at
+ * each iteration and added with end-around carry.
+ */
+#if (defined(__GNUC__) && defined(__thumb2__)) || defined(__DOXYGEN__)
+#define CHKSUM_ACC_T    uint32_t
+
+static inline uint32_t chksum_words(const uint32_t *wp, size_t n,
+                                    uint32_t sum) {
+
+  while (n >= 4U) {
+    uint32_t w0 = wp[0], w1 = wp[1], w2 = wp[2], w3 = wp[3];
+
+    __asm__ ("adds  %[s], %[s], %[w0]\n\t"
+             "adcs  %[s], %[s], %[w1]\n\t"
+             "adcs  %[s], %[s], %[w2]\n\t"
+             "adcs  %[s], %[s], %[w3]\n\t"
+             "adc   %[s], %[s], #0"
+             : [s] "+r" (sum)
+             : [w0] "r" (w0), [w1] "r" (w1), [w2] "r" (w2), [w3] "r" (w3)
+             : "cc");
+    wp += 4;
+    n  -= 4U;
+  }
+
+  while (n > 0U) {
+    __asm__ ("adds  %[s], %[s], %[w]\n\t"
+             "adc   %[s], %[s], #0"
+             : [s] "+r" (sum)
+             : [w] "r" (*wp)
+             : "cc");
+    wp++;
+    n--;
+  }
+
+  return sum;
+}
+
+/*
+ * Portable implementation of the main loop, the 64 bits accumulator
+ * cannot overflow for any frame size.
+ */
+#else
+#define CHKSUM_ACC_T    uint64_t
+
+static inline uint64_t chksum_words(const uint32_t *wp, size_t n,
+                                    uint64_t sum) {
+
+  while (n >= 4U) {
+    sum += (uint64_t)wp[0] + (uint64_t)wp[1] +
+           (uint64_t)wp[2] + (uint64_t)wp[3];
+    wp += 4;
+    n  -= 4U;
+  }
+
+  while (n > 0U) {
+    sum += (uint64_t)*wp;
+    wp++;
+    n--;
+  }
+
+  return sum;
+}
+#endif
+
+/**
+ * @brief   Computes the internet checksum of a buffer.
+ * @note    The returned value is not complemented.
+ *
+ * @param[in] dataptr   pointer to the data buffer, any alignment
+ * @param[in] len       size of the data buffer
+ * @return              The one's complement sum in network order.
+ */
+uint16_t lwip_arch_chksum(const void *dataptr, int len) {
+  const uint8_t *p = (const uint8_t *)dataptr;
+  size_t n = (size_t)len;
+  CHKSUM_ACC_T sum = 0U;
+  uint16_t t = 0U;
+  bool odd;
+
+  if (len <= 0) {
+    return 0U;
+  }
+
+  /* Unaligned head byte, it is accounted in the high position and the
+     result is swapped at the end.*/
+  odd = ((uintptr_t)p & 1U) != 0U;
+  if (odd) {
+    ((uint8_t *)&t)[1] = *p++;
+    n--;
+    sum += t;
+  }
+
+  /* Aligning to 32 bits.*/
+  if ((((uintptr_t)p & 2U) != 0U) && (n >= 2U)) {
+    sum += *(const uint16_t *)p;
+    p += 2;
+    n -= 2U;
+  }
+
+  /* Main loop on words.*/
+  sum = chksum_words((const uint32_t *)p, n / 4U, sum);
+  p += n & ~(size_t)3U;
+  n &= 3U;
+
+  /* Partial folding, the tail additions cannot overflow after this.*/
+  sum = (sum & 0xFFFFU) + (sum >> 16);
+
+  /* Tail.*/
+  if (n >= 2U) {
+    sum += *(const uint16_t *)p;
+    p += 2;
+    n -= 2U;
+  }
+  if (n > 0U) {
+    t = 0U;
+    ((uint8_t *)&t)[0] = *p;
+    sum += t;
+  }
+
+  /* Folding to 16 bits.*/
+  while ((sum >> 16) != 0U) {
+    sum = (sum & 0xFFFFU) + (sum >> 16);
+  }
+
+  if (odd) {
+    sum = ((sum & 0xFFU) << 8) | ((sum >> 8) & 0xFFU);
+  }
+
+  return (uint16_t)sum;
+}
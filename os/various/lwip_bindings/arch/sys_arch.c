@@ -52,6 +52,8 @@
  * See http://lwip.wikia.com/wiki/Porting_for_an_OS for instructions.
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 #include "lwip/opt.h"
@@ -62,13 +64,304 @@
 #include "arch/cc.h"
 #include "arch/sys_arch.h"
 
+/*
+ * Mailbox fetch hook, a single thread, normally the tcpip thread, can wait
+ * on both its mailbox and a set of events, events are serviced by the hook
+ * function in the context of the waiting thread.
+ */
+static struct {
+  thread_t          *tp;
+  mailbox_t         *mbox;
+  eventmask_t       events;
+  sys_mbox_hook_t   hook;
+} mbox_hook;
+
+static u32_t sys_arch_mbox_fetch_hooked(sys_mbox_t *mbox, void **msg,
+                                        u32_t timeout) {
+  systime_t start;
+  sysinterval_t tmo, elapsed;
+
+  /* The first fetch associates the mailbox to the hook, posts to the
+     mailbox signal the hooked thread from then on.*/
+  mbox_hook.mbox = *mbox;
+
+  tmo = timeout > 0 ? TIME_MS2I((time_msecs_t)timeout) : TIME_INFINITE;
+  start = chVTGetSystemTimeX();
+  while (true) {
+    eventmask_t events;
+
+    chSysLock();
+    elapsed = chTimeDiffX(start, chVTGetSystemTimeX());
+    if (chMBFetchI(*mbox, (msg_t *)msg) == MSG_OK) {
+      chSysUnlock();
+      return (u32_t)TIME_I2MS(elapsed);
+    }
+    chSysUnlock();
+
+    if (tmo != TIME_INFINITE) {
+      if (elapsed >= tmo) {
+        return SYS_ARCH_TIMEOUT;
+      }
+      events = chEvtWaitAnyTimeout(mbox_hook.events | SYS_ARCH_MBOX_POST_EVENT,
+                                   tmo - elapsed);
+    }
+    else {
+      events = chEvtWaitAny(mbox_hook.events | SYS_ARCH_MBOX_POST_EVENT);
+    }
+
+    if ((events & mbox_hook.events) != 0U) {
+      mbox_hook.hook(events & mbox_hook.events);
+    }
+  }
+}
+
+static void sys_arch_mbox_notify(sys_mbox_t *mbox) {
+
+  if ((mbox_hook.mbox != NULL) && (*mbox == mbox_hook.mbox)) {
+    chEvtSignal(mbox_hook.tp, SYS_ARCH_MBOX_POST_EVENT);
+  }
+}
+
+#if SYS_ARCH_USE_POOLS
+/*
+ * Static pools, each pool remembers the address range of its storage so
+ * that objects can be returned to the right pool or to the heap.
+ */
+typedef struct {
+  memory_pool_t         pool;
+  uint8_t               *base;
+  uint8_t               *top;
+  sys_arch_pool_stats_t stats;
+} sys_arch_pool_t;
+
+/* lwIP mailbox with its messages buffer */
+typedef struct {
+  mailbox_t             mb;
+  msg_t                 buf[SYS_ARCH_MBOX_MAX_SIZE];
+} sys_arch_mbox_obj_t;
+
+#define MEM_SIZE_ALIGN(n)   MEM_ALIGN_NEXT((n), CH_HEAP_ALIGNMENT)
+
+static CH_HEAP_AREA(mem_pool0_buf,
+                    MEM_SIZE_ALIGN(SYS_ARCH_MEM_POOL0_SIZE) *
+                    SYS_ARCH_MEM_POOL0_NUM);
+static CH_HEAP_AREA(mem_pool1_buf,
+                    MEM_SIZE_ALIGN(SYS_ARCH_MEM_POOL1_SIZE) *
+                    SYS_ARCH_MEM_POOL1_NUM);
+static CH_HEAP_AREA(mem_pool2_buf,
+                    MEM_SIZE_ALIGN(SYS_ARCH_MEM_POOL2_SIZE) *
+                    SYS_ARCH_MEM_POOL2_NUM);
+static CH_HEAP_AREA(mem_pool3_buf,
+                    MEM_SIZE_ALIGN(SYS_ARCH_MEM_POOL3_SIZE) *
+                    SYS_ARCH_MEM_POOL3_NUM);
+static semaphore_t sem_buf[SYS_ARCH_SEM_NUM];
+static sys_arch_mbox_obj_t mbox_buf[SYS_ARCH_MBOX_NUM];
+#if SYS_ARCH_THREAD_NUM > 0
+static stkalign_t thread_buf[SYS_ARCH_THREAD_NUM]
+                            [THD_WORKING_AREA_SIZE(SYS_ARCH_THREAD_STACK_SIZE) /
+                             sizeof (stkalign_t)];
+#endif
+#if SYS_ARCH_MEM_HEAP_SIZE > 0
+static memory_heap_t mem_heap;
+static CH_HEAP_AREA(mem_heap_buf, SYS_ARCH_MEM_HEAP_SIZE);
+#endif
+
+static sys_arch_pool_t pools[SYS_ARCH_POOLS_NUMBER];
+
+static void pool_init(unsigned n, const char *name, void *base,
+                      size_t size, unsigned num, unsigned align) {
+  sys_arch_pool_t *pp = &pools[n];
+
+  chPoolObjectInitAligned(&pp->pool, size, align, NULL);
+  chPoolLoadArray(&pp->pool, base, (size_t)num);
+  pp->base              = (uint8_t *)base;
+  pp->top               = (uint8_t *)base + (size * num);
+  pp->stats.name        = name;
+  pp->stats.object_size = size;
+  pp->stats.num         = num;
+  pp->stats.used        = 0U;
+  pp->stats.max_used    = 0U;
+  pp->stats.fallbacks   = 0U;
+}
+
+static void *pool_alloc(sys_arch_pool_t *pp) {
+  void *p;
+
+  chSysLock();
+  p = chPoolAllocI(&pp->pool);
+  if (p != NULL) {
+    pp->stats.used++;
+    if (pp->stats.used > pp->stats.max_used) {
+      pp->stats.max_used = pp->stats.used;
+    }
+  }
+  chSysUnlock();
+
+  return p;
+}
+
+static bool pool_free(sys_arch_pool_t *pp, void *p) {
+
+  if (((uint8_t *)p < pp->base) || ((uint8_t *)p >= pp->top)) {
+    return false;
+  }
+
+  chSysLock();
+  chPoolFreeI(&pp->pool, p);
+  pp->stats.used--;
+  chSysUnlock();
+
+  return true;
+}
+
+static void pool_fallback(sys_arch_pool_t *pp) {
+
+  chSysLock();
+  pp->stats.fallbacks++;
+  chSysUnlock();
+}
+
+static void *heap_alloc(size_t size) {
+
+#if SYS_ARCH_MEM_HEAP_SIZE > 0
+  return chHeapAlloc(&mem_heap, size);
+#else
+  return chHeapAlloc(NULL, size);
+#endif
+}
+
+void *sys_arch_mem_malloc(size_t size) {
+  unsigned i;
+
+  for (i = SYS_ARCH_POOL_MEM0; i <= SYS_ARCH_POOL_MEM3; i++) {
+    if (size <= pools[i].stats.object_size) {
+      void *p = pool_alloc(&pools[i]);
+      if (p != NULL) {
+        return p;
+      }
+      pool_fallback(&pools[i]);
+    }
+  }
+
+  return heap_alloc(size);
+}
+
+void *sys_arch_mem_calloc(size_t n, size_t size) {
+  void *p;
+
+  /* The total size must not overflow.*/
+  if ((size > (size_t)0) && (n > ((size_t)-1 / size))) {
+    return NULL;
+  }
+
+  p = sys_arch_mem_malloc(n * size);
+  if (p != NULL) {
+    memset(p, 0, n * size);
+  }
+
+  return p;
+}
+
+void sys_arch_mem_free(void *p) {
+  unsigned i;
+
+  if (p == NULL) {
+    return;
+  }
+
+  for (i = SYS_ARCH_POOL_MEM0; i <= SYS_ARCH_POOL_MEM3; i++) {
+    if (pool_free(&pools[i], p)) {
+      return;
+    }
+  }
+
+  chHeapFree(p);
+}
+
+/* CHIBIOS EXTENSION: returns the usage statistics of a pool or NULL if
+   the pool identifier is out of range.*/
+const sys_arch_pool_stats_t *sys_arch_get_pool_stats(unsigned n) {
+
+  if (n >= SYS_ARCH_POOLS_NUMBER) {
+    return NULL;
+  }
+
+#if SYS_ARCH_THREAD_NUM > 0
+  if (n == SYS_ARCH_POOL_THREAD) {
+    /* Threads return their working area to the pool autonomously on
+       release, the used count is recalculated from the free list.*/
+    struct pool_header *php;
+    unsigned free = 0U;
+
+    chSysLock();
+    for (php = pools[n].pool.next; php != NULL; php = php->next) {
+      free++;
+    }
+    pools[n].stats.used = pools[n].stats.num - free;
+    chSysUnlock();
+  }
+#endif
+
+  return &pools[n].stats;
+}
+#endif /* SYS_ARCH_USE_POOLS */
+
 void sys_init(void) {
 
+#if SYS_ARCH_USE_POOLS
+  pool_init(SYS_ARCH_POOL_MEM0, "mem0", mem_pool0_buf,
+            MEM_SIZE_ALIGN(SYS_ARCH_MEM_POOL0_SIZE),
+            SYS_ARCH_MEM_POOL0_NUM, CH_HEAP_ALIGNMENT);
+  pool_init(SYS_ARCH_POOL_MEM1, "mem1", mem_pool1_buf,
+            MEM_SIZE_ALIGN(SYS_ARCH_MEM_POOL1_SIZE),
+            SYS_ARCH_MEM_POOL1_NUM, CH_HEAP_ALIGNMENT);
+  pool_init(SYS_ARCH_POOL_MEM2, "mem2", mem_pool2_buf,
+            MEM_SIZE_ALIGN(SYS_ARCH_MEM_POOL2_SIZE),
+            SYS_ARCH_MEM_POOL2_NUM, CH_HEAP_ALIGNMENT);
+  pool_init(SYS_ARCH_POOL_MEM3, "mem3", mem_pool3_buf,
+            MEM_SIZE_ALIGN(SYS_ARCH_MEM_POOL3_SIZE),
+            SYS_ARCH_MEM_POOL3_NUM, CH_HEAP_ALIGNMENT);
+  pool_init(SYS_ARCH_POOL_SEM, "sem", sem_buf,
+            sizeof (semaphore_t), SYS_ARCH_SEM_NUM, PORT_NATURAL_ALIGN);
+  pool_init(SYS_ARCH_POOL_MBOX, "mbox", mbox_buf,
+            sizeof (sys_arch_mbox_obj_t), SYS_ARCH_MBOX_NUM,
+            PORT_NATURAL_ALIGN);
+#if SYS_ARCH_THREAD_NUM > 0
+  pool_init(SYS_ARCH_POOL_THREAD, "thread", thread_buf,
+            sizeof (thread_buf[0]), SYS_ARCH_THREAD_NUM,
+            PORT_WORKING_AREA_ALIGN);
+#endif
+#if SYS_ARCH_MEM_HEAP_SIZE > 0
+  chHeapObjectInit(&mem_heap, mem_heap_buf, sizeof (mem_heap_buf));
+#endif
+#endif
+}
+
+/* CHIBIOS EXTENSION: makes the calling thread wait on both its mailbox and
+   the specified events, the hook is invoked with the events mask when one
+   of the events is signaled. The hook is invoked without the lwIP core
+   lock, it must take it before calling lwIP core functions.*/
+void sys_arch_mbox_set_hook(eventmask_t events, sys_mbox_hook_t hook) {
+
+  osalDbgCheck((events & SYS_ARCH_MBOX_POST_EVENT) == 0U);
+
+  mbox_hook.mbox   = NULL;
+  mbox_hook.events = events;
+  mbox_hook.hook   = hook;
+  mbox_hook.tp     = chThdGetSelfX();
 }
 
 err_t sys_sem_new(sys_sem_t *sem, u8_t count) {
 
+#if SYS_ARCH_USE_POOLS
+  *sem = pool_alloc(&pools[SYS_ARCH_POOL_SEM]);
+  if (*sem == 0) {
+    pool_fallback(&pools[SYS_ARCH_POOL_SEM]);
+    *sem = chHeapAlloc(NULL, sizeof(semaphore_t));
+  }
+#else
   *sem = chHeapAlloc(NULL, sizeof(semaphore_t));
+#endif
   if (*sem == 0) {
     SYS_STATS_INC(sem.err);
     return ERR_MEM;
@@ -82,7 +375,12 @@ err_t sys_sem_new(sys_sem_t *sem, u8_t count) {
 
 void sys_sem_free(sys_sem_t *sem) {
 
-  chHeapFree(*sem);
+#if SYS_ARCH_USE_POOLS
+  if (!pool_free(&pools[SYS_ARCH_POOL_SEM], *sem))
+#endif
+  {
+    chHeapFree(*sem);
+  }
   *sem = SYS_SEM_NULL;
   SYS_STATS_DEC(sem.used);
 }
@@ -128,7 +426,18 @@ void sys_sem_set_invalid(sys_sem_t *sem) {
 
 err_t sys_mbox_new(sys_mbox_t *mbox, int size) {
 
+#if SYS_ARCH_USE_POOLS
+  *mbox = NULL;
+  if (size <= SYS_ARCH_MBOX_MAX_SIZE) {
+    *mbox = pool_alloc(&pools[SYS_ARCH_POOL_MBOX]);
+  }
+  if (*mbox == 0) {
+    pool_fallback(&pools[SYS_ARCH_POOL_MBOX]);
+    *mbox = chHeapAlloc(NULL, sizeof(mailbox_t) + sizeof(msg_t) * size);
+  }
+#else
   *mbox = chHeapAlloc(NULL, sizeof(mailbox_t) + sizeof(msg_t) * size);
+#endif
   if (*mbox == 0) {
     SYS_STATS_INC(mbox.err);
     return ERR_MEM;
@@ -154,7 +463,12 @@ void sys_mbox_free(sys_mbox_t *mbox) {
     SYS_STATS_INC(mbox.err);
     chMBReset(*mbox);
   }
-  chHeapFree(*mbox);
+#if SYS_ARCH_USE_POOLS
+  if (!pool_free(&pools[SYS_ARCH_POOL_MBOX], *mbox))
+#endif
+  {
+    chHeapFree(*mbox);
+  }
   *mbox = SYS_MBOX_NULL;
   SYS_STATS_DEC(mbox.used);
 }
@@ -162,6 +476,7 @@ void sys_mbox_free(sys_mbox_t *mbox) {
 void sys_mbox_post(sys_mbox_t *mbox, void *msg) {
 
   chMBPostTimeout(*mbox, (msg_t)msg, TIME_INFINITE);
+  sys_arch_mbox_notify(mbox);
 }
 
 err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg) {
@@ -170,6 +485,7 @@ err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg) {
     SYS_STATS_INC(mbox.err);
     return ERR_MEM;
   }
+  sys_arch_mbox_notify(mbox);
   return ERR_OK;
 }
 
@@ -177,6 +493,10 @@ u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout) {
   systime_t start;
   sysinterval_t tmo, remaining;
 
+  if ((mbox_hook.hook != NULL) && (mbox_hook.tp == chThdGetSelfX())) {
+    return sys_arch_mbox_fetch_hooked(mbox, msg, timeout);
+  }
+
   chSysLock();
   tmo = timeout > 0 ? TIME_MS2I((time_msecs_t)timeout) : TIME_INFINITE;
   start = chVTGetSystemTimeX();
@@ -210,6 +530,26 @@ sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread,
                             void *arg, int stacksize, int prio) {
   thread_t *tp;
 
+#if SYS_ARCH_USE_POOLS && (SYS_ARCH_THREAD_NUM > 0)
+  if (stacksize <= SYS_ARCH_THREAD_STACK_SIZE) {
+    tp = chThdCreateFromMemoryPool(&pools[SYS_ARCH_POOL_THREAD].pool,
+                                   name, prio, (tfunc_t)thread, arg);
+    if (tp != NULL) {
+      /* Updating the high-water mark.*/
+      (void) sys_arch_get_pool_stats(SYS_ARCH_POOL_THREAD);
+      chSysLock();
+      if (pools[SYS_ARCH_POOL_THREAD].stats.used >
+          pools[SYS_ARCH_POOL_THREAD].stats.max_used) {
+        pools[SYS_ARCH_POOL_THREAD].stats.max_used =
+            pools[SYS_ARCH_POOL_THREAD].stats.used;
+      }
+      chSysUnlock();
+      return (sys_thread_t)tp;
+    }
+  }
+  pool_fallback(&pools[SYS_ARCH_POOL_THREAD]);
+#endif
+
   tp = chThdCreateFromHeap(NULL, THD_WORKING_AREA_SIZE(stacksize),
                            name, prio, (tfunc_t)thread, arg);
   return (sys_thread_t)tp;
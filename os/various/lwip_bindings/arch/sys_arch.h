@@ -65,4 +65,107 @@ typedef syssts_t        sys_prot_t;
 /* let sys.h use binary semaphores for mutexes */
 #define LWIP_COMPAT_MUTEX 1
 
+#if SYS_ARCH_USE_POOLS
+/* size and number of the objects of the four lwIP memory pools, requests
+   are served by the smallest pool with a large enough and free object */
+#if !defined(SYS_ARCH_MEM_POOL0_SIZE)
+#define SYS_ARCH_MEM_POOL0_SIZE         32
+#endif
+#if !defined(SYS_ARCH_MEM_POOL0_NUM)
+#define SYS_ARCH_MEM_POOL0_NUM          32
+#endif
+#if !defined(SYS_ARCH_MEM_POOL1_SIZE)
+#define SYS_ARCH_MEM_POOL1_SIZE         128
+#endif
+#if !defined(SYS_ARCH_MEM_POOL1_NUM)
+#define SYS_ARCH_MEM_POOL1_NUM          16
+#endif
+#if !defined(SYS_ARCH_MEM_POOL2_SIZE)
+#define SYS_ARCH_MEM_POOL2_SIZE         512
+#endif
+#if !defined(SYS_ARCH_MEM_POOL2_NUM)
+#define SYS_ARCH_MEM_POOL2_NUM          8
+#endif
+#if !defined(SYS_ARCH_MEM_POOL3_SIZE)
+#define SYS_ARCH_MEM_POOL3_SIZE         1536
+#endif
+#if !defined(SYS_ARCH_MEM_POOL3_NUM)
+#define SYS_ARCH_MEM_POOL3_NUM          8
+#endif
+
+/* size of the private heap region serving the requests not fitting the
+   memory pools, zero disables it */
+#if !defined(SYS_ARCH_MEM_HEAP_SIZE)
+#define SYS_ARCH_MEM_HEAP_SIZE          4096
+#endif
+
+/* number of preallocated semaphores */
+#if !defined(SYS_ARCH_SEM_NUM)
+#define SYS_ARCH_SEM_NUM                16
+#endif
+
+/* number of preallocated mailboxes and their maximum size */
+#if !defined(SYS_ARCH_MBOX_NUM)
+#define SYS_ARCH_MBOX_NUM               8
+#endif
+#if !defined(SYS_ARCH_MBOX_MAX_SIZE)
+#define SYS_ARCH_MBOX_MAX_SIZE          16
+#endif
+
+/* number of preallocated threads and their stack size */
+#if !defined(SYS_ARCH_THREAD_NUM)
+#define SYS_ARCH_THREAD_NUM             4
+#endif
+#if !defined(SYS_ARCH_THREAD_STACK_SIZE)
+#define SYS_ARCH_THREAD_STACK_SIZE      1024
+#endif
+
+#if CH_CFG_USE_MEMPOOLS == FALSE
+#error "SYS_ARCH_USE_POOLS requires CH_CFG_USE_MEMPOOLS"
+#endif
+
+#if (SYS_ARCH_THREAD_NUM > 0) && (CH_CFG_USE_DYNAMIC == FALSE)
+#error "SYS_ARCH_THREAD_NUM requires CH_CFG_USE_DYNAMIC"
+#endif
+
+/* pools identifiers */
+#define SYS_ARCH_POOL_MEM0              0U
+#define SYS_ARCH_POOL_MEM1              1U
+#define SYS_ARCH_POOL_MEM2              2U
+#define SYS_ARCH_POOL_MEM3              3U
+#define SYS_ARCH_POOL_SEM               4U
+#define SYS_ARCH_POOL_MBOX              5U
+#define SYS_ARCH_POOL_THREAD            6U
+#define SYS_ARCH_POOLS_NUMBER           7U
+
+/* usage statistics of a pool, objects not fitting or not available in
+   the pool are allocated from the heap and counted as fallbacks */
+typedef struct {
+  const char    *name;
+  size_t        object_size;
+  unsigned      num;
+  unsigned      used;
+  unsigned      max_used;
+  unsigned      fallbacks;
+} sys_arch_pool_stats_t;
+#endif /* SYS_ARCH_USE_POOLS */
+
+/* event used to notify a post to a hooked mailbox */
+#define SYS_ARCH_MBOX_POST_EVENT    EVENT_MASK(0)
+
+/* type of a mailbox fetch hook, invoked by the hooked thread while
+   waiting on its mailbox */
+typedef void (*sys_mbox_hook_t)(eventmask_t events);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void sys_arch_mbox_set_hook(eventmask_t events, sys_mbox_hook_t hook);
+#if SYS_ARCH_USE_POOLS
+  const sys_arch_pool_stats_t *sys_arch_get_pool_stats(unsigned n);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __SYS_ARCH_H__ */
@@ -6,7 +6,8 @@ include $(LWIPDIR)/Filelists.mk
 
 LWBINDSRC = \
         $(CHIBIOS)/os/various/lwip_bindings/lwipthread.c \
-        $(CHIBIOS)/os/various/lwip_bindings/arch/sys_arch.c
+        $(CHIBIOS)/os/various/lwip_bindings/arch/sys_arch.c \
+        $(CHIBIOS)/os/various/lwip_bindings/arch/lwip_chksum.c
 
 
 # Add blocks of files from Filelists.mk as required for enabled options
@@ -82,16 +82,55 @@
 #define PERIODIC_TIMER_ID       1
 #define FRAME_RECEIVED_ID       2
 
+#if (LWIP_TCPIP_DIRECT_RX == TRUE) && (MAC_USE_EVENTS == FALSE)
+#error "LWIP_TCPIP_DIRECT_RX requires MAC_USE_EVENTS"
+#endif
+
 /*
  * Suspension point for initialization procedure.
  */
 thread_reference_t lwip_trp = NULL;
 
+/*
+ * Network interface and its addressing mode.
+ */
+static struct netif thisif = { 0 };
+static net_addr_mode_t addressMode;
+
 /*
  * Stack area for the LWIP-MAC thread.
  */
 static THD_WORKING_AREA(wa_lwip_thread, LWIP_THREAD_STACK_SIZE);
 
+#if LWIP_CHECKSUM_CTRL_PER_NETIF || defined(__DOXYGEN__)
+/*
+ * Translates the MAC capabilities into the netif checksum control flags,
+ * checksums handled by the hardware are disabled in software.
+ */
+static u16_t low_level_checksum_ctrl(uint32_t caps) {
+  u16_t flags = NETIF_CHECKSUM_ENABLE_ALL;
+
+  if (caps & MAC_CAP_CHECKSUM_GEN_IP)
+    flags &= ~NETIF_CHECKSUM_GEN_IP;
+  if (caps & MAC_CAP_CHECKSUM_GEN_UDP)
+    flags &= ~NETIF_CHECKSUM_GEN_UDP;
+  if (caps & MAC_CAP_CHECKSUM_GEN_TCP)
+    flags &= ~NETIF_CHECKSUM_GEN_TCP;
+  if (caps & MAC_CAP_CHECKSUM_GEN_ICMP)
+    flags &= ~NETIF_CHECKSUM_GEN_ICMP;
+  if (caps & MAC_CAP_CHECKSUM_CHECK_IP)
+    flags &= ~NETIF_CHECKSUM_CHECK_IP;
+  if (caps & MAC_CAP_CHECKSUM_CHECK_UDP)
+    flags &= ~NETIF_CHECKSUM_CHECK_UDP;
+  if (caps & MAC_CAP_CHECKSUM_CHECK_TCP)
+    flags &= ~NETIF_CHECKSUM_CHECK_TCP;
+  if (caps & MAC_CAP_CHECKSUM_CHECK_ICMP)
+    flags &= ~NETIF_CHECKSUM_CHECK_ICMP;
+
+  return flags;
+}
+#endif
+
 /*
  * Initialization.
  */
@@ -106,6 +145,12 @@ static void low_level_init(struct netif *netif) {
   /* don't set NETIF_FLAG_ETHARP if this device is not an Ethernet one */
   netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_LINK_UP;
 
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+  /* checksums offloaded to the MAC are not computed by lwIP */
+  NETIF_SET_CHECKSUM_CTRL(netif,
+                          low_level_checksum_ctrl(macGetCapabilities(&ETHD1)));
+#endif
+
   /* Do whatever else is needed to initialize interface. */
 }
 
@@ -266,6 +311,120 @@ static err_t ethernetif_init(struct netif *netif) {
   return ERR_OK;
 }
 
+/*
+ * Checks the link status and notifies lwIP of changes.
+ */
+static void lwip_link_check(void) {
+  bool current_link_status = macPollLinkStatus(&ETHD1);
+
+  if (current_link_status != netif_is_link_up(&thisif)) {
+    if (current_link_status) {
+#if LWIP_TCPIP_DIRECT_RX == TRUE
+      netif_set_link_up(&thisif);
+#else
+      tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_up,
+                                 &thisif, 0);
+#endif
+#if LWIP_DHCP
+      if (addressMode == NET_ADDRESS_DHCP)
+        dhcp_start(&thisif);
+#endif
+    }
+    else {
+#if LWIP_TCPIP_DIRECT_RX == TRUE
+      netif_set_link_down(&thisif);
+#else
+      tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_down,
+                                 &thisif, 0);
+#endif
+#if LWIP_DHCP
+      if (addressMode == NET_ADDRESS_DHCP)
+        dhcp_stop(&thisif);
+#endif
+    }
+  }
+}
+
+/*
+ * Reads up to the specified number of frames and passes them to the
+ * interface input function.
+ * Returns true if the limit has been reached, more frames could be pending.
+ */
+static bool lwip_rx_frames(unsigned n) {
+  struct pbuf *p;
+
+  while (n > 0U) {
+    if (!low_level_input(&thisif, &p))
+      return false;
+    n--;
+    if (p != NULL) {
+      struct eth_hdr *ethhdr = p->payload;
+      switch (htons(ethhdr->type)) {
+        /* IP or ARP packet? */
+        case ETHTYPE_IP:
+        case ETHTYPE_ARP:
+          /* full packet send to tcpip_thread to process */
+          if (thisif.input(p, &thisif) == ERR_OK)
+            break;
+          LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: IP input error\n"));
+      /* Falls through */
+        default:
+          pbuf_free(p);
+      }
+    }
+  }
+  return true;
+}
+
+#if (LWIP_TCPIP_DIRECT_RX == TRUE) || defined(__DOXYGEN__)
+/*
+ * Link poll lwIP timeout, runs in the tcpip thread.
+ */
+static void lwip_link_timeout(void *arg) {
+
+  (void)arg;
+  lwip_link_check();
+  sys_timeout((u32_t)TIME_I2MS(LWIP_LINK_POLL_INTERVAL),
+              lwip_link_timeout, NULL);
+}
+
+/*
+ * Frames reception hook, runs in the tcpip thread while it is waiting on
+ * its mailbox.
+ * The tcpip thread releases the core lock while waiting, it has to be
+ * taken again because other threads can enter the core using the
+ * netconn and sockets APIs.
+ */
+static void lwip_rx_hook(eventmask_t events) {
+  bool more;
+
+  (void)events;
+  LOCK_TCPIP_CORE();
+  more = lwip_rx_frames(LWIP_RX_BATCH_SIZE);
+  UNLOCK_TCPIP_CORE();
+  if (more) {
+    /* Batch limit reached, the remaining frames are processed after the
+       mailbox and the timeouts had a chance to run.*/
+    chEvtSignal(chThdGetSelfX(), FRAME_RECEIVED_ID);
+  }
+}
+
+/*
+ * Initialization of the reception path, runs in the tcpip thread.
+ */
+static void lwip_rx_direct_init(void *arg) {
+  static event_listener_t el;
+
+  (void)arg;
+  chEvtRegisterMask(macGetReceiveEventSource(&ETHD1), &el,
+                    FRAME_RECEIVED_ID);
+  sys_arch_mbox_set_hook(FRAME_RECEIVED_ID, lwip_rx_hook);
+  chEvtSignal(chThdGetSelfX(), FRAME_RECEIVED_ID);
+  sys_timeout((u32_t)TIME_I2MS(LWIP_LINK_POLL_INTERVAL),
+              lwip_link_timeout, NULL);
+}
+#endif /* LWIP_TCPIP_DIRECT_RX == TRUE */
+
 /**
  * @brief LWIP handling thread.
  *
@@ -273,12 +432,12 @@ static err_t ethernetif_init(struct netif *netif) {
  * @return The function does not return.
  */
 static THD_FUNCTION(lwip_thread, p) {
+#if LWIP_TCPIP_DIRECT_RX == FALSE
   event_timer_t evt;
   event_listener_t el0, el1;
+#endif
   ip_addr_t ip, gateway, netmask;
-  static struct netif thisif = { 0 };
   static const MACConfig mac_config = {thisif.hwaddr};
-  net_addr_mode_t addressMode;
   err_t result;
 
   chRegSetThreadName(LWIP_THREAD_NAME);
@@ -325,7 +484,12 @@ static THD_FUNCTION(lwip_thread, p) {
   macStart(&ETHD1, &mac_config);
 
   /* Add interface. */
+#if LWIP_TCPIP_DIRECT_RX == TRUE
+  /* Frames are received from within the tcpip thread.*/
+  result = netifapi_netif_add(&thisif, &ip, &netmask, &gateway, NULL, ethernetif_init, ethernet_input);
+#else
   result = netifapi_netif_add(&thisif, &ip, &netmask, &gateway, NULL, ethernetif_init, tcpip_input);
+#endif
   if (result != ERR_OK)
   {
     chThdSleepMilliseconds(1000);     // Give some time to print any other diagnostics.
@@ -347,6 +511,13 @@ static THD_FUNCTION(lwip_thread, p) {
       break;
   }
 
+#if LWIP_TCPIP_DIRECT_RX == TRUE
+  /* Reception and link polling are moved into the tcpip thread.*/
+  tcpip_callback_with_block(lwip_rx_direct_init, NULL, 1);
+
+  /* Resumes the caller, this thread is no more required.*/
+  chThdResume(&lwip_trp, MSG_OK);
+#else
   /* Setup event sources.*/
   evtObjectInit(&evt, LWIP_LINK_POLL_INTERVAL);
   evtStart(&evt);
@@ -361,48 +532,15 @@ static THD_FUNCTION(lwip_thread, p) {
   while (true) {
     eventmask_t mask = chEvtWaitAny(ALL_EVENTS);
     if (mask & PERIODIC_TIMER_ID) {
-      bool current_link_status = macPollLinkStatus(&ETHD1);
-      if (current_link_status != netif_is_link_up(&thisif)) {
-        if (current_link_status) {
-          tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_up,
-                                     &thisif, 0);
-#if LWIP_DHCP
-          if (addressMode == NET_ADDRESS_DHCP)
-            dhcp_start(&thisif);
-#endif
-        }
-        else {
-          tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_down,
-                                     &thisif, 0);
-#if LWIP_DHCP
-          if (addressMode == NET_ADDRESS_DHCP)
-            dhcp_stop(&thisif);
-#endif
-        }
-      }
+      lwip_link_check();
     }
     
     if (mask & FRAME_RECEIVED_ID) {
-      struct pbuf *p;
-      while (low_level_input(&thisif, &p)) {
-        if (p != NULL) {
-          struct eth_hdr *ethhdr = p->payload;
-          switch (htons(ethhdr->type)) {
-            /* IP or ARP packet? */
-            case ETHTYPE_IP:
-            case ETHTYPE_ARP:
-              /* full packet send to tcpip_thread to process */
-              if (thisif.input(p, &thisif) == ERR_OK)
-                break;
-              LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: IP input error\n"));
-          /* Falls through */
-            default:
-              pbuf_free(p);
-          }
-        }
+      while (lwip_rx_frames(LWIP_RX_BATCH_SIZE)) {
       }
     }
   }
+#endif
 }
 
 /**
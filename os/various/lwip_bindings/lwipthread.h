@@ -68,6 +68,27 @@
 #define LWIP_LINK_POLL_INTERVAL             TIME_S2I(5)
 #endif
 
+/**
+ * @brief   Frames reception inside the tcpip thread.
+ * @details If enabled the MAC receive events are serviced directly by the
+ *          lwIP tcpip thread, frames are drained in batches and passed to
+ *          @p ethernet_input() without going through the tcpip mailbox.
+ *          The link status is polled using an lwIP timeout and the
+ *          lwIP-MAC thread terminates after the initialization.
+ */
+#if !defined(LWIP_TCPIP_DIRECT_RX) || defined(__DOXYGEN__)
+#define LWIP_TCPIP_DIRECT_RX                FALSE
+#endif
+
+/**
+ * @brief   Maximum number of frames processed for each receive event.
+ * @note    Only used if @p LWIP_TCPIP_DIRECT_RX is @p TRUE, remaining
+ *          frames are processed after the pending lwIP timeouts.
+ */
+#if !defined(LWIP_RX_BATCH_SIZE) || defined(__DOXYGEN__)
+#define LWIP_RX_BATCH_SIZE                  8
+#endif
+
 /**
  *  @brief  IP Address.
  */
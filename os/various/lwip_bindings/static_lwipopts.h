@@ -37,6 +37,33 @@
 
 #define MEM_ALIGNMENT                   4
 
+/* CHIBIOS EXTENSION: lwIP memory, memp pools, mailboxes, semaphores and
+   threads allocated from static ChibiOS memory pools, see sys_arch.h for
+   the pools configuration.*/
+#if !defined(SYS_ARCH_USE_POOLS)
+#define SYS_ARCH_USE_POOLS              0
+#endif
+
+#if SYS_ARCH_USE_POOLS
+#include <stddef.h>
+
+#define MEM_LIBC_MALLOC                 1
+#define MEMP_MEM_MALLOC                 1
+#define mem_clib_malloc                 sys_arch_mem_malloc
+#define mem_clib_calloc                 sys_arch_mem_calloc
+#define mem_clib_free                   sys_arch_mem_free
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void *sys_arch_mem_malloc(size_t size);
+  void *sys_arch_mem_calloc(size_t n, size_t size);
+  void sys_arch_mem_free(void *p);
+#ifdef __cplusplus
+}
+#endif
+#endif /* SYS_ARCH_USE_POOLS */
+
 #endif  /* STATIC_LWIPOPTS_H */
 
 /** @} */
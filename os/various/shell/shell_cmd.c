@@ -171,6 +171,136 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
 }
 #endif
 
+#if (SHELL_CMD_IRQSTAT_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_irqstat(BaseSequentialStream *chp, int argc, char *argv[]) {
+  irq_stats_t is;
+  unsigned i;
+
+  (void)argv;
+  if (argc > 0) {
+    shellUsage(chp, "irqstat");
+    return;
+  }
+  chprintf(chp, "vector      count     best    worst      avg       cumulative nest" SHELL_NEWLINE_STR);
+  for (i = 0U; i < (unsigned)CH_DBG_STATISTICS_IRQ_VECTORS; i++) {
+    chSysLock();
+    is = ch.kernel_stats.irq[i];
+    chSysUnlock();
+    if (is.m_isr.n == (ucnt_t)0) {
+      continue;
+    }
+    chprintf(chp, "%6u %10lu %8lu %8lu %8lu %08lx%08lx %4lu" SHELL_NEWLINE_STR,
+             i, (uint32_t)is.m_isr.n,
+             (uint32_t)is.m_isr.best, (uint32_t)is.m_isr.worst,
+             (uint32_t)(is.m_isr.cumulative / (rttime_t)is.m_isr.n),
+             (uint32_t)(is.m_isr.cumulative >> 32),
+             (uint32_t)is.m_isr.cumulative,
+             (uint32_t)is.max_nesting);
+  }
+}
+#endif
+
+#if (SHELL_CMD_CRIT_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_crit(BaseSequentialStream *chp, int argc, char *argv[]) {
+  crit_site_stats_t cs;
+  unsigned i, j;
+
+  (void)argv;
+  if ((argc > 1) || ((argc == 1) && strcmp(argv[0], "reset"))) {
+    shellUsage(chp, "crit [reset]");
+    return;
+  }
+  if (argc == 1) {
+    chSysLock();
+    chStatsResetCritSitesI();
+    chSysUnlock();
+    return;
+  }
+  chprintf(chp, "    site      count    worst      avg histogram" SHELL_NEWLINE_STR);
+  for (i = 0U; i < (unsigned)CH_DBG_STATISTICS_CRIT_SITES; i++) {
+    chSysLock();
+    cs = ch.kernel_stats.crit_sites[i];
+    chSysUnlock();
+    if (cs.site == NULL) {
+      continue;
+    }
+    chprintf(chp, "%08lx %10lu %8lu %8lu",
+             (uint32_t)cs.site, (uint32_t)cs.n, (uint32_t)cs.worst,
+             (uint32_t)(cs.cumulative / (rttime_t)cs.n));
+    for (j = 0U; j < (unsigned)CH_DBG_STATISTICS_CRIT_HIST_SIZE; j++) {
+      chprintf(chp, " %lu", (uint32_t)cs.hist[j]);
+    }
+    chprintf(chp, SHELL_NEWLINE_STR);
+  }
+  chprintf(chp, "dropped: %lu" SHELL_NEWLINE_STR,
+           (uint32_t)ch.kernel_stats.crit_sites_dropped);
+}
+#endif
+
+#if (SHELL_CMD_LOCKS_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_locks(BaseSequentialStream *chp, int argc, char *argv[]) {
+  lock_stats_t ls, *lsp;
+
+  (void)argv;
+  if (argc > 0) {
+    shellUsage(chp, "locks");
+    return;
+  }
+  chprintf(chp, "    name   acquired  contended boosts wait max   wait avg   hold max" SHELL_NEWLINE_STR);
+  /* Objects are copied one at time in order to not print within a
+     critical zone, registered objects are assumed to be permanent.*/
+  chSysLock();
+  lsp = ch.kernel_stats.locks;
+  while (lsp != NULL) {
+    ls = *lsp;
+    chSysUnlock();
+    chprintf(chp, "%8s %10lu %10lu %6lu %10lu %10lu %10lu" SHELL_NEWLINE_STR,
+             ls.name == NULL ? "" : ls.name,
+             (uint32_t)ls.n_acquired, (uint32_t)ls.n_contended,
+             (uint32_t)ls.n_boosts, (uint32_t)ls.wait_worst,
+             ls.n_contended == (ucnt_t)0 ? 0UL :
+             (uint32_t)(ls.wait_cumulative / (rttime_t)ls.n_contended),
+             (uint32_t)ls.hold_worst);
+    chSysLock();
+    lsp = ls.next;
+  }
+  chSysUnlock();
+}
+#endif
+
+#if (SHELL_CMD_PERF_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_perf(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static const char *names[PORT_PMU_COUNTERS] = PORT_PMU_COUNTER_NAMES;
+  pmu_counters_t pc;
+  thread_t *tp;
+  unsigned i;
+
+  (void)argv;
+  if (argc > 0) {
+    shellUsage(chp, "perf");
+    return;
+  }
+  chprintf(chp, "thousands of events" SHELL_NEWLINE_STR);
+  chprintf(chp, "        name");
+  for (i = 0U; i < (unsigned)PORT_PMU_COUNTERS; i++) {
+    chprintf(chp, " %10s", names[i]);
+  }
+  chprintf(chp, SHELL_NEWLINE_STR);
+  tp = chRegFirstThread();
+  do {
+    chSysLock();
+    chStatsGetThreadPMUI(tp, &pc);
+    chSysUnlock();
+    chprintf(chp, "%12s", tp->name == NULL ? "" : tp->name);
+    for (i = 0U; i < (unsigned)PORT_PMU_COUNTERS; i++) {
+      chprintf(chp, " %10lu", (uint32_t)(pc.cnt[i] / 1000U));
+    }
+    chprintf(chp, SHELL_NEWLINE_STR);
+    tp = chRegNextThread(tp);
+  } while (tp != NULL);
+}
+#endif
+
 #if (SHELL_CMD_TEST_ENABLED == TRUE) || defined(__DOXYGEN__)
 static THD_FUNCTION(test_rt, arg) {
   BaseSequentialStream *chp = (BaseSequentialStream *)arg;
@@ -238,6 +368,18 @@ const ShellCommand shell_local_commands[] = {
 #if SHELL_CMD_THREADS_ENABLED == TRUE
   {"threads", cmd_threads},
 #endif
+#if SHELL_CMD_IRQSTAT_ENABLED == TRUE
+  {"irqstat", cmd_irqstat},
+#endif
+#if SHELL_CMD_CRIT_ENABLED == TRUE
+  {"crit", cmd_crit},
+#endif
+#if SHELL_CMD_LOCKS_ENABLED == TRUE
+  {"locks", cmd_locks},
+#endif
+#if SHELL_CMD_PERF_ENABLED == TRUE
+  {"perf", cmd_perf},
+#endif
 #if SHELL_CMD_TEST_ENABLED == TRUE
   {"test", cmd_test},
 #endif
@@ -61,6 +61,22 @@
 #define SHELL_CMD_TEST_ENABLED              TRUE
 #endif
 
+#if !defined(SHELL_CMD_IRQSTAT_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_IRQSTAT_ENABLED           FALSE
+#endif
+
+#if !defined(SHELL_CMD_CRIT_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_CRIT_ENABLED              FALSE
+#endif
+
+#if !defined(SHELL_CMD_LOCKS_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_LOCKS_ENABLED             FALSE
+#endif
+
+#if !defined(SHELL_CMD_PERF_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_PERF_ENABLED              FALSE
+#endif
+
 #if !defined(SHELL_CMD_TEST_WA_SIZE) || defined(__DOXYGEN__)
 #define SHELL_CMD_TEST_WA_SIZE              THD_WORKING_AREA_SIZE(256)
 #endif
@@ -81,6 +97,34 @@
 #error "SHELL_CMD_THREADS_ENABLED requires CH_CFG_USE_REGISTRY"
 #endif
 
+#if (SHELL_CMD_IRQSTAT_ENABLED == TRUE) && (CH_DBG_STATISTICS == FALSE)
+#error "SHELL_CMD_IRQSTAT_ENABLED requires CH_DBG_STATISTICS"
+#endif
+
+#if (SHELL_CMD_IRQSTAT_ENABLED == TRUE) && (CH_DBG_STATISTICS_IRQ_VECTORS == 0)
+#error "SHELL_CMD_IRQSTAT_ENABLED requires CH_DBG_STATISTICS_IRQ_VECTORS"
+#endif
+
+#if (SHELL_CMD_CRIT_ENABLED == TRUE) && (CH_DBG_STATISTICS == FALSE)
+#error "SHELL_CMD_CRIT_ENABLED requires CH_DBG_STATISTICS"
+#endif
+
+#if (SHELL_CMD_CRIT_ENABLED == TRUE) && (CH_DBG_STATISTICS_CRIT_SITES == 0)
+#error "SHELL_CMD_CRIT_ENABLED requires CH_DBG_STATISTICS_CRIT_SITES"
+#endif
+
+#if (SHELL_CMD_LOCKS_ENABLED == TRUE) && (CH_DBG_STATISTICS_LOCKS == FALSE)
+#error "SHELL_CMD_LOCKS_ENABLED requires CH_DBG_STATISTICS_LOCKS"
+#endif
+
+#if (SHELL_CMD_PERF_ENABLED == TRUE) && (CH_DBG_STATISTICS_PMU == FALSE)
+#error "SHELL_CMD_PERF_ENABLED requires CH_DBG_STATISTICS_PMU"
+#endif
+
+#if (SHELL_CMD_PERF_ENABLED == TRUE) && (CH_CFG_USE_REGISTRY == FALSE)
+#error "SHELL_CMD_PERF_ENABLED requires CH_CFG_USE_REGISTRY"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
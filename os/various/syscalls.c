@@ -54,6 +54,7 @@
 *  15.11.09  gdisirio   Added read and write handling
 ****************************************************************************/
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
 #include <string.h>
@@ -61,17 +62,142 @@
 #include <sys/types.h>
 
 #include "ch.h"
-#if defined(STDOUT_SD) || defined(STDIN_SD)
+#include "syscalls.h"
+#if defined(STDOUT_SD) || defined(STDIN_SD) || defined(SYSCALLS_WALLCLOCK)
 #include "hal.h"
 #endif
+#if defined(SYSCALLS_WALLCLOCK)
+#include <sys/time.h>
+#include "hal_wallclock.h"
+
+extern WallClockDriver SYSCALLS_WALLCLOCK;
+#endif
+
+/***************************************************************************/
+
+#if SYSCALLS_USE_STREAMS == TRUE
+/*
+ * File descriptors table, entries are NULL if not in use.
+ */
+static struct {
+  BaseSequentialStream  *stream;
+  bool                  file;
+} syscalls_fds[SYSCALLS_MAX_FDS] = {
+#if defined(STDIN_SD)
+  {(BaseSequentialStream *)&STDIN_SD, false},
+#else
+  {NULL, false},
+#endif
+#if defined(STDOUT_SD)
+  {(BaseSequentialStream *)&STDOUT_SD, false},
+  {(BaseSequentialStream *)&STDOUT_SD, false}
+#endif
+};
+
+static int fd_attach(int fd, BaseSequentialStream *stp, bool file) {
+
+  chDbgCheck((fd < SYSCALLS_MAX_FDS) && (stp != NULL));
+
+  chSysLock();
+  if (fd < 0) {
+    /* Searching for the lowest free descriptor after the standard ones.*/
+    for (fd = 3; fd < SYSCALLS_MAX_FDS; fd++) {
+      if (syscalls_fds[fd].stream == NULL) {
+        break;
+      }
+    }
+    if (fd >= SYSCALLS_MAX_FDS) {
+      chSysUnlock();
+      return -1;
+    }
+  }
+  syscalls_fds[fd].stream = stp;
+  syscalls_fds[fd].file   = file;
+  chSysUnlock();
+
+  return fd;
+}
+
+static BaseSequentialStream *fd_get(struct _reent *r, int file, bool *filep) {
+  BaseSequentialStream *stp = NULL;
+
+  if ((file >= 0) && (file < SYSCALLS_MAX_FDS)) {
+    chSysLock();
+    stp = syscalls_fds[file].stream;
+    if (filep != NULL) {
+      *filep = syscalls_fds[file].file;
+    }
+    chSysUnlock();
+  }
+  if (stp == NULL) {
+    __errno_r(r) = EBADF;
+  }
+  return stp;
+}
+
+/**
+ * @brief   Associates a stream to a file descriptor.
+ *
+ * @param[in] fd        the file descriptor or -1 for the lowest free one
+ *                      above the standard descriptors
+ * @param[in] stp       pointer to the stream
+ * @return              The file descriptor or -1 if the table is full.
+ *
+ * @api
+ */
+int syscallsStreamAttach(int fd, BaseSequentialStream *stp) {
+
+  return fd_attach(fd, stp, false);
+}
+
+/**
+ * @brief   Associates a file stream to a file descriptor.
+ * @details File descriptors associated to file streams support seeking
+ *          and are closed when the descriptor is closed.
+ *
+ * @param[in] fd        the file descriptor or -1 for the lowest free one
+ *                      above the standard descriptors
+ * @param[in] fsp       pointer to the file stream
+ * @return              The file descriptor or -1 if the table is full.
+ *
+ * @api
+ */
+int syscallsFileAttach(int fd, FileStream *fsp) {
+
+  return fd_attach(fd, (BaseSequentialStream *)fsp, true);
+}
+
+/**
+ * @brief   Removes the association of a file descriptor.
+ * @note    The associated object is not closed.
+ *
+ * @param[in] fd        the file descriptor
+ *
+ * @api
+ */
+void syscallsDetach(int fd) {
+
+  chDbgCheck((fd >= 0) && (fd < SYSCALLS_MAX_FDS));
+
+  chSysLock();
+  syscalls_fds[fd].stream = NULL;
+  chSysUnlock();
+}
+#endif /* SYSCALLS_USE_STREAMS == TRUE */
 
 /***************************************************************************/
 
 __attribute__((used))
 int _read_r(struct _reent *r, int file, char * ptr, int len)
 {
-  (void)r;
-#if defined(STDIN_SD)
+#if SYSCALLS_USE_STREAMS == TRUE
+  BaseSequentialStream *stp = fd_get(r, file, NULL);
+
+  if (stp == NULL) {
+    return -1;
+  }
+  return (int)streamRead(stp, (uint8_t *)ptr, (size_t)len);
+#elif defined(STDIN_SD)
   if (!len || (file != 0)) {
     __errno_r(r) = EINVAL;
     return -1;
@@ -92,12 +218,61 @@ int _read_r(struct _reent *r, int file, char * ptr, int len)
 __attribute__((used))
 int _lseek_r(struct _reent *r, int file, int ptr, int dir)
 {
+#if SYSCALLS_USE_STREAMS == TRUE
+  BaseSequentialStream *stp;
+  FileStream *fsp;
+  fileoffset_t offset;
+  bool isfile;
+
+  stp = fd_get(r, file, &isfile);
+  if (stp == NULL) {
+    return -1;
+  }
+  if (!isfile) {
+    __errno_r(r) = ESPIPE;
+    return -1;
+  }
+  fsp = (FileStream *)stp;
+
+  /* Computing the new absolute position.*/
+  switch (dir) {
+  case SEEK_SET:
+    offset = (fileoffset_t)0;
+    break;
+  case SEEK_CUR:
+    if (fileStreamGetPosition(fsp, &offset) != FILE_OK) {
+      __errno_r(r) = EIO;
+      return -1;
+    }
+    break;
+  case SEEK_END:
+    if (fileStreamGetSize(fsp, &offset) != FILE_OK) {
+      __errno_r(r) = EIO;
+      return -1;
+    }
+    break;
+  default:
+    __errno_r(r) = EINVAL;
+    return -1;
+  }
+  if ((ptr < 0) && ((fileoffset_t)-ptr > offset)) {
+    __errno_r(r) = EINVAL;
+    return -1;
+  }
+  offset += (fileoffset_t)ptr;
+  if (fileStreamSetPosition(fsp, offset) != FILE_OK) {
+    __errno_r(r) = EIO;
+    return -1;
+  }
+  return (int)offset;
+#else
   (void)r;
   (void)file;
   (void)ptr;
   (void)dir;
 
   return 0;
+#endif
 }
 
 /***************************************************************************/
@@ -105,6 +280,14 @@ int _lseek_r(struct _reent *r, int file, int ptr, int dir)
 __attribute__((used))
 int _write_r(struct _reent *r, int file, char * ptr, int len)
 {
+#if SYSCALLS_USE_STREAMS == TRUE
+  BaseSequentialStream *stp = fd_get(r, file, NULL);
+
+  if (stp == NULL) {
+    return -1;
+  }
+  return (int)streamWrite(stp, (const uint8_t *)ptr, (size_t)len);
+#else
   (void)r;
   (void)file;
   (void)ptr;
@@ -116,6 +299,7 @@ int _write_r(struct _reent *r, int file, char * ptr, int len)
   sdWrite(&STDOUT_SD, (uint8_t *)ptr, (size_t)len);
 #endif
   return len;
+#endif
 }
 
 /***************************************************************************/
@@ -123,10 +307,28 @@ int _write_r(struct _reent *r, int file, char * ptr, int len)
 __attribute__((used))
 int _close_r(struct _reent *r, int file)
 {
+#if SYSCALLS_USE_STREAMS == TRUE
+  BaseSequentialStream *stp;
+  bool isfile;
+
+  stp = fd_get(r, file, &isfile);
+  if (stp == NULL) {
+    return -1;
+  }
+  syscallsDetach(file);
+  if (isfile) {
+    if (fileStreamClose((FileStream *)stp) != FILE_OK) {
+      __errno_r(r) = EIO;
+      return -1;
+    }
+  }
+  return 0;
+#else
   (void)r;
   (void)file;
 
   return 0;
+#endif
 }
 
 /***************************************************************************/
@@ -154,15 +356,163 @@ caddr_t _sbrk_r(struct _reent *r, int incr)
 
 /***************************************************************************/
 
+#if SYSCALLS_USE_HEAP == TRUE
+/*
+ * The newlib allocator is replaced, the heap allocator is already
+ * thread safe so no further locking is required.
+ */
+__attribute__((used))
+void *_malloc_r(struct _reent *r, size_t size)
+{
+  void *p;
+
+  p = chHeapAlloc(SYSCALLS_HEAP, size);
+  if (p == NULL) {
+    __errno_r(r) = ENOMEM;
+  }
+  return p;
+}
+
+__attribute__((used))
+void _free_r(struct _reent *r, void *p)
+{
+  (void)r;
+
+  if (p != NULL) {
+    chHeapFree(p);
+  }
+}
+
+__attribute__((used))
+void *_calloc_r(struct _reent *r, size_t n, size_t size)
+{
+  void *p;
+
+  if ((size != 0U) && (n > ((size_t)-1 / size))) {
+    __errno_r(r) = ENOMEM;
+    return NULL;
+  }
+  p = _malloc_r(r, n * size);
+  if (p != NULL) {
+    memset(p, 0, n * size);
+  }
+  return p;
+}
+
+__attribute__((used))
+void *_realloc_r(struct _reent *r, void *p, size_t size)
+{
+  void *np;
+  size_t oldsize;
+
+  if (p == NULL) {
+    return _malloc_r(r, size);
+  }
+  if (size == 0U) {
+    chHeapFree(p);
+    return NULL;
+  }
+
+  /* The block is reused if already large enough.*/
+  oldsize = chHeapGetSize(p);
+  if (size <= oldsize) {
+    return p;
+  }
+  np = _malloc_r(r, size);
+  if (np != NULL) {
+    memcpy(np, p, oldsize);
+    chHeapFree(p);
+  }
+  return np;
+}
+
+__attribute__((used))
+void *_memalign_r(struct _reent *r, size_t align, size_t size)
+{
+  void *p;
+
+  if ((align == 0U) || ((align & (align - 1U)) != 0U)) {
+    __errno_r(r) = EINVAL;
+    return NULL;
+  }
+  p = chHeapAllocAligned(SYSCALLS_HEAP, size, (unsigned)align);
+  if (p == NULL) {
+    __errno_r(r) = ENOMEM;
+  }
+  return p;
+}
+
+__attribute__((used))
+size_t _malloc_usable_size_r(struct _reent *r, void *p)
+{
+  (void)r;
+
+  return chHeapGetSize(p);
+}
+
+#elif SYSCALLS_USE_MALLOC_LOCK == TRUE
+/*
+ * The newlib allocator is kept and serialized using a mutex, the lock is
+ * recursive because newlib can nest calls.
+ */
+static MUTEX_DECL(syscalls_malloc_mtx);
+static thread_t *syscalls_malloc_owner;
+static cnt_t syscalls_malloc_cnt;
+
+__attribute__((used))
+void __malloc_lock(struct _reent *r)
+{
+  (void)r;
+
+  /* Allocations performed before the kernel initialization do not need
+     to be serialized.*/
+  if (chThdGetSelfX() == NULL) {
+    return;
+  }
+  if (syscalls_malloc_owner != chThdGetSelfX()) {
+    chMtxLock(&syscalls_malloc_mtx);
+    syscalls_malloc_owner = chThdGetSelfX();
+  }
+  syscalls_malloc_cnt++;
+}
+
+__attribute__((used))
+void __malloc_unlock(struct _reent *r)
+{
+  (void)r;
+
+  if (chThdGetSelfX() == NULL) {
+    return;
+  }
+  if (--syscalls_malloc_cnt == (cnt_t)0) {
+    syscalls_malloc_owner = NULL;
+    chMtxUnlock(&syscalls_malloc_mtx);
+  }
+}
+#endif /* SYSCALLS_USE_MALLOC_LOCK == TRUE */
+
+/***************************************************************************/
+
 __attribute__((used))
 int _fstat_r(struct _reent *r, int file, struct stat * st)
 {
+#if SYSCALLS_USE_STREAMS == TRUE
+  bool isfile;
+
+  if (fd_get(r, file, &isfile) == NULL) {
+    return -1;
+  }
+  memset(st, 0, sizeof(*st));
+  st->st_mode = isfile ? S_IFREG : S_IFCHR;
+  return 0;
+#else
   (void)r;
   (void)file;
 
   memset(st, 0, sizeof(*st));
   st->st_mode = S_IFCHR;
   return 0;
+#endif
 }
 
 /***************************************************************************/
@@ -170,10 +520,39 @@ int _fstat_r(struct _reent *r, int file, struct stat * st)
 __attribute__((used))
 int _isatty_r(struct _reent *r, int fd)
 {
+#if SYSCALLS_USE_STREAMS == TRUE
+  bool isfile;
+
+  if (fd_get(r, fd, &isfile) == NULL) {
+    return 0;
+  }
+  return isfile ? 0 : 1;
+#else
   (void)r;
   (void)fd;
 
   return 1;
+#endif
+}
+
+/***************************************************************************/
+
+#if defined(SYSCALLS_WALLCLOCK)
+__attribute__((used))
+int _gettimeofday_r(struct _reent *r, struct timeval *tv, void *tz)
+{
+  int64_t us;
+
+  (void)r;
+  (void)tz;
+
+  if (tv != NULL) {
+    us = wclkGetTimeUS(&SYSCALLS_WALLCLOCK);
+    tv->tv_sec  = (time_t)(us / 1000000);
+    tv->tv_usec = (suseconds_t)(us % 1000000);
+  }
+  return 0;
 }
+#endif
 
 /*** EOF ***/
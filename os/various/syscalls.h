@@ -0,0 +1,159 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    syscalls.h
+ * @brief   Newlib retargeting layer header.
+ * @details The retargeting layer can be configured using the following
+ *          options, usually specified in the makefile:
+ *          - @p SYSCALLS_USE_HEAP, routes the newlib allocator functions
+ *            to a ChibiOS heap.
+ *          - @p SYSCALLS_USE_MALLOC_LOCK, serializes the newlib allocator
+ *            using a mutex.
+ *          - @p SYSCALLS_USE_STREAMS, maps file descriptors to streams.
+ *          - @p SYSCALLS_USE_REENT, per-thread reentrancy structures,
+ *            see @p syscalls_hooks.h.
+ *          - @p SYSCALLS_WALLCLOCK, name of a @p WallClockDriver object
+ *            serving @p gettimeofday() and so @p time().
+ *          .
+ *
+ * @addtogroup NEWLIB_SYSCALLS
+ * @{
+ */
+
+#ifndef SYSCALLS_H
+#define SYSCALLS_H
+
+#include "ch.h"
+#include "syscalls_hooks.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Newlib allocator on a ChibiOS heap.
+ * @details If enabled then @p malloc(), @p free(), @p realloc(),
+ *          @p calloc() and @p memalign() are served by @p chHeapAlloc(),
+ *          @p chHeapAllocAligned() and @p chHeapFree() so freed memory
+ *          is returned to the heap and can be reused by other heap users.
+ *          If disabled then the newlib allocator is used on top of
+ *          @p _sbrk_r(), see @p SYSCALLS_USE_MALLOC_LOCK.
+ */
+#if !defined(SYSCALLS_USE_HEAP) || defined(__DOXYGEN__)
+#define SYSCALLS_USE_HEAP                   FALSE
+#endif
+
+/**
+ * @brief   Newlib allocator serialization.
+ * @details If enabled then @p __malloc_lock() and @p __malloc_unlock()
+ *          serialize the newlib allocator using a recursive mutex. If
+ *          disabled then newlib's own stubs are used and the allocator is
+ *          not thread safe.
+ * @note    Only used if @p SYSCALLS_USE_HEAP is @p FALSE, the heap
+ *          allocator is already thread safe.
+ * @note    If enabled the allocator can only be invoked from thread
+ *          context outside critical zones.
+ * @note    The default is @p TRUE, disabling it is only safe if the
+ *          allocator is used by a single thread.
+ */
+#if !defined(SYSCALLS_USE_MALLOC_LOCK) || defined(__DOXYGEN__)
+#define SYSCALLS_USE_MALLOC_LOCK            TRUE
+#endif
+
+/**
+ * @brief   Heap used by the newlib allocator.
+ * @note    @p NULL means the default heap.
+ */
+#if !defined(SYSCALLS_HEAP) || defined(__DOXYGEN__)
+#define SYSCALLS_HEAP                       NULL
+#endif
+
+/**
+ * @brief   File descriptors mapped on streams.
+ * @details If enabled then file descriptors are entries of a table of
+ *          @p BaseSequentialStream or @p FileStream objects, descriptors
+ *          0, 1 and 2 are initially associated to @p STDIN_SD and
+ *          @p STDOUT_SD if defined. If disabled then only @p STDIN_SD
+ *          and @p STDOUT_SD are supported.
+ */
+#if !defined(SYSCALLS_USE_STREAMS) || defined(__DOXYGEN__)
+#define SYSCALLS_USE_STREAMS                FALSE
+#endif
+
+/**
+ * @brief   Number of file descriptors.
+ */
+#if !defined(SYSCALLS_MAX_FDS) || defined(__DOXYGEN__)
+#define SYSCALLS_MAX_FDS                    8
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SYSCALLS_USE_HEAP == TRUE) && (CH_CFG_USE_HEAP == FALSE)
+#error "SYSCALLS_USE_HEAP requires CH_CFG_USE_HEAP"
+#endif
+
+#if (SYSCALLS_USE_HEAP == FALSE) && (SYSCALLS_USE_MALLOC_LOCK == TRUE) &&   \
+    (CH_CFG_USE_MUTEXES == FALSE)
+#error "SYSCALLS_USE_MALLOC_LOCK requires CH_CFG_USE_MUTEXES"
+#endif
+
+#if SYSCALLS_MAX_FDS < 3
+#error "invalid SYSCALLS_MAX_FDS value"
+#endif
+
+#if SYSCALLS_USE_STREAMS == TRUE
+#include "hal.h"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if (SYSCALLS_USE_STREAMS == TRUE) || defined(__DOXYGEN__)
+  int syscallsStreamAttach(int fd, BaseSequentialStream *stp);
+  int syscallsFileAttach(int fd, FileStream *fsp);
+  void syscallsDetach(int fd);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* SYSCALLS_H */
+
+/** @} */
@@ -0,0 +1,130 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    syscalls_hooks.h
+ * @brief   Newlib per-thread reentrancy hooks.
+ * @details This header has no dependencies on the kernel headers so it
+ *          can be included from @p chconf.h, the hooks are meant to be
+ *          used as follows:
+ *          @code
+ *          #include "syscalls_hooks.h"
+ *
+ *          #define CH_CFG_THREAD_EXTRA_FIELDS                              \
+ *            SYSCALLS_THREAD_EXTRA_FIELDS
+ *
+ *          #define CH_CFG_THREAD_INIT_HOOK(tp) {                           \
+ *            SYSCALLS_THREAD_INIT_HOOK(tp);                                \
+ *          }
+ *
+ *          #define CH_CFG_CONTEXT_SWITCH_HOOK(ntp, otp) {                  \
+ *            SYSCALLS_CONTEXT_SWITCH_HOOK(ntp, otp);                       \
+ *          }
+ *          @endcode
+ * @note    The stdio buffers allocated by a thread are not reclaimed
+ *          automatically because the exit hook is invoked in a critical
+ *          zone, a thread using stdio should invoke
+ *          @p _reclaim_reent(_REENT) before terminating.
+ *
+ * @addtogroup NEWLIB_SYSCALLS
+ * @{
+ */
+
+#ifndef SYSCALLS_HOOKS_H
+#define SYSCALLS_HOOKS_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Per-thread newlib reentrancy structures.
+ * @details If enabled then each thread embeds its own @p struct @p _reent
+ *          and @p _impure_ptr is switched with the thread, so @p errno,
+ *          stdio streams and the other newlib per-context states are
+ *          private to each thread.
+ * @note    The @p struct @p _reent size is significant, it is added to
+ *          each thread including the idle thread.
+ */
+#if !defined(SYSCALLS_USE_REENT) || defined(__DOXYGEN__)
+#define SYSCALLS_USE_REENT                  FALSE
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SYSCALLS_USE_REENT == TRUE) && !defined(_FROM_ASM_)
+#include <reent.h>
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+#if (SYSCALLS_USE_REENT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Thread fields required by the reentrancy support.
+ */
+#define SYSCALLS_THREAD_EXTRA_FIELDS                                        \
+  struct _reent             newlib_reent;
+
+/**
+ * @brief   Thread initialization hook.
+ * @note    It is invoked in a critical zone, the newlib initializer does
+ *          not allocate memory.
+ *
+ * @param[in] tp        pointer to the thread being initialized
+ */
+#define SYSCALLS_THREAD_INIT_HOOK(tp) {                                     \
+  _REENT_INIT_PTR(&(tp)->newlib_reent);                                     \
+}
+
+/**
+ * @brief   Context switch hook.
+ *
+ * @param[in] ntp       thread being switched in
+ * @param[in] otp       thread being switched out
+ */
+#define SYSCALLS_CONTEXT_SWITCH_HOOK(ntp, otp) {                            \
+  (void)(otp);                                                              \
+  _impure_ptr = &(ntp)->newlib_reent;                                       \
+}
+#else
+#define SYSCALLS_THREAD_EXTRA_FIELDS
+#define SYSCALLS_THREAD_INIT_HOOK(tp) {(void)(tp);}
+#define SYSCALLS_CONTEXT_SWITCH_HOOK(ntp, otp) {(void)(ntp); (void)(otp);}
+#endif
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* SYSCALLS_HOOKS_H */
+
+/** @} */
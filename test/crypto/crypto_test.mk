@@ -13,7 +13,9 @@ TESTSRC += 	 ${CHIBIOS}/test/crypto/source/test/cry_test_root.c 			\
 			 ${CHIBIOS}/test/crypto/source/test/cry_test_sequence_006.c		\
 			 ${CHIBIOS}/test/crypto/source/test/cry_test_sequence_007.c		\
 			 ${CHIBIOS}/test/crypto/source/test/cry_test_sequence_008.c		\
-			 ${CHIBIOS}/test/crypto/source/test/cry_test_sequence_009.c
+			 ${CHIBIOS}/test/crypto/source/test/cry_test_sequence_009.c		\
+			 ${CHIBIOS}/test/crypto/source/test/cry_test_sequence_010.c		\
+			 ${CHIBIOS}/test/crypto/source/test/cry_test_sequence_011.c
 # Required include directories
 TESTINC +=  ${CHIBIOS}/test/crypto/source/testref	\
 			${CHIBIOS}/test/crypto/source/test
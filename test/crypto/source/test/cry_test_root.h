@@ -33,6 +33,8 @@
 #include "cry_test_sequence_007.h"
 #include "cry_test_sequence_008.h"
 #include "cry_test_sequence_009.h"
+#include "cry_test_sequence_010.h"
+#include "cry_test_sequence_011.h"
 
 #if !defined(__DOXYGEN__)
 
@@ -53,6 +55,12 @@ extern "C" {
 /* Shared definitions.                                                       */
 /*===========================================================================*/
 
+#if HAL_CRY_ENFORCE_FALLBACK == TRUE
+/* There is no LLD in standalone mode, the driver is defined by the
+   application.*/
+extern CRYDriver CRYD1;
+#endif
+
 extern void cryptoTest_setStream(BaseSequentialStream * s);
 extern void cryptoTest_printArray32(bool isLE,const uint32_t *a,size_t len);
 #ifdef LOG_CRYPTO_DATA
@@ -0,0 +1,475 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "cry_test_root.h"
+
+/**
+ * @file    cry_test_sequence_010.c
+ * @brief   Test Sequence 010 code.
+ *
+ * @page cry_test_sequence_010 [10] Standard Vectors
+ *
+ * File: @ref cry_test_sequence_010.c
+ *
+ * <h2>Description</h2>
+ * The driver is tested against the published test vectors of the AES,
+ * AES modes and HMAC-SHA256 standards, using transient keys.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage cry_test_010_001
+ * - @subpage cry_test_010_002
+ * - @subpage cry_test_010_003
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#if HAL_CRY_ENFORCE_FALLBACK == FALSE
+static const CRYConfig config_Polling = {
+  TRANSFER_POLLING,
+  0
+};
+#else
+static const CRYConfig config_Polling = {
+  0
+};
+#endif
+
+static uint8_t out[64];
+static uint8_t out2[64];
+
+/* FIPS-197 appendix C, the key is 00010203... truncated to the key size.*/
+
+static const uint8_t fips197_key[32] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+  0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F
+};
+
+static const uint8_t fips197_plain[16] = {
+  0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+  0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+};
+
+static const uint8_t fips197_aes128[16] = {
+  0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+  0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A
+};
+
+static const uint8_t fips197_aes192[16] = {
+  0xDD, 0xA9, 0x7C, 0xA4, 0x86, 0x4C, 0xDF, 0xE0,
+  0x6E, 0xAF, 0x70, 0xA0, 0xEC, 0x0D, 0x71, 0x91
+};
+
+static const uint8_t fips197_aes256[16] = {
+  0x8E, 0xA2, 0xB7, 0xCA, 0x51, 0x67, 0x45, 0xBF,
+  0xEA, 0xFC, 0x49, 0x90, 0x4B, 0x49, 0x60, 0x89
+};
+
+/* SP800-38A appendix F, AES-128.*/
+
+static const uint8_t sp800_key[16] = {
+  0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+  0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C
+};
+
+static const uint8_t sp800_iv[16] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F
+};
+
+static const uint8_t sp800_ctr[16] = {
+  0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7,
+  0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF
+};
+
+static const uint8_t sp800_plain[64] = {
+  0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96,
+  0xE9, 0x3D, 0x7E, 0x11, 0x73, 0x93, 0x17, 0x2A,
+  0xAE, 0x2D, 0x8A, 0x57, 0x1E, 0x03, 0xAC, 0x9C,
+  0x9E, 0xB7, 0x6F, 0xAC, 0x45, 0xAF, 0x8E, 0x51,
+  0x30, 0xC8, 0x1C, 0x46, 0xA3, 0x5C, 0xE4, 0x11,
+  0xE5, 0xFB, 0xC1, 0x19, 0x1A, 0x0A, 0x52, 0xEF,
+  0xF6, 0x9F, 0x24, 0x45, 0xDF, 0x4F, 0x9B, 0x17,
+  0xAD, 0x2B, 0x41, 0x7B, 0xE6, 0x6C, 0x37, 0x10
+};
+
+static const uint8_t sp800_ecb[64] = {
+  0x3A, 0xD7, 0x7B, 0xB4, 0x0D, 0x7A, 0x36, 0x60,
+  0xA8, 0x9E, 0xCA, 0xF3, 0x24, 0x66, 0xEF, 0x97,
+  0xF5, 0xD3, 0xD5, 0x85, 0x03, 0xB9, 0x69, 0x9D,
+  0xE7, 0x85, 0x89, 0x5A, 0x96, 0xFD, 0xBA, 0xAF,
+  0x43, 0xB1, 0xCD, 0x7F, 0x59, 0x8E, 0xCE, 0x23,
+  0x88, 0x1B, 0x00, 0xE3, 0xED, 0x03, 0x06, 0x88,
+  0x7B, 0x0C, 0x78, 0x5E, 0x27, 0xE8, 0xAD, 0x3F,
+  0x82, 0x23, 0x20, 0x71, 0x04, 0x72, 0x5D, 0xD4
+};
+
+static const uint8_t sp800_cbc[64] = {
+  0x76, 0x49, 0xAB, 0xAC, 0x81, 0x19, 0xB2, 0x46,
+  0xCE, 0xE9, 0x8E, 0x9B, 0x12, 0xE9, 0x19, 0x7D,
+  0x50, 0x86, 0xCB, 0x9B, 0x50, 0x72, 0x19, 0xEE,
+  0x95, 0xDB, 0x11, 0x3A, 0x91, 0x76, 0x78, 0xB2,
+  0x73, 0xBE, 0xD6, 0xB8, 0xE3, 0xC1, 0x74, 0x3B,
+  0x71, 0x16, 0xE6, 0x9E, 0x22, 0x22, 0x95, 0x16,
+  0x3F, 0xF1, 0xCA, 0xA1, 0x68, 0x1F, 0xAC, 0x09,
+  0x12, 0x0E, 0xCA, 0x30, 0x75, 0x86, 0xE1, 0xA7
+};
+
+static const uint8_t sp800_cfb[64] = {
+  0x3B, 0x3F, 0xD9, 0x2E, 0xB7, 0x2D, 0xAD, 0x20,
+  0x33, 0x34, 0x49, 0xF8, 0xE8, 0x3C, 0xFB, 0x4A,
+  0xC8, 0xA6, 0x45, 0x37, 0xA0, 0xB3, 0xA9, 0x3F,
+  0xCD, 0xE3, 0xCD, 0xAD, 0x9F, 0x1C, 0xE5, 0x8B,
+  0x26, 0x75, 0x1F, 0x67, 0xA3, 0xCB, 0xB1, 0x40,
+  0xB1, 0x80, 0x8C, 0xF1, 0x87, 0xA4, 0xF4, 0xDF,
+  0xC0, 0x4B, 0x05, 0x35, 0x7C, 0x5D, 0x1C, 0x0E,
+  0xEA, 0xC4, 0xC6, 0x6F, 0x9F, 0xF7, 0xF2, 0xE6
+};
+
+static const uint8_t sp800_ctr_out[64] = {
+  0x87, 0x4D, 0x61, 0x91, 0xB6, 0x20, 0xE3, 0x26,
+  0x1B, 0xEF, 0x68, 0x64, 0x99, 0x0D, 0xB6, 0xCE,
+  0x98, 0x06, 0xF6, 0x6B, 0x79, 0x70, 0xFD, 0xFF,
+  0x86, 0x17, 0x18, 0x7B, 0xB9, 0xFF, 0xFD, 0xFF,
+  0x5A, 0xE4, 0xDF, 0x3E, 0xDB, 0xD5, 0xD3, 0x5E,
+  0x5B, 0x4F, 0x09, 0x02, 0x0D, 0xB0, 0x3E, 0xAB,
+  0x1E, 0x03, 0x1D, 0xDA, 0x2F, 0xBE, 0x03, 0xD1,
+  0x79, 0x21, 0x70, 0xA0, 0xF3, 0x00, 0x9C, 0xEE
+};
+
+/* RFC 4231 test cases 1, 2, 6 and 7.*/
+
+static const uint8_t rfc4231_hmac1[32] = {
+  0xB0, 0x34, 0x4C, 0x61, 0xD8, 0xDB, 0x38, 0x53,
+  0x5C, 0xA8, 0xAF, 0xCE, 0xAF, 0x0B, 0xF1, 0x2B,
+  0x88, 0x1D, 0xC2, 0x00, 0xC9, 0x83, 0x3D, 0xA7,
+  0x26, 0xE9, 0x37, 0x6C, 0x2E, 0x32, 0xCF, 0xF7
+};
+
+static const uint8_t rfc4231_hmac2[32] = {
+  0x5B, 0xDC, 0xC1, 0x46, 0xBF, 0x60, 0x75, 0x4E,
+  0x6A, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xC7,
+  0x5A, 0x00, 0x3F, 0x08, 0x9D, 0x27, 0x39, 0x83,
+  0x9D, 0xEC, 0x58, 0xB9, 0x64, 0xEC, 0x38, 0x43
+};
+
+static const uint8_t rfc4231_hmac6[32] = {
+  0x60, 0xE4, 0x31, 0x59, 0x1E, 0xE0, 0xB6, 0x7F,
+  0x0D, 0x8A, 0x26, 0xAA, 0xCB, 0xF5, 0xB7, 0x7F,
+  0x8E, 0x0B, 0xC6, 0x21, 0x37, 0x28, 0xC5, 0x14,
+  0x05, 0x46, 0x04, 0x0F, 0x0E, 0xE3, 0x7F, 0x54
+};
+
+static const uint8_t rfc4231_hmac7[32] = {
+  0x9B, 0x09, 0xFF, 0xA7, 0x1B, 0x94, 0x2F, 0xCB,
+  0x27, 0x63, 0x5F, 0xBC, 0xD5, 0xB0, 0xE9, 0x44,
+  0xBF, 0xDC, 0x63, 0x64, 0x4F, 0x07, 0x13, 0x93,
+  0x8A, 0x7F, 0x51, 0x53, 0x5C, 0x3A, 0x35, 0xE2
+};
+
+static const char rfc4231_msg6[] =
+  "Test Using Larger Than Block-Size Key - Hash Key First";
+
+static const char rfc4231_msg7[] =
+  "This is a test using a larger than block-size key and a larger than "
+  "block-size data. The key needs to be hashed before being used by the "
+  "HMAC algorithm.";
+
+static void hmac_sha256(const uint8_t *keyp, size_t ksize,
+                        const void *msgp, size_t msize, uint8_t *mac) {
+  HMACSHA256Context ctx;
+  cryerror_t ret;
+
+  ret = cryLoadHMACTransientKey(&CRYD1, ksize, keyp);
+  test_assert(ret == CRY_NOERROR, "failed load transient key");
+  ret = cryHMACSHA256Init(&CRYD1, &ctx);
+  test_assert(ret == CRY_NOERROR, "failed init HMACSHA256");
+  ret = cryHMACSHA256Update(&CRYD1, &ctx, msize, (const uint8_t *)msgp);
+  test_assert(ret == CRY_NOERROR, "failed update HMACSHA256");
+  ret = cryHMACSHA256Final(&CRYD1, &ctx, mac);
+  test_assert(ret == CRY_NOERROR, "failed final HMACSHA256");
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page cry_test_010_001 [10.1] AES FIPS-197
+ *
+ * <h2>Description</h2>
+ * The FIPS-197 appendix C example vectors are encrypted and decrypted
+ * with 128, 192 and 256 bits keys.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.1.1] Loading the 128 bits key, encrypting and decrypting the
+ *   FIPS-197 block.
+ * - [10.1.2] Loading the 192 bits key, encrypting and decrypting the
+ *   FIPS-197 block.
+ * - [10.1.3] Loading the 256 bits key, encrypting and decrypting the
+ *   FIPS-197 block.
+ * .
+ */
+
+static void cry_test_010_001_setup(void) {
+  memset(out, 0xFF, sizeof out);
+  cryStart(&CRYD1, &config_Polling);
+}
+
+static void cry_test_010_001_teardown(void) {
+  cryStop(&CRYD1);
+}
+
+static void cry_test_010_001_execute(void) {
+  cryerror_t ret;
+
+  /* [10.1.1] Loading the 128 bits key, encrypting and decrypting the
+     FIPS-197 block.*/
+  test_set_step(1);
+  {
+    ret = cryLoadAESTransientKey(&CRYD1, 16, fips197_key);
+    test_assert(ret == CRY_NOERROR, "failed load transient key");
+    ret = cryEncryptAES(&CRYD1, 0, fips197_plain, out);
+    test_assert(ret == CRY_NOERROR, "failed encryption");
+    test_assert(memcmp(out, fips197_aes128, 16) == 0, "encrypt mismatch");
+    ret = cryDecryptAES(&CRYD1, 0, out, out2);
+    test_assert(ret == CRY_NOERROR, "failed decryption");
+    test_assert(memcmp(out2, fips197_plain, 16) == 0, "decrypt mismatch");
+  }
+
+  /* [10.1.2] Loading the 192 bits key, encrypting and decrypting the
+     FIPS-197 block.*/
+  test_set_step(2);
+  {
+    ret = cryLoadAESTransientKey(&CRYD1, 24, fips197_key);
+    test_assert(ret == CRY_NOERROR, "failed load transient key");
+    ret = cryEncryptAES(&CRYD1, 0, fips197_plain, out);
+    test_assert(ret == CRY_NOERROR, "failed encryption");
+    test_assert(memcmp(out, fips197_aes192, 16) == 0, "encrypt mismatch");
+    ret = cryDecryptAES(&CRYD1, 0, out, out2);
+    test_assert(ret == CRY_NOERROR, "failed decryption");
+    test_assert(memcmp(out2, fips197_plain, 16) == 0, "decrypt mismatch");
+  }
+
+  /* [10.1.3] Loading the 256 bits key, encrypting and decrypting the
+     FIPS-197 block.*/
+  test_set_step(3);
+  {
+    ret = cryLoadAESTransientKey(&CRYD1, 32, fips197_key);
+    test_assert(ret == CRY_NOERROR, "failed load transient key");
+    ret = cryEncryptAES(&CRYD1, 0, fips197_plain, out);
+    test_assert(ret == CRY_NOERROR, "failed encryption");
+    test_assert(memcmp(out, fips197_aes256, 16) == 0, "encrypt mismatch");
+    ret = cryDecryptAES(&CRYD1, 0, out, out2);
+    test_assert(ret == CRY_NOERROR, "failed decryption");
+    test_assert(memcmp(out2, fips197_plain, 16) == 0, "decrypt mismatch");
+  }
+}
+
+static const testcase_t cry_test_010_001 = {
+  "AES FIPS-197",
+  cry_test_010_001_setup,
+  cry_test_010_001_teardown,
+  cry_test_010_001_execute
+};
+
+/**
+ * @page cry_test_010_002 [10.2] AES modes SP800-38A
+ *
+ * <h2>Description</h2>
+ * The SP800-38A appendix F AES-128 vectors are encrypted and decrypted
+ * in the ECB, CBC, CFB and CTR modes, the CBC decryption is performed
+ * in place.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.2.1] Loading the key.
+ * - [10.2.2] Encrypting and decrypting the four blocks in ECB mode.
+ * - [10.2.3] Encrypting the four blocks in CBC mode then decrypting
+ *   them in place.
+ * - [10.2.4] Encrypting and decrypting the four blocks in CFB mode.
+ * - [10.2.5] Encrypting and decrypting the four blocks in CTR mode.
+ * .
+ */
+
+static void cry_test_010_002_setup(void) {
+  memset(out, 0xFF, sizeof out);
+  cryStart(&CRYD1, &config_Polling);
+}
+
+static void cry_test_010_002_teardown(void) {
+  cryStop(&CRYD1);
+}
+
+static void cry_test_010_002_execute(void) {
+  cryerror_t ret;
+
+  /* [10.2.1] Loading the key.*/
+  test_set_step(1);
+  {
+    ret = cryLoadAESTransientKey(&CRYD1, sizeof sp800_key, sp800_key);
+    test_assert(ret == CRY_NOERROR, "failed load transient key");
+  }
+
+  /* [10.2.2] Encrypting and decrypting the four blocks in ECB mode.*/
+  test_set_step(2);
+  {
+    ret = cryEncryptAES_ECB(&CRYD1, 0, 64, sp800_plain, out);
+    test_assert(ret == CRY_NOERROR, "failed encryption");
+    test_assert(memcmp(out, sp800_ecb, 64) == 0, "encrypt mismatch");
+    ret = cryDecryptAES_ECB(&CRYD1, 0, 64, out, out2);
+    test_assert(ret == CRY_NOERROR, "failed decryption");
+    test_assert(memcmp(out2, sp800_plain, 64) == 0, "decrypt mismatch");
+  }
+
+  /* [10.2.3] Encrypting the four blocks in CBC mode then decrypting
+     them in place.*/
+  test_set_step(3);
+  {
+    ret = cryEncryptAES_CBC(&CRYD1, 0, 64, sp800_plain, out, sp800_iv);
+    test_assert(ret == CRY_NOERROR, "failed encryption");
+    test_assert(memcmp(out, sp800_cbc, 64) == 0, "encrypt mismatch");
+    memcpy(out2, out, 64);
+    ret = cryDecryptAES_CBC(&CRYD1, 0, 64, out2, out2, sp800_iv);
+    test_assert(ret == CRY_NOERROR, "failed decryption");
+    test_assert(memcmp(out2, sp800_plain, 64) == 0, "decrypt mismatch");
+  }
+
+  /* [10.2.4] Encrypting and decrypting the four blocks in CFB mode.*/
+  test_set_step(4);
+  {
+    ret = cryEncryptAES_CFB(&CRYD1, 0, 64, sp800_plain, out, sp800_iv);
+    test_assert(ret == CRY_NOERROR, "failed encryption");
+    test_assert(memcmp(out, sp800_cfb, 64) == 0, "encrypt mismatch");
+    ret = cryDecryptAES_CFB(&CRYD1, 0, 64, out, out2, sp800_iv);
+    test_assert(ret == CRY_NOERROR, "failed decryption");
+    test_assert(memcmp(out2, sp800_plain, 64) == 0, "decrypt mismatch");
+  }
+
+  /* [10.2.5] Encrypting and decrypting the four blocks in CTR mode.*/
+  test_set_step(5);
+  {
+    ret = cryEncryptAES_CTR(&CRYD1, 0, 64, sp800_plain, out, sp800_ctr);
+    test_assert(ret == CRY_NOERROR, "failed encryption");
+    test_assert(memcmp(out, sp800_ctr_out, 64) == 0, "encrypt mismatch");
+    ret = cryDecryptAES_CTR(&CRYD1, 0, 64, out, out2, sp800_ctr);
+    test_assert(ret == CRY_NOERROR, "failed decryption");
+    test_assert(memcmp(out2, sp800_plain, 64) == 0, "decrypt mismatch");
+  }
+}
+
+static const testcase_t cry_test_010_002 = {
+  "AES modes SP800-38A",
+  cry_test_010_002_setup,
+  cry_test_010_002_teardown,
+  cry_test_010_002_execute
+};
+
+/**
+ * @page cry_test_010_003 [10.3] HMAC-SHA256 RFC 4231
+ *
+ * <h2>Description</h2>
+ * The RFC 4231 test cases 1, 2, 6 and 7 are computed, cases 6 and 7 use
+ * a key larger than the block size.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.3.1] Test case 1, 20 bytes key.
+ * - [10.3.2] Test case 2, key shorter than the output.
+ * - [10.3.3] Test case 6, 131 bytes key.
+ * - [10.3.4] Test case 7, 131 bytes key and data larger than the block
+ *   size.
+ * .
+ */
+
+static void cry_test_010_003_setup(void) {
+  memset(out, 0xFF, sizeof out);
+  cryStart(&CRYD1, &config_Polling);
+}
+
+static void cry_test_010_003_teardown(void) {
+  cryStop(&CRYD1);
+}
+
+static void cry_test_010_003_execute(void) {
+  uint8_t key[131];
+
+  /* [10.3.1] Test case 1, 20 bytes key.*/
+  test_set_step(1);
+  {
+    memset(key, 0x0B, 20);
+    hmac_sha256(key, 20, "Hi There", 8, out);
+    test_assert(memcmp(out, rfc4231_hmac1, 32) == 0, "hmac mismatch");
+  }
+
+  /* [10.3.2] Test case 2, key shorter than the output.*/
+  test_set_step(2);
+  {
+    hmac_sha256((const uint8_t *)"Jefe", 4,
+                "what do ya want for nothing?", 28, out);
+    test_assert(memcmp(out, rfc4231_hmac2, 32) == 0, "hmac mismatch");
+  }
+
+  /* [10.3.3] Test case 6, 131 bytes key.*/
+  test_set_step(3);
+  {
+    memset(key, 0xAA, 131);
+    hmac_sha256(key, 131, rfc4231_msg6, sizeof rfc4231_msg6 - 1U, out);
+    test_assert(memcmp(out, rfc4231_hmac6, 32) == 0, "hmac mismatch");
+  }
+
+  /* [10.3.4] Test case 7, 131 bytes key and data larger than the block
+     size.*/
+  test_set_step(4);
+  {
+    hmac_sha256(key, 131, rfc4231_msg7, sizeof rfc4231_msg7 - 1U, out);
+    test_assert(memcmp(out, rfc4231_hmac7, 32) == 0, "hmac mismatch");
+  }
+}
+
+static const testcase_t cry_test_010_003 = {
+  "HMAC-SHA256 RFC 4231",
+  cry_test_010_003_setup,
+  cry_test_010_003_teardown,
+  cry_test_010_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const cry_test_sequence_010_array[] = {
+  &cry_test_010_001,
+  &cry_test_010_002,
+  &cry_test_010_003,
+  NULL
+};
+
+/**
+ * @brief   Standard Vectors.
+ */
+const testsequence_t cry_test_sequence_010 = {
+  "Standard Vectors",
+  cry_test_sequence_010_array
+};
@@ -0,0 +1,388 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "cry_test_root.h"
+
+/**
+ * @file    cry_test_sequence_011.c
+ * @brief   Test Sequence 011 code.
+ *
+ * @page cry_test_sequence_011 [11] Key Slots
+ *
+ * File: @ref cry_test_sequence_011.c
+ *
+ * <h2>Description</h2>
+ * The key slots are tested, keys are loaded, used, evicted and deleted.
+ * Stale key identifiers must be rejected.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_CRY_KEY_SLOTS > 0
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage cry_test_011_001
+ * - @subpage cry_test_011_002
+ * - @subpage cry_test_011_003
+ * .
+ */
+
+#if (HAL_CRY_KEY_SLOTS > 0) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#if HAL_CRY_ENFORCE_FALLBACK == FALSE
+static const CRYConfig config_Polling = {
+  TRANSFER_POLLING,
+  0
+};
+#else
+static const CRYConfig config_Polling = {
+  0
+};
+#endif
+
+static uint8_t out[16];
+static uint8_t out2[16];
+
+/* FIPS-197 appendix C.1 and RFC 4231 test case 1.*/
+
+static const uint8_t fips197_key[16] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F
+};
+
+static const uint8_t fips197_plain[16] = {
+  0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+  0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+};
+
+static const uint8_t fips197_aes128[16] = {
+  0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+  0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A
+};
+
+static const uint8_t rfc4231_hmac1[32] = {
+  0xB0, 0x34, 0x4C, 0x61, 0xD8, 0xDB, 0x38, 0x53,
+  0x5C, 0xA8, 0xAF, 0xCE, 0xAF, 0x0B, 0xF1, 0x2B,
+  0x88, 0x1D, 0xC2, 0x00, 0xC9, 0x83, 0x3D, 0xA7,
+  0x26, 0xE9, 0x37, 0x6C, 0x2E, 0x32, 0xCF, 0xF7
+};
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page cry_test_011_001 [11.1] Loading and deleting keys
+ *
+ * <h2>Description</h2>
+ * AES and HMAC keys are loaded in slots and used, the identifiers are
+ * then invalidated by deleting the keys.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.1.1] Loading a key with an invalid size, the operation must
+ *   fail.
+ * - [11.1.2] Loading an AES key, the FIPS-197 block must be encrypted
+ *   using the identifier.
+ * - [11.1.3] Loading the same key again, the same identifier must be
+ *   returned.
+ * - [11.1.4] Deleting the AES key, the identifier must be rejected.
+ * - [11.1.5] Loading an HMAC key, the RFC 4231 case 1 must be computed
+ *   using the identifier. The key must be rejected by AES operations
+ *   and the identifier of the deleted AES key must still be rejected.
+ * - [11.1.6] Deleting the HMAC key, the identifier must be rejected.
+ * .
+ */
+
+static void cry_test_011_001_setup(void) {
+  cryStart(&CRYD1, &config_Polling);
+}
+
+static void cry_test_011_001_teardown(void) {
+  cryDeleteAllKeys(&CRYD1);
+  cryStop(&CRYD1);
+}
+
+static void cry_test_011_001_execute(void) {
+  cryerror_t ret;
+  crykey_t aes_id, aes_id2, hmac_id;
+  HMACSHA256Context ctx;
+  uint8_t key[20];
+  uint8_t mac[32];
+
+  /* [11.1.1] Loading a key with an invalid size, the operation must
+     fail.*/
+  test_set_step(1);
+  {
+    ret = cryLoadAESKey(&CRYD1, 15, fips197_key, &aes_id);
+    test_assert(ret == CRY_ERR_INV_KEY_SIZE, "size not checked");
+  }
+
+  /* [11.1.2] Loading an AES key, the FIPS-197 block must be encrypted
+     using the identifier.*/
+  test_set_step(2);
+  {
+    ret = cryLoadAESKey(&CRYD1, 16, fips197_key, &aes_id);
+    test_assert(ret == CRY_NOERROR, "failed load key");
+    ret = cryEncryptAES(&CRYD1, aes_id, fips197_plain, out);
+    test_assert(ret == CRY_NOERROR, "failed encryption");
+    test_assert(memcmp(out, fips197_aes128, 16) == 0, "encrypt mismatch");
+    ret = cryDecryptAES(&CRYD1, aes_id, out, out2);
+    test_assert(ret == CRY_NOERROR, "failed decryption");
+    test_assert(memcmp(out2, fips197_plain, 16) == 0, "decrypt mismatch");
+  }
+
+  /* [11.1.3] Loading the same key again, the same identifier must be
+     returned.*/
+  test_set_step(3);
+  {
+    ret = cryLoadAESKey(&CRYD1, 16, fips197_key, &aes_id2);
+    test_assert(ret == CRY_NOERROR, "failed load key");
+    test_assert(aes_id2 == aes_id, "key duplicated");
+  }
+
+  /* [11.1.4] Deleting the AES key, the identifier must be rejected.*/
+  test_set_step(4);
+  {
+    ret = cryDeleteKey(&CRYD1, aes_id);
+    test_assert(ret == CRY_NOERROR, "failed delete key");
+    ret = cryDeleteKey(&CRYD1, aes_id);
+    test_assert(ret == CRY_ERR_INV_KEY_ID, "key deleted twice");
+    ret = cryEncryptAES(&CRYD1, aes_id, fips197_plain, out);
+    test_assert(ret == CRY_ERR_INV_KEY_ID, "stale identifier accepted");
+  }
+
+  /* [11.1.5] Loading an HMAC key, the RFC 4231 case 1 must be computed
+     using the identifier. The key must be rejected by AES operations
+     and the identifier of the deleted AES key must still be rejected.*/
+  test_set_step(5);
+  {
+    memset(key, 0x0B, 20);
+    ret = cryLoadHMACKey(&CRYD1, 20, key, &hmac_id);
+    test_assert(ret == CRY_NOERROR, "failed load key");
+    ret = cryHMACSHA256InitKey(&CRYD1, hmac_id, &ctx);
+    test_assert(ret == CRY_NOERROR, "failed init HMACSHA256");
+    ret = cryHMACSHA256Update(&CRYD1, &ctx, 8, (const uint8_t *)"Hi There");
+    test_assert(ret == CRY_NOERROR, "failed update HMACSHA256");
+    ret = cryHMACSHA256Final(&CRYD1, &ctx, mac);
+    test_assert(ret == CRY_NOERROR, "failed final HMACSHA256");
+    test_assert(memcmp(mac, rfc4231_hmac1, 32) == 0, "hmac mismatch");
+    ret = cryEncryptAES(&CRYD1, hmac_id, fips197_plain, out);
+    test_assert(ret == CRY_ERR_INV_KEY_TYPE, "key type not checked");
+    ret = cryEncryptAES(&CRYD1, aes_id, fips197_plain, out);
+    test_assert(ret == CRY_ERR_INV_KEY_ID, "stale identifier accepted");
+  }
+
+  /* [11.1.6] Deleting the HMAC key, the identifier must be rejected.*/
+  test_set_step(6);
+  {
+    ret = cryDeleteKey(&CRYD1, hmac_id);
+    test_assert(ret == CRY_NOERROR, "failed delete key");
+    ret = cryHMACSHA256InitKey(&CRYD1, hmac_id, &ctx);
+    test_assert(ret == CRY_ERR_INV_KEY_ID, "stale identifier accepted");
+  }
+}
+
+static const testcase_t cry_test_011_001 = {
+  "Loading and deleting keys",
+  cry_test_011_001_setup,
+  cry_test_011_001_teardown,
+  cry_test_011_001_execute
+};
+
+#if (HAL_CRY_KEY_SLOTS > 1) || defined(__DOXYGEN__)
+/**
+ * @page cry_test_011_002 [11.2] Slots eviction
+ *
+ * <h2>Description</h2>
+ * All the slots are filled while a key is kept in use, loading one more
+ * key must evict the least recently used one. The identifier of the
+ * evicted key must be rejected after its slot has been reused.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_CRY_KEY_SLOTS > 1
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.2.1] Loading the key kept in use.
+ * - [11.2.2] Loading one key more than the free slots, the key in use
+ *   is used before each load.
+ * - [11.2.3] The first loaded key must have been evicted, its
+ *   identifier must be rejected even if the slot now holds another key.
+ * - [11.2.4] The other keys must still be usable and must give the
+ *   expected results.
+ * .
+ */
+
+static void cry_test_011_002_setup(void) {
+  cryStart(&CRYD1, &config_Polling);
+}
+
+static void cry_test_011_002_teardown(void) {
+  cryDeleteAllKeys(&CRYD1);
+  cryStop(&CRYD1);
+}
+
+static void cry_test_011_002_execute(void) {
+  cryerror_t ret;
+  crykey_t used_id, ids[HAL_CRY_KEY_SLOTS];
+  uint8_t key[16];
+  unsigned i;
+
+  /* [11.2.1] Loading the key kept in use.*/
+  test_set_step(1);
+  {
+    ret = cryLoadAESKey(&CRYD1, 16, fips197_key, &used_id);
+    test_assert(ret == CRY_NOERROR, "failed load key");
+  }
+
+  /* [11.2.2] Loading one key more than the free slots, the key in use
+     is used before each load.*/
+  test_set_step(2);
+  {
+    for (i = 0U; i < (unsigned)HAL_CRY_KEY_SLOTS; i++) {
+      memset(key, 0x40 + (int)i, sizeof key);
+      ret = cryEncryptAES(&CRYD1, used_id, fips197_plain, out);
+      test_assert(ret == CRY_NOERROR, "failed encryption");
+      ret = cryLoadAESKey(&CRYD1, sizeof key, key, &ids[i]);
+      test_assert(ret == CRY_NOERROR, "failed load key");
+    }
+  }
+
+  /* [11.2.3] The first loaded key must have been evicted, its
+     identifier must be rejected even if the slot now holds another key.*/
+  test_set_step(3);
+  {
+    ret = cryEncryptAES(&CRYD1, ids[0], fips197_plain, out);
+    test_assert(ret == CRY_ERR_INV_KEY_ID, "stale identifier accepted");
+    ret = cryDeleteKey(&CRYD1, ids[0]);
+    test_assert(ret == CRY_ERR_INV_KEY_ID, "stale identifier deleted");
+  }
+
+  /* [11.2.4] The other keys must still be usable and must give the
+     expected results.*/
+  test_set_step(4);
+  {
+    ret = cryEncryptAES(&CRYD1, used_id, fips197_plain, out);
+    test_assert(ret == CRY_NOERROR, "failed encryption");
+    test_assert(memcmp(out, fips197_aes128, 16) == 0, "encrypt mismatch");
+    for (i = 1U; i < (unsigned)HAL_CRY_KEY_SLOTS; i++) {
+      ret = cryEncryptAES(&CRYD1, ids[i], fips197_plain, out);
+      test_assert(ret == CRY_NOERROR, "key evicted");
+    }
+    memset(key, 0x40 + HAL_CRY_KEY_SLOTS - 1, sizeof key);
+    ret = cryLoadAESTransientKey(&CRYD1, sizeof key, key);
+    test_assert(ret == CRY_NOERROR, "failed load transient key");
+    ret = cryEncryptAES(&CRYD1, 0, fips197_plain, out2);
+    test_assert(ret == CRY_NOERROR, "failed encryption");
+    test_assert(memcmp(out, out2, 16) == 0, "wrong key in slot");
+  }
+}
+
+static const testcase_t cry_test_011_002 = {
+  "Slots eviction",
+  cry_test_011_002_setup,
+  cry_test_011_002_teardown,
+  cry_test_011_002_execute
+};
+#endif /* HAL_CRY_KEY_SLOTS > 1 */
+
+/**
+ * @page cry_test_011_003 [11.3] Deleting all keys
+ *
+ * <h2>Description</h2>
+ * All the keys are deleted, the slot identifiers and the transient key
+ * must be rejected.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.3.1] Loading a slot key and a transient key.
+ * - [11.3.2] Deleting all the keys, both identifiers must be rejected.
+ * .
+ */
+
+static void cry_test_011_003_setup(void) {
+  cryStart(&CRYD1, &config_Polling);
+}
+
+static void cry_test_011_003_teardown(void) {
+  cryStop(&CRYD1);
+}
+
+static void cry_test_011_003_execute(void) {
+  cryerror_t ret;
+  crykey_t id;
+
+  /* [11.3.1] Loading a slot key and a transient key.*/
+  test_set_step(1);
+  {
+    ret = cryLoadAESKey(&CRYD1, 16, fips197_key, &id);
+    test_assert(ret == CRY_NOERROR, "failed load key");
+    ret = cryLoadAESTransientKey(&CRYD1, 16, fips197_key);
+    test_assert(ret == CRY_NOERROR, "failed load transient key");
+  }
+
+  /* [11.3.2] Deleting all the keys, both identifiers must be rejected.*/
+  test_set_step(2);
+  {
+    cryDeleteAllKeys(&CRYD1);
+    ret = cryEncryptAES(&CRYD1, id, fips197_plain, out);
+    test_assert(ret == CRY_ERR_INV_KEY_ID, "stale identifier accepted");
+    ret = cryEncryptAES(&CRYD1, 0, fips197_plain, out);
+    test_assert(ret == CRY_ERR_INV_KEY_ID, "transient key not deleted");
+  }
+}
+
+static const testcase_t cry_test_011_003 = {
+  "Deleting all keys",
+  cry_test_011_003_setup,
+  cry_test_011_003_teardown,
+  cry_test_011_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const cry_test_sequence_011_array[] = {
+  &cry_test_011_001,
+#if (HAL_CRY_KEY_SLOTS > 1) || defined(__DOXYGEN__)
+  &cry_test_011_002,
+#endif
+  &cry_test_011_003,
+  NULL
+};
+
+/**
+ * @brief   Key Slots.
+ */
+const testsequence_t cry_test_sequence_011 = {
+  "Key Slots",
+  cry_test_sequence_011_array
+};
+
+#endif /* HAL_CRY_KEY_SLOTS > 0 */
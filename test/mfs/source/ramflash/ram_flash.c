@@ -0,0 +1,265 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ram_flash.c
+ * @brief   RAM flash model code.
+ *
+ * @addtogroup RAM_FLASH
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "ram_flash.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static const flash_descriptor_t *ram_get_descriptor(void *instance);
+static flash_error_t ram_read(void *instance, flash_offset_t offset,
+                              size_t n, uint8_t *rp);
+static flash_error_t ram_program(void *instance, flash_offset_t offset,
+                                 size_t n, const uint8_t *pp);
+static flash_error_t ram_start_erase_all(void *instance);
+static flash_error_t ram_start_erase_sector(void *instance,
+                                            flash_sector_t sector);
+static flash_error_t ram_query_erase(void *instance, uint32_t *msec);
+static flash_error_t ram_verify_erase(void *instance, flash_sector_t sector);
+
+/**
+ * @brief   Virtual methods table.
+ */
+static const struct RAMFlashVMT ram_flash_vmt = {
+  (size_t)0,
+  ram_get_descriptor, ram_read, ram_program,
+  ram_start_erase_all, ram_start_erase_sector,
+  ram_query_erase, ram_verify_erase
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Consumes the power budget.
+ *
+ * @param[in] rfp       pointer to the @p RAMFlash object
+ * @param[in] n         amount of work required by the operation
+ * @return              The amount of work performed before the power loss,
+ *                      @p n if the operation can complete.
+ */
+static size_t ram_consume(RAMFlash *rfp, size_t n) {
+
+  if (rfp->budget < 0) {
+    return n;
+  }
+
+  if ((size_t)rfp->budget < n) {
+    n = (size_t)rfp->budget;
+    rfp->budget  = 0;
+    rfp->powered = false;
+    return n;
+  }
+
+  rfp->budget -= (int32_t)n;
+  return n;
+}
+
+static const flash_descriptor_t *ram_get_descriptor(void *instance) {
+  RAMFlash *rfp = (RAMFlash *)instance;
+
+  return &rfp->descriptor;
+}
+
+static flash_error_t ram_read(void *instance, flash_offset_t offset,
+                              size_t n, uint8_t *rp) {
+  RAMFlash *rfp = (RAMFlash *)instance;
+
+  if (!rfp->powered) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+  if ((size_t)offset + n > (size_t)rfp->descriptor.sectors_count *
+                           (size_t)rfp->descriptor.sectors_size) {
+    return FLASH_ERROR_READ;
+  }
+
+  memcpy(rp, &rfp->memory[offset], n);
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t ram_program(void *instance, flash_offset_t offset,
+                                 size_t n, const uint8_t *pp) {
+  RAMFlash *rfp = (RAMFlash *)instance;
+  size_t i, done;
+
+  if (!rfp->powered) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+  if ((size_t)offset + n > (size_t)rfp->descriptor.sectors_count *
+                           (size_t)rfp->descriptor.sectors_size) {
+    return FLASH_ERROR_PROGRAM;
+  }
+
+  /* Programming can only clear bits.*/
+  done = ram_consume(rfp, n);
+  for (i = 0U; i < done; i++) {
+    rfp->memory[offset + i] &= pp[i];
+  }
+
+  return done < n ? FLASH_ERROR_PROGRAM : FLASH_NO_ERROR;
+}
+
+static flash_error_t ram_start_erase_all(void *instance) {
+  RAMFlash *rfp = (RAMFlash *)instance;
+  flash_sector_t sector;
+
+  for (sector = 0U; sector < rfp->descriptor.sectors_count; sector++) {
+    flash_error_t err = ram_start_erase_sector(instance, sector);
+    if (err != FLASH_NO_ERROR) {
+      return err;
+    }
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t ram_start_erase_sector(void *instance,
+                                            flash_sector_t sector) {
+  RAMFlash *rfp = (RAMFlash *)instance;
+  size_t size = (size_t)rfp->descriptor.sectors_size;
+  size_t done;
+
+  if (!rfp->powered) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+  if (sector >= rfp->descriptor.sectors_count) {
+    return FLASH_ERROR_ERASE;
+  }
+
+  /* An interrupted erase leaves the sector partially erased from its
+     start.*/
+  done = ram_consume(rfp, size);
+  memset(&rfp->memory[sector * size], 0xFF, done);
+
+  return done < size ? FLASH_ERROR_ERASE : FLASH_NO_ERROR;
+}
+
+static flash_error_t ram_query_erase(void *instance, uint32_t *msec) {
+  RAMFlash *rfp = (RAMFlash *)instance;
+
+  if (msec != NULL) {
+    *msec = 0U;
+  }
+
+  return rfp->powered ? FLASH_NO_ERROR : FLASH_ERROR_HW_FAILURE;
+}
+
+static flash_error_t ram_verify_erase(void *instance, flash_sector_t sector) {
+  RAMFlash *rfp = (RAMFlash *)instance;
+  size_t i, size = (size_t)rfp->descriptor.sectors_size;
+
+  if (!rfp->powered) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+  if (sector >= rfp->descriptor.sectors_count) {
+    return FLASH_ERROR_VERIFY;
+  }
+
+  for (i = 0U; i < size; i++) {
+    if (rfp->memory[(sector * size) + i] != 0xFFU) {
+      return FLASH_ERROR_VERIFY;
+    }
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ * @note    The memory array is not modified.
+ *
+ * @param[out] rfp          pointer to the @p RAMFlash object
+ * @param[in] memory        pointer to the memory array, its size must be
+ *                          @p sectors multiplied by @p sector_size
+ * @param[in] sectors       number of sectors
+ * @param[in] sector_size   size of sectors
+ *
+ * @init
+ */
+void ramflashObjectInit(RAMFlash *rfp, uint8_t *memory,
+                        flash_sector_t sectors, uint32_t sector_size) {
+
+  rfp->vmt                      = &ram_flash_vmt;
+  rfp->state                    = FLASH_READY;
+  rfp->descriptor.attributes    = FLASH_ATTR_ERASED_IS_ONE;
+  rfp->descriptor.page_size     = 1U;
+  rfp->descriptor.sectors_count = sectors;
+  rfp->descriptor.sectors       = NULL;
+  rfp->descriptor.sectors_size  = sector_size;
+  rfp->descriptor.address       = 0U;
+  rfp->memory                   = memory;
+  rfp->budget                   = -1;
+  rfp->powered                  = true;
+}
+
+/**
+ * @brief   Schedules a power loss.
+ * @details The power is lost when the specified number of bytes has been
+ *          programmed or erased, the operation in progress at that point
+ *          is left incomplete and fails.
+ *
+ * @param[in] rfp       pointer to the @p RAMFlash object
+ * @param[in] budget    number of bytes before the power loss, a negative
+ *                      value cancels a scheduled power loss
+ *
+ * @api
+ */
+void ramflashSetPowerLoss(RAMFlash *rfp, int32_t budget) {
+
+  rfp->budget = budget;
+}
+
+/**
+ * @brief   Restores the power after a power loss.
+ * @details A scheduled power loss is also canceled.
+ *
+ * @param[in] rfp       pointer to the @p RAMFlash object
+ *
+ * @api
+ */
+void ramflashPowerOn(RAMFlash *rfp) {
+
+  rfp->budget  = -1;
+  rfp->powered = true;
+}
+
+/** @} */
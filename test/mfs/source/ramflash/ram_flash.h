@@ -0,0 +1,124 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ram_flash.h
+ * @brief   RAM flash model header.
+ * @details A NOR-like flash device emulated in RAM, programming can only
+ *          clear bits and erasing sets a whole sector to 0xFF. A power
+ *          loss can be scheduled after a given amount of work in order to
+ *          leave interrupted program and erase operations in the array.
+ *
+ * @addtogroup RAM_FLASH
+ * @{
+ */
+
+#ifndef RAM_FLASH_H
+#define RAM_FLASH_H
+
+#include "hal_flash.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   @p RAMFlash specific methods.
+ */
+#define _ram_flash_methods_alone
+
+/**
+ * @brief   @p RAMFlash specific methods with inherited ones.
+ */
+#define _ram_flash_methods                                                  \
+  _base_flash_methods                                                       \
+  _ram_flash_methods_alone
+
+/**
+ * @extends BaseFlashVMT
+ *
+ * @brief   @p RAMFlash virtual methods table.
+ */
+struct RAMFlashVMT {
+  _ram_flash_methods
+};
+
+/**
+ * @extends BaseFlash
+ *
+ * @brief   Type of a RAM flash object.
+ */
+typedef struct {
+  /**
+   * @brief   RAMFlashVMT Virtual Methods Table.
+   */
+  const struct RAMFlashVMT  *vmt;
+  _base_flash_data
+  /**
+   * @brief   Device descriptor.
+   */
+  flash_descriptor_t        descriptor;
+  /**
+   * @brief   Memory array.
+   */
+  uint8_t                   *memory;
+  /**
+   * @brief   Bytes still allowed before the power loss.
+   * @note    Negative if a power loss is not scheduled.
+   */
+  int32_t                   budget;
+  /**
+   * @brief   Device powered.
+   * @note    After a power loss all operations fail until
+   *          @p ramflashPowerOn() is invoked.
+   */
+  bool                      powered;
+} RAMFlash;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void ramflashObjectInit(RAMFlash *rfp, uint8_t *memory,
+                          flash_sector_t sectors, uint32_t sector_size);
+  void ramflashSetPowerLoss(RAMFlash *rfp, int32_t budget);
+  void ramflashPowerOn(RAMFlash *rfp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAM_FLASH_H */
+
+/** @} */
@@ -23,6 +23,7 @@
  * <h2>Test Sequences</h2>
  * - @subpage mfs_test_sequence_001
  * - @subpage mfs_test_sequence_002
+ * - @subpage mfs_test_sequence_003
  * .
  */
 
@@ -46,6 +47,9 @@
 const testsequence_t * const mfs_test_suite_array[] = {
   &mfs_test_sequence_001,
   &mfs_test_sequence_002,
+#if (MFS_CFG_MAX_BANKS > 2) || defined(__DOXYGEN__)
+  &mfs_test_sequence_003,
+#endif
   NULL
 };
 
@@ -78,7 +82,7 @@ flash_error_t bank_erase(mfs_bank_t bank) {
     n      = mfscfg1.bank0_sectors;
   }
   else {
-    sector = mfscfg1.bank1_start;
+    sector = mfscfg1.bank1_start + (bank - 1U) * mfscfg1.bank1_sectors;
     n      = mfscfg1.bank1_sectors;
   }
 
@@ -104,7 +108,7 @@ flash_error_t bank_verify_erased(mfs_bank_t bank) {
     n      = mfscfg1.bank0_sectors;
   }
   else {
-    sector = mfscfg1.bank1_start;
+    sector = mfscfg1.bank1_start + (bank - 1U) * mfscfg1.bank1_sectors;
     n      = mfscfg1.bank1_sectors;
   }
 
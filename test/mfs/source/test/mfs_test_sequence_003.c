@@ -0,0 +1,442 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "mfs_test_root.h"
+
+/**
+ * @file    mfs_test_sequence_003.c
+ * @brief   Test Sequence 003 code.
+ *
+ * @page mfs_test_sequence_003 [3] Multiple banks tests
+ *
+ * File: @ref mfs_test_sequence_003.c
+ *
+ * <h2>Description</h2>
+ * The driver is tested on a partition of three banks, rotation through
+ * the spare banks, reclaim of the oldest bank and recovery from a
+ * reclaim interrupted by a power loss are tested. The partition is
+ * allocated on a RAM flash model.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_MAX_BANKS > 2
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage mfs_test_003_001
+ * - @subpage mfs_test_003_002
+ * - @subpage mfs_test_003_003
+ * .
+ */
+
+#if (MFS_CFG_MAX_BANKS > 2) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+#include "hal_mfs.h"
+#include "ram_flash.h"
+
+#define MB_BANKS            3U
+#define MB_SECTOR_SIZE      512U
+#define MB_RECORD_SIZE      64U
+
+static uint8_t mb_memory[MB_BANKS * MB_SECTOR_SIZE];
+static uint8_t mb_snapshot[MB_BANKS * MB_SECTOR_SIZE];
+static RAMFlash mb_flash;
+static MFSDriver mb_mfs;
+
+static const MFSConfig mb_config = {
+  .flashp           = (BaseFlash *)&mb_flash,
+  .erased           = 0xFFFFFFFFU,
+  .bank_size        = MB_SECTOR_SIZE,
+  .bank0_start      = 0U,
+  .bank0_sectors    = 1U,
+  .bank1_start      = 1U,
+  .bank1_sectors    = 1U,
+  .bank_count       = MB_BANKS
+};
+
+static void mb_pattern(mfs_id_t id, unsigned gen, uint8_t *p) {
+  unsigned i;
+
+  for (i = 0U; i < MB_RECORD_SIZE; i++) {
+    p[i] = (uint8_t)((id * 64U) + (gen * 7U) + i);
+  }
+}
+
+static mfs_error_t mb_write(mfs_id_t id, unsigned gen) {
+  uint8_t buf[MB_RECORD_SIZE];
+
+  mb_pattern(id, gen, buf);
+  return mfsWriteRecord(&mb_mfs, id, sizeof buf, buf);
+}
+
+static bool mb_check(mfs_id_t id, unsigned gen) {
+  uint8_t buf[MB_RECORD_SIZE];
+  size_t size = sizeof mfs_buffer;
+
+  if ((mfsReadRecord(&mb_mfs, id, &size, mfs_buffer) != MFS_NO_ERROR) ||
+      (size != MB_RECORD_SIZE)) {
+    return false;
+  }
+  mb_pattern(id, gen, buf);
+  return memcmp(buf, mfs_buffer, MB_RECORD_SIZE) == 0;
+}
+
+static bool mb_bank_erased(flash_sector_t sector) {
+
+  return flashVerifyErase(mb_config.flashp, sector) == FLASH_NO_ERROR;
+}
+
+/*
+ * Each bank holds six records, banks 0 and 1 are filled leaving records
+ * 1, 2 and 4 live in bank 0 and record 3 live in bank 1, bank 2 is the
+ * only erased bank. The next write reclaims bank 0.
+ */
+static bool mb_fill_for_reclaim(void) {
+  static const struct {
+    mfs_id_t id;
+    unsigned gen;
+  } writes[] = {
+    {1U, 0U}, {2U, 0U}, {3U, 0U}, {4U, 0U}, {1U, 1U}, {2U, 1U},
+    {3U, 1U}, {3U, 2U}, {3U, 3U}, {3U, 4U}, {3U, 5U}, {3U, 6U}
+  };
+  unsigned i;
+
+  for (i = 0U; i < sizeof writes / sizeof writes[0]; i++) {
+    if (mb_write(writes[i].id, writes[i].gen) != MFS_NO_ERROR) {
+      return false;
+    }
+  }
+
+  return (mb_mfs.current_bank == 1U) && mb_bank_erased(2U);
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page mfs_test_003_001 [3.1] Banks rotation
+ *
+ * <h2>Description</h2>
+ * Records are written until all banks have been used, spare banks are
+ * put in use without relocating records, a bank only holding obsolete
+ * records is erased without relocations.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.1.1] The partition is mounted on an erased flash, bank 0 is
+ *   expected to be in use.
+ * - [3.1.2] Bank 0 is filled, the next write puts bank 1 in use without
+ *   a garbage collection, bank 2 is expected to be still erased.
+ * - [3.1.3] Bank 1 is filled with records superseding all the ones in
+ *   bank 0, the next write erases bank 0 without relocations and puts
+ *   bank 2 in use, MFS_WARN_GC is expected.
+ * - [3.1.4] The partition is mounted again, the records are read back
+ *   and compared.
+ * .
+ */
+
+static void mfs_test_003_001_setup(void) {
+  memset(mb_memory, 0xFF, sizeof mb_memory);
+  ramflashObjectInit(&mb_flash, mb_memory, MB_BANKS, MB_SECTOR_SIZE);
+  mfsObjectInit(&mb_mfs);
+}
+
+static void mfs_test_003_001_teardown(void) {
+  mfsStop(&mb_mfs);
+}
+
+static void mfs_test_003_001_execute(void) {
+  /* [3.1.1] The partition is mounted on an erased flash, bank 0 is
+     expected to be in use.*/
+  test_set_step(1);
+  {
+    mfs_error_t err;
+
+    err = mfsStart(&mb_mfs, &mb_config);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+    test_assert(mb_mfs.current_bank == 0U, "unexpected current bank");
+  }
+
+  /* [3.1.2] Bank 0 is filled, the next write puts bank 1 in use without
+     a garbage collection, bank 2 is expected to be still erased.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+
+    test_assert(mb_write(1U, 0U) == MFS_NO_ERROR, "error writing record");
+    test_assert(mb_write(2U, 0U) == MFS_NO_ERROR, "error writing record");
+    test_assert(mb_write(3U, 0U) == MFS_NO_ERROR, "error writing record");
+    test_assert(mb_write(4U, 0U) == MFS_NO_ERROR, "error writing record");
+    test_assert(mb_write(1U, 1U) == MFS_NO_ERROR, "error writing record");
+    test_assert(mb_write(2U, 1U) == MFS_NO_ERROR, "error writing record");
+    test_assert(mb_mfs.current_bank == 0U, "unexpected current bank");
+
+    err = mb_write(3U, 1U);
+    test_assert(err == MFS_NO_ERROR, "unexpected garbage collection");
+    test_assert(mb_mfs.current_bank == 1U, "bank 1 not in use");
+    test_assert(mb_bank_erased(2U), "bank 2 not erased");
+  }
+
+  /* [3.1.3] Bank 1 is filled with records superseding all the ones in
+     bank 0, the next write erases bank 0 without relocations and puts
+     bank 2 in use, MFS_WARN_GC is expected.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+
+    test_assert(mb_write(4U, 1U) == MFS_NO_ERROR, "error writing record");
+    test_assert(mb_write(1U, 2U) == MFS_NO_ERROR, "error writing record");
+    test_assert(mb_write(2U, 2U) == MFS_NO_ERROR, "error writing record");
+    test_assert(mb_write(3U, 2U) == MFS_NO_ERROR, "error writing record");
+    test_assert(mb_write(4U, 2U) == MFS_NO_ERROR, "error writing record");
+    test_assert(mb_mfs.current_bank == 1U, "unexpected current bank");
+
+    err = mb_write(1U, 3U);
+    test_assert(err == MFS_WARN_GC, "garbage collection not reported");
+    test_assert(mb_mfs.current_bank == 2U, "bank 2 not in use");
+    test_assert(mb_bank_erased(0U), "bank 0 not erased");
+  }
+
+  /* [3.1.4] The partition is mounted again, the records are read back
+     and compared.*/
+  test_set_step(4);
+  {
+    mfs_error_t err;
+
+    mfsStop(&mb_mfs);
+    err = mfsStart(&mb_mfs, &mb_config);
+    test_assert(err == MFS_NO_ERROR, "re-mount failed");
+    test_assert(mb_mfs.current_bank == 2U, "unexpected current bank");
+    test_assert(mb_check(1U, 3U), "record 1 content mismatch");
+    test_assert(mb_check(2U, 2U), "record 2 content mismatch");
+    test_assert(mb_check(3U, 2U), "record 3 content mismatch");
+    test_assert(mb_check(4U, 2U), "record 4 content mismatch");
+  }
+}
+
+static const testcase_t mfs_test_003_001 = {
+  "Banks rotation",
+  mfs_test_003_001_setup,
+  mfs_test_003_001_teardown,
+  mfs_test_003_001_execute
+};
+
+/**
+ * @page mfs_test_003_002 [3.2] Reclaim of the oldest bank
+ *
+ * <h2>Description</h2>
+ * All banks are used and the oldest bank still holds live records, a
+ * write relocates those records into the erased bank and erases the
+ * oldest bank.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.2.1] The partition is mounted and filled, bank 2 is the only
+ *   erased bank and bank 0 holds live records.
+ * - [3.2.2] A record is written, the live records of bank 0 are
+ *   relocated into bank 2 and bank 0 is erased, MFS_WARN_GC is
+ *   expected.
+ * - [3.2.3] The partition is mounted again, the records are read back
+ *   and compared.
+ * .
+ */
+
+static void mfs_test_003_002_setup(void) {
+  memset(mb_memory, 0xFF, sizeof mb_memory);
+  ramflashObjectInit(&mb_flash, mb_memory, MB_BANKS, MB_SECTOR_SIZE);
+  mfsObjectInit(&mb_mfs);
+}
+
+static void mfs_test_003_002_teardown(void) {
+  mfsStop(&mb_mfs);
+}
+
+static void mfs_test_003_002_execute(void) {
+  /* [3.2.1] The partition is mounted and filled, bank 2 is the only
+     erased bank and bank 0 holds live records.*/
+  test_set_step(1);
+  {
+    mfs_error_t err;
+
+    err = mfsStart(&mb_mfs, &mb_config);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+    test_assert(mb_fill_for_reclaim(), "error filling the partition");
+  }
+
+  /* [3.2.2] A record is written, the live records of bank 0 are
+     relocated into bank 2 and bank 0 is erased, MFS_WARN_GC is
+     expected.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+
+    err = mb_write(3U, 7U);
+    test_assert(err == MFS_WARN_GC, "garbage collection not reported");
+    test_assert(mb_mfs.current_bank == 2U, "bank 2 not in use");
+    test_assert(mb_bank_erased(0U), "bank 0 not erased");
+    test_assert(mb_check(1U, 1U), "record 1 content mismatch");
+    test_assert(mb_check(2U, 1U), "record 2 content mismatch");
+    test_assert(mb_check(3U, 7U), "record 3 content mismatch");
+    test_assert(mb_check(4U, 0U), "record 4 content mismatch");
+  }
+
+  /* [3.2.3] The partition is mounted again, the records are read back
+     and compared.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+
+    mfsStop(&mb_mfs);
+    err = mfsStart(&mb_mfs, &mb_config);
+    test_assert(err == MFS_NO_ERROR, "re-mount failed");
+    test_assert(mb_mfs.current_bank == 2U, "unexpected current bank");
+    test_assert(mb_bank_erased(0U), "bank 0 not erased");
+    test_assert(mb_check(1U, 1U), "record 1 content mismatch");
+    test_assert(mb_check(2U, 1U), "record 2 content mismatch");
+    test_assert(mb_check(3U, 7U), "record 3 content mismatch");
+    test_assert(mb_check(4U, 0U), "record 4 content mismatch");
+  }
+}
+
+static const testcase_t mfs_test_003_002 = {
+  "Reclaim of the oldest bank",
+  mfs_test_003_002_setup,
+  mfs_test_003_002_teardown,
+  mfs_test_003_002_execute
+};
+
+/**
+ * @page mfs_test_003_003 [3.3] Interrupted reclaim
+ *
+ * <h2>Description</h2>
+ * The write triggering the reclaim of the oldest bank is interrupted by
+ * a power loss after each possible amount of programmed or erased
+ * bytes, the partition is mounted again after each interruption.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.3.1] The partition is mounted and filled, bank 2 is the only
+ *   erased bank and bank 0 holds live records, the flash content is
+ *   saved.
+ * - [3.3.2] For each cut point the saved flash content is restored and
+ *   the write is interrupted, after the power is restored the partition
+ *   is mounted, records are expected to hold the previous or the new
+ *   value and the storage is expected to be writable. The loop ends
+ *   when the write completes without interruptions.
+ * .
+ */
+
+static void mfs_test_003_003_setup(void) {
+  memset(mb_memory, 0xFF, sizeof mb_memory);
+  ramflashObjectInit(&mb_flash, mb_memory, MB_BANKS, MB_SECTOR_SIZE);
+  mfsObjectInit(&mb_mfs);
+}
+
+static void mfs_test_003_003_teardown(void) {
+  mfsStop(&mb_mfs);
+}
+
+static void mfs_test_003_003_execute(void) {
+  /* [3.3.1] The partition is mounted and filled, bank 2 is the only
+     erased bank and bank 0 holds live records, the flash content is
+     saved.*/
+  test_set_step(1);
+  {
+    mfs_error_t err;
+
+    err = mfsStart(&mb_mfs, &mb_config);
+    test_assert(err == MFS_NO_ERROR, "initialization error");
+    test_assert(mb_fill_for_reclaim(), "error filling the partition");
+    memcpy(mb_snapshot, mb_memory, sizeof mb_memory);
+  }
+
+  /* [3.3.2] For each cut point the saved flash content is restored and
+     the write is interrupted, after the power is restored the partition
+     is mounted, records are expected to hold the previous or the new
+     value and the storage is expected to be writable. The loop ends
+     when the write completes without interruptions.*/
+  test_set_step(2);
+  {
+    int32_t cut = 0;
+    mfs_error_t err, werr;
+
+    do {
+      memcpy(mb_memory, mb_snapshot, sizeof mb_memory);
+      mfsStop(&mb_mfs);
+      err = mfsStart(&mb_mfs, &mb_config);
+      test_assert(err == MFS_NO_ERROR, "mount failed");
+
+      ramflashSetPowerLoss(&mb_flash, cut);
+      werr = mb_write(3U, 7U);
+      ramflashPowerOn(&mb_flash);
+
+      mfsStop(&mb_mfs);
+      err = mfsStart(&mb_mfs, &mb_config);
+      test_assert((err == MFS_NO_ERROR) || (err == MFS_WARN_REPAIR),
+                  "re-mount failed");
+      test_assert(mb_check(1U, 1U), "record 1 content mismatch");
+      test_assert(mb_check(2U, 1U), "record 2 content mismatch");
+      test_assert(mb_check(3U, 6U) || mb_check(3U, 7U),
+                  "record 3 content mismatch");
+      test_assert(mb_check(4U, 0U), "record 4 content mismatch");
+
+      err = mb_write(4U, 8U);
+      test_assert(!MFS_IS_ERROR(err), "error writing record");
+      test_assert(mb_check(4U, 8U), "record 4 content mismatch");
+      cut++;
+    } while (MFS_IS_ERROR(werr));
+
+    test_assert(mb_check(3U, 7U), "record 3 not updated");
+
+    test_assert(cut > (int32_t)MB_SECTOR_SIZE, "reclaim not interrupted");
+  }
+}
+
+static const testcase_t mfs_test_003_003 = {
+  "Interrupted reclaim",
+  mfs_test_003_003_setup,
+  mfs_test_003_003_teardown,
+  mfs_test_003_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const mfs_test_sequence_003_array[] = {
+  &mfs_test_003_001,
+  &mfs_test_003_002,
+  &mfs_test_003_003,
+  NULL
+};
+
+/**
+ * @brief   Multiple banks tests.
+ */
+const testsequence_t mfs_test_sequence_003 = {
+  "Multiple banks tests",
+  mfs_test_sequence_003_array
+};
+
+#endif /* MFS_CFG_MAX_BANKS > 2 */
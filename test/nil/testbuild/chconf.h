@@ -167,6 +167,25 @@
  */
 #define CH_CFG_USE_PIPES                    TRUE
 
+/**
+ * @brief   Active Objects APIs.
+ * @details If enabled then the active objects APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MEMPOOLS.
+ */
+#define CH_CFG_USE_ACTIVE_OBJECTS           TRUE
+
+/**
+ * @brief   Remote Mailboxes APIs.
+ * @details If enabled then the remote mailboxes APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#define CH_CFG_USE_REMOTE_MAILBOXES         TRUE
+
 /**
  * @brief   Managed RAM size.
  * @details Size of the RAM area to be managed by the OS. If set to zero
@@ -26,6 +26,12 @@
  * - @subpage oslib_test_sequence_003
  * - @subpage oslib_test_sequence_004
  * - @subpage oslib_test_sequence_005
+ * - @subpage oslib_test_sequence_006
+ * - @subpage oslib_test_sequence_007
+ * - @subpage oslib_test_sequence_008
+ * - @subpage oslib_test_sequence_009
+ * - @subpage oslib_test_sequence_010
+ * - @subpage oslib_test_sequence_011
  * .
  */
 
@@ -61,6 +67,24 @@ const testsequence_t * const oslib_test_suite_array[] = {
 #endif
 #if ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) || defined(__DOXYGEN__)
   &oslib_test_sequence_005,
+#endif
+#if (CH_CFG_USE_ACTIVE_OBJECTS) || defined(__DOXYGEN__)
+  &oslib_test_sequence_006,
+#endif
+#if (CH_CFG_USE_REMOTE_MAILBOXES) || defined(__DOXYGEN__)
+  &oslib_test_sequence_007,
+#endif
+#if ((CH_CFG_USE_BASIC_TASKS == TRUE) && (CH_CFG_USE_WAITEXIT == TRUE)) || defined(__DOXYGEN__)
+  &oslib_test_sequence_008,
+#endif
+#if (CH_CFG_USE_SCHEDULE_TABLES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_sequence_009,
+#endif
+#if ((CH_CFG_USE_RCU == TRUE) && (CH_CFG_USE_WAITEXIT == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE)) || defined(__DOXYGEN__)
+  &oslib_test_sequence_010,
+#endif
+#if ((defined(SYSCALLS_USE_HEAP) && (SYSCALLS_USE_HEAP == TRUE)) || (defined(SYSCALLS_USE_STREAMS) && (SYSCALLS_USE_STREAMS == TRUE))) || defined(__DOXYGEN__)
+  &oslib_test_sequence_011,
 #endif
   NULL
 };
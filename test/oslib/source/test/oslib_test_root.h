@@ -29,6 +29,12 @@
 #include "oslib_test_sequence_003.h"
 #include "oslib_test_sequence_004.h"
 #include "oslib_test_sequence_005.h"
+#include "oslib_test_sequence_006.h"
+#include "oslib_test_sequence_007.h"
+#include "oslib_test_sequence_008.h"
+#include "oslib_test_sequence_009.h"
+#include "oslib_test_sequence_010.h"
+#include "oslib_test_sequence_011.h"
 
 #if !defined(__DOXYGEN__)
 
@@ -0,0 +1,607 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_006.c
+ * @brief   Test Sequence 006 code.
+ *
+ * @page oslib_test_sequence_006 [6] Active Objects
+ *
+ * File: @ref oslib_test_sequence_006.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to
+ * active objects.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_ACTIVE_OBJECTS
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_006_001
+ * - @subpage oslib_test_006_002
+ * - @subpage oslib_test_006_003
+ * - @subpage oslib_test_006_004
+ * .
+ */
+
+#if (CH_CFG_USE_ACTIVE_OBJECTS) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define AO_QUEUE_SIZE       4
+
+#define SIG_A               (AO_SIG_USER + 0U)
+#define SIG_B               (AO_SIG_USER + 1U)
+#define SIG_C               (AO_SIG_USER + 2U)
+#define SIG_D               (AO_SIG_USER + 3U)
+#define SIG_TOKEN           (AO_SIG_USER + 4U)
+#define SIG_TICK            (AO_SIG_USER + 5U)
+
+typedef struct {
+  ao_event_t            ev;
+  char                  token;
+} token_event_t;
+
+static ao_scheduler_t sched1;
+static active_object_t ao1, ao2, ao3;
+static ao_event_t *ao1_buf[AO_QUEUE_SIZE];
+static ao_event_t *ao2_buf[AO_QUEUE_SIZE];
+static ao_event_t *ao3_buf[AO_QUEUE_SIZE];
+static ao_event_t ev_a, ev_b, ev_c, ev_d;
+static token_event_t tev[4];
+static token_event_t pool_events[2];
+static memory_pool_t mp1;
+
+static ao_result_t s1_handler(active_object_t *aop, const ao_event_t *ep);
+static ao_result_t s11_handler(active_object_t *aop, const ao_event_t *ep);
+static ao_result_t s2_handler(active_object_t *aop, const ao_event_t *ep);
+static ao_result_t s21_handler(active_object_t *aop, const ao_event_t *ep);
+static ao_result_t token_handler(active_object_t *aop, const ao_event_t *ep);
+
+static AO_STATE_DECL(s1, NULL, s1_handler);
+static AO_STATE_DECL(s11, &s1, s11_handler);
+static AO_STATE_DECL(s2, NULL, s2_handler);
+static AO_STATE_DECL(s21, &s2, s21_handler);
+static AO_STATE_DECL(tokens, NULL, token_handler);
+
+static ao_result_t s1_handler(active_object_t *aop, const ao_event_t *ep) {
+
+  switch (ep->sig) {
+  case AO_SIG_ENTRY:
+    test_emit_token('A');
+    return AO_HANDLED;
+  case AO_SIG_EXIT:
+    test_emit_token('a');
+    return AO_HANDLED;
+  case AO_SIG_INIT:
+    return chAOTransition(aop, &s11);
+  case SIG_A:
+    return chAOTransition(aop, &s2);
+  default:
+    return AO_UNHANDLED;
+  }
+}
+
+static ao_result_t s11_handler(active_object_t *aop, const ao_event_t *ep) {
+
+  switch (ep->sig) {
+  case AO_SIG_ENTRY:
+    test_emit_token('B');
+    return AO_HANDLED;
+  case AO_SIG_EXIT:
+    test_emit_token('b');
+    return AO_HANDLED;
+  case SIG_B:
+    return chAOTransition(aop, &s11);
+  default:
+    return AO_UNHANDLED;
+  }
+}
+
+static ao_result_t s2_handler(active_object_t *aop, const ao_event_t *ep) {
+
+  switch (ep->sig) {
+  case AO_SIG_ENTRY:
+    test_emit_token('C');
+    return AO_HANDLED;
+  case AO_SIG_EXIT:
+    test_emit_token('c');
+    return AO_HANDLED;
+  case AO_SIG_INIT:
+    return chAOTransition(aop, &s21);
+  case SIG_A:
+    return chAOTransition(aop, &s11);
+  case SIG_B:
+    return chAOTransition(aop, &s2);
+  default:
+    return AO_UNHANDLED;
+  }
+}
+
+static ao_result_t s21_handler(active_object_t *aop, const ao_event_t *ep) {
+
+  switch (ep->sig) {
+  case AO_SIG_ENTRY:
+    test_emit_token('D');
+    return AO_HANDLED;
+  case AO_SIG_EXIT:
+    test_emit_token('d');
+    return AO_HANDLED;
+  case SIG_C:
+    return chAOTransition(aop, &s2);
+  default:
+    return AO_UNHANDLED;
+  }
+}
+
+static ao_result_t token_handler(active_object_t *aop, const ao_event_t *ep) {
+
+  (void)aop;
+
+  switch (ep->sig) {
+  case SIG_TOKEN:
+    test_emit_token(((const token_event_t *)ep)->token);
+    return AO_HANDLED;
+  case SIG_TICK:
+    test_emit_token('T');
+    return AO_HANDLED;
+  default:
+    return AO_UNHANDLED;
+  }
+}
+
+static void dispatch_all(void) {
+
+  while (chAOSchedulerDispatchTimeout(&sched1, TIME_IMMEDIATE) == MSG_OK) {
+  }
+}
+
+static void tokens_init(void) {
+  unsigned i;
+
+  for (i = 0U; i < 4U; i++) {
+    chAOEventObjectInit(&tev[i].ev, SIG_TOKEN);
+    tev[i].token = (char)('A' + i);
+  }
+}
+
+#if defined(_CHIBIOS_RT_) || defined(__DOXYGEN__)
+static ao_time_event_t tmev;
+#endif
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_006_001 [6.1] Hierarchical state machine
+ *
+ * <h2>Description</h2>
+ * An active object implementing a two levels state machine is started
+ * and events are posted to it, the entry and exit actions are verified
+ * for initial, self, cross and local transitions and for unhandled
+ * events.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.1.1] Starting the active object, the initial transitions must be
+ *   followed down to the leaf state.
+ * - [6.1.2] Posting an event causing a self transition in the leaf
+ *   state.
+ * - [6.1.3] Posting an event handled by the parent state, the state
+ *   machine must move in the other branch.
+ * - [6.1.4] Posting an event causing a transition to the parent state,
+ *   the parent state must not be exited.
+ * - [6.1.5] Posting an event causing a self transition in the parent
+ *   state.
+ * - [6.1.6] Posting an event not handled by any state, it must be
+ *   discarded.
+ * - [6.1.7] Posting an event causing a transition to a leaf state of
+ *   the other branch.
+ * .
+ */
+
+static void oslib_test_006_001_setup(void) {
+  chAOSchedulerObjectInit(&sched1);
+  chAOObjectInit(&ao1, &sched1, (tprio_t)1, &s1, ao1_buf, AO_QUEUE_SIZE);
+  chAOEventObjectInit(&ev_a, SIG_A);
+  chAOEventObjectInit(&ev_b, SIG_B);
+  chAOEventObjectInit(&ev_c, SIG_C);
+  chAOEventObjectInit(&ev_d, SIG_D);
+}
+
+static void oslib_test_006_001_execute(void) {
+
+  /* [6.1.1] Starting the active object, the initial transitions must be
+     followed down to the leaf state.*/
+  test_set_step(1);
+  {
+    chAOStart(&ao1);
+    test_assert_sequence("AB", "invalid initial transitions");
+    test_assert(chAOGetStateX(&ao1) == &s11, "wrong state");
+    test_assert(chAOIsInState(&ao1, &s1), "not in parent state");
+    test_assert(!chAOIsInState(&ao1, &s2), "in wrong state");
+  }
+
+  /* [6.1.2] Posting an event causing a self transition in the leaf
+     state.*/
+  test_set_step(2);
+  {
+    msg_t msg = chAOPost(&ao1, &ev_b);
+    test_assert(msg == MSG_OK, "post failed");
+    dispatch_all();
+    test_assert_sequence("bB", "invalid self transition");
+    test_assert(chAOGetStateX(&ao1) == &s11, "wrong state");
+  }
+
+  /* [6.1.3] Posting an event handled by the parent state, the state
+     machine must move in the other branch.*/
+  test_set_step(3);
+  {
+    (void) chAOPost(&ao1, &ev_a);
+    dispatch_all();
+    test_assert_sequence("baCD", "invalid cross transition");
+    test_assert(chAOGetStateX(&ao1) == &s21, "wrong state");
+  }
+
+  /* [6.1.4] Posting an event causing a transition to the parent state,
+     the parent state must not be exited.*/
+  test_set_step(4);
+  {
+    (void) chAOPost(&ao1, &ev_c);
+    dispatch_all();
+    test_assert_sequence("dD", "invalid transition to parent");
+    test_assert(chAOGetStateX(&ao1) == &s21, "wrong state");
+  }
+
+  /* [6.1.5] Posting an event causing a self transition in the parent
+     state.*/
+  test_set_step(5);
+  {
+    (void) chAOPost(&ao1, &ev_b);
+    dispatch_all();
+    test_assert_sequence("dcCD", "invalid self transition");
+    test_assert(chAOGetStateX(&ao1) == &s21, "wrong state");
+  }
+
+  /* [6.1.6] Posting an event not handled by any state, it must be
+     discarded.*/
+  test_set_step(6);
+  {
+    (void) chAOPost(&ao1, &ev_d);
+    dispatch_all();
+    test_assert_sequence("", "unexpected actions");
+    test_assert(chAOGetStateX(&ao1) == &s21, "wrong state");
+  }
+
+  /* [6.1.7] Posting an event causing a transition to a leaf state of
+     the other branch.*/
+  test_set_step(7);
+  {
+    (void) chAOPost(&ao1, &ev_a);
+    dispatch_all();
+    test_assert_sequence("dcAB", "invalid transition");
+    test_assert(chAOGetStateX(&ao1) == &s11, "wrong state");
+  }
+}
+
+static const testcase_t oslib_test_006_001 = {
+  "Hierarchical state machine",
+  oslib_test_006_001_setup,
+  NULL,
+  oslib_test_006_001_execute
+};
+
+/**
+ * @page oslib_test_006_002 [6.2] Events pools and references
+ *
+ * <h2>Description</h2>
+ * Events are allocated from a memory pool and posted to multiple active
+ * objects, the events must be returned to the pool only after the last
+ * active object processed them.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.2.1] Allocating all the events from the pool, the allocation
+ *   must fail when the pool is empty.
+ * - [6.2.2] Posting the first event to both active objects, the event
+ *   must be returned to the pool after being processed by both.
+ * - [6.2.3] Releasing the second event that has never been posted, it
+ *   must be returned to the pool.
+ * - [6.2.4] Filling the queue of an active object with the same event,
+ *   the post must fail when the queue is full and the event must be
+ *   returned to the pool after the last reference has been released.
+ * .
+ */
+
+static void oslib_test_006_002_setup(void) {
+  chPoolObjectInit(&mp1, sizeof (token_event_t), NULL);
+  chPoolLoadArray(&mp1, pool_events, 2);
+  chAOSchedulerObjectInit(&sched1);
+  chAOObjectInit(&ao1, &sched1, (tprio_t)1, &tokens, ao1_buf, AO_QUEUE_SIZE);
+  chAOObjectInit(&ao2, &sched1, (tprio_t)1, &tokens, ao2_buf, AO_QUEUE_SIZE);
+  chAOStart(&ao1);
+  chAOStart(&ao2);
+}
+
+static void oslib_test_006_002_execute(void) {
+  token_event_t *e1, *e2;
+
+  /* [6.2.1] Allocating all the events from the pool, the allocation
+     must fail when the pool is empty.*/
+  test_set_step(1);
+  {
+    e1 = (token_event_t *)chAOEventAlloc(&mp1, SIG_TOKEN);
+    e2 = (token_event_t *)chAOEventAlloc(&mp1, SIG_TOKEN);
+    test_assert((e1 != NULL) && (e2 != NULL), "allocation failed");
+    test_assert(chAOEventAlloc(&mp1, SIG_TOKEN) == NULL, "pool not empty");
+    e1->token = 'A';
+    e2->token = 'B';
+  }
+
+  /* [6.2.2] Posting the first event to both active objects, the event
+     must be returned to the pool after being processed by both.*/
+  test_set_step(2);
+  {
+    (void) chAOPost(&ao1, &e1->ev);
+    (void) chAOPost(&ao2, &e1->ev);
+    test_assert(e1->ev.refs == (ucnt_t)2, "wrong references");
+    (void) chAOSchedulerDispatchTimeout(&sched1, TIME_IMMEDIATE);
+    test_assert(e1->ev.refs == (ucnt_t)1, "wrong references");
+    test_assert(mp1.next == NULL, "returned to the pool");
+    dispatch_all();
+    test_assert_sequence("AA", "wrong events");
+    test_assert(e1->ev.refs == (ucnt_t)0, "wrong references");
+    test_assert(mp1.next == (struct pool_header *)e1, "not returned to the pool");
+  }
+
+  /* [6.2.3] Releasing the second event that has never been posted, it
+     must be returned to the pool.*/
+  test_set_step(3);
+  {
+    chAOEventRelease(&e2->ev);
+    test_assert(mp1.next == (struct pool_header *)e2, "not returned to the pool");
+  }
+
+  /* [6.2.4] Filling the queue of an active object with the same event,
+     the post must fail when the queue is full and the event must be
+     returned to the pool after the last reference has been released.*/
+  test_set_step(4);
+  {
+    unsigned i;
+
+    e1 = (token_event_t *)chAOEventAlloc(&mp1, SIG_TOKEN);
+    e1->token = 'C';
+    for (i = 0U; i < AO_QUEUE_SIZE; i++) {
+      test_assert(chAOPost(&ao1, &e1->ev) == MSG_OK, "post failed");
+    }
+    test_assert(chAOPost(&ao1, &e1->ev) == MSG_TIMEOUT, "post not failed");
+    test_assert(e1->ev.refs == (ucnt_t)AO_QUEUE_SIZE, "wrong references");
+    dispatch_all();
+    test_assert_sequence("CCCC", "wrong events");
+    test_assert(mp1.next == (struct pool_header *)e1, "not returned to the pool");
+  }
+}
+
+static const testcase_t oslib_test_006_002 = {
+  "Events pools and references",
+  oslib_test_006_002_setup,
+  NULL,
+  oslib_test_006_002_execute
+};
+
+/**
+ * @page oslib_test_006_003 [6.3] Scheduling and priorities
+ *
+ * <h2>Description</h2>
+ * Events are posted to active objects with different priorities, the
+ * order of execution and the posting ahead of the queued events are
+ * verified.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.3.1] Posting an event to each active object, the higher priority
+ *   active objects must be served first.
+ * - [6.3.2] Posting two events to each active object with the same
+ *   priority, they must be served round-robin one event at time.
+ * - [6.3.3] Posting an event ahead of a queued event, it must be served
+ *   first.
+ * - [6.3.4] Stopping the scheduler, the events must no more be
+ *   dispatched.
+ * .
+ */
+
+static void oslib_test_006_003_setup(void) {
+  tokens_init();
+  chAOSchedulerObjectInit(&sched1);
+  chAOObjectInit(&ao1, &sched1, (tprio_t)1, &tokens, ao1_buf, AO_QUEUE_SIZE);
+  chAOObjectInit(&ao2, &sched1, (tprio_t)2, &tokens, ao2_buf, AO_QUEUE_SIZE);
+  chAOObjectInit(&ao3, &sched1, (tprio_t)2, &tokens, ao3_buf, AO_QUEUE_SIZE);
+  chAOStart(&ao1);
+  chAOStart(&ao2);
+  chAOStart(&ao3);
+}
+
+static void oslib_test_006_003_execute(void) {
+
+  /* [6.3.1] Posting an event to each active object, the higher priority
+     active objects must be served first.*/
+  test_set_step(1);
+  {
+    (void) chAOPost(&ao1, &tev[2].ev);
+    (void) chAOPost(&ao2, &tev[0].ev);
+    (void) chAOPost(&ao3, &tev[1].ev);
+    dispatch_all();
+    test_assert_sequence("ABC", "invalid sequence");
+  }
+
+  /* [6.3.2] Posting two events to each active object with the same
+     priority, they must be served round-robin one event at time.*/
+  test_set_step(2);
+  {
+    (void) chAOPost(&ao2, &tev[0].ev);
+    (void) chAOPost(&ao2, &tev[2].ev);
+    (void) chAOPost(&ao3, &tev[1].ev);
+    (void) chAOPost(&ao3, &tev[3].ev);
+    dispatch_all();
+    test_assert_sequence("ABCD", "invalid sequence");
+  }
+
+  /* [6.3.3] Posting an event ahead of a queued event, it must be served
+     first.*/
+  test_set_step(3);
+  {
+    (void) chAOPost(&ao1, &tev[1].ev);
+    (void) chAOPostAhead(&ao1, &tev[0].ev);
+    dispatch_all();
+    test_assert_sequence("AB", "invalid sequence");
+  }
+
+  /* [6.3.4] Stopping the scheduler, the events must no more be
+     dispatched.*/
+  test_set_step(4);
+  {
+    msg_t msg;
+
+    (void) chAOPost(&ao1, &tev[0].ev);
+    chAOSchedulerStop(&sched1);
+    msg = chAOSchedulerDispatchTimeout(&sched1, TIME_IMMEDIATE);
+    test_assert(msg == MSG_RESET, "not stopped");
+    test_assert_sequence("", "unexpected events");
+  }
+}
+
+static const testcase_t oslib_test_006_003 = {
+  "Scheduling and priorities",
+  oslib_test_006_003_setup,
+  NULL,
+  oslib_test_006_003_execute
+};
+
+#if (defined(_CHIBIOS_RT_)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_006_004 [6.4] Time events
+ *
+ * <h2>Description</h2>
+ * One-shot and periodic time events are posted to an active object, the
+ * scheduler waits for them.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - defined(_CHIBIOS_RT_)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [6.4.1] No time events armed, the scheduler must timeout.
+ * - [6.4.2] Arming a one-shot time event, the event must be dispatched
+ *   once.
+ * - [6.4.3] Arming a periodic time event, the event must be dispatched
+ *   repeatedly until the time event is disarmed.
+ * .
+ */
+
+static void oslib_test_006_004_setup(void) {
+  chAOSchedulerObjectInit(&sched1);
+  chAOObjectInit(&ao1, &sched1, (tprio_t)1, &tokens, ao1_buf, AO_QUEUE_SIZE);
+  chAOStart(&ao1);
+  chAOTimeEventObjectInit(&tmev, &ao1, SIG_TICK);
+}
+
+static void oslib_test_006_004_teardown(void) {
+  chAOTimeEventDisarm(&tmev);
+}
+
+static void oslib_test_006_004_execute(void) {
+  msg_t msg;
+
+  /* [6.4.1] No time events armed, the scheduler must timeout.*/
+  test_set_step(1);
+  {
+    msg = chAOSchedulerDispatchTimeout(&sched1, TIME_MS2I(10));
+    test_assert(msg == MSG_TIMEOUT, "not timed out");
+  }
+
+  /* [6.4.2] Arming a one-shot time event, the event must be dispatched
+     once.*/
+  test_set_step(2);
+  {
+    chAOTimeEventArm(&tmev, TIME_MS2I(10), (sysinterval_t)0);
+    msg = chAOSchedulerDispatchTimeout(&sched1, TIME_MS2I(100));
+    test_assert(msg == MSG_OK, "no event");
+    test_assert_sequence("T", "invalid sequence");
+    msg = chAOSchedulerDispatchTimeout(&sched1, TIME_MS2I(50));
+    test_assert(msg == MSG_TIMEOUT, "not timed out");
+  }
+
+  /* [6.4.3] Arming a periodic time event, the event must be dispatched
+     repeatedly until the time event is disarmed.*/
+  test_set_step(3);
+  {
+    unsigned i;
+
+    chAOTimeEventArm(&tmev, TIME_MS2I(5), TIME_MS2I(5));
+    for (i = 0U; i < 3U; i++) {
+      msg = chAOSchedulerDispatchTimeout(&sched1, TIME_MS2I(100));
+      test_assert(msg == MSG_OK, "no event");
+    }
+    test_assert_sequence("TTT", "invalid sequence");
+    chAOTimeEventDisarm(&tmev);
+    dispatch_all();
+    msg = chAOSchedulerDispatchTimeout(&sched1, TIME_MS2I(20));
+    test_assert(msg == MSG_TIMEOUT, "not timed out");
+  }
+}
+
+static const testcase_t oslib_test_006_004 = {
+  "Time events",
+  oslib_test_006_004_setup,
+  oslib_test_006_004_teardown,
+  oslib_test_006_004_execute
+};
+#endif /* defined(_CHIBIOS_RT_) */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_006_array[] = {
+  &oslib_test_006_001,
+  &oslib_test_006_002,
+  &oslib_test_006_003,
+#if (defined(_CHIBIOS_RT_)) || defined(__DOXYGEN__)
+  &oslib_test_006_004,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Active Objects.
+ */
+const testsequence_t oslib_test_sequence_006 = {
+  "Active Objects",
+  oslib_test_sequence_006_array
+};
+
+#endif /* CH_CFG_USE_ACTIVE_OBJECTS */
@@ -0,0 +1,354 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_007.c
+ * @brief   Test Sequence 007 code.
+ *
+ * @page oslib_test_sequence_007 [7] Remote Mailboxes
+ *
+ * File: @ref oslib_test_sequence_007.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to
+ * remote mailboxes. Both sides run in the same instance, each doorbell
+ * directly interrupts the other side.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_REMOTE_MAILBOXES
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_007_001
+ * - @subpage oslib_test_007_002
+ * - @subpage oslib_test_007_003
+ * .
+ */
+
+#if (CH_CFG_USE_REMOTE_MAILBOXES) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define RMB_SLOTS           4U
+#define RMB_SIZE            16U
+
+static ALIGNED_VAR(CH_CFG_RMB_LINE_SIZE)
+  uint8_t rmb_region[RMB_REGION_SIZE(RMB_SLOTS, RMB_SIZE)];
+static remote_mailbox_t rmba, rmbb;
+
+static void doorbell_a(remote_mailbox_t *rmbp, void *arg) {
+
+  (void)rmbp;
+  (void)arg;
+
+  chRMBDoorbellI(&rmbb);
+}
+
+static void doorbell_b(remote_mailbox_t *rmbp, void *arg) {
+
+  (void)rmbp;
+  (void)arg;
+
+  chRMBDoorbellI(&rmba);
+}
+
+static void rmb_loopback_init(size_t slots) {
+  rmb_descriptor_t d;
+  size_t i;
+
+  for (i = 0U; i < sizeof (rmb_region); i++) {
+    rmb_region[i] = 0U;
+  }
+
+  d.region    = rmb_region;
+  d.slots     = RMB_SLOTS;
+  d.slot_size = RMB_SIZE;
+  d.side      = RMB_SIDE_A;
+  d.doorbell  = doorbell_a;
+  d.arg       = NULL;
+  chRMBObjectInit(&rmba, &d);
+
+  d.slots     = slots;
+  d.side      = RMB_SIDE_B;
+  d.doorbell  = doorbell_b;
+  chRMBObjectInit(&rmbb, &d);
+}
+
+static void rmb_loopback_connect(void) {
+
+  rmb_loopback_init(RMB_SLOTS);
+  (void) chRMBConnectTimeout(&rmba, TIME_INFINITE);
+  (void) chRMBConnectTimeout(&rmbb, TIME_IMMEDIATE);
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_007_001 [7.1] Connection
+ *
+ * <h2>Description</h2>
+ * The two sides are connected, side B must wait for side A to format the
+ * region and must reject a region with a different geometry.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.1.1] Connecting side B before side A formatted the region, the
+ *   operation must time out.
+ * - [7.1.2] Connecting side A then side B, side A must ring the doorbell
+ *   once.
+ * - [7.1.3] Connecting a side B expecting a different geometry, the
+ *   operation must fail.
+ * .
+ */
+
+static void oslib_test_007_001_setup(void) {
+  rmb_loopback_init(RMB_SLOTS);
+}
+
+static void oslib_test_007_001_execute(void) {
+  msg_t msg;
+
+  /* [7.1.1] Connecting side B before side A formatted the region, the
+     operation must time out.*/
+  test_set_step(1);
+  {
+    msg = chRMBConnectTimeout(&rmbb, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "connected");
+  }
+
+  /* [7.1.2] Connecting side A then side B, side A must ring the doorbell
+     once.*/
+  test_set_step(2);
+  {
+    msg = chRMBConnectTimeout(&rmba, TIME_INFINITE);
+    test_assert(msg == MSG_OK, "side A not connected");
+    test_assert(rmba.n_rung == (ucnt_t)1, "wrong doorbells count");
+    test_assert(rmbb.n_doorbells == (ucnt_t)1, "doorbell not received");
+    msg = chRMBConnectTimeout(&rmbb, TIME_IMMEDIATE);
+    test_assert(msg == MSG_OK, "side B not connected");
+  }
+
+  /* [7.1.3] Connecting a side B expecting a different geometry, the
+     operation must fail.*/
+  test_set_step(3);
+  {
+    rmb_loopback_init(RMB_SLOTS / 2U);
+    msg = chRMBConnectTimeout(&rmba, TIME_INFINITE);
+    test_assert(msg == MSG_OK, "side A not connected");
+    msg = chRMBConnectTimeout(&rmbb, TIME_IMMEDIATE);
+    test_assert(msg == MSG_RESET, "geometry not checked");
+  }
+}
+
+static const testcase_t oslib_test_007_001 = {
+  "Connection",
+  oslib_test_007_001_setup,
+  NULL,
+  oslib_test_007_001_execute
+};
+
+/**
+ * @page oslib_test_007_002 [7.2] Messages exchange
+ *
+ * <h2>Description</h2>
+ * Messages are posted and fetched in both directions, the rings
+ * capacity and the messages order are verified.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.2.1] Posting messages from side A until the ring is full, side B
+ *   is not waiting so no doorbell must be rung.
+ * - [7.2.2] Fetching the messages on side B, they must be received in
+ *   order.
+ * - [7.2.3] Exchanging a message in the other direction.
+ * .
+ */
+
+static void oslib_test_007_002_setup(void) {
+  rmb_loopback_connect();
+}
+
+static void oslib_test_007_002_execute(void) {
+  uint32_t buf[RMB_SIZE / 4U];
+  size_t n;
+  uint32_t i;
+  msg_t msg;
+
+  /* [7.2.1] Posting messages from side A until the ring is full, side B
+     is not waiting so no doorbell must be rung.*/
+  test_set_step(1);
+  {
+    for (i = 0U; i < RMB_SLOTS; i++) {
+      msg = chRMBPostTimeout(&rmba, &i, sizeof (uint32_t), TIME_IMMEDIATE);
+      test_assert(msg == MSG_OK, "post failed");
+    }
+    msg = chRMBPostTimeout(&rmba, &i, sizeof (uint32_t), TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "ring not full");
+    test_assert(chRMBGetPendingCountX(&rmba) == RMB_SLOTS, "wrong count");
+    test_assert(chRMBGetUsedCountX(&rmbb) == RMB_SLOTS, "wrong count");
+    test_assert(rmba.n_rung == (ucnt_t)1, "unexpected doorbell");
+  }
+
+  /* [7.2.2] Fetching the messages on side B, they must be received in
+     order.*/
+  test_set_step(2);
+  {
+    for (i = 0U; i < RMB_SLOTS; i++) {
+      msg = chRMBFetchTimeout(&rmbb, buf, &n, TIME_IMMEDIATE);
+      test_assert(msg == MSG_OK, "fetch failed");
+      test_assert(n == sizeof (uint32_t), "wrong size");
+      test_assert(buf[0] == i, "wrong order");
+    }
+    msg = chRMBFetchTimeout(&rmbb, buf, &n, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "ring not empty");
+    test_assert(chRMBGetPendingCountX(&rmba) == 0U, "slots not released");
+    test_assert(rmbb.n_rung == (ucnt_t)0, "unexpected doorbell");
+  }
+
+  /* [7.2.3] Exchanging a message in the other direction.*/
+  test_set_step(3);
+  {
+    msg = chRMBPostTimeout(&rmbb, "ABCD", 4U, TIME_IMMEDIATE);
+    test_assert(msg == MSG_OK, "post failed");
+    msg = chRMBFetchTimeout(&rmba, buf, &n, TIME_IMMEDIATE);
+    test_assert(msg == MSG_OK, "fetch failed");
+    test_assert((n == 4U) && (((char *)buf)[0] == 'A') &&
+                (((char *)buf)[3] == 'D'), "wrong message");
+  }
+}
+
+static const testcase_t oslib_test_007_002 = {
+  "Messages exchange",
+  oslib_test_007_002_setup,
+  NULL,
+  oslib_test_007_002_execute
+};
+
+/**
+ * @page oslib_test_007_003 [7.3] Doorbells batching
+ *
+ * <h2>Description</h2>
+ * Messages are published in place and flushed together, the doorbell
+ * must be rung once for each wait announced by the other side.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.3.1] Waiting for a message on side B, the wait times out after
+ *   being announced to side A.
+ * - [7.3.2] Publishing three messages from side A with a single flush,
+ *   the doorbell must be rung once.
+ * - [7.3.3] Flushing and posting again, the doorbell must not be rung
+ *   because side B did not wait again.
+ * - [7.3.4] Reading the messages in place on side B.
+ * .
+ */
+
+static void oslib_test_007_003_setup(void) {
+  rmb_loopback_connect();
+}
+
+static void oslib_test_007_003_execute(void) {
+  uint32_t buf[RMB_SIZE / 4U];
+  const void *cp;
+  void *p;
+  size_t n;
+  unsigned i;
+  msg_t msg;
+
+  /* [7.3.1] Waiting for a message on side B, the wait times out after
+     being announced to side A.*/
+  test_set_step(1);
+  {
+    msg = chRMBFetchTimeout(&rmbb, buf, &n, TIME_MS2I(10));
+    test_assert(msg == MSG_TIMEOUT, "not timed out");
+  }
+
+  /* [7.3.2] Publishing three messages from side A with a single flush,
+     the doorbell must be rung once.*/
+  test_set_step(2);
+  {
+    for (i = 0U; i < 3U; i++) {
+      msg = chRMBReserveTimeout(&rmba, &p, TIME_IMMEDIATE);
+      test_assert(msg == MSG_OK, "reserve failed");
+      *(char *)p = (char)('A' + i);
+      chRMBPublish(&rmba, 1U);
+    }
+    test_assert(rmba.n_rung == (ucnt_t)1, "unexpected doorbell");
+    chRMBFlush(&rmba);
+    test_assert(rmba.n_rung == (ucnt_t)2, "doorbell not rung");
+    test_assert(rmbb.n_doorbells == (ucnt_t)2, "doorbell not received");
+  }
+
+  /* [7.3.3] Flushing and posting again, the doorbell must not be rung
+     because side B did not wait again.*/
+  test_set_step(3);
+  {
+    chRMBFlush(&rmba);
+    msg = chRMBPostTimeout(&rmba, "D", 1U, TIME_IMMEDIATE);
+    test_assert(msg == MSG_OK, "post failed");
+    test_assert(rmba.n_rung == (ucnt_t)2, "unexpected doorbell");
+  }
+
+  /* [7.3.4] Reading the messages in place on side B.*/
+  test_set_step(4);
+  {
+    for (i = 0U; i < 4U; i++) {
+      msg = chRMBFetchSlotTimeout(&rmbb, &cp, &n, TIME_IMMEDIATE);
+      test_assert(msg == MSG_OK, "fetch failed");
+      test_assert((n == 1U) && (*(const char *)cp == (char)('A' + i)),
+                  "wrong message");
+      chRMBRelease(&rmbb);
+    }
+    test_assert(chRMBGetUsedCountX(&rmbb) == 0U, "ring not empty");
+  }
+}
+
+static const testcase_t oslib_test_007_003 = {
+  "Doorbells batching",
+  oslib_test_007_003_setup,
+  NULL,
+  oslib_test_007_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_007_array[] = {
+  &oslib_test_007_001,
+  &oslib_test_007_002,
+  &oslib_test_007_003,
+  NULL
+};
+
+/**
+ * @brief   Remote Mailboxes.
+ */
+const testsequence_t oslib_test_sequence_007 = {
+  "Remote Mailboxes",
+  oslib_test_sequence_007_array
+};
+
+#endif /* CH_CFG_USE_REMOTE_MAILBOXES */
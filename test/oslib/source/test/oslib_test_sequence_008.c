@@ -0,0 +1,332 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_008.c
+ * @brief   Test Sequence 008 code.
+ *
+ * @page oslib_test_sequence_008 [8] Basic Tasks
+ *
+ * File: @ref oslib_test_sequence_008.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to basic
+ * tasks. Each preemption level is served by a thread created by the test
+ * case, tasks emit tokens when executed.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_BASIC_TASKS == TRUE) && (CH_CFG_USE_WAITEXIT == TRUE)
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_008_001
+ * - @subpage oslib_test_008_002
+ * - @subpage oslib_test_008_003
+ * .
+ */
+
+#if ((CH_CFG_USE_BASIC_TASKS == TRUE) && (CH_CFG_USE_WAITEXIT == TRUE)) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define BT_STACK_SIZE       256
+
+static THD_WORKING_AREA(wa_level1, BT_STACK_SIZE);
+static THD_WORKING_AREA(wa_level2, BT_STACK_SIZE);
+static bt_level_t level1, level2;
+static thread_t *tp1, *tp2;
+static basic_task_t task1, task2, task3;
+static bt_resource_t res1;
+
+static THD_FUNCTION(bt_level_thread, arg) {
+
+  chBTLevelRun((bt_level_t *)arg);
+}
+
+static void bt_token(void *arg) {
+
+  test_emit_token(*(const char *)arg);
+}
+
+static void bt_activator(void *arg) {
+
+  (void)arg;
+
+  test_emit_token('A');
+  (void) chBTActivate(&task2);
+  (void) chBTActivate(&task3);
+  test_emit_token('a');
+}
+
+static void bt_locker(void *arg) {
+
+  (void)arg;
+
+  chBTResourceLock(&res1);
+  (void) chBTActivate(&task3);
+  test_emit_token('B');
+  chBTResourceUnlock(&res1);
+  test_emit_token('b');
+}
+
+static void bt_levels_start(tprio_t threshold1, tprio_t threshold2) {
+  tprio_t prio = chThdGetPriorityX();
+
+  chBTLevelObjectInit(&level1, threshold1);
+  chBTLevelObjectInit(&level2, threshold2);
+  tp1 = chThdCreateStatic(wa_level1, sizeof (wa_level1), prio + 1,
+                          bt_level_thread, &level1);
+  tp2 = chThdCreateStatic(wa_level2, sizeof (wa_level2), prio + 1,
+                          bt_level_thread, &level2);
+}
+
+static void bt_levels_stop(void) {
+
+  chBTLevelStop(&level1);
+  chBTLevelStop(&level2);
+  (void) chThdWait(tp1);
+  (void) chThdWait(tp2);
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_008_001 [8.1] Activation order and counting
+ *
+ * <h2>Description</h2>
+ * Two tasks of the same level are activated together, they must be started
+ * in priority order and only when their priority is the highest.
+ * Activations exceeding the limit must be rejected.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.1.1] Activating a task with priority below the test thread and one
+ *   with priority above it, only the second must be executed.
+ * - [8.1.2] Sleeping, the lower priority task must be executed.
+ * - [8.1.3] Activating a task beyond its activations limit, the last
+ *   activation must fail and the task must be executed once for each
+ *   accepted activation.
+ * .
+ */
+
+static void oslib_test_008_001_setup(void) {
+  tprio_t prio = chThdGetPriorityX();
+
+  bt_levels_start(prio + 2, prio + 2);
+  chBTObjectInit(&task1, &level1, prio - 1, 3, bt_token, "A");
+  chBTObjectInit(&task2, &level1, prio + 1, 3, bt_token, "B");
+}
+
+static void oslib_test_008_001_teardown(void) {
+  bt_levels_stop();
+}
+
+static void oslib_test_008_001_execute(void) {
+  msg_t msg;
+  ucnt_t n;
+  unsigned i;
+
+  /* [8.1.1] Activating a task with priority below the test thread and one
+     with priority above it, only the second must be executed.*/
+  test_set_step(1);
+  {
+    chSysLock();
+    msg = chBTActivateI(&task1);
+    if (msg == MSG_OK) {
+      msg = chBTActivateI(&task2);
+    }
+    chSchRescheduleS();
+    chSysUnlock();
+    test_assert(msg == MSG_OK, "not activated");
+    test_assert_sequence("B", "invalid sequence");
+  }
+
+  /* [8.1.2] Sleeping, the lower priority task must be executed.*/
+  test_set_step(2);
+  {
+    chThdSleepMilliseconds(10);
+    test_assert_sequence("A", "invalid sequence");
+  }
+
+  /* [8.1.3] Activating a task beyond its activations limit, the last
+     activation must fail and the task must be executed once for each
+     accepted activation.*/
+  test_set_step(3);
+  {
+    chSysLock();
+    for (i = 0U; i < 4U; i++) {
+      msg = chBTActivateI(&task2);
+    }
+    n = chBTGetPendingI(&task2);
+    chSchRescheduleS();
+    chSysUnlock();
+    test_assert(msg == MSG_TIMEOUT, "activated");
+    test_assert(n == (ucnt_t)3, "wrong pending count");
+    test_assert_sequence("BBB", "invalid sequence");
+  }
+}
+
+static const testcase_t oslib_test_008_001 = {
+  "Activation order and counting",
+  oslib_test_008_001_setup,
+  oslib_test_008_001_teardown,
+  oslib_test_008_001_execute
+};
+
+/**
+ * @page oslib_test_008_002 [8.2] Preemption threshold
+ *
+ * <h2>Description</h2>
+ * A running task activates a task of the same level and a task of another
+ * level, only the task with priority above the preemption threshold must
+ * preempt it.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.2.1] Activating the first task, the task of the other level must
+ *   preempt it, the task of the same level must be executed after it.
+ * .
+ */
+
+static void oslib_test_008_002_setup(void) {
+  tprio_t prio = chThdGetPriorityX();
+
+  bt_levels_start(prio + 3, prio + 4);
+  chBTObjectInit(&task1, &level1, prio + 1, 1, bt_activator, NULL);
+  chBTObjectInit(&task2, &level1, prio + 2, 1, bt_token, "B");
+  chBTObjectInit(&task3, &level2, prio + 4, 1, bt_token, "C");
+}
+
+static void oslib_test_008_002_teardown(void) {
+  bt_levels_stop();
+}
+
+static void oslib_test_008_002_execute(void) {
+
+  /* [8.2.1] Activating the first task, the task of the other level must
+     preempt it, the task of the same level must be executed after it.*/
+  test_set_step(1);
+  {
+    (void) chBTActivate(&task1);
+    test_assert_sequence("ACaB", "invalid sequence");
+  }
+}
+
+static const testcase_t oslib_test_008_002 = {
+  "Preemption threshold",
+  oslib_test_008_002_setup,
+  oslib_test_008_002_teardown,
+  oslib_test_008_002_execute
+};
+
+/**
+ * @page oslib_test_008_003 [8.3] Resources
+ *
+ * <h2>Description</h2>
+ * A resource is locked by the test thread and by a task, tasks with
+ * priority not above the resource ceiling must not be started until the
+ * resource is unlocked.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.3.1] Locking the resource from the test thread then activating a
+ *   task below the ceiling and a task above it, only the second must be
+ *   executed before unlocking.
+ * - [8.3.2] Locking the resource from a task then activating a task of
+ *   another level below the ceiling, it must be executed when the resource
+ *   is unlocked.
+ * .
+ */
+
+static void oslib_test_008_003_setup(void) {
+  tprio_t prio = chThdGetPriorityX();
+
+  bt_levels_start(prio + 2, prio + 4);
+  chBTResourceObjectInit(&res1, prio + 3);
+}
+
+static void oslib_test_008_003_teardown(void) {
+  bt_levels_stop();
+}
+
+static void oslib_test_008_003_execute(void) {
+  tprio_t prio = chThdGetPriorityX();
+
+  /* [8.3.1] Locking the resource from the test thread then activating a
+     task below the ceiling and a task above it, only the second must be
+     executed before unlocking.*/
+  test_set_step(1);
+  {
+    chBTObjectInit(&task1, &level1, prio + 1, 1, bt_token, "B");
+    chBTObjectInit(&task3, &level2, prio + 4, 1, bt_token, "C");
+    chBTResourceLock(&res1);
+    test_assert(chThdGetPriorityX() == prio + 3, "wrong priority");
+    (void) chBTActivate(&task1);
+    (void) chBTActivate(&task3);
+    test_emit_token('L');
+    chBTResourceUnlock(&res1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority");
+    test_assert_sequence("CLB", "invalid sequence");
+  }
+
+  /* [8.3.2] Locking the resource from a task then activating a task of
+     another level below the ceiling, it must be executed when the resource
+     is unlocked.*/
+  test_set_step(2);
+  {
+    chBTObjectInit(&task1, &level1, prio + 1, 1, bt_locker, NULL);
+    chBTObjectInit(&task3, &level2, prio + 3, 1, bt_token, "C");
+    (void) chBTActivate(&task1);
+    test_assert_sequence("BCb", "invalid sequence");
+  }
+}
+
+static const testcase_t oslib_test_008_003 = {
+  "Resources",
+  oslib_test_008_003_setup,
+  oslib_test_008_003_teardown,
+  oslib_test_008_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_008_array[] = {
+  &oslib_test_008_001,
+  &oslib_test_008_002,
+  &oslib_test_008_003,
+  NULL
+};
+
+/**
+ * @brief   Basic Tasks.
+ */
+const testsequence_t oslib_test_sequence_008 = {
+  "Basic Tasks",
+  oslib_test_sequence_008_array
+};
+
+#endif /* (CH_CFG_USE_BASIC_TASKS == TRUE) && (CH_CFG_USE_WAITEXIT == TRUE) */
@@ -0,0 +1,378 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_009.c
+ * @brief   Test Sequence 009 code.
+ *
+ * @page oslib_test_sequence_009 [9] Schedule Tables
+ *
+ * File: @ref oslib_test_sequence_009.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to
+ * schedule tables.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SCHEDULE_TABLES == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_009_001
+ * - @subpage oslib_test_009_002
+ * - @subpage oslib_test_009_003
+ * .
+ */
+
+#if (CH_CFG_USE_SCHEDULE_TABLES == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define ST_MAX_TIMES        8U
+
+static st_timeline_t stl;
+static thread_reference_t st_tr;
+static systime_t st_times[ST_MAX_TIMES];
+static unsigned st_count;
+
+static void st_token(void *arg) {
+
+  test_emit_token_i(*(const char *)arg);
+}
+
+static void st_record(void *arg) {
+
+  (void)arg;
+
+  if (st_count < ST_MAX_TIMES) {
+    st_times[st_count++] = chVTGetSystemTimeX();
+  }
+}
+
+static const st_expiry_t st_points1[] = {
+  ST_CALLBACK(TIME_MS2I(0), st_token, "A"),
+  ST_CALLBACK(TIME_MS2I(10), st_token, "B"),
+  ST_CALLBACK(TIME_MS2I(10), st_token, "C"),
+  ST_CALLBACK(TIME_MS2I(30), st_token, "D"),
+  ST_RESUME(TIME_MS2I(30), &st_tr, MSG_OK)
+};
+
+static const st_expiry_t st_points2[] = {
+  ST_CALLBACK(TIME_MS2I(0), st_token, "x"),
+  ST_CALLBACK(TIME_MS2I(10), st_token, "y")
+};
+
+static const st_expiry_t st_points3[] = {
+  ST_CALLBACK(TIME_MS2I(0), st_record, NULL),
+  ST_CALLBACK(TIME_MS2I(10), st_record, NULL),
+  ST_CALLBACK(TIME_MS2I(20), st_record, NULL),
+  ST_CALLBACK(TIME_MS2I(30), st_record, NULL)
+};
+
+static const st_table_t st_single =
+  ST_TABLE(st_points1, TIME_MS2I(50), false, 0, 0);
+static const st_table_t st_repeating =
+  ST_TABLE(st_points1, TIME_MS2I(50), true, 0, 0);
+static const st_table_t st_next =
+  ST_TABLE(st_points2, TIME_MS2I(20), false, 0, 0);
+static const st_table_t st_sync =
+  ST_TABLE(st_points3, TIME_MS2I(40), true, TIME_MS2I(1), TIME_MS2I(2));
+
+static const unsigned st_retard_offsets[] = {20U, 32U, 44U, 56U, 66U};
+static const unsigned st_advance_offsets[] = {76U, 84U, 93U};
+
+static st_state_t st_get_state(void) {
+  st_state_t state;
+
+  chSysLock();
+  state = chSTGetStateI(&stl);
+  chSysUnlock();
+
+  return state;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_009_001 [9.1] Expiry points
+ *
+ * <h2>Description</h2>
+ * Single shot and repeating tables are started, the expiry points must be
+ * processed in order and at the right time.
+ *
+ * <h2>Test Steps</h2>
+ * - [9.1.1] Starting a single shot table, the points must be processed once
+ *   then the timeline must stop.
+ * - [9.1.2] Starting a repeating table, the points must be processed on
+ *   each cycle until the timeline is stopped.
+ * - [9.1.3] Starting a table and waiting on the resumed thread reference,
+ *   the thread must be resumed on the expiry point time.
+ * .
+ */
+
+static void oslib_test_009_001_setup(void) {
+  chSTObjectInit(&stl);
+}
+
+static void oslib_test_009_001_teardown(void) {
+  chSTStop(&stl);
+}
+
+static void oslib_test_009_001_execute(void) {
+  systime_t time;
+  msg_t msg;
+
+  /* [9.1.1] Starting a single shot table, the points must be processed once
+     then the timeline must stop.*/
+  test_set_step(1);
+  {
+    time = chTimeAddX(chVTGetSystemTime(), TIME_MS2I(10));
+    chSTStartAbs(&stl, &st_single, time);
+    test_assert(st_get_state() == ST_RUNNING, "not running");
+    chThdSleepUntil(chTimeAddX(time, TIME_MS2I(60)));
+    test_assert_sequence("ABCD", "invalid sequence");
+    test_assert(st_get_state() == ST_STOPPED, "not stopped");
+  }
+
+  /* [9.1.2] Starting a repeating table, the points must be processed on
+     each cycle until the timeline is stopped.*/
+  test_set_step(2);
+  {
+    time = chTimeAddX(chVTGetSystemTime(), TIME_MS2I(10));
+    chSTStartAbs(&stl, &st_repeating, time);
+    chThdSleepUntil(chTimeAddX(time, TIME_MS2I(95)));
+    test_assert_sequence("ABCDABCD", "invalid sequence");
+    test_assert(st_get_state() == ST_RUNNING, "not running");
+    chSTStop(&stl);
+    test_assert(st_get_state() == ST_STOPPED, "not stopped");
+  }
+
+  /* [9.1.3] Starting a table and waiting on the resumed thread reference,
+     the thread must be resumed on the expiry point time.*/
+  test_set_step(3);
+  {
+    chSysLock();
+    time = chTimeAddX(chVTGetSystemTimeX(), TIME_MS2I(10));
+    chSTStartRelI(&stl, &st_single, TIME_MS2I(10));
+    msg = chThdSuspendTimeoutS(&st_tr, TIME_MS2I(100));
+    chSysUnlock();
+    test_assert(msg == MSG_OK, "not resumed");
+    test_assert_time_window(chTimeAddX(time, TIME_MS2I(30)),
+                            chTimeAddX(time, TIME_MS2I(30) + 1),
+                            "out of time window");
+    test_assert_sequence("ABCD", "invalid sequence");
+  }
+}
+
+static const testcase_t oslib_test_009_001 = {
+  "Expiry points",
+  oslib_test_009_001_setup,
+  oslib_test_009_001_teardown,
+  oslib_test_009_001_execute
+};
+
+/**
+ * @page oslib_test_009_002 [9.2] Tables switching
+ *
+ * <h2>Description</h2>
+ * A table is queued while another one is running, it must be started at the
+ * end of the current cycle.
+ *
+ * <h2>Test Steps</h2>
+ * - [9.2.1] Starting a repeating table and queuing a single shot table
+ *   during the first cycle, the queued table must follow the first cycle.
+ * .
+ */
+
+static void oslib_test_009_002_setup(void) {
+  chSTObjectInit(&stl);
+}
+
+static void oslib_test_009_002_teardown(void) {
+  chSTStop(&stl);
+}
+
+static void oslib_test_009_002_execute(void) {
+  const st_table_t *tp;
+  systime_t time;
+
+  /* [9.2.1] Starting a repeating table and queuing a single shot table
+     during the first cycle, the queued table must follow the first cycle.*/
+  test_set_step(1);
+  {
+    time = chTimeAddX(chVTGetSystemTime(), TIME_MS2I(10));
+    chSTStartAbs(&stl, &st_repeating, time);
+    chThdSleepUntil(chTimeAddX(time, TIME_MS2I(20)));
+    chSTNext(&stl, &st_next);
+    test_assert_sequence("ABC", "invalid sequence");
+    chThdSleepUntil(chTimeAddX(time, TIME_MS2I(55)));
+    test_assert_sequence("Dx", "invalid sequence");
+    chSysLock();
+    tp = chSTGetTableI(&stl);
+    chSysUnlock();
+    test_assert(tp == &st_next, "wrong table");
+    chThdSleepUntil(chTimeAddX(time, TIME_MS2I(80)));
+    test_assert_sequence("y", "invalid sequence");
+    test_assert(st_get_state() == ST_STOPPED, "not stopped");
+  }
+}
+
+static const testcase_t oslib_test_009_002 = {
+  "Tables switching",
+  oslib_test_009_002_setup,
+  oslib_test_009_002_teardown,
+  oslib_test_009_002_execute
+};
+
+/**
+ * @page oslib_test_009_003 [9.3] Synchronization
+ *
+ * <h2>Description</h2>
+ * A repeating table is synchronized to an external time base, the deviation
+ * must be corrected gradually in both directions and a table must be
+ * started on the first synchronization.
+ *
+ * <h2>Test Steps</h2>
+ * - [9.3.1] Starting the table and synchronizing it with no deviation, the
+ *   timeline must become synchronous.
+ * - [9.3.2] Synchronizing with the timeline ahead of the time base, the
+ *   timeline must be retarded by the maximum adjustment on each alarm.
+ * - [9.3.3] Synchronizing with the timeline behind the time base, the
+ *   timeline must be advanced by the maximum adjustment on each alarm.
+ * - [9.3.4] Starting the table on the first synchronization, it must start
+ *   at the end of the time base cycle.
+ * .
+ */
+
+static void oslib_test_009_003_setup(void) {
+  chSTObjectInit(&stl);
+  st_count = 0U;
+}
+
+static void oslib_test_009_003_teardown(void) {
+  chSTStop(&stl);
+}
+
+static void oslib_test_009_003_execute(void) {
+  systime_t time;
+  unsigned i;
+
+  /* [9.3.1] Starting the table and synchronizing it with no deviation, the
+     timeline must become synchronous.*/
+  test_set_step(1);
+  {
+    time = chTimeAddX(chVTGetSystemTime(), TIME_MS2I(10));
+    chSTStartAbs(&stl, &st_sync, time);
+    chThdSleepUntil(chTimeAddX(time, TIME_MS2I(5)));
+    test_assert(st_get_state() == ST_RUNNING, "synchronous");
+    chSTSync(&stl, TIME_MS2I(5));
+    test_assert(st_get_state() == ST_RUNNING_SYNC, "not synchronous");
+  }
+
+  /* [9.3.2] Synchronizing with the timeline ahead of the time base, the
+     timeline must be retarded by the maximum adjustment on each alarm.*/
+  test_set_step(2);
+  {
+    chThdSleepUntil(chTimeAddX(time, TIME_MS2I(15)));
+    st_count = 0U;
+    chSTSync(&stl, TIME_MS2I(9));
+    test_assert(st_get_state() == ST_RUNNING, "synchronous");
+    chThdSleepUntil(chTimeAddX(time, TIME_MS2I(70)));
+    test_assert(st_get_state() == ST_RUNNING_SYNC, "not synchronous");
+    test_assert(st_count == 5U, "wrong points count");
+    for (i = 0U; i < 5U; i++) {
+      test_assert(st_times[i] ==
+                  chTimeAddX(time, TIME_MS2I(st_retard_offsets[i])),
+                  "wrong expiry time");
+    }
+  }
+
+  /* [9.3.3] Synchronizing with the timeline behind the time base, the
+     timeline must be advanced by the maximum adjustment on each alarm.*/
+  test_set_step(3);
+  {
+    st_count = 0U;
+    chSTSync(&stl, TIME_MS2I(27));
+    test_assert(st_get_state() == ST_RUNNING, "synchronous");
+    chThdSleepUntil(chTimeAddX(time, TIME_MS2I(95)));
+    test_assert(st_get_state() == ST_RUNNING_SYNC, "not synchronous");
+    test_assert(st_count == 3U, "wrong points count");
+    for (i = 0U; i < 3U; i++) {
+      test_assert(st_times[i] ==
+                  chTimeAddX(time, TIME_MS2I(st_advance_offsets[i])),
+                  "wrong expiry time");
+    }
+  }
+
+  /* [9.3.4] Starting the table on the first synchronization, it must start
+     at the end of the time base cycle.*/
+  test_set_step(4);
+  {
+    chSTStop(&stl);
+    chSTStartSync(&stl, &st_sync);
+    test_assert(st_get_state() == ST_WAITING, "not waiting");
+    chSysLock();
+    st_count = 0U;
+    time = chVTGetSystemTimeX();
+    chSTSyncI(&stl, TIME_MS2I(30));
+    chSysUnlock();
+    chThdSleepUntil(chTimeAddX(time, TIME_MS2I(15)));
+    test_assert(st_get_state() == ST_RUNNING_SYNC, "not synchronous");
+    test_assert(st_count == 1U, "wrong points count");
+    test_assert(st_times[0] == chTimeAddX(time, TIME_MS2I(10)),
+                "wrong expiry time");
+  }
+}
+
+static const testcase_t oslib_test_009_003 = {
+  "Synchronization",
+  oslib_test_009_003_setup,
+  oslib_test_009_003_teardown,
+  oslib_test_009_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_009_array[] = {
+  &oslib_test_009_001,
+  &oslib_test_009_002,
+  &oslib_test_009_003,
+  NULL
+};
+
+/**
+ * @brief   Schedule Tables.
+ */
+const testsequence_t oslib_test_sequence_009 = {
+  "Schedule Tables",
+  oslib_test_sequence_009_array
+};
+
+#endif /* CH_CFG_USE_SCHEDULE_TABLES == TRUE */
@@ -0,0 +1,301 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_010.c
+ * @brief   Test Sequence 010 code.
+ *
+ * @page oslib_test_sequence_010 [10] RCU
+ *
+ * File: @ref oslib_test_sequence_010.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to read-
+ * copy-update.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_RCU == TRUE) && (CH_CFG_USE_WAITEXIT == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE)
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_010_001
+ * - @subpage oslib_test_010_002
+ * - @subpage oslib_test_010_003
+ * .
+ */
+
+#if ((CH_CFG_USE_RCU == TRUE) && (CH_CFG_USE_WAITEXIT == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE)) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define RCU_STACK_SIZE      256
+
+typedef struct {
+  sysinterval_t         delay;
+  sysinterval_t         hold;
+  char                  token;
+} rcu_reader_t;
+
+typedef struct {
+  rcu_head_t            head;
+  char                  token;
+} rcu_object_t;
+
+static THD_WORKING_AREA(wa_reader1, RCU_STACK_SIZE);
+static THD_WORKING_AREA(wa_reader2, RCU_STACK_SIZE);
+static thread_t *tp1, *tp2;
+static memory_pool_t rcu_pool;
+static rcu_object_t rcu_objects[2];
+static rcu_object_t *rcu_current;
+
+static const rcu_reader_t rcu_reader1 = {(sysinterval_t)0, TIME_MS2I(50), 'A'};
+static const rcu_reader_t rcu_reader2 = {TIME_MS2I(10), TIME_MS2I(100), 'C'};
+
+static THD_FUNCTION(rcu_reader, arg) {
+  const rcu_reader_t *rp = (const rcu_reader_t *)arg;
+
+  if (rp->delay > (sysinterval_t)0) {
+    chThdSleep(rp->delay);
+  }
+  chRCUReadLock();
+  (void)rcu_current;
+  chThdSleep(rp->hold);
+  test_emit_token(rp->token);
+  chRCUReadUnlock();
+}
+
+static thread_t *rcu_reader_start(stkalign_t *wap, size_t size,
+                                  const rcu_reader_t *rp) {
+
+  return chThdCreateStatic(wap, size, chThdGetPriorityX() + 1,
+                           rcu_reader, (void *)rp);
+}
+
+static void rcu_free(rcu_head_t *hp) {
+  rcu_object_t *op = (rcu_object_t *)hp;
+
+  test_emit_token(op->token);
+  chPoolFree(&rcu_pool, op);
+}
+
+static rcu_object_t *rcu_publish(char token) {
+  rcu_object_t *old = rcu_current;
+  rcu_object_t *op = chPoolAlloc(&rcu_pool);
+
+  op->token = token;
+  chRCUAssignPointer(rcu_current, op);
+
+  return old;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_010_001 [10.1] Read-side critical sections
+ *
+ * <h2>Description</h2>
+ * Read-side critical sections are nested and a grace period is waited
+ * without preempted readers.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.1.1] Entering two nested sections, the thread must be reading until
+ *   the outermost section is left.
+ * - [10.1.2] Waiting for a grace period without preempted readers, the wait
+ *   must end immediately.
+ * .
+ */
+
+static void oslib_test_010_001_execute(void) {
+  systime_t time;
+
+  /* [10.1.1] Entering two nested sections, the thread must be reading until
+     the outermost section is left.*/
+  test_set_step(1);
+  {
+    chRCUReadLock();
+    chRCUReadLock();
+    test_assert(chRCUIsReadingX(), "not reading");
+    chRCUReadUnlock();
+    test_assert(chRCUIsReadingX(), "not reading");
+    chRCUReadUnlock();
+    test_assert(!chRCUIsReadingX(), "still reading");
+  }
+
+  /* [10.1.2] Waiting for a grace period without preempted readers, the wait
+     must end immediately.*/
+  test_set_step(2);
+  {
+    chThdSleep(1);
+    time = chVTGetSystemTime();
+    chRCUSynchronize();
+    test_assert_time_window(time, chTimeAddX(time, 1), "out of time window");
+  }
+}
+
+static const testcase_t oslib_test_010_001 = {
+  "Read-side critical sections",
+  NULL,
+  NULL,
+  oslib_test_010_001_execute
+};
+
+/**
+ * @page oslib_test_010_002 [10.2] Grace periods
+ *
+ * <h2>Description</h2>
+ * A grace period must wait for the readers preempted inside a section
+ * before its start and only for them.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.2.1] Starting a reader holding a section for 50mS and a reader
+ *   entering a section after 10mS for 100mS, then waiting for a grace
+ *   period. The wait must end when the first reader leaves its section.
+ * - [10.2.2] Waiting for the readers, the second reader must leave its
+ *   section last.
+ * .
+ */
+
+static void oslib_test_010_002_execute(void) {
+  systime_t time;
+
+  /* [10.2.1] Starting a reader holding a section for 50mS and a reader
+     entering a section after 10mS for 100mS, then waiting for a grace
+     period. The wait must end when the first reader leaves its section.*/
+  test_set_step(1);
+  {
+    chThdSleep(1);
+    time = chVTGetSystemTime();
+    tp1 = rcu_reader_start(wa_reader1, sizeof (wa_reader1), &rcu_reader1);
+    tp2 = rcu_reader_start(wa_reader2, sizeof (wa_reader2), &rcu_reader2);
+    chRCUSynchronize();
+    test_emit_token('B');
+    test_assert_time_window(chTimeAddX(time, TIME_MS2I(50)),
+                            chTimeAddX(time, TIME_MS2I(50) + 2),
+                            "out of time window");
+  }
+
+  /* [10.2.2] Waiting for the readers, the second reader must leave its
+     section last.*/
+  test_set_step(2);
+  {
+    (void) chThdWait(tp1);
+    (void) chThdWait(tp2);
+    test_assert_sequence("ABC", "invalid sequence");
+  }
+}
+
+static const testcase_t oslib_test_010_002 = {
+  "Grace periods",
+  NULL,
+  NULL,
+  oslib_test_010_002_execute
+};
+
+/**
+ * @page oslib_test_010_003 [10.3] Reclamation callbacks
+ *
+ * <h2>Description</h2>
+ * Versions allocated from a pool are replaced and reclaimed by callbacks
+ * after their grace period.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.3.1] Replacing the published version without readers, the old
+ *   version must be returned to the pool by the callback.
+ * - [10.3.2] Replacing the version while a reader is inside a section, the
+ *   callback must be delayed until the reader leaves and the barrier is
+ *   invoked.
+ * .
+ */
+
+static void oslib_test_010_003_setup(void) {
+  chPoolObjectInit(&rcu_pool, sizeof (rcu_object_t), NULL);
+  chPoolLoadArray(&rcu_pool, rcu_objects, 2);
+  rcu_current = NULL;
+}
+
+static void oslib_test_010_003_teardown(void) {
+  rcu_current = NULL;
+}
+
+static void oslib_test_010_003_execute(void) {
+  rcu_object_t *old;
+
+  /* [10.3.1] Replacing the published version without readers, the old
+     version must be returned to the pool by the callback.*/
+  test_set_step(1);
+  {
+    (void) rcu_publish('a');
+    old = rcu_publish('b');
+    chRCUCall(&old->head, rcu_free);
+    test_assert_sequence("a", "invalid sequence");
+    test_assert(chPoolAlloc(&rcu_pool) == (void *)old, "not reclaimed");
+    chPoolFree(&rcu_pool, old);
+  }
+
+  /* [10.3.2] Replacing the version while a reader is inside a section, the
+     callback must be delayed until the reader leaves and the barrier is
+     invoked.*/
+  test_set_step(2);
+  {
+    tp1 = rcu_reader_start(wa_reader1, sizeof (wa_reader1), &rcu_reader1);
+    old = rcu_publish('c');
+    chRCUCall(&old->head, rcu_free);
+    test_assert_sequence("", "invalid sequence");
+    chRCUBarrier();
+    test_assert_sequence("Ab", "invalid sequence");
+    (void) chThdWait(tp1);
+  }
+}
+
+static const testcase_t oslib_test_010_003 = {
+  "Reclamation callbacks",
+  oslib_test_010_003_setup,
+  oslib_test_010_003_teardown,
+  oslib_test_010_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_010_array[] = {
+  &oslib_test_010_001,
+  &oslib_test_010_002,
+  &oslib_test_010_003,
+  NULL
+};
+
+/**
+ * @brief   RCU.
+ */
+const testsequence_t oslib_test_sequence_010 = {
+  "RCU",
+  oslib_test_sequence_010_array
+};
+
+#endif /* (CH_CFG_USE_RCU == TRUE) && (CH_CFG_USE_WAITEXIT == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) */
@@ -0,0 +1,447 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_011.c
+ * @brief   Test Sequence 011 code.
+ *
+ * @page oslib_test_sequence_011 [11] Newlib Retargeting
+ *
+ * File: @ref oslib_test_sequence_011.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the newlib retargeting layer, the allocator
+ * functions and the file descriptors table are invoked directly. The
+ * SYSCALLS_USE_HEAP and SYSCALLS_USE_STREAMS options must be specified
+ * in the makefile.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (defined(SYSCALLS_USE_HEAP) && (SYSCALLS_USE_HEAP == TRUE)) ||
+ *   (defined(SYSCALLS_USE_STREAMS) && (SYSCALLS_USE_STREAMS == TRUE))
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_011_001
+ * - @subpage oslib_test_011_002
+ * - @subpage oslib_test_011_003
+ * .
+ */
+
+#if ((defined(SYSCALLS_USE_HEAP) && (SYSCALLS_USE_HEAP == TRUE)) || (defined(SYSCALLS_USE_STREAMS) && (SYSCALLS_USE_STREAMS == TRUE))) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <reent.h>
+#include <sys/stat.h>
+
+#include "syscalls.h"
+
+#if SYSCALLS_USE_STREAMS == TRUE
+#include "memstreams.h"
+
+static MemoryStream ms;
+static uint8_t ms_buffer[16];
+#endif
+
+#if CH_CFG_USE_WAITEXIT == TRUE
+#define MALLOC_STACK_SIZE   256
+
+static THD_WORKING_AREA(wa_malloc1, MALLOC_STACK_SIZE);
+static THD_WORKING_AREA(wa_malloc2, MALLOC_STACK_SIZE);
+static THD_WORKING_AREA(wa_malloc3, MALLOC_STACK_SIZE);
+static THD_WORKING_AREA(wa_malloc4, MALLOC_STACK_SIZE);
+static volatile bool malloc_stop;
+static uint32_t malloc_ops, malloc_errors;
+
+static THD_FUNCTION(malloc_thread, p) {
+  uint8_t tag = (uint8_t)(size_t)p;
+  size_t i, size = 16U;
+
+  while (!malloc_stop) {
+    uint8_t *bp = malloc(size);
+    if (bp != NULL) {
+      memset(bp, tag, size);
+      chThdYield();
+      for (i = 0U; i < size; i++) {
+        if (bp[i] != tag) {
+          malloc_errors++;
+          break;
+        }
+      }
+      free(bp);
+      malloc_ops++;
+    }
+    size = size < 256U ? size * 2U : 16U;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  }
+}
+#endif
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+#if (SYSCALLS_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_001 [11.1] Allocator functions
+ *
+ * <h2>Description</h2>
+ * The newlib reentrant allocator functions are invoked, the blocks must
+ * come from the configured heap and the heap must be returned to its
+ * initial state.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - SYSCALLS_USE_HEAP == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.1.1] Taking the heap status as reference.
+ * - [11.1.2] Allocating a block using _malloc_r(), the block must come
+ *   from the heap.
+ * - [11.1.3] Shrinking the block using _realloc_r(), the block must be
+ *   kept.
+ * - [11.1.4] Growing the block using _realloc_r(), the content must be
+ *   preserved.
+ * - [11.1.5] Allocating a block using _calloc_r(), the block must be
+ *   cleared. An overflowing request must fail with ENOMEM.
+ * - [11.1.6] Invoking _realloc_r() with a NULL pointer then with a zero
+ *   size, it must behave as _malloc_r() then as _free_r().
+ * - [11.1.7] Allocating a block aligned to 64 bytes using _memalign_r(),
+ *   an invalid alignment must fail with EINVAL.
+ * - [11.1.8] Freeing the blocks using _free_r(), the heap must be back
+ *   to the initial state.
+ * .
+ */
+
+static void oslib_test_011_001_execute(void) {
+  struct _reent *r = _REENT;
+  uint8_t *p1, *p2, *p3, *p4;
+  size_t n1, total1, n2, total2;
+  unsigned i;
+
+  /* [11.1.1] Taking the heap status as reference.*/
+  test_set_step(1);
+  {
+    n1 = chHeapStatus(SYSCALLS_HEAP, &total1, NULL);
+  }
+
+  /* [11.1.2] Allocating a block using _malloc_r(), the block must come
+     from the heap.*/
+  test_set_step(2);
+  {
+    p1 = _malloc_r(r, 16);
+    test_assert(p1 != NULL, "allocation failed");
+    test_assert(chHeapGetSize(p1) >= 16U, "wrong block size");
+    memset(p1, 0x55, 16);
+  }
+
+  /* [11.1.3] Shrinking the block using _realloc_r(), the block must be
+     kept.*/
+  test_set_step(3);
+  {
+    p2 = _realloc_r(r, p1, 8);
+    test_assert(p2 == p1, "block moved");
+  }
+
+  /* [11.1.4] Growing the block using _realloc_r(), the content must be
+     preserved.*/
+  test_set_step(4);
+  {
+    p2 = _realloc_r(r, p1, 64);
+    test_assert(p2 != NULL, "reallocation failed");
+    test_assert(chHeapGetSize(p2) >= 64U, "wrong block size");
+    for (i = 0U; i < 16U; i++) {
+      test_assert(p2[i] == 0x55U, "content not preserved");
+    }
+    p1 = p2;
+  }
+
+  /* [11.1.5] Allocating a block using _calloc_r(), the block must be
+     cleared. An overflowing request must fail with ENOMEM.*/
+  test_set_step(5);
+  {
+    p3 = _calloc_r(r, 4, 8);
+    test_assert(p3 != NULL, "allocation failed");
+    for (i = 0U; i < 32U; i++) {
+      test_assert(p3[i] == 0U, "block not cleared");
+    }
+    __errno_r(r) = 0;
+    test_assert(_calloc_r(r, (size_t)-1, 2) == NULL, "overflow not detected");
+    test_assert(__errno_r(r) == ENOMEM, "wrong error code");
+  }
+
+  /* [11.1.6] Invoking _realloc_r() with a NULL pointer then with a zero
+     size, it must behave as _malloc_r() then as _free_r().*/
+  test_set_step(6);
+  {
+    p2 = _realloc_r(r, NULL, 16);
+    test_assert(p2 != NULL, "allocation failed");
+    test_assert(_realloc_r(r, p2, 0) == NULL, "block not freed");
+  }
+
+  /* [11.1.7] Allocating a block aligned to 64 bytes using _memalign_r(),
+     an invalid alignment must fail with EINVAL.*/
+  test_set_step(7);
+  {
+    p4 = _memalign_r(r, 64, 16);
+    test_assert(p4 != NULL, "allocation failed");
+    test_assert(((uintptr_t)p4 & 63U) == 0U, "block not aligned");
+    __errno_r(r) = 0;
+    test_assert(_memalign_r(r, 24, 16) == NULL, "invalid alignment accepted");
+    test_assert(__errno_r(r) == EINVAL, "wrong error code");
+  }
+
+  /* [11.1.8] Freeing the blocks using _free_r(), the heap must be back
+     to the initial state.*/
+  test_set_step(8);
+  {
+    _free_r(r, p1);
+    _free_r(r, p3);
+    _free_r(r, p4);
+    _free_r(r, NULL);
+    n2 = chHeapStatus(SYSCALLS_HEAP, &total2, NULL);
+    test_assert((n1 == n2) && (total1 == total2), "heap not restored");
+  }
+}
+
+static const testcase_t oslib_test_011_001 = {
+  "Allocator functions",
+  NULL,
+  NULL,
+  oslib_test_011_001_execute
+};
+#endif /* SYSCALLS_USE_HEAP == TRUE */
+
+#if (SYSCALLS_USE_STREAMS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_002 [11.2] File descriptors
+ *
+ * <h2>Description</h2>
+ * A memory stream is associated to a file descriptor and accessed using
+ * the newlib reentrant system calls, the descriptors table is then
+ * filled.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - SYSCALLS_USE_STREAMS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.2.1] Associating the stream to the lowest free descriptor, it
+ *   must be above the standard descriptors.
+ * - [11.2.2] Writing then reading back using _write_r() and _read_r().
+ * - [11.2.3] Streams must not be seekable and must be character
+ *   devices.
+ * - [11.2.4] Closing the descriptor using _close_r(), further accesses
+ *   must fail with EBADF.
+ * - [11.2.5] Filling the descriptors table, the association must fail
+ *   when no descriptors are left, then the descriptors are released.
+ * .
+ */
+
+static void oslib_test_011_002_setup(void) {
+  msObjectInit(&ms, ms_buffer, sizeof ms_buffer, 0);
+}
+
+static void oslib_test_011_002_execute(void) {
+  struct _reent *r = _REENT;
+  int fds[SYSCALLS_MAX_FDS];
+  struct stat st;
+  char buf[8];
+  int fd, i, n;
+
+  /* [11.2.1] Associating the stream to the lowest free descriptor, it
+     must be above the standard descriptors.*/
+  test_set_step(1);
+  {
+    fd = syscallsStreamAttach(-1, (BaseSequentialStream *)&ms);
+    test_assert(fd >= 3, "invalid descriptor");
+  }
+
+  /* [11.2.2] Writing then reading back using _write_r() and _read_r().*/
+  test_set_step(2);
+  {
+    test_assert(_write_r(r, fd, "abcd", 4) == 4, "write failed");
+    test_assert(_read_r(r, fd, buf, sizeof buf) == 4, "read failed");
+    test_assert(memcmp(buf, "abcd", 4) == 0, "wrong data");
+  }
+
+  /* [11.2.3] Streams must not be seekable and must be character
+     devices.*/
+  test_set_step(3);
+  {
+    __errno_r(r) = 0;
+    test_assert(_lseek_r(r, fd, 0, SEEK_SET) == -1, "seek not failed");
+    test_assert(__errno_r(r) == ESPIPE, "wrong error code");
+    test_assert(_fstat_r(r, fd, &st) == 0, "fstat failed");
+    test_assert(S_ISCHR(st.st_mode), "not a character device");
+    test_assert(_isatty_r(r, fd) == 1, "not a terminal");
+  }
+
+  /* [11.2.4] Closing the descriptor using _close_r(), further accesses
+     must fail with EBADF.*/
+  test_set_step(4);
+  {
+    test_assert(_close_r(r, fd) == 0, "close failed");
+    __errno_r(r) = 0;
+    test_assert(_write_r(r, fd, "a", 1) == -1, "write not failed");
+    test_assert(__errno_r(r) == EBADF, "wrong error code");
+    test_assert(_isatty_r(r, fd) == 0, "still a terminal");
+    test_assert(_read_r(r, SYSCALLS_MAX_FDS, buf, 1) == -1, "out of range");
+  }
+
+  /* [11.2.5] Filling the descriptors table, the association must fail
+     when no descriptors are left, then the descriptors are released.*/
+  test_set_step(5);
+  {
+    n = 0;
+    while ((fd = syscallsStreamAttach(-1, (BaseSequentialStream *)&ms)) >= 0) {
+      test_assert(n < SYSCALLS_MAX_FDS - 3, "too many descriptors");
+      fds[n++] = fd;
+    }
+    test_assert(n > 0, "no descriptors");
+    for (i = 0; i < n; i++) {
+      syscallsDetach(fds[i]);
+    }
+    fd = syscallsStreamAttach(-1, (BaseSequentialStream *)&ms);
+    test_assert(fd == fds[0], "descriptors not released");
+    syscallsDetach(fd);
+  }
+}
+
+static const testcase_t oslib_test_011_002 = {
+  "File descriptors",
+  oslib_test_011_002_setup,
+  NULL,
+  oslib_test_011_002_execute
+};
+#endif /* SYSCALLS_USE_STREAMS == TRUE */
+
+#if (CH_CFG_USE_WAITEXIT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_003 [11.3] Allocator performance, multiple threads
+ *
+ * <h2>Description</h2>
+ * Four threads allocate blocks of increasing sizes using malloc(), fill
+ * them, yield, check their content and release them using free().<br>
+ * The performance is calculated by measuring the number of iterations
+ * after a second of continuous operations, blocks corruption is checked
+ * at the same time.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_WAITEXIT == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.3.1] The four threads are created at equal lower priority and
+ *   start allocating and releasing blocks continuously.
+ * - [11.3.2] Waiting one second then stopping the four threads.
+ * - [11.3.3] No block must have been corrupted, the score is printed.
+ * .
+ */
+
+static void oslib_test_011_003_execute(void) {
+  thread_t *tp[4];
+  unsigned i;
+
+  /* [11.3.1] The four threads are created at equal lower priority and
+     start allocating and releasing blocks continuously.*/
+  test_set_step(1);
+  {
+    malloc_stop = false;
+    malloc_ops = 0U;
+    malloc_errors = 0U;
+    tp[0] = chThdCreateStatic(wa_malloc1, sizeof wa_malloc1, chThdGetPriorityX() - 1, malloc_thread, (void *)1);
+    tp[1] = chThdCreateStatic(wa_malloc2, sizeof wa_malloc2, chThdGetPriorityX() - 1, malloc_thread, (void *)2);
+    tp[2] = chThdCreateStatic(wa_malloc3, sizeof wa_malloc3, chThdGetPriorityX() - 1, malloc_thread, (void *)3);
+    tp[3] = chThdCreateStatic(wa_malloc4, sizeof wa_malloc4, chThdGetPriorityX() - 1, malloc_thread, (void *)4);
+  }
+
+  /* [11.3.2] Waiting one second then stopping the four threads.*/
+  test_set_step(2);
+  {
+    chThdSleepSeconds(1);
+    malloc_stop = true;
+    for (i = 0U; i < 4U; i++) {
+      chThdWait(tp[i]);
+    }
+  }
+
+  /* [11.3.3] No block must have been corrupted, the score is printed.*/
+  test_set_step(3);
+  {
+    test_assert(malloc_errors == 0U, "block corrupted");
+    test_print("--- Score : ");
+    test_printn(malloc_ops);
+    test_println(" malloc+free/S");
+  }
+}
+
+static const testcase_t oslib_test_011_003 = {
+  "Allocator performance, multiple threads",
+  NULL,
+  NULL,
+  oslib_test_011_003_execute
+};
+#endif /* CH_CFG_USE_WAITEXIT == TRUE */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_011_array[] = {
+#if (SYSCALLS_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_011_001,
+#endif
+#if (SYSCALLS_USE_STREAMS == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_011_002,
+#endif
+#if (CH_CFG_USE_WAITEXIT == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_011_003,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Newlib Retargeting.
+ */
+const testsequence_t oslib_test_sequence_011 = {
+  "Newlib Retargeting",
+  oslib_test_sequence_011_array
+};
+
+#endif /* (defined(SYSCALLS_USE_HEAP) && (SYSCALLS_USE_HEAP == TRUE)) || (defined(SYSCALLS_USE_STREAMS) && (SYSCALLS_USE_STREAMS == TRUE)) */
@@ -31,6 +31,8 @@
  * - @subpage rt_test_sequence_008
  * - @subpage rt_test_sequence_009
  * - @subpage rt_test_sequence_010
+ * - @subpage rt_test_sequence_011
+ * - @subpage rt_test_sequence_012
  * .
  */
 
@@ -72,6 +74,12 @@ const testsequence_t * const rt_test_suite_array[] = {
   &rt_test_sequence_009,
 #endif
   &rt_test_sequence_010,
+#if ((CH_DBG_STATISTICS_LOCKS == TRUE) && (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_sequence_011,
+#endif
+#if (CH_DBG_STATISTICS_PMU == TRUE) || defined(__DOXYGEN__)
+  &rt_test_sequence_012,
+#endif
   NULL
 };
 
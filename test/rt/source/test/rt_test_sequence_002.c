@@ -37,6 +37,9 @@
  * - @subpage rt_test_002_002
  * - @subpage rt_test_002_003
  * - @subpage rt_test_002_004
+ * - @subpage rt_test_002_005
+ * - @subpage rt_test_002_006
+ * - @subpage rt_test_002_007
  * .
  */
 
@@ -61,6 +64,81 @@ static void vtcb(void *p) {
   chSysUnlockFromISR();
 }
 
+#if (CH_DBG_STATISTICS == TRUE) && (CH_DBG_STATISTICS_CRIT_SITES >= 8)
+/* Durations of the profiled critical zones, in realtime counter cycles,
+   the measured durations can be shorter by the calibration offset.*/
+#define CRIT_SHORT      ((rtcnt_t)1000)
+#define CRIT_LONG       ((rtcnt_t)4000)
+
+/* Return addresses taken at the start and at the end of crit_zones(), the
+   call sites of its critical zones lie between them.*/
+static const void *crit_bounds[2];
+
+/* Number of taken addresses, the side effect prevents the compiler from
+   merging calls to crit_here().*/
+static unsigned crit_nbounds;
+
+static NOINLINE const void *crit_here(void) {
+
+  crit_nbounds++;
+  return CH_DBG_STATISTICS_GET_CALLER();
+}
+
+/* Short and long critical zones opened from two call sites of the same
+   function.*/
+static NOINLINE void crit_zones(void) {
+
+  crit_bounds[0] = crit_here();
+
+  chSysLock();
+  chSysPolledDelayX(CRIT_SHORT);
+  chSysUnlock();
+
+  chSysLock();
+  chSysPolledDelayX(CRIT_LONG);
+  chSysUnlock();
+
+  crit_bounds[1] = crit_here();
+}
+
+/* Copies the table entries of the call sites within crit_zones(), returns
+   the number of entries found.*/
+static unsigned crit_find_sites(crit_site_stats_t *sites, unsigned n) {
+  unsigned i, found = 0U;
+
+  chSysLock();
+  for (i = 0U; i < (unsigned)CH_DBG_STATISTICS_CRIT_SITES; i++) {
+    const crit_site_stats_t *csp = &ch.kernel_stats.crit_sites[i];
+
+    if (((uintptr_t)csp->site > (uintptr_t)crit_bounds[0]) &&
+        ((uintptr_t)csp->site < (uintptr_t)crit_bounds[1])) {
+      if (found < n) {
+        sites[found] = *csp;
+      }
+      found++;
+    }
+  }
+  chSysUnlock();
+
+  return found;
+}
+#endif
+
+#if (CH_DBG_STATISTICS == TRUE) && (CH_DBG_STATISTICS_IRQ_VECTORS > 2) &&   \
+    (HAL_USE_SERIAL == TRUE) && defined(USE_SIM_SERIAL1) &&                 \
+    (USE_SIM_SERIAL1 == TRUE) && (USE_SIM_SERIAL2 == TRUE)
+/* Returns the number of times the specified vector has been served.*/
+static ucnt_t irq_served(unsigned vector) {
+  ucnt_t n;
+
+  chSysLock();
+  n = ch.kernel_stats.irq[vector].m_isr.n;
+  chSysUnlock();
+
+  return n;
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -265,6 +343,232 @@ static const testcase_t rt_test_002_004 = {
   rt_test_002_004_execute
 };
 
+#if ((CH_DBG_STATISTICS == TRUE) && (CH_DBG_STATISTICS_CRIT_SITES >= 8)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_002_005 [2.5] Critical zones profiling
+ *
+ * <h2>Description</h2>
+ * Critical zones of known duration are opened from two call sites of
+ * the same function, the per-site statistics are checked for correct
+ * attribution.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_DBG_STATISTICS == TRUE) && (CH_DBG_STATISTICS_CRIT_SITES >= 8)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [2.5.1] Clearing the call sites table.
+ * - [2.5.2] Opening a short and then a long critical zone from two call
+ *   sites of the same function, three times.
+ * - [2.5.3] Looking up the call sites within the function, there must
+ *   be two distinct entries accounting for three zones each, one for
+ *   the short zones and one for the long zones.
+ * .
+ */
+
+static void rt_test_002_005_execute(void) {
+  crit_site_stats_t sites[2];
+  unsigned i, n;
+
+  /* [2.5.1] Clearing the call sites table.*/
+  test_set_step(1);
+  {
+    chSysLock();
+    chStatsResetCritSitesI();
+    chSysUnlock();
+  }
+
+  /* [2.5.2] Opening a short and then a long critical zone from two call
+     sites of the same function, three times.*/
+  test_set_step(2);
+  {
+    for (i = 0U; i < 3U; i++) {
+      crit_zones();
+    }
+  }
+
+  /* [2.5.3] Looking up the call sites within the function, there must
+     be two distinct entries accounting for three zones each, one for
+     the short zones and one for the long zones.*/
+  test_set_step(3);
+  {
+    n = crit_find_sites(sites, 2U);
+    test_assert(n == 2U, "wrong number of sites");
+    test_assert(sites[0].site != sites[1].site, "sites not distinct");
+    if (sites[0].worst > sites[1].worst) {
+      crit_site_stats_t tmp = sites[0];
+      sites[0] = sites[1];
+      sites[1] = tmp;
+    }
+    test_assert(sites[0].n == (ucnt_t)3, "wrong short zones count");
+    test_assert((sites[0].worst >= CRIT_SHORT - ch.tm.offset) &&
+                (sites[0].worst < CRIT_LONG - ch.tm.offset),
+                "wrong short zones worst time");
+    test_assert(sites[1].n == (ucnt_t)3, "wrong long zones count");
+    test_assert(sites[1].worst >= CRIT_LONG - ch.tm.offset,
+                "wrong long zones worst time");
+  }
+}
+
+static const testcase_t rt_test_002_005 = {
+  "Critical zones profiling",
+  NULL,
+  NULL,
+  rt_test_002_005_execute
+};
+#endif /* (CH_DBG_STATISTICS == TRUE) && (CH_DBG_STATISTICS_CRIT_SITES >= 8) */
+
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_002_006 [2.6] Time stamps functionality
+ *
+ * <h2>Description</h2>
+ * The functionality of the API @p chVTGetTimeStamp() is tested.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_TIMESTAMP == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [2.6.1] Reading time stamps in a loop, they must never go backward.
+ * - [2.6.2] The low bits of a time stamp must be the counter value read
+ *   at the same time.
+ * - [2.6.3] Measuring a 100mS sleep using time stamps, the measured time
+ *   must be close to the requested one.
+ * .
+ */
+
+static void rt_test_002_006_execute(void) {
+  systimestamp_t stamp, last;
+  unsigned i;
+
+  /* [2.6.1] Reading time stamps in a loop, they must never go
+     backward.*/
+  test_set_step(1);
+  {
+    last = chVTGetTimeStamp();
+    for (i = 0U; i < 1000U; i++) {
+      stamp = chVTGetTimeStamp();
+      test_assert(stamp >= last, "time stamp went backward");
+      last = stamp;
+    }
+  }
+
+  /* [2.6.2] The low bits of a time stamp must be the counter value read
+     at the same time.*/
+  test_set_step(2);
+  {
+    chSysLock();
+#if PORT_SUPPORTS_RT == TRUE
+    {
+      rtcnt_t start = chSysGetRealtimeCounterX();
+      stamp = chVTGetTimeStampX();
+      last = (systimestamp_t)(rtcnt_t)(chSysGetRealtimeCounterX() - start);
+      test_assert((systimestamp_t)(rtcnt_t)((rtcnt_t)stamp - start) <= last,
+                  "counter mismatch");
+    }
+#else
+    {
+      systime_t start = chVTGetSystemTimeX();
+      stamp = chVTGetTimeStampX();
+      test_assert((systime_t)stamp == start, "counter mismatch");
+    }
+#endif
+    chSysUnlock();
+  }
+
+  /* [2.6.3] Measuring a 100mS sleep using time stamps, the measured time
+     must be close to the requested one.*/
+  test_set_step(3);
+  {
+#if CH_TIMESTAMP_FREQUENCY > 0
+    last = chVTGetTimeStamp();
+    chThdSleepMilliseconds(100);
+    stamp = chTimeStamp2US(chVTGetTimeStamp() - last);
+    test_assert((stamp >= (systimestamp_t)90000) &&
+                (stamp < (systimestamp_t)1000000), "wrong measurement");
+#endif
+  }
+}
+
+static const testcase_t rt_test_002_006 = {
+  "Time stamps functionality",
+  NULL,
+  NULL,
+  rt_test_002_006_execute
+};
+#endif /* CH_CFG_USE_TIMESTAMP == TRUE */
+
+#if ((CH_DBG_STATISTICS == TRUE) && (CH_DBG_STATISTICS_IRQ_VECTORS > 2) && (HAL_USE_SERIAL == TRUE) && defined(USE_SIM_SERIAL1) && (USE_SIM_SERIAL1 == TRUE) && (USE_SIM_SERIAL2 == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_002_007 [2.7] Per-vector interrupt statistics
+ *
+ * <h2>Description</h2>
+ * The per-vector interrupt statistics of the simulator are checked, the
+ * system tick vector must be served while stopped serial ports must not
+ * cause any interrupt.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_DBG_STATISTICS == TRUE) && (CH_DBG_STATISTICS_IRQ_VECTORS > 2)
+ *   && (HAL_USE_SERIAL == TRUE) && defined(USE_SIM_SERIAL1) &&
+ *   (USE_SIM_SERIAL1 == TRUE) && (USE_SIM_SERIAL2 == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [2.7.1] Taking the number of activations of the system tick and
+ *   serial ports vectors.
+ * - [2.7.2] Sleeping for 100mS, interrupt sources are polled meanwhile.
+ * - [2.7.3] The system tick vector must have been served, the vectors
+ *   of the stopped serial ports must not.
+ * .
+ */
+
+static void rt_test_002_007_execute(void) {
+  ucnt_t st, sd1, sd2;
+
+  /* [2.7.1] Taking the number of activations of the system tick and
+     serial ports vectors.*/
+  test_set_step(1);
+  {
+    st  = irq_served(SIM_ST_IRQ_VECTOR);
+    sd1 = irq_served(SIM_SD1_IRQ_VECTOR);
+    sd2 = irq_served(SIM_SD2_IRQ_VECTOR);
+  }
+
+  /* [2.7.2] Sleeping for 100mS, interrupt sources are polled meanwhile.*/
+  test_set_step(2);
+  {
+    chThdSleepMilliseconds(100);
+  }
+
+  /* [2.7.3] The system tick vector must have been served, the vectors
+     of the stopped serial ports must not.*/
+  test_set_step(3);
+  {
+    test_assert(irq_served(SIM_ST_IRQ_VECTOR) != st, "tick not served");
+    if (SD1.state == SD_STOP) {
+      test_assert(irq_served(SIM_SD1_IRQ_VECTOR) == sd1, "SD1 vector served");
+    }
+    if (SD2.state == SD_STOP) {
+      test_assert(irq_served(SIM_SD2_IRQ_VECTOR) == sd2, "SD2 vector served");
+    }
+  }
+}
+
+static const testcase_t rt_test_002_007 = {
+  "Per-vector interrupt statistics",
+  NULL,
+  NULL,
+  rt_test_002_007_execute
+};
+#endif /* (CH_DBG_STATISTICS == TRUE) && (CH_DBG_STATISTICS_IRQ_VECTORS > 2) && (HAL_USE_SERIAL == TRUE) && defined(USE_SIM_SERIAL1) && (USE_SIM_SERIAL1 == TRUE) && (USE_SIM_SERIAL2 == TRUE) */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -277,6 +581,15 @@ const testcase_t * const rt_test_sequence_002_array[] = {
   &rt_test_002_002,
   &rt_test_002_003,
   &rt_test_002_004,
+#if ((CH_DBG_STATISTICS == TRUE) && (CH_DBG_STATISTICS_CRIT_SITES >= 8)) || defined(__DOXYGEN__)
+  &rt_test_002_005,
+#endif
+#if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
+  &rt_test_002_006,
+#endif
+#if ((CH_DBG_STATISTICS == TRUE) && (CH_DBG_STATISTICS_IRQ_VECTORS > 2) && (HAL_USE_SERIAL == TRUE) && defined(USE_SIM_SERIAL1) && (USE_SIM_SERIAL1 == TRUE) && (USE_SIM_SERIAL2 == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_002_007,
+#endif
   NULL
 };
 
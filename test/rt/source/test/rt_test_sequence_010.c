@@ -46,6 +46,9 @@
  * - @subpage rt_test_010_010
  * - @subpage rt_test_010_011
  * - @subpage rt_test_010_012
+ * - @subpage rt_test_010_013
+ * - @subpage rt_test_010_014
+ * - @subpage rt_test_010_015
  * .
  */
 
@@ -134,6 +137,162 @@ static THD_FUNCTION(bmk_thread8, p) {
   } while(!chThdShouldTerminateX());
 }
 
+#if ((CH_CFG_USE_ACTIVE_OBJECTS == TRUE) && (CH_CFG_USE_MAILBOXES == TRUE)) || defined(__DOXYGEN__)
+#define BMK_COMPONENTS  4
+#define BMK_QUEUE_SIZE  4
+
+static uint32_t bmk_events;
+static mailbox_t bmk_mb[BMK_COMPONENTS];
+static msg_t bmk_mb_buf[BMK_COMPONENTS][BMK_QUEUE_SIZE];
+static ao_scheduler_t bmk_sched;
+static active_object_t bmk_ao[BMK_COMPONENTS];
+static ao_event_t *bmk_ao_buf[BMK_COMPONENTS][BMK_QUEUE_SIZE];
+static ao_event_t bmk_token;
+
+static THD_FUNCTION(bmk_thread9, p) {
+  unsigned i = (unsigned)(size_t)p;
+  msg_t msg;
+
+  while (chMBFetchTimeout(&bmk_mb[i], &msg, TIME_INFINITE) == MSG_OK) {
+    bmk_events++;
+    (void) chMBPostTimeout(&bmk_mb[(i + 1U) % BMK_COMPONENTS], msg,
+                           TIME_INFINITE);
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  }
+}
+
+static ao_result_t bmk_forward(active_object_t *aop, const ao_event_t *ep) {
+  unsigned i = (unsigned)(aop - bmk_ao);
+
+  if (ep->sig != AO_SIG_USER) {
+    return AO_UNHANDLED;
+  }
+  bmk_events++;
+  (void) chAOPost(&bmk_ao[(i + 1U) % BMK_COMPONENTS], &bmk_token);
+#if defined(SIMULATOR)
+  _sim_check_for_interrupts();
+#endif
+  return AO_HANDLED;
+}
+
+static AO_STATE_DECL(bmk_state, NULL, bmk_forward);
+
+static THD_FUNCTION(bmk_thread10, p) {
+
+  chAOSchedulerRun((ao_scheduler_t *)p);
+}
+#endif
+
+#if (CH_CFG_USE_BASIC_TASKS == TRUE) || defined(__DOXYGEN__)
+#define BMK_JOBS        4
+
+static uint32_t bmk_activations;
+static thread_reference_t bmk_tr[BMK_JOBS];
+static bt_level_t bmk_level[2];
+static basic_task_t bmk_task[BMK_JOBS];
+
+static THD_FUNCTION(bmk_thread11, p) {
+  unsigned i = (unsigned)(size_t)p;
+
+  chSysLock();
+  while (!chThdShouldTerminateX() &&
+         (chThdSuspendS(&bmk_tr[i]) == MSG_OK)) {
+    bmk_activations++;
+    chThdResumeS(&bmk_tr[(i + 1U) % BMK_JOBS], MSG_OK);
+#if defined(SIMULATOR)
+    chSysUnlock();
+    _sim_check_for_interrupts();
+    chSysLock();
+#endif
+  }
+  chSysUnlock();
+}
+
+static void bmk_job(void *arg) {
+  unsigned i = (unsigned)(size_t)arg;
+
+  bmk_activations++;
+  (void) chBTActivate(&bmk_task[(i + 1U) % BMK_JOBS]);
+#if defined(SIMULATOR)
+  _sim_check_for_interrupts();
+#endif
+}
+
+static THD_FUNCTION(bmk_thread12, p) {
+
+  chBTLevelRun((bt_level_t *)p);
+}
+#endif
+
+#if ((CH_CFG_USE_RCU == TRUE) && (CH_CFG_USE_MUTEXES == TRUE) &&            \
+     (CH_CFG_USE_MEMPOOLS == TRUE)) || defined(__DOXYGEN__)
+#define BMK_READERS     4
+#define BMK_ENTRIES     8
+#define BMK_VERSIONS    4
+
+typedef struct {
+  rcu_head_t            head;
+  uint32_t              entries[BMK_ENTRIES];
+} bmk_table_t;
+
+static bmk_table_t bmk_tables[BMK_VERSIONS];
+static bmk_table_t *bmk_current;
+static memory_pool_t bmk_pool;
+static uint32_t bmk_reads[BMK_READERS];
+static volatile uint32_t bmk_sink;
+
+static uint32_t bmk_lookup(const bmk_table_t *tp) {
+  uint32_t sum = 0U;
+  unsigned i;
+
+  for (i = 0U; i < BMK_ENTRIES; i++) {
+    sum += tp->entries[i];
+  }
+
+  return sum;
+}
+
+static void bmk_reader_yield(unsigned i) {
+
+  bmk_reads[i]++;
+  if ((bmk_reads[i] & 31U) == 0U) {
+    chThdYield();
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  }
+}
+
+static THD_FUNCTION(bmk_thread13, p) {
+  unsigned i = (unsigned)(size_t)p;
+
+  while (!chThdShouldTerminateX()) {
+    chMtxLock(&mtx1);
+    bmk_sink = bmk_lookup(&bmk_tables[0]);
+    chMtxUnlock(&mtx1);
+    bmk_reader_yield(i);
+  }
+}
+
+static THD_FUNCTION(bmk_thread14, p) {
+  unsigned i = (unsigned)(size_t)p;
+
+  while (!chThdShouldTerminateX()) {
+    chRCUReadLock();
+    bmk_sink = bmk_lookup(bmk_current);
+    chRCUReadUnlock();
+    bmk_reader_yield(i);
+  }
+}
+
+static void bmk_reclaim(rcu_head_t *hp) {
+
+  chPoolFree(&bmk_pool, (void *)hp);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -994,6 +1153,357 @@ static const testcase_t rt_test_010_012 = {
   rt_test_010_012_execute
 };
 
+#if ((CH_CFG_USE_ACTIVE_OBJECTS == TRUE) && (CH_CFG_USE_MAILBOXES == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_010_013 [10.13] Active objects versus threads
+ *
+ * <h2>Description</h2>
+ * Four components pass an event to each other in a ring, first
+ * implemented as four threads with a mailbox each then as four active
+ * objects served by a single thread. The events throughput and the RAM
+ * used by the two designs are printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_ACTIVE_OBJECTS == TRUE) && (CH_CFG_USE_MAILBOXES == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.13.1] The four threads are created at lower priority, an event
+ *   is injected and the number of forwarded events is counted in a one
+ *   second time window.
+ * - [10.13.2] Score and RAM of the threads design are printed.
+ * - [10.13.3] The four active objects are started and a worker thread
+ *   is created at lower priority, an event is injected and the number
+ *   of forwarded events is counted in a one second time window.
+ * - [10.13.4] Score and RAM of the active objects design are printed.
+ * .
+ */
+
+static void rt_test_010_013_execute(void) {
+  uint32_t n;
+  unsigned i;
+
+  /* [10.13.1] The four threads are created at lower priority, an event
+     is injected and the number of forwarded events is counted in a one
+     second time window.*/
+  test_set_step(1);
+  {
+    bmk_events = 0;
+    for (i = 0U; i < BMK_COMPONENTS; i++) {
+      chMBObjectInit(&bmk_mb[i], bmk_mb_buf[i], BMK_QUEUE_SIZE);
+    }
+    for (i = 0U; i < BMK_COMPONENTS; i++) {
+      threads[i] = chThdCreateStatic(wa[i], WA_SIZE, chThdGetPriorityX()-1,
+                                     bmk_thread9, (void *)(size_t)i);
+    }
+    test_wait_tick();
+    (void) chMBPostTimeout(&bmk_mb[0], (msg_t)0, TIME_INFINITE);
+    chThdSleepSeconds(1);
+    n = bmk_events;
+    for (i = 0U; i < BMK_COMPONENTS; i++) {
+      chMBReset(&bmk_mb[i]);
+    }
+    test_wait_threads();
+  }
+
+  /* [10.13.2] Score and RAM of the threads design are printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Thds  : ");
+    test_printn(n);
+    test_println(" events/S");
+    test_print("--- RAM   : ");
+    test_printn(BMK_COMPONENTS * (WA_SIZE + sizeof (mailbox_t) +
+                                  sizeof bmk_mb_buf[0]));
+    test_println(" bytes");
+  }
+
+  /* [10.13.3] The four active objects are started and a worker thread
+     is created at lower priority, an event is injected and the number
+     of forwarded events is counted in a one second time window.*/
+  test_set_step(3);
+  {
+    bmk_events = 0;
+    chAOEventObjectInit(&bmk_token, AO_SIG_USER);
+    chAOSchedulerObjectInit(&bmk_sched);
+    for (i = 0U; i < BMK_COMPONENTS; i++) {
+      chAOObjectInit(&bmk_ao[i], &bmk_sched, (tprio_t)1, &bmk_state,
+                     bmk_ao_buf[i], BMK_QUEUE_SIZE);
+      chAOStart(&bmk_ao[i]);
+    }
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()-1,
+                                   bmk_thread10, (void *)&bmk_sched);
+    test_wait_tick();
+    (void) chAOPost(&bmk_ao[0], &bmk_token);
+    chThdSleepSeconds(1);
+    n = bmk_events;
+    chAOSchedulerStop(&bmk_sched);
+    test_wait_threads();
+  }
+
+  /* [10.13.4] Score and RAM of the active objects design are printed.*/
+  test_set_step(4);
+  {
+    test_print("--- AOs   : ");
+    test_printn(n);
+    test_println(" events/S");
+    test_print("--- RAM   : ");
+    test_printn(WA_SIZE + sizeof (ao_scheduler_t) +
+                BMK_COMPONENTS * (sizeof (active_object_t) +
+                                  sizeof bmk_ao_buf[0]));
+    test_println(" bytes");
+  }
+}
+
+static const testcase_t rt_test_010_013 = {
+  "Active objects versus threads",
+  NULL,
+  NULL,
+  rt_test_010_013_execute
+};
+#endif /* (CH_CFG_USE_ACTIVE_OBJECTS == TRUE) && (CH_CFG_USE_MAILBOXES == TRUE) */
+
+#if (CH_CFG_USE_BASIC_TASKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_010_014 [10.14] Basic tasks versus threads
+ *
+ * <h2>Description</h2>
+ * Four jobs on two priority levels activate each other in a ring, first
+ * implemented as four threads then as four basic tasks sharing the stacks
+ * of two level threads. The activations throughput and the RAM used by the
+ * two designs are printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_BASIC_TASKS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.14.1] The four threads are created at lower priorities, the first
+ *   one is resumed and the number of activations is counted in a one second
+ *   time window.
+ * - [10.14.2] Score and RAM of the threads design are printed.
+ * - [10.14.3] The two level threads are created at lower priority, the
+ *   first task is activated and the number of activations is counted in a
+ *   one second time window.
+ * - [10.14.4] Score and RAM of the basic tasks design are printed.
+ * .
+ */
+
+static void rt_test_010_014_execute(void) {
+  uint32_t n;
+  unsigned i;
+
+  /* [10.14.1] The four threads are created at lower priorities, the first
+     one is resumed and the number of activations is counted in a one second
+     time window.*/
+  test_set_step(1);
+  {
+    bmk_activations = 0;
+    for (i = 0U; i < BMK_JOBS; i++) {
+      bmk_tr[i] = NULL;
+      threads[i] = chThdCreateStatic(wa[i], WA_SIZE,
+                                     chThdGetPriorityX() - 2 + (i & 1U),
+                                     bmk_thread11, (void *)(size_t)i);
+    }
+    test_wait_tick();
+    chThdResume(&bmk_tr[0], MSG_OK);
+    chThdSleepSeconds(1);
+    n = bmk_activations;
+    for (i = 0U; i < BMK_JOBS; i++) {
+      chThdTerminate(threads[i]);
+    }
+    chSysLock();
+    for (i = 0U; i < BMK_JOBS; i++) {
+      chThdResumeI(&bmk_tr[i], MSG_RESET);
+    }
+    chSchRescheduleS();
+    chSysUnlock();
+    test_wait_threads();
+  }
+
+  /* [10.14.2] Score and RAM of the threads design are printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Thds  : ");
+    test_printn(n);
+    test_println(" activations/S");
+    test_print("--- RAM   : ");
+    test_printn(BMK_JOBS * WA_SIZE);
+    test_println(" bytes");
+  }
+
+  /* [10.14.3] The two level threads are created at lower priority, the
+     first task is activated and the number of activations is counted in a
+     one second time window.*/
+  test_set_step(3);
+  {
+    bmk_activations = 0;
+    for (i = 0U; i < 2U; i++) {
+      chBTLevelObjectInit(&bmk_level[i], chThdGetPriorityX() - 2 + i);
+      threads[i] = chThdCreateStatic(wa[i], WA_SIZE, chThdGetPriorityX() - 1,
+                                     bmk_thread12, (void *)&bmk_level[i]);
+    }
+    for (i = 0U; i < BMK_JOBS; i++) {
+      chBTObjectInit(&bmk_task[i], &bmk_level[i & 1U],
+                     chThdGetPriorityX() - 2 + (i & 1U), 1,
+                     bmk_job, (void *)(size_t)i);
+    }
+    test_wait_tick();
+    (void) chBTActivate(&bmk_task[0]);
+    chThdSleepSeconds(1);
+    n = bmk_activations;
+    chBTLevelStop(&bmk_level[0]);
+    chBTLevelStop(&bmk_level[1]);
+    test_wait_threads();
+  }
+
+  /* [10.14.4] Score and RAM of the basic tasks design are printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Tasks : ");
+    test_printn(n);
+    test_println(" activations/S");
+    test_print("--- RAM   : ");
+    test_printn(2U * (WA_SIZE + sizeof (bt_level_t)) +
+                BMK_JOBS * sizeof (basic_task_t));
+    test_println(" bytes");
+  }
+}
+
+static const testcase_t rt_test_010_014 = {
+  "Basic tasks versus threads",
+  NULL,
+  NULL,
+  rt_test_010_014_execute
+};
+#endif /* CH_CFG_USE_BASIC_TASKS == TRUE */
+
+#if ((CH_CFG_USE_RCU == TRUE) && (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_010_015 [10.15] RCU versus mutex
+ *
+ * <h2>Description</h2>
+ * Four readers of the same priority look up a table while the test thread
+ * updates it every 10mS, first protected by a mutex then by RCU with
+ * versions allocated from a pool. The lookups throughput of the two designs
+ * is printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_RCU == TRUE) && (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.15.1] The readers are created at lower priority and the table is
+ *   updated under the mutex for one second.
+ * - [10.15.2] Score of the mutex design is printed.
+ * - [10.15.3] The readers are created at lower priority and a new version
+ *   of the table is published every 10mS for one second, the old versions
+ *   are reclaimed by a callback.
+ * - [10.15.4] Score of the RCU design is printed.
+ * .
+ */
+
+static void rt_test_010_015_execute(void) {
+  uint32_t n;
+  unsigned i, j;
+
+  /* [10.15.1] The readers are created at lower priority and the table is
+     updated under the mutex for one second.*/
+  test_set_step(1);
+  {
+    for (i = 0U; i < BMK_ENTRIES; i++) {
+      bmk_tables[0].entries[i] = 0U;
+    }
+    for (i = 0U; i < BMK_READERS; i++) {
+      bmk_reads[i] = 0U;
+      threads[i] = chThdCreateStatic(wa[i], WA_SIZE, chThdGetPriorityX() - 1,
+                                     bmk_thread13, (void *)(size_t)i);
+    }
+    test_wait_tick();
+    for (j = 0U; j < 100U; j++) {
+      chThdSleepMilliseconds(10);
+      chMtxLock(&mtx1);
+      for (i = 0U; i < BMK_ENTRIES; i++) {
+        bmk_tables[0].entries[i]++;
+      }
+      chMtxUnlock(&mtx1);
+    }
+    n = 0U;
+    for (i = 0U; i < BMK_READERS; i++) {
+      chThdTerminate(threads[i]);
+      n += bmk_reads[i];
+    }
+    test_wait_threads();
+  }
+
+  /* [10.15.2] Score of the mutex design is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Mutex : ");
+    test_printn(n);
+    test_println(" lookups/S");
+  }
+
+  /* [10.15.3] The readers are created at lower priority and a new version
+     of the table is published every 10mS for one second, the old versions
+     are reclaimed by a callback.*/
+  test_set_step(3);
+  {
+    chPoolObjectInit(&bmk_pool, sizeof (bmk_table_t), NULL);
+    chPoolLoadArray(&bmk_pool, &bmk_tables[1], BMK_VERSIONS - 1);
+    bmk_current = &bmk_tables[0];
+    for (i = 0U; i < BMK_READERS; i++) {
+      bmk_reads[i] = 0U;
+      threads[i] = chThdCreateStatic(wa[i], WA_SIZE, chThdGetPriorityX() - 1,
+                                     bmk_thread14, (void *)(size_t)i);
+    }
+    test_wait_tick();
+    for (j = 0U; j < 100U; j++) {
+      bmk_table_t *old = bmk_current;
+      bmk_table_t *tp;
+
+      chThdSleepMilliseconds(10);
+      tp = chPoolAlloc(&bmk_pool);
+      if (tp != NULL) {
+        for (i = 0U; i < BMK_ENTRIES; i++) {
+          tp->entries[i] = old->entries[i] + 1U;
+        }
+        chRCUAssignPointer(bmk_current, tp);
+        chRCUCall(&old->head, bmk_reclaim);
+      }
+    }
+    n = 0U;
+    for (i = 0U; i < BMK_READERS; i++) {
+      chThdTerminate(threads[i]);
+      n += bmk_reads[i];
+    }
+    test_wait_threads();
+    chRCUBarrier();
+  }
+
+  /* [10.15.4] Score of the RCU design is printed.*/
+  test_set_step(4);
+  {
+    test_print("--- RCU   : ");
+    test_printn(n);
+    test_println(" lookups/S");
+  }
+}
+
+static const testcase_t rt_test_010_015 = {
+  "RCU versus mutex",
+  NULL,
+  NULL,
+  rt_test_010_015_execute
+};
+#endif /* (CH_CFG_USE_RCU == TRUE) && (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -1026,6 +1536,15 @@ const testcase_t * const rt_test_sequence_010_array[] = {
   &rt_test_010_011,
 #endif
   &rt_test_010_012,
+#if ((CH_CFG_USE_ACTIVE_OBJECTS == TRUE) && (CH_CFG_USE_MAILBOXES == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_010_013,
+#endif
+#if (CH_CFG_USE_BASIC_TASKS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_010_014,
+#endif
+#if ((CH_CFG_USE_RCU == TRUE) && (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_010_015,
+#endif
   NULL
 };
 
@@ -0,0 +1,350 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "rt_test_root.h"
+
+/**
+ * @file    rt_test_sequence_011.c
+ * @brief   Test Sequence 011 code.
+ *
+ * @page rt_test_sequence_011 [11] Lock contention profiling
+ *
+ * File: @ref rt_test_sequence_011.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the contention statistics of mutexes, semaphores
+ * and condition variables under scripted contention patterns.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_DBG_STATISTICS_LOCKS == TRUE) && (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage rt_test_011_001
+ * - @subpage rt_test_011_002
+ * - @subpage rt_test_011_003
+ * .
+ */
+
+#if ((CH_DBG_STATISTICS_LOCKS == TRUE) && (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+static mutex_t m1;
+static semaphore_t sem1;
+#if CH_CFG_USE_CONDVARS == TRUE
+static condition_variable_t c1;
+#endif
+
+static THD_FUNCTION(thread1, p) {
+
+  (void)p;
+  chMtxLock(&m1);
+  chMtxUnlock(&m1);
+}
+
+static THD_FUNCTION(thread2, p) {
+
+  (void)p;
+  chSemWait(&sem1);
+}
+
+#if CH_CFG_USE_CONDVARS == TRUE
+static THD_FUNCTION(thread3, p) {
+
+  (void)p;
+  chMtxLock(&m1);
+  chCondWait(&c1);
+  chMtxUnlock(&m1);
+}
+#endif
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page rt_test_011_001 [11.1] Mutex contention
+ *
+ * <h2>Description</h2>
+ * A mutex is held while a higher priority thread contends it,
+ * acquisitions, contentions, boosts, wait and hold times are checked.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.1.1] Registering the mutex, it must be at the head of the
+ *   registry.
+ * - [11.1.2] Locking the mutex, the acquisition is not contended.
+ * - [11.1.3] Starting a higher priority thread contending the mutex,
+ *   the owner priority is boosted.
+ * - [11.1.4] Holding the mutex for one tick then releasing it, the
+ *   contending thread acquires and releases the mutex.
+ * - [11.1.5] Checking the counters, two acquisitions of which one
+ *   contended, wait and hold times must have been accounted.
+ * .
+ */
+
+static void rt_test_011_001_setup(void) {
+  chMtxObjectInit(&m1);
+}
+
+static void rt_test_011_001_teardown(void) {
+  test_wait_threads();
+  chStatsLockUnregister(&m1.stats);
+}
+
+static void rt_test_011_001_execute(void) {
+  tprio_t prio;
+
+  /* [11.1.1] Registering the mutex, it must be at the head of the
+     registry.*/
+  test_set_step(1);
+  {
+    chStatsLockRegister(&m1.stats, "m1");
+    test_assert(ch.kernel_stats.locks == &m1.stats, "not registered");
+  }
+
+  /* [11.1.2] Locking the mutex, the acquisition is not contended.*/
+  test_set_step(2);
+  {
+    prio = chThdGetPriorityX();
+    chMtxLock(&m1);
+    test_assert(m1.stats.n_acquired == 1, "wrong acquisitions");
+    test_assert(m1.stats.n_contended == 0, "wrong contentions");
+  }
+
+  /* [11.1.3] Starting a higher priority thread contending the mutex,
+     the owner priority is boosted.*/
+  test_set_step(3);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio + 1, thread1, NULL);
+    test_assert(chThdGetPriorityX() == prio + 1, "not boosted");
+    test_assert(m1.stats.n_boosts == 1, "wrong boosts");
+  }
+
+  /* [11.1.4] Holding the mutex for one tick then releasing it, the
+     contending thread acquires and releases the mutex.*/
+  test_set_step(4);
+  {
+    test_wait_tick();
+    chMtxUnlock(&m1);
+    test_wait_threads();
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+  }
+
+  /* [11.1.5] Checking the counters, two acquisitions of which one
+     contended, wait and hold times must have been accounted.*/
+  test_set_step(5);
+  {
+    test_assert(m1.stats.n_acquired == 2, "wrong acquisitions");
+    test_assert(m1.stats.n_contended == 1, "wrong contentions");
+    test_assert(m1.stats.wait_worst > 0, "wait not accounted");
+    test_assert(m1.stats.hold_worst > 0, "hold not accounted");
+    test_assert(m1.stats.hold_cumulative >= m1.stats.hold_worst, "wrong hold time");
+  }
+}
+
+static const testcase_t rt_test_011_001 = {
+  "Mutex contention",
+  rt_test_011_001_setup,
+  rt_test_011_001_teardown,
+  rt_test_011_001_execute
+};
+
+/**
+ * @page rt_test_011_002 [11.2] Semaphore contention
+ *
+ * <h2>Description</h2>
+ * Threads wait on a semaphore that is signaled later, contended and
+ * uncontended waits are checked, a timed out wait is contended but not
+ * acquired.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.2.1] Starting two higher priority threads waiting on the
+ *   semaphore.
+ * - [11.2.2] Signaling the semaphore twice after one tick, both threads
+ *   acquire it after waiting.
+ * - [11.2.3] Signaling then waiting, the acquisition is not contended.
+ * - [11.2.4] Waiting with a timeout, the wait is contended but the
+ *   semaphore is not acquired.
+ * .
+ */
+
+static void rt_test_011_002_setup(void) {
+  chSemObjectInit(&sem1, 0);
+}
+
+static void rt_test_011_002_teardown(void) {
+  test_wait_threads();
+}
+
+static void rt_test_011_002_execute(void) {
+  msg_t msg;
+  tprio_t prio = chThdGetPriorityX();
+
+  /* [11.2.1] Starting two higher priority threads waiting on the
+     semaphore.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio + 1, thread2, NULL);
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio + 1, thread2, NULL);
+    test_assert(sem1.stats.n_contended == 0, "wrong contentions");
+  }
+
+  /* [11.2.2] Signaling the semaphore twice after one tick, both threads
+     acquire it after waiting.*/
+  test_set_step(2);
+  {
+    test_wait_tick();
+    chSemSignal(&sem1);
+    chSemSignal(&sem1);
+    test_wait_threads();
+    test_assert(sem1.stats.n_acquired == 2, "wrong acquisitions");
+    test_assert(sem1.stats.n_contended == 2, "wrong contentions");
+    test_assert(sem1.stats.wait_worst > 0, "wait not accounted");
+  }
+
+  /* [11.2.3] Signaling then waiting, the acquisition is not contended.*/
+  test_set_step(3);
+  {
+    chSemSignal(&sem1);
+    msg = chSemWait(&sem1);
+    test_assert(msg == MSG_OK, "wrong wake-up message");
+    test_assert(sem1.stats.n_acquired == 3, "wrong acquisitions");
+    test_assert(sem1.stats.n_contended == 2, "wrong contentions");
+  }
+
+  /* [11.2.4] Waiting with a timeout, the wait is contended but the
+     semaphore is not acquired.*/
+  test_set_step(4);
+  {
+    msg = chSemWaitTimeout(&sem1, TIME_MS2I(1));
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+    test_assert(sem1.stats.n_acquired == 3, "wrong acquisitions");
+    test_assert(sem1.stats.n_contended == 3, "wrong contentions");
+    test_assert(sem1.stats.n_boosts == 0, "wrong boosts");
+  }
+}
+
+static const testcase_t rt_test_011_002 = {
+  "Semaphore contention",
+  rt_test_011_002_setup,
+  rt_test_011_002_teardown,
+  rt_test_011_002_execute
+};
+
+#if (CH_CFG_USE_CONDVARS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_003 [11.3] Condition variable contention
+ *
+ * <h2>Description</h2>
+ * A thread waits on a condition variable and then contends the
+ * associated mutex, the statistics of both objects are checked.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_CONDVARS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.3.1] Starting a higher priority thread waiting on the condition
+ *   variable.
+ * - [11.3.2] Signaling the condition variable after one tick while
+ *   owning the mutex, the thread wakes up and contends the mutex.
+ * - [11.3.3] Checking the counters of both objects.
+ * .
+ */
+
+static void rt_test_011_003_setup(void) {
+  chMtxObjectInit(&m1);
+  chCondObjectInit(&c1);
+}
+
+static void rt_test_011_003_teardown(void) {
+  test_wait_threads();
+}
+
+static void rt_test_011_003_execute(void) {
+
+  /* [11.3.1] Starting a higher priority thread waiting on the condition
+     variable.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   thread3, NULL);
+  }
+
+  /* [11.3.2] Signaling the condition variable after one tick while
+     owning the mutex, the thread wakes up and contends the mutex.*/
+  test_set_step(2);
+  {
+    test_wait_tick();
+    chMtxLock(&m1);
+    chCondSignal(&c1);
+    chMtxUnlock(&m1);
+    test_wait_threads();
+  }
+
+  /* [11.3.3] Checking the counters of both objects.*/
+  test_set_step(3);
+  {
+    test_assert(c1.stats.n_acquired == 1, "wrong acquisitions");
+    test_assert(c1.stats.n_contended == 1, "wrong contentions");
+    test_assert(c1.stats.wait_worst > 0, "wait not accounted");
+    test_assert(m1.stats.n_acquired == 3, "wrong acquisitions");
+    test_assert(m1.stats.n_contended == 1, "wrong contentions");
+    test_assert(m1.stats.n_boosts == 1, "wrong boosts");
+  }
+}
+
+static const testcase_t rt_test_011_003 = {
+  "Condition variable contention",
+  rt_test_011_003_setup,
+  rt_test_011_003_teardown,
+  rt_test_011_003_execute
+};
+#endif /* CH_CFG_USE_CONDVARS == TRUE */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const rt_test_sequence_011_array[] = {
+  &rt_test_011_001,
+  &rt_test_011_002,
+#if (CH_CFG_USE_CONDVARS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_011_003,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Lock contention profiling.
+ */
+const testsequence_t rt_test_sequence_011 = {
+  "Lock contention profiling",
+  rt_test_sequence_011_array
+};
+
+#endif /* (CH_DBG_STATISTICS_LOCKS == TRUE) && (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE) */
@@ -0,0 +1,165 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "rt_test_root.h"
+
+/**
+ * @file    rt_test_sequence_012.c
+ * @brief   Test Sequence 012 code.
+ *
+ * @page rt_test_sequence_012 [12] Performance counters virtualization
+ *
+ * File: @ref rt_test_sequence_012.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the per-thread virtualization of the port
+ * performance counters.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_DBG_STATISTICS_PMU == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage rt_test_012_001
+ * .
+ */
+
+#if (CH_DBG_STATISTICS_PMU == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define PMU_BUSY        ((rtcnt_t)100000)
+#define PMU_SLEEPS      10
+
+static pmu_counters_t pmu[2];
+
+static void pmu_sample(pmu_counters_t *pcp) {
+
+  chSysLock();
+  chStatsGetThreadPMUI(chThdGetSelfX(), pcp);
+  chSysUnlock();
+}
+
+static THD_FUNCTION(busy_thread, p) {
+
+  chSysPolledDelayX(PMU_BUSY);
+  pmu_sample((pmu_counters_t *)p);
+}
+
+static THD_FUNCTION(sleeping_thread, p) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)PMU_SLEEPS; i++) {
+    chThdSleepMilliseconds(10);
+  }
+  pmu_sample((pmu_counters_t *)p);
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page rt_test_012_001 [12.1] CPU-bound and sleeping threads
+ *
+ * <h2>Description</h2>
+ * A CPU-bound thread and a mostly sleeping thread run concurrently, the
+ * first counter, cycles on all ports, must be accounted mostly to the
+ * CPU-bound thread.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.1.1] Starting a sleeping thread at higher priority and a
+ *   CPU-bound thread at lower priority, then waiting for both to
+ *   terminate.
+ * - [12.1.2] Checking the counters, the CPU-bound thread must have
+ *   accounted at least four times the cycles of the sleeping thread.
+ * - [12.1.3] Checking that the counters of a new thread start from
+ *   zero.
+ * .
+ */
+
+static void rt_test_012_001_teardown(void) {
+  test_wait_threads();
+}
+
+static void rt_test_012_001_execute(void) {
+  tprio_t prio = chThdGetPriorityX();
+
+  /* [12.1.1] Starting a sleeping thread at higher priority and a
+     CPU-bound thread at lower priority, then waiting for both to
+     terminate.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio + 1,
+                                   sleeping_thread, &pmu[0]);
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio - 1,
+                                   busy_thread, &pmu[1]);
+    test_wait_threads();
+  }
+
+  /* [12.1.2] Checking the counters, the CPU-bound thread must have
+     accounted at least four times the cycles of the sleeping thread.*/
+  test_set_step(2);
+  {
+    test_assert(pmu[1].cnt[0] > (uint64_t)0, "no cycles accounted");
+    test_assert(pmu[1].cnt[0] > pmu[0].cnt[0] * (uint64_t)4, "wrong ratio");
+  }
+
+  /* [12.1.3] Checking that the counters of a new thread start from
+     zero.*/
+  test_set_step(3);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio - 1,
+                                   busy_thread, &pmu[0]);
+    test_assert(threads[0]->pmu.cnt[0] == (uint64_t)0, "not cleared");
+    test_wait_threads();
+    test_assert(pmu[0].cnt[0] > (uint64_t)0, "no cycles accounted");
+  }
+}
+
+static const testcase_t rt_test_012_001 = {
+  "CPU-bound and sleeping threads",
+  NULL,
+  rt_test_012_001_teardown,
+  rt_test_012_001_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const rt_test_sequence_012_array[] = {
+  &rt_test_012_001,
+  NULL
+};
+
+/**
+ * @brief   Performance counters virtualization.
+ */
+const testsequence_t rt_test_sequence_012 = {
+  "Performance counters virtualization",
+  rt_test_sequence_012_array
+};
+
+#endif /* CH_DBG_STATISTICS_PMU == TRUE */
@@ -175,6 +175,18 @@
 #define CH_CFG_USE_TM                       TRUE
 #endif
 
+/**
+ * @brief   64 bits time stamps.
+ * @details If enabled then the realtime counter is extended to 64 bits
+ *          by a periodic virtual timer and the time stamps APIs are
+ *          included in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_TIMESTAMP)
+#define CH_CFG_USE_TIMESTAMP                TRUE
+#endif
+
 /**
  * @brief   Threads registry APIs.
  * @details If enabled then the registry APIs are included in the kernel.
@@ -381,6 +393,62 @@
 #define CH_CFG_USE_PIPES                    TRUE
 #endif
 
+/**
+ * @brief   Active Objects APIs.
+ * @details If enabled then the active objects APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MEMPOOLS.
+ */
+#if !defined(CH_CFG_USE_ACTIVE_OBJECTS)
+#define CH_CFG_USE_ACTIVE_OBJECTS           TRUE
+#endif
+
+/**
+ * @brief   Remote Mailboxes APIs.
+ * @details If enabled then the remote mailboxes APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_REMOTE_MAILBOXES)
+#define CH_CFG_USE_REMOTE_MAILBOXES         TRUE
+#endif
+
+/**
+ * @brief   Basic Tasks APIs.
+ * @details If enabled then the stack sharing basic tasks APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_BASIC_TASKS)
+#define CH_CFG_USE_BASIC_TASKS              TRUE
+#endif
+
+/**
+ * @brief   Schedule Tables APIs.
+ * @details If enabled then the time-triggered schedule tables APIs are
+ *          included in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_SCHEDULE_TABLES)
+#define CH_CFG_USE_SCHEDULE_TABLES          TRUE
+#endif
+
+/**
+ * @brief   RCU APIs.
+ * @details If enabled then the read-copy-update APIs are included in the
+ *          kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_RCU)
+#define CH_CFG_USE_RCU                      TRUE
+#endif
+
 /**
  * @brief   Dynamic Threads APIs.
  * @details If enabled then the dynamic threads creation APIs are included
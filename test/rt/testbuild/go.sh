@@ -122,6 +122,7 @@ test cfg32 "-DCH_CFG_ST_RESOLUTION=16 -DCH_CFG_INTERVALS_SIZE=64"
 test cfg33 "-DCH_CFG_INTERVALS_SIZE=64"
 test cfg34 "-DCH_CFG_USE_OBJ_FIFOS=FALSE"
 test cfg35 "-DCH_CFG_USE_FACTORY=FALSE"
+test cfg36 "-DCH_DBG_STATISTICS=TRUE -DCH_DBG_STATISTICS_CRIT_SITES=8 -DCH_DBG_STATISTICS_LOCKS=TRUE -DCH_DBG_STATISTICS_PMU=TRUE"
 
 rm *log.txt 2> /dev/null
 echo
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+#
+#    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+#
+
+"""LZ4 raw block compressor.
+
+Compresses a binary file into a single LZ4 block without the frame format,
+this is the format expanded by the ARMCMx startup code for the RAM areas
+selected by CRT1_AREAS_LZ_MASK. The compression fails if the block is not
+smaller than the input because the block must fit the space reserved in
+flash for the uncompressed image.
+"""
+
+import sys
+
+MINMATCH = 4
+LASTLITERALS = 5
+MFLIMIT = 12
+MAXOFFSET = 65535
+
+def put_length(out, n):
+    """Appends the extra bytes of a length field."""
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+def put_sequence(out, literals, offset, mlen):
+    """Appends a sequence, a match length of zero ends the block."""
+    nlit = len(literals)
+    token = min(nlit, 15) << 4
+    if mlen > 0:
+        token |= min(mlen - MINMATCH, 15)
+    out.append(token)
+    if nlit >= 15:
+        put_length(out, nlit - 15)
+    out += literals
+    if mlen > 0:
+        out.append(offset & 255)
+        out.append(offset >> 8)
+        if mlen - MINMATCH >= 15:
+            put_length(out, mlen - MINMATCH - 15)
+
+def compress(src):
+    """Greedy compression, the last bytes are always emitted as literals
+    as required by the LZ4 block format."""
+    out = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+    limit = len(src) - MFLIMIT
+    while i < limit:
+        key = src[i:i + MINMATCH]
+        ref = table.get(key)
+        table[key] = i
+        if ref is None or i - ref > MAXOFFSET:
+            i += 1
+            continue
+        mlen = MINMATCH
+        maxlen = len(src) - LASTLITERALS - i
+        while mlen < maxlen and src[ref + mlen] == src[i + mlen]:
+            mlen += 1
+        put_sequence(out, src[anchor:i], i - ref, mlen)
+        i += mlen
+        anchor = i
+    put_sequence(out, src[anchor:], 0, 0)
+    return out
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write("usage: lz4raw.py <input> <output>\n")
+        return 2
+    with open(sys.argv[1], "rb") as f:
+        src = f.read()
+    dst = compress(src)
+    if len(dst) >= len(src):
+        sys.stderr.write("lz4raw.py: %s is not compressible (%d -> %d bytes)\n"
+                         % (sys.argv[1], len(src), len(dst)))
+        return 1
+    with open(sys.argv[2], "wb") as f:
+        f.write(dst)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())